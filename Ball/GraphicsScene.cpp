@@ -10,6 +10,9 @@
 
 #include "Rendering/Renderer.h"
 #include "Rendering/ModelLoading/ModelManager.h"
+#include "Utilities/LaunchParameters.h"
+
+#include <random>
 
 [[maybe_unused]] constexpr int g_numObjects = 128;
 [[maybe_unused]] constexpr int g_numModels = 4;
@@ -18,21 +21,25 @@ const std::string randomSmallModels[g_numModels] = {"Models/Spark/BlueSpark.glb"
 													"Models/Spark/OrangeSpark.glb",
 													"Models/Spark/RedSpark.glb"};
 
+// Seeded with -Seed, so benchmark runs place the models at the same spots every time
+std::mt19937 g_Random;
+
 // Between -1 and 1
 float neg_randf()
 {
-	return 2.0f * static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 1.0f; // Generate
+	return std::uniform_real_distribution<float>(-1.0f, 1.0f)(g_Random);
 }
 
 float randf()
 {
-	return static_cast<float>(rand()) / static_cast<float>(RAND_MAX); // Generate
+	return std::uniform_real_distribution<float>(0.0f, 1.0f)(g_Random);
 }
 
 void GraphicsScene::Initialize()
 {
 	DebugInputSetup();
 	LOG(LOG_GENERIC, "Loading the Graphics Scene");
+	g_Random.seed(static_cast<std::mt19937::result_type>(Ball::LaunchParameters::GetInt("Seed", 1337)));
 
 	// Add a camera to the level
 	Ball::FreeCamera* camera = Ball::GetLevel().AddObject<Ball::FreeCamera>();
@@ -0,0 +1,243 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "Utilities/StringId.h"
+
+namespace Ball
+{
+	// Interned event name, an index into the event names of the AudioSystem
+	struct AudioEventId
+	{
+		uint32_t m_Index = UINT32_MAX;
+
+		bool IsValid() const { return m_Index != UINT32_MAX; }
+		bool operator==(const AudioEventId& other) const { return m_Index == other.m_Index; }
+		bool operator!=(const AudioEventId& other) const { return m_Index != other.m_Index; }
+	};
+
+	// Interned parameter name, an index into the parameter names of the AudioSystem
+	struct AudioParameterId
+	{
+		uint32_t m_Index = UINT32_MAX;
+
+		bool IsValid() const { return m_Index != UINT32_MAX; }
+		bool operator==(const AudioParameterId& other) const { return m_Index == other.m_Index; }
+		bool operator!=(const AudioParameterId& other) const { return m_Index != other.m_Index; }
+	};
+
+	// Handle to a playing event, stays invalid after the voice stopped even when the slot is reused
+	struct AudioVoiceId
+	{
+		uint32_t m_Index = UINT32_MAX;
+		uint32_t m_Generation = 0;
+
+		bool IsValid() const { return m_Index != UINT32_MAX; }
+		bool operator==(const AudioVoiceId& other) const
+		{
+			return m_Index == other.m_Index && m_Generation == other.m_Generation;
+		}
+	};
+
+	/// <summary>
+	/// Maps names to dense indices, so lookups after interning are a vector index instead of a string hash.
+	/// </summary>
+	class AudioNameTable
+	{
+	public:
+		// Returns the index of the name, adding it when it's new
+		uint32_t Intern(std::string_view name);
+		// UINT32_MAX when the name was never interned
+		uint32_t Find(std::string_view name) const;
+		const std::string& GetName(uint32_t index) const { return m_Names[index]; }
+		uint32_t GetCount() const { return static_cast<uint32_t>(m_Names.size()); }
+
+	private:
+		// Keyed by the hash of the name, finding a name doesn't copy it into a string
+		std::unordered_map<StringId, uint32_t> m_Indices;
+		std::vector<std::string> m_Names;
+	};
+
+	struct AudioEventSettings
+	{
+		// Higher priorities are made audible first, distance only orders voices with the same priority
+		int m_Priority = 0;
+		// Voices of the event past this limit are virtual
+		uint32_t m_MaxRealVoices = 8;
+		// 3D voices are at full volume up to the min distance and fade out linearly to the max distance, beyond it
+		// they are inaudible and always virtual
+		float m_MinDistance = 1.f;
+		float m_MaxDistance = 50.f;
+	};
+
+	enum class AudioVoiceState : uint8_t
+	{
+		FREE,
+		RESERVED, // Id was handed out, the play command hasn't been executed yet
+		VIRTUAL, // Tracked and timed, but not playing in the backend
+		REAL // Playing in the backend
+	};
+
+	struct AudioVoice
+	{
+		AudioVoiceId m_Id;
+		AudioEventId m_Event;
+		AudioVoiceState m_State = AudioVoiceState::FREE;
+		bool m_Is3D = false;
+		float m_Volume = 1.f;
+		glm::vec3 m_Position = glm::vec3(0.f);
+		// Seconds since the voice started, virtual voices continue where they would have been
+		float m_Time = 0.f;
+		// Volume after distance attenuation, updated every frame
+		float m_Audibility = 0.f;
+		// Last value of every parameter that was set, reapplied when the voice becomes real
+		std::vector<std::pair<AudioParameterId, float>> m_Parameters;
+	};
+
+	/// <summary>
+	/// Plays voices for the scheduler, e.g. FMOD event instances. All calls happen while the scheduler executes the
+	/// commands of a frame.
+	/// </summary>
+	class AudioBackend
+	{
+	public:
+		virtual ~AudioBackend() = default;
+
+		// Length of the event in seconds, negative for looping events or events that never end by themselves
+		virtual float GetEventLength(AudioEventId event) = 0;
+		// Starts the voice at voice.m_Time with its volume, position and parameters
+		virtual void StartVoice(const AudioVoice& voice) = 0;
+		virtual void StopVoice(AudioVoiceId voice, bool allowFadeOut) = 0;
+		// False once a started voice finished playing
+		virtual bool IsVoicePlaying(AudioVoiceId voice) = 0;
+		virtual void SetVoiceVolume(AudioVoiceId voice, float volume) = 0;
+		virtual void SetVoicePosition(AudioVoiceId voice, const glm::vec3& position) = 0;
+		virtual void SetVoiceParameter(AudioVoiceId voice, AudioParameterId parameter, float value) = 0;
+		virtual void SetListener(const glm::vec3& position, const glm::vec3& forward, const glm::vec3& up) = 0;
+	};
+
+	enum class AudioCommandType : uint8_t
+	{
+		PLAY,
+		STOP_VOICE,
+		STOP_EVENT,
+		STOP_ALL,
+		SET_VOLUME,
+		SET_POSITION,
+		SET_PARAMETER,
+		SET_LISTENER
+	};
+
+	struct AudioCommand
+	{
+		AudioCommandType m_Type;
+		// Stop commands use it to allow fading out, play commands to mark 3D voices
+		bool m_Flag = false;
+		AudioVoiceId m_Voice;
+		// Event of play and stop event commands, parameter of set parameter commands
+		uint32_t m_Id = UINT32_MAX;
+		float m_Value = 0.f;
+		glm::vec3 m_Position = glm::vec3(0.f);
+		// Listener orientation
+		glm::vec3 m_Forward = glm::vec3(0.f);
+		glm::vec3 m_Up = glm::vec3(0.f);
+	};
+
+	// Audio operations of a frame, recorded by gameplay code and executed at once by the scheduler
+	class AudioCommandBuffer
+	{
+	public:
+		void Play(AudioVoiceId voice, AudioEventId event, float volume);
+		void Play3D(AudioVoiceId voice, AudioEventId event, const glm::vec3& position, float volume);
+		void StopVoice(AudioVoiceId voice, bool allowFadeOut);
+		void StopEvent(AudioEventId event, bool allowFadeOut);
+		void StopAll(bool allowFadeOut);
+		void SetVolume(AudioVoiceId voice, float volume);
+		void SetPosition(AudioVoiceId voice, const glm::vec3& position);
+		void SetParameter(AudioVoiceId voice, AudioParameterId parameter, float value);
+		void SetListener(const glm::vec3& position, const glm::vec3& forward, const glm::vec3& up);
+
+		const std::vector<AudioCommand>& GetCommands() const { return m_Commands; }
+		// Keeps the memory for the next frame
+		void Clear() { m_Commands.clear(); }
+
+	private:
+		std::vector<AudioCommand> m_Commands;
+	};
+
+	struct AudioSchedulerStats
+	{
+		uint32_t m_Commands = 0;
+		uint32_t m_RealVoices = 0;
+		uint32_t m_VirtualVoices = 0;
+		// Transitions during the frame
+		uint32_t m_StartedVoices = 0;
+		uint32_t m_VirtualizedVoices = 0;
+		uint32_t m_FinishedVoices = 0;
+	};
+
+	/// <summary>
+	/// Decides which voices are played by the backend. Every frame the voices are ranked by event priority and
+	/// audibility, the best ones up to the per event and global limits are real and the others virtual. Virtual
+	/// voices keep their time, so they continue at the right position when they become audible again.
+	/// </summary>
+	class AudioVoiceScheduler
+	{
+	public:
+		void SetMaxRealVoices(uint32_t maxRealVoices) { m_MaxRealVoices = maxRealVoices; }
+		uint32_t GetMaxRealVoices() const { return m_MaxRealVoices; }
+
+		void SetEventSettings(AudioEventId event, const AudioEventSettings& settings);
+		AudioEventSettings GetEventSettings(AudioEventId event) const;
+
+		// Hands out the id for a play command, so later commands of the same frame can refer to the voice
+		AudioVoiceId ReserveVoice();
+
+		// Executes the commands, then updates the state of all voices
+		void Execute(const AudioCommandBuffer& commands, float deltaTime, AudioBackend& backend);
+
+		// Stops every voice without fading out, e.g. before the backend is released
+		void StopAll(AudioBackend& backend);
+
+		// Real or virtual, or reserved for a play command that hasn't been executed yet
+		bool IsVoiceActive(AudioVoiceId voice) const;
+		// nullptr when the voice stopped
+		const AudioVoice* GetVoice(AudioVoiceId voice) const;
+
+		const AudioSchedulerStats& GetLastFrameStats() const { return m_Stats; }
+
+	private:
+		struct EventData
+		{
+			AudioEventSettings m_Settings;
+			float m_Length = -1.f;
+			bool m_LengthKnown = false;
+			uint32_t m_RealVoices = 0;
+		};
+
+		AudioVoice* FindVoice(AudioVoiceId voice);
+		EventData& GetEventData(AudioEventId event);
+		void ExecuteCommand(const AudioCommand& command, AudioBackend& backend);
+		void StopVoice(AudioVoice& voice, bool allowFadeOut, AudioBackend& backend);
+		void FreeVoice(AudioVoice& voice);
+		float CalculateAudibility(const AudioVoice& voice) const;
+
+		std::vector<AudioVoice> m_Voices;
+		std::vector<uint32_t> m_FreeVoices;
+		std::vector<EventData> m_Events;
+		// Active voice indices from most to least important and whether they are real, kept to not allocate every
+		// frame
+		std::vector<uint32_t> m_Ranking;
+		std::vector<uint8_t> m_Real;
+
+		glm::vec3 m_ListenerPosition = glm::vec3(0.f);
+		uint32_t m_MaxRealVoices = 64;
+		AudioSchedulerStats m_Stats;
+	};
+} // namespace Ball
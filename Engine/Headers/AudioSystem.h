@@ -2,6 +2,8 @@
 #include <string>
 #include <unordered_map>
 
+#include "AudioScheduler.h"
+
 namespace FMOD
 {
 	class Sound;
@@ -35,6 +37,8 @@ namespace Ball
 		SFX = 3
 	};
 
+	class FmodAudioBackend;
+
 	class AudioSystem
 	{
 	public:
@@ -84,8 +88,38 @@ namespace Ball
 		void SetFlanger(float flangerMix, float flangerDepth);
 		void SetEcho(float echoLevel, float echoDelay);
 
+		// Intern names once and keep the ids, the functions below don't look up strings
+		AudioEventId GetEventId(const std::string& eventName);
+		AudioParameterId GetParameterId(const std::string& parameterName);
+		const std::string& GetEventName(AudioEventId event) const { return m_EventNames.GetName(event.m_Index); }
+
+		void SetEventSettings(AudioEventId event, const AudioEventSettings& settings);
+		void SetMaxRealVoices(uint32_t maxRealVoices) { m_Scheduler.SetMaxRealVoices(maxRealVoices); }
+
+		/// <summary>
+		/// Queues playing an event, the commands of a frame are submitted together in Update. Voices beyond the
+		/// limits of the event or the system, or out of hearing range, are virtual until they become audible again.
+		/// </summary>
+		/// <returns>Handle for the other voice functions, valid until the voice stopped</returns>
+		AudioVoiceId PlayEvent(AudioEventId event, float volume = 1.f);
+		AudioVoiceId PlayEvent3D(AudioEventId event, const glm::vec3& position, float volume = 1.f);
+		void StopVoice(AudioVoiceId voice, bool allowFadeOut);
+		void StopEvent(AudioEventId event, bool allowFadeOut);
+		void SetVoiceVolume(AudioVoiceId voice, float volume);
+		void SetVoicePosition(AudioVoiceId voice, const glm::vec3& position);
+		void SetVoiceParameter(AudioVoiceId voice, AudioParameterId parameter, float value);
+		void SetListener(const glm::vec3& position, const glm::vec3& forward, const glm::vec3& up);
+
+		// Real or virtual
+		bool IsVoicePlaying(AudioVoiceId voice) const { return m_Scheduler.IsVoiceActive(voice); }
+		const AudioSchedulerStats& GetSchedulerStats() const { return m_Scheduler.GetLastFrameStats(); }
+
+		// Logs the time spent in Update and the voice counts, for runs without tools
+		void LogReport() const;
+
 	private:
 		friend class AudioParameter;
+		friend class FmodAudioBackend;
 		float m_MasterVolume = 1.0f;
 		float m_MusicVolume = 1.0f;
 		float m_SFXVolume = 1.0f;
@@ -129,11 +163,24 @@ namespace Ball
 		// Map to store EventInstances for future reference
 		std::unordered_map<std::string, FMOD::Studio::EventInstance*> m_EventInstances;
 
+		AudioNameTable m_EventNames;
+		AudioNameTable m_ParameterNames;
+		AudioCommandBuffer m_Commands;
+		AudioVoiceScheduler m_Scheduler;
+		FmodAudioBackend* m_Backend = nullptr;
+
+		// Cost of Update
+		uint32_t m_UpdateCount = 0;
+		double m_TotalUpdateTimeMs = 0.0;
+		float m_MaxUpdateTimeMs = 0.f;
+		uint32_t m_PeakRealVoices = 0;
+		uint32_t m_PeakVirtualVoices = 0;
+
 		const int m_MAXCHANNELS = 512;
 
 		// Combines the master volume with the volume from specific event volume type, you can use volume to give
 		// specific event custom volume
-		float GetMixedVolume(const std::string eventName, float volume = 1.0f);
+		float GetMixedVolume(const std::string& eventName, float volume = 1.0f);
 
 		VolumeType StringToVolumeType(const std::string& EventDirectory)
 		{
@@ -19,6 +19,10 @@ namespace Ball
 	class AudioSystem;
 	class FileWatchSystem;
 	class Camera;
+	class InputRecorder;
+	class InputReplay;
+	class BenchmarkRunner;
+	class PrefabCache;
 
 	struct ApplicationConfig
 	{
@@ -96,6 +100,7 @@ namespace Ball
 
 		Window& GetWindow() const { return *m_Window; }
 		FileWatchSystem& GetFileWatchSystem() const { return *m_FileWatch; }
+		PrefabCache& GetPrefabCache() const { return *m_PrefabCache; }
 
 		/// <summary>
 		/// Called when the Application window has been resized
@@ -106,6 +111,13 @@ namespace Ball
 
 		void ToggleFreeCam();
 
+		// Stops the engine loop at the end of the current frame, Run() then returns the exit code
+		void RequestExit(int exitCode)
+		{
+			m_ExitRequested = true;
+			m_ExitCode = exitCode;
+		}
+
 	private:
 		// @Note,
 		// Not const because we might want to change it in runtime from an editor tool.
@@ -115,6 +127,13 @@ namespace Ball
 		void Shutdown();
 
 		void HandleLevelSwitching();
+		// Hash of the transforms of every object in the level, used to verify input replays
+		uint64_t HashLevelState() const;
+		void SaveInputRecording();
+		void StartBenchmark();
+		void RecordBenchmarkFrame(float frameTimeInMs);
+		// Writes the results and compares them with -BenchmarkBaseline, returns the exit code of the run
+		int FinishBenchmark();
 		friend Engine& GetEngine();
 		Engine();
 
@@ -122,6 +141,10 @@ namespace Ball
 		bool m_Paused = false;
 		const std::chrono::time_point<std::chrono::system_clock> m_StartupTime = std::chrono::system_clock::now();
 		float m_DeltaTime = 0;
+		// -FixedDeltaTime=<ms>, overrides the measured and replayed delta time
+		float m_FixedDeltaTime = 0;
+		bool m_ExitRequested = false;
+		int m_ExitCode = 0;
 
 		Window* m_Window = nullptr;
 		Input* m_Input = nullptr;
@@ -131,6 +154,10 @@ namespace Ball
 		LoggerSystem* m_Logger = nullptr;
 		AudioSystem* m_Audio = nullptr;
 		FileWatchSystem* m_FileWatch = nullptr;
+		PrefabCache* m_PrefabCache = nullptr;
+		InputRecorder* m_InputRecorder = nullptr;
+		InputReplay* m_InputReplay = nullptr;
+		BenchmarkRunner* m_Benchmark = nullptr;
 
 		Level* m_Level = nullptr;
 
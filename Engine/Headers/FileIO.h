@@ -1,9 +1,44 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace Ball
 {
+	class FileReadBatch;
+	struct FileReadRequest;
+
+	/// <summary>
+	/// Read-only view of a whole file, mapped into memory by FileIO::MapReadOnly. Pages are loaded when they are first
+	/// touched, nothing is copied. The view is unmapped when the object is destroyed.
+	/// </summary>
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// False if the file couldn't be mapped. Empty files are valid, but have no data.
+		bool IsValid() const { return m_Valid; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+
+	private:
+		friend class FileIO;
+
+		// Unmaps the view, implemented per platform
+		void Reset();
+
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+		bool m_Valid = false;
+	};
+
 	/// <summary>
 	/// Our interface of interacting with the file system. Always use this and not std functions, as this will work
 	/// cross-platform.
@@ -51,6 +86,8 @@ namespace Ball
 		/// <summary>
 		/// Writes a string to the given file.
 		///	Note that you cannot write to every DirectoryType
+		/// Overwriting writes a temporary file and renames it over the target, so a crash or failed write never
+		/// leaves a partially written file behind.
 		/// </summary>
 		/// <param name="type">The directoryType we try to write to</param>
 		/// <param name="relativePath">The filepath where we will save this file</param>
@@ -60,7 +97,7 @@ namespace Ball
 		static bool Write(DirectoryType type, const std::string& relativePath, const std::string& data,
 						  bool appendData = false);
 		/// <summary>
-		/// Write binary data to a file
+		/// Write binary data to a file, replaced atomically like Write
 		/// </summary>
 		/// <param name="type">The directoryType we try to write to</param>
 		/// <param name="relativePath">The filepath where we will save this file</param>
@@ -87,6 +124,30 @@ namespace Ball
 		static bool ReadBinary(DirectoryType type, const std::string& relativePath, void* targetBuffer,
 							   std::streamsize targetBufferSize);
 
+		/// <summary>
+		/// Maps the whole file into memory without copying it, for large files like glTF buffers and HDR images
+		/// </summary>
+		/// <param name="type">The directoryType the file is in</param>
+		/// <param name="relativePath">The file to map</param>
+		/// <returns>The mapping, invalid if the file doesn't exist or couldn't be mapped</returns>
+		static MappedFile MapReadOnly(DirectoryType type, const std::string& relativePath);
+
+		/// <summary>
+		/// Starts reading all requests in the background and returns right away. The requests are submitted as one
+		/// batch, see FileReadBatch.h.
+		/// </summary>
+		/// <param name="requests">Files and ranges to read, the buffers have to outlive the batch</param>
+		/// <returns>The batch, wait on it before using the buffers</returns>
+		static std::shared_ptr<FileReadBatch> ReadAsync(std::vector<FileReadRequest> requests);
+
+		enum class AsyncReadBackend
+		{
+			THREAD_POOL, // Blocking reads on worker threads, available everywhere
+			IO_URING // Linux io_uring, the whole batch is submitted with a single system call
+		};
+		// Chosen in Init(), -FileIOThreadPool forces the thread pool
+		static AsyncReadBackend GetAsyncReadBackend();
+
 		/// <summary>
 		/// Deletes the given file, Note that not all directory types support deleting
 		/// </summary>
@@ -124,8 +185,8 @@ namespace Ball
 		/// Get the absolute path for the directory type
 		/// </summary>
 		/// <param name="type">The directory type for which we want the absolute path</param>
-		/// <returns>The absolute file path as string</returns>
-		static std::string GetPath(DirectoryType type);
+		/// <returns>The absolute file path as string, stays valid for the lifetime of the program</returns>
+		static const std::string& GetPath(DirectoryType type);
 		/// <summary>
 		/// Get the absolute path for the directory type with the appended relative path
 		/// </summary>
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileIO.h"
+
+namespace Ball
+{
+	struct FileReadRequest
+	{
+		FileIO::DirectoryType m_Type = FileIO::Engine;
+		std::string m_RelativePath;
+		// Bytes [m_Offset, m_Offset + m_Size) of the file are read into m_Buffer
+		uint64_t m_Offset = 0;
+		void* m_Buffer = nullptr;
+		size_t m_Size = 0;
+
+		// Results, written by the backend before the batch completes
+		size_t m_BytesRead = 0;
+		// All m_Size bytes were read
+		bool m_Succeeded = false;
+	};
+
+	/// <summary>
+	/// Requests of a single FileIO::ReadAsync call. The backend fills in the results and the batch completes once
+	/// every request finished, successful or not. The buffers have to stay alive until then.
+	/// </summary>
+	class FileReadBatch
+	{
+	public:
+		explicit FileReadBatch(std::vector<FileReadRequest> requests);
+
+		bool IsComplete() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+		void Wait() const;
+
+		// Only read the results after the batch completed
+		const std::vector<FileReadRequest>& GetRequests() const { return m_Requests; }
+		bool AllSucceeded() const;
+
+		// Called by the backends
+		FileReadRequest& GetRequest(size_t index) { return m_Requests[index]; }
+		size_t GetNumRequests() const { return m_Requests.size(); }
+		void CompleteRequest();
+
+	private:
+		std::vector<FileReadRequest> m_Requests;
+		std::atomic<size_t> m_Pending;
+		mutable std::mutex m_Mutex;
+		mutable std::condition_variable m_Completed;
+	};
+
+	/// <summary>
+	/// Threads that execute read requests with a blocking read function, used when the platform has no batched read
+	/// API (or it isn't available at runtime).
+	/// </summary>
+	class FileReadWorkers
+	{
+	public:
+		// Reads the request and fills in its results
+		using ReadFunction = void (*)(FileReadRequest& request);
+
+		FileReadWorkers(uint32_t numThreads, ReadFunction readFunction);
+		~FileReadWorkers();
+		FileReadWorkers(const FileReadWorkers&) = delete;
+		FileReadWorkers& operator=(const FileReadWorkers&) = delete;
+
+		void Submit(const std::shared_ptr<FileReadBatch>& batch);
+
+	private:
+		struct Job
+		{
+			std::shared_ptr<FileReadBatch> m_Batch;
+			size_t m_Index = 0;
+		};
+
+		void Run();
+
+		ReadFunction m_ReadFunction;
+		std::vector<std::thread> m_Threads;
+		std::deque<Job> m_Jobs;
+		std::mutex m_Mutex;
+		std::condition_variable m_HasJobs;
+		bool m_Stop = false;
+	};
+} // namespace Ball
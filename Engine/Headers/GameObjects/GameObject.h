@@ -42,6 +42,7 @@ namespace Ball
 		friend class ObjectManager;
 		friend class ObjectSerializer;
 		friend class ObjectFactory;
+		friend class PrefabCache;
 
 	public:
 		GameObject() = default;
@@ -86,11 +87,22 @@ namespace Ball
 		glm::mat4 MakeLocalToParentTransform();
 		glm::mat4 MakeParentToLocalTransform();
 
+		// Objects spawned from the prefab cache are copied instead of loaded, so Serialize isn't called on them.
+		// Override this for the side effects that loading has on your type.
+		virtual void OnCopiedFromPrefab() {}
+
 		Transform m_Transform;
 		bool m_CanBeSaved = true;
 
 	private:
 		void SerializeBase(SerializeArchive& archive);
+		// Detaches a copy of a cached prefab object from everything the original is linked to
+		void FixUpPrefabCopy();
+		// Not GetFieldTable(), inherited types would pick it up as their own
+		static constexpr auto GetBaseFieldTable()
+		{
+			return MakeFieldTable(FIELD(GameObject, m_PrefabTitle), FIELD(GameObject, m_ModelPath));
+		}
 
 		GameObject* m_ParentedObject = nullptr;
 		GameObject* m_LastChildObject = nullptr;
@@ -6,9 +6,11 @@
 #include <type_traits>
 
 #include "GameObject.h"
+#include "SpatialIndex.h"
 
 #include "GameObjects/Serialization/ObjectFactory.h"
 #include "Serialization/ObjectSerializer.h"
+#include "Serialization/PrefabCache.h"
 
 struct ModelHeapLocation;
 namespace Ball
@@ -42,6 +44,9 @@ namespace Ball
 		GameObject* operator[](int i) const;
 		int Size() const { return m_Objects.size(); }
 
+		// Bounds of the objects with a model, updated at the start of Update
+		SpatialIndex& GetSpatialIndex() { return m_SpatialIndex; }
+
 		struct Iterator
 		{
 			// First, set up the iterator traits
@@ -97,6 +102,7 @@ namespace Ball
 		bool m_FixedSize = false;
 
 		std::vector<std::unique_ptr<GameObject>> m_Objects;
+		SpatialIndex m_SpatialIndex;
 	};
 
 	template<typename T>
@@ -108,7 +114,7 @@ namespace Ball
 
 		if (!prefabName.empty())
 		{
-			auto* object = ObjectSerializer::LoadPrefab(prefabName);
+			auto* object = GetEngine().GetPrefabCache().Instantiate(prefabName);
 			m_Objects.emplace_back(std::unique_ptr<GameObject>(object));
 			object->Init();
 			return static_cast<T*>(object);
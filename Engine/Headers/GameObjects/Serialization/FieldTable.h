@@ -0,0 +1,167 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Entry of a field table. Save files use the member name as key, prefabs use it without the "m_" prefix.
+#define FIELD(TYPE, MEMBER) Ball::MakeField(#MEMBER, &TYPE::MEMBER)
+// Field that used to be saved under another member name, files that still use the old name keep loading
+#define FIELD_RENAMED(TYPE, MEMBER, OLD_NAME) Ball::MakeField(#MEMBER, &TYPE::MEMBER, OLD_NAME)
+
+namespace Ball
+{
+	enum class FieldType : uint8_t
+	{
+		INT,
+		INT64,
+		FLOAT,
+		DOUBLE,
+		BOOL,
+		STRING,
+		VEC3,
+		QUAT,
+		ARRAY,
+		OBJECT
+	};
+
+	// FNV-1a, usable at compile time
+	constexpr uint32_t HashFieldName(std::string_view name)
+	{
+		uint32_t hash = 2166136261u;
+		for (const char character : name)
+			hash = (hash ^ static_cast<uint8_t>(character)) * 16777619u;
+		return hash;
+	}
+
+	// "m_Position" -> "Position", the result points into the same string literal
+	constexpr const char* RemoveMemberPrefix(const char* name)
+	{
+		return name[0] == 'm' && name[1] == '_' ? name + 2 : name;
+	}
+
+	template<typename T>
+	struct IsFieldArray : std::false_type
+	{
+	};
+	template<typename T>
+	struct IsFieldArray<std::vector<T>> : std::true_type
+	{
+	};
+
+	template<typename T>
+	constexpr FieldType GetFieldType()
+	{
+		if constexpr (std::is_same_v<T, int>)
+			return FieldType::INT;
+		else if constexpr (std::is_same_v<T, int64_t>)
+			return FieldType::INT64;
+		else if constexpr (std::is_same_v<T, float>)
+			return FieldType::FLOAT;
+		else if constexpr (std::is_same_v<T, double>)
+			return FieldType::DOUBLE;
+		else if constexpr (std::is_same_v<T, bool>)
+			return FieldType::BOOL;
+		else if constexpr (std::is_same_v<T, std::string>)
+			return FieldType::STRING;
+		else if constexpr (std::is_same_v<T, glm::vec3>)
+			return FieldType::VEC3;
+		else if constexpr (std::is_same_v<T, glm::quat>)
+			return FieldType::QUAT;
+		else if constexpr (IsFieldArray<T>::value)
+			return FieldType::ARRAY;
+		else
+			return FieldType::OBJECT;
+	}
+
+	template<typename Class, typename Member>
+	struct Field
+	{
+		using MemberType = Member;
+
+		const char* m_Name; // Key in save files
+		const char* m_PrefabName; // Key in prefab files
+		const char* m_OldName; // Name before the last rename, nullptr if the field was never renamed
+		uint32_t m_NameHash; // Of m_PrefabName, which is the name tools show
+		FieldType m_Type;
+		Member Class::*m_Member;
+	};
+
+	template<typename Class, typename Member>
+	constexpr Field<Class, Member> MakeField(const char* name, Member Class::*member, const char* oldName = nullptr)
+	{
+		const char* prefabName = RemoveMemberPrefix(name);
+		return {name, prefabName, oldName, HashFieldName(prefabName), GetFieldType<Member>(), member};
+	}
+
+	/// <summary>
+	/// A field table lists the serialized members of a type, built at compile time so saving, loading and prefab
+	/// diffing don't derive names from strings at runtime. Declare it as a static member function:
+	/// static constexpr auto GetFieldTable() { return MakeFieldTable(FIELD(Camera, m_FOV)); }
+	/// Removed fields are simply left out, their keys in old files are ignored. Renamed fields use FIELD_RENAMED.
+	/// </summary>
+	template<typename... Fields>
+	constexpr std::tuple<Fields...> MakeFieldTable(Fields... fields)
+	{
+		return {fields...};
+	}
+
+	template<typename T, typename = std::void_t<>>
+	struct has_field_table : std::false_type
+	{
+	};
+	template<typename T>
+	struct has_field_table<T, std::void_t<decltype(T::GetFieldTable())>> : std::true_type
+	{
+	};
+
+	template<typename Table, typename Function>
+	constexpr void ForEachField(const Table& table, Function&& function)
+	{
+		std::apply([&function](const auto&... field) { (function(field), ...); }, table);
+	}
+
+	template<typename Table>
+	constexpr bool HasUniqueFieldNames(const Table& table)
+	{
+		bool unique = true;
+		ForEachField(table,
+					 [&](const auto& field)
+					 {
+						 int count = 0;
+						 ForEachField(table, [&](const auto& other) { count += other.m_NameHash == field.m_NameHash; });
+						 unique &= count == 1;
+					 });
+		return unique;
+	}
+
+	/// <summary>
+	/// Calls function with the field and a reference to the member of object, for tools that only know the name
+	/// of a field at runtime.
+	/// </summary>
+	/// <returns>False if T has no field with that name</returns>
+	template<typename T, typename Function>
+	bool VisitField(T& object, std::string_view name, Function&& function)
+	{
+		if (name.substr(0, 2) == "m_")
+			name.remove_prefix(2);
+		const uint32_t nameHash = HashFieldName(name);
+
+		bool found = false;
+		ForEachField(T::GetFieldTable(),
+					 [&](const auto& field)
+					 {
+						 if (!found && field.m_NameHash == nameHash)
+						 {
+							 found = true;
+							 function(field, object.*field.m_Member);
+						 }
+					 });
+		return found;
+	}
+} // namespace Ball
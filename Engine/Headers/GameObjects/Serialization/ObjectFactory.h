@@ -1,6 +1,8 @@
 #pragma once
+#include <type_traits>
 #include <unordered_map>
 #include "Log.h"
+#include "Utilities/StringId.h"
 
 namespace Ball
 {
@@ -19,16 +21,22 @@ namespace Ball
 		/// <summary>
 		/// Create a new GameObject from a typename
 		/// </summary>
-		/// <param name="TypeName">The Object type as string, can get this from T::TYPE_NAME</param>
+		/// <param name="TypeName">The Object type name, can get this from T::TYPE_NAME</param>
 		/// <returns>A game object, not added to any level</returns>
-		static GameObject* CreateObject(const std::string& TypeName);
+		static GameObject* CreateObject(std::string_view TypeName);
+
+		/// <summary>
+		/// Copy constructs a GameObject of the same type as source
+		/// </summary>
+		/// <returns>A game object, not added to any level. nullptr if the type can't be copied</returns>
+		static GameObject* CloneObject(GameObject& source);
 
 		/// <summary>
 		/// Checks if the given typename is registered to the ObjectFactory.
 		/// </summary>
-		/// <param name="TypeName">The Object type as string, can get this from T::TYPE_NAME</param>
+		/// <param name="TypeName">The Object type name, can get this from T::TYPE_NAME</param>
 		/// <returns>True if the type exist</returns>
-		static bool Contains(const char* TypeName);
+		static bool Contains(StringId TypeName);
 
 	private:
 		ObjectFactory() = default;
@@ -40,8 +48,11 @@ namespace Ball
 		/// <returns></returns>
 		static ObjectFactory& GetInstance();
 
+		// Keyed by the hash of the type name
 		typedef GameObject* (*CreateObjectFunc)();
-		std::unordered_map<std::string, CreateObjectFunc> m_ObjectCreationFunctions{};
+		std::unordered_map<StringId, CreateObjectFunc> m_ObjectCreationFunctions{};
+		typedef GameObject* (*CloneObjectFunc)(const GameObject&);
+		std::unordered_map<StringId, CloneObjectFunc> m_ObjectCloneFunctions{};
 
 		/// <summary>
 		/// This function creates the unique object instance
@@ -51,6 +62,15 @@ namespace Ball
 		{
 			return new T();
 		}
+
+		template<typename T>
+		static GameObject* CloneObjectPtr(const GameObject& source)
+		{
+			if constexpr (std::is_copy_constructible_v<T>)
+				return new T(static_cast<const T&>(source));
+			else
+				return nullptr;
+		}
 	};
 
 	template<typename T>
@@ -59,15 +79,17 @@ namespace Ball
 		static_assert(std::is_base_of_v<GameObject, T>, "T must inherit from GameObject");
 
 		const char* objectName = T::TYPE_NAME;
+		const StringId typeId = StringId::Intern(objectName);
 
 		auto& registeredTypes = GetInstance().m_ObjectCreationFunctions;
 
 		ASSERT_MSG(LOG_GAMEOBJECTS,
-				   registeredTypes.find(objectName) == registeredTypes.end(),
+				   registeredTypes.find(typeId) == registeredTypes.end(),
 				   "Failed to register type \"%s\" in object factory: Object is already registered.",
 				   objectName);
 
-		registeredTypes.insert({objectName, CreateObjectPtr<T>});
+		registeredTypes.insert({typeId, CreateObjectPtr<T>});
+		GetInstance().m_ObjectCloneFunctions.insert({typeId, CloneObjectPtr<T>});
 	}
 
 	inline ObjectFactory& ObjectFactory::GetInstance()
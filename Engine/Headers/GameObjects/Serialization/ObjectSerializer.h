@@ -2,6 +2,7 @@
 #include <string>
 #include <nlohmann/json.hpp>
 
+#include "GameObjects/Serialization/FieldTable.h"
 #include "GameObjects/Serialization/SerializerFields.h"
 #include "GameObjects/Serialization/PrefabReader.h"
 
@@ -37,10 +38,21 @@ namespace Ball
 		template<typename T>
 		void Add(T& data, const std::string& varName, const std::string& funcSignature);
 
+		// Adds every field in T::GetFieldTable(), see FieldTable.h
+		template<typename T>
+		void AddFields(T& object);
+		template<typename T, typename Table>
+		void AddFields(T& object, const Table& fields);
+
 		SerializeArchiveType GetArchiveType() const { return m_Type; }
 		nlohmann::ordered_json& GetData() const { return *m_Data; }
 
 	private:
+		// prefabName is the key of the value in the attached prefab, oldName is checked when loading a missing value
+		template<typename T>
+		void AddValue(T& data, const std::string& varName, const std::string& prefabName, const char* oldName,
+					  const std::string& funcSignature);
+
 		// Data required for saving:
 		nlohmann::ordered_json* m_Data = nullptr;
 
@@ -80,19 +92,47 @@ namespace Ball
 	template<typename T>
 	inline void SerializeArchive::Add(T& data, const std::string& varName, const std::string& funcSignature)
 	{
-		std::string varNameNoPrefix = Utilities::RemoveStringMemberPrefix(varName);
+		AddValue(data, varName, Utilities::RemoveStringMemberPrefix(varName), nullptr, funcSignature);
+	}
+
+	template<typename T>
+	inline void SerializeArchive::AddFields(T& object)
+	{
+		static_assert(HasUniqueFieldNames(T::GetFieldTable()), "Two fields in the field table have the same name");
+		AddFields(object, T::GetFieldTable());
+	}
 
-		// In case the inner object has a serialize function, we become recursive
-		if constexpr (has_serialize<T>::value)
+	template<typename T, typename Table>
+	inline void SerializeArchive::AddFields(T& object, const Table& fields)
+	{
+		ForEachField(fields,
+					 [&](const auto& field)
+					 {
+						 AddValue(object.*field.m_Member, field.m_Name, field.m_PrefabName, field.m_OldName, "");
+					 });
+	}
+
+	template<typename T>
+	inline void SerializeArchive::AddValue(T& data, const std::string& varName, const std::string& prefabName,
+										   const char* oldName, const std::string& funcSignature)
+	{
+		// In case the inner object has a serialize function or a field table, we become recursive
+		if constexpr (has_serialize<T>::value || has_field_table<T>::value)
 		{
-			// Create new JsonObject, For SubObject
+			// Create new JsonObject, For SubObject. When loading it starts as a copy of the saved one.
 			nlohmann::ordered_json object = {};
+			if (m_Type == SerializeArchiveType::LOAD_DATA && m_Data->contains(varName))
+				object = (*m_Data)[varName];
 			auto* root = this->m_Data;
 			this->m_Data = &object;
 
-			data.Serialize(*this);
+			if constexpr (has_serialize<T>::value)
+				data.Serialize(*this);
+			else
+				AddFields(data);
 
-			(*root)[varName] = object;
+			if (m_Type == SerializeArchiveType::SAVE_DATA)
+				(*root)[varName] = object;
 			this->m_Data = root;
 
 			return;
@@ -109,7 +149,7 @@ namespace Ball
 				// If it is, we ignore it. If it isn't, we save it to the override section.
 
 				nlohmann::ordered_json& saveDataCompare = (*m_Data)[varName];
-				nlohmann::ordered_json& prefabDataCompare = m_AttachedPrefabData->m_ObjectData[varNameNoPrefix];
+				nlohmann::ordered_json& prefabDataCompare = m_AttachedPrefabData->m_ObjectData[prefabName];
 				if (prefabDataCompare == saveDataCompare)
 					(*m_Data).erase(varName);
 			}
@@ -117,32 +157,38 @@ namespace Ball
 		// Deserialization
 		else
 		{
+			// Files written before the field got renamed still use its old name
+			std::string loadName = varName;
+			if (oldName != nullptr && !m_Data->contains(varName) && m_Data->contains(oldName))
+				loadName = oldName;
+
 			if (m_AttachedPrefabData != nullptr)
 			{
-				std::string varNameNoPrefix = Utilities::RemoveStringMemberPrefix(varName);
+				std::string prefabLoadName = prefabName;
+				if (oldName != nullptr && !m_AttachedPrefabData->m_ObjectData.contains(prefabName))
+					prefabLoadName = RemoveMemberPrefix(oldName);
 
 				// Check for overrides in the save file
-				if (m_Data->contains(varName))
+				if (m_Data->contains(loadName))
 				{
-					Deserializer::DeserializeValue(*m_Data, data, varName, funcSignature);
+					Deserializer::DeserializeValue(*m_Data, data, loadName, funcSignature);
 				}
 				// Load from prefab file if one is attached
-				else if (m_AttachedPrefabData->m_ObjectData.contains(varNameNoPrefix))
+				else if (m_AttachedPrefabData->m_ObjectData.contains(prefabLoadName))
 				{
-					std::string lookupKey = Utilities::RemoveStringMemberPrefix(varName);
-
 					// Don't handle null data. This will only cause problems...
-					if (m_AttachedPrefabData->m_ObjectData[lookupKey].type() == nlohmann::json::value_t::null)
+					if (m_AttachedPrefabData->m_ObjectData[prefabLoadName].type() == nlohmann::json::value_t::null)
 						return;
-					Deserializer::DeserializeValue(m_AttachedPrefabData->m_ObjectData, data, lookupKey, funcSignature);
+					Deserializer::DeserializeValue(
+						m_AttachedPrefabData->m_ObjectData, data, prefabLoadName, funcSignature);
 				}
 			}
 			// If no prefab is attached, we just try to read it from the save file. This is risky, and needs to be
 			// tested...
 			else
 			{
-				if (m_Data->contains(varName))
-					Deserializer::DeserializeValue(*m_Data, data, varName, funcSignature);
+				if (m_Data->contains(loadName))
+					Deserializer::DeserializeValue(*m_Data, data, loadName, funcSignature);
 			}
 		}
 	}
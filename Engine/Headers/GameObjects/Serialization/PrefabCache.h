@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+
+#include "Utilities/FileWatch.h"
+
+namespace Ball
+{
+	class GameObject;
+
+	/// <summary>
+	/// Keeps one fully loaded object per prefab. Spawning a prefab copy constructs that object instead of applying
+	/// the prefab JSON to a new object again. Cached objects are dropped when their prefab file changes on disk.
+	/// Types that can't be copied fall back to ObjectSerializer::LoadPrefab.
+	/// </summary>
+	class PrefabCache : public IFileWatchListener
+	{
+	public:
+		PrefabCache();
+		~PrefabCache() override;
+
+		/// <summary>
+		/// Creates an object from a prefab, the same as ObjectSerializer::LoadPrefab but faster after the first call.
+		/// </summary>
+		/// <returns>gameObject pointer not attached to a level !</returns>
+		GameObject* Instantiate(const std::string& prefabPath);
+
+		// Drops the cached object, the next spawn reads the prefab again
+		void Invalidate(const std::string& prefabPath);
+		void Clear();
+
+		size_t GetCachedCount() const { return m_Templates.size(); }
+		void SetEnabled(bool enabled) { m_Enabled = enabled; }
+		bool IsEnabled() const { return m_Enabled; }
+
+		void OnFileWatchEvent(const std::string& path) override;
+
+	private:
+		// Owned, nullptr for types that can't be copied
+		std::unordered_map<std::string, GameObject*> m_Templates{};
+		// Absolute path of a watched prefab file to its prefab path
+		std::unordered_map<std::string, std::string> m_WatchedFiles{};
+		bool m_Enabled = true;
+	};
+} // namespace Ball
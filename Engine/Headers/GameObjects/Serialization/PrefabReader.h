@@ -3,6 +3,9 @@
 #include <unordered_map>
 #include <string>
 
+#include "GameObjects/Serialization/FieldTable.h"
+#include "Utilities/StringId.h"
+
 // This class is used for loading the data from a prefab file into a map.
 // The data in this map can be retrieved at any time.
 //
@@ -36,6 +39,13 @@ namespace Ball
 		/// </summary>
 		/// <param name="archive"></param>
 		void SerializePrefabInfo(class SerializeArchive& archive);
+		static constexpr auto GetFieldTable()
+		{
+			return MakeFieldTable(FIELD(PrefabData, m_DisplayName),
+								  FIELD(PrefabData, m_Description),
+								  FIELD(PrefabData, m_ThumbnailPath),
+								  FIELD(PrefabData, m_LevelCost));
+		}
 
 	private:
 		std::string m_DisplayName = "";
@@ -73,7 +83,10 @@ namespace Ball
 		// - prefabName: Lookup key to access the prefab data. This is the name of the prefab (the same name that was
 		// used when using the AddPrefab function).
 		// - Return value: A pointer to the PrefabData struct. Returns nullptr when no data has been found.
-		static PrefabData* GetPrefabData(const std::string& prefabName);
+		static PrefabData* GetPrefabData(std::string_view prefabName);
+
+		// Reads the prefab file again after it changed on disk. PrefabData pointers stay valid.
+		static void ReloadPrefab(const std::string& prefabFilePath);
 
 	private:
 		/// <summary>
@@ -83,9 +96,11 @@ namespace Ball
 		/// </summary>
 		/// <param name="prefabFilePath">The name of the prefab that needs to be loaded</param>
 		static void RegisterPrefab(const std::string& prefabFilePath);
+		static bool ReadPrefabFile(const std::string& prefabFilePath, PrefabData& prefabData);
 
 		static void Initialize();
 
-		inline static std::unordered_map<std::string, std::unique_ptr<PrefabData>> m_Prefabs;
+		// Keyed by the hash of the prefab name
+		inline static std::unordered_map<StringId, std::unique_ptr<PrefabData>> m_Prefabs;
 	};
 } // namespace Ball
\ No newline at end of file
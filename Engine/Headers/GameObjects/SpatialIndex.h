@@ -0,0 +1,58 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+
+#include "Utilities/DynamicAABBTree.h"
+
+namespace Ball
+{
+	class GameObject;
+	class Model;
+	class ObjectManager;
+
+	/// <summary>
+	/// Answers "what is near X" for the objects of a level. Objects are added with the world space bounds of their
+	/// loaded model, lights with their emissive ball too. Objects without a model (cameras, triggers) are not in the
+	/// index. Owned and updated by the ObjectManager once per frame, only objects whose transform or model changed
+	/// are looked at again.
+	/// </summary>
+	class SpatialIndex
+	{
+	public:
+		// Adds, moves and removes objects so the index matches the object manager
+		void Update(ObjectManager& objectManager);
+		void Remove(const GameObject* object);
+		void Clear();
+
+		// World space bounds the object was indexed with, nullptr when it isn't indexed
+		const AABB* GetObjectBounds(const GameObject* object) const;
+
+		// The Query functions add the objects whose bounds match to result, without clearing it
+		void QueryOverlap(const AABB& box, std::vector<GameObject*>& result) const;
+		void QueryRadius(const glm::vec3& center, float radius, std::vector<GameObject*>& result) const;
+		void QueryFrustum(const CullingFrustum& frustum, std::vector<GameObject*>& result) const;
+
+		/// <summary>
+		/// Finds the first object whose bounds the ray hits. Bounds are boxes around the models, not the triangles.
+		/// </summary>
+		/// <param name="hitDistance">Optional, set to the distance along the ray where the bounds are entered</param>
+		/// <returns>nullptr when nothing is hit within maxDistance</returns>
+		GameObject* RayCast(const glm::vec3& origin,
+							const glm::vec3& direction,
+							float maxDistance,
+							float* hitDistance = nullptr) const;
+
+		const DynamicAABBTree& GetTree() const { return m_Tree; }
+
+	private:
+		struct Entry
+		{
+			int32_t m_ProxyId = DynamicAABBTree::NULL_NODE;
+			uint32_t m_TransformVersion = 0;
+			const Model* m_Model = nullptr;
+		};
+
+		DynamicAABBTree m_Tree{};
+		std::unordered_map<const GameObject*, Entry> m_Entries{};
+	};
+} // namespace Ball
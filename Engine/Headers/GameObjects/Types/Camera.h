@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GameObjects/GameObject.h"
+#include "Rendering/FrustumCulling.h"
 #include "ShaderHeaders/CameraGPU.h"
 
 namespace Ball
@@ -23,6 +24,9 @@ namespace Ball
 		glm::mat4 GetView();
 		glm::mat4 GetGameplaySkyboxRotMat();
 
+		// World space view pyramid of the current transform, culls everything further away than the far plane
+		CullingFrustum GetCullingFrustum();
+
 		void SetCameraDir(const glm::vec3& newDir) { m_CameraDirection = newDir; }
 		const glm::vec3& GetCameraDir() const { return m_CameraDirection; }
 
@@ -34,6 +38,8 @@ namespace Ball
 		// Returns a pointer to the camera used for rendering
 		static Camera* GetActiveCamera() { return m_ActiveCamera; }
 
+		static constexpr auto GetFieldTable() { return MakeFieldTable(FIELD(Camera, m_FOV)); }
+
 		float m_NearPlane = 0.01f;
 		float m_FarPlane = 1000.f;
 		float m_FOV = 50.0f;
@@ -43,8 +49,11 @@ namespace Ball
 
 	protected:
 		void Serialize(SerializeArchive& archive) override;
+		void OnCopiedFromPrefab() override { SetActiveCamera(this); }
 
 		void UpdateCamera(uint32_t screenWidth, uint32_t screenHeight);
+		glm::vec3 CalculateImagePlanePos();
+		ViewPyramid CalculateViewPyramid(const glm::vec3& imagePlanePos);
 
 		glm::vec3 m_CameraDirection = glm::vec3(0.f);
 		glm::vec3 m_ImagePlanePos;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GameObjects/Types/Camera.h"
+#include "Input/Input.h"
 
 namespace Ball
 {
@@ -20,6 +21,11 @@ namespace Ball
 
 	private:
 		inline static bool m_InputInitialized = false;
+		inline static AxisId m_XAxis;
+		inline static AxisId m_YAxis;
+		inline static AxisId m_ZAxis;
+		inline static AxisId m_PitchAxis;
+		inline static AxisId m_YawAxis;
 
 		REFLECT(FreeCamera)
 	};
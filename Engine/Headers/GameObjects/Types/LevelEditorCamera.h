@@ -2,6 +2,7 @@
 
 #include "GameObjects/Serialization/PrefabReader.h"
 #include "GameObjects/Types/Camera.h"
+#include "Input/Input.h"
 
 namespace Ball
 {
@@ -46,6 +47,14 @@ namespace Ball
 		glm::vec3 m_Direction;
 
 		inline static bool m_InputInitialized = false;
+		inline static ActionId m_ControlAction;
+		inline static AxisId m_ForwardAxis;
+		inline static AxisId m_RightAxis;
+		inline static AxisId m_UpAxis;
+		inline static AxisId m_DownAxis;
+		inline static AxisId m_PitchAxis;
+		inline static AxisId m_YawAxis;
+		inline static AxisId m_ScrollAxis;
 
 		REFLECT(LevelEditorCamera)
 	};
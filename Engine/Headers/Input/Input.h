@@ -1,10 +1,16 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <deque>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <set>
 
 #include "Input/KeyCodes.h"
+#include "Utilities/StringId.h"
 
 namespace Ball
 {
@@ -39,6 +45,30 @@ namespace Ball
 		Xbox
 	};
 
+	// Handle to an action, get it once with Input::GetActionId so polling it doesn't hash the name every time
+	struct ActionId
+	{
+		static constexpr uint32_t INVALID = ~0u;
+
+		bool IsValid() const { return m_Index != INVALID; }
+
+		uint32_t m_Index = INVALID;
+	};
+
+	// Handle to an axis, get it once with Input::GetAxisId so polling it doesn't hash the name every time
+	struct AxisId
+	{
+		static constexpr uint32_t INVALID = ~0u;
+
+		bool IsValid() const { return m_Index != INVALID; }
+
+		uint32_t m_Index = INVALID;
+	};
+
+	using KeyBitset = std::bitset<NUM_KEY_CODES>;
+
+	struct InputFrame;
+
 	class Axis
 	{
 	public:
@@ -84,54 +114,74 @@ namespace Ball
 		KeyCode m_Keys[m_KeyCount]{};
 		// How many keys are bound to this action
 		int m_BoundKeyCount = 0;
+		std::string m_Name = "";
 	};
 
 	//
 	class Input
 	{
 	public:
+		// The engine owns the instance used by the game, tests can create their own and drive it with
+		// UpdateSynthetic()
+		Input();
+		~Input();
 		Input(const Input&) = delete;
 
 		Axis& CreateAxis(const std::string& name);
-		bool ContainsAxis(const std::string& name) const;
+		bool ContainsAxis(StringId name) const;
+		// Invalid id when the axis doesn't exist (yet), ids stay valid for the lifetime of the Input
+		AxisId GetAxisId(StringId name) const;
 
 		/// <summary>
 		/// Get the axis object that has been created before, used for rebinding ect.
 		/// </summary>
 		/// <param name="name"></param>
 		/// <returns></returns>
-		Axis& GetAxisBinding(const std::string& name);
+		Axis& GetAxisBinding(StringId name);
 
 		/// <summary>
 		/// Get current value of the axis
 		/// </summary>
 		/// <param name="name">Axis created with `CreateAxis`</param>
 		/// <returns></returns>
-		float GetAxis(const std::string& name) const;
+		float GetAxis(StringId name) const;
+		float GetAxis(AxisId id) const
+		{
+			assert(id.m_Index < m_AxisStates.size());
+			return m_AxisStates[id.m_Index];
+		}
 
 		// Check if any input has been pressed
 		bool GetAnyDown() const;
 
 		Action& CreateAction(const std::string& name);
-		bool ContainsAction(const std::string& name) const;
+		bool ContainsAction(StringId name) const;
+		// Invalid id when the action doesn't exist (yet), ids stay valid for the lifetime of the Input
+		ActionId GetActionId(StringId name) const;
 		/// <summary>
 		/// Get the action object that has been created before, used for rebinding ect.
 		/// </summary>
 		/// <param name="name"></param>
 		/// <returns></returns>
-		Action& GetActionBinding(const std::string& name);
+		Action& GetActionBinding(StringId name);
 		// Check If this Action is being held down
-		bool GetAction(const std::string& name) const;
+		bool GetAction(StringId name) const;
 		// Check if the Action got pressed this frame
-		bool GetActionDown(const std::string& name) const;
+		bool GetActionDown(StringId name) const;
 		// Check if the action got Released this frame
-		bool GetActionReleased(const std::string& name) const;
+		bool GetActionReleased(StringId name) const;
 		/// <summary>
 		/// Get the Raw state of an action
 		/// </summary>
 		/// <param name="name">Name of the action</param>
 		/// <returns>The raw state of the Action</returns>
-		KeyState GetActionRaw(const std::string& name) const;
+		KeyState GetActionRaw(StringId name) const;
+
+		// Same as the string versions, the states of all actions are calculated once per frame in Update()
+		bool GetAction(ActionId id) const { return GetActionState(id).m_Held; }
+		bool GetActionDown(ActionId id) const { return GetActionState(id).m_Pressed; }
+		bool GetActionReleased(ActionId id) const { return GetActionState(id).m_Released; }
+		KeyState GetActionRaw(ActionId id) const { return GetActionState(id).m_Raw; }
 
 		/// <summary>
 		/// Get raw keycode, please do not use this for gameplay!!!
@@ -146,8 +196,25 @@ namespace Ball
 		/// <summary>
 		/// Get all keys that have there state changed since last frame.
 		/// </summary>
-		/// <returns></returns>
-		const std::unordered_map<KeyCode, KeyState>& GetUpdatedKeys() const;
+		/// <returns>Bit per KeyCode, the new states can be read with GetRawKeyState</returns>
+		const KeyBitset& GetUpdatedKeys() const;
+
+		/// <summary>
+		/// Replaces the platform input for a frame, used by tests and input replays. Every key that is not in
+		/// keysDown gets released, the action and axis states are updated the same way as in Update().
+		/// </summary>
+		/// <param name="keysDown">Bit per KeyCode that is held down this frame</param>
+		/// <param name="axisValues">Raw value per JoyStick</param>
+		/// <param name="mouseDelta">Mouse movement of this frame</param>
+		/// <param name="blockGameplayInput">Same as the window being inactive in Update()</param>
+		void UpdateSynthetic(const KeyBitset& keysDown, const float (&axisValues)[NUM_JOYSTICKS],
+							 const glm::vec2& mouseDelta = glm::vec2(0.f), bool blockGameplayInput = false);
+
+		/// <summary>
+		/// Replaces the platform input with a frame recorded by InputRecorder. The recorded key states are applied
+		/// as they are instead of going through UpdateKeyState, so the replay matches the recording exactly.
+		/// </summary>
+		void UpdateFromRecording(const InputFrame& frame);
 
 		/// <summary>
 		/// Checks if a key is a controller or keyboard button.
@@ -175,6 +242,8 @@ namespace Ball
 
 		glm::vec2 GetMousePosition() const;
 		glm::vec2 GetMouseDelta() const { return m_MouseDelta; }
+		// Whether the actions and axes of this frame were blocked, see UpdateActions()
+		bool IsGameplayInputBlocked() const { return m_GameplayInputBlocked; }
 
 		void SetCursorState(CursorState newState);
 		CursorState GetCursorState() const { return m_CursorState; };
@@ -186,8 +255,19 @@ namespace Ball
 		friend class Engine;
 		friend class InputViewTool;
 
-		Input();
-		~Input();
+		struct ActionState
+		{
+			KeyState m_Raw = KeyState::NONE;
+			bool m_Held = false;
+			bool m_Pressed = false;
+			bool m_Released = false;
+		};
+
+		const ActionState& GetActionState(ActionId id) const
+		{
+			assert(id.m_Index < m_ActionStates.size());
+			return m_ActionStates[id.m_Index];
+		}
 
 		/// <summary>
 		/// Initialize input
@@ -210,14 +290,35 @@ namespace Ball
 		/// <param name="key"></param>
 		void UpdateKeyState(bool KeyDown, KeyCode key);
 
-		std::unordered_map<std::string, Action> m_Actions{};
-		std::unordered_map<std::string, Axis> m_Axes{};
-
-		// This does not look like a ideal structure of storing keystates, but makes lookup easier
-		std::unordered_map<KeyCode, KeyState> m_KeyStates{};
-		std::unordered_map<JoyStick, float> m_AxisValues{};
-
-		std::unordered_map<KeyCode, KeyState> m_UpdatedKeys{};
+		/// <summary>
+		/// Calculates the state of every action and axis from the key states of this frame.
+		/// </summary>
+		/// <param name="blockGameplayInput">Actions and axes read as released/0, used while the window is
+		/// inactive or ImGui has an item active</param>
+		void UpdateActions(bool blockGameplayInput);
+		KeyState CalculateActionRaw(const Action& action) const;
+		float CalculateAxis(const Axis& axis) const;
+
+		// Deques so the references returned by CreateAction/CreateAxis stay valid, indexed by ActionId/AxisId
+		std::deque<Action> m_Actions{};
+		std::deque<Axis> m_Axes{};
+		// Keyed by the hash of the name, looking up a literal doesn't construct a string
+		std::unordered_map<StringId, ActionId> m_ActionIds{};
+		std::unordered_map<StringId, AxisId> m_AxisIds{};
+		std::vector<ActionState> m_ActionStates{};
+		std::vector<float> m_AxisStates{};
+
+		// Indexed by KeyCode, only the keys in m_KnownKeys are updated by the platform
+		KeyState m_KeyStates[NUM_KEY_CODES]{};
+		KeyBitset m_KnownKeys{};
+		float m_AxisValues[NUM_JOYSTICKS]{};
+
+		// Edge bits of this frame, calculated from m_KeyStates in UpdateActions()
+		KeyBitset m_HeldKeys{};
+		KeyBitset m_PressedKeys{};
+		KeyBitset m_ReleasedKeys{};
+
+		KeyBitset m_UpdatedKeys{};
 
 		float m_Vibrations[2]{0, 0};
 		int m_ControllerID = 0;
@@ -225,6 +326,7 @@ namespace Ball
 		CursorState m_CursorState = CursorState::NONE;
 		CursorState m_PreUnfocusCursorState = CursorState::NONE;
 		glm::vec2 m_MouseDelta = glm::vec2(0.f);
+		bool m_GameplayInputBlocked = false;
 	};
 
 } // namespace Ball
\ No newline at end of file
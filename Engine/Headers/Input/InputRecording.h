@@ -0,0 +1,107 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Input/Input.h"
+
+namespace Ball
+{
+	class Transform;
+
+	struct KeyStateChange
+	{
+		KeyCode m_Key;
+		KeyState m_State;
+	};
+
+	// Everything Input got from the platform in one frame, plus the delta time of that frame
+	struct InputFrame
+	{
+		float m_DeltaTime = 0.f; // In milliseconds, the same as Engine::GetDeltaTime()
+		std::vector<KeyStateChange> m_KeyChanges{};
+		glm::vec2 m_MouseDelta = glm::vec2(0.f);
+		float m_AxisValues[NUM_JOYSTICKS]{};
+		// The window was inactive or ImGui had an item active, the actions and axes read as released
+		bool m_GameplayInputBlocked = false;
+	};
+
+	/// <summary>
+	/// Captures the input of every frame into a compact binary stream, only the keys whose state changed, the mouse
+	/// delta when it moved and the joystick axes that changed are stored. Played back with InputReplay.
+	/// Optionally a hash of the simulated state is stored per frame, so a replay can check that it ended up with the
+	/// same state as the recording.
+	/// </summary>
+	class InputRecorder
+	{
+	public:
+		InputRecorder();
+
+		// Call after Input::Update(), deltaTime is the time the frame is simulated with
+		void RecordFrame(const Input& input, float deltaTime);
+		// Call once per frame after the simulation, see HashTransform()
+		void RecordStateHash(uint64_t hash) { m_StateHashes.push_back(hash); }
+
+		// The state hashes are saved next to the recording, in <relativePath>.hashes
+		bool Save(const std::string& relativePath) const;
+
+		const std::vector<uint8_t>& GetData() const { return m_Data; }
+		const std::vector<uint64_t>& GetStateHashes() const { return m_StateHashes; }
+		uint32_t GetFrameCount() const { return m_FrameCount; }
+
+	private:
+		std::vector<uint8_t> m_Data{};
+		std::vector<uint64_t> m_StateHashes{};
+		float m_PreviousAxisValues[NUM_JOYSTICKS]{};
+		uint32_t m_FrameCount = 0;
+	};
+
+	/// <summary>
+	/// Feeds a stream made by InputRecorder back through Input. The delta time of a frame is needed before the input
+	/// is updated, so a frame is decoded with NextFrame() and applied later with ApplyInput().
+	/// </summary>
+	class InputReplay
+	{
+	public:
+		bool Load(const std::string& relativePath);
+		bool Load(std::vector<uint8_t> data, std::vector<uint64_t> stateHashes = {});
+
+		// Decodes the next frame, false when the recording is finished or corrupt
+		bool NextFrame();
+		// Replaces the platform input with the input of the current frame, call instead of Input::Update()
+		void ApplyInput(Input& input) const;
+		// Recorded delta time of the current frame in milliseconds
+		float GetDeltaTime() const { return m_Frame.m_DeltaTime; }
+
+		/// <summary>
+		/// Compares the state of the current frame with the hash that was recorded for it.
+		/// </summary>
+		/// <returns>False on a mismatch, true when it matches or there is no recorded hash</returns>
+		bool VerifyStateHash(uint64_t hash);
+
+		bool IsFinished() const { return m_ReadOffset >= m_Data.size(); }
+		// Number of frames decoded so far
+		uint32_t GetFrameCount() const { return m_FrameCount; }
+		uint32_t GetMismatchCount() const { return m_MismatchCount; }
+
+	private:
+		bool ReadFrame(InputFrame& frame);
+
+		std::vector<uint8_t> m_Data{};
+		std::vector<uint64_t> m_StateHashes{};
+		size_t m_ReadOffset = 0;
+		InputFrame m_Frame{};
+		uint32_t m_FrameCount = 0;
+		uint32_t m_MismatchCount = 0;
+	};
+
+	constexpr uint64_t TRANSFORM_HASH_SEED = 14695981039346656037ull; // FNV-1a offset basis
+
+	/// <summary>
+	/// FNV-1a hash of the position, rotation and scale bits of a transform. Replays are deterministic when the hashes
+	/// of every frame match between runs.
+	/// </summary>
+	/// <param name="hash">Hash to continue from, so the transforms of a level can be combined</param>
+	uint64_t HashTransform(Transform& transform, uint64_t hash = TRANSFORM_HASH_SEED);
+} // namespace Ball
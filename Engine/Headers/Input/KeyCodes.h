@@ -167,6 +167,9 @@ namespace Ball
 		GAMEPAD_R2,
 	};
 
+	// Size of arrays indexed by KeyCode
+	constexpr unsigned int NUM_KEY_CODES = GAMEPAD_R2 + 1;
+
 	enum JoyStick : unsigned char
 	{
 		JOYSTICK_NONE,
@@ -180,6 +183,9 @@ namespace Ball
 		SCROLL_WHEEL_H // Horizontal scroll, yeah some mouses have this...
 	};
 
+	// Size of arrays indexed by JoyStick
+	constexpr unsigned int NUM_JOYSTICKS = SCROLL_WHEEL_H + 1;
+
 	enum controllerMotor : unsigned char
 	{
 		MOTORLOWFREQ,
@@ -41,13 +41,6 @@ namespace Ball
 		// Draw ImGui ui that is required for the level
 		virtual void OnImGui() {}
 
-		/// Calculates the bounds of a level and stores it. if bounds have been calculated already it just returns them
-		/// as references
-		///
-		/// @param min reference that will be set to minimun of the bounds
-		/// @param max reference that will be set to maximum of the bounds
-		void GetLevelBounds(glm::vec3& min, glm::vec3& max, bool recalculate = false);
-
 		// Add an object of type T to the object manager.
 		// Only registered objects can be added to the object manager.
 		// - prefabName: Name of the prefab that you want to apply to the object. Leave empty for no prefab to be
@@ -80,11 +73,6 @@ namespace Ball
 	private:
 		std::string m_CurrentLevelPath;
 		LevelSaveType m_CurrentLevelType;
-
-		// Level bounds
-		glm::vec3 m_BoundsMin = glm::vec3(0.0f);
-		glm::vec3 m_BoundsMax = glm::vec3(0.0f);
-		bool m_ValidBounds = false;
 	};
 
 	template<typename T>
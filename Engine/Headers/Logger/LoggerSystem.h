@@ -2,6 +2,8 @@
 #include <string>
 #include <unordered_map>
 
+#include "Utilities/StringId.h"
+
 namespace Ball
 {
 	namespace Logger
@@ -72,15 +74,17 @@ namespace Ball
 		void SetColor(ELogLevel);
 
 		const std::string& LogLevelToString(ELogLevel logLevel);
-		std::string GetTimeStampString();
+		// Writes the time since startup, e.g. "1m 05s"
+		void FormatTimeStamp(char* buffer, size_t bufferSize);
 
-		std::unordered_map<std::string, ELogLevel> m_BlockedCategories{};
+		// Keyed by the hash of the category, checking a category doesn't build a string for every entry
+		std::unordered_map<StringId, ELogLevel> m_BlockedCategories{};
 		// Global ignore mask for Logging
 		ELogLevel m_BlockedLevelMask = ELogLevel::NONE;
 
 		bool IsBlocked(ELogLevel Level, const char* Category);
 
-		void CreateLogLevel(const char* Category);
+		ELogLevel& CreateLogLevel(const char* Category);
 
 		bool m_AllowWritingToFile = true;
 		static constexpr int m_MaxMemLogSize = 500; // The max size of MemLog before we write it to disk (in characters)
@@ -94,18 +98,23 @@ namespace Ball
 		if (IsBlocked(Level, Category))
 			return;
 
-		// Cursed way of getting string out of const char*'s
-		std::string formattedText;
+		// Most entries fit on the stack, only long ones need a heap allocation
+		char stackBuffer[512];
+		const int length = std::snprintf(stackBuffer, sizeof(stackBuffer), fmt, params...);
+		if (length < 0)
 		{
-			// Calculate the required buffer size
-			const int bufferSize = std::snprintf(nullptr, 0, fmt, params...) + 1; // +1 for null terminator
-
-			formattedText = std::string(bufferSize, '\0');
+			GenerateLogEntry(Level, Category, fileName, lineNumber, fmt);
+			return;
+		}
 
-			// Format the string
-			std::sprintf(formattedText.data(), fmt, params...);
+		if (length < static_cast<int>(sizeof(stackBuffer)))
+		{
+			GenerateLogEntry(Level, Category, fileName, lineNumber, stackBuffer);
+			return;
 		}
 
+		std::string formattedText(length + 1, '\0'); // +1 for null terminator
+		std::snprintf(formattedText.data(), formattedText.size(), fmt, params...);
 		GenerateLogEntry(Level, Category, fileName, lineNumber, formattedText.c_str());
 	}
 
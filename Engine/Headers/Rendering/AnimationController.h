@@ -8,9 +8,11 @@ namespace Ball
 	public:
 		AnimationController() = delete;
 		AnimationController(Model* model) { m_AnimatedModel = model; }
-		// Updates animation time and returns it
-		void Update(float dt);
-		void RebuildModelBlas();
+		// Updates animation time, the pose is only evaluated (and the BLAS refitted) when evaluatePose is set
+		void Update(float dt, bool evaluatePose = true);
+		// The last Update() evaluated a new pose, the BLAS of the model has to follow it
+		bool IsPoseDirty() const { return m_AnimDirtyFlag && m_AnimatedModel != nullptr; }
+		Model* GetModel() const { return m_AnimatedModel; }
 		void SetModel(Model* model) { m_AnimatedModel = model; }
 		float m_Speed = 1.f;
 		float m_TimeOffset = 0.f;
@@ -7,6 +7,7 @@
 
 namespace Ball
 {
+	// The REFIT_ qualities can be refitted but not compacted, the others are compacted by Compact()
 	enum class BlasQuality
 	{
 		FAST_BUILD,
@@ -15,11 +16,17 @@ namespace Ball
 		REFIT_FAST_TRAVERSE,
 	};
 
+	inline bool AllowsRefit(BlasQuality quality)
+	{
+		return quality == BlasQuality::REFIT_FAST_BUILD || quality == BlasQuality::REFIT_FAST_TRAVERSE;
+	}
+
 	struct BLASPrimitive
 	{
 		Buffer* m_VertexBuffer; // Vertext POSITION buffer
 		Buffer* m_IndexBuffer; // UINT32 index buffer
 		glm::mat4 m_ModelMatrix; // Ptimitive-to-model-space matrix
+		bool m_Opaque = true; // Alpha tested geometry isn't, any hit on it goes through the alpha test
 	};
 
 	class BLAS
@@ -28,13 +35,32 @@ namespace Ball
 		BLAS(const std::vector<BLASPrimitive*>& data, BlasQuality quality = BlasQuality::FAST_TRAVERSE,
 			 const std::string& name = "default_blas_name");
 		~BLAS();
-		void Update();
+		// Both upload the primitive matrices first. Refit keeps the tree and only moves its boxes, which falls back to
+		// a rebuild when the quality doesn't allow it.
+		void Refit();
+		void Rebuild();
+		// Copies the BLAS into a buffer of the size its build reported. Returns false when the quality doesn't allow
+		// it or that size isn't known yet. The old buffers are handed to FrameScheduler::DeferDeletion, they stay alive
+		// until the copy executed.
+		bool Compact();
+
 		// Getter
 		const GPUBlasHandle& GetBLASRef() const { return m_BLASHandle; }
+		BlasQuality GetQuality() const { return m_Quality; }
+		uint64_t GetSizeInBytes() const { return m_SizeInBytes; }
+		bool IsCompacted() const { return m_Compacted; }
+		// Changes with every build, refit and compaction, the TLAS has to be built again when it does
+		uint64_t GetVersion() const { return m_Version; }
 
 	private:
+		void UploadTransforms();
+
 		std::string m_Name;
 		std::vector<BLASPrimitive*> m_ModelData;
 		GPUBlasHandle m_BLASHandle;
+		BlasQuality m_Quality;
+		uint64_t m_SizeInBytes = 0;
+		uint64_t m_Version = 0;
+		bool m_Compacted = false;
 	};
 } // namespace Ball
\ No newline at end of file
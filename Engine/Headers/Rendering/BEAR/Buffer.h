@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include "TypeDefs.h"
+#include "Rendering/MemoryTracker.h"
 
 namespace Ball
 {
@@ -18,7 +19,9 @@ namespace Ball
 		UPLOAD_HEAP = 1 << 6, // Upload heap is fast to update - slower to access in shader, used for data which is
 							  // regularly updated
 		VERTEX_BUFFER = 1 << 7, // PS5 specific, as requires the unique struct
-		SCREENSIZE = 1 << 8
+		SCREENSIZE = 1 << 8,
+		PER_FRAME = 1 << 9 // Rewritten every frame while earlier frames are still in flight. Lives in the default heap,
+						   // UpdateData copies from upload memory owned by the frame being recorded
 	};
 
 	// Enable bitwise operations on the BufferFlags enum
@@ -40,7 +43,9 @@ namespace Ball
 		uint32_t GetSizeBytes() const { return m_Count * m_Stride; } // in Bytes
 		std::string GetName() const { return m_Name; }
 		BufferFlags GetFlags() const { return m_Flags; }
+		MemoryTag GetMemoryTag() const { return m_MemoryTag; }
 		GPUBufferHandle& GetGPUHandleRef() { return m_BufferHandle; }
+		// PER_FRAME buffers take one update per frame, a second one in the same frame overwrites what the first copies
 		void UpdateData(const void* data, uint32_t dataSizeInBytes);
 		void Resize(uint32_t newCount);
 
@@ -53,12 +58,18 @@ namespace Ball
 		~Buffer();
 
 		void CleanupHelperResources();
+		// Fills the upload buffer of the current frame slot and records the copy into the buffer
+		void UploadFrameCopy(const void* data, uint32_t dataSizeInBytes);
+		void ReleaseFrameUploaders();
 
 		GPUBufferHandle m_BufferHandle;
 		std::string m_Name = "DEFAULT_NAME_FOR_BUFFER";
 		uint32_t m_Stride = 0;
 		uint32_t m_Count = 0;
 		BufferFlags m_Flags = BufferFlags::NONE;
+		MemoryTag m_MemoryTag = MemoryTag::OTHER; // Set by BufferManager
+		uint32_t m_StagingBytes = 0; // Size of the upload buffer, reported to the MemoryTracker as STAGING
+		uint32_t m_FrameStagingBytes = 0; // Upload buffers of a PER_FRAME buffer, also reported as STAGING
 	};
 
 } // namespace Ball
@@ -35,6 +35,15 @@ namespace Ball
 		void BindResourceUAV(const uint32_t layoutLocation, Buffer& buffer);
 		void BindResourceUAV(const uint32_t layoutLocation, Texture& texture);
 
+		// Explicit barriers for the frame graph, the binders above already transition what they bind
+		void TransitionToSRV(Buffer& buffer);
+		void TransitionToSRV(Texture& texture);
+		void TransitionToUAV(Buffer& buffer);
+		void TransitionToUAV(Texture& texture);
+		// Waits for the writes of earlier dispatches to the resource before the next one accesses it
+		void UAVBarrier(Buffer& buffer);
+		void UAVBarrier(Texture& texture);
+
 		// Copy of Resources
 		void CopyResource(Buffer& bufferDst, Buffer& bufferSrc); // Buffers should have the same size
 		void CopyResource(Texture& textureDst, Texture& textureSrc); // Textures should have same size and format
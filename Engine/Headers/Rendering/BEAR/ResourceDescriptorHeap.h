@@ -3,6 +3,7 @@
 #include "Log.h"
 #include "TypeDefs.h"
 #include "Rendering/ModelLoading/Model.h"
+#include "Rendering/DescriptorAllocator.h"
 
 namespace Ball
 {
@@ -16,18 +17,49 @@ namespace Ball
 		ResourceDescriptorHeap(uint32_t maxNumberResources);
 		~ResourceDescriptorHeap();
 
-		// Reserves Spot without pushing anything
-		int ReserveSpace(uint32_t numSpacesToReserve = 1);
+		// Reserves Spot without pushing anything, returns the last reserved index
+		int ReserveSpace(uint32_t numSpacesToReserve = 1, const std::string& owner = "Reserved");
+
+		// Functions are inside header because then we dont need two implementations for the two platforms
+		// Reserves a contiguous range of slots, fill it in with Add(resource, heapID)
+		DescriptorRange Allocate(uint32_t numSpaces, const std::string& owner)
+		{
+			const DescriptorRange range = m_Allocator.Allocate(numSpaces, owner);
+			ASSERT_MSG(LOG_GRAPHICS, range.IsValid(), "Resource descriptor heap is full");
+			for (uint32_t i = 0; i < range.m_Count; i++)
+				SetElementName(range.m_Start + i, std::string("Reserved Spot, Currently Empty"));
+			return range;
+		}
+
+		// Slots get reused once the GPU finished the current frame
+		void Free(DescriptorRange& range)
+		{
+			for (uint32_t i = 0; range.IsValid() && i < range.m_Count; i++)
+				SetElementName(range.m_Start + i, std::string("null"));
+			m_Allocator.Free(range);
+		}
+
+		// Call once per frame, releases the slots freed in frames up to completedFence
+		void BeginFrame(uint64_t frameFence, uint64_t completedFence)
+		{
+			m_Allocator.BeginFrame(frameFence, completedFence);
+		}
 
 		// Pushes to the heap
 		int Add(Buffer& buffer);
 
+		// Creates the view in an already allocated slot
+		void Add(Buffer& buffer, int heapID);
+
 		// Switches a resource in the heap to the new one
 		void Switch(Buffer& newBuffer, int heapID);
 
 		// Pushes to the heap
 		int Add(Texture& texture);
 
+		// Creates the view in an already allocated slot
+		void Add(Texture& texture, int heapID);
+
 		// Switches a resource in the heap to the new one
 		void Switch(Texture& newTexture, int heapID);
 
@@ -50,24 +82,20 @@ namespace Ball
 		}
 
 		GPUDescriptorHeapHandle& GetDescriptorHeapHandleRef() { return m_DescriptorHeapHandle; }
-		int GetNumElements() const { return m_NumElements; }
+		const DescriptorAllocator& GetAllocator() const { return m_Allocator; }
 
 	private:
 		GPUDescriptorHeapHandle m_DescriptorHeapHandle;
-		int m_NumElements = 0;
-		[[maybe_unused]] int m_MaxSize = 0;
+		DescriptorAllocator m_Allocator;
 
 		// Array that stores the names of the textures added to the heap
 		std::vector<std::string> m_TextureNames;
 
-		void ReserveSpaceCommonLogic(int i)
+		void SetElementName(int heapID, const std::string& name)
 		{
-			WARN(LOG_GRAPHICS,
-				 "Resource Descriptor Entry [%i - %i] : RESERVED SPACE(s), Currently Empty",
-				 m_NumElements,
-				 (m_NumElements + i - 1));
-			m_NumElements += i;
-			m_TextureNames.insert(m_TextureNames.end(), i, std::string("Reserved Spot, Currently Empty"));
+			if (heapID >= static_cast<int>(m_TextureNames.size()))
+				m_TextureNames.resize(heapID + 1, std::string("null"));
+			m_TextureNames[heapID] = name;
 		}
 	};
 } // namespace Ball
\ No newline at end of file
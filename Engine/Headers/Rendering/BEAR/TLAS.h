@@ -18,6 +18,7 @@ namespace Ball
 	public:
 		TLAS(const std::vector<TlasInstanceData*>& levelData);
 		~TLAS();
+		// Builds the TLAS again when an instance moved or one of the BLASes changed since the last build
 		void Update();
 
 		// Getters
@@ -30,9 +31,15 @@ namespace Ball
 		void SetInstanceTransform(const glm::mat4& newTransform, const uint32_t id);
 
 	private:
+		// Compaction moves a BLAS, the instances have to point at its new buffer
+		void AddInstances();
+
 		// Reference to the Models in our world so we can always
 		// update the TLAS with the most relevant data.
 		std::vector<TlasInstanceData*> m_LevelData;
 		GPUTlasDescHandle m_TLAS;
+		// BLAS::GetVersion() of every instance at the last build
+		std::vector<uint64_t> m_BlasVersions;
+		bool m_TransformsDirty = false;
 	};
 } // namespace Ball
\ No newline at end of file
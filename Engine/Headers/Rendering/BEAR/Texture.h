@@ -3,6 +3,7 @@
 
 #include "TypeDefs.h"
 #include "Utilities/MathUtilities.h"
+#include "Rendering/MemoryTracker.h"
 
 namespace Ball
 {
@@ -84,6 +85,14 @@ namespace Ball
 		uint32_t GetNumChannels() const { return m_Channels; }
 		uint32_t GetWidth() const { return m_Spec.m_Width; }
 		uint32_t GetHeight() const { return m_Spec.m_Height; }
+		MemoryTag GetMemoryTag() const { return m_MemoryTag; }
+
+		// Estimated GPU memory, a full mip chain adds roughly a third to the top level
+		uint64_t GetSizeBytes() const
+		{
+			const uint64_t size = m_SizeInBytes;
+			return (m_Spec.m_Flags & TextureFlags::MIPMAP_GENERATE) != TextureFlags::NONE ? size * 4 / 3 : size;
+		}
 
 		uint32_t GetAlignedWidth() const
 		{
@@ -120,9 +129,11 @@ namespace Ball
 		TextureSpec m_Spec;
 		GPUTextureHandle m_TextureHandle = {};
 		uint32_t m_Channels = 0;
-		[[maybe_unused]] uint32_t m_SizeInBytes = 0;
+		uint32_t m_SizeInBytes = 0;
 		[[maybe_unused]] uint32_t m_BytesPerChannel = 1;
 		[[maybe_unused]] bool m_MipsGenerated = false;
 		std::string m_Name;
+		MemoryTag m_MemoryTag = MemoryTag::TEXTURES; // Set by TextureManager
+		uint32_t m_StagingBytes = 0; // Size of the upload buffer, reported to the MemoryTracker as STAGING
 	};
 } // namespace Ball
\ No newline at end of file
@@ -6,6 +6,7 @@ namespace Ball
 	class Window;
 	class Texture;
 	class CommandList;
+	class IGpuTimeline;
 	class BackEndRenderer
 	{
 	public:
@@ -13,7 +14,8 @@ namespace Ball
 		~BackEndRenderer(){};
 
 		void Initialize(Window* window, Texture** mainRenderTargets, CommandList* cmdList);
-		void BeginFrame();
+		// frameSlot comes from the FrameScheduler, the GPU has to be done with the last frame that used it
+		void BeginFrame(uint32_t frameSlot);
 		void EndFrame();
 		void Shutdown();
 		void EndTracing();
@@ -27,6 +29,7 @@ namespace Ball
 		uint32_t GetCurrentBackBufferIndex() const;
 
 		void PresentFrame();
-		void WaitForCmdQueueExecute();
+		// Fence of the queue the frames are submitted to
+		IGpuTimeline& GetGpuTimeline();
 	};
 } // namespace Ball
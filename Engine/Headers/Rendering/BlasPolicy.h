@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace Ball
+{
+	enum class BlasUsage
+	{
+		// Built once with fast trace and compacted afterwards
+		STATIC,
+		// Refitted whenever its pose changed, rebuilt once the refits degraded it too much
+		DEFORMING
+	};
+
+	enum class BlasOperation
+	{
+		REFIT,
+		REBUILD,
+		COMPACT
+	};
+
+	struct BlasPolicySettings
+	{
+		// Rebuilds and compactions of a frame stop once the estimated cost of all BLAS work passes this
+		float m_FrameBudgetMs = 1.f;
+		// CpuBvh::Degradation() at which a refitted BLAS is rebuilt
+		float m_RebuildThreshold = 1.25f;
+		// Frames between the build of a static BLAS and its compaction, the GPU has to have written its compacted
+		// size by then
+		uint32_t m_CompactionDelay = 2;
+		// Estimated GPU cost of each operation per million triangles
+		float m_RefitMsPerMillion = 0.5f;
+		float m_RebuildMsPerMillion = 4.f;
+		float m_CompactMsPerMillion = 0.5f;
+	};
+
+	struct BlasTask
+	{
+		uint32_t m_Id = 0;
+		BlasOperation m_Operation = BlasOperation::REFIT;
+		float m_EstimatedMs = 0.f;
+	};
+
+	struct BlasPolicyStats
+	{
+		// Totals since the manager was created
+		uint64_t m_Refits = 0;
+		uint64_t m_Rebuilds = 0;
+		uint64_t m_Compactions = 0;
+		uint64_t m_BytesBeforeCompaction = 0;
+		uint64_t m_BytesAfterCompaction = 0;
+
+		// Last Schedule()
+		float m_EstimatedMs = 0.f;
+		uint32_t m_DeferredRebuilds = 0;
+		uint32_t m_DeferredCompactions = 0;
+
+		uint64_t MemorySaved() const { return m_BytesBeforeCompaction - m_BytesAfterCompaction; }
+	};
+
+	/// <summary>
+	/// Decides what happens to every BLAS each frame, without touching the GPU so it can be tested anywhere. Static
+	/// BLASes get compacted once, deforming ones get refitted every frame they moved and rebuilt when the SAH cost of
+	/// their refitted tree drifted too far from the cost after their last build. Refits can't wait, rebuilds (most
+	/// degraded first) and compactions share what is left of the frame budget. One of them always runs when any are
+	/// waiting, so a budget that is too small only slows them down.
+	/// </summary>
+	class BlasPolicyManager
+	{
+	public:
+		BlasPolicyManager(const BlasPolicySettings& settings = BlasPolicySettings());
+
+		// BLASes are expected to have been built when they are registered
+		uint32_t Register(BlasUsage usage, uint32_t triangleCount);
+		void Unregister(uint32_t id);
+
+		// The BLAS needs a refit this frame, degradation is the CpuBvh::Degradation() of its new pose. Calling it
+		// again in the same frame keeps the worst degradation.
+		void MarkDeformed(uint32_t id, float degradation);
+
+		// Work for this frame, refits first. A rebuild replaces the refit of the same BLAS.
+		std::vector<BlasTask> Schedule();
+
+		// A scheduled compaction only counts once it is reported, until then it is scheduled again
+		void ReportCompaction(uint32_t id, uint64_t bytesBefore, uint64_t bytesAfter);
+
+		float EstimateMs(BlasOperation operation, uint32_t triangleCount) const;
+		bool IsRegistered(uint32_t id) const;
+		float GetDegradation(uint32_t id) const;
+		bool IsCompacted(uint32_t id) const;
+
+		uint64_t GetFrame() const { return m_Frame; }
+		const BlasPolicyStats& GetStats() const { return m_Stats; }
+		BlasPolicySettings& GetSettings() { return m_Settings; }
+
+	private:
+		struct Entry
+		{
+			BlasUsage m_Usage = BlasUsage::STATIC;
+			uint32_t m_TriangleCount = 0;
+			uint64_t m_BuildFrame = 0;
+			float m_Degradation = 1.f;
+			bool m_Registered = false;
+			bool m_Deformed = false;
+			bool m_Compacted = false;
+		};
+
+		BlasPolicySettings m_Settings;
+		BlasPolicyStats m_Stats;
+		std::vector<Entry> m_Entries;
+		std::vector<uint32_t> m_FreeIds;
+		uint64_t m_Frame = 0;
+	};
+} // namespace Ball
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <mutex>
+#include <unordered_set>
+
 #include "BEAR/Buffer.h"
 
 namespace Ball
@@ -15,7 +18,7 @@ namespace Ball
 	{
 	public:
 		static Buffer* Create(const void* data, uint32_t stride, uint32_t count, BufferFlags flags = BufferFlags::NONE,
-							  const std::string& name = "default_name");
+							  const std::string& name = "default_name", MemoryTag tag = MemoryTag::OTHER);
 
 		static void Destroy(Buffer* buffer);
 		static void DestroyAll();
@@ -32,7 +35,9 @@ namespace Ball
 		static void CleanupHelperResources();
 
 		friend BufferVisualizer; // Uses this data to display info about Buffers
-		static inline std::list<Buffer*> m_Buffers;
+		static inline std::unordered_set<Buffer*> m_Buffers;
 		static inline size_t m_BufferCount = 0;
+		// Models create their buffers from multiple threads
+		static inline std::mutex m_Mutex;
 	};
 } // namespace Ball
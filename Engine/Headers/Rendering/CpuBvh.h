@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Rendering/FrustumCulling.h"
+
+namespace Ball
+{
+	/// <summary>
+	/// Binned SAH bounding volume hierarchy over a triangle soup, a CPU stand-in for the BLAS the driver builds. Refit
+	/// moves the boxes with the vertices but keeps the tree, like an acceleration structure update does, so the SAH
+	/// cost after a refit compared to the cost of the last build tells how much tracing through the refitted BLAS
+	/// lost.
+	/// </summary>
+	class CpuBvh
+	{
+	public:
+		struct Node
+		{
+			AABB m_Bounds;
+			// Interior nodes: index of the left child, the right one follows it. Leaves: first triangle in m_Triangles
+			uint32_t m_First = 0;
+			// 0 for interior nodes
+			uint32_t m_Count = 0;
+
+			bool IsLeaf() const { return m_Count > 0; }
+		};
+
+		// Relative costs of the SAH, the same ones the build splits with
+		static constexpr float TRAVERSAL_COST = 1.f;
+		static constexpr float INTERSECTION_COST = 1.f;
+		static constexpr uint32_t BIN_COUNT = 16;
+		static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+		// Three vertices per triangle
+		void Build(const std::vector<glm::vec3>& vertices);
+		// Same triangles at new positions, the tree has to have been built from as many vertices
+		void Refit(const std::vector<glm::vec3>& vertices);
+
+		// Expected cost of a ray through the tree, area weighted and relative to the root, so it doesn't depend on
+		// the size of the model
+		float SAHCost() const;
+		// Unnormalized SAH cost over the cost right after the last Build, 1 when nothing degraded. Both are measured
+		// against the surface area of the triangles instead of the root box, which stays the same when rigid parts
+		// move apart and grow the root.
+		float Degradation() const;
+
+		bool IsEmpty() const { return m_Nodes.empty(); }
+		uint32_t GetTriangleCount() const { return static_cast<uint32_t>(m_Triangles.size()); }
+		const std::vector<Node>& GetNodes() const { return m_Nodes; }
+		// Triangle order of the leaves
+		const std::vector<uint32_t>& GetTriangles() const { return m_Triangles; }
+
+	private:
+		void Subdivide(uint32_t rootIndex, const std::vector<AABB>& triangleBounds,
+					   const std::vector<glm::vec3>& centers);
+		void FitLeaf(Node& node, const std::vector<glm::vec3>& vertices) const;
+		// SAH cost with the areas of the nodes themselves, over m_TriangleArea
+		float TriangleRelativeCost() const;
+
+		std::vector<Node> m_Nodes;
+		std::vector<uint32_t> m_Triangles;
+		float m_TriangleArea = 0.f;
+		float m_BuildCost = 0.f;
+	};
+} // namespace Ball
@@ -0,0 +1,139 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Rendering/FrameScheduler.h"
+#include "Rendering/FrustumCulling.h"
+#include "ShaderHeaders/DebugDrawGPU.h"
+
+namespace Ball
+{
+	struct Triangle;
+
+	enum class DebugDrawChannel
+	{
+		DEPTH_TESTED, // Hidden behind the geometry of the scene
+		OVERLAY, // Always on top
+		COUNT
+	};
+
+	// Records of one stream that were written during a frame
+	struct DebugPrimitiveRange
+	{
+		uint32_t m_First = 0; // Index of the first record in the memory given to DebugPrimitiveRing::Init
+		uint32_t m_Count = 0;
+	};
+
+	/// <summary>
+	/// Multi-producer ring of DebugPrimitiveGPU records. The memory holds one region per frame in flight, producers
+	/// reserve records in the region of the current frame with a compare exchange and write them directly, so with
+	/// persistently mapped memory nothing is copied. Reservations that don't fit are dropped.
+	/// </summary>
+	class DebugPrimitiveRing
+	{
+	public:
+		// - memory: capacity * numFrames records, e.g. a persistently mapped upload buffer
+		void Init(DebugPrimitiveGPU* memory, uint32_t capacity, uint32_t numFrames);
+
+		/// <summary>
+		/// Reserves count consecutive records in the current frame, safe to call from any thread. The records must
+		/// be written before EndFrame is called.
+		/// </summary>
+		/// <returns>nullptr when the frame is full</returns>
+		DebugPrimitiveGPU* Allocate(uint32_t count);
+
+		// Returns the records of the current frame and moves on to the next region. Not thread safe.
+		DebugPrimitiveRange EndFrame();
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		// Records that didn't fit since the last EndFrame
+		uint32_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+	private:
+		DebugPrimitiveGPU* m_Memory = nullptr;
+		uint32_t m_Capacity = 0;
+		uint32_t m_NumFrames = 1;
+		uint32_t m_Frame = 0;
+		std::atomic<uint32_t> m_Count{0};
+		std::atomic<uint32_t> m_Dropped{0};
+	};
+
+	/// <summary>
+	/// Debug lines and shapes of a frame, split into a stream of lines and a stream of instanced shapes per
+	/// channel. Shapes are expanded to lines by the vertex shader, ExpandDebugPrimitives does the same on the CPU.
+	/// All Add functions are safe to call from multiple threads.
+	/// </summary>
+	class DebugDrawStream
+	{
+	public:
+		enum Stream
+		{
+			DEPTH_TESTED_LINES,
+			DEPTH_TESTED_SHAPES,
+			OVERLAY_LINES,
+			OVERLAY_SHAPES,
+			NUM_STREAMS
+		};
+
+		// The rings advance every frame, so no region is rewritten before the frame that filled it finished
+		static constexpr uint32_t NUM_FRAMES = FrameScheduler::MAX_FRAMES_IN_FLIGHT;
+		static constexpr uint32_t CAPACITIES[NUM_STREAMS] = {131072, 8192, 32768, 8192};
+
+		// Records per frame in flight, the memory given to Init needs NUM_FRAMES times this
+		static constexpr uint32_t GetRecordsPerFrame()
+		{
+			return CAPACITIES[0] + CAPACITIES[1] + CAPACITIES[2] + CAPACITIES[3];
+		}
+
+		// Stream i uses the records starting at NUM_FRAMES * (CAPACITIES[0] + ... + CAPACITIES[i - 1]). With nullptr
+		// every record is dropped.
+		void Init(DebugPrimitiveGPU* memory);
+
+		void AddLine(const glm::vec3& start, const glm::vec3& end, const glm::vec3& color, DebugDrawChannel channel);
+		void AddAABB(const AABB& box, const glm::vec3& color, DebugDrawChannel channel);
+		void AddSphere(const glm::vec3& center, float radius, const glm::vec3& color, DebugDrawChannel channel);
+		// Local axes of transform, size is the length of the lines
+		void AddAxis(const glm::mat4& transform, float size, DebugDrawChannel channel);
+		// Edges of the view pyramid, the base is at the max distance of the frustum
+		void AddFrustum(const CullingFrustum& frustum, const glm::vec3& color, DebugDrawChannel channel);
+
+		// Reserves count line records for writers that produce many lines at once, fill them with WriteDebugLine
+		DebugPrimitiveGPU* AllocateLines(uint32_t count, DebugDrawChannel channel);
+
+		// Ends the frame of every stream, ranges are indexed by Stream
+		void EndFrame(DebugPrimitiveRange ranges[NUM_STREAMS]);
+
+		uint32_t GetDroppedCount() const;
+
+	private:
+		void AddShape(const glm::mat4& transform, uint32_t type, const glm::vec3& color, DebugDrawChannel channel);
+
+		DebugPrimitiveRing m_Rings[NUM_STREAMS];
+	};
+
+	uint32_t PackDebugColor(const glm::vec3& color);
+
+	inline void WriteDebugLine(DebugPrimitiveGPU& primitive, const glm::vec3& start, const glm::vec3& end,
+							   uint32_t packedColor)
+	{
+		primitive.m_Row0 = glm::vec4(start, 1.f);
+		primitive.m_Row1 = glm::vec4(end, 1.f);
+		primitive.m_Type = DEBUG_PRIMITIVE_LINE;
+		primitive.m_Color = packedColor;
+	}
+
+	// CPU fallback of the vertex shader, appends a start and end point for every line of the primitives
+	void ExpandDebugPrimitives(const DebugPrimitiveGPU* primitives, uint32_t count, std::vector<glm::vec3>& points);
+
+	struct DebugEdge
+	{
+		glm::vec3 m_Start;
+		glm::vec3 m_End;
+	};
+
+	// Edges shared by several triangles are only added once, so wireframes draw every edge once
+	void ExtractUniqueEdges(const std::vector<Triangle>& triangles, std::vector<DebugEdge>& edges);
+} // namespace Ball
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Ball
+{
+	// Contiguous block of descriptor slots, m_Start is the index used in the shaders (ResourceDescriptorHeap[i])
+	struct DescriptorRange
+	{
+		static constexpr uint32_t INVALID = ~0u;
+
+		uint32_t m_Start = INVALID;
+		uint32_t m_Count = 0;
+
+		bool IsValid() const { return m_Start != INVALID; }
+		uint32_t GetLast() const { return m_Start + m_Count - 1; }
+	};
+
+	struct DescriptorAllocatorStats
+	{
+		uint32_t m_PersistentCapacity = 0;
+		uint32_t m_PersistentAllocated = 0;
+		uint32_t m_NumAllocations = 0;
+		uint32_t m_NumFreeBlocks = 0;
+		uint32_t m_LargestFreeBlock = 0;
+		uint32_t m_PendingFrees = 0; // Slots waiting for the GPU to finish with them
+	};
+
+	/// <summary>
+	/// Manages the slots of a bindless descriptor heap without knowing anything about the graphics API.
+	/// Ranges are handed out from size class free lists and coalesced on free.
+	/// Frees are deferred: slots are only reused after BeginFrame() reports the fence of the freeing frame completed.
+	/// </summary>
+	class DescriptorAllocator
+	{
+	public:
+		explicit DescriptorAllocator(uint32_t capacity);
+
+		// Returns an invalid range when there's no block large enough
+		DescriptorRange Allocate(uint32_t count, const std::string& owner = "");
+		// The slots stay untouched until the GPU has finished the current frame, the range gets invalidated
+		void Free(DescriptorRange& range);
+
+		// frameFence is the value the new frame will signal, everything tagged <= completedFence is released
+		void BeginFrame(uint64_t frameFence, uint64_t completedFence);
+
+		DescriptorAllocatorStats GetStats() const;
+		uint32_t GetCapacity() const { return m_Capacity; }
+		bool IsAllocated(uint32_t index) const;
+
+#ifndef SHIPPING
+		struct DebugAllocation
+		{
+			DescriptorRange m_Range;
+			std::string m_Owner;
+		};
+		// Live persistent allocations, sorted by their start slot
+		std::vector<DebugAllocation> GetDebugAllocations() const;
+		// Owner of the persistent allocation containing index, empty when the slot is free
+		std::string GetOwner(uint32_t index) const;
+#endif
+
+	private:
+		struct Allocation
+		{
+			uint32_t m_Count = 0;
+#ifndef SHIPPING
+			std::string m_Owner;
+#endif
+		};
+
+		struct PendingFree
+		{
+			uint64_t m_Fence;
+			DescriptorRange m_Range;
+		};
+
+		static uint32_t GetSizeClass(uint32_t count);
+		void InsertFreeBlock(uint32_t start, uint32_t count);
+		void RemoveFreeBlock(uint32_t start, uint32_t count);
+		void Release(const DescriptorRange& range);
+
+		uint32_t m_Capacity = 0;
+
+		// Free blocks by start slot (for coalescing) and by size class (for allocation).
+		// Size class i holds the blocks with a size in [2^i, 2^(i+1))
+		static constexpr uint32_t NUM_SIZE_CLASSES = 32;
+		std::map<uint32_t, uint32_t> m_FreeBlocks;
+		std::set<uint32_t> m_SizeClasses[NUM_SIZE_CLASSES];
+
+		std::map<uint32_t, Allocation> m_Allocations;
+		std::vector<PendingFree> m_PendingFrees;
+		uint32_t m_PersistentAllocated = 0;
+
+		uint64_t m_CurrentFence = 0;
+	};
+} // namespace Ball
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Ball
+{
+	/// <summary>
+	/// Directional albedo tables of the GGX lobes in BsdfGPU.h, used by EvalBSDF to give back the energy single
+	/// scattering loses. Every entry holds E(mu) in x and E_avg in y, the layout is described next to ENERGY_LUT_SIZE.
+	/// </summary>
+	struct EnergyLUTs
+	{
+		// ENERGY_LUT_SIZE x ENERGY_LUT_SIZE, mu along x and alpha along y
+		std::vector<glm::vec2> m_Reflection;
+		// ENERGY_LUT_SIZE x (ENERGY_LUT_SIZE * ENERGY_LUT_ETA_SLICES), one reflection table per eta
+		std::vector<glm::vec2> m_Dielectric;
+	};
+
+	// Directional albedo of the GGX reflection with F = 1, seen from mu = NdotV. Integrated with numSamples points of
+	// a low discrepancy sequence over the visible normals, so the result is the same on every call.
+	float IntegrateReflectionAlbedo(float mu, float alphaRoughness, uint32_t numSamples);
+
+	// Reflection plus transmission of a white dielectric, with the Fresnel of f0 = ((eta - 1) / (eta + 1))^2 the way
+	// PbrSample picks between them
+	float IntegrateDielectricAlbedo(float mu, float alphaRoughness, float eta, uint32_t numSamples);
+
+	// E_avg, the cosine weighted average 2 * integral of E(mu) * mu over mu
+	float IntegrateAverageReflectionAlbedo(float alphaRoughness, uint32_t numSamples);
+	float IntegrateAverageDielectricAlbedo(float alphaRoughness, float eta, uint32_t numSamples);
+
+	// Integrates the rows of both tables in parallel. Each entry only depends on its own coordinates, so the tables
+	// are identical no matter how many threads ran or in which order.
+	EnergyLUTs BakeEnergyLUTs(uint32_t numSamples = 4096);
+
+	// Reads the tables cached in TempData. Bakes and caches them when the cache is missing, has another layout or
+	// version, or when -BakeEnergyLUT is passed.
+	EnergyLUTs LoadOrBakeEnergyLUTs();
+
+	// Lets the C++ version of EvalBSDF compensate with these tables, nullptr turns the compensation off again. The
+	// tables have to outlive the binding.
+	void BindEnergyLUTs(const EnergyLUTs* luts);
+} // namespace Ball
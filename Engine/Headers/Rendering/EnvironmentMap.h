@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "ShaderHeaders/EnvironmentMapGPU.h"
+
+namespace Ball
+{
+	// 8K HDRIs are averaged down to 1024 x 512 texels, 8 MB of entries
+	constexpr uint32_t MAX_ENVIRONMENT_DISTRIBUTION_WIDTH = 1024;
+
+	/// <summary>
+	/// 2D alias table over the texels of an equirectangular HDRI, weighted by luminance * sin(theta) so that
+	/// directions are picked proportional to the luminance the sky sends along them. A marginal table picks the row,
+	/// the conditional table of that row picks the column, both in constant time on the GPU.
+	/// </summary>
+	struct EnvironmentDistribution
+	{
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		// Marginal table, then one table per row, the layout EnvironmentMapGPU.h reads
+		std::vector<EnvironmentAliasEntry> m_Entries;
+	};
+
+	// Walker alias table over count weights (Vose's method). Only m_Probability and m_Alias are written, returns the
+	// sum of the weights. Without any weight every slot is equally likely.
+	double BuildAliasTable(const double* weights, uint32_t count, EnvironmentAliasEntry* entries);
+
+	// rgba holds width * height RGBA texels, the way stbi_loadf returns them. Blocks of texels are averaged, by the
+	// smallest whole factor that fits the width into maxWidth. The rows are built in parallel, the result doesn't
+	// depend on how many threads ran. A black HDRI gets a distribution that is uniform over the sphere.
+	EnvironmentDistribution BuildEnvironmentDistribution(const float* rgba, uint32_t width, uint32_t height,
+														 uint32_t maxWidth = MAX_ENVIRONMENT_DISTRIBUTION_WIDTH);
+
+	// Lets the C++ version of SampleEnvironment and EnvironmentPdf read this distribution, nullptr unbinds it. The
+	// distribution has to outlive the binding.
+	void BindEnvironmentDistribution(const EnvironmentDistribution* distribution);
+} // namespace Ball
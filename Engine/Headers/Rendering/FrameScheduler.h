@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace Ball
+{
+	/// <summary>
+	/// The part of a GPU queue the frame scheduler works with: a fence that counts the work submitted to it. The
+	/// direct CommandQueue implements it on Windows, the unit tests and benchmarks drive a fake one.
+	/// </summary>
+	class IGpuTimeline
+	{
+	public:
+		virtual ~IGpuTimeline() = default;
+
+		// Queues a signal after everything submitted so far, returns the value the fence reaches once that finished
+		virtual uint64_t Signal() = 0;
+		virtual uint64_t GetCompletedValue() const = 0;
+		// Blocks until the fence reached value
+		virtual void WaitForValue(uint64_t value) = 0;
+	};
+
+	struct FrameSchedulerStats
+	{
+		uint64_t m_Frames = 0;
+		// Frames that had to wait for the GPU to free their slot
+		uint64_t m_Waits = 0;
+		double m_LastWaitMs = 0.0;
+		double m_TotalWaitMs = 0.0;
+		uint64_t m_Deletions = 0;
+	};
+
+	/// <summary>
+	/// Lets the CPU record up to MAX_FRAMES_IN_FLIGHT frames ahead of the GPU. Every frame in flight owns a slot, and
+	/// whatever the CPU rewrites each frame (command allocators, upload buffers) has one copy per slot. BeginFrame only
+	/// blocks while the last frame that used its slot is still on the GPU. Resources released while frames are in
+	/// flight go through DeferDeletion and are kept alive until every frame that could still read them finished.
+	/// </summary>
+	class FrameScheduler
+	{
+	public:
+		static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+		FrameScheduler(IGpuTimeline& timeline, uint32_t framesInFlight = 2);
+
+		// Waits until the slot of the new frame is free and runs the deletions of the frames that finished. Returns
+		// the slot.
+		uint32_t BeginFrame();
+		// Signals the timeline after the command lists of the frame were submitted
+		void EndFrame();
+		// Waits for everything submitted so far, also work submitted outside of BeginFrame and EndFrame, and runs the
+		// deletions of every submitted frame
+		void WaitForIdle();
+
+		// Clamped to [1, MAX_FRAMES_IN_FLIGHT]. The GPU is drained at the next BeginFrame before the slots change.
+		void SetFramesInFlight(uint32_t framesInFlight);
+		uint32_t GetFramesInFlight() const { return m_PendingFramesInFlight; }
+
+		// Slot of the frame being recorded, or of the next one between EndFrame and BeginFrame
+		uint32_t GetFrameSlot() const { return m_Slot; }
+		// Frames are numbered from 1, 0 means none
+		uint64_t GetFrameNumber() const { return m_Frame; }
+		// Last frame the GPU finished, as of the last BeginFrame or WaitForIdle
+		uint64_t GetCompletedFrame() const { return m_CompletedFrame; }
+		bool IsRecording() const { return m_Recording; }
+
+		// Runs release once the GPU finished the frame being recorded, or the next one when called between frames.
+		// Safe to call from any thread.
+		void DeferDeletion(std::function<void()> release);
+		size_t GetPendingDeletions() const;
+
+		const FrameSchedulerStats& GetStats() const { return m_Stats; }
+
+	private:
+		struct SubmittedFrame
+		{
+			uint64_t m_Frame;
+			uint64_t m_FenceValue;
+		};
+
+		struct Deletion
+		{
+			uint64_t m_Frame;
+			std::function<void()> m_Release;
+		};
+
+		// Moves m_CompletedFrame up to the fence the GPU reached
+		void RetireFrames();
+		void RunDeletions(uint64_t completedFrame);
+
+		IGpuTimeline& m_Timeline;
+		uint32_t m_FramesInFlight = 2;
+		uint32_t m_PendingFramesInFlight = 2;
+		uint32_t m_Slot = 0;
+		uint64_t m_Frame = 0;
+		uint64_t m_CompletedFrame = 0;
+		bool m_Recording = false;
+
+		// Fence value signaled by the last frame that used each slot
+		std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_SlotFences = {};
+		std::deque<SubmittedFrame> m_Submitted;
+
+		// Sorted by frame, DeferDeletion only ever appends the newest one
+		std::deque<Deletion> m_Deletions;
+		mutable std::mutex m_DeletionMutex;
+
+		FrameSchedulerStats m_Stats;
+	};
+
+	// One copy of T for each frame in flight, indexed by FrameScheduler::GetFrameSlot()
+	template <typename T>
+	using PerFrame = std::array<T, FrameScheduler::MAX_FRAMES_IN_FLIGHT>;
+} // namespace Ball
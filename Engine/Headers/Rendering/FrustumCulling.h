@@ -0,0 +1,52 @@
+#pragma once
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "ShaderHeaders/CameraGPU.h"
+
+namespace Ball
+{
+	struct AABB
+	{
+		glm::vec3 m_Min = glm::vec3(FLT_MAX);
+		glm::vec3 m_Max = glm::vec3(-FLT_MAX);
+
+		// Default constructed boxes are empty until something is added to them
+		bool IsValid() const { return m_Min.x <= m_Max.x && m_Min.y <= m_Max.y && m_Min.z <= m_Max.z; }
+		glm::vec3 GetCenter() const { return (m_Min + m_Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (m_Max - m_Min) * 0.5f; }
+
+		void Grow(const glm::vec3& point);
+		void Grow(const AABB& box);
+
+		// Box around this box after transforming it, not as tight as transforming the geometry itself
+		AABB Transformed(const glm::mat4& transform) const;
+	};
+
+	/// <summary>
+	/// World space version of the camera's ViewPyramid. The pyramid starts at the camera position and has no near
+	/// plane, instead of a far plane everything further away than m_MaxDistance from the camera is culled.
+	/// </summary>
+	struct CullingFrustum
+	{
+		static constexpr int NUM_PLANES = 4;
+
+		static CullingFrustum FromViewPyramid(const ViewPyramid& pyramid, const glm::vec3& position, float maxDistance);
+
+		// Single box versions of CullAABBs
+		bool IsVisible(const AABB& box) const;
+		float GetDistance(const AABB& box) const;
+
+		// Normals are normalized and point inside, w = -dot(normal, m_Position)
+		glm::vec4 m_Planes[NUM_PLANES];
+		glm::vec3 m_Position = glm::vec3(0.f);
+		float m_MaxDistance = FLT_MAX;
+	};
+
+	// Tests the boxes 4 at a time with SSE. visible[i] is set to 1 when box i intersects the frustum, distances[i]
+	// (optional) to the distance between the camera and the closest point of the box, 0 when the camera is inside it
+	void CullAABBs(const CullingFrustum& frustum, const AABB* boxes, size_t count, uint8_t* visible, float* distances);
+} // namespace Ball
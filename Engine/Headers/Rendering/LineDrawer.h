@@ -3,6 +3,9 @@
 #include <glm/vec3.hpp>
 #include <vector>
 #include <glm/ext/matrix_float4x4.hpp>
+
+#include "Rendering/DebugDrawStream.h"
+
 namespace Ball
 {
 	struct Line
@@ -12,24 +15,31 @@ namespace Ball
 		glm::vec3 m_Color;
 	};
 
+	class Buffer;
 	class Camera;
 	class LineDrawer
 	{
 	public:
-		void AddLine(Line line);
-		void DrawLines(Camera* cam);
+		void AddLine(Line line, DebugDrawChannel channel = DebugDrawChannel::OVERLAY);
+		// depthBuffer: Distance to the primary hit per pixel, for the depth tested channel
+		void DrawLines(Camera* cam, Buffer* depthBuffer, uint32_t screenWidth);
 		void Init(uint32_t width, uint32_t height);
 		void Shutdown();
 
+		// Lines and shapes are written straight into GPU visible memory, from any thread
+		DebugDrawStream& GetStream() { return m_Stream; }
+
 	private:
-		struct LineData
+		// Root constants of the line shaders
+		struct LineSettings
 		{
-			glm::mat4 m_MVP;
-			glm::vec4 m_Color;
+			glm::mat4 m_ViewProjection;
+			glm::vec3 m_CameraPosition;
+			uint32_t m_ScreenWidth;
+			uint32_t m_DepthTest;
+			float m_DepthBias;
 		};
-		std::vector<Line> m_Lines;
 
-		// Not used on PS5
-		[[maybe_unused]] uint32_t m_MaxLinesNum = 200000;
+		DebugDrawStream m_Stream;
 	};
-}; // namespace Ball
\ No newline at end of file
+}; // namespace Ball
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Ball
+{
+	// What an allocation is used for, every GPU resource created through the managers gets one
+	enum class MemoryTag : uint8_t
+	{
+		WAVEFRONT, // Ray batches, hit data and other per pixel wavefront buffers
+		DENOISER,
+		MODEL_GEOMETRY, // Vertex/index/primitive/material buffers and scene data built from the models
+		TEXTURES, // Model textures, sky box, blue noise
+		RENDER_TARGETS, // Screen sized textures the frame is rendered into
+		STAGING, // Upload heaps used to copy data into default heap resources
+		OTHER,
+
+		NUM_TAGS,
+		TOTAL = NUM_TAGS // Sum of all tags, can be used for budgets and stats
+	};
+
+	struct MemoryTagStats
+	{
+		uint64_t m_LiveBytes = 0;
+		uint64_t m_PeakBytes = 0;
+		uint32_t m_NumAllocations = 0;
+		int64_t m_FrameDeltaBytes = 0; // Change of m_LiveBytes during the last finished frame
+		uint64_t m_BudgetBytes = 0; // 0 means no budget
+	};
+
+	/// <summary>
+	/// Keeps live/peak byte counters per MemoryTag for the resources created by BufferManager and TextureManager.
+	/// Budgets are checked once per frame in EndFrame(), a breach logs a warning (once, until the tag is back under
+	/// budget) and calls the registered callbacks every frame, so they can evict resources until it fits again.
+	/// </summary>
+	class MemoryTracker
+	{
+	public:
+		// Called every frame a tag is over budget, tag can be MemoryTag::TOTAL
+		using BudgetCallback = std::function<void(MemoryTag tag, const MemoryTagStats& stats)>;
+
+		void Allocate(MemoryTag tag, uint64_t bytes);
+		void Free(MemoryTag tag, uint64_t bytes);
+		void Resize(MemoryTag tag, uint64_t oldBytes, uint64_t newBytes);
+
+		// Calculates the per frame deltas and checks the budgets
+		void EndFrame();
+
+		void SetBudget(MemoryTag tag, uint64_t bytes);
+		void SetWarnOnBudgetBreach(bool warn) { m_WarnOnBudgetBreach = warn; }
+		uint32_t AddBudgetCallback(BudgetCallback callback);
+		void RemoveBudgetCallback(uint32_t callbackID);
+
+		// Logs a report every N frames from EndFrame(), 0 disables it. Used for headless runs that have no tools
+		void SetLogInterval(uint32_t frames) { m_LogInterval = frames; }
+		void LogReport() const;
+
+		MemoryTagStats GetStats(MemoryTag tag) const;
+		uint64_t GetFrameNumber() const { return m_FrameNumber; }
+		static const char* GetTagName(MemoryTag tag);
+
+	private:
+		static constexpr size_t NUM_STATS = static_cast<size_t>(MemoryTag::NUM_TAGS) + 1;
+
+		void AddBytes(MemoryTag tag, int64_t bytes, int32_t numAllocations);
+
+		struct CallbackEntry
+		{
+			uint32_t m_ID;
+			BudgetCallback m_Callback;
+		};
+
+		// Allocations happen from the model loading threads too
+		mutable std::mutex m_Mutex;
+		MemoryTagStats m_Stats[NUM_STATS];
+		uint64_t m_LiveBytesLastFrame[NUM_STATS] = {};
+		bool m_OverBudget[NUM_STATS] = {};
+		std::vector<CallbackEntry> m_BudgetCallbacks;
+		uint32_t m_NextCallbackID = 0;
+		bool m_WarnOnBudgetBreach = true;
+		uint32_t m_LogInterval = 0;
+		uint64_t m_FrameNumber = 0;
+	};
+
+	// Tracker that BufferManager and TextureManager report to
+	MemoryTracker& GetMemoryTracker();
+} // namespace Ball
@@ -16,7 +16,7 @@ namespace Ball
 		~Material() = default;
 
 		// TODO (Would): Support more than 1 Tex Coord
-		// TODO (Would): Support Alpha Modes and Cutoff
+		// TODO (Would): Support the BLEND Alpha Mode
 		// TODO (Would): Support "Double Sided"
 
 		MaterialGPU m_Data;
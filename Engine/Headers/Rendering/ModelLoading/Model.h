@@ -1,8 +1,12 @@
 #pragma once
 #include "ResourceManager/IResourceType.h"
+#include "Rendering/FrustumCulling.h"
+#include "Rendering/CpuBvh.h"
+#include "Rendering/DebugDrawStream.h"
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
@@ -27,6 +31,7 @@ namespace Ball
 	class ResourceDescriptorHeap;
 	class BLAS;
 	class ModelAnimation;
+	struct AlphaTexture;
 
 	struct Triangle
 	{
@@ -39,6 +44,12 @@ namespace Ball
 		void Draw(glm::mat4& transform) const;
 	};
 
+	// Ray cone data of every triangle in model space, RayCone::PackTriangleLOD of the LOD constant and the curvature.
+	// normals can be empty, the triangles are flat then.
+	std::vector<uint32_t> BuildTriangleLODs(const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>& uvs,
+											const std::vector<glm::vec3>& normals,
+											const std::vector<uint32_t>& indices);
+
 	struct PrimitiveLights
 	{
 		uint32_t m_PrimitiveID;
@@ -58,6 +69,9 @@ namespace Ball
 		// from the data above.
 		std::vector<Primitive>* m_PrimitiveBufferGPU;
 		std::vector<glm::mat4> m_PrevMatGpu;
+
+		// Unique edges of the triangles in m_CPUTris with the same keys, built when the wireframe is first drawn
+		std::unordered_map<uint64_t, std::vector<DebugEdge>> m_WireframeEdges;
 	};
 
 	class Model : public IResourceType
@@ -79,13 +93,23 @@ namespace Ball
 		void Unload() override;
 
 		BLAS& GetBLAS() { return *m_BLAS; }
+		// Uploads the primitive matrices of the current pose and returns how much refitting the BLAS to it degrades
+		// the BLAS, CpuBvh::Degradation() of the pose triangles
+		float UpdateBlasPose();
+		void RefitBlas();
+		// Also makes the current pose the one UpdateBlasPose() compares to
 		void RebuildBlas();
+		// Triangles of all primitives, instanced meshes count once per primitive like they do in the BLAS
+		uint32_t GetBlasTriangleCount() const;
 
 		const std::vector<PrimitiveLights>& GetLightsData() { return m_Lights; }
 		int m_ModelIndexID;
 
 		CpuPhysicsData& GetCPUPhysicsData() { return m_CpuPhysicsData; }
 
+		// Model space bounds of all primitives, for animated models also of the poses sampled over the animation
+		const AABB& GetBounds() const { return m_Bounds; }
+
 		// Animations
 		const bool HasAnimation() { return m_HasAnimation; }
 		void UpdateAnimations(float curTime);
@@ -97,6 +121,20 @@ namespace Ball
 
 		void GetCPUTrianglePrimitives(tinygltf::Model& model_cpu_data, std::vector<Mesh>& meshes);
 
+		// Grows m_Bounds by the poses at and between the key frames, the current pose is kept
+		void GrowBoundsOverAnimation();
+
+		// Model space vertices of every triangle in the current pose, three per triangle
+		void GatherPoseTriangles(std::vector<glm::vec3>& vertices) const;
+
+		// Appends a buffer of BuildTriangleLODs() to m_Buffers for every primitive with texture coordinates
+		void CreateTriangleLODBuffers(const tinygltf::Model& model, std::vector<Mesh>& meshes);
+
+		// Appends an opacity micromap to m_Buffers for every primitive with an alpha tested material, alphaTextures
+		// holds the alpha of their base color images by image index
+		void CreateOpacityMicromaps(const tinygltf::Model& model, std::vector<Mesh>& meshes,
+									const std::unordered_map<int, AlphaTexture>& alphaTextures);
+
 		// BLAS Structure on GPU used for TLAS Creation
 		BLAS* m_BLAS;
 
@@ -105,6 +143,9 @@ namespace Ball
 
 		// Physics Collision Data
 		CpuPhysicsData m_CpuPhysicsData;
+		AABB m_Bounds;
+		// Bounds of every primitive in its own space, empty without min/max on the positions
+		std::vector<AABB> m_PrimitiveBounds;
 
 		// All textures specified in the glTF were loading
 		std::vector<Texture*> m_Textures;
@@ -120,6 +161,10 @@ namespace Ball
 
 		bool m_HasAnimation;
 		ModelAnimation* m_Animation = nullptr;
+
+		// Tree of the pose the BLAS was last built with, refitted along to measure the BLAS refits
+		CpuBvh m_PoseBvh;
+		std::vector<glm::vec3> m_PoseVertices;
 	};
 
 } // namespace Ball
\ No newline at end of file
@@ -60,6 +60,8 @@ namespace Ball
 		bool LoadAnimations(const tinygltf::Model& model);
 		void UpdateAnimations(OutBlasConstructor* outBlasConstrData, CpuPhysicsData* cpuData, float curTime);
 		std::vector<AnimNode>& GetPrimOrderRef() { return m_RecursivePrimOrder; }
+		// Key frame times of all samplers, unsorted and with duplicates
+		const std::vector<float>& GetKeyFrameTimes() const { return m_TimeKeyFarmes; }
 
 	private:
 		std::vector<AnimChannel> m_AnimChannels;
@@ -1,9 +1,15 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
+#include <vector>
 
 #include "ResourceManager/Resource.h"
+#include "Rendering/BlasPolicy.h"
+#include "Rendering/DescriptorAllocator.h"
+#include "Rendering/FrustumCulling.h"
+#include "Utilities/PoolAllocator.h"
 #include "ShaderHeaders/GpuModelStruct.h"
 
 namespace Ball
@@ -13,6 +19,7 @@ namespace Ball
 	class Buffer;
 	class ResourceDescriptorHeap;
 	class Model;
+	class BLAS;
 	class GameObject;
 
 	class ModelManager
@@ -24,7 +31,11 @@ namespace Ball
 		void RequestReloadModels();
 		void ProcessModelLoadingQueue(ResourceDescriptorHeap& rdhToStoreModels);
 		void UpdateInstanceTransformsBuffer();
-		void UpdateAnimations();
+		// Culls the world space bounds of all objects with a model against the active camera
+		void UpdateVisibility();
+		// deltaTime in seconds, the same time step the level is updated with
+		void UpdateAnimations(float deltaTime);
+		// Uploads the new poses and refits, rebuilds and compacts the BLASes the policy picked for this frame
 		void UpdateAnimationsGPU();
 		void AnimationImGui();
 		// Adds a Models' Buffers and Textures and saves them as added
@@ -38,10 +49,24 @@ namespace Ball
 
 		bool ReloadingModels() const { return m_ReloadModels; }
 
+		// Results of the last UpdateVisibility(), objects without (loaded) bounds are always visible at distance 0.
+		// Only CPU side work should be skipped with these, the path tracer still sees objects outside the frustum
+		bool IsVisible(const GameObject* object) const;
+		float GetViewDistance(const GameObject* object) const;
+		const CullingFrustum& GetCullingFrustum() const { return m_CullingFrustum; }
+		BlasPolicyManager& GetBlasPolicy() { return m_BlasPolicy; }
+
+		// Off-screen animations are evaluated every N frames, visible ones past the LOD distance every 2 frames
+		int m_OffscreenAnimationInterval = 8;
+		float m_AnimationLodDistance = 50.f;
+		bool m_DrawCullingBounds = false;
+
 	private:
 		void RebuildTLAS(ResourceDescriptorHeap& rdhToStoreTLASBuffers);
 
 		void FillInLights();
+		// Registers new and reloaded models with the BLAS policy, forgets the ones not in loadedPaths
+		void UpdateBlasRegistrations(const std::unordered_set<std::string>& loadedPaths);
 
 		std::vector<TlasInstanceData*> CreateTlasInstanceData();
 
@@ -57,5 +82,32 @@ namespace Ball
 
 		// Animations
 		std::vector<GameObject*> m_AnimatedGameObjects;
+		uint32_t m_AnimationFrame = 0;
+
+		// Visibility, kept between frames so the vectors don't reallocate
+		CullingFrustum m_CullingFrustum;
+		std::vector<AABB> m_CullingBounds;
+		std::vector<uint8_t> m_Visible;
+		std::vector<float> m_ViewDistances;
+		std::unordered_map<const GameObject*,
+						   uint32_t,
+						   std::hash<const GameObject*>,
+						   std::equal_to<const GameObject*>,
+						   PoolAllocator<std::pair<const GameObject* const, uint32_t>>>
+			m_CullingIndices;
+
+		// Descriptor slots of every model added to the heap, by model path. Kept between reloads
+		std::unordered_map<std::string, DescriptorRange> m_ModelDescriptorRanges;
+
+		// BLAS of every loaded model by model path, the policy id indexes m_BlasPaths
+		struct BlasRecord
+		{
+			Model* m_Model = nullptr;
+			BLAS* m_Blas = nullptr;
+			uint32_t m_PolicyId = 0;
+		};
+		BlasPolicyManager m_BlasPolicy;
+		std::unordered_map<std::string, BlasRecord> m_BlasRecords;
+		std::vector<std::string> m_BlasPaths;
 	};
 } // namespace Ball
@@ -18,6 +18,14 @@ namespace Ball
 		uint32_t GetPositionIndex() const { return m_Data.m_PositionIndex; }
 		uint32_t GetIndexBufferIndex() const { return m_Data.m_IndexBufferId; }
 		uint32_t GetMaterialIndex() const { return m_Data.m_MaterialIndex; }
+		// -1 when the primitive doesn't have the attribute
+		int GetTexCoordIndex() const { return m_Data.m_TexCoordIndex; }
+		int GetNormalIndex() const { return m_Data.m_NormalIndex; }
+
+		void SetTriangleLODIndex(int bufferIndex) { m_Data.m_TriangleLODIndex = bufferIndex; }
+		// Primitives with an opacity micromap are alpha tested, their BLAS geometry isn't opaque
+		int GetOpacityMicromapIndex() const { return m_Data.m_OpacityMicromapIndex; }
+		void SetOpacityMicromapIndex(int bufferIndex) { m_Data.m_OpacityMicromapIndex = bufferIndex; }
 
 		void SetMatrix(glm::mat4 mat) { m_Data.m_Model = mat; }
 		glm::mat4 GetMatrix() const { return m_Data.m_Model; }
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "ShaderHeaders/OpacityMicromapGPU.h"
+
+namespace Ball
+{
+	// How the sampler of the alpha texture addresses outside [0, 1], the glTF wrap modes
+	enum class AlphaWrap
+	{
+		REPEAT,
+		CLAMP,
+		MIRROR
+	};
+
+	/// <summary>
+	/// Alpha channel of a base color texture, kept on the CPU to bake opacity micromaps from.
+	/// </summary>
+	struct AlphaTexture
+	{
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		// Alpha of a texel is m_Alpha / MAX_VALUE. 8 bit textures are widened, 16 bit ones keep their full precision
+		// so the bake compares the same value against the cutoff as the alpha test on the GPU
+		static constexpr uint16_t MAX_VALUE = 0xffffu;
+
+		// Row major
+		std::vector<uint16_t> m_Alpha;
+	};
+
+	struct OpacityMicromapSettings
+	{
+		// Alpha of a texel is m_AlphaScale * texel, opaque when >= m_AlphaCutoff (the glTF material values)
+		float m_AlphaCutoff = 0.5f;
+		float m_AlphaScale = 1.f;
+		AlphaWrap m_Wrap = AlphaWrap::REPEAT;
+		// Unknown triangles are split until a micro-triangle covers about this many texels
+		float m_TexelsPerMicroTriangle = 8.f;
+		uint32_t m_MaxLevel = 5;
+	};
+
+	/// <summary>
+	/// What a bake found. The areas are model space areas, an any hit lands on a triangle in proportion to its area,
+	/// so m_KnownArea / m_TotalArea is the fraction of alpha test texture fetches the micromap saves.
+	/// </summary>
+	struct OpacityMicromapStats
+	{
+		size_t m_Triangles = 0;
+		size_t m_SubdividedTriangles = 0;
+		size_t m_MicroTriangles = 0;
+		double m_TotalArea = 0.0;
+		double m_KnownArea = 0.0;
+
+		double FetchesEliminated() const { return m_TotalArea > 0.0 ? m_KnownArea / m_TotalArea : 1.0; }
+		void Add(const OpacityMicromapStats& other);
+	};
+
+	// Alpha the GPU reads at uv, bilinear between the four nearest texel centers and scaled, before the cutoff. Also
+	// the brute force reference the bake is tested against.
+	float SampleAlphaBilinear(const AlphaTexture& texture, glm::vec2 uv, const OpacityMicromapSettings& settings);
+
+	// The buffer OpacityState() reads for one primitive. Triangles are classified whole first, unknown ones are split
+	// into micro-triangles by their texel area. A (micro-)triangle is only known when every texel that bilinear or
+	// point filtering could read inside its uv bounds agrees, a min/max pyramid of the texture answers that. Triangles
+	// are baked in parallel, the result doesn't depend on the number of threads. Adds to stats when given.
+	std::vector<uint32_t> BuildOpacityMicromap(const std::vector<glm::vec3>& positions,
+											   const std::vector<glm::vec2>& uvs,
+											   const std::vector<uint32_t>& indices,
+											   const AlphaTexture& texture,
+											   const OpacityMicromapSettings& settings,
+											   OpacityMicromapStats* stats = nullptr);
+} // namespace Ball
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+
+namespace Ball
+{
+	// How reservoirs from other pixels or frames are merged into the receiving one
+	enum class ReservoirCombine
+	{
+		BIASED_SOURCE_TARGET, // CombineReservoirs, what the shaders do: the target of the source pixel and 1 / M
+		BIASED, // Target re-evaluated at the receiving pixel, still 1 / M
+		GENERALIZED_BALANCE, // Unbiased, every sample weighted against the targets of all reservoirs
+		PAIRWISE // Unbiased, every neighbour only weighted against the receiving reservoir
+	};
+
+	// Same order as ReStirSettings::m_UseReSTIR, starting at 1
+	enum class ReuseStrategy
+	{
+		RIS,
+		TEMPORAL,
+		SPATIAL,
+		TEMPORAL_SPATIAL
+	};
+
+	const char* ToString(ReservoirCombine combine);
+	const char* ToString(ReuseStrategy strategy);
+
+	/// <summary>
+	/// Synthetic direct lighting problem the ReSTIR passes are run on. The receivers are a grid of pixels on two
+	/// planes meeting at a crease in the middle of the screen, lit by random point lights above them. A wall along
+	/// the crease keeps the lights of one side from reaching the other, so neighbours across it can't produce some
+	/// of the samples. The target is the unshadowed contribution of a light, the integrand also has a hashed
+	/// visibility term, so the target is only an approximation of it, like on the GPU. The static scene is seen with
+	/// a sub pixel jitter every frame, so the temporal neighbour has a slightly different target too.
+	/// </summary>
+	struct ReSTIRReferenceSettings
+	{
+		ReuseStrategy m_Strategy = ReuseStrategy::TEMPORAL_SPATIAL;
+		ReservoirCombine m_Combine = ReservoirCombine::BIASED_SOURCE_TARGET;
+
+		uint32_t m_NumLights = 64;
+		uint32_t m_Width = 32;
+		uint32_t m_Height = 16;
+		float m_CreaseAngle = 0.5f; // Tilt of each plane in radians
+		float m_Jitter = 0.5f; // In pixels
+
+		// Same meaning as the renderer's settings
+		int m_RISRandomLights = 16;
+		int m_CurrentLightClamp = 20;
+		int m_NumSpatialSamples = 5;
+		float m_SpatialRadius = 4.f;
+		float m_NormalThreshold = 0.25f; // Neighbours further away in normal distance are rejected
+
+		uint32_t m_NumFrames = 8; // The estimate of the last frame is measured
+		uint32_t m_NumTrials = 64; // Independent runs
+		uint32_t m_Seed = 1;
+	};
+
+	struct ReSTIRReferenceResult
+	{
+		// (mean estimate - ground truth) / ground truth, over the whole screen
+		double m_RelativeBias = 0.0;
+		// Standard error of m_RelativeBias between the trials, a bias within a few of these is noise
+		double m_BiasStandardError = 0.0;
+		// Root mean square over the pixels of their relative bias, biases of different sign don't cancel out here
+		double m_PixelBias = 0.0;
+		// Mean over the pixels of the variance of estimate / ground truth
+		double m_RelativeVariance = 0.0;
+		double m_RelativeRMSE = 0.0;
+		// Cost, target evaluations for RIS and reuse per pixel per frame
+		double m_TargetEvaluations = 0.0;
+	};
+
+	/// <summary>
+	/// CPU version of the RIS, temporal and spatial ReSTIR passes using the reservoir operations of ReservoirGPU.h.
+	/// Compares the shaded estimate against the ground truth sum over all lights.
+	/// </summary>
+	ReSTIRReferenceResult RunReSTIRReference(const ReSTIRReferenceSettings& settings);
+} // namespace Ball
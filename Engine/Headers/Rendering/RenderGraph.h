@@ -0,0 +1,188 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Ball
+{
+	class Buffer;
+	class Texture;
+
+	// Index of a resource declared on a RenderGraph, only valid for the graph that created it
+	typedef uint32_t RGResourceHandle;
+	constexpr RGResourceHandle RG_INVALID_RESOURCE = ~0u;
+
+	enum class RGResourceState : uint8_t
+	{
+		UNDEFINED, // Never touched this frame (or the memory was just aliased)
+		SRV, // Read only access (t0)
+		UAV // Read/Write access (u0)
+	};
+
+	enum class RGBarrierType : uint8_t
+	{
+		TRANSITION, // Resource state changes between passes
+		UAV, // Same state, but a previous UAV write has to finish before the next access
+		ALIASING // Transient memory gets reused by a different resource
+	};
+
+	struct RGBarrier
+	{
+		RGBarrierType m_Type = RGBarrierType::TRANSITION;
+		RGResourceHandle m_Resource = RG_INVALID_RESOURCE;
+		RGResourceHandle m_AliasedFrom = RG_INVALID_RESOURCE; // Only for ALIASING
+		RGResourceState m_Before = RGResourceState::UNDEFINED;
+		RGResourceState m_After = RGResourceState::UNDEFINED;
+	};
+
+	struct RGResource
+	{
+		std::string m_Name;
+		uint64_t m_SizeBytes = 0;
+
+		// Transient resources live only inside the frame and their memory can alias other transient resources.
+		// Imported resources (history buffers, output textures) persist and never alias.
+		bool m_Transient = true;
+
+		// Outputs are consumed outside the graph (presentation, next frame), their writers are never culled
+		bool m_Output = false;
+
+		// Optional backing resources the barriers are issued on, the graph itself never dereferences them
+		Buffer* m_Buffer = nullptr;
+		Texture* m_Texture = nullptr;
+
+		// Filled in by Compile()
+		int m_FirstPass = -1; // Index into the execution order
+		int m_LastPass = -1;
+		uint64_t m_HeapOffset = 0; // Offset in the shared transient heap
+	};
+
+	enum class RGAccess : uint8_t
+	{
+		READ,
+		WRITE,
+		READ_WRITE
+	};
+
+	struct RGPass
+	{
+		std::string m_Name;
+		std::function<void()> m_Execute;
+
+		struct Access
+		{
+			RGResourceHandle m_Resource;
+			RGAccess m_Access;
+		};
+		std::vector<Access> m_Accesses;
+
+		bool m_SideEffect = false; // Pass does work the graph can't see (e.g. writes through the bindless heap)
+		bool m_Debug = false; // Visualizers etc, culled when debug passes are disabled
+
+		// Filled in by Compile()
+		bool m_Culled = false;
+		uint32_t m_DependencyLevel = 0; // Passes with the same level have no dependencies between them
+		std::vector<RGBarrier> m_Barriers; // Barriers to issue before executing this pass
+	};
+
+	class RenderGraph;
+
+	// Builder returned by RenderGraph::AddPass, declares what a pass reads and writes
+	class RGPassBuilder
+	{
+	public:
+		RGPassBuilder& Read(RGResourceHandle resource);
+		RGPassBuilder& Write(RGResourceHandle resource);
+		RGPassBuilder& ReadWrite(RGResourceHandle resource);
+		RGPassBuilder& SideEffect();
+		RGPassBuilder& Debug();
+
+	private:
+		friend class RenderGraph;
+		RGPassBuilder(RenderGraph& graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+		RGPassBuilder& AddAccess(RGResourceHandle resource, RGAccess access);
+		// Looked up on every call, adding passes can move them
+		RGPass& GetPass();
+
+		RenderGraph& m_Graph;
+		uint32_t m_Pass;
+	};
+
+	struct RGStats
+	{
+		uint32_t m_NumPasses = 0;
+		uint32_t m_NumCulledPasses = 0;
+		uint32_t m_NumTransitionBarriers = 0;
+		uint32_t m_NumUAVBarriers = 0;
+		uint32_t m_NumAliasingBarriers = 0;
+
+		// Memory every transient resource would need if all of them were alive for the whole program
+		uint64_t m_TransientBytesUnaliased = 0;
+		// Peak memory of a shared transient heap after aliasing resources with disjoint lifetimes. The renderer's
+		// transient buffers are still committed resources, so this is what placing them in one heap would save.
+		uint64_t m_TransientBytesAliased = 0;
+	};
+
+	/// <summary>
+	/// CPU side frame graph. Passes declare the resources they read and write, Compile() then figures out the
+	/// execution order, culls passes that don't contribute to an output, computes the barriers needed between passes
+	/// and packs transient resources with non-overlapping lifetimes into a shared heap.
+	/// Compile() has no GPU dependencies so it can be unit tested, Execute() hands the barriers to the backend. The
+	/// heap offsets are a plan only: the renderer issues the transition and UAV barriers but doesn't place its
+	/// transient buffers in a heap yet, so it has no aliasing barriers to issue either.
+	/// </summary>
+	class RenderGraph
+	{
+	public:
+		// D3D12 placed resources need 64KB alignment
+		static constexpr uint64_t HEAP_ALIGNMENT = 64 * 1024;
+
+		RGResourceHandle CreateTransientBuffer(const std::string& name, uint64_t sizeBytes, Buffer* buffer = nullptr);
+		RGResourceHandle ImportBuffer(const std::string& name, uint64_t sizeBytes, Buffer* buffer = nullptr);
+		RGResourceHandle ImportTexture(const std::string& name, uint64_t sizeBytes, Texture* texture = nullptr);
+		void MarkOutput(RGResourceHandle resource);
+
+		RGPassBuilder AddPass(const std::string& name, std::function<void()> execute = {});
+
+		void SetDebugPassesEnabled(bool enabled) { m_DebugPassesEnabled = enabled; }
+
+		void Compile();
+		// Runs every non culled pass in order, handing the barriers of each pass to the callback beforehand
+		void Execute(const std::function<void(const RGBarrier&)>& issueBarrier = {}) const;
+
+		// Removes all passes and resources but keeps the allocated memory, so the graph can be rebuilt every frame
+		void Reset();
+
+		const std::vector<RGPass>& GetPasses() const { return m_Passes; }
+		const std::vector<RGResource>& GetResources() const { return m_Resources; }
+		const RGResource& GetResource(RGResourceHandle resource) const { return m_Resources[resource]; }
+		// Indices into GetPasses(), in the order they're executed (culled passes excluded)
+		const std::vector<uint32_t>& GetExecutionOrder() const { return m_ExecutionOrder; }
+		const RGStats& GetStats() const { return m_Stats; }
+		bool IsCompiled() const { return m_Compiled; }
+
+	private:
+		friend class RGPassBuilder;
+
+		void BuildDependencies();
+		void CullPasses();
+		void SortPasses();
+		void ComputeBarriers();
+		void AliasTransientResources();
+
+		std::vector<RGPass> m_Passes;
+		std::vector<RGResource> m_Resources;
+		std::vector<uint32_t> m_ExecutionOrder;
+
+		// Edges between passes, m_Producers only holds read-after-write edges (the ones that keep passes alive)
+		std::vector<std::vector<uint32_t>> m_Dependencies;
+		std::vector<std::vector<uint32_t>> m_Producers;
+		// Earlier writers of the resources a pass ReadWrites. When the pass is disabled its consumers still need them.
+		std::vector<std::vector<uint32_t>> m_ReadWriteProducers;
+
+		RGStats m_Stats;
+		bool m_DebugPassesEnabled = true;
+		bool m_Compiled = false;
+	};
+} // namespace Ball
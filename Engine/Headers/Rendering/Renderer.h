@@ -5,9 +5,11 @@
 
 #include "ShaderHeaders/GpuModelStruct.h"
 #include "ShaderHeaders/CameraGPU.h"
+#include "ShaderHeaders/EnvironmentMapGPU.h"
 #include "ShaderHeaders/WavefrontStructsGPU.h"
 
 #include "Rendering/LineDrawer.h"
+#include "Rendering/RenderGraph.h"
 #include "ShaderHeaders/GpuGridStruct.h"
 #include "ShaderHeaders/TonemapStructsGPU.h"
 #include "Utilities/RenderUtilities.h"
@@ -29,7 +31,9 @@ namespace Ball
 	class ResourceDescriptorHeap;
 	class SamplerDescriptorHeap;
 	class Denoiser;
+	class FrameScheduler;
 	class GameObject;
+	struct AABB;
 
 	struct BloomSettings
 	{
@@ -55,13 +59,30 @@ namespace Ball
 
 		ModelManager* GetModelManager() { return m_ModelManager; }
 		uint32_t GetFrameNumber() const { return m_NumTotalFrames; }
+		// Index into the Sobol sequence. While accumulating it counts the accumulated frames, so every accumulation
+		// starts at the beginning of the sequence, otherwise it follows the frame number
+		uint32_t GetSampleIndex() const
+		{
+			return m_AccumFramesEnabled && m_AccumFramesNum > 0 ? m_AccumFramesNum - 1 : m_NumTotalFrames;
+		}
 
 		void TakeScreenshot(const std::string& pathAndName, std::function<void()> onComplete = {},
 							glm::ivec2 size = glm::ivec2(0));
 
-		static void DrawDebugLine(Line line);
-		static void DrawDebugLine(glm::vec3 start, glm::vec3 end, glm::vec3 color = glm::vec3(0.1f, 1.0f, 0.1f));
-		static void DrawDebugAABB(class AABB* aabb, glm::vec3 color);
+		// Debug drawing is thread safe. Overlay lines are drawn on top of everything, depth tested lines are hidden
+		// behind the scene.
+		static void DrawDebugLine(Line line, DebugDrawChannel channel = DebugDrawChannel::OVERLAY);
+		static void DrawDebugLine(glm::vec3 start, glm::vec3 end, glm::vec3 color = glm::vec3(0.1f, 1.0f, 0.1f),
+								  DebugDrawChannel channel = DebugDrawChannel::OVERLAY);
+		static void DrawDebugAABB(const AABB& aabb, glm::vec3 color = glm::vec3(1.0f, 0.6f, 0.1f),
+								  DebugDrawChannel channel = DebugDrawChannel::OVERLAY);
+		static void DrawDebugSphere(glm::vec3 center, float radius, glm::vec3 color = glm::vec3(0.1f, 1.0f, 0.1f),
+									DebugDrawChannel channel = DebugDrawChannel::OVERLAY);
+		// Red, green and blue lines along the local x, y and z axes of transform
+		static void DrawDebugAxis(const glm::mat4& transform, float size = 1.f,
+								  DebugDrawChannel channel = DebugDrawChannel::OVERLAY);
+		static void DrawDebugFrustum(const CullingFrustum& frustum, glm::vec3 color = glm::vec3(1.0f, 1.0f, 0.1f),
+									 DebugDrawChannel channel = DebugDrawChannel::OVERLAY);
 
 		void SetRunGridShader(bool runGridShader) { m_RunGridShader = runGridShader; }
 		GridShaderSettings& GetGridShaderSettings() { return m_GridSettings; }
@@ -70,6 +91,8 @@ namespace Ball
 		void SetDispatchOutlineObjects(bool dispatch);
 
 		Denoiser* GetDenoiserPtr() { return m_Denoiser; }
+		// Owns the frames in flight, resources the GPU may still read are released through its DeferDeletion
+		FrameScheduler& GetFrameScheduler() { return *m_FrameScheduler; }
 
 		bool m_DrawWireframe = false;
 		glm::vec3 m_CollidersColor = glm::vec3(0.0, 1.0, 0.0);
@@ -164,11 +187,13 @@ namespace Ball
 		bool m_DenoisingEnabled = true;
 		bool m_RunGridShader = false;
 		bool m_DispatchOutlineObjects = false;
+		bool m_EnvironmentSampling = true; // Next event estimation towards the HDRI
 
 		float3 m_OutlinesSelectedColor = float3(0.0, 1.0, 0.0);
 		float3 m_OutlinesHoveredColor = float3(1.0, 1.0, 1.0);
 		float m_LineThickness = 1.f;
 		float m_TracingDistanceMultiplier = 300.f;
+		float m_TextureLODBias = 0.f; // In mip levels, negative values pick sharper mips
 
 		void ClearAccumFrames()
 		{
@@ -187,6 +212,16 @@ namespace Ball
 
 		void ProcessScreenshotLogic();
 		void LoadSkyboxLogic();
+		// Uploads the HDRI along with the distribution its directions are importance sampled with
+		void LoadSkyTexture(const std::string& path);
+
+		// Declares every pass of the frame with the resources it reads and writes, rebuilt every frame
+		void BuildFrameGraph(const CameraGPU& cam, const GameplaySkyMat& skyMat, int numGroupsX, int numGroupsY,
+							 int numGroups1D, bool dispatchWavefront);
+		// Issues a barrier of the frame graph on the command list
+		void IssueFrameGraphBarrier(const RGBarrier& barrier) const;
+		RenderGraph m_FrameGraph;
+		bool m_LogFrameGraphStats = false; // Logs pass/barrier counts and transient memory after init and resizes
 
 		std::vector<ScreensizeTexturePtr> m_ScreensizeTextures;
 		std::vector<ScreensizeBufferPtr> m_ScreensizeBuffers;
@@ -199,6 +234,7 @@ namespace Ball
 		// Wrappers over most of GPU Code
 		BackEndRenderer* m_BackEndAPI;
 		CommandList* m_CmdList;
+		FrameScheduler* m_FrameScheduler = nullptr;
 
 		Texture* m_RenderTargets[NUM_RT_BUFFERS] = {nullptr};
 		Texture* m_TransferToRTTexture = nullptr;
@@ -217,6 +253,8 @@ namespace Ball
 		Texture* m_OutputTexture = nullptr;
 
 		Texture* m_SkyTexture = nullptr;
+		Buffer* m_EnvironmentDistribution = nullptr;
+		EnvironmentSettings m_EnvironmentSettings{};
 		Buffer* m_GpuModelInfo = nullptr;
 
 		// Manages TLAS, Creation of Models from GameObjects
@@ -257,12 +295,11 @@ namespace Ball
 
 		ComputePipelineDescription* m_ShadeRaysPipeline = nullptr;
 		ComputePipelineDescription* GenerateShadeRaysPipeline();
-		void DispatchShadeRays(uint32_t numGroups1D, uint32_t wavefrontBounceNum, GameplaySkyMat skyMat,
-							   float coneSpreadAngle) const;
+		void DispatchShadeRays(uint32_t numGroups1D, uint32_t wavefrontBounceNum, GameplaySkyMat skyMat) const;
 
 		ComputePipelineDescription* m_DirectIllumPipeline = nullptr;
 		ComputePipelineDescription* GenerateDirectIllumPipeline();
-		void DispatchDirectIllum(uint32_t numGroups1D, uint32_t wavefrontBounceNum) const;
+		void DispatchDirectIllum(uint32_t numGroups1D, uint32_t wavefrontBounceNum, GameplaySkyMat skyMat) const;
 
 		ComputePipelineDescription* m_ConnectRaysPipeline = nullptr;
 		ComputePipelineDescription* GenerateConnectRaysPipeline();
@@ -294,13 +331,25 @@ namespace Ball
 		ComputePipelineDescription* GenerateOutlineObjectsPipeline();
 		void DispatchOutlineObjects(uint32_t numGroups1D);
 
+		void DispatchDebugRayTrace(int numGroupsX, int numGroupsY, CameraGPU cam) const;
+		void DispatchGrid(int numGroupsX, int numGroupsY, CameraGPU cam) const;
+		void DispatchBloom() const;
+		void DispatchTonemap(int numGroupsX, int numGroupsY) const;
+
 		ComputePipelineDescription* m_BloomUpsamplePipeline = nullptr;
 		ComputePipelineDescription* m_BloomDownsamplePipeline = nullptr;
 		void AddBloomTexturesToRDH();
 		Texture* m_BloomIntermediateTextures[NUM_BLOOM] = {};
 
+		// Blue noise slices and the tables of the low discrepancy samples, see SamplingTables.h
 		void LoadBlueNoiseTextures();
 		Texture* m_BlueNoiseTextures[NUM_BLUENOISE];
+		Buffer* m_SamplingTables = nullptr;
+
+		// Directional albedo tables of the BSDF, see EnergyLUT.h
+		void LoadEnergyLUTTextures();
+		Texture* m_EnergyLUTTexture = nullptr;
+		Texture* m_DielectricEnergyLUTTexture = nullptr;
 
 		struct
 		{
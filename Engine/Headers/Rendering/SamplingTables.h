@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ShaderHeaders/SamplingGPU.h"
+
+namespace Ball
+{
+	// Sobol dimensions with direction numbers, the shaders use the first Sampling::SOBOL_DIMENSIONS
+	constexpr uint32_t MAX_SOBOL_DIMENSIONS = 8;
+
+	/// <summary>
+	/// Spatiotemporal blue noise made with void-and-cluster. The energy of a texel sums a Gaussian of the toroidal
+	/// distance to the points of its own slice and a Gaussian of the distance in time to the points at the same texel
+	/// of the other slices, so every slice is blue noise and so is every texel over time.
+	/// </summary>
+	struct BlueNoiseSettings
+	{
+		uint32_t m_Size = Sampling::BLUE_NOISE_SIZE; // Width and height, a power of two
+		uint32_t m_Slices = 32;
+		float m_SpatialSigma = 1.9f;
+		float m_TemporalSigma = 1.9f;
+		float m_InitialDensity = 0.1f; // Fraction of the texels in the initial binary pattern
+		uint32_t m_Seed = 1;
+	};
+
+	/// <summary>
+	/// Everything the samplers of the shaders need. m_Tables is uploaded as is, the blue noise slices become the
+	/// textures SampleBlueNoiseTexture reads.
+	/// </summary>
+	struct SamplingTables
+	{
+		// Sobol matrices, then the ranks of the first blue noise slice, the layout of SamplingGPU.h
+		std::vector<uint32_t> m_Tables;
+		// Size x size x slices, two independent masks in x and y
+		std::vector<glm::vec2> m_BlueNoise;
+		uint32_t m_BlueNoiseSize = 0;
+		uint32_t m_BlueNoiseSlices = 0;
+	};
+
+	// Generator matrices of the Sobol sequence from the Joe-Kuo direction numbers, SOBOL_BITS columns per dimension.
+	// Column i is the contribution of bit i of the index as a 0.32 fixed point number.
+	std::vector<uint32_t> BuildSobolMatrices(uint32_t numDimensions = Sampling::SOBOL_DIMENSIONS);
+
+	// Rank of every texel within its slice, [0, size * size). Ties are broken by the texel index, so the same settings
+	// give the same masks on every machine.
+	std::vector<uint32_t> BuildBlueNoiseRanks(const BlueNoiseSettings& settings);
+
+	// Both masks are built in parallel
+	SamplingTables BuildSamplingTables(const BlueNoiseSettings& settings = BlueNoiseSettings());
+
+	// Reads the tables cached in TempData. Builds and caches them when the cache is missing or outdated, or when
+	// -BakeSamplingTables is passed.
+	SamplingTables LoadOrBuildSamplingTables();
+
+	// Lets the C++ version of LowDiscrepancySample read these tables, nullptr unbinds them. The tables have to outlive
+	// the binding.
+	void BindSamplingTables(const SamplingTables* tables);
+} // namespace Ball
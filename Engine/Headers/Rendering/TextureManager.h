@@ -1,5 +1,8 @@
 #pragma once
 
+#include <mutex>
+#include <unordered_set>
+
 #include "BEAR/Texture.h"
 
 namespace Ball
@@ -13,10 +16,12 @@ namespace Ball
 	class TextureManager
 	{
 	public:
-		static Texture* Create(const void* data, TextureSpec spec, const std::string& name = "default_name");
+		static Texture* Create(const void* data, TextureSpec spec, const std::string& name = "default_name",
+							   MemoryTag tag = MemoryTag::TEXTURES);
 
 		static Texture* CreateFromFilepath(const std::string& path, TextureSpec spec,
-										   const std::string& name = "default_name");
+										   const std::string& name = "default_name",
+										   MemoryTag tag = MemoryTag::TEXTURES);
 
 		static void Destroy(Texture* buffer);
 		static void DestroyAll();
@@ -39,7 +44,9 @@ namespace Ball
 		static void CleanupHelperResources();
 
 		friend TextureVisualizer; // Uses this data to display info about Textures
-		static inline std::list<Texture*> m_Textures;
+		static inline std::unordered_set<Texture*> m_Textures;
 		static inline size_t m_TextureCount = 0;
+		// Models create their textures from multiple threads
+		static inline std::mutex m_Mutex;
 	};
 } // namespace Ball
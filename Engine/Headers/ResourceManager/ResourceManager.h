@@ -7,6 +7,7 @@
 #include "IResourceType.h"
 #include "Log.h"
 #include "Resource.h"
+#include "Utilities/StringId.h"
 
 namespace Ball
 {
@@ -57,7 +58,11 @@ namespace Ball
 		static int Size();
 
 	private:
-		static inline std::unordered_map<std::string, std::unique_ptr<T>> m_Cache{};
+		// Id of the path with the engine directory in front, unless the path already contains it
+		static StringId GetPathId(const std::string& path);
+
+		// Keyed by the hash of the full path, lookups don't have to build the prefixed path
+		static inline std::unordered_map<StringId, std::unique_ptr<T>> m_Cache{};
 	};
 
 	template<typename T>
@@ -67,28 +72,31 @@ namespace Ball
 		paths.reserve(m_Cache.size());
 
 		for (const auto& cachePair : m_Cache)
-			paths.emplace_back(cachePair.first);
+			paths.emplace_back(static_cast<const IResourceType*>(cachePair.second.get())->GetPath());
 
 		return paths;
 	}
 
 	template<typename T>
-	Resource<T> ResourceManager<T>::Get(const std::string& filePath)
+	StringId ResourceManager<T>::GetPathId(const std::string& path)
 	{
-		// Check if the resource path has already been prefixed
-		std::string tempPath;
-		if (filePath.find(FileIO::GetPath(FileIO::DirectoryType::Engine)) == std::string::npos)
-			tempPath = FileIO::GetPath(FileIO::DirectoryType::Engine) + filePath;
-		else
-			tempPath = filePath;
+		const std::string& enginePath = FileIO::GetPath(FileIO::DirectoryType::Engine);
+		if (path.find(enginePath) != std::string::npos)
+			return StringId(path);
+
+		return StringId(enginePath).Append(path);
+	}
 
-		const auto& cachePair = m_Cache.find(tempPath);
+	template<typename T>
+	Resource<T> ResourceManager<T>::Get(const std::string& filePath)
+	{
+		const auto& cachePair = m_Cache.find(GetPathId(filePath));
 		if (cachePair != m_Cache.end())
 		{
 			return Resource(cachePair->second.get());
 		}
 
-		ERROR(LOG_RESOURCE, "Attempted to get '%s' but Resource doesn't exist", tempPath.c_str());
+		ERROR(LOG_RESOURCE, "Attempted to get '%s' but Resource doesn't exist", filePath.c_str());
 		return Resource<T>(nullptr);
 	}
 
@@ -96,33 +104,28 @@ namespace Ball
 	template<typename... Args>
 	Resource<T> ResourceManager<T>::Load(const std::string& path, Args&&... args)
 	{
-		// Check if the resource path has already been prefixed
-		std::string tempPath;
-		if (path.find(FileIO::GetPath(FileIO::DirectoryType::Engine)) == std::string::npos)
-			tempPath = FileIO::GetPath(FileIO::DirectoryType::Engine) + path;
-		else
-			tempPath = path;
-
-		const auto& cachePair = m_Cache.find(tempPath);
+		const StringId pathId = GetPathId(path);
+		const auto& cachePair = m_Cache.find(pathId);
 
 		if (cachePair == m_Cache.end())
 		{
-			// Its not found create it
+			// Its not found create it, only now the prefixed path is needed
+			const std::string& enginePath = FileIO::GetPath(FileIO::DirectoryType::Engine);
+			const std::string tempPath = path.find(enginePath) == std::string::npos ? enginePath + path : path;
+
 			auto asset = std::make_unique<T>(tempPath, std::forward<Args>(args)...);
 			IResourceType* resource = static_cast<IResourceType*>(asset.get());
 			resource->Load();
 			resource->m_Loaded = true;
 
-			m_Cache.emplace(tempPath, std::move(asset));
-
-			return Resource(m_Cache.find(tempPath)->second.get());
+			return Resource(m_Cache.emplace(pathId, std::move(asset)).first->second.get());
 		}
 		else
 		{
 			IResourceType* resource = static_cast<IResourceType*>(cachePair->second.get());
 			if (resource->IsLoaded())
 			{
-				WARN(LOG_RESOURCE, "Attempted to load an already loaded asset '%s'", tempPath.c_str());
+				WARN(LOG_RESOURCE, "Attempted to load an already loaded asset '%s'", resource->GetPath().c_str());
 
 				return Resource((T*)resource);
 			}
@@ -130,6 +133,8 @@ namespace Ball
 			// We have a smart pointer and want to reset it without it changing the underlying T* address.
 			// I achieve this by using the placement new operator.
 
+			// Copied, the old path is destroyed with the resource
+			const std::string tempPath = resource->GetPath();
 			resource->~IResourceType();
 			new (resource) T(tempPath, std::forward<Args>(args)...);
 
@@ -143,14 +148,7 @@ namespace Ball
 	template<typename T>
 	void ResourceManager<T>::Unload(const std::string& path)
 	{
-		// Check if the resource path has already been prefixed
-		std::string tempPath;
-		if (path.find(FileIO::GetPath(FileIO::DirectoryType::Engine)) == std::string::npos)
-			tempPath = FileIO::GetPath(FileIO::DirectoryType::Engine) + path;
-		else
-			tempPath = path;
-
-		const auto& cachePair = m_Cache.find(tempPath);
+		const auto& cachePair = m_Cache.find(GetPathId(path));
 
 		if (cachePair != m_Cache.end())
 		{
@@ -160,20 +158,13 @@ namespace Ball
 			return;
 		}
 
-		ERROR(LOG_RESOURCE, "Attempted to unload '%s' which is not loaded", tempPath.c_str());
+		ERROR(LOG_RESOURCE, "Attempted to unload '%s' which is not loaded", path.c_str());
 	}
 
 	template<typename T>
 	bool ResourceManager<T>::IsLoaded(const std::string& path)
 	{
-		// Check if the resource path has already been prefixed
-		std::string tempPath;
-		if (path.find(FileIO::GetPath(FileIO::DirectoryType::Engine)) == std::string::npos)
-			tempPath = FileIO::GetPath(FileIO::DirectoryType::Engine) + path;
-		else
-			tempPath = path;
-
-		auto cachePair = m_Cache.find(tempPath);
+		auto cachePair = m_Cache.find(GetPathId(path));
 		if (cachePair == m_Cache.end())
 			return false;
 
@@ -192,7 +183,7 @@ namespace Ball
 		for (auto& it : m_Cache)
 		{
 			if (it.second->IsLoaded())
-				ResourceManager<T>::Get(it.first)->Unload();
+				it.second->Unload();
 		}
 		ResourceManager<T>::Clear();
 	}
@@ -1,6 +1,9 @@
 #pragma once
+#include <unordered_map>
+#include <vector>
 
 #include "Tools/ToolBase.h"
+#include "Utilities/StringId.h"
 
 namespace Ball
 {
@@ -15,7 +18,7 @@ namespace Ball
 
 	private:
 		// Assuming renderer.m_Data is your vector<TimestampData>
-		std::map<std::string, std::vector<float>> historyMap;
+		std::unordered_map<StringId, std::vector<float>> historyMap;
 
 		float m_ColorSensitivityClamp = 8.f;
 	};
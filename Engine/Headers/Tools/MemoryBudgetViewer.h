@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+#include "Tools/ToolBase.h"
+
+namespace Ball
+{
+	// Shows the live/peak GPU memory per MemoryTag and lets the budgets be changed at runtime
+	class MemoryBudgetViewer : public ToolBase
+	{
+	public:
+		void Init() override;
+
+		void Update() override;
+		void Event() override {}
+		void Draw() override;
+
+	private:
+		static constexpr size_t HISTORY_SIZE = 240;
+
+		std::vector<float> m_TotalHistoryMB; // Live total per frame, oldest first
+	};
+} // namespace Ball
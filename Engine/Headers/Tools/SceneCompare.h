@@ -1,10 +1,21 @@
 #pragma once
 #include "Tools/ToolBase.h"
+#include "Utilities/ImageCompare.h"
+
+#include <nlohmann/json.hpp>
 
 namespace Ball
 {
 	class RenderAPI;
 
+	/// <summary>
+	/// Saves and restores the camera and rendering mode, so the same view can be compared between changes.
+	/// -SceneCompareBatch=<directory> renders every state file in that TempData directory, compares the captures
+	/// with References/<state>.png and writes diff heatmaps and Summary.json to Results/. The engine exits with 1
+	/// when a scene is over its thresholds. A state file can override the thresholds and the number of frames that
+	/// are accumulated before the capture:
+	/// "AccumulatedFrames": 256, "Thresholds": {"MaxRMSE": 0.02, "MinSSIM": 0.9, "MaxFlip": 0.05}
+	/// </summary>
 	class SceneCompare : public ToolBase
 	{
 	public:
@@ -14,7 +25,40 @@ namespace Ball
 		void Event() override;
 
 	private:
+		enum class BatchStep
+		{
+			NONE,
+			LOAD_STATE,
+			ACCUMULATE,
+			WAIT_FOR_CAPTURE
+		};
+
+		// Applies the camera and rendering mode of a state file in TempData, returns an empty object on failure
+		nlohmann::json LoadState(const std::string& fileName);
+
+		void StartBatch(const std::string& directory);
+		void CompareBatchCapture();
+		void FinishBatch();
+		std::string GetSceneName() const;
+		std::string GetCapturePath() const;
+		void WriteBatchSummary() const;
+
 		std::string m_StateFileName = "DefaultState.json";
 		bool m_LoadOnStart = false;
+
+		std::string m_BatchDirectory = "SceneCompare";
+		std::vector<std::string> m_BatchStates{};
+		size_t m_BatchIndex = 0;
+		BatchStep m_BatchStep = BatchStep::NONE;
+		bool m_ExitAfterBatch = false;
+		uint32_t m_FramesToAccumulate = 0;
+		uint32_t m_FramesAccumulated = 0;
+		// A capture that times out can still complete later, the index tells it apart from the current one
+		uint32_t m_CaptureIndex = 0;
+		uint32_t m_CaptureWaitFrames = 0;
+		bool m_CaptureDone = false;
+		ImageCompareThresholds m_Thresholds{};
+		nlohmann::json m_BatchResults{};
+		uint32_t m_FailedScenes = 0;
 	};
 } // namespace Ball
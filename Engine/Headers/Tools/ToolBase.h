@@ -27,6 +27,7 @@ namespace Ball
 		void Open() { m_Open = true; }
 		void Close() { m_Open = false; }
 		bool IsOpen() const { return m_Open; }
+		bool UpdatesWithoutOverlay() const { return m_UpdateWithoutOverlay; }
 
 	protected:
 		/// <summary>
@@ -41,5 +42,8 @@ namespace Ball
 		ToolCatagory m_ToolCatagory;
 		ToolInterfaceType m_ToolInterfaceType;
 		bool m_Open;
+		// Updated from the engine loop, also when the overlay isn't drawn (headless, hidden or NO_IMGUI).
+		// Other tools are only updated while the overlay is visible.
+		bool m_UpdateWithoutOverlay = false;
 	};
 } // namespace Ball
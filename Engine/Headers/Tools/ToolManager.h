@@ -32,6 +32,7 @@ namespace Ball
 
 		void Init();
 		void Shutdown();
+		void Update();
 		void OnImgui();
 
 	private:
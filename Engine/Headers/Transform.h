@@ -3,6 +3,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include "GameObjects/Serialization/FieldTable.h"
+
 namespace Ball
 {
 	class SerializeArchive;
@@ -66,10 +68,17 @@ namespace Ball
 
 		// Flag the transform as dirty
 		void Dirty() { m_Dirty = true; }
+		// Changes every time the model matrix is rebuilt, compare it to a stored value to see if the transform moved
+		uint32_t GetVersion();
 
 		void ImGuiForDebugging();
 
 		void Serialize(SerializeArchive& archive);
+		static constexpr auto GetFieldTable()
+		{
+			return MakeFieldTable(
+				FIELD(Transform, m_Position), FIELD(Transform, m_Rotation), FIELD(Transform, m_Scale));
+		}
 
 	private:
 		// Update the transform
@@ -87,6 +96,7 @@ namespace Ball
 		glm::mat4 m_ModelMatrix; // The model matrix of this transform
 
 		bool m_Dirty; // Has a change been made to this transform
+		uint32_t m_Version; // Unique over all transforms, copies keep the version of their source
 	};
 
 } // namespace Ball
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Ball
+{
+	/// <summary>
+	/// Counts the calls to the global operator new, the engine replaces it outside of SHIPPING builds (in
+	/// AllocationCounter.cpp). Used to check how many heap allocations a frame does, mostly in headless benchmarks.
+	/// </summary>
+	class AllocationCounter
+	{
+	public:
+		static bool IsEnabled();
+
+		static uint64_t GetNumAllocations() { return m_NumAllocations.load(std::memory_order_relaxed); }
+		static uint64_t GetNumAllocatedBytes() { return m_NumAllocatedBytes.load(std::memory_order_relaxed); }
+
+		// Allocations done between the last two EndFrame() calls
+		static uint64_t GetFrameAllocations() { return m_FrameAllocations; }
+		static uint64_t GetFrameAllocatedBytes() { return m_FrameAllocatedBytes; }
+
+		static void EndFrame();
+		// Logs the allocations of the last frame every N frames, 0 disables it
+		static void SetLogInterval(uint32_t frames) { m_LogInterval = frames; }
+
+		// Called by the operator new replacement, has to be safe before main() and from every thread
+		static void OnAllocate(size_t bytes)
+		{
+			m_NumAllocations.fetch_add(1, std::memory_order_relaxed);
+			m_NumAllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+	private:
+		static inline std::atomic<uint64_t> m_NumAllocations = 0;
+		static inline std::atomic<uint64_t> m_NumAllocatedBytes = 0;
+
+		static inline uint64_t m_AllocationsAtFrameStart = 0;
+		static inline uint64_t m_BytesAtFrameStart = 0;
+		static inline uint64_t m_FrameAllocations = 0;
+		static inline uint64_t m_FrameAllocatedBytes = 0;
+		static inline uint64_t m_FrameNumber = 0;
+		static inline uint32_t m_LogInterval = 0;
+	};
+} // namespace Ball
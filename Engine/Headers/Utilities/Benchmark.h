@@ -0,0 +1,86 @@
+#pragma once
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Ball
+{
+	struct BenchmarkSettings
+	{
+		std::string m_Name = "Default";
+		uint32_t m_WarmupFrames = 120;
+		uint32_t m_MeasuredFrames = 600;
+		// Stored in the results so runs can be reproduced, the scene has to use it for its random placement
+		uint32_t m_Seed = 1337;
+		float m_FixedDeltaTime = 0.f; // In milliseconds, 0 when the measured delta time is used
+	};
+
+	// Distribution of one metric over the measured frames
+	struct BenchmarkStatistics
+	{
+		float m_Min = 0.f;
+		float m_Mean = 0.f;
+		float m_P50 = 0.f;
+		float m_P90 = 0.f;
+		float m_P95 = 0.f;
+		float m_P99 = 0.f;
+		float m_Max = 0.f;
+
+		// Nearest-rank percentiles
+		static BenchmarkStatistics Calculate(std::vector<float> samples);
+	};
+
+	struct BenchmarkRegression
+	{
+		std::string m_Metric; // "<group>/<name>/<statistic>"
+		double m_Baseline;
+		double m_Current;
+	};
+
+	/// <summary>
+	/// Collects per frame samples for a benchmark run (frame time, CPU/GPU zones, allocations) and turns them into
+	/// percentiles. The first m_WarmupFrames frames are ignored, so loading and shader compilation don't end up in
+	/// the results. Metrics are grouped ("frame", "cpu", "gpu", ...) to keep the names of the zones intact.
+	/// </summary>
+	class BenchmarkRunner
+	{
+	public:
+		explicit BenchmarkRunner(BenchmarkSettings settings);
+
+		// Ignored during the warm-up, a metric without a sample in a measured frame counts as 0 for that frame
+		void AddSample(std::string_view group, std::string_view name, float value);
+		// Single value for the whole run, e.g. a memory peak
+		void SetValue(std::string_view group, std::string_view name, double value);
+
+		void EndFrame();
+
+		bool IsWarmingUp() const { return m_FrameIndex < m_Settings.m_WarmupFrames; }
+		bool IsFinished() const { return m_FrameIndex >= m_Settings.m_WarmupFrames + m_Settings.m_MeasuredFrames; }
+		const BenchmarkSettings& GetSettings() const { return m_Settings; }
+
+		BenchmarkStatistics GetStatistics(std::string_view group, std::string_view name) const;
+		nlohmann::json ToJson() const;
+
+		/// <summary>
+		/// Compares the p50 and p95 of every metric and every value with a baseline run. Metrics that only exist in
+		/// one of them are skipped.
+		/// </summary>
+		/// <param name="tolerance">Allowed relative increase, 0.1 allows 10% slower</param>
+		/// <param name="minimumDifference">Smaller absolute increases are noise, mostly for tiny zones</param>
+		static std::vector<BenchmarkRegression> Compare(const nlohmann::json& baseline, const nlohmann::json& current,
+														float tolerance, float minimumDifference = 0.05f);
+
+	private:
+		using Samples = std::map<std::string, std::vector<float>, std::less<>>;
+
+		uint32_t GetMeasuredFrameIndex() const { return m_FrameIndex - m_Settings.m_WarmupFrames; }
+
+		BenchmarkSettings m_Settings;
+		uint32_t m_FrameIndex = 0;
+		std::map<std::string, Samples, std::less<>> m_Samples{};
+		std::map<std::string, std::map<std::string, double, std::less<>>, std::less<>> m_Values{};
+	};
+} // namespace Ball
@@ -0,0 +1,63 @@
+#pragma once
+#include <chrono>
+#include <vector>
+
+#define CPU_PROFILER_CONCAT_INNER(a, b) a##b
+#define CPU_PROFILER_CONCAT(a, b) CPU_PROFILER_CONCAT_INNER(a, b)
+
+#ifndef SHIPPING
+// Times the rest of the scope, name has to be a string literal
+#define PROFILE_CPU_ZONE(name) Ball::CpuZone CPU_PROFILER_CONCAT(cpuZone, __LINE__)(name)
+#else
+#define PROFILE_CPU_ZONE(name)
+#endif
+
+namespace Ball
+{
+	struct CpuZoneTime
+	{
+		const char* m_Name;
+		float m_TimeInMs;
+	};
+
+	/// <summary>
+	/// Collects the time spent in PROFILE_CPU_ZONE scopes on the main thread per frame. A zone that is entered
+	/// multiple times in a frame adds up, nested zones are counted in their parents as well.
+	/// </summary>
+	class CpuProfiler
+	{
+	public:
+		void AddZoneTime(const char* name, float timeInMs);
+
+		// Moves the zones of this frame to GetLastFrameZones() and starts a new frame
+		void EndFrame();
+
+		// In the order they were first entered
+		const std::vector<CpuZoneTime>& GetLastFrameZones() const { return m_LastFrameZones; }
+
+	private:
+		std::vector<CpuZoneTime> m_FrameZones{};
+		std::vector<CpuZoneTime> m_LastFrameZones{};
+	};
+
+	// Profiler of the engine loop
+	CpuProfiler& GetCpuProfiler();
+
+	class CpuZone
+	{
+	public:
+		explicit CpuZone(const char* name) : m_Name(name), m_Start(std::chrono::high_resolution_clock::now()) {}
+		~CpuZone()
+		{
+			const std::chrono::duration<float, std::milli> duration =
+				std::chrono::high_resolution_clock::now() - m_Start;
+			GetCpuProfiler().AddZoneTime(m_Name, duration.count());
+		}
+		CpuZone(const CpuZone&) = delete;
+		CpuZone& operator=(const CpuZone&) = delete;
+
+	private:
+		const char* m_Name;
+		std::chrono::high_resolution_clock::time_point m_Start;
+	};
+} // namespace Ball
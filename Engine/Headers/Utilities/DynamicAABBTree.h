@@ -0,0 +1,205 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Rendering/FrustumCulling.h"
+#include "Log.h"
+
+namespace Ball
+{
+	class GameObject;
+
+	/// <summary>
+	/// Bounding volume hierarchy that is updated incrementally, in the style of Box2D's b2DynamicTree. Every proxy
+	/// is a leaf with a fat box around its bounds, proxies that move inside their fat box don't touch the tree.
+	/// Leaves that leave it are removed and inserted again, the tree is kept balanced with rotations on the way up.
+	/// Queries test the fat boxes while descending and the exact bounds at the leaves.
+	/// </summary>
+	class DynamicAABBTree
+	{
+	public:
+		static constexpr int32_t NULL_NODE = -1;
+
+		// - margin: Distance the fat boxes extend past the bounds of a proxy
+		DynamicAABBTree(float margin = 0.1f);
+
+		/// <returns>Proxy id, stays the same until the proxy is destroyed</returns>
+		int32_t CreateProxy(const AABB& bounds, GameObject* object);
+		void DestroyProxy(int32_t proxyId);
+
+		/// <summary>
+		/// Updates the bounds of a proxy. The fat box is extended in the direction of displacement so objects that
+		/// keep moving the same way don't get reinserted every frame.
+		/// </summary>
+		/// <returns>True when the proxy had to be reinserted</returns>
+		bool MoveProxy(int32_t proxyId, const AABB& bounds, const glm::vec3& displacement = glm::vec3(0.f));
+
+		void Clear();
+
+		GameObject* GetGameObject(int32_t proxyId) const { return m_Nodes[proxyId].m_Object; }
+		const AABB& GetBounds(int32_t proxyId) const { return m_Nodes[proxyId].m_Bounds; }
+		const AABB& GetFatBounds(int32_t proxyId) const { return m_Nodes[proxyId].m_FatBounds; }
+
+		// Fat box around all proxies, invalid when the tree is empty
+		AABB GetRootBounds() const { return m_Root == NULL_NODE ? AABB() : m_Nodes[m_Root].m_FatBounds; }
+		int32_t GetHeight() const { return m_Root == NULL_NODE ? 0 : m_Nodes[m_Root].m_Height; }
+		int32_t GetProxyCount() const { return m_ProxyCount; }
+		// Surface area of all internal nodes compared to the root, lower is a better tree
+		float GetAreaRatio() const;
+
+		// Checks the links, heights and boxes of every node, for tests
+		bool Validate() const;
+
+		// callback(proxyId) is called for every proxy whose bounds overlap box, return false to stop the query
+		template<typename Callback>
+		void QueryOverlap(const AABB& box, Callback&& callback) const;
+
+		// callback(proxyId) for every proxy whose bounds are within radius of center
+		template<typename Callback>
+		void QueryRadius(const glm::vec3& center, float radius, Callback&& callback) const;
+
+		// callback(proxyId) for every proxy whose bounds are inside the frustum, see CullingFrustum::IsVisible
+		template<typename Callback>
+		void QueryFrustum(const CullingFrustum& frustum, Callback&& callback) const;
+
+		/// <summary>
+		/// Calls callback(proxyId, distance) for every proxy whose bounds the ray hits within maxDistance, distance
+		/// is where the ray enters the bounds. The callback returns the new max distance: the distance it was given
+		/// to only look for closer hits, maxDistance to keep going or 0 to stop. Proxies are not visited in order.
+		/// </summary>
+		template<typename Callback>
+		void RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Callback&& callback) const;
+
+	private:
+		// Deep enough for any balanced tree that fits in memory
+		static constexpr int MAX_STACK_SIZE = 256;
+
+		struct Node
+		{
+			bool IsLeaf() const { return m_Child1 == NULL_NODE; }
+
+			AABB m_FatBounds;
+			AABB m_Bounds; // Exact bounds, only set for leaves
+			GameObject* m_Object = nullptr;
+
+			int32_t m_Parent = NULL_NODE; // Next free node when this node is free
+			int32_t m_Child1 = NULL_NODE;
+			int32_t m_Child2 = NULL_NODE;
+			int32_t m_Height = -1; // Leaves are 0, free nodes -1
+		};
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t nodeId);
+
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+		// Rotates the taller child up when the heights of the children differ by more than one
+		int32_t Balance(int32_t nodeId);
+		// Fixes the boxes and heights from nodeId up to the root
+		void Refit(int32_t nodeId);
+
+		bool ValidateNode(int32_t nodeId, int32_t parent) const;
+
+		// Depth first walk, test(box) decides if a node is entered and if a leaf is reported. test is called with
+		// the fat box for every node and with the exact bounds for leaves.
+		template<typename Test, typename Callback>
+		void Traverse(Test&& test, Callback&& callback) const;
+
+		std::vector<Node> m_Nodes{};
+		int32_t m_Root = NULL_NODE;
+		int32_t m_FreeList = NULL_NODE;
+		int32_t m_ProxyCount = 0;
+		float m_Margin;
+	};
+
+	template<typename Test, typename Callback>
+	inline void DynamicAABBTree::Traverse(Test&& test, Callback&& callback) const
+	{
+		if (m_Root == NULL_NODE)
+			return;
+
+		int32_t stack[MAX_STACK_SIZE];
+		int stackSize = 0;
+		stack[stackSize++] = m_Root;
+		while (stackSize > 0)
+		{
+			const int32_t nodeId = stack[--stackSize];
+			const Node& node = m_Nodes[nodeId];
+			if (!test(node.m_FatBounds))
+				continue;
+
+			if (node.IsLeaf())
+			{
+				if (test(node.m_Bounds) && !callback(nodeId))
+					return;
+				continue;
+			}
+
+			ASSERT_MSG(LOG_GENERIC, stackSize + 2 <= MAX_STACK_SIZE, "Dynamic AABB tree is too deep");
+			stack[stackSize++] = node.m_Child1;
+			stack[stackSize++] = node.m_Child2;
+		}
+	}
+
+	template<typename Callback>
+	inline void DynamicAABBTree::QueryOverlap(const AABB& box, Callback&& callback) const
+	{
+		Traverse(
+			[&box](const AABB& nodeBox)
+			{
+				return nodeBox.m_Min.x <= box.m_Max.x && nodeBox.m_Min.y <= box.m_Max.y &&
+					nodeBox.m_Min.z <= box.m_Max.z && box.m_Min.x <= nodeBox.m_Max.x &&
+					box.m_Min.y <= nodeBox.m_Max.y && box.m_Min.z <= nodeBox.m_Max.z;
+			},
+			callback);
+	}
+
+	template<typename Callback>
+	inline void DynamicAABBTree::QueryRadius(const glm::vec3& center, float radius, Callback&& callback) const
+	{
+		const float radiusSquared = radius * radius;
+		Traverse(
+			[&center, radiusSquared](const AABB& nodeBox)
+			{
+				const glm::vec3 offset = glm::clamp(center, nodeBox.m_Min, nodeBox.m_Max) - center;
+				return glm::dot(offset, offset) <= radiusSquared;
+			},
+			callback);
+	}
+
+	template<typename Callback>
+	inline void DynamicAABBTree::QueryFrustum(const CullingFrustum& frustum, Callback&& callback) const
+	{
+		Traverse([&frustum](const AABB& nodeBox) { return frustum.IsVisible(nodeBox); }, callback);
+	}
+
+	template<typename Callback>
+	inline void DynamicAABBTree::RayCast(const glm::vec3& origin,
+										 const glm::vec3& direction,
+										 float maxDistance,
+										 Callback&& callback) const
+	{
+		// Slab test, the direction doesn't have to be normalized, distances are in multiples of it
+		const glm::vec3 inverseDirection = 1.f / direction;
+		float hitDistance = 0.f;
+		auto hits = [&](const AABB& nodeBox)
+		{
+			const glm::vec3 t0 = (nodeBox.m_Min - origin) * inverseDirection;
+			const glm::vec3 t1 = (nodeBox.m_Max - origin) * inverseDirection;
+			const glm::vec3 tMin = glm::min(t0, t1);
+			const glm::vec3 tMax = glm::max(t0, t1);
+			const float enter = (std::max)((std::max)(tMin.x, tMin.y), (std::max)(tMin.z, 0.f));
+			const float exit = (std::min)((std::min)(tMax.x, tMax.y), (std::min)(tMax.z, maxDistance));
+			hitDistance = enter;
+			return enter <= exit;
+		};
+
+		Traverse(hits,
+				 [&](int32_t proxyId)
+				 {
+					 maxDistance = callback(proxyId, hitDistance);
+					 return maxDistance > 0.f;
+				 });
+	}
+} // namespace Ball
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Ball
+{
+	/// <summary>
+	/// Linear allocator for data that only lives for a frame or two, allocating is a pointer bump and nothing is
+	/// freed individually. The memory is double-buffered: BeginFrame() switches to the other half and resets it, so an
+	/// allocation stays valid until the end of the next frame. When a half runs out, allocations fall back to the heap.
+	/// Allocate() can be called from any thread, BeginFrame() only from the main thread while nothing else allocates.
+	/// </summary>
+	class FrameArena
+	{
+	public:
+		explicit FrameArena(size_t bytesPerFrame);
+
+		void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+		// Only needed for allocations that could have fallen back to the heap, arena memory is ignored
+		void Deallocate(void* memory, size_t alignment = alignof(std::max_align_t));
+
+		void BeginFrame();
+
+		size_t GetCapacity() const { return m_BytesPerFrame; }
+		size_t GetUsedBytes() const { return m_Offset.load(std::memory_order_relaxed); }
+		uint32_t GetNumOverflows() const { return m_NumOverflows.load(std::memory_order_relaxed); }
+		bool Owns(const void* memory) const;
+
+	private:
+		size_t m_BytesPerFrame;
+		std::unique_ptr<uint8_t[]> m_Memory[2];
+		uint32_t m_CurrentHalf = 0;
+		std::atomic<size_t> m_Offset = 0;
+		std::atomic<uint32_t> m_NumOverflows = 0; // Heap fallbacks during the current frame
+	};
+
+	// Arena reset by the engine at the start of every frame
+	FrameArena& GetFrameArena();
+
+	// STL allocator that takes its memory from a FrameArena, containers using it must not outlive the next frame
+	template<class T>
+	class FrameAllocator
+	{
+	public:
+		using value_type = T;
+
+		FrameAllocator() : m_Arena(&GetFrameArena()) {}
+		explicit FrameAllocator(FrameArena& arena) : m_Arena(&arena) {}
+		template<class U>
+		FrameAllocator(const FrameAllocator<U>& other) : m_Arena(other.m_Arena)
+		{
+		}
+
+		T* allocate(size_t count) { return static_cast<T*>(m_Arena->Allocate(count * sizeof(T), alignof(T))); }
+		void deallocate(T* memory, size_t) { m_Arena->Deallocate(memory, alignof(T)); }
+
+		template<class U>
+		bool operator==(const FrameAllocator<U>& other) const
+		{
+			return m_Arena == other.m_Arena;
+		}
+		template<class U>
+		bool operator!=(const FrameAllocator<U>& other) const
+		{
+			return m_Arena != other.m_Arena;
+		}
+
+	private:
+		template<class U>
+		friend class FrameAllocator;
+
+		FrameArena* m_Arena;
+	};
+
+	template<class T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+} // namespace Ball
@@ -0,0 +1,64 @@
+#pragma once
+#include <glm/vec3.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Ball
+{
+	// 8 bit sRGB image stored as floats in [0, 1], the alpha channel is dropped
+	struct CompareImage
+	{
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		std::vector<glm::vec3> m_Pixels{};
+
+		bool IsValid() const { return m_Width > 0 && m_Height > 0 && m_Pixels.size() == m_Width * m_Height; }
+		const glm::vec3& GetPixel(uint32_t x, uint32_t y) const { return m_Pixels[y * m_Width + x]; }
+
+		// Absolute path, returns an invalid image when the file can't be loaded
+		static CompareImage Load(const std::string& path);
+		bool SavePNG(const std::string& path) const;
+	};
+
+	struct ImageCompareThresholds
+	{
+		float m_MaxRMSE = 0.02f;
+		float m_MinSSIM = 0.9f; // SSIM punishes noise in flat areas, accumulated frames are never fully converged
+		float m_MaxFlip = 0.05f;
+	};
+
+	struct ImageCompareResult
+	{
+		float m_RMSE = 0.f;
+		float m_SSIM = 1.f;
+		float m_Flip = 0.f; // Mean of m_ErrorMap
+		// Perceptual error per pixel in [0, 1], same size as the compared images
+		std::vector<float> m_ErrorMap{};
+
+		bool Passes(const ImageCompareThresholds& thresholds) const
+		{
+			return m_RMSE <= thresholds.m_MaxRMSE && m_SSIM >= thresholds.m_MinSSIM && m_Flip <= thresholds.m_MaxFlip;
+		}
+	};
+
+	// Root mean square error over all channels
+	float ComputeRMSE(const CompareImage& reference, const CompareImage& test);
+
+	// Mean structural similarity of the luminance, in 8x8 windows with a stride of 4 pixels
+	float ComputeSSIM(const CompareImage& reference, const CompareImage& test);
+
+	/// <summary>
+	/// FLIP style perceptual error per pixel. Colors are compared in a blurred Lab space with the HyAB distance,
+	/// edges and points (Sobel and Laplacian of the luminance) that show up or disappear amplify that error. Noise
+	/// that is blurred away by the eye scores a lot lower than the same RMSE concentrated on an edge.
+	/// </summary>
+	/// <returns>Error per pixel in [0, 1]</returns>
+	std::vector<float> ComputeFlipErrorMap(const CompareImage& reference, const CompareImage& test);
+
+	// Computes all metrics, returns false when the images can't be compared because their sizes differ
+	bool CompareImages(const CompareImage& reference, const CompareImage& test, ImageCompareResult& result);
+
+	// Maps the error per pixel to a magma color ramp, black is no difference
+	CompareImage CreateHeatmap(const std::vector<float>& errorMap, uint32_t width, uint32_t height);
+} // namespace Ball
@@ -0,0 +1,217 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Ball
+{
+	struct BlockPoolStats
+	{
+		uint64_t m_NumLiveBlocks = 0;
+		uint64_t m_NumChunks = 0;
+	};
+
+	/// <summary>
+	/// Pool of fixed-size blocks shared by all types with the same size and alignment. Every thread keeps a small
+	/// free list of its own, so allocating and freeing only take the lock when that list is empty or too long.
+	/// Blocks can be freed on a different thread than the one that allocated them, the memory is never returned to
+	/// the OS.
+	/// </summary>
+	template<size_t BlockSize, size_t Alignment>
+	class BlockPool
+	{
+	public:
+		static void* Allocate()
+		{
+			ThreadCache& cache = GetThreadCache();
+			if (cache.m_Head == nullptr)
+				Refill(cache);
+
+			FreeBlock* block = cache.m_Head;
+			cache.m_Head = block->m_Next;
+			cache.m_Count--;
+			GetShared().m_NumLiveBlocks.fetch_add(1, std::memory_order_relaxed);
+			return block;
+		}
+
+		static void Free(void* memory)
+		{
+			if (memory == nullptr)
+				return;
+
+			ThreadCache& cache = GetThreadCache();
+			FreeBlock* block = static_cast<FreeBlock*>(memory);
+			block->m_Next = cache.m_Head;
+			cache.m_Head = block;
+			cache.m_Count++;
+			GetShared().m_NumLiveBlocks.fetch_sub(1, std::memory_order_relaxed);
+
+			// Threads that only free (e.g. the main thread deleting what a loading thread created) give blocks back
+			if (cache.m_Count > 2 * BATCH_SIZE)
+				ReturnBlocks(cache, BATCH_SIZE);
+		}
+
+		static BlockPoolStats GetStats()
+		{
+			Shared& shared = GetShared();
+			std::lock_guard<std::mutex> lock(shared.m_Mutex);
+			return {shared.m_NumLiveBlocks.load(std::memory_order_relaxed), shared.m_Chunks.size()};
+		}
+
+	private:
+		// Free blocks store the next pointer in place, (std::max) because this gets included next to windows.h
+		static constexpr size_t ALIGNMENT = (std::max)(Alignment, alignof(void*));
+		static constexpr size_t BLOCK_SIZE =
+			((std::max)(BlockSize, sizeof(void*)) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		static constexpr size_t BATCH_SIZE = 32;
+		static constexpr size_t BLOCKS_PER_CHUNK = BATCH_SIZE * 4;
+
+		struct FreeBlock
+		{
+			FreeBlock* m_Next;
+		};
+
+		struct Shared
+		{
+			std::mutex m_Mutex;
+			FreeBlock* m_Head = nullptr;
+			std::vector<void*> m_Chunks;
+			std::atomic<uint64_t> m_NumLiveBlocks = 0;
+		};
+
+		struct ThreadCache
+		{
+			FreeBlock* m_Head = nullptr;
+			size_t m_Count = 0;
+
+			~ThreadCache() { ReturnBlocks(*this, m_Count); }
+		};
+
+		// Never destroyed, blocks can still be freed by static destructors and exiting threads
+		static Shared& GetShared()
+		{
+			static Shared* shared = new Shared();
+			return *shared;
+		}
+
+		static ThreadCache& GetThreadCache()
+		{
+			thread_local ThreadCache cache;
+			return cache;
+		}
+
+		static void Refill(ThreadCache& cache)
+		{
+			Shared& shared = GetShared();
+			std::lock_guard<std::mutex> lock(shared.m_Mutex);
+			if (shared.m_Head == nullptr)
+			{
+				uint8_t* chunk =
+					static_cast<uint8_t*>(::operator new(BLOCK_SIZE * BLOCKS_PER_CHUNK, std::align_val_t(ALIGNMENT)));
+				shared.m_Chunks.push_back(chunk);
+				for (size_t i = BLOCKS_PER_CHUNK; i-- > 0;)
+				{
+					FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * BLOCK_SIZE);
+					block->m_Next = shared.m_Head;
+					shared.m_Head = block;
+				}
+			}
+
+			for (size_t i = 0; i < BATCH_SIZE && shared.m_Head != nullptr; i++)
+			{
+				FreeBlock* block = shared.m_Head;
+				shared.m_Head = block->m_Next;
+				block->m_Next = cache.m_Head;
+				cache.m_Head = block;
+				cache.m_Count++;
+			}
+		}
+
+		static void ReturnBlocks(ThreadCache& cache, size_t count)
+		{
+			if (count == 0)
+				return;
+
+			Shared& shared = GetShared();
+			std::lock_guard<std::mutex> lock(shared.m_Mutex);
+			for (size_t i = 0; i < count && cache.m_Head != nullptr; i++)
+			{
+				FreeBlock* block = cache.m_Head;
+				cache.m_Head = block->m_Next;
+				cache.m_Count--;
+				block->m_Next = shared.m_Head;
+				shared.m_Head = block;
+			}
+		}
+	};
+
+	// Pooled replacement for new/delete of small objects that are created and destroyed often
+	template<class T>
+	class ObjectPool
+	{
+	public:
+		using Pool = BlockPool<sizeof(T), alignof(T)>;
+
+		template<class... Args>
+		static T* New(Args&&... args)
+		{
+			void* memory = Pool::Allocate();
+			return new (memory) T(std::forward<Args>(args)...);
+		}
+
+		static void Delete(T* object)
+		{
+			if (object == nullptr)
+				return;
+
+			object->~T();
+			Pool::Free(object);
+		}
+	};
+
+	// STL allocator for node based containers (std::list, std::map, std::unordered_map nodes), single element
+	// allocations come from a BlockPool and larger ones (e.g. hash buckets) from the heap
+	template<class T>
+	class PoolAllocator
+	{
+	public:
+		using value_type = T;
+
+		PoolAllocator() = default;
+		template<class U>
+		PoolAllocator(const PoolAllocator<U>&)
+		{
+		}
+
+		T* allocate(size_t count)
+		{
+			if (count == 1)
+				return static_cast<T*>(BlockPool<sizeof(T), alignof(T)>::Allocate());
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+		}
+
+		void deallocate(T* memory, size_t count)
+		{
+			if (count == 1)
+				BlockPool<sizeof(T), alignof(T)>::Free(memory);
+			else
+				::operator delete(memory, std::align_val_t(alignof(T)));
+		}
+
+		template<class U>
+		bool operator==(const PoolAllocator<U>&) const
+		{
+			return true;
+		}
+		template<class U>
+		bool operator!=(const PoolAllocator<U>&) const
+		{
+			return false;
+		}
+	};
+} // namespace Ball
@@ -1,7 +1,10 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
+#include "Utilities/StringId.h"
+
 #ifndef SHIPPING
 #define PUSH_GPU_MARKER(cmdList, name) Ball::Utilities::PushGPUMarker(cmdList, name)
 #define POP_GPU_MARKER(cmdList) Ball::Utilities::PopGPUMarker(cmdList)
@@ -18,7 +21,9 @@ namespace Ball
 	{
 		struct TimestampData
 		{
-			std::string name;
+			StringId id;
+			// Interned name of the id, valid for the lifetime of the program
+			const char* name;
 			float timeInMs;
 		};
 
@@ -40,7 +45,7 @@ namespace Ball
 			TEAL = 0x008080,
 		};
 
-		const std::unordered_map<std::string, MarkerColors> g_MarkerColors = {
+		const std::unordered_map<StringId, MarkerColors> g_MarkerColors = {
 			{"Generate", MarkerColors::RED},
 			{"Extend", MarkerColors::GREEN},
 			{"Shade", MarkerColors::PINK},
@@ -75,15 +80,16 @@ namespace Ball
 		/// <param name="cmdList">Command list used for dispatching marked GPU calls</param>
 		void PopGPUMarker(CommandList* cmdList);
 
-		// Returns the index of the timestamp query
-		uint32_t PushGPUTimestamp(CommandList* cmdList, const std::string& name);
+		// Returns the index of the timestamp query. The name is interned, queries only store its id.
+		uint32_t PushGPUTimestamp(CommandList* cmdList, std::string_view name);
 
 		// startIndex refers to the index from `PushGPUTimestamp` to calculate the end product
 		void PopGPUTimestamp(CommandList* cmdList, const uint32_t startIndex);
 
 		void SaveGPUTimestampData(CommandList* cmdList);
 
-		std::vector<TimestampData> ProcessReadbackBuffer();
+		// Fills timestampData with the timings of this frame, reuses the memory of the vector
+		void ProcessReadbackBuffer(std::vector<TimestampData>& timestampData);
 
 	} // namespace Utilities
 } // namespace Ball
\ No newline at end of file
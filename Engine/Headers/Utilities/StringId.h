@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace Ball
+{
+	/// <summary>
+	/// 64 bit FNV-1a hash of a name, used as map key instead of the string. Literals are hashed at compile time,
+	/// comparing and hashing an id is an integer operation and never allocates. Outside of shipping builds interned
+	/// names can be looked up again for debugging, and two names with the same hash are reported.
+	/// </summary>
+	class StringId
+	{
+	public:
+		static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+		static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+		// Invalid id, doesn't compare equal to the id of any name, not even the empty one
+		constexpr StringId() = default;
+		constexpr StringId(const char* name) : m_Hash(Hash(FNV_OFFSET_BASIS, std::string_view(name))) {}
+		constexpr StringId(std::string_view name) : m_Hash(Hash(FNV_OFFSET_BASIS, name)) {}
+		StringId(const std::string& name) : m_Hash(Hash(FNV_OFFSET_BASIS, name)) {}
+
+		/// <summary>
+		/// Hashes the name and remembers it for GetDebugName(). Only the ids created by the systems that own the names
+		/// (e.g. when registering an action) have to be interned, lookups can hash without it.
+		/// </summary>
+		static StringId Intern(std::string_view name);
+
+		// Id of the name with suffix appended, without building the combined string. E.g. prefix + path.
+		constexpr StringId Append(std::string_view suffix) const
+		{
+			StringId id;
+			id.m_Hash = Hash(m_Hash, suffix);
+			return id;
+		}
+
+		// The interned name, "?" if the name was never interned. Always "?" in shipping builds.
+		const char* GetDebugName() const;
+
+		constexpr uint64_t GetHash() const { return m_Hash; }
+		constexpr bool IsValid() const { return m_Hash != 0; }
+
+		constexpr bool operator==(const StringId& other) const { return m_Hash == other.m_Hash; }
+		constexpr bool operator!=(const StringId& other) const { return m_Hash != other.m_Hash; }
+
+	private:
+		static constexpr uint64_t Hash(uint64_t hash, std::string_view name)
+		{
+			for (const char c : name)
+			{
+				hash ^= static_cast<uint8_t>(c);
+				hash *= FNV_PRIME;
+			}
+			return hash;
+		}
+
+		uint64_t m_Hash = 0;
+	};
+
+	// Number of interned names, 0 in shipping builds
+	size_t GetInternedStringCount();
+} // namespace Ball
+
+// The id already is a hash, maps keyed by it don't hash the name again
+template<>
+struct std::hash<Ball::StringId>
+{
+	size_t operator()(const Ball::StringId& id) const { return static_cast<size_t>(id.GetHash()); }
+};
@@ -0,0 +1,38 @@
+#define SHADER_STRUCT 1
+
+#include "ShaderHeaders/GpuModelStruct.h"
+#include "ShaderHeaders/OpacityMicromapGPU.h"
+
+// Alpha test of a candidate hit on a non opaque triangle, true when the ray should stop there. Only alpha tested
+// primitives are non opaque, their opacity micromap answers most hits without touching the base color texture.
+bool AlphaTestCandidate(uint modelID, uint primitiveID, uint triangleID, float2 barycentricUV)
+{
+    StructuredBuffer<ModelHeapLocation> modelBuffer = ResourceDescriptorHeap[RDH_MODEL_DATA];
+    ModelHeapLocation modelInfo = modelBuffer[modelID];
+    PrimitiveGPU primitiveInfo =
+        StructuredBuffer<PrimitiveGPU>(ResourceDescriptorHeap[modelInfo.m_ModelStart])[primitiveID];
+    if (primitiveInfo.m_OpacityMicromapIndex == -1)
+        return true;
+
+    uint state = OpacityState(modelInfo.m_ModelStart + BUFFER_OFFSET + primitiveInfo.m_OpacityMicromapIndex,
+                              triangleID, barycentricUV);
+    if (state != OPACITY_UNKNOWN)
+        return state == OPACITY_OPAQUE;
+
+    // The micro-triangle is partly cut out, sample the top mip like the bake did
+    MaterialGPU materialInfo = StructuredBuffer<MaterialGPU>(
+        ResourceDescriptorHeap[modelInfo.m_ModelStart + MATERIAL_OFFSET])[primitiveInfo.m_MaterialIndex];
+    StructuredBuffer<uint> indexBuffer =
+        ResourceDescriptorHeap[modelInfo.m_ModelStart + BUFFER_OFFSET + primitiveInfo.m_IndexBufferId];
+    StructuredBuffer<float2> uvBuffer =
+        ResourceDescriptorHeap[modelInfo.m_ModelStart + BUFFER_OFFSET + primitiveInfo.m_TexCoordIndex];
+    float2 uv = uvBuffer[indexBuffer[triangleID * 3 + 0]] * (1.f - barycentricUV.x - barycentricUV.y) +
+        uvBuffer[indexBuffer[triangleID * 3 + 1]] * barycentricUV.x +
+        uvBuffer[indexBuffer[triangleID * 3 + 2]] * barycentricUV.y;
+
+    Texture2D<float4> baseColor =
+        ResourceDescriptorHeap[modelInfo.m_TextureStart + materialInfo.m_BaseColorTextureIndex];
+    SamplerState baseColorSampler = SamplerDescriptorHeap[materialInfo.m_BaseColorSamplerIndex];
+    float alpha = baseColor.SampleLevel(baseColorSampler, uv, 0.f).a * materialInfo.m_BaseColorFactor.a;
+    return alpha >= materialInfo.m_AlphaCutoff;
+}
@@ -1,6 +1,7 @@
 #define SHADER_STRUCT 1
 
 #include "ShaderHeaders/WavefrontStructsGPU.h" 
+#include "AlphaTest.hlsl"
 
 StructuredBuffer<ShadowRay> shadowRayBatch : register(t0);
 RaytracingAccelerationStructure sceneBVH : register(t1);
@@ -23,7 +24,8 @@ void main(uint3 idx : SV_DispatchThreadID)
 	// Shade only active shadow rays
     if (idx.x < atomicShadowRays[1])
     {
-        RayQuery<RAY_FLAG_CULL_NON_OPAQUE | RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES> query;
+        // Any opaque hit occludes the light, the closest one isn't needed
+        RayQuery<RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES | RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH> query;
 
 		// Setup a shadow ray
         RayDesc ray;
@@ -38,11 +40,20 @@ void main(uint3 idx : SV_DispatchThreadID)
             0xff,
             ray);
 
-        query.Proceed();
+        // Hits on alpha tested geometry only occlude where they pass the alpha test
+        while (query.Proceed())
+        {
+            if (query.CandidateType() == CANDIDATE_NON_OPAQUE_TRIANGLE &&
+                AlphaTestCandidate(query.CandidateInstanceID(), query.CandidateGeometryIndex(),
+                                   query.CandidatePrimitiveIndex(), query.CandidateTriangleBarycentrics()))
+                query.CommitNonOpaqueTriangleHit();
+        }
         
+        // Rays towards the sky aren't part of ReSTIR, they always add their energy and never touch the reservoirs
+        bool isEnvironment = shadowRayBatch[idx.x].m_IsEnvironment == 1;
         if (query.CommittedStatus() == COMMITTED_NOTHING)
         {
-            if (settings.m_WavefronLoopIdx != 0 || settings.m_UseReSTIR == 0)
+            if (isEnvironment || settings.m_WavefronLoopIdx != 0 || settings.m_UseReSTIR == 0)
             {
                 // ToDo, reimplement this or add a flag for it
 			    // Remove fireflies, using the threshold
@@ -60,7 +71,7 @@ void main(uint3 idx : SV_DispatchThreadID)
         }
         else
         {
-            if (settings.m_WavefronLoopIdx == 0)
+            if (settings.m_WavefronLoopIdx == 0 && !isEnvironment)
             {
                 // ToDo: Research reset reservoir or set weight to 0?
                 currentReservoirs[shadowRayBatch[idx.x].m_PixelIdx].m_Weight = 0.f;
@@ -1,8 +1,12 @@
 #include "NEE.hlsl"
 #include "ReSTIR.hlsl"
+#include "ShaderHeaders/CameraGPU.h"
+#include "ShaderHeaders/EnvironmentMapGPU.h"
 
 ConstantBuffer<DISeedData> shadeSeedData : register(b0);
 ConstantBuffer<ReStirSettings> restirSettings : register(b1);
+ConstantBuffer<GameplaySkyMat> skyMat : register(b2);
+ConstantBuffer<EnvironmentSettings> environmentSettings : register(b3);
 
 StructuredBuffer<Ray> rayBatch : register(t0);
 StructuredBuffer<LightPickData> lightData : register(t1);
@@ -35,7 +39,10 @@ void main(uint3 idx : SV_DispatchThreadID)
 		float3 lightContribution = float3(0.0, 0.0, 0.0);
 		bool isLightContributing = false;
 
-		float2 blueNoise = SampleBlueNoiseTexture(pixelIdx, shadeSeedData.m_FrameIdx).xy;
+		// Point on the light, the same one for every candidate
+		uint lightDimension = SamplingDimension(shadeSeedData.m_WavefronLoopIdx, SAMPLE_LIGHT);
+		float2 lightSample = float2(SamplePixel(pixelIdx, shadeSeedData.m_FrameIdx, lightDimension),
+								  SamplePixel(pixelIdx, shadeSeedData.m_FrameIdx, lightDimension + 1));
 
 		// We only do ReSTIR on the FIRST iteration as after that we don't have valid spatio-temporal data
 		if (restirSettings.m_UseReSTIR != 0 && shadeSeedData.m_WavefronLoopIdx == 0)
@@ -56,7 +63,7 @@ void main(uint3 idx : SV_DispatchThreadID)
 				// https://www.youtube.com/watch?v=kI5uEMXvreY&t=10217s&ab_channel=High-PerformanceGraphics
 				uint lightID = rand(seed) * shadeSeedData.m_NumLights - 1;
 
-                LightDataRaw resLightData = GetLightData(ray.m_Origin, lightID, lightData[lightID], blueNoise);
+                LightDataRaw resLightData = GetLightData(ray.m_Origin, lightID, lightData[lightID], lightSample);
 				bool resIsLightContributing = EvalLightContribution(materialHitData,
 																	normal,
 																	ray.m_Direction, 
@@ -89,7 +96,7 @@ void main(uint3 idx : SV_DispatchThreadID)
 
 			// Sample a random light source
 			uint randomLightID = rand(seed) * shadeSeedData.m_NumLights - 1;
-            LightDataRaw randomLightData = GetLightData(ray.m_Origin, randomLightID, lightData[randomLightID], blueNoise);
+            LightDataRaw randomLightData = GetLightData(ray.m_Origin, randomLightID, lightData[randomLightID], lightSample);
 
             // I don't think this should get accounted in lightColor.
 			// IMO, lightColor var should be constant and should represent
@@ -123,12 +130,55 @@ void main(uint3 idx : SV_DispatchThreadID)
 
             sRay.m_Energy = ray.m_Throughput * lightContribution;
 			sRay.m_PixelIdx = pixelIdx; // We will need to write to the corresponding pixel
-			sRay.m_Padding = 0.f;
+			sRay.m_IsEnvironment = 0;
 
 			// Increment the atomic and "push" to the shadow rays array
 			uint prevAtom = 0;
 			InterlockedAdd(atomicShadowRays[1], 1, prevAtom);
 			shadowRayBatch[prevAtom] = sRay;
 		}
+
+		// ENVIRONMENT
+		// The sky gets a shadow ray of its own, weighted against the diffuse bounce Shade.hlsl continues the path with
+		if (environmentSettings.m_Enabled != 0)
+		{
+			uint2 size = uint2(environmentSettings.m_Width, environmentSettings.m_Height);
+			uint environmentDimension = SamplingDimension(shadeSeedData.m_WavefronLoopIdx, SAMPLE_ENVIRONMENT);
+			float4 r;
+			for (uint i = 0; i < 4; i++)
+				r[i] = SamplePixel(pixelIdx, shadeSeedData.m_FrameIdx, environmentDimension + i);
+			float environmentPdf = 0.f;
+			float3 skyDir = SampleEnvironment(size, r, environmentPdf);
+
+			// The distribution lives in the space of the HDRI, the rotation matrix takes world directions there
+			float3 lightDir = skyDir;
+			if (skyMat.m_UseSkyMat == 1)
+				lightDir = normalize(mul(float4(skyDir, 0.f), skyMat.m_RotMat).xyz);
+
+			float NdotL = dot(normal, lightDir);
+			if (environmentPdf > 0.f && NdotL > 0.f)
+			{
+				float diffusePdf = 0.f;
+				float3 diffuse = EvalDiffuseGltf(materialHitData, -ray.m_Direction, normal, lightDir, diffusePdf);
+
+				SamplerState mirror = SamplerDescriptorHeap[SDH_SKYBOX];
+				Texture2D<float4> skyboxTex = ResourceDescriptorHeap[RDH_SKYBOX];
+				float3 sky = skyboxTex.SampleLevel(mirror, DirectionToEnvironmentUV(skyDir), 0).rgb;
+				float misWeight = EnvironmentMISWeight(environmentPdf, diffusePdf);
+
+				ShadowRay envRay;
+				envRay.m_Origin = ray.m_Origin;
+				envRay.m_Direction = lightDir;
+				envRay.m_DistanceT = 100000.f; // Same reach as the camera rays
+				envRay.m_Energy = ray.m_Throughput * diffuse * sky * skyMat.m_LightingStrength * NdotL * misWeight /
+								  environmentPdf;
+				envRay.m_PixelIdx = pixelIdx;
+				envRay.m_IsEnvironment = 1;
+
+				uint prevAtom = 0;
+				InterlockedAdd(atomicShadowRays[1], 1, prevAtom);
+				shadowRayBatch[prevAtom] = envRay;
+			}
+		}
     }
 }
\ No newline at end of file
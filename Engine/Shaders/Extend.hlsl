@@ -1,4 +1,5 @@
 #include "Common.hlsl"
+#include "AlphaTest.hlsl"
 #include "ShaderHeaders/WavefrontStructsGPU.h"
 
 RaytracingAccelerationStructure sceneBVH : register(t0);
@@ -14,7 +15,7 @@ void main(uint3 idx : SV_DispatchThreadID)
 	// We work only with the active rays
     if (idx.x < rayCount[0])
     {
-        RayQuery<RAY_FLAG_CULL_NON_OPAQUE | RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES> query;
+        RayQuery<RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES> query;
 
         RayDesc ray;
         ray.Origin = rayBatch[idx.x].m_Origin;
@@ -29,7 +30,14 @@ void main(uint3 idx : SV_DispatchThreadID)
             0xff,
             ray);
 
-        query.Proceed();
+        // Only alpha tested geometry is non opaque, its hits count when they pass the alpha test
+        while (query.Proceed())
+        {
+            if (query.CandidateType() == CANDIDATE_NON_OPAQUE_TRIANGLE &&
+                AlphaTestCandidate(query.CandidateInstanceID(), query.CandidateGeometryIndex(),
+                                   query.CandidatePrimitiveIndex(), query.CandidateTriangleBarycentrics()))
+                query.CommitNonOpaqueTriangleHit();
+        }
 
         if (query.CommittedStatus() == COMMITTED_TRIANGLE_HIT)
         {
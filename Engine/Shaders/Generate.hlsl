@@ -37,7 +37,9 @@ void main(uint3 idx : SV_DispatchThreadID)
     seed = GetWangHashSeed(seed);
     
     // Generate rays with AA
-    CamRay camRay = GenerateRay(float(idx.x) + rand(seed), float(idx.y) + rand(seed), camera); //  + 0.5 to disable jittering
+    float jitterX = LowDiscrepancySample(idx.x, idx.y, accumFrames.m_FramesNum, SAMPLE_CAMERA_JITTER);
+    float jitterY = LowDiscrepancySample(idx.x, idx.y, accumFrames.m_FramesNum, SAMPLE_CAMERA_JITTER + 1);
+    CamRay camRay = GenerateRay(float(idx.x) + jitterX, float(idx.y) + jitterY, camera); //  + 0.5 to disable jittering
     rayBatch[pixelIdx].m_Origin = camRay.m_Pos;
     rayBatch[pixelIdx].m_Direction = camRay.m_Dir;
     rayBatch[pixelIdx].m_PixelIdx = pixelIdx;
@@ -45,7 +47,9 @@ void main(uint3 idx : SV_DispatchThreadID)
     rayBatch[pixelIdx].m_LastSpecular = 1; // First is always considered specular, as we need to render light sources
     rayBatch[pixelIdx].m_Absorption = float3(0.f, 0.f, 0.f);
     rayBatch[pixelIdx].m_ConeWidth = 0.f;
+    rayBatch[pixelIdx].m_ConeSpreadAngle = camera.m_PrimaryConeSpreadAngle;
     rayBatch[pixelIdx].m_MaxT = 100000.f;
+    rayBatch[pixelIdx].m_EnvironmentMisPdf = 0.f;
     
     //wavefrontOutput[pixelIdx] = float4((camRay.m_Dir + 1.f) * 0.5f, 0.f);
     //return;
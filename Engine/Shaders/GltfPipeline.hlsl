@@ -2,6 +2,7 @@
 
 #include "Common.hlsl"
 #include "ShaderHeaders/WavefrontStructsGPU.h"
+#include "ShaderHeaders/RayConeGPU.h"
 
 // Inspired by https://github.com/nvpro-samples/vk_raytrace/tree/master
 // Compact data, from a primitive reused a lot of times
@@ -20,54 +21,34 @@ struct GeomIntersectData
     int m_TextureStart;
     int m_ModelStart;
     int m_MaterialIndex;
-    float m_TexelAreaDouble;
-    float m_TriangleAreaDouble;
+    float m_TriangleLODConstant; // World space, see RayConeGPU.h
+    float m_Curvature; // World space, positive on convex surfaces
 };
 
-float GetDoubleTriangleArea(float3 v0, float3 v1, float3 v2)
+// Referenced from RT Gems Chapter 20.6, the ray has to be propagated to the hit first
+float GetMaterialLOD(Ray ray, GeomIntersectData geoData, float lodBias)
 {
-    float3 v01 = v1 - v0;
-    float3 v02 = v2 - v0;
-    float3 crossProduct = cross(v01, v02);
-    
-    float area = length(crossProduct); // no * 0.5
-    return area;
-}
-
-float GetDoubleTriangleArea(float2 v0, float2 v1, float2 v2)
-{
-    float2 v01x = v1.x - v0.x;
-    float2 v02x = v2.x - v0.x;
-    float2 v01y = v1.y - v0.y;
-    float2 v02y = v2.y - v0.y;
-    
-    float area = abs(v01x * v02y - v02x * v01y);
-    return area;
-}
-
-// Referenced from RT Gems Chapter 20.6
-void PropagateRayCone(inout Ray ray, float hitT, float coneSpreadAngle)
-{
-    ray.m_ConeWidth = coneSpreadAngle * hitT + ray.m_ConeWidth;
+    return ConeMaterialLOD(geoData.m_TriangleLODConstant,
+                           ray.m_ConeWidth,
+                           dot(ray.m_Direction.xyz, geoData.m_GeomNormal),
+                           lodBias);
 }
 
-// Referenced from RT Gems Chapter 20.6
-float GetTriangleLODConstant(float texelArea, float triangleArea, float texDim)
+// Mip level of one texture of the material, textures of a material don't have to share a size
+float GetTextureMip(Texture2D<float4> tex, float materialLOD)
 {
-    float tA = texDim * texDim * texelArea;
-    float pA = triangleArea;
-    return 0.5 * log2(tA / pA);
+    float width;
+    float height;
+    tex.GetDimensions(width, height);
+    return TextureMipLevel(materialLOD, width, height);
 }
 
-// Referenced from RT Gems Chapter 20.6
-float GetMaterialLOD(Ray ray, MaterialGPU materialInfo, GeomIntersectData geoData)
+float GetTextureMip(Texture2D<float3> tex, float materialLOD)
 {
-    float lambda = GetTriangleLODConstant(geoData.m_TexelAreaDouble, geoData.m_TriangleAreaDouble, materialInfo.m_TextureDim);
-    lambda += log2(abs(ray.m_ConeWidth) + 0.00001);
-    //lambda += 0.5 * log2(materialInfo.m_TextureDim * materialInfo.m_TextureDim); This is in boox example code, but not in formula???
-    lambda -= log2(abs(dot(ray.m_Direction.xyz, geoData.m_Normal)));
-    return lambda;
-    
+    float width;
+    float height;
+    tex.GetDimensions(width, height);
+    return TextureMipLevel(materialLOD, width, height);
 }
 
 GeomIntersectData GetIntersectionData(ExtendResult hitResult)
@@ -83,6 +64,8 @@ GeomIntersectData GetIntersectionData(ExtendResult hitResult)
     intersection.m_TextureStart = 0;
     intersection.m_ModelStart = 0;
     intersection.m_MaterialIndex = 0;
+    intersection.m_TriangleLODConstant = 0.f;
+    intersection.m_Curvature = 0.f;
     // --------------- Get Ids -------------------------------------
     uint modelID = (hitResult.m_ModelAndInstanceID >> 16) & 0xFFFF;
     uint instanceID = hitResult.m_ModelAndInstanceID & 0xFFFF;
@@ -127,7 +110,17 @@ GeomIntersectData GetIntersectionData(ExtendResult hitResult)
         float3 pos = pos0 * barycentrics.x + pos1 * barycentrics.y + pos2 * barycentrics.z;
         // World position of the intersection
         intersection.m_Position = pos;
-        intersection.m_TriangleAreaDouble = GetDoubleTriangleArea(pos0, pos1, pos2);
+    }
+
+    // Ray cone data baked in model space, an instance that scales the triangle changes both
+    if (primitiveInfo.m_TriangleLODIndex != -1)
+    {
+        StructuredBuffer<uint> lodBuffer =
+				ResourceDescriptorHeap[modelInfo.m_ModelStart + BUFFER_OFFSET + primitiveInfo.m_TriangleLODIndex];
+        float2 triangleLOD = UnpackTriangleLOD(lodBuffer[triangleID]);
+        float scaleLog2 = TransformScaleLog2(abs(determinant((float3x3) transformToWorld)));
+        intersection.m_TriangleLODConstant = triangleLOD.x - scaleLog2;
+        intersection.m_Curvature = triangleLOD.y * exp2(-scaleLog2);
     }
     
     // Get texture coordinates
@@ -145,7 +138,6 @@ GeomIntersectData GetIntersectionData(ExtendResult hitResult)
         float2 textureUVs = uv0 * barycentrics.x + uv1 * barycentrics.y +
 				uv2 * barycentrics.z;
         intersection.m_UV = textureUVs;
-        intersection.m_TexelAreaDouble = GetDoubleTriangleArea(uv0, uv1, uv2);
     }
     // Intersection normal
     if (primitiveInfo.m_NormalIndex != -1)
@@ -225,7 +217,7 @@ void ApplyNormalMap(MaterialGPU materialInfo, SamplerState texSampler, inout Geo
     if (materialInfo.m_NormalTextureIndex != -1)
     {
         Texture2D<float3> normalTexture = ResourceDescriptorHeap[data.m_TextureStart + materialInfo.m_NormalTextureIndex];
-        float3 normTex = normalTexture.SampleLevel(texSampler, data.m_UV, materialInfo.m_MaterialLOD).rgb;
+        float3 normTex = normalTexture.SampleLevel(texSampler, data.m_UV, GetTextureMip(normalTexture, materialInfo.m_MaterialLOD)).rgb;
         normTex = normalize(normTex * 2.f - 1.f);
         //normTex *= float3(materialInfo.m_NormalTextureScale, materialInfo.m_NormalTextureScale, 1.0);
         //normTex.g = -normTex.g;
@@ -240,7 +232,7 @@ float3 GetEmissiveColor(MaterialGPU materialInfo, SamplerState texSampler, GeomI
     if (materialInfo.m_EmissiveTextureIndex != -1)
     {
         Texture2D<float4> emissiveTexture = ResourceDescriptorHeap[data.m_TextureStart + materialInfo.m_EmissiveTextureIndex];
-        emissiveColor *= SRGBToLinear(emissiveTexture.SampleLevel(texSampler, data.m_UV, materialInfo.m_MaterialLOD)).xyz;
+        emissiveColor *= SRGBToLinear(emissiveTexture.SampleLevel(texSampler, data.m_UV, GetTextureMip(emissiveTexture, materialInfo.m_MaterialLOD))).xyz;
     }
     return emissiveColor;
 }
@@ -251,7 +243,7 @@ void GetBaseColor(inout MaterialHitData matData, MaterialGPU materialInfo, Sampl
     if (materialInfo.m_BaseColorTextureIndex != -1)
     {
         Texture2D<float4> baseColorTexture =ResourceDescriptorHeap[data.m_TextureStart + materialInfo.m_BaseColorTextureIndex];
-        matData.m_BaseColor *= SRGBToLinear(baseColorTexture.SampleLevel(texSampler, data.m_UV, materialInfo.m_MaterialLOD)).rgb;
+        matData.m_BaseColor *= SRGBToLinear(baseColorTexture.SampleLevel(texSampler, data.m_UV, GetTextureMip(baseColorTexture, materialInfo.m_MaterialLOD))).rgb;
     }
 
     matData.m_BaseColor *= data.m_Color;
@@ -268,7 +260,7 @@ void GetMetallicRoughnessInfo(inout MaterialHitData matData, MaterialGPU materia
         // This layout intentionally reserves the 'r' channel for (optional) occlusion map data
         Texture2D<float4> metallicRoughnessTexture = ResourceDescriptorHeap[data.m_TextureStart + materialInfo.m_MetallicRoughnessTextureIndex];
         
-        float4 metRough = metallicRoughnessTexture.SampleLevel(texSampler, data.m_UV, materialInfo.m_MaterialLOD);
+        float4 metRough = metallicRoughnessTexture.SampleLevel(texSampler, data.m_UV, GetTextureMip(metallicRoughnessTexture, materialInfo.m_MaterialLOD));
         matData.m_AlphaRoughness *= metRough.g;
         matData.m_Metallic *= metRough.b;
     }
@@ -286,14 +278,14 @@ void GetSpecularInfo(inout MaterialHitData matData, MaterialGPU materialInfo, Sa
     {
         Texture2D<float4> specularTexture = ResourceDescriptorHeap[data.m_TextureStart + materialInfo.m_SpecularTextureIndex];
         
-        matData.m_SpecularWeight *= specularTexture.SampleLevel(texSampler, data.m_UV, materialInfo.m_MaterialLOD).a;
+        matData.m_SpecularWeight *= specularTexture.SampleLevel(texSampler, data.m_UV, GetTextureMip(specularTexture, materialInfo.m_MaterialLOD)).a;
     }
 
     if (materialInfo.m_SpecularColorTextureIndex != -1)
     {
         Texture2D<float4> specularColorTexture = ResourceDescriptorHeap[data.m_TextureStart + materialInfo.m_SpecularColorTextureIndex];
 
-        specularTextureSample = SRGBToLinear(specularColorTexture.SampleLevel(texColSampler, data.m_UV, materialInfo.m_MaterialLOD).rgb);
+        specularTextureSample = SRGBToLinear(specularColorTexture.SampleLevel(texColSampler, data.m_UV, GetTextureMip(specularColorTexture, materialInfo.m_MaterialLOD)).rgb);
       
     }
 
@@ -310,7 +302,7 @@ void GetTransmissionInfo(inout MaterialHitData matData, MaterialGPU materialInfo
     {
         Texture2D<float4> transmissionTexture = ResourceDescriptorHeap[data.m_TextureStart + materialInfo.m_TransmissionTextureIndex];
         
-        float4 transmissionSample = transmissionTexture.SampleLevel(texSampler, data.m_UV, materialInfo.m_MaterialLOD);
+        float4 transmissionSample = transmissionTexture.SampleLevel(texSampler, data.m_UV, GetTextureMip(transmissionTexture, materialInfo.m_MaterialLOD));
         matData.m_TransmissionFactor *= transmissionSample.r;
     }
 }
@@ -1,36 +1,8 @@
 #define SHADER_STRUCT 1
 
 #include "ShaderHeaders/GpuModelStruct.h"
-
-uint CombineIntoSeed(uint pixelIdx, uint frameIdx, uint wavefrontLoopIdx)
-{
-    uint combinedValue = (frameIdx * 55001) + (pixelIdx * 78713) + (wavefrontLoopIdx * 26927);
-    return combinedValue;
-}
-
-uint GetWangHashSeed(uint seed)
-{
-    seed = (seed ^ 61) ^ (seed >> 16);
-    seed *= 9;
-    seed = seed ^ (seed >> 4);
-    seed *= 0x27d4eb2d;
-    seed = seed ^ (seed >> 15);
-    return seed;
-}
-
-float rand(inout uint seed) // inout allows to modify the input value, so we get different rand every time
-{
-    // White Noise
-    seed ^= (seed << 13);
-    seed ^= (seed >> 17);
-    seed ^= (seed << 5);
-    return seed / 4294967296.0; // float [0, 1] ( divided on maximum 32-bit unsigned integer) 
-}
-
-float3 randf3(inout uint seed)
-{
-    return float3(rand(seed), rand(seed), rand(seed));
-}
+#include "ShaderHeaders/RandomGPU.h"
+#include "ShaderHeaders/SamplingGPU.h"
 
 float4 SampleBlueNoiseTexture(uint idx, uint frameID)
 {
@@ -44,7 +16,8 @@ float4 SampleBlueNoiseTexture(uint idx, uint frameID)
 
 	int textureWidth;
 	int textureHeight;
-	Texture2D<float4> blueNoiseTexture = ResourceDescriptorHeap[RDH_BLUENOISE];
+	// The slice follows the frame index of the dispatch, the descriptors of all slices stay bound
+	Texture2D<float4> blueNoiseTexture = ResourceDescriptorHeap[RDH_BLUENOISE + (frameID & (NUM_BLUENOISE - 1))];
 	blueNoiseTexture.GetDimensions(textureWidth, textureHeight);
 
 	textureWidth = textureWidth - 1;
@@ -55,4 +28,15 @@ float4 SampleBlueNoiseTexture(uint idx, uint frameID)
 	uint wrappedY = uint(screenY + offset.y) & textureHeight;
 
 	return blueNoiseTexture.Load(int3(wrappedX, wrappedY, 0));
+}
+
+// Low discrepancy sample of a pixel, frameID and the dimension follow the indexing of CombineIntoSeed
+float SamplePixel(uint idx, uint frameID, uint dimension)
+{
+	int screenWidth;
+	int screenHeight;
+	Texture2D<float4> screenTexture = ResourceDescriptorHeap[RDH_OUTPUT];
+	screenTexture.GetDimensions(screenWidth, screenHeight);
+
+	return LowDiscrepancySample(idx % screenWidth, idx / screenWidth, frameID, dimension);
 }
\ No newline at end of file
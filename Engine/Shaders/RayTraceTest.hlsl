@@ -1,6 +1,7 @@
 #define SHADER_STRUCT 1
 
 #include "Common.hlsl"
+#include "AlphaTest.hlsl"
 
 #include "ShaderHeaders/CameraGPU.h"
 #include "ShaderHeaders/GpuModelStruct.h"
@@ -36,13 +37,19 @@ float4 SampleSky(float3 rayDir, SamplerState samp)
 	ray.TMin = 0;
 	ray.TMax = 100000;
 
-	RayQuery<RAY_FLAG_CULL_NON_OPAQUE | RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES> query;
+	RayQuery<RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES> query;
 
 	outputTexture[idx.xy] = SampleSky(normalize(ray.Direction), mirror);
 
 	query.TraceRayInline(sceneBVH, RAY_FLAG_NONE, 0xff, ray);
 
-	query.Proceed();
+	while (query.Proceed())
+	{
+		if (query.CandidateType() == CANDIDATE_NON_OPAQUE_TRIANGLE &&
+			AlphaTestCandidate(query.CandidateInstanceID(), query.CandidateGeometryIndex(),
+							   query.CandidatePrimitiveIndex(), query.CandidateTriangleBarycentrics()))
+			query.CommitNonOpaqueTriangleHit();
+	}
 
 	float3 finalOutput = float3(1.0, 0.0, 1.0);
 
@@ -120,11 +127,17 @@ float4 SampleSky(float3 rayDir, SamplerState samp)
 			shadowRay.TMin = 0.01;
 			shadowRay.TMax = 100000;
 
-			RayQuery<RAY_FLAG_CULL_NON_OPAQUE | RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES> query;
+			RayQuery<RAY_FLAG_SKIP_PROCEDURAL_PRIMITIVES> query;
 
 			query.TraceRayInline(sceneBVH, RAY_FLAG_NONE, 0xff, shadowRay);
 
-			query.Proceed();
+			while (query.Proceed())
+			{
+				if (query.CandidateType() == CANDIDATE_NON_OPAQUE_TRIANGLE &&
+					AlphaTestCandidate(query.CandidateInstanceID(), query.CandidateGeometryIndex(),
+									   query.CandidatePrimitiveIndex(), query.CandidateTriangleBarycentrics()))
+					query.CommitNonOpaqueTriangleHit();
+			}
 
 			if (query.CommittedStatus() == COMMITTED_TRIANGLE_HIT)
 			{
@@ -1,10 +1,12 @@
 #include "PBR.hlsl"
 #include "ReSTIR.hlsl"
 #include "ShaderHeaders/CameraGPU.h"
+#include "ShaderHeaders/EnvironmentMapGPU.h"
 
 ConstantBuffer<ShadeSeedData> shadeSeedData : register(b0);
 ConstantBuffer<GameplaySkyMat> skyMat : register(b1);
 ConstantBuffer<ShadeSettings> shadeSettings : register(b2);
+ConstantBuffer<EnvironmentSettings> environmentSettings : register(b3);
 
 StructuredBuffer<uint> rayCount : register(t0);
 StructuredBuffer<ExtendResult> extendedBatch : register(t1);
@@ -36,17 +38,20 @@ float3 ApplyThreshold(float3 color)
     return clampedEnergy;
 }
 
-float4 SampleSky(float3 rayDir, SamplerState samp)
+// Direction in the space of the HDRI
+float3 ToSkySpace(float3 rayDir)
 {
     if (skyMat.m_UseSkyMat == 1)
     {
         rayDir = normalize(mul(skyMat.m_RotMat, float4(rayDir, 0.0f)).xyz);
     }
-    float u = 0.5 + atan2(rayDir.z, rayDir.x) / (2 * PI);
-    float v = 0.5 - asin(rayDir.y) / PI;
+    return rayDir;
+}
 
+float4 SampleSky(float3 skyDir, SamplerState samp)
+{
     Texture2D<float4> skyboxTex = ResourceDescriptorHeap[RDH_SKYBOX];
-	return float4(skyboxTex.SampleLevel(samp, float2(u, v), 0).rgb, 1.0);
+	return float4(skyboxTex.SampleLevel(samp, DirectionToEnvironmentUV(skyDir), 0).rgb, 1.0);
 }
 
 // 1 - survival chance in Russian Rullette after hitting a surface
@@ -80,8 +85,17 @@ void main(uint3 idx : SV_DispatchThreadID)
         if (hitResult.m_DistanceT < 0.f)
         {
             SamplerState mirror = SamplerDescriptorHeap[SDH_SKYBOX]; 
-            float3 skyColor = rayThroughput * SampleSky(normalize(ray.m_Direction).xyz, mirror).rgb ;
-			output[pixelIdx] += float4(ApplyThreshold(skyColor * skyMat.m_LightingStrength), 0.f);
+            float3 skyDir = ToSkySpace(normalize(ray.m_Direction).xyz);
+            float3 skyColor = rayThroughput * SampleSky(skyDir, mirror).rgb;
+
+            // The sky was also sampled directly from the last diffuse bounce, both estimates share its light
+            float misWeight = 1.f;
+            if (ray.m_EnvironmentMisPdf > 0.f)
+            {
+                uint2 size = uint2(environmentSettings.m_Width, environmentSettings.m_Height);
+                misWeight = EnvironmentMISWeight(ray.m_EnvironmentMisPdf, EnvironmentPdf(size, skyDir));
+            }
+			output[pixelIdx] += float4(ApplyThreshold(skyColor * skyMat.m_LightingStrength * misWeight), 0.f);
 
             // No geometry intersected
             if (shadeSeedData.m_WavefronLoopIdx == 0)
@@ -107,7 +121,7 @@ void main(uint3 idx : SV_DispatchThreadID)
         }
         // Get vertex attributes
         GeomIntersectData intersectData = GetIntersectionData(hitResult);
-        PropagateRayCone(ray, hitResult.m_DistanceT, shadeSettings.m_ConeSpreadAngle);
+        ray.m_ConeWidth = PropagateConeWidth(ray.m_ConeWidth, ray.m_ConeSpreadAngle, hitResult.m_DistanceT);
         
         if (shadeSeedData.m_WavefronLoopIdx == 0)
         {
@@ -117,7 +131,7 @@ void main(uint3 idx : SV_DispatchThreadID)
         MaterialGPU materialInfo =
         StructuredBuffer<MaterialGPU>( ResourceDescriptorHeap[intersectData.m_ModelStart + MATERIAL_OFFSET])[intersectData.m_MaterialIndex];
 
-        materialInfo.m_MaterialLOD = GetMaterialLOD(ray, materialInfo, intersectData);
+        materialInfo.m_MaterialLOD = GetMaterialLOD(ray, intersectData, shadeSettings.m_TextureLODBias);
         // EMISSION
         {
             float3 lightColor = GetEmissiveColor(materialInfo, SamplerDescriptorHeap[materialInfo.m_EmissiveSamplerIndex], intersectData);
@@ -257,7 +271,8 @@ void main(uint3 idx : SV_DispatchThreadID)
         {
             
             float probability = SurviveProbRR(albedo.rgb);
-            float randVal = rand(seed);
+            uint rouletteDimension = SamplingDimension(shadeSeedData.m_WavefronLoopIdx, SAMPLE_RUSSIAN_ROULETTE);
+            float randVal = SamplePixel(pixelIdx, shadeSeedData.m_FrameIdx, rouletteDimension);
 			// Kill random rays based on the max albedo color
             if (probability < randVal)
                 return;
@@ -284,7 +299,18 @@ void main(uint3 idx : SV_DispatchThreadID)
 			newRay.m_LastSpecular = isSpecular * ray.m_LastSpecular;
             newRay.m_Absorption = absorption;
             newRay.m_ConeWidth = ray.m_ConeWidth;
+            // Curved mirrors and rough lobes widen the cone, refraction keeps the spread of the incoming ray
+            float lobeSpread = isSpecular == 1 ? materialHitData.m_AlphaRoughness : RAY_CONE_DIFFUSE_SPREAD;
+            float curvature = refracted ? 0.f : (inside ? -intersectData.m_Curvature : intersectData.m_Curvature);
+            newRay.m_ConeSpreadAngle = BounceConeSpread(ray.m_ConeSpreadAngle,
+                                                        ray.m_ConeWidth,
+                                                        curvature,
+                                                        dot(ray.m_Direction, intersectData.m_Normal),
+                                                        lobeSpread);
             newRay.m_MaxT = range;
+            // DirectIllumination.hlsl samples the sky from diffuse bounces, it needs the density of the diffuse lobe
+            bool sampledSky = isSpecular == 0 && environmentSettings.m_Enabled != 0;
+            newRay.m_EnvironmentMisPdf = sampledSky ? abs(dot(intersectData.m_Normal, newRayDir)) / PI : 0.f;
 			// "Push" a new ray to the batch
 			uint prevAtom = 0;
 			InterlockedAdd(atomicNewRays[0], 1, prevAtom);
@@ -0,0 +1,550 @@
+#pragma once
+
+// BSDF evaluation and sampling of the path tracer. The shaders include it through PBR.hlsl, the CPU includes it to
+// validate the math (BsdfTests.cpp). Write the functions in the subset of HLSL that also compiles as C++ with glm:
+// float literals with an f suffix, full vector constructors and INOUT() for reference parameters.
+#include "RandomGPU.h"
+#include "WavefrontStructsGPU.h"
+
+#ifdef SHADER_STRUCT
+#include "GpuModelStruct.h"
+#define INOUT(type) inout type
+#else
+#include <cmath>
+#define INOUT(type) type&
+
+namespace Ball::Bsdf
+{
+	// HLSL intrinsics used below
+	using glm::abs;
+	using glm::clamp;
+	using glm::cos;
+	using glm::cross;
+	using glm::dot;
+	using glm::floor;
+	using glm::log;
+	using glm::max;
+	using glm::min;
+	using glm::normalize;
+	using glm::pow;
+	using glm::reflect;
+	using glm::refract;
+	using glm::sin;
+	using glm::sqrt;
+	using std::isnan;
+
+	using ShaderRandom::rand;
+
+	inline float2 lerp(const float2& a, const float2& b, float t) { return glm::mix(a, b, t); }
+	inline float3 lerp(const float3& a, const float3& b, float t) { return glm::mix(a, b, t); }
+#endif
+
+static const float BSDF_PI = 3.141592653589f;
+static const float BSDF_INV_PI = 0.318309886183f;
+
+// Referenced from
+// https://github.com/KhronosGroup/glTF-Sample-Viewer/blob/6546208a521eebff504929ce5bfa43da7c43eaee/source/Renderer/shaders/brdf.glsl
+// The following equation models the Fresnel reflectance term of the spec equation (aka F())
+// Implementation of fresnel from [4], Equation 15
+inline float3 F_Schlick(float3 f0, float3 f90, float VdotH)
+{
+	return f0 + (f90 - f0) * pow(clamp(1.f - VdotH, 0.f, 1.f), 5.f);
+}
+inline float F_Schlick(float f0, float f90, float VdotH)
+{
+	return f0 + (f90 - f0) * pow(clamp(1.f - VdotH, 0.f, 1.f), 5.f);
+}
+inline float F_SchlickDiel(float f0, float VdotH)
+{
+	float sinSq = f0 * f0 * (1.f - VdotH * VdotH);
+
+	// Total internal reflection
+	if (sinSq > 1.f)
+		return 1.f;
+
+	float cosT = sqrt(max(1.f - sinSq, 0.f));
+
+	float rs = (f0 * cosT - VdotH) / (f0 * cosT + VdotH);
+	float rp = (f0 * VdotH - cosT) / (f0 * VdotH + cosT);
+
+	return 0.5f * (rs * rs + rp * rp);
+}
+
+// Smith Joint GGX
+// Note: Vis = G / (4 * NdotL * NdotV)
+// see Eric Heitz. 2014. Understanding the Masking-Shadowing Function in Microfacet-Based BRDFs. Journal of Computer
+// Graphics Techniques, 3
+// see Real-Time Rendering. Page 331 to 336.
+// see https://google.github.io/filament/Filament.md.html#materialsystem/specularbrdf/geometricshadowing(specularg)
+inline float V_GGX(float NdotL, float NdotV, float alphaRoughness)
+{
+	float alphaRoughnessSq = alphaRoughness * alphaRoughness;
+
+	float GGXV = NdotL * sqrt(NdotV * NdotV * (1.f - alphaRoughnessSq) + alphaRoughnessSq);
+	float GGXL = NdotV * sqrt(NdotL * NdotL * (1.f - alphaRoughnessSq) + alphaRoughnessSq);
+
+	float GGX = GGXV + GGXL;
+	if (GGX > 0.f)
+	{
+		return 0.5f / GGX;
+	}
+	return 0.f;
+}
+
+// G1 / (2 * NdotV)
+inline float Smith_G_GGX(float NdotV, float alphaRoughness)
+{
+	float alphaRoughnessSq = alphaRoughness * alphaRoughness;
+	float dotSq = NdotV * NdotV;
+	return 1.f / (NdotV + sqrt(alphaRoughnessSq + dotSq - alphaRoughnessSq * dotSq));
+}
+
+// Smith masking of the view direction, the fraction of the visible microfacets seen from V
+inline float G1_GGX(float NdotV, float alphaRoughness)
+{
+	return 2.f * NdotV * Smith_G_GGX(NdotV, alphaRoughness);
+}
+
+// The following equation(s) model the distribution of microfacet normals across the area being drawn (aka D())
+// Implementation from "Average Irregularity Representation of a Roughened Surface for Ray Reflection" by T. S.
+// Trowbridge, and K. P. Reitz Follows the distribution function recommended in the SIGGRAPH 2013 course notes from
+// EPIC Games [1], Equation 3.
+inline float D_GGX(float NdotH, float alphaRoughness)
+{
+	float alphaRoughnessSq = alphaRoughness * alphaRoughness;
+	float f = (NdotH * NdotH) * (alphaRoughnessSq - 1.f) + 1.f;
+	return (alphaRoughnessSq / (f * f)) * BSDF_INV_PI;
+}
+
+inline float3 BRDF_LambertianSimple(float3 diffuseColor)
+{
+	return diffuseColor * BSDF_INV_PI;
+}
+
+// HEMISPHERE -----------------------------------
+// All sampled directions are in tangent space, z is the normal
+
+// Hemisphere importance sampling (Diffuse)
+inline float3 CosineWeightedDiffuseReflection(INOUT(uint) seed)
+{
+	float r0 = rand(seed);
+	float r1 = rand(seed);
+	float r = sqrt(r0);
+	float theta = 2.f * BSDF_PI * r1;
+	float x = r * cos(theta);
+	float y = r * sin(theta);
+	float3 ray = float3(x, y, sqrt(1.f - r0));
+
+	return ray;
+}
+
+// Hemisphere GGX sampling (Specular) of the half vector from the full distribution of normals, pdf is
+// D * NdotH. Only kept as the reference the visible normal sampling is tested against.
+inline float3 GGXSampling(float specularAlpha, INOUT(uint) seed)
+{
+	float r0 = rand(seed);
+	float r1 = rand(seed);
+	float phi = r0 * 2.f * BSDF_PI;
+
+	float cosTheta = sqrt((1.f - r1) / (1.f + (specularAlpha * specularAlpha - 1.f) * r1));
+	float sinTheta = clamp(sqrt(1.f - (cosTheta * cosTheta)), 0.f, 1.f);
+	float sinPhi = sin(phi);
+	float cosPhi = cos(phi);
+	float3 ray = float3(sinTheta * cosPhi, sinTheta * sinPhi, cosTheta);
+
+	return ray;
+}
+
+// Pdf of reflecting around a half vector from GGXSampling
+inline float GGXReflectionPdf(float NdotH, float VdotH, float alphaRoughness)
+{
+	return D_GGX(NdotH, alphaRoughness) * NdotH / (4.f * VdotH);
+}
+
+// Samples the half vector from the normals visible from V (in tangent space), pdf is G1(V) * VdotH * D / NdotV.
+// Reflections around it never point below the surface as often as with GGXSampling, which lowers the variance.
+// Eric Heitz. 2018. Sampling the GGX Distribution of Visible Normals. Journal of Computer Graphics Techniques, 7
+// r0 and r1 are uniform in [0, 1), the LUT baker passes a low discrepancy sequence
+inline float3 GGXSampleVNDF(float3 V, float specularAlpha, float r0, float r1)
+{
+	// Shading normals can put V below the surface, the mirrored direction keeps the sample valid
+	float3 Vh = normalize(float3(specularAlpha * V.x, specularAlpha * V.y, abs(V.z)));
+
+	// Orthonormal basis around the stretched view direction
+	float lengthSq = Vh.x * Vh.x + Vh.y * Vh.y;
+	float3 T1 = float3(1.f, 0.f, 0.f);
+	if (lengthSq > 0.f)
+		T1 = float3(-Vh.y, Vh.x, 0.f) / sqrt(lengthSq);
+	float3 T2 = cross(Vh, T1);
+
+	// Uniform disk sample, warped towards the part of the hemisphere that is visible
+	float r = sqrt(r0);
+	float phi = 2.f * BSDF_PI * r1;
+	float t1 = r * cos(phi);
+	float t2 = r * sin(phi);
+	float s = 0.5f * (1.f + Vh.z);
+	t2 = (1.f - s) * sqrt(max(1.f - t1 * t1, 0.f)) + s * t2;
+
+	// Reproject onto the hemisphere and unstretch
+	float3 Nh = t1 * T1 + t2 * T2 + sqrt(max(1.f - t1 * t1 - t2 * t2, 0.f)) * Vh;
+	return normalize(float3(specularAlpha * Nh.x, specularAlpha * Nh.y, max(Nh.z, 0.f)));
+}
+
+inline float3 GGXSamplingVNDF(float3 V, float specularAlpha, INOUT(uint) seed)
+{
+	float r0 = rand(seed);
+	float r1 = rand(seed);
+	return GGXSampleVNDF(V, specularAlpha, r0, r1);
+}
+
+// Pdf of reflecting around a half vector from GGXSamplingVNDF, the VdotH of the reflection Jacobian cancels out
+inline float GGXReflectionPdfVNDF(float NdotV, float NdotH, float alphaRoughness)
+{
+	return D_GGX(NdotH, alphaRoughness) * G1_GGX(NdotV, alphaRoughness) / (4.f * NdotV);
+}
+
+// ENERGY COMPENSATION --------------------------
+// Single scattering GGX loses the light that bounces between the microfacets more than once, so rough surfaces come
+// out too dark. The directional albedo E(mu) of the lobes and its cosine weighted average E_avg are integrated on
+// the CPU (EnergyLUT.h) and looked up here. x holds E and y E_avg, entries sit at mu and alpha
+// i / (ENERGY_LUT_SIZE - 1).
+// The dielectric table has one slice per eta, stacked along y.
+static const uint ENERGY_LUT_SIZE = 32u;
+static const uint ENERGY_LUT_ETA_SLICES = 16u;
+// Slices cover eta from 1 / ENERGY_LUT_MAX_ETA to ENERGY_LUT_MAX_ETA logarithmically, entering and leaving
+static const float ENERGY_LUT_MAX_ETA = 3.f;
+
+inline float EnergyLUTTexel(float x)
+{
+	return clamp(x, 0.f, 1.f) * float(ENERGY_LUT_SIZE - 1u);
+}
+
+inline float EnergyLUTSlice(float eta)
+{
+	float t = 0.5f + 0.5f * log(eta) / log(ENERGY_LUT_MAX_ETA);
+	return clamp(t, 0.f, 1.f) * float(ENERGY_LUT_ETA_SLICES - 1u);
+}
+
+// The eta a slice is integrated for
+inline float EnergyLUTSliceEta(uint slice)
+{
+	float t = float(slice) / float(ENERGY_LUT_ETA_SLICES - 1u);
+	return pow(ENERGY_LUT_MAX_ETA, 2.f * t - 1.f);
+}
+
+#ifdef SHADER_STRUCT
+// texel is in texels, the linear clamp sampler does the filtering
+inline float2 SampleEnergyLUT(uint rdhIndex, float2 texel, float2 size)
+{
+	Texture2D<float2> lut = ResourceDescriptorHeap[rdhIndex];
+	SamplerState linearClamp = SamplerDescriptorHeap[LINEAR_CLAMP];
+	return lut.SampleLevel(linearClamp, (texel + 0.5f) / size, 0.f);
+}
+#else
+// Set by BindEnergyLUTs(), without tables E is 1 and nothing gets compensated
+inline const float2* g_ReflectionEnergyLUT = nullptr;
+inline const float2* g_DielectricEnergyLUT = nullptr;
+
+inline float2 SampleEnergyLUT(const float2* lut, float2 texel, float2 size)
+{
+	if (lut == nullptr)
+		return float2(1.f, 1.f);
+
+	const int width = int(size.x);
+	const float2 position = clamp(texel, float2(0.f, 0.f), size - 1.f);
+	const int x0 = int(position.x);
+	const int y0 = int(position.y);
+	const int x1 = min(x0 + 1, width - 1);
+	const int y1 = min(y0 + 1, int(size.y) - 1);
+	const float tx = position.x - float(x0);
+	const float ty = position.y - float(y0);
+	const float2 top = lerp(lut[y0 * width + x0], lut[y0 * width + x1], tx);
+	const float2 bottom = lerp(lut[y1 * width + x0], lut[y1 * width + x1], tx);
+	return lerp(top, bottom, ty);
+}
+#endif
+
+inline float2 SampleReflectionEnergy(float mu, float alphaRoughness)
+{
+	float2 texel = float2(EnergyLUTTexel(mu), EnergyLUTTexel(alphaRoughness));
+	float2 size = float2(float(ENERGY_LUT_SIZE), float(ENERGY_LUT_SIZE));
+#ifdef SHADER_STRUCT
+	return SampleEnergyLUT(RDH_ENERGY_LUT, texel, size);
+#else
+	return SampleEnergyLUT(g_ReflectionEnergyLUT, texel, size);
+#endif
+}
+
+inline float2 SampleDielectricEnergy(float mu, float alphaRoughness, float eta)
+{
+	// Filtering across the border of two slices would mix different alphas, the slices are blended here instead
+	float slice = EnergyLUTSlice(eta);
+	float slice0 = floor(slice);
+	float slice1 = min(slice0 + 1.f, float(ENERGY_LUT_ETA_SLICES - 1u));
+	float alphaTexel = EnergyLUTTexel(alphaRoughness);
+	float2 texel0 = float2(EnergyLUTTexel(mu), slice0 * float(ENERGY_LUT_SIZE) + alphaTexel);
+	float2 texel1 = float2(texel0.x, slice1 * float(ENERGY_LUT_SIZE) + alphaTexel);
+	float2 size = float2(float(ENERGY_LUT_SIZE), float(ENERGY_LUT_SIZE * ENERGY_LUT_ETA_SLICES));
+#ifdef SHADER_STRUCT
+	float2 energy0 = SampleEnergyLUT(RDH_ENERGY_LUT_DIELECTRIC, texel0, size);
+	float2 energy1 = SampleEnergyLUT(RDH_ENERGY_LUT_DIELECTRIC, texel1, size);
+#else
+	float2 energy0 = SampleEnergyLUT(g_DielectricEnergyLUT, texel0, size);
+	float2 energy1 = SampleEnergyLUT(g_DielectricEnergyLUT, texel1, size);
+#endif
+	return lerp(energy0, energy1, slice - slice0);
+}
+
+// Multiple scattering lobe added to the GGX reflection, the energy single scattering misses comes back diffusely.
+// Fresnel is applied once per bounce, light that bounces more often is tinted more.
+// Christopher Kulla and Alejandro Conty. 2017. Revisiting Physically Based Shading at Imageworks. SIGGRAPH Course
+inline float3 MultiScatterGGX(float3 f0, float NdotV, float NdotL, float alphaRoughness)
+{
+	float2 energyV = SampleReflectionEnergy(NdotV, alphaRoughness);
+	float energyL = SampleReflectionEnergy(NdotL, alphaRoughness).x;
+	float energyAvg = energyV.y;
+	// Nothing is lost by smooth surfaces, or when no tables are bound
+	if (energyAvg >= 0.9999f)
+		return float3(0.f, 0.f, 0.f);
+
+	float fms = (1.f - energyV.x) * (1.f - energyL) / (BSDF_PI * (1.f - energyAvg));
+
+	// Hemispherical average of Schlick's Fresnel with f90 = 1
+	float3 fAvg = f0 * (20.f / 21.f) + float3(1.f / 21.f, 1.f / 21.f, 1.f / 21.f);
+	float3 one = float3(1.f, 1.f, 1.f);
+	return fms * fAvg * fAvg * energyAvg / (one - fAvg * (1.f - energyAvg));
+}
+
+// Dielectrics split the light single scattering misses between reflection and transmission like the single
+// scattering does, so both transmissive lobes are scaled by 1 / E(mu) instead of adding another lobe.
+inline float DielectricEnergyCompensation(float NdotV, float alphaRoughness, float eta)
+{
+	float energy = SampleDielectricEnergy(NdotV, alphaRoughness, eta).x;
+	return 1.f / max(energy, 0.05f);
+}
+
+// BSDF -----------------------------------------
+// The material is a mix of lobes. Each lobe is picked with the probability it is weighted with, both the returned
+// value and the pdf include that probability. Dividing one by the other gives the estimate of the picked lobe.
+
+inline float3 EvalDiffuseGltf(MaterialHitData mat, float3 V, float3 N, float3 L, INOUT(float) pdf)
+{
+	pdf = 0.f;
+	float NdotV = dot(N, V);
+	float NdotL = dot(N, L);
+
+	if (NdotL < 0.f || NdotV < 0.f)
+		return float3(0.f, 0.f, 0.f);
+
+	NdotL = clamp(NdotL, 0.001f, 1.f);
+
+	pdf = NdotL * BSDF_INV_PI;
+
+	// Metals have no diffuse lobe, this is part of the lobe weight
+	return BRDF_LambertianSimple(mat.m_BaseColor);
+}
+
+inline float3 BSDF_GGX(MaterialHitData mat, float3 V, float3 N, float3 H, float NdotL, float3 F, INOUT(float) pdf)
+{
+	pdf = 0.f;
+
+	if (NdotL < 0.f)
+		return float3(0.f, 0.f, 0.f);
+
+	float NdotV = dot(N, V);
+	float NdotH = clamp(dot(N, H), 0.f, 1.f);
+
+	NdotL = clamp(NdotL, 0.001f, 1.f);
+	NdotV = clamp(abs(NdotV), 0.001f, 1.f);
+
+	float G = V_GGX(NdotL, NdotV, mat.m_AlphaRoughness);
+	float D = D_GGX(NdotH, mat.m_AlphaRoughness);
+
+	pdf = GGXReflectionPdfVNDF(NdotV, NdotH, mat.m_AlphaRoughness);
+
+	return F * D * G;
+}
+
+// Probability of picking (and weight of) the reflective GGX lobe, metals and the specular weight of dielectrics
+inline float GetSpecularChance(MaterialHitData mat)
+{
+	return mat.m_Metallic + mat.m_SpecularWeight - mat.m_Metallic * mat.m_SpecularWeight;
+}
+
+inline float GetTransmissionChance(MaterialHitData mat)
+{
+	return (1.f - mat.m_Metallic) * mat.m_TransmissionFactor;
+}
+
+// specChance is the Fresnel reflectance for transmissive bounces, GetSpecularChance otherwise
+inline float3 EvalBSDF(MaterialHitData mat, float3 V, float3 N, float3 L, float3 H, bool specBounce, float specChance,
+					   bool transmissBounce, float transmissChance, INOUT(float) pdf)
+{
+	pdf = 0.f;
+	float3 brdf = float3(0.f, 0.f, 0.f);
+	float lobeChance = 0.f;
+	if (transmissBounce == true)
+	{
+		// The Fresnel weights of reflection and transmission are passed as F
+		if (specBounce == true)
+		{
+			// Reflection
+			float NdotL = dot(N, L);
+			float3 F = float3(specChance, specChance, specChance);
+			brdf = BSDF_GGX(mat, V, N, H, NdotL, F, pdf) * mat.m_BaseColor;
+			pdf *= specChance;
+		}
+		else
+		{
+			// Transmission
+			float NdotL = abs(dot(N, L));
+			float3 F = float3(1.f - specChance, 1.f - specChance, 1.f - specChance);
+			brdf = BSDF_GGX(mat, V, N, H, NdotL, F, pdf) * mat.m_BaseColor;
+			pdf *= (1.f - specChance);
+		}
+		brdf *= DielectricEnergyCompensation(abs(dot(N, V)), mat.m_AlphaRoughness, mat.m_Eta);
+		lobeChance = transmissChance;
+	}
+	else
+	{
+		if (specBounce == true)
+		{
+			float NdotL = dot(N, L);
+			float VdotH = clamp(dot(V, H), 0.f, 1.f);
+			float3 f90 = float3(1.f, 1.f, 1.f);
+			float3 F = F_Schlick(mat.m_F0, f90, VdotH);
+			brdf = BSDF_GGX(mat, V, N, H, NdotL, F, pdf);
+			if (pdf > 0.f)
+			{
+				float NdotV = clamp(abs(dot(N, V)), 0.001f, 1.f);
+				brdf += MultiScatterGGX(mat.m_F0, NdotV, clamp(NdotL, 0.001f, 1.f), mat.m_AlphaRoughness);
+			}
+			lobeChance = specChance * (1.f - transmissChance);
+		}
+		else
+		{
+			brdf = EvalDiffuseGltf(mat, V, N, L, pdf);
+			lobeChance = (1.f - specChance) * (1.f - transmissChance);
+		}
+	}
+
+	pdf *= lobeChance;
+	return brdf * lobeChance;
+}
+
+// Inspired by https://github.com/nvpro-samples/vk_raytrace/tree/master
+// N, T and B are the shading frame, V points away from the surface
+inline float3 PbrSample(MaterialHitData mat, float3 N, float3 T, float3 B, float3 V, INOUT(uint) isSpecular,
+						INOUT(bool) refracted, INOUT(float3) newRayDir, INOUT(float) pdf, INOUT(uint) seed)
+{
+	pdf = 0.f;
+	float3 H = float3(0.f, 0.f, 0.f);
+	float3 localV = float3(dot(V, T), dot(V, B), dot(V, N));
+	float specChance = GetSpecularChance(mat);
+	bool specBounce = false;
+	refracted = false;
+	// Transmission weight
+	float transChance = GetTransmissionChance(mat);
+	bool transBounce = rand(seed) < transChance;
+	// Transmission
+	if (transBounce == true)
+	{
+		isSpecular = 1;
+
+		H = GGXSamplingVNDF(localV, mat.m_AlphaRoughness, seed);
+		H = T * H.x + B * H.y + N * H.z;
+		newRayDir = normalize(reflect(-V, H));
+
+		float f0 = mat.m_F0.r;
+		// Anything less than 2% is physically impossible and is instead considered to be shadowing. Compare to
+		// "Real-Time-Rendering" 4th editon on page 325.
+		float f90 = clamp(f0 * 50.f, 0.f, 1.f);
+		float VdotH = abs(dot(V, H));
+		float F = F_Schlick(f0, f90, abs(dot(newRayDir, H)));
+		specChance = F;
+		float discriminat = mat.m_Eta * mat.m_Eta * (1.f - VdotH * VdotH); // (Total internal reflection)
+		// Reflection/Total internal reflection
+		if (discriminat > 1.f || rand(seed) < specChance)
+		{
+			specBounce = true;
+		}
+		else
+		{
+			refracted = true;
+			specBounce = false;
+			// Find the pure refractive ray
+			newRayDir = normalize(refract(-V, H, mat.m_Eta));
+			// Catch rays perpendicular to surface, and simply continue
+			if (isnan(newRayDir.x) || isnan(newRayDir.y) || isnan(newRayDir.z))
+			{
+				newRayDir = -V;
+			}
+		}
+	}
+	else if (rand(seed) < specChance)
+	{
+		specBounce = true;
+		H = GGXSamplingVNDF(localV, mat.m_AlphaRoughness, seed);
+		H = T * H.x + B * H.y + N * H.z;
+		newRayDir = reflect(-V, H);
+		isSpecular = 1;
+	}
+	else
+	{
+		// Diffuse
+		float3 L = CosineWeightedDiffuseReflection(seed);
+		L = T * L.x + B * L.y + N * L.z;
+		newRayDir = L;
+		isSpecular = 0;
+	}
+
+	// Evaluate a full BSDF
+	float3 brdf = EvalBSDF(mat, V, N, newRayDir, H, specBounce, specChance, transBounce, transChance, pdf);
+	return brdf;
+}
+
+inline float3 PbrDirectSample(MaterialHitData mat, float3 V, float3 N, float3 L, INOUT(float) pdf,
+							  INOUT(uint) seed)
+{
+	// Calculate the half vector
+	float3 H;
+	if (dot(N, L) < 0.f)
+		H = normalize(L * (1.f / mat.m_Eta) + V);
+	else
+		H = normalize(L + V);
+	if (dot(N, H) < 0.f)
+		H = -H;
+
+	pdf = 0.f;
+	float specChance = GetSpecularChance(mat);
+	bool specBounce = false;
+	float transChance = GetTransmissionChance(mat);
+	bool transBounce = rand(seed) < transChance;
+	if (transBounce == true)
+	{
+		float f0 = mat.m_F0.r;
+		// Anything less than 2% is physically impossible and is instead considered to be shadowing. Compare to
+		// "Real-Time-Rendering" 4th editon on page 325.
+		float f90 = clamp(f0 * 50.f, 0.f, 1.f);
+		float VdotH = abs(dot(V, H));
+		float F = F_Schlick(f0, f90, abs(dot(L, H)));
+		specChance = F;
+		float discriminat = mat.m_Eta * mat.m_Eta * (1.f - VdotH * VdotH); // (Total internal reflection)
+		// Reflection/Total internal reflection
+		if (discriminat > 1.f || rand(seed) < F)
+		{
+			specBounce = true;
+		}
+	}
+	else
+	{
+		specBounce = rand(seed) < specChance;
+	}
+	// Evaluate a full BSDF
+	return EvalBSDF(mat, V, N, L, H, specBounce, specChance, transBounce, transChance, pdf);
+}
+
+#ifndef SHADER_STRUCT
+} // namespace Ball::Bsdf
+#endif
+#undef INOUT
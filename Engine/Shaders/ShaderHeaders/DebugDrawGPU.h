@@ -0,0 +1,120 @@
+#pragma once
+
+#ifndef SHADER_STRUCT
+// Math Types
+#include <glm/glm.hpp>
+#include <cmath>
+typedef glm::mat4 float4x4;
+typedef glm::vec4 float4;
+typedef glm::vec3 float3;
+typedef uint32_t uint;
+#endif
+
+// Shapes of the debug draw stream. Lines are drawn with 2 vertices per instance, all other shapes with
+// DEBUG_SHAPE_VERTEX_COUNT vertices per instance, vertices past the end of a shape are degenerate.
+static const uint DEBUG_PRIMITIVE_LINE = 0; // m_Row0.xyz to m_Row1.xyz, not transformed
+static const uint DEBUG_PRIMITIVE_BOX = 1; // Cube from -1 to 1
+static const uint DEBUG_PRIMITIVE_SPHERE = 2; // Three circles with radius 1 around the axes
+static const uint DEBUG_PRIMITIVE_AXIS = 3; // Unit lines along x, y and z colored red, green and blue
+static const uint DEBUG_PRIMITIVE_PYRAMID = 4; // Apex at the origin, base corners at (+-1, +-1, 1)
+
+static const uint DEBUG_SPHERE_SEGMENTS = 16;
+static const uint DEBUG_SHAPE_VERTEX_COUNT = 3 * DEBUG_SPHERE_SEGMENTS * 2;
+
+// A line or an instanced shape, written by the CPU straight into the mapped upload buffer
+struct DebugPrimitiveGPU
+{
+	// Rows of the affine shape to world transform, the two end points for lines
+	float4 m_Row0;
+	float4 m_Row1;
+	float4 m_Row2;
+	uint m_Type;
+	uint m_Color; // RGBA8, red in the lowest byte
+	uint m_Padding0;
+	uint m_Padding1;
+};
+
+// Number of line list vertices a shape expands to
+inline uint GetDebugPrimitiveVertexCount(uint type)
+{
+	if (type == DEBUG_PRIMITIVE_LINE)
+		return 2;
+	if (type == DEBUG_PRIMITIVE_BOX)
+		return 12 * 2;
+	if (type == DEBUG_PRIMITIVE_SPHERE)
+		return DEBUG_SHAPE_VERTEX_COUNT;
+	if (type == DEBUG_PRIMITIVE_AXIS)
+		return 3 * 2;
+	if (type == DEBUG_PRIMITIVE_PYRAMID)
+		return 8 * 2;
+	return 0;
+}
+
+// Shape space position of a line list vertex, vertexId must be below GetDebugPrimitiveVertexCount
+inline float3 GetDebugShapeVertex(uint type, uint vertexId)
+{
+	const uint edge = vertexId / 2;
+	const uint end = vertexId % 2;
+
+	if (type == DEBUG_PRIMITIVE_BOX)
+	{
+		// 4 edges along each axis, the other two axes pick a corner
+		const uint axis = edge / 4;
+		const float along = end == 0 ? -1.f : 1.f;
+		const float u = (edge & 1) != 0 ? 1.f : -1.f;
+		const float v = (edge & 2) != 0 ? 1.f : -1.f;
+		if (axis == 0)
+			return float3(along, u, v);
+		if (axis == 1)
+			return float3(u, along, v);
+		return float3(u, v, along);
+	}
+
+	if (type == DEBUG_PRIMITIVE_SPHERE)
+	{
+		const uint circle = edge / DEBUG_SPHERE_SEGMENTS;
+		const uint segment = edge % DEBUG_SPHERE_SEGMENTS + end;
+		const float angle = float(segment) * (6.28318530718f / float(DEBUG_SPHERE_SEGMENTS));
+		const float c = cos(angle);
+		const float s = sin(angle);
+		if (circle == 0)
+			return float3(c, s, 0.f);
+		if (circle == 1)
+			return float3(0.f, c, s);
+		return float3(s, 0.f, c);
+	}
+
+	if (type == DEBUG_PRIMITIVE_AXIS)
+	{
+		const float length = end == 0 ? 0.f : 1.f;
+		return float3(edge == 0 ? length : 0.f, edge == 1 ? length : 0.f, edge == 2 ? length : 0.f);
+	}
+
+	if (type == DEBUG_PRIMITIVE_PYRAMID)
+	{
+		// Base corners go around the square, the first 4 edges connect them to the apex
+		const uint corner = edge < 4 ? edge : (end == 0 ? edge - 4 : (edge - 3) % 4);
+		const float x = (corner == 1 || corner == 2) ? 1.f : -1.f;
+		const float y = corner >= 2 ? 1.f : -1.f;
+		if (edge < 4 && end == 0)
+			return float3(0.f, 0.f, 0.f);
+		return float3(x, y, 1.f);
+	}
+
+	return float3(0.f, 0.f, 0.f);
+}
+
+// World space position of a line list vertex of the primitive
+inline float3 GetDebugPrimitiveVertex(DebugPrimitiveGPU primitive, uint vertexId)
+{
+	if (primitive.m_Type == DEBUG_PRIMITIVE_LINE)
+	{
+		const float4 point = vertexId == 0 ? primitive.m_Row0 : primitive.m_Row1;
+		return float3(point.x, point.y, point.z);
+	}
+
+	const float3 p = GetDebugShapeVertex(primitive.m_Type, vertexId);
+	return float3(primitive.m_Row0.x * p.x + primitive.m_Row0.y * p.y + primitive.m_Row0.z * p.z + primitive.m_Row0.w,
+				  primitive.m_Row1.x * p.x + primitive.m_Row1.y * p.y + primitive.m_Row1.z * p.z + primitive.m_Row1.w,
+				  primitive.m_Row2.x * p.x + primitive.m_Row2.y * p.y + primitive.m_Row2.z * p.z + primitive.m_Row2.w);
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+// Importance sampling of the HDRI. The distribution is built on the CPU (EnvironmentMap.h) when the skybox is
+// loaded, the shaders sample it for next event estimation and weigh the sky hit by escaping rays against it.
+// Directions map to the equirectangular UVs the same way SampleSky in Shade.hlsl looks them up.
+#include "WavefrontStructsGPU.h"
+
+#ifdef SHADER_STRUCT
+#include "GpuModelStruct.h"
+#define INOUT(type) inout type
+#else
+#include <cmath>
+#define INOUT(type) type&
+#endif
+
+// One column (or row) of a Walker alias table. A sample that lands in this slot keeps it with m_Probability and
+// moves to m_Alias otherwise.
+struct EnvironmentAliasEntry
+{
+	float m_Probability;
+	uint m_Alias;
+	// Density over the [0, 1]^2 UVs of the texel, for the marginal entries the density of the row over v
+	float m_Pdf;
+	float m_Padding;
+};
+
+struct EnvironmentSettings
+{
+	uint m_Width; // Resolution of the distribution, can be lower than the one of the HDRI
+	uint m_Height;
+	uint m_Enabled;
+};
+
+#ifndef SHADER_STRUCT
+namespace Ball::EnvironmentMap
+{
+	using uint2 = glm::uvec2;
+
+	using glm::clamp;
+	using glm::max;
+	using glm::min;
+	using std::asin;
+	using std::atan2;
+	using std::cos;
+	using std::sin;
+	using std::sqrt;
+#endif
+
+static const float ENVIRONMENT_PI = 3.141592653589f;
+
+// Rows of the distribution, the marginal table comes first: [0, height) holds the rows, every row of width entries
+// follows after it
+#ifdef SHADER_STRUCT
+inline EnvironmentAliasEntry LoadEnvironmentEntry(uint index)
+{
+	StructuredBuffer<EnvironmentAliasEntry> distribution = ResourceDescriptorHeap[RDH_ENVIRONMENT_DISTRIBUTION];
+	return distribution[index];
+}
+#else
+// Set by BindEnvironmentDistribution()
+inline const EnvironmentAliasEntry* g_EnvironmentDistribution = nullptr;
+
+inline EnvironmentAliasEntry LoadEnvironmentEntry(uint index)
+{
+	return g_EnvironmentDistribution[index];
+}
+#endif
+
+inline float2 DirectionToEnvironmentUV(float3 direction)
+{
+	float u = 0.5f + atan2(direction.z, direction.x) / (2.f * ENVIRONMENT_PI);
+	float v = 0.5f - asin(clamp(direction.y, -1.f, 1.f)) / ENVIRONMENT_PI;
+	return float2(u, v);
+}
+
+inline float3 EnvironmentUVToDirection(float2 uv)
+{
+	float phi = (uv.x - 0.5f) * 2.f * ENVIRONMENT_PI;
+	float theta = uv.y * ENVIRONMENT_PI;
+	float sinTheta = sin(theta);
+	return float3(sinTheta * cos(phi), cos(theta), sinTheta * sin(phi));
+}
+
+// Solid angle density of a direction from the UV density of its texel, dw = 2 * pi^2 * sin(theta) du dv
+inline float EnvironmentSolidAnglePdf(float uvPdf, float3 direction)
+{
+	float sinTheta = sqrt(max(1.f - direction.y * direction.y, 0.f));
+	return sinTheta > 0.f ? uvPdf / (2.f * ENVIRONMENT_PI * ENVIRONMENT_PI * sinTheta) : 0.f;
+}
+
+// u picks the slot, what is left of it decides between the slot and its alias
+inline uint SampleEnvironmentAlias(uint offset, uint count, float u)
+{
+	float scaled = u * float(count);
+	uint index = min(uint(scaled), count - 1u);
+	EnvironmentAliasEntry entry = LoadEnvironmentEntry(offset + index);
+	return scaled - float(index) < entry.m_Probability ? index : entry.m_Alias;
+}
+
+inline uint2 EnvironmentTexel(uint2 size, float2 uv)
+{
+	uint x = min(uint(max(uv.x, 0.f) * float(size.x)), size.x - 1u);
+	uint y = min(uint(max(uv.y, 0.f) * float(size.y)), size.y - 1u);
+	return uint2(x, y);
+}
+
+// Picks a texel proportional to luminance * sin(theta) and a uniform point in it. r holds four uniform numbers,
+// the direction is in the space of the HDRI (before the sky rotation) and pdf is per solid angle.
+inline float3 SampleEnvironment(uint2 size, float4 r, INOUT(float) pdf)
+{
+	uint y = SampleEnvironmentAlias(0u, size.y, r.x);
+	uint x = SampleEnvironmentAlias(size.y + y * size.x, size.x, r.y);
+	float2 uv = (float2(float(x), float(y)) + float2(r.z, r.w)) / float2(float(size.x), float(size.y));
+	float3 direction = EnvironmentUVToDirection(uv);
+	pdf = EnvironmentSolidAnglePdf(LoadEnvironmentEntry(size.y + y * size.x + x).m_Pdf, direction);
+	return direction;
+}
+
+// Density SampleEnvironment generates direction with
+inline float EnvironmentPdf(uint2 size, float3 direction)
+{
+	uint2 texel = EnvironmentTexel(size, DirectionToEnvironmentUV(direction));
+	float uvPdf = LoadEnvironmentEntry(size.y + texel.y * size.x + texel.x).m_Pdf;
+	return EnvironmentSolidAnglePdf(uvPdf, direction);
+}
+
+// Balance heuristic between the two ways a direction towards the sky is found
+inline float EnvironmentMISWeight(float pdf, float otherPdf)
+{
+	return pdf + otherPdf > 0.f ? pdf / (pdf + otherPdf) : 0.f;
+}
+
+#ifndef SHADER_STRUCT
+} // namespace Ball::EnvironmentMap
+#endif
+#undef INOUT
@@ -47,12 +47,18 @@ RENDER_MODES
 #define RDH_OUTPUT 5
 // 12 RDH_BLOOM_Textures stored from 6 to 17
 #define NUM_BLOOM 12
+// Bluenoise, every slice has its own slot so frames in flight never share a descriptor that gets rewritten
+#define NUM_BLUENOISE 32
 #define RDH_BLUENOISE NUM_BLOOM + RDH_OUTPUT + 1
+// Energy compensation tables of the BSDF, see BsdfGPU.h
+#define RDH_ENERGY_LUT RDH_BLUENOISE + NUM_BLUENOISE
+#define RDH_ENERGY_LUT_DIELECTRIC RDH_ENERGY_LUT + 1
+// Alias tables of the skybox, see EnvironmentMapGPU.h
+#define RDH_ENVIRONMENT_DISTRIBUTION RDH_ENERGY_LUT + 2
+// Sobol matrices and the blue noise ranks of the pixels, see SamplingGPU.h
+#define RDH_SAMPLING_TABLES RDH_ENERGY_LUT + 3
 // HEADER_SIZE determined at runtime
-#define RDH_HEADER_SIZE RDH_BLUENOISE + 1
-
-// Bluenoise
-#define NUM_BLUENOISE 32
+#define RDH_HEADER_SIZE RDH_SAMPLING_TABLES + 1
 
 // Macros for the SDH Headers
 #define SDH_SKYBOX 9
@@ -83,7 +89,8 @@ struct PrimitiveGPU
 	int m_TangentIndex;
 	int m_NormalIndex;
 	int m_ColorIndex;
-	int padding;
+	int m_TriangleLODIndex; // Buffer with the ray cone data of every triangle, see RayConeGPU.h
+	int m_OpacityMicromapIndex; // Alpha tested primitives only, see OpacityMicromapGPU.h
 
 	// Note: This gets set during the BLAS creation step from
 	// multiplying all Nodes to get into world space from vertex space
@@ -137,9 +144,12 @@ struct MaterialGPU
 	float3 m_AttenuationColor;
 	float m_AttenuationDistance;
 	// 144
-	float m_TextureDim;
+	// Set in the shaders, the mip level of the hit before the size of the texture is added, see RayConeGPU.h
 	float m_MaterialLOD;
-	float2 m_Padding;
+	// glTF alphaMode MASK, the hit is only there where alpha >= m_AlphaCutoff
+	int m_AlphaMask;
+	float m_AlphaCutoff;
+	float m_Padding;
 	// 160
 };
 
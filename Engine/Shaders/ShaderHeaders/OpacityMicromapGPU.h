@@ -0,0 +1,122 @@
+#pragma once
+
+// Opacity micromaps for alpha tested (glTF MASK) geometry, done in software the way DXR 1.2 does them in hardware.
+// Every alpha tested triangle is split into 4^level micro-triangles, the CPU (OpacityMicromap.h) bakes whether each
+// of them is fully opaque, fully transparent or unknown from the alpha texture. Any hit on such a triangle looks its
+// micro-triangle up first, only unknown ones read the texture (AlphaTest.hlsl).
+#include "GpuModelStruct.h"
+
+#ifdef SHADER_STRUCT
+#ifndef INOUT
+#define INOUT(type) inout type
+#endif
+// Heap index of the micromap buffer of a primitive
+typedef uint OpacityMicromapBuffer;
+#else
+#include <cstdint>
+#ifndef INOUT
+#define INOUT(type) type&
+#endif
+typedef uint32_t uint;
+
+namespace Ball::OpacityMicromap
+{
+	typedef const uint* OpacityMicromapBuffer;
+	using glm::max;
+	using glm::min;
+#endif
+
+// 2 bits per micro-triangle
+static const uint OPACITY_TRANSPARENT = 0u;
+static const uint OPACITY_OPAQUE = 1u;
+static const uint OPACITY_UNKNOWN = 2u;
+static const uint OPACITY_STATES_PER_WORD = 16u;
+
+// 4096 micro-triangles, 1 KB per triangle
+static const uint OPACITY_MAX_LEVEL = 6u;
+
+// The buffer of a primitive holds one descriptor per triangle, then the states of all subdivided triangles. Bits 0-1
+// of a descriptor are the state of the whole triangle when it isn't subdivided, bits 2-5 the level, bits 6-31 where
+// its states start, counted in states from the start of the buffer
+static const uint OPACITY_LEVEL_SHIFT = 2u;
+static const uint OPACITY_OFFSET_SHIFT = 6u;
+
+inline uint OpacityDescriptor(uint state, uint level, uint stateOffset)
+{
+	return state | (level << OPACITY_LEVEL_SHIFT) | (stateOffset << OPACITY_OFFSET_SHIFT);
+}
+
+inline uint MicroTriangleCount(uint level)
+{
+	return 1u << (2u * level);
+}
+
+// The micro-triangles of a level lie in n = 2^level rows along the v barycentric. Row j starts at j * (2n - j) and
+// holds 2 (n - j) - 1 triangles, the upright ones at even and the upside down ones at odd positions
+inline uint MicroTriangleIndex(float2 barycentrics, uint level)
+{
+	uint n = 1u << level;
+	float2 grid = barycentrics * float(n);
+	uint i = min(uint(max(grid.x, 0.f)), n - 1u);
+	uint j = min(uint(max(grid.y, 0.f)), n - 1u - i);
+	float2 cell = grid - float2(float(i), float(j));
+	uint upsideDown = (i + j < n - 1u && cell.x + cell.y > 1.f) ? 1u : 0u;
+	return j * (2u * n - j) + 2u * i + upsideDown;
+}
+
+// Corners of a micro-triangle as barycentrics, the inverse of MicroTriangleIndex
+inline void MicroTriangleBarycentrics(uint index, uint level, INOUT(float2) b0, INOUT(float2) b1, INOUT(float2) b2)
+{
+	uint n = 1u << level;
+	uint j = 0u;
+	while (index >= 2u * (n - j) - 1u)
+	{
+		index -= 2u * (n - j) - 1u;
+		j++;
+	}
+	uint i = index / 2u;
+	float size = 1.f / float(n);
+	float2 corner = float2(float(i), float(j)) * size;
+	if ((index & 1u) == 0u)
+	{
+		b0 = corner;
+		b1 = corner + float2(size, 0.f);
+		b2 = corner + float2(0.f, size);
+	}
+	else
+	{
+		b0 = corner + float2(size, size);
+		b1 = corner + float2(0.f, size);
+		b2 = corner + float2(size, 0.f);
+	}
+}
+
+#ifdef SHADER_STRUCT
+inline uint LoadOpacityWord(OpacityMicromapBuffer buffer, uint index)
+{
+	StructuredBuffer<uint> words = ResourceDescriptorHeap[buffer];
+	return words[index];
+}
+#else
+inline uint LoadOpacityWord(OpacityMicromapBuffer buffer, uint index)
+{
+	return buffer[index];
+}
+#endif
+
+// State of the micro-triangle a hit lands on, two loads at most
+inline uint OpacityState(OpacityMicromapBuffer buffer, uint triangle, float2 barycentrics)
+{
+	uint descriptor = LoadOpacityWord(buffer, triangle);
+	uint level = (descriptor >> OPACITY_LEVEL_SHIFT) & 0xfu;
+	if (level == 0u)
+		return descriptor & 0x3u;
+
+	uint state = (descriptor >> OPACITY_OFFSET_SHIFT) + MicroTriangleIndex(barycentrics, level);
+	uint word = LoadOpacityWord(buffer, state / OPACITY_STATES_PER_WORD);
+	return (word >> (2u * (state % OPACITY_STATES_PER_WORD))) & 0x3u;
+}
+
+#ifndef SHADER_STRUCT
+} // namespace Ball::OpacityMicromap
+#endif
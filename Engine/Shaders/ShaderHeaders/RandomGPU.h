@@ -0,0 +1,58 @@
+#pragma once
+
+// Seeding and white noise of the shaders, shared with the CPU so reference code draws the same numbers
+#ifndef SHADER_STRUCT
+// Math Types
+#include <glm/glm.hpp>
+typedef glm::vec3 float3;
+typedef uint32_t uint;
+#endif
+
+#ifdef SHADER_STRUCT
+#define INOUT(type) inout type
+#else
+#define INOUT(type) type&
+
+namespace Ball::ShaderRandom
+{
+#endif
+
+inline uint CombineIntoSeed(uint pixelIdx, uint frameIdx, uint wavefrontLoopIdx)
+{
+	uint combinedValue = (frameIdx * 55001u) + (pixelIdx * 78713u) + (wavefrontLoopIdx * 26927u);
+	return combinedValue;
+}
+
+inline uint GetWangHashSeed(uint seed)
+{
+	seed = (seed ^ 61u) ^ (seed >> 16);
+	seed *= 9u;
+	seed = seed ^ (seed >> 4);
+	seed *= 0x27d4eb2du;
+	seed = seed ^ (seed >> 15);
+	return seed;
+}
+
+// inout allows to modify the input value, so we get different rand every time
+inline float rand(INOUT(uint) seed)
+{
+	// White Noise
+	seed ^= (seed << 13);
+	seed ^= (seed >> 17);
+	seed ^= (seed << 5);
+	return float(seed) / 4294967296.0f; // float [0, 1] ( divided on maximum 32-bit unsigned integer)
+}
+
+inline float3 randf3(INOUT(uint) seed)
+{
+	// Separate statements, C++ doesn't define the order arguments are evaluated in
+	float x = rand(seed);
+	float y = rand(seed);
+	float z = rand(seed);
+	return float3(x, y, z);
+}
+
+#ifndef SHADER_STRUCT
+} // namespace Ball::ShaderRandom
+#endif
+#undef INOUT
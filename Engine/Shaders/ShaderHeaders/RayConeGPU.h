@@ -0,0 +1,113 @@
+#pragma once
+
+// Texture level of detail with ray cones, Ray Tracing Gems chapter 20 and Improved Shader and Texture Level of Detail
+// Using Ray Cones, Akenine-Moller et al. 2021. Every ray carries the width of its cone and how fast it spreads. The
+// part of the mip level that only depends on a triangle is baked per triangle on the CPU (Model.cpp), the shading
+// adds the cone footprint at the hit and the size of every texture it reads. RayConeTests.cpp checks the math.
+#include "WavefrontStructsGPU.h"
+
+#ifdef SHADER_STRUCT
+#include "GpuModelStruct.h"
+#else
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+
+namespace Ball::RayCone
+{
+	using glm::abs;
+	using glm::clamp;
+	using glm::dot;
+	using glm::log2;
+	using glm::max;
+#endif
+
+// Bounds of the baked per triangle constant, also what degenerate triangles get
+static const float TRIANGLE_LOD_MIN = -32.f;
+static const float TRIANGLE_LOD_MAX = 32.f;
+// Curvatures are baked as halfs
+static const float TRIANGLE_CURVATURE_MAX = 60000.f;
+// Keeps cones of focusing mirrors from flipping inside out
+static const float RAY_CONE_MAX_SPREAD = 1.5707963f;
+// Spread a diffuse bounce adds, about the angle of the cosine lobe that holds most of its energy
+static const float RAY_CONE_DIFFUSE_SPREAD = 1.f;
+
+// 0.5 * log2(uv area / area), the doubled areas work as well as they cancel out
+inline float TriangleLODConstant(float uvAreaDouble, float areaDouble)
+{
+	if (uvAreaDouble <= 0.f || areaDouble <= 0.f)
+		return TRIANGLE_LOD_MIN;
+	return clamp(0.5f * log2(uvAreaDouble / areaDouble), TRIANGLE_LOD_MIN, TRIANGLE_LOD_MAX);
+}
+
+// Mean curvature from the vertex normals, positive when the normals diverge (convex). Every edge gives
+// dot(n1 - n0, p1 - p0) / |p1 - p0|^2, which is 1 / radius on a sphere
+inline float EdgeCurvature(float3 p0, float3 p1, float3 n0, float3 n1)
+{
+	float3 edge = p1 - p0;
+	float lengthSq = dot(edge, edge);
+	return lengthSq > 0.f ? dot(n1 - n0, edge) / lengthSq : 0.f;
+}
+
+inline float TriangleCurvature(float3 p0, float3 p1, float3 p2, float3 n0, float3 n1, float3 n2)
+{
+	float curvature = EdgeCurvature(p0, p1, n0, n1) + EdgeCurvature(p1, p2, n1, n2) + EdgeCurvature(p2, p0, n2, n0);
+	return clamp(curvature / 3.f, -TRIANGLE_CURVATURE_MAX, TRIANGLE_CURVATURE_MAX);
+}
+
+// The baked values are in model space, an instance that scales areas by s^2 moves the constant by -log2(s).
+// log2(s) = log2(|det|) / 3 of the upper 3x3 of the transform, exact for uniform scales
+inline float TransformScaleLog2(float absDeterminant)
+{
+	return absDeterminant > 0.f ? log2(absDeterminant) / 3.f : 0.f;
+}
+
+// Width of the cone at the hit
+inline float PropagateConeWidth(float width, float spread, float hitT)
+{
+	return width + spread * hitT;
+}
+
+// Part of the mip level shared by all the textures of the hit: the triangle, the footprint of the cone and how
+// much the footprint stretches on surfaces seen at grazing angles
+inline float ConeMaterialLOD(float lodConstant, float coneWidth, float cosTheta, float bias)
+{
+	float footprint = log2(max(abs(coneWidth), 1e-8f));
+	return lodConstant + footprint - log2(max(abs(cosTheta), 1e-4f)) + bias;
+}
+
+// Mip of one texture, the texel area of the texture turns the uv footprint into texels
+inline float TextureMipLevel(float materialLOD, float textureWidth, float textureHeight)
+{
+	return max(materialLOD + 0.5f * log2(textureWidth * textureHeight), 0.f);
+}
+
+// Spread after a bounce. The normal turns by curvature * footprint over the footprint of the cone, width / cosTheta
+// long, and a reflection turns twice as much as the normal. Convex mirrors widen the cone, concave ones focus it.
+// lobeSpread widens the cone of glossy and diffuse bounces.
+inline float BounceConeSpread(float spread, float coneWidth, float curvature, float cosTheta, float lobeSpread)
+{
+	float surfaceSpread = 2.f * curvature * abs(coneWidth) / max(abs(cosTheta), 1e-4f);
+	return clamp(spread + surfaceSpread + lobeSpread, -RAY_CONE_MAX_SPREAD, RAY_CONE_MAX_SPREAD);
+}
+
+// Per triangle data of a primitive, see Model::CreateTriangleLODBuffers. The LOD constant is in the low half
+#ifdef SHADER_STRUCT
+inline float2 UnpackTriangleLOD(uint packed)
+{
+	return float2(f16tof32(packed & 0xffffu), f16tof32(packed >> 16));
+}
+#else
+inline uint PackTriangleLOD(float lodConstant, float curvature)
+{
+	return glm::packHalf2x16(float2(lodConstant, curvature));
+}
+
+inline float2 UnpackTriangleLOD(uint packed)
+{
+	return glm::unpackHalf2x16(packed);
+}
+#endif
+
+#ifndef SHADER_STRUCT
+} // namespace Ball::RayCone
+#endif
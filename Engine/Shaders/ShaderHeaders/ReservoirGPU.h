@@ -0,0 +1,155 @@
+#pragma once
+
+// Reservoir operations of ReSTIR, included by the shaders through ReSTIR.hlsl and by the CPU reference
+// (ReSTIRReference.h) that measures the bias and variance of the ways reservoirs are combined.
+// Sources:
+// https://interplayoflight.wordpress.com/2023/12/17/a-gentler-introduction-to-restir/
+// and "A Gentle Introduction to ReSTIR"
+#include "RandomGPU.h"
+#include "WavefrontStructsGPU.h"
+
+#ifdef SHADER_STRUCT
+#define INOUT(type) inout type
+#else
+#define INOUT(type) type&
+
+namespace Ball::ReSTIR
+{
+	using ShaderRandom::rand;
+
+	inline float rcp(float x) { return 1.f / x; }
+#endif
+
+static const uint RESERVOIR_NO_LIGHT = 4294967295u;
+
+// Function for Updating a ReSTIR Light Reservoir
+inline bool UpdateReservoir(INOUT(Reservoir) reservoir, uint lightID, float pHat, float pdf, float c,
+							INOUT(uint) seed)
+{
+	float weight = pHat / pdf;
+	reservoir.m_WSum += weight;
+	reservoir.m_EvalLights += c;
+
+	if (rand(seed) < weight / (reservoir.m_WSum + 0.00001f))
+	{
+		reservoir.m_PHat = pHat;
+		reservoir.m_PickedLightIdx = lightID;
+		return true;
+	}
+
+	return false;
+}
+
+inline void CalculateReservoirWeight(INOUT(Reservoir) reservoir)
+{
+	if (reservoir.m_PHat >= 0.0001f) // NaN Protect
+	{
+		reservoir.m_Weight = rcp(reservoir.m_PHat) * (rcp(reservoir.m_EvalLights) * reservoir.m_WSum);
+	}
+	else
+	{
+		reservoir.m_Weight = 0.f;
+	}
+}
+
+inline bool isReservoirValid(Reservoir reservoir)
+{
+	const bool defaultReservoir = reservoir.m_PickedLightIdx == RESERVOIR_NO_LIGHT; // true if no light was picked
+	const bool validWeight = reservoir.m_Weight > 0.f; // true if weight is position
+	return validWeight && !defaultReservoir;
+}
+
+inline Reservoir InitEmptyReservoir()
+{
+	Reservoir reservoir;
+	reservoir.m_PickedLightIdx = RESERVOIR_NO_LIGHT; // max val, to signify not picked light
+	reservoir.m_Weight = 0.f;
+	reservoir.m_WSum = 0.f;
+	reservoir.m_EvalLights = 0.f;
+	reservoir.m_PHat = 0.f;
+	reservoir.padding = float3(0.f, 0.f, 0.f);
+	return reservoir;
+}
+
+// Biased: the target of each sample stays the one of the pixel it came from, and the samples are weighted by
+// 1 / M. ToDo Make sure to calculate p_hat after calling this
+inline Reservoir CombineReservoirs(Reservoir r1, Reservoir r2, INOUT(uint) seed)
+{
+	Reservoir r = InitEmptyReservoir();
+	UpdateReservoir(r, r1.m_PickedLightIdx, r1.m_PHat, rcp(r1.m_Weight * r1.m_EvalLights), r1.m_EvalLights, seed);
+	UpdateReservoir(r, r2.m_PickedLightIdx, r2.m_PHat, rcp(r2.m_Weight * r2.m_EvalLights), r2.m_EvalLights, seed);
+
+	CalculateReservoirWeight(r);
+	return r;
+}
+
+// UNBIASED REUSE -------------------------------
+// Reservoirs from other pixels or frames are streamed into the receiving reservoir with a MIS weight instead of
+// 1 / M. pHat is the target of the receiving pixel evaluated for the sample, contributionWeight the m_Weight of the
+// reservoir the sample came from. The reuse stays unbiased as long as the MIS weights of every sample sum up to one
+// over all the reservoirs that could have produced it.
+inline bool UpdateReservoirMIS(INOUT(Reservoir) reservoir, uint lightID, float pHat, float contributionWeight,
+							   float misWeight, float M, INOUT(uint) seed)
+{
+	float weight = misWeight * pHat * contributionWeight;
+	reservoir.m_WSum += weight;
+	reservoir.m_EvalLights += M;
+
+	if (weight > 0.f && rand(seed) < weight / reservoir.m_WSum)
+	{
+		reservoir.m_PHat = pHat;
+		reservoir.m_PickedLightIdx = lightID;
+		return true;
+	}
+	return false;
+}
+
+// The MIS weights already normalize m_WSum, there is no division by M
+inline void CalculateReservoirWeightMIS(INOUT(Reservoir) reservoir)
+{
+	if (reservoir.m_PHat >= 0.0001f)
+		reservoir.m_Weight = reservoir.m_WSum / reservoir.m_PHat;
+	else
+		reservoir.m_Weight = 0.f;
+}
+
+// Generalized balance heuristic, O(N^2) target evaluations for N reservoirs. confidencePHatSum is the sum of
+// M * pHat over all reservoirs, every pHat evaluated for the same sample at the pixel of that reservoir.
+inline float GeneralizedBalanceWeight(float M, float pHat, float confidencePHatSum)
+{
+	if (confidencePHatSum <= 0.f)
+		return 0.f;
+	return M * pHat / confidencePHatSum;
+}
+
+// Pairwise MIS, O(N) target evaluations. Every neighbour is weighted against the canonical (receiving) reservoir
+// only, like the balance heuristic between two techniques where the canonical one has M / numNeighbours of its
+// confidence in every pair. A neighbour with a poor target can't take weight away from the other neighbours.
+
+// Weight of a sample from a neighbour, both pHats evaluated for that sample
+inline float PairwiseNeighbourWeight(float neighbourM, float neighbourPHat, float canonicalM, float canonicalPHat,
+									 float numNeighbours)
+{
+	float neighbour = neighbourM * neighbourPHat;
+	float denominator = neighbour + canonicalM / numNeighbours * canonicalPHat;
+	if (denominator <= 0.f)
+		return 0.f;
+	return neighbour / (denominator * numNeighbours);
+}
+
+// Part of the weight of the canonical sample for one neighbour, both pHats evaluated for the canonical sample. Sum
+// it over all neighbours.
+inline float PairwiseCanonicalWeight(float neighbourM, float neighbourPHat, float canonicalM, float canonicalPHat,
+									 float numNeighbours)
+{
+	float canonical = canonicalM / numNeighbours * canonicalPHat;
+	float denominator = neighbourM * neighbourPHat + canonical;
+	if (denominator <= 0.f)
+		return 0.f;
+	return canonical / (denominator * numNeighbours);
+}
+
+#ifndef SHADER_STRUCT
+} // namespace Ball::ReSTIR
+#endif
+#undef INOUT
@@ -0,0 +1,159 @@
+#pragma once
+
+// Low discrepancy samples for the wavefront passes. Every pixel draws from the same Owen scrambled Sobol sequence,
+// indexed by the frame, and shifts it on the torus by its own point of a rank-1 lattice. The lattice point of a pixel
+// is picked by the rank of the pixel in a blue noise mask, so neighbouring pixels get shifts far apart. The tables
+// are built on the CPU (SamplingTables.h).
+#ifdef SHADER_STRUCT
+#include "GpuModelStruct.h"
+#else
+#include <cstdint>
+typedef uint32_t uint;
+
+namespace Ball::Sampling
+{
+#endif
+
+// Sobol dimensions with generator matrices, higher dimensions reuse them with another scramble and index shuffle
+static const uint SOBOL_DIMENSIONS = 4u;
+static const uint SOBOL_BITS = 32u;
+
+// Side of the blue noise masks, the lattice has one point per texel of the mask
+static const uint BLUE_NOISE_SIZE = 64u;
+static const uint LATTICE_POINTS = BLUE_NOISE_SIZE * BLUE_NOISE_SIZE;
+// Korobov generator, the 2D projections of (d, d + 1), (d, d + 2) and (d, d + 3) are all close to hexagonal
+static const uint LATTICE_GENERATOR = 1701u;
+
+// Layout of the tables buffer
+static const uint SAMPLING_SOBOL_OFFSET = 0u;
+static const uint SAMPLING_RANK_OFFSET = SOBOL_DIMENSIONS * SOBOL_BITS;
+static const uint SAMPLING_TABLES_SIZE = SAMPLING_RANK_OFFSET + LATTICE_POINTS;
+
+// Same for every pixel, only the lattice shift tells pixels apart
+static const uint SAMPLING_SEED = 0x5851f42du;
+
+// Dimensions of a path. Generate draws the camera dimensions, every wavefront loop has its own block after them,
+// which is the same (m_FrameIdx, m_WavefronLoopIdx) indexing ShadeSeedData gives CombineIntoSeed. Every group of
+// SOBOL_DIMENSIONS shares one index shuffle, a sample with more than one dimension has to stay inside its group.
+static const uint SAMPLE_CAMERA_JITTER = 0u; // 2D
+static const uint SAMPLE_CAMERA_DIMENSIONS = 4u;
+static const uint SAMPLE_LIGHT = 0u; // 2D, point on the picked light
+static const uint SAMPLE_RUSSIAN_ROULETTE = 2u; // 1D
+static const uint SAMPLE_ENVIRONMENT = 4u; // 4D, see SampleEnvironment
+static const uint SAMPLE_BOUNCE_DIMENSIONS = 8u;
+
+#ifdef SHADER_STRUCT
+inline uint LoadSamplingTable(uint index)
+{
+	StructuredBuffer<uint> tables = ResourceDescriptorHeap[RDH_SAMPLING_TABLES];
+	return tables[index];
+}
+
+inline uint ReverseBits(uint x)
+{
+	return reversebits(x);
+}
+#else
+// Set by BindSamplingTables()
+inline const uint* g_SamplingTables = nullptr;
+
+inline uint LoadSamplingTable(uint index)
+{
+	return g_SamplingTables[index];
+}
+
+inline uint ReverseBits(uint x)
+{
+	x = (x << 16) | (x >> 16);
+	x = ((x & 0x00ff00ffu) << 8) | ((x & 0xff00ff00u) >> 8);
+	x = ((x & 0x0f0f0f0fu) << 4) | ((x & 0xf0f0f0f0u) >> 4);
+	x = ((x & 0x33333333u) << 2) | ((x & 0xccccccccu) >> 2);
+	x = ((x & 0x55555555u) << 1) | ((x & 0xaaaaaaaau) >> 1);
+	return x;
+}
+#endif
+
+inline uint SamplingDimension(uint wavefrontLoopIdx, uint bounceDimension)
+{
+	return SAMPLE_CAMERA_DIMENSIONS + wavefrontLoopIdx * SAMPLE_BOUNCE_DIMENSIONS + bounceDimension;
+}
+
+inline uint HashCombine(uint seed, uint value)
+{
+	return seed ^ (value + (seed << 6) + (seed >> 2) + 0x9e3779b9u);
+}
+
+// Every bit only depends on itself and the bits below it, Practical Hash-based Owen Scrambling, Burley 2020
+inline uint LaineKarrasPermutation(uint x, uint seed)
+{
+	x += seed;
+	x ^= x * 0x6c50b47cu;
+	x ^= x * 0xb82f1e52u;
+	x ^= x * 0xc7afe638u;
+	x ^= x * 0x8d22f6e6u;
+	return x;
+}
+
+// Owen scramble, the higher bits of x decide how the lower ones are flipped
+inline uint NestedUniformScramble(uint x, uint seed)
+{
+	return ReverseBits(LaineKarrasPermutation(ReverseBits(x), seed));
+}
+
+// Unscrambled Sobol point as a 0.32 fixed point number
+inline uint SobolBits(uint index, uint dimension)
+{
+	uint result = 0u;
+	uint offset = SAMPLING_SOBOL_OFFSET + dimension * SOBOL_BITS;
+	for (uint bit = 0u; index != 0u; bit++, index >>= 1u)
+	{
+		if ((index & 1u) != 0u)
+			result ^= LoadSamplingTable(offset + bit);
+	}
+	return result;
+}
+
+// Owen scrambled Sobol. The index is shuffled per block of SOBOL_DIMENSIONS, shuffling keeps every aligned power of
+// two block of indices together, so the first 2^m samples stay a (0, m, 2)-net in dimensions 0 and 1
+inline uint OwenSobolBits(uint index, uint dimension, uint seed)
+{
+	uint shuffled = NestedUniformScramble(index, HashCombine(seed, dimension / SOBOL_DIMENSIONS));
+	uint bits = SobolBits(shuffled, dimension % SOBOL_DIMENSIONS);
+	return NestedUniformScramble(bits, HashCombine(seed, dimension + 0x68bc21ebu));
+}
+
+// LATTICE_GENERATOR^dimension, the generating vector of the lattice
+inline uint LatticeGenerator(uint dimension)
+{
+	uint z = 1u;
+	uint base = LATTICE_GENERATOR;
+	for (uint e = dimension; e != 0u; e >>= 1u)
+	{
+		if ((e & 1u) != 0u)
+			z = (z * base) & (LATTICE_POINTS - 1u);
+		base = (base * base) & (LATTICE_POINTS - 1u);
+	}
+	return z;
+}
+
+// Toroidal shift of a pixel as a 0.32 fixed point number. The generators are odd, so along every dimension the
+// pixels of a mask tile get the LATTICE_POINTS shifts k / LATTICE_POINTS once each
+inline uint LatticeShiftBits(uint pixelX, uint pixelY, uint dimension)
+{
+	uint x = pixelX & (BLUE_NOISE_SIZE - 1u);
+	uint y = pixelY & (BLUE_NOISE_SIZE - 1u);
+	uint rank = LoadSamplingTable(SAMPLING_RANK_OFFSET + y * BLUE_NOISE_SIZE + x);
+	uint point = (rank * LatticeGenerator(dimension)) & (LATTICE_POINTS - 1u);
+	return point * (0xffffffffu / LATTICE_POINTS + 1u);
+}
+
+// Sample number sampleIdx of a pixel, in [0, 1). The shift is added in fixed point, which wraps around on its own
+inline float LowDiscrepancySample(uint pixelX, uint pixelY, uint sampleIdx, uint dimension)
+{
+	uint bits = OwenSobolBits(sampleIdx, dimension, SAMPLING_SEED) + LatticeShiftBits(pixelX, pixelY, dimension);
+	return float(bits >> 8) / 16777216.f;
+}
+
+#ifndef SHADER_STRUCT
+} // namespace Ball::Sampling
+#endif
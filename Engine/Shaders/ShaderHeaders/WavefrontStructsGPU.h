@@ -40,7 +40,7 @@ struct ThresholdValue
 struct ShadeSettings
 {
 	float m_Threshold;
-	float m_ConeSpreadAngle;
+	float m_TextureLODBias; // Added to the mip level of every texture fetch, see RayConeGPU.h
 	float m_TracingDistanceMultiplier;
 };
 
@@ -49,6 +49,7 @@ struct Ray
 	float3 m_Origin;
 	float3 m_Direction;
 	float m_ConeWidth;
+	float m_ConeSpreadAngle; // Changes at every bounce, see BounceConeSpread
 
 	float3 m_Throughput; // RGB
 	uint m_PixelIdx; // x + width * y
@@ -56,6 +57,9 @@ struct Ray
 	uint m_LastSpecular; // 1 - last ray was specular, 0 - last ray was regular
 	float3 m_Absorption; // for Beer's Law
 	float m_MaxT; // for Tracing Distance Selection
+
+	// Pdf of the diffuse bounce that created this ray, when the sky was also sampled there. 0 otherwise
+	float m_EnvironmentMisPdf;
 };
 
 struct ExtendResult
@@ -78,7 +82,7 @@ struct ShadowRay
 	uint m_PixelIdx; // x + width * y
 
 	float3 m_Energy; // RGB
-	float m_Padding; // ToDo: COMPACT THE VARIABLES
+	uint m_IsEnvironment; // 1 - sample of the sky, it isn't part of ReSTIR
 };
 
 struct LightPickData
@@ -0,0 +1,388 @@
+#include "AudioScheduler.h"
+
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+
+namespace Ball
+{
+	namespace
+	{
+		// Voices at or below this are not worth a real voice
+		constexpr float MIN_AUDIBILITY = 0.001f;
+		// Real voices are preferred over virtual voices that are about as audible, so voices don't switch back and
+		// forth every frame
+		constexpr float REAL_VOICE_BIAS = 1.1f;
+	} // namespace
+
+	uint32_t AudioNameTable::Intern(std::string_view name)
+	{
+		const auto inserted = m_Indices.emplace(StringId::Intern(name), static_cast<uint32_t>(m_Names.size()));
+		if (inserted.second)
+			m_Names.emplace_back(name);
+		return inserted.first->second;
+	}
+
+	uint32_t AudioNameTable::Find(std::string_view name) const
+	{
+		const auto it = m_Indices.find(StringId(name));
+		return it != m_Indices.end() ? it->second : UINT32_MAX;
+	}
+
+	void AudioCommandBuffer::Play(AudioVoiceId voice, AudioEventId event, float volume)
+	{
+		AudioCommand& command = m_Commands.emplace_back();
+		command.m_Type = AudioCommandType::PLAY;
+		command.m_Voice = voice;
+		command.m_Id = event.m_Index;
+		command.m_Value = volume;
+	}
+
+	void AudioCommandBuffer::Play3D(AudioVoiceId voice, AudioEventId event, const glm::vec3& position, float volume)
+	{
+		AudioCommand& command = m_Commands.emplace_back();
+		command.m_Type = AudioCommandType::PLAY;
+		command.m_Flag = true;
+		command.m_Voice = voice;
+		command.m_Id = event.m_Index;
+		command.m_Value = volume;
+		command.m_Position = position;
+	}
+
+	void AudioCommandBuffer::StopVoice(AudioVoiceId voice, bool allowFadeOut)
+	{
+		AudioCommand& command = m_Commands.emplace_back();
+		command.m_Type = AudioCommandType::STOP_VOICE;
+		command.m_Flag = allowFadeOut;
+		command.m_Voice = voice;
+	}
+
+	void AudioCommandBuffer::StopEvent(AudioEventId event, bool allowFadeOut)
+	{
+		AudioCommand& command = m_Commands.emplace_back();
+		command.m_Type = AudioCommandType::STOP_EVENT;
+		command.m_Flag = allowFadeOut;
+		command.m_Id = event.m_Index;
+	}
+
+	void AudioCommandBuffer::StopAll(bool allowFadeOut)
+	{
+		AudioCommand& command = m_Commands.emplace_back();
+		command.m_Type = AudioCommandType::STOP_ALL;
+		command.m_Flag = allowFadeOut;
+	}
+
+	void AudioCommandBuffer::SetVolume(AudioVoiceId voice, float volume)
+	{
+		AudioCommand& command = m_Commands.emplace_back();
+		command.m_Type = AudioCommandType::SET_VOLUME;
+		command.m_Voice = voice;
+		command.m_Value = volume;
+	}
+
+	void AudioCommandBuffer::SetPosition(AudioVoiceId voice, const glm::vec3& position)
+	{
+		AudioCommand& command = m_Commands.emplace_back();
+		command.m_Type = AudioCommandType::SET_POSITION;
+		command.m_Voice = voice;
+		command.m_Position = position;
+	}
+
+	void AudioCommandBuffer::SetParameter(AudioVoiceId voice, AudioParameterId parameter, float value)
+	{
+		AudioCommand& command = m_Commands.emplace_back();
+		command.m_Type = AudioCommandType::SET_PARAMETER;
+		command.m_Voice = voice;
+		command.m_Id = parameter.m_Index;
+		command.m_Value = value;
+	}
+
+	void AudioCommandBuffer::SetListener(const glm::vec3& position, const glm::vec3& forward, const glm::vec3& up)
+	{
+		AudioCommand& command = m_Commands.emplace_back();
+		command.m_Type = AudioCommandType::SET_LISTENER;
+		command.m_Position = position;
+		command.m_Forward = forward;
+		command.m_Up = up;
+	}
+
+	void AudioVoiceScheduler::SetEventSettings(AudioEventId event, const AudioEventSettings& settings)
+	{
+		if (event.IsValid())
+			GetEventData(event).m_Settings = settings;
+	}
+
+	AudioEventSettings AudioVoiceScheduler::GetEventSettings(AudioEventId event) const
+	{
+		return event.m_Index < m_Events.size() ? m_Events[event.m_Index].m_Settings : AudioEventSettings();
+	}
+
+	AudioVoiceId AudioVoiceScheduler::ReserveVoice()
+	{
+		uint32_t index;
+		if (!m_FreeVoices.empty())
+		{
+			index = m_FreeVoices.back();
+			m_FreeVoices.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(m_Voices.size());
+			m_Voices.emplace_back().m_Id.m_Index = index;
+		}
+
+		AudioVoice& voice = m_Voices[index];
+		voice.m_State = AudioVoiceState::RESERVED;
+		return voice.m_Id;
+	}
+
+	void AudioVoiceScheduler::Execute(const AudioCommandBuffer& commands, float deltaTime, AudioBackend& backend)
+	{
+		m_Stats = {};
+		m_Stats.m_Commands = static_cast<uint32_t>(commands.GetCommands().size());
+		for (const AudioCommand& command : commands.GetCommands())
+			ExecuteCommand(command, backend);
+
+		// Finished voices are freed before ranking, so they don't take the place of others
+		m_Ranking.clear();
+		for (AudioVoice& voice : m_Voices)
+		{
+			if (voice.m_State != AudioVoiceState::REAL && voice.m_State != AudioVoiceState::VIRTUAL)
+				continue;
+
+			voice.m_Time += deltaTime;
+			const EventData& event = m_Events[voice.m_Event.m_Index];
+			const bool finished = voice.m_State == AudioVoiceState::REAL
+				? !backend.IsVoicePlaying(voice.m_Id)
+				: event.m_Length >= 0.f && voice.m_Time >= event.m_Length;
+			if (finished)
+			{
+				if (voice.m_State == AudioVoiceState::REAL)
+					backend.StopVoice(voice.m_Id, false);
+				FreeVoice(voice);
+				m_Stats.m_FinishedVoices++;
+				continue;
+			}
+
+			voice.m_Audibility = CalculateAudibility(voice);
+			m_Ranking.push_back(voice.m_Id.m_Index);
+		}
+
+		std::sort(m_Ranking.begin(),
+				  m_Ranking.end(),
+				  [this](uint32_t a, uint32_t b)
+				  {
+					  const AudioVoice& voiceA = m_Voices[a];
+					  const AudioVoice& voiceB = m_Voices[b];
+					  const int priorityA = m_Events[voiceA.m_Event.m_Index].m_Settings.m_Priority;
+					  const int priorityB = m_Events[voiceB.m_Event.m_Index].m_Settings.m_Priority;
+					  if (priorityA != priorityB)
+						  return priorityA > priorityB;
+
+					  const float scoreA =
+						  voiceA.m_Audibility * (voiceA.m_State == AudioVoiceState::REAL ? REAL_VOICE_BIAS : 1.f);
+					  const float scoreB =
+						  voiceB.m_Audibility * (voiceB.m_State == AudioVoiceState::REAL ? REAL_VOICE_BIAS : 1.f);
+					  if (scoreA != scoreB)
+						  return scoreA > scoreB;
+					  return a < b;
+				  });
+
+		for (EventData& event : m_Events)
+			event.m_RealVoices = 0;
+
+		m_Real.resize(m_Ranking.size());
+		uint32_t realVoices = 0;
+		for (size_t i = 0; i < m_Ranking.size(); i++)
+		{
+			const AudioVoice& voice = m_Voices[m_Ranking[i]];
+			EventData& event = m_Events[voice.m_Event.m_Index];
+			m_Real[i] = voice.m_Audibility > MIN_AUDIBILITY && realVoices < m_MaxRealVoices &&
+				event.m_RealVoices < event.m_Settings.m_MaxRealVoices;
+			realVoices += m_Real[i];
+			event.m_RealVoices += m_Real[i];
+		}
+		m_Stats.m_RealVoices = realVoices;
+		m_Stats.m_VirtualVoices = static_cast<uint32_t>(m_Ranking.size()) - realVoices;
+
+		// Voices that lost their place are virtualized before others are started, so the backend never plays more
+		// voices than the limit
+		for (size_t i = 0; i < m_Ranking.size(); i++)
+		{
+			AudioVoice& voice = m_Voices[m_Ranking[i]];
+			if (!m_Real[i] && voice.m_State == AudioVoiceState::REAL)
+			{
+				backend.StopVoice(voice.m_Id, true);
+				voice.m_State = AudioVoiceState::VIRTUAL;
+				m_Stats.m_VirtualizedVoices++;
+			}
+		}
+		for (size_t i = 0; i < m_Ranking.size(); i++)
+		{
+			AudioVoice& voice = m_Voices[m_Ranking[i]];
+			if (m_Real[i] && voice.m_State == AudioVoiceState::VIRTUAL)
+			{
+				voice.m_State = AudioVoiceState::REAL;
+				backend.StartVoice(voice);
+				m_Stats.m_StartedVoices++;
+			}
+		}
+	}
+
+	void AudioVoiceScheduler::StopAll(AudioBackend& backend)
+	{
+		for (AudioVoice& voice : m_Voices)
+		{
+			if (voice.m_State != AudioVoiceState::FREE)
+				StopVoice(voice, false, backend);
+		}
+	}
+
+	bool AudioVoiceScheduler::IsVoiceActive(AudioVoiceId voice) const
+	{
+		return GetVoice(voice) != nullptr;
+	}
+
+	const AudioVoice* AudioVoiceScheduler::GetVoice(AudioVoiceId voice) const
+	{
+		if (voice.m_Index >= m_Voices.size())
+			return nullptr;
+
+		const AudioVoice& found = m_Voices[voice.m_Index];
+		return found.m_Id == voice && found.m_State != AudioVoiceState::FREE ? &found : nullptr;
+	}
+
+	AudioVoice* AudioVoiceScheduler::FindVoice(AudioVoiceId voice)
+	{
+		return const_cast<AudioVoice*>(GetVoice(voice));
+	}
+
+	AudioVoiceScheduler::EventData& AudioVoiceScheduler::GetEventData(AudioEventId event)
+	{
+		if (event.m_Index >= m_Events.size())
+			m_Events.resize(event.m_Index + 1);
+		return m_Events[event.m_Index];
+	}
+
+	void AudioVoiceScheduler::ExecuteCommand(const AudioCommand& command, AudioBackend& backend)
+	{
+		switch (command.m_Type)
+		{
+		case AudioCommandType::PLAY:
+		{
+			AudioVoice* voice = FindVoice(command.m_Voice);
+			if (voice == nullptr || voice->m_State != AudioVoiceState::RESERVED)
+				break;
+
+			// Nothing to play, the reserved voice goes back to the pool
+			const AudioEventId eventId = {command.m_Id};
+			if (!eventId.IsValid())
+			{
+				FreeVoice(*voice);
+				break;
+			}
+
+			EventData& event = GetEventData(eventId);
+			if (!event.m_LengthKnown)
+			{
+				event.m_Length = backend.GetEventLength(eventId);
+				event.m_LengthKnown = true;
+			}
+
+			// Starts as virtual, ranking decides whether it's played this frame
+			voice->m_Event = eventId;
+			voice->m_State = AudioVoiceState::VIRTUAL;
+			voice->m_Is3D = command.m_Flag;
+			voice->m_Volume = command.m_Value;
+			voice->m_Position = command.m_Position;
+			voice->m_Time = 0.f;
+			voice->m_Parameters.clear();
+			break;
+		}
+		case AudioCommandType::STOP_VOICE:
+			if (AudioVoice* voice = FindVoice(command.m_Voice))
+				StopVoice(*voice, command.m_Flag, backend);
+			break;
+		case AudioCommandType::STOP_EVENT:
+			for (AudioVoice& voice : m_Voices)
+			{
+				if (voice.m_State != AudioVoiceState::FREE && voice.m_State != AudioVoiceState::RESERVED &&
+					voice.m_Event.m_Index == command.m_Id)
+					StopVoice(voice, command.m_Flag, backend);
+			}
+			break;
+		case AudioCommandType::STOP_ALL:
+			for (AudioVoice& voice : m_Voices)
+			{
+				if (voice.m_State != AudioVoiceState::FREE && voice.m_State != AudioVoiceState::RESERVED)
+					StopVoice(voice, command.m_Flag, backend);
+			}
+			break;
+		case AudioCommandType::SET_VOLUME:
+			if (AudioVoice* voice = FindVoice(command.m_Voice))
+			{
+				voice->m_Volume = command.m_Value;
+				if (voice->m_State == AudioVoiceState::REAL)
+					backend.SetVoiceVolume(voice->m_Id, command.m_Value);
+			}
+			break;
+		case AudioCommandType::SET_POSITION:
+			if (AudioVoice* voice = FindVoice(command.m_Voice))
+			{
+				voice->m_Position = command.m_Position;
+				if (voice->m_State == AudioVoiceState::REAL)
+					backend.SetVoicePosition(voice->m_Id, command.m_Position);
+			}
+			break;
+		case AudioCommandType::SET_PARAMETER:
+			if (AudioVoice* voice = FindVoice(command.m_Voice))
+			{
+				const AudioParameterId parameter = {command.m_Id};
+				auto it = std::find_if(voice->m_Parameters.begin(),
+									   voice->m_Parameters.end(),
+									   [parameter](const auto& stored) { return stored.first == parameter; });
+				if (it != voice->m_Parameters.end())
+					it->second = command.m_Value;
+				else
+					voice->m_Parameters.emplace_back(parameter, command.m_Value);
+
+				if (voice->m_State == AudioVoiceState::REAL)
+					backend.SetVoiceParameter(voice->m_Id, parameter, command.m_Value);
+			}
+			break;
+		case AudioCommandType::SET_LISTENER:
+			m_ListenerPosition = command.m_Position;
+			backend.SetListener(command.m_Position, command.m_Forward, command.m_Up);
+			break;
+		}
+	}
+
+	void AudioVoiceScheduler::StopVoice(AudioVoice& voice, bool allowFadeOut, AudioBackend& backend)
+	{
+		if (voice.m_State == AudioVoiceState::REAL)
+			backend.StopVoice(voice.m_Id, allowFadeOut);
+		FreeVoice(voice);
+	}
+
+	void AudioVoiceScheduler::FreeVoice(AudioVoice& voice)
+	{
+		voice.m_State = AudioVoiceState::FREE;
+		voice.m_Id.m_Generation++;
+		m_FreeVoices.push_back(voice.m_Id.m_Index);
+	}
+
+	float AudioVoiceScheduler::CalculateAudibility(const AudioVoice& voice) const
+	{
+		if (!voice.m_Is3D)
+			return voice.m_Volume;
+
+		const AudioEventSettings& settings = m_Events[voice.m_Event.m_Index].m_Settings;
+		const float distance = glm::distance(voice.m_Position, m_ListenerPosition);
+		if (distance <= settings.m_MinDistance)
+			return voice.m_Volume;
+		if (distance >= settings.m_MaxDistance)
+			return 0.f;
+		return voice.m_Volume * (1.f - (distance - settings.m_MinDistance) /
+								 (settings.m_MaxDistance - settings.m_MinDistance));
+	}
+} // namespace Ball
@@ -9,8 +9,169 @@
 #include "Engine.h"
 #include "Utilities/LaunchParameters.h"
 
+#include <chrono>
+#include <vector>
+
 using namespace Ball;
 
+namespace Ball
+{
+	/// <summary>
+	/// Plays the voices of the scheduler as FMOD Studio event instances. Event descriptions and parameter ids are
+	/// looked up by name once and cached by interned id.
+	/// </summary>
+	class FmodAudioBackend final : public AudioBackend
+	{
+	public:
+		explicit FmodAudioBackend(AudioSystem& audio) : m_Audio(audio) {}
+
+		float GetEventLength(AudioEventId event) override
+		{
+			FMOD::Studio::EventDescription* description = GetDescription(event);
+			bool oneShot = false;
+			int lengthInMs = 0;
+			if (description == nullptr || description->isOneshot(&oneShot) != FMOD_OK || !oneShot ||
+				description->getLength(&lengthInMs) != FMOD_OK)
+				return -1.f;
+			return static_cast<float>(lengthInMs) / 1000.f;
+		}
+
+		void StartVoice(const AudioVoice& voice) override
+		{
+			FMOD::Studio::EventDescription* description = GetDescription(voice.m_Event);
+			if (description == nullptr)
+				return;
+
+			FMOD::Studio::EventInstance* instance = nullptr;
+			FMOD_RESULT result = description->createInstance(&instance);
+			if (result != FMOD_OK)
+			{
+				ERROR(LOG_AUDIO, "Failed to create FMOD Event Instance: %s", FMOD_ErrorString(result));
+				return;
+			}
+
+			if (voice.m_Id.m_Index >= m_Instances.size())
+				m_Instances.resize(voice.m_Id.m_Index + 1, nullptr);
+			m_Instances[voice.m_Id.m_Index] = instance;
+
+			instance->setVolume(m_Audio.GetMixedVolume(m_Audio.GetEventName(voice.m_Event), voice.m_Volume));
+			if (voice.m_Is3D)
+				Set3DAttributes(instance, voice.m_Position);
+			for (const auto& [parameter, value] : voice.m_Parameters)
+				SetParameter(instance, voice.m_Event, parameter, value);
+			if (voice.m_Time > 0.f)
+				instance->setTimelinePosition(static_cast<int>(voice.m_Time * 1000.f));
+
+			result = instance->start();
+			if (result != FMOD_OK)
+				ERROR(LOG_AUDIO, "Failed to start FMOD Event Instance: %s", FMOD_ErrorString(result));
+		}
+
+		void StopVoice(AudioVoiceId voice, bool allowFadeOut) override
+		{
+			FMOD::Studio::EventInstance* instance = GetInstance(voice);
+			if (instance == nullptr)
+				return;
+
+			// Released instances are destroyed by FMOD once they stopped, fading out continues after this
+			instance->stop(allowFadeOut ? FMOD_STUDIO_STOP_ALLOWFADEOUT : FMOD_STUDIO_STOP_IMMEDIATE);
+			instance->release();
+			m_Instances[voice.m_Index] = nullptr;
+		}
+
+		bool IsVoicePlaying(AudioVoiceId voice) override
+		{
+			FMOD::Studio::EventInstance* instance = GetInstance(voice);
+			FMOD_STUDIO_PLAYBACK_STATE state = FMOD_STUDIO_PLAYBACK_STOPPED;
+			if (instance != nullptr)
+				instance->getPlaybackState(&state);
+			return state != FMOD_STUDIO_PLAYBACK_STOPPED;
+		}
+
+		void SetVoiceVolume(AudioVoiceId voice, float volume) override
+		{
+			if (FMOD::Studio::EventInstance* instance = GetInstance(voice))
+			{
+				const AudioVoice* scheduled = m_Audio.m_Scheduler.GetVoice(voice);
+				instance->setVolume(m_Audio.GetMixedVolume(m_Audio.GetEventName(scheduled->m_Event), volume));
+			}
+		}
+
+		void SetVoicePosition(AudioVoiceId voice, const glm::vec3& position) override
+		{
+			if (FMOD::Studio::EventInstance* instance = GetInstance(voice))
+				Set3DAttributes(instance, position);
+		}
+
+		void SetVoiceParameter(AudioVoiceId voice, AudioParameterId parameter, float value) override
+		{
+			if (FMOD::Studio::EventInstance* instance = GetInstance(voice))
+				SetParameter(instance, m_Audio.m_Scheduler.GetVoice(voice)->m_Event, parameter, value);
+		}
+
+		void SetListener(const glm::vec3& position, const glm::vec3& forward, const glm::vec3& up) override
+		{
+			FMOD_3D_ATTRIBUTES attributes = {};
+			attributes.position = {position.x, position.y, position.z};
+			attributes.forward = {forward.x, forward.y, forward.z};
+			attributes.up = {up.x, up.y, up.z};
+			m_Audio.m_System->setListenerAttributes(0, &attributes);
+		}
+
+	private:
+		FMOD::Studio::EventDescription* GetDescription(AudioEventId event)
+		{
+			if (event.m_Index >= m_Descriptions.size())
+				m_Descriptions.resize(event.m_Index + 1, nullptr);
+			if (m_Descriptions[event.m_Index] == nullptr)
+				m_Descriptions[event.m_Index] = m_Audio.CreateAudioEvent(m_Audio.GetEventName(event));
+			return m_Descriptions[event.m_Index];
+		}
+
+		FMOD::Studio::EventInstance* GetInstance(AudioVoiceId voice) const
+		{
+			return voice.m_Index < m_Instances.size() ? m_Instances[voice.m_Index] : nullptr;
+		}
+
+		void SetParameter(FMOD::Studio::EventInstance* instance, AudioEventId event, AudioParameterId parameter,
+						  float value)
+		{
+			const uint64_t key = static_cast<uint64_t>(event.m_Index) << 32 | parameter.m_Index;
+			auto it = m_ParameterIds.find(key);
+			if (it == m_ParameterIds.end())
+			{
+				FMOD_STUDIO_PARAMETER_DESCRIPTION description = {};
+				const std::string& name = m_Audio.m_ParameterNames.GetName(parameter.m_Index);
+				const bool found = GetDescription(event) != nullptr &&
+					GetDescription(event)->getParameterDescriptionByName(name.c_str(), &description) == FMOD_OK;
+				if (!found)
+					WARN(LOG_AUDIO, "Event %s has no parameter %s", m_Audio.GetEventName(event).c_str(), name.c_str());
+				it = m_ParameterIds.emplace(key, std::make_pair(description.id, found)).first;
+			}
+
+			if (it->second.second)
+				instance->setParameterByID(it->second.first, value);
+		}
+
+		static void Set3DAttributes(FMOD::Studio::EventInstance* instance, const glm::vec3& position)
+		{
+			FMOD_3D_ATTRIBUTES attributes = {};
+			attributes.position = {position.x, position.y, position.z};
+			attributes.forward = {0.f, 0.f, 1.f};
+			attributes.up = {0.f, 1.f, 0.f};
+			instance->set3DAttributes(&attributes);
+		}
+
+		AudioSystem& m_Audio;
+		// Indexed by event id
+		std::vector<FMOD::Studio::EventDescription*> m_Descriptions;
+		// Indexed by voice slot
+		std::vector<FMOD::Studio::EventInstance*> m_Instances;
+		// Key is the event id in the high and the parameter id in the low bits, false when the event doesn't have it
+		std::unordered_map<uint64_t, std::pair<FMOD_STUDIO_PARAMETER_ID, bool>> m_ParameterIds;
+	};
+} // namespace Ball
+
 void AudioSystem::Init()
 {
 	PlatformInit();
@@ -46,19 +207,124 @@ void AudioSystem::Init()
 
 	// set starting volume with launch parameter
 	SetVolume(LaunchParameters::GetFloat("Volume", 1.f));
+
+	m_Backend = new FmodAudioBackend(*this);
+	m_Scheduler.SetMaxRealVoices(static_cast<uint32_t>((std::max)(LaunchParameters::GetInt("MaxAudioVoices", 64), 0)));
 }
 
 void AudioSystem::Shutdown()
 {
+	m_Scheduler.StopAll(*m_Backend);
+	delete m_Backend;
+	m_Backend = nullptr;
+
 	m_System->release();
 	m_CoreSystem->release();
 }
 
 void AudioSystem::Update(float deltaTime)
 {
+	const auto start = std::chrono::high_resolution_clock::now();
+
 	if (m_Applyeffects)
 		SetAllEffects();
+
+	// All operations of the frame reach FMOD here, before the FMOD update processes them
+	m_Scheduler.Execute(m_Commands, deltaTime, *m_Backend);
+	m_Commands.Clear();
 	m_System->update();
+
+	const std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+	m_UpdateCount++;
+	m_TotalUpdateTimeMs += duration.count();
+	m_MaxUpdateTimeMs = (std::max)(m_MaxUpdateTimeMs, duration.count());
+	m_PeakRealVoices = (std::max)(m_PeakRealVoices, GetSchedulerStats().m_RealVoices);
+	m_PeakVirtualVoices = (std::max)(m_PeakVirtualVoices, GetSchedulerStats().m_VirtualVoices);
+}
+
+AudioEventId AudioSystem::GetEventId(const std::string& eventName)
+{
+	return {m_EventNames.Intern(eventName)};
+}
+
+AudioParameterId AudioSystem::GetParameterId(const std::string& parameterName)
+{
+	return {m_ParameterNames.Intern(parameterName)};
+}
+
+void AudioSystem::SetEventSettings(AudioEventId event, const AudioEventSettings& settings)
+{
+	m_Scheduler.SetEventSettings(event, settings);
+}
+
+AudioVoiceId AudioSystem::PlayEvent(AudioEventId event, float volume)
+{
+	if (!event.IsValid())
+	{
+		WARN(LOG_AUDIO, "Tried to play an invalid audio event");
+		return {};
+	}
+
+	const AudioVoiceId voice = m_Scheduler.ReserveVoice();
+	m_Commands.Play(voice, event, volume);
+	return voice;
+}
+
+AudioVoiceId AudioSystem::PlayEvent3D(AudioEventId event, const glm::vec3& position, float volume)
+{
+	if (!event.IsValid())
+	{
+		WARN(LOG_AUDIO, "Tried to play an invalid audio event");
+		return {};
+	}
+
+	const AudioVoiceId voice = m_Scheduler.ReserveVoice();
+	m_Commands.Play3D(voice, event, position, volume);
+	return voice;
+}
+
+void AudioSystem::StopVoice(AudioVoiceId voice, bool allowFadeOut)
+{
+	m_Commands.StopVoice(voice, allowFadeOut);
+}
+
+void AudioSystem::StopEvent(AudioEventId event, bool allowFadeOut)
+{
+	m_Commands.StopEvent(event, allowFadeOut);
+}
+
+void AudioSystem::SetVoiceVolume(AudioVoiceId voice, float volume)
+{
+	m_Commands.SetVolume(voice, volume);
+}
+
+void AudioSystem::SetVoicePosition(AudioVoiceId voice, const glm::vec3& position)
+{
+	m_Commands.SetPosition(voice, position);
+}
+
+void AudioSystem::SetVoiceParameter(AudioVoiceId voice, AudioParameterId parameter, float value)
+{
+	m_Commands.SetParameter(voice, parameter, value);
+}
+
+void AudioSystem::SetListener(const glm::vec3& position, const glm::vec3& forward, const glm::vec3& up)
+{
+	m_Commands.SetListener(position, forward, up);
+}
+
+void AudioSystem::LogReport() const
+{
+	if (m_UpdateCount == 0)
+		return;
+
+	INFO(LOG_AUDIO,
+		 "Audio update: %.3f ms average, %.3f ms max over %u frames. Peak voices: %u real, %u virtual",
+		 m_TotalUpdateTimeMs / m_UpdateCount,
+		 m_MaxUpdateTimeMs,
+		 m_UpdateCount,
+		 m_PeakRealVoices,
+		 m_PeakVirtualVoices);
 }
 
 FMOD::Studio::Bank* AudioSystem::LoadBank(const std::string& filepath)
@@ -230,6 +496,8 @@ void AudioSystem::StopAudioEvent(const std::string& eventName, const bool AllowF
 
 void Ball::AudioSystem::StopAllAudioEvents()
 {
+	m_Commands.StopAll(false);
+
 	for (auto it = m_EventInstances.cbegin(); it != m_EventInstances.cend();)
 	{
 		if (GetIsEventPlaying(it->first))
@@ -512,7 +780,7 @@ void Ball::AudioSystem::SetEcho(float echoLevel, float echoDelay)
 	}
 }
 
-float Ball::AudioSystem::GetMixedVolume(const std::string eventName, float volume)
+float Ball::AudioSystem::GetMixedVolume(const std::string& eventName, float volume)
 {
 	float MixedVolume = volume * m_MasterVolume;
 
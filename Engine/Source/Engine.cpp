@@ -1,10 +1,12 @@
 #include "Engine.h"
 
+#include <algorithm>
 #include <chrono>
 #include <unordered_set>
 
 #include "BaseGame.h"
 #include "Input/Input.h"
+#include "Input/InputRecording.h"
 #include "Rendering/Renderer.h"
 #include "Window.h"
 
@@ -28,12 +30,19 @@
 
 #include "GameObjects/Types/Camera.h"
 #include "GameObjects/Types/FreeCamera.h"
+#include "GameObjects/ObjectManager.h"
 
 #include <Catch2/catch_amalgamated.hpp>
 
 #include "UnitTesting.h"
 #include "Logger/LoggerSystem.h"
 #include "Utilities/FileWatch.h"
+#include "Rendering/MemoryTracker.h"
+#include "Utilities/AllocationCounter.h"
+#include "Utilities/FrameArena.h"
+#include "Utilities/Benchmark.h"
+#include "Utilities/CpuProfiler.h"
+#include "GameObjects/Serialization/PrefabCache.h"
 
 using namespace Ball;
 
@@ -63,6 +72,17 @@ bool Ball::Engine::Initialize(const ApplicationConfig& config)
 
 	m_FileWatch = new FileWatchSystem();
 	m_FileWatch->Init();
+	m_PrefabCache = new PrefabCache();
+
+	// Headless runs have no tools to look at the memory usage, so it's logged instead
+	const int memoryBudgetMB = std::max(LaunchParameters::GetInt("MemoryBudgetMB", 0), 0);
+	GetMemoryTracker().SetBudget(MemoryTag::TOTAL, static_cast<uint64_t>(memoryBudgetMB) * 1024 * 1024);
+	if (LaunchParameters::Contains("Headless") || LaunchParameters::Contains("LogMemory"))
+	{
+		const int logInterval = std::max(LaunchParameters::GetInt("MemoryLogInterval", 600), 0);
+		GetMemoryTracker().SetLogInterval(logInterval);
+		AllocationCounter::SetLogInterval(logInterval);
+	}
 
 	// Input has to be created before window, as we depend on windproc
 	m_Input = new Input();
@@ -83,6 +103,20 @@ bool Ball::Engine::Initialize(const ApplicationConfig& config)
 
 	m_Input->Init();
 
+	// Recording and replaying input makes runs reproducible, e.g. for headless benchmarks
+	m_FixedDeltaTime = std::max(LaunchParameters::GetFloat("FixedDeltaTime", 0.f), 0.f);
+	if (LaunchParameters::Contains("RecordInput"))
+		m_InputRecorder = new InputRecorder();
+	if (LaunchParameters::Contains("ReplayInput"))
+	{
+		m_InputReplay = new InputReplay();
+		if (!m_InputReplay->Load(LaunchParameters::GetString("ReplayInput", "")))
+		{
+			delete m_InputReplay;
+			m_InputReplay = nullptr;
+		}
+	}
+
 	// Set up an empty level.
 	//  Calling HandleLevelSwitching() is valid here, since we're not in the update loop
 	LoadLevel<Level>("", LevelSaveType::None);
@@ -112,6 +146,10 @@ bool Ball::Engine::Initialize(const ApplicationConfig& config)
 	m_Game = config.m_Game;
 	m_Game->Initialize();
 
+	// -Benchmark=<name> measures a fixed number of frames and writes the results to Benchmarks/<name>.json
+	if (LaunchParameters::Contains("Benchmark"))
+		StartBenchmark();
+
 	END_TIMER_MSG(engine_init, "Initialized Engine with Window %i x %i", m_Window->GetWidth(), m_Window->GetHeight());
 
 	return true;
@@ -125,6 +163,11 @@ void Engine::Shutdown()
 		m_Renderer->WaitForExecution();
 	}
 
+	if (LaunchParameters::Contains("Headless") || LaunchParameters::Contains("LogMemory"))
+		GetMemoryTracker().LogReport();
+	if (LaunchParameters::Contains("Headless") || LaunchParameters::Contains("LogAudio"))
+		m_Audio->LogReport();
+
 	// Unload all models
 	ResourceManager<Model>::UnloadAndClearAll();
 
@@ -136,6 +179,10 @@ void Engine::Shutdown()
 		m_Game->Shutdown();
 	delete m_Game;
 
+	delete m_Benchmark;
+	SaveInputRecording();
+	delete m_InputRecorder;
+	delete m_InputReplay;
 	delete m_Input;
 
 	m_ToolManager->Shutdown();
@@ -155,6 +202,8 @@ void Engine::Shutdown()
 		delete m_Renderer;
 	}
 
+	delete m_PrefabCache;
+
 	// Filewatch dependent on shader files from Renderer
 	m_FileWatch->ShutDown();
 	delete m_FileWatch;
@@ -181,15 +230,33 @@ int Engine::Run(const ApplicationConfig& config)
 	auto lastSecondTime = lastTime;
 	double totalTime = 0.0;
 	int frameCount = 0;
+	int exitCode = 0;
 
 	while (m_Window->IsAlive())
 	{
+		GetFrameArena().BeginFrame();
+
 		// Calculate delta time
 		auto currentTime = std::chrono::high_resolution_clock::now();
 		std::chrono::duration<double, std::milli> deltaTime = currentTime - lastTime;
 		lastTime = currentTime;
 
 		m_DeltaTime = static_cast<float>(deltaTime.count());
+		if (m_InputReplay != nullptr)
+		{
+			if (!m_InputReplay->NextFrame())
+			{
+				INFO(LOG_INPUT,
+					 "Input replay finished after %u frames, final state hash %016llx, %u frames diverged",
+					 m_InputReplay->GetFrameCount(),
+					 static_cast<unsigned long long>(HashLevelState()),
+					 m_InputReplay->GetMismatchCount());
+				break;
+			}
+			m_DeltaTime = m_InputReplay->GetDeltaTime();
+		}
+		if (m_FixedDeltaTime > 0.f)
+			m_DeltaTime = m_FixedDeltaTime;
 		const float deltaTimeInMiliseconds = m_DeltaTime * 0.001f;
 
 		totalTime += deltaTime.count();
@@ -207,7 +274,10 @@ int Engine::Run(const ApplicationConfig& config)
 			lastSecondTime = currentTime;
 		}
 
-		m_Renderer->BeginFrame();
+		{
+			PROFILE_CPU_ZONE("Begin Frame");
+			m_Renderer->BeginFrame();
+		}
 
 		// Here, we check if the level needs to be switched/reloaded/unloaded
 		HandleLevelSwitching();
@@ -228,22 +298,54 @@ int Engine::Run(const ApplicationConfig& config)
 		}
 
 		// Updates
-		m_Window->Update(); // This needs to be called early, otherwise Imgui input does not work.
-		m_Input->Update();
+		{
+			PROFILE_CPU_ZONE("Window and Input");
+			m_Window->Update(); // This needs to be called early, otherwise Imgui input does not work.
+			if (m_InputReplay != nullptr)
+				m_InputReplay->ApplyInput(*m_Input);
+			else
+				m_Input->Update();
+		}
+
+		if (m_InputRecorder != nullptr)
+			m_InputRecorder->RecordFrame(*m_Input, m_DeltaTime);
 
-		m_Game->Update();
+		{
+			PROFILE_CPU_ZONE("Game Update");
+			m_Game->Update();
+		}
 
 		if (!m_Paused)
 		{
+			PROFILE_CPU_ZONE("Level Update");
 			m_Level->Update(deltaTimeInMiliseconds);
 		}
 
-		m_Audio->Update(m_DeltaTime);
+		if (m_InputRecorder != nullptr)
+			m_InputRecorder->RecordStateHash(HashLevelState());
+		if (m_InputReplay != nullptr)
+			m_InputReplay->VerifyStateHash(HashLevelState());
+
+		{
+			PROFILE_CPU_ZONE("Audio");
+			if (Camera* camera = Camera::GetActiveCamera())
+			{
+				Transform& transform = camera->GetTransform();
+				m_Audio->SetListener(glm::vec3(transform.GetModelMatrix()[3]), transform.Forward(), transform.Up());
+			}
+			m_Audio->Update(m_DeltaTime);
+		}
+
+		{
+			PROFILE_CPU_ZONE("Tools");
+			m_ToolManager->Update();
+		}
 
 #ifndef NO_IMGUI
 		// Imgui rendering is done after all updates, This so that no other functions can access Imgui..
 		if (!Ball::LaunchParameters::Contains("Headless"))
 		{
+			PROFILE_CPU_ZONE("ImGui");
 			m_Renderer->ImGuiBeginFrame();
 			m_ToolManager->OnImgui();
 			m_Level->OnImGui();
@@ -251,15 +353,161 @@ int Engine::Run(const ApplicationConfig& config)
 		}
 #endif
 
-		m_Renderer->Render();
+		{
+			PROFILE_CPU_ZONE("Render");
+			m_Renderer->Render();
+		}
 		m_FileWatch->Update();
+		GetMemoryTracker().EndFrame();
+		AllocationCounter::EndFrame();
+		GetCpuProfiler().EndFrame();
+
+		if (m_Benchmark != nullptr)
+		{
+			const std::chrono::duration<float, std::milli> frameTime =
+				std::chrono::high_resolution_clock::now() - currentTime;
+			RecordBenchmarkFrame(frameTime.count());
+			if (m_Benchmark->IsFinished())
+			{
+				exitCode = FinishBenchmark();
+				break;
+			}
+		}
+
+		if (m_ExitRequested)
+		{
+			exitCode = m_ExitCode;
+			break;
+		}
 
 		// This should be the last function call in the loop!
 		m_DeltaTime = static_cast<float>(deltaTime.count());
 	}
 
 	Shutdown();
-	return 0;
+	return exitCode;
+}
+
+uint64_t Ball::Engine::HashLevelState() const
+{
+	uint64_t hash = TRANSFORM_HASH_SEED;
+	for (GameObject* gameObject : m_Level->GetObjectManager())
+		hash = HashTransform(gameObject->GetTransform(), hash);
+	return hash;
+}
+
+void Ball::Engine::SaveInputRecording()
+{
+	if (m_InputRecorder == nullptr)
+		return;
+
+	std::string path = LaunchParameters::GetString("RecordInput", "");
+	if (path.empty())
+		path = "InputRecording.bin";
+	m_InputRecorder->Save(path);
+}
+
+void Ball::Engine::StartBenchmark()
+{
+	BenchmarkSettings settings;
+	const std::string name = LaunchParameters::GetString("Benchmark", "");
+	if (!name.empty())
+		settings.m_Name = name;
+	settings.m_WarmupFrames =
+		static_cast<uint32_t>(std::max(LaunchParameters::GetInt("BenchmarkWarmupFrames", settings.m_WarmupFrames), 0));
+	settings.m_MeasuredFrames =
+		static_cast<uint32_t>(std::max(LaunchParameters::GetInt("BenchmarkFrames", settings.m_MeasuredFrames), 1));
+	settings.m_Seed = static_cast<uint32_t>(LaunchParameters::GetInt("Seed", settings.m_Seed));
+
+	// Every run simulates the same time steps, unless a delta time is given
+	if (m_FixedDeltaTime <= 0.f)
+		m_FixedDeltaTime = 1000.f / 60.f;
+	settings.m_FixedDeltaTime = m_FixedDeltaTime;
+
+	m_Benchmark = new BenchmarkRunner(settings);
+
+	// Without a level the scene the game set up is measured
+	const std::string levelPath = LaunchParameters::GetString("BenchmarkLevel", "");
+	if (!levelPath.empty())
+		LoadLevel<Level>(levelPath, LevelSaveType::Campaign);
+
+	INFO(LOG_GENERIC,
+		 "Running benchmark '%s', %u warm-up and %u measured frames",
+		 settings.m_Name.c_str(),
+		 settings.m_WarmupFrames,
+		 settings.m_MeasuredFrames);
+}
+
+void Ball::Engine::RecordBenchmarkFrame(float frameTimeInMs)
+{
+	m_Benchmark->AddSample("frame", "time", frameTimeInMs);
+	if (AllocationCounter::IsEnabled())
+	{
+		m_Benchmark->AddSample("frame", "allocations", static_cast<float>(AllocationCounter::GetFrameAllocations()));
+		m_Benchmark->AddSample(
+			"frame", "allocatedBytes", static_cast<float>(AllocationCounter::GetFrameAllocatedBytes()));
+	}
+
+	for (const CpuZoneTime& zone : GetCpuProfiler().GetLastFrameZones())
+		m_Benchmark->AddSample("cpu", zone.m_Name, zone.m_TimeInMs);
+	for (const Utilities::TimestampData& timestamp : m_Renderer->m_Data)
+		m_Benchmark->AddSample("gpu", timestamp.name, timestamp.timeInMs);
+
+	m_Benchmark->EndFrame();
+}
+
+int Ball::Engine::FinishBenchmark()
+{
+	for (size_t i = 0; i <= static_cast<size_t>(MemoryTag::NUM_TAGS); i++)
+	{
+		const MemoryTag tag = static_cast<MemoryTag>(i);
+		m_Benchmark->SetValue("memoryPeakBytes",
+							  MemoryTracker::GetTagName(tag),
+							  static_cast<double>(GetMemoryTracker().GetStats(tag).m_PeakBytes));
+	}
+
+	const BenchmarkSettings& settings = m_Benchmark->GetSettings();
+	const nlohmann::json results = m_Benchmark->ToJson();
+	const std::string outputPath =
+		LaunchParameters::GetString("BenchmarkOutput", "Benchmarks/" + settings.m_Name + ".json");
+	if (!FileIO::Write(FileIO::TempData, outputPath, results.dump(4)))
+		ERROR(LOG_GENERIC, "Failed to write the benchmark results to %s", outputPath.c_str());
+
+	const BenchmarkStatistics frameTime = m_Benchmark->GetStatistics("frame", "time");
+	INFO(LOG_GENERIC,
+		 "Benchmark '%s' finished, frame time p50 %.3f ms, p95 %.3f ms, p99 %.3f ms",
+		 settings.m_Name.c_str(),
+		 frameTime.m_P50,
+		 frameTime.m_P95,
+		 frameTime.m_P99);
+
+	if (!LaunchParameters::Contains("BenchmarkBaseline"))
+		return 0;
+
+	// A non-zero exit code lets a build server fail on regressions
+	const std::string baselinePath = LaunchParameters::GetString("BenchmarkBaseline", "");
+	const nlohmann::json baseline =
+		nlohmann::json::parse(FileIO::Read(FileIO::TempData, baselinePath), nullptr, false);
+	if (baseline.is_discarded())
+	{
+		ERROR(LOG_GENERIC, "Failed to read the benchmark baseline %s", baselinePath.c_str());
+		return 1;
+	}
+
+	const float tolerance = LaunchParameters::GetFloat("BenchmarkTolerance", 0.1f);
+	const std::vector<BenchmarkRegression> regressions = BenchmarkRunner::Compare(baseline, results, tolerance);
+	for (const BenchmarkRegression& regression : regressions)
+	{
+		WARN(LOG_GENERIC,
+			 "Benchmark regression in %s: %.3f -> %.3f",
+			 regression.m_Metric.c_str(),
+			 regression.m_Baseline,
+			 regression.m_Current);
+	}
+
+	if (regressions.empty())
+		INFO(LOG_GENERIC, "No regressions against %s (tolerance %.0f%%)", baselinePath.c_str(), tolerance * 100.f);
+	return regressions.empty() ? 0 : 1;
 }
 
 void Ball::Engine::SaveLevel(const std::string& filePath, const LevelSaveType& levelType)
@@ -0,0 +1,87 @@
+#include "FileReadBatch.h"
+
+namespace Ball
+{
+	FileReadBatch::FileReadBatch(std::vector<FileReadRequest> requests)
+		: m_Requests(std::move(requests)), m_Pending(m_Requests.size())
+	{
+	}
+
+	void FileReadBatch::Wait() const
+	{
+		if (IsComplete())
+			return;
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Completed.wait(lock, [this]() { return IsComplete(); });
+	}
+
+	bool FileReadBatch::AllSucceeded() const
+	{
+		for (const FileReadRequest& request : m_Requests)
+		{
+			if (!request.m_Succeeded)
+				return false;
+		}
+		return true;
+	}
+
+	void FileReadBatch::CompleteRequest()
+	{
+		if (m_Pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		// Locked so a waiter can't miss the notification between checking and sleeping
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Completed.notify_all();
+	}
+
+	FileReadWorkers::FileReadWorkers(uint32_t numThreads, ReadFunction readFunction) : m_ReadFunction(readFunction)
+	{
+		for (uint32_t i = 0; i < numThreads; i++)
+			m_Threads.emplace_back(&FileReadWorkers::Run, this);
+	}
+
+	FileReadWorkers::~FileReadWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stop = true;
+		}
+		m_HasJobs.notify_all();
+
+		// Queued jobs are still finished, nobody waits forever on a batch
+		for (std::thread& thread : m_Threads)
+			thread.join();
+	}
+
+	void FileReadWorkers::Submit(const std::shared_ptr<FileReadBatch>& batch)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for (size_t i = 0; i < batch->GetNumRequests(); i++)
+				m_Jobs.push_back({batch, i});
+		}
+		m_HasJobs.notify_all();
+	}
+
+	void FileReadWorkers::Run()
+	{
+		while (true)
+		{
+			Job job;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_HasJobs.wait(lock, [this]() { return m_Stop || !m_Jobs.empty(); });
+				if (m_Jobs.empty())
+					return;
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop_front();
+			}
+
+			m_ReadFunction(job.m_Batch->GetRequest(job.m_Index));
+			job.m_Batch->CompleteRequest();
+		}
+	}
+} // namespace Ball
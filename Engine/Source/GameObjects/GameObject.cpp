@@ -14,6 +14,16 @@
 
 using namespace Ball;
 
+namespace
+{
+	// Headless runs don't initialize the renderer, so there is no model manager
+	void RequestReloadModels()
+	{
+		if (ModelManager* modelManager = GetEngine().GetRenderer().GetModelManager())
+			modelManager->RequestReloadModels();
+	}
+} // namespace
+
 void GameObject::SetParent(GameObject* parent)
 {
 	// Leave room for error handling.There should be an extra check that checks whether the pointers are valid.
@@ -74,7 +84,7 @@ void GameObject::SetModel(const std::string& modelPath)
 
 	// Set the model
 	m_ModelPath = modelPath;
-	GetEngine().GetRenderer().GetModelManager()->RequestReloadModels();
+	RequestReloadModels();
 }
 
 void GameObject::RemoveModel()
@@ -83,7 +93,7 @@ void GameObject::RemoveModel()
 	if (m_ModelPath != "")
 	{
 		m_ModelPath = "";
-		GetEngine().GetRenderer().GetModelManager()->RequestReloadModels();
+		RequestReloadModels();
 	}
 	if (m_AnimationController != nullptr)
 	{
@@ -178,17 +188,30 @@ glm::mat4 GameObject::MakeParentToLocalTransform()
 
 void GameObject::SerializeBase(SerializeArchive& archive)
 {
-	archive.Add(ARCHIVE_VAR(m_PrefabTitle));
-
+	static_assert(HasUniqueFieldNames(GetBaseFieldTable()), "Two fields in the field table have the same name");
+	archive.AddFields(*this, GetBaseFieldTable());
 	m_Transform.Serialize(archive);
-
-	archive.Add(ARCHIVE_VAR(m_ModelPath));
 	if (archive.GetArchiveType() == SerializeArchiveType::LOAD_DATA)
 	{
 		if (!m_ModelPath.empty())
 		{
 			SetModel(m_ModelPath);
-			GetEngine().GetRenderer().GetModelManager()->RequestReloadModels();
+			RequestReloadModels();
 		}
 	}
-}
\ No newline at end of file
+}
+
+void GameObject::FixUpPrefabCopy()
+{
+	m_ParentedObject = nullptr;
+	m_LastChildObject = nullptr;
+	m_PreviousSiblingObject = nullptr;
+	m_NextSiblingObject = nullptr;
+	m_AnimationController = nullptr;
+
+	// Loading sets the model, the copy has the path already but the models still have to be reloaded
+	if (!m_ModelPath.empty())
+		RequestReloadModels();
+
+	OnCopiedFromPrefab();
+}
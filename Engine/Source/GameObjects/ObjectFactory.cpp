@@ -1,22 +1,35 @@
 #include "GameObjects/Serialization/ObjectFactory.h"
+#include "GameObjects/GameObject.h"
 
 using namespace Ball;
 
-GameObject* ObjectFactory::CreateObject(const std::string& TypeName)
+GameObject* ObjectFactory::CreateObject(std::string_view TypeName)
 {
 	auto& registeredTypes = GetInstance().m_ObjectCreationFunctions;
 
-	const auto object = registeredTypes.find(TypeName);
+	const auto object = registeredTypes.find(StringId(TypeName));
 
 	ASSERT_MSG(LOG_GAMEOBJECTS,
 			   (object != registeredTypes.end()),
-			   "Tried to get an unregistered game object type (\"%s\").",
-			   TypeName.c_str());
+			   "Tried to get an unregistered game object type (\"%.*s\").",
+			   static_cast<int>(TypeName.size()),
+			   TypeName.data());
 
 	return object->second();
 }
 
-bool ObjectFactory::Contains(const char* TypeName)
+GameObject* ObjectFactory::CloneObject(GameObject& source)
+{
+	auto& cloneFunctions = GetInstance().m_ObjectCloneFunctions;
+
+	const auto cloneFunction = cloneFunctions.find(StringId(source.GetTypeName()));
+	if (cloneFunction == cloneFunctions.end())
+		return nullptr;
+
+	return cloneFunction->second(source);
+}
+
+bool ObjectFactory::Contains(StringId TypeName)
 {
 	return GetInstance().m_ObjectCreationFunctions.find(TypeName) != GetInstance().m_ObjectCreationFunctions.end();
 }
\ No newline at end of file
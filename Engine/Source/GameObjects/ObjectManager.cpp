@@ -25,7 +25,9 @@ namespace Ball
 		m_Objects.emplace_back(std::move(targetObject));
 		m_Objects[m_Objects.size() - 1]->Init();
 
-		GetEngine().GetRenderer().GetModelManager()->RequestReloadModels();
+		// Headless runs don't initialize the renderer, so there is no model manager
+		if (ModelManager* modelManager = GetEngine().GetRenderer().GetModelManager())
+			modelManager->RequestReloadModels();
 	}
 
 	std::unique_ptr<GameObject> ObjectManager::RemoveOwnership(GameObject* targetObject)
@@ -38,6 +40,7 @@ namespace Ball
 
 				m_Objects[i]->RemoveModel();
 				m_Objects[i]->Shutdown();
+				m_SpatialIndex.Remove(targetObject);
 
 				std::unique_ptr<GameObject> obj = std::move(m_Objects[i]);
 				obj->SetModel(modelPath);
@@ -57,6 +60,7 @@ namespace Ball
 			{
 				m_Objects[i]->Shutdown();
 				m_Objects[i]->RemoveModel();
+				m_SpatialIndex.Remove(object);
 				m_Objects.erase(m_Objects.begin() + i);
 				return;
 			}
@@ -74,12 +78,19 @@ namespace Ball
 
 		m_Objects.clear();
 		m_Objects.shrink_to_fit();
+		m_SpatialIndex.Clear();
 	}
 
 	void ObjectManager::Update(float deltaTime)
 	{
-		// Update animations
-		GetEngine().GetRenderer().GetModelManager()->UpdateAnimations();
+		m_SpatialIndex.Update(*this);
+
+		// Update animations, throttled for objects that were off-screen or far away last frame
+		if (ModelManager* modelManager = GetEngine().GetRenderer().GetModelManager())
+		{
+			modelManager->UpdateVisibility();
+			modelManager->UpdateAnimations(deltaTime);
+		}
 
 		for (int i = 0; i < m_Objects.size(); i++)
 		{
@@ -0,0 +1,94 @@
+#include "GameObjects/Serialization/PrefabCache.h"
+
+#include "GameObjects/GameObject.h"
+#include "GameObjects/Serialization/ObjectFactory.h"
+#include "GameObjects/Serialization/ObjectSerializer.h"
+#include "GameObjects/Serialization/PrefabReader.h"
+#include "Utilities/LaunchParameters.h"
+#include "FileIO.h"
+#include "Log.h"
+
+using namespace Ball;
+
+PrefabCache::PrefabCache() : m_Enabled(!LaunchParameters::Contains("DisablePrefabCache"))
+{
+}
+
+PrefabCache::~PrefabCache()
+{
+	Clear();
+}
+
+GameObject* PrefabCache::Instantiate(const std::string& prefabPath)
+{
+	if (!m_Enabled)
+		return ObjectSerializer::LoadPrefab(prefabPath);
+
+	const auto cached = m_Templates.find(prefabPath);
+	if (cached != m_Templates.end())
+	{
+		if (cached->second == nullptr)
+			return ObjectSerializer::LoadPrefab(prefabPath);
+
+		GameObject* object = ObjectFactory::CloneObject(*cached->second);
+		object->FixUpPrefabCopy();
+		return object;
+	}
+
+	// The first object is loaded from the prefab data and kept, the caller gets a copy
+	GameObject* prefabObject = ObjectSerializer::LoadPrefab(prefabPath);
+	GameObject* object = ObjectFactory::CloneObject(*prefabObject);
+	if (object == nullptr)
+	{
+		INFO(LOG_SERIALIZER,
+			 "Prefab %s can't be cached, type %s has no copy constructor",
+			 prefabPath.c_str(),
+			 prefabObject->GetTypeName());
+		m_Templates.emplace(prefabPath, nullptr);
+		return prefabObject;
+	}
+
+	m_Templates.emplace(prefabPath, prefabObject);
+	object->FixUpPrefabCopy();
+
+	const std::string prefabFile = prefabPath + ".json";
+	const std::string fullPath = FileIO::GetPath(FileIO::DirectoryType::Prefabs, prefabFile);
+	if (m_WatchedFiles.find(fullPath) == m_WatchedFiles.end())
+	{
+		m_WatchedFiles.emplace(fullPath, prefabPath);
+		AddFileWatch(FileIO::DirectoryType::Prefabs, prefabFile);
+	}
+
+	return object;
+}
+
+void PrefabCache::Invalidate(const std::string& prefabPath)
+{
+	// The file watch stays, this can be called while the file watch system is iterating its listeners
+	const auto cached = m_Templates.find(prefabPath);
+	if (cached == m_Templates.end())
+		return;
+
+	delete cached->second;
+	m_Templates.erase(cached);
+}
+
+void PrefabCache::Clear()
+{
+	for (auto& [prefabPath, prefabObject] : m_Templates)
+		delete prefabObject;
+	m_Templates.clear();
+	m_WatchedFiles.clear();
+	ResetFileWatch();
+}
+
+void PrefabCache::OnFileWatchEvent(const std::string& path)
+{
+	const auto watchedFile = m_WatchedFiles.find(path);
+	if (watchedFile == m_WatchedFiles.end())
+		return;
+
+	LOG(LOG_SERIALIZER, "Prefab %s changed, reloading it", watchedFile->second.c_str());
+	PrefabReader::ReloadPrefab(watchedFile->second);
+	Invalidate(watchedFile->second);
+}
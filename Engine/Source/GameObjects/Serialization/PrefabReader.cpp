@@ -8,57 +8,76 @@ namespace Ball
 {
 	void PrefabReader::RegisterPrefab(const std::string& prefabFilePath)
 	{
-		if (m_Prefabs.find(prefabFilePath) != m_Prefabs.end())
+		const StringId prefabId = StringId::Intern(prefabFilePath);
+		if (m_Prefabs.find(prefabId) != m_Prefabs.end())
 			return;
 
+		std::unique_ptr<PrefabData> prefabData = std::make_unique<PrefabData>();
+		if (!ReadPrefabFile(prefabFilePath, *prefabData))
+			return;
+
+		m_Prefabs.emplace(prefabId, std::move(prefabData));
+	}
+
+	void PrefabReader::ReloadPrefab(const std::string& prefabFilePath)
+	{
+		auto prefab = m_Prefabs.find(StringId(prefabFilePath));
+		if (prefab == m_Prefabs.end())
+		{
+			RegisterPrefab(prefabFilePath);
+			return;
+		}
+
+		// Read into a copy, a broken file keeps the old data
+		PrefabData prefabData;
+		if (ReadPrefabFile(prefabFilePath, prefabData))
+			*prefab->second = std::move(prefabData);
+	}
+
+	bool PrefabReader::ReadPrefabFile(const std::string& prefabFilePath, PrefabData& prefabData)
+	{
 		std::string prefabFileName = prefabFilePath + ".json";
 		if (!FileIO::Exist(FileIO::DirectoryType::Prefabs, prefabFileName))
 		{
 			ERROR("Serializer", "Prefab file %s not found", prefabFileName.c_str());
-			return;
+			return false;
 		}
 
 		nlohmann::ordered_json prefabFileData =
-			nlohmann::json::parse(FileIO::Read(FileIO::DirectoryType::Prefabs, prefabFileName));
-		if (prefabFileData.size() <= 0)
+			nlohmann::json::parse(FileIO::Read(FileIO::DirectoryType::Prefabs, prefabFileName), nullptr, false);
+		if (prefabFileData.is_discarded() || prefabFileData.size() <= 0)
 		{
 			ERROR("Serializer", "Failed to read prefab file %s. Is this file empty?", prefabFileName.c_str());
-			return;
+			return false;
 		}
 
-		std::unique_ptr<PrefabData> prefabData = std::make_unique<PrefabData>();
-		prefabData->m_PrefabPath = prefabFilePath;
-		prefabData->m_DisplayName = prefabFileData["DisplayName"];
-		prefabData->m_Description = prefabFileData["Description"];
-		prefabData->m_ThumbnailPath = prefabFileData["ThumbnailImage"];
-		prefabData->m_ObjectType = prefabFileData["Type"];
-		prefabData->m_LevelCost = prefabFileData["Cost"];
-		prefabData->m_IncludeInPrefabBrowser = prefabFileData["IncludeInPrefabBrowser"];
-		prefabData->m_ObjectData = prefabFileData["ObjectData"];
+		prefabData.m_PrefabPath = prefabFilePath;
+		prefabData.m_DisplayName = prefabFileData["DisplayName"];
+		prefabData.m_Description = prefabFileData["Description"];
+		prefabData.m_ThumbnailPath = prefabFileData["ThumbnailImage"];
+		prefabData.m_ObjectType = prefabFileData["Type"];
+		prefabData.m_LevelCost = prefabFileData["Cost"];
+		prefabData.m_IncludeInPrefabBrowser = prefabFileData["IncludeInPrefabBrowser"];
+		prefabData.m_ObjectData = prefabFileData["ObjectData"];
 
 		if (prefabFileData.contains("ObjectData"))
 		{
 			const auto& objectJsonData = prefabFileData["ObjectData"];
 			// Set model path
 			if (objectJsonData.contains("ModelPath"))
-				prefabData->m_ModelPath = objectJsonData["ModelPath"];
+				prefabData.m_ModelPath = objectJsonData["ModelPath"];
 			else
 				INFO(LOG_SERIALIZER, "Prefab %s does not have a model path.", prefabFilePath.c_str());
 		}
 
 		// Inject path
-		prefabData->m_ObjectData.push_back({"m_PrefabPath", prefabFilePath});
-
-		m_Prefabs.emplace(prefabFilePath, std::move(prefabData));
+		prefabData.m_ObjectData.push_back({"m_PrefabPath", prefabFilePath});
+		return true;
 	}
 
 	void PrefabData::SerializePrefabInfo(SerializeArchive& archive)
 	{
-		archive.Add(ARCHIVE_VAR(m_DisplayName));
-		archive.Add(ARCHIVE_VAR(m_Description));
-		archive.Add(ARCHIVE_VAR(m_ThumbnailPath));
-		archive.Add(ARCHIVE_VAR(m_LevelCost));
-		archive.Add(ARCHIVE_VAR(m_DisplayName));
+		archive.AddFields(*this);
 	}
 
 	std::vector<PrefabData> PrefabReader::GetListOfPrefabs()
@@ -113,17 +132,18 @@ namespace Ball
 		return prefabsList;
 	}
 
-	PrefabData* PrefabReader::GetPrefabData(const std::string& prefabName)
+	PrefabData* PrefabReader::GetPrefabData(std::string_view prefabName)
 	{
 		if (m_Prefabs.empty())
 			Initialize();
 
-		auto data = m_Prefabs.find(prefabName);
+		auto data = m_Prefabs.find(StringId(prefabName));
 
 		ASSERT_MSG(LOG_SERIALIZER,
 				   data != m_Prefabs.end(),
-				   "Attempted to load a prefab that doesn't exist: %s",
-				   prefabName.c_str());
+				   "Attempted to load a prefab that doesn't exist: %.*s",
+				   static_cast<int>(prefabName.size()),
+				   prefabName.data());
 
 		if (data == m_Prefabs.end())
 			return nullptr;
@@ -0,0 +1,127 @@
+#include "GameObjects/SpatialIndex.h"
+
+#include "GameObjects/ObjectManager.h"
+#include "Rendering/ModelLoading/Model.h"
+#include "ResourceManager/ResourceManager.h"
+#include "Utilities/CpuProfiler.h"
+
+using namespace Ball;
+
+void SpatialIndex::Update(ObjectManager& objectManager)
+{
+	PROFILE_CPU_ZONE("Spatial index");
+
+	for (GameObject* object : objectManager)
+	{
+		const std::string& modelPath = object->GetModelPath();
+		const Model* model = nullptr;
+		if (!modelPath.empty() && ResourceManager<Model>::IsLoaded(modelPath))
+			model = ResourceManager<Model>::Get(modelPath).Get();
+
+		if (model == nullptr || !model->GetBounds().IsValid())
+		{
+			Remove(object);
+			continue;
+		}
+
+		Transform& transform = object->GetTransform();
+		const uint32_t transformVersion = transform.GetVersion();
+
+		const auto found = m_Entries.find(object);
+		if (found != m_Entries.end() && found->second.m_TransformVersion == transformVersion &&
+			found->second.m_Model == model)
+			continue;
+
+		// Same box the model manager culls with
+		const AABB bounds = model->GetBounds().Transformed(transform.GetModelMatrix());
+		if (found == m_Entries.end())
+		{
+			m_Entries[object] = {m_Tree.CreateProxy(bounds, object), transformVersion, model};
+			continue;
+		}
+
+		Entry& entry = found->second;
+		const glm::vec3 displacement = bounds.GetCenter() - m_Tree.GetBounds(entry.m_ProxyId).GetCenter();
+		m_Tree.MoveProxy(entry.m_ProxyId, bounds, displacement);
+		entry.m_TransformVersion = transformVersion;
+		entry.m_Model = model;
+	}
+}
+
+void SpatialIndex::Remove(const GameObject* object)
+{
+	const auto found = m_Entries.find(object);
+	if (found == m_Entries.end())
+		return;
+
+	m_Tree.DestroyProxy(found->second.m_ProxyId);
+	m_Entries.erase(found);
+}
+
+void SpatialIndex::Clear()
+{
+	m_Tree.Clear();
+	m_Entries.clear();
+}
+
+const AABB* SpatialIndex::GetObjectBounds(const GameObject* object) const
+{
+	const auto found = m_Entries.find(object);
+	return found == m_Entries.end() ? nullptr : &m_Tree.GetBounds(found->second.m_ProxyId);
+}
+
+void SpatialIndex::QueryOverlap(const AABB& box, std::vector<GameObject*>& result) const
+{
+	m_Tree.QueryOverlap(box,
+						[&](int32_t proxyId)
+						{
+							result.push_back(m_Tree.GetGameObject(proxyId));
+							return true;
+						});
+}
+
+void SpatialIndex::QueryRadius(const glm::vec3& center, float radius, std::vector<GameObject*>& result) const
+{
+	m_Tree.QueryRadius(center,
+					   radius,
+					   [&](int32_t proxyId)
+					   {
+						   result.push_back(m_Tree.GetGameObject(proxyId));
+						   return true;
+					   });
+}
+
+void SpatialIndex::QueryFrustum(const CullingFrustum& frustum, std::vector<GameObject*>& result) const
+{
+	m_Tree.QueryFrustum(frustum,
+						[&](int32_t proxyId)
+						{
+							result.push_back(m_Tree.GetGameObject(proxyId));
+							return true;
+						});
+}
+
+GameObject* SpatialIndex::RayCast(const glm::vec3& origin,
+								  const glm::vec3& direction,
+								  float maxDistance,
+								  float* hitDistance) const
+{
+	GameObject* closest = nullptr;
+	float closestDistance = maxDistance;
+	m_Tree.RayCast(origin,
+				   direction,
+				   maxDistance,
+				   [&](int32_t proxyId, float distance)
+				   {
+					   if (distance <= closestDistance)
+					   {
+						   closest = m_Tree.GetGameObject(proxyId);
+						   closestDistance = distance;
+					   }
+					   return closestDistance;
+				   });
+
+	if (closest != nullptr && hitDistance != nullptr)
+		*hitDistance = closestDistance;
+	return closest;
+}
@@ -32,7 +32,7 @@ void Ball::Camera::Update(float deltaTime)
 
 void Ball::Camera::Serialize(SerializeArchive& archive)
 {
-	archive.Add(ARCHIVE_VAR(m_FOV));
+	archive.AddFields(*this);
 	if (archive.GetArchiveType() == SerializeArchiveType::LOAD_DATA)
 		SetActiveCamera(this);
 }
@@ -56,7 +56,12 @@ glm::mat4 Ball::Camera::GetGameplaySkyboxRotMat()
 void Ball::Camera::UpdateCamera(uint32_t screenWidth, uint32_t screenHeight)
 {
 	m_AspectRatio = static_cast<float>(screenWidth) / static_cast<float>(screenHeight);
+	m_ImagePlanePos = CalculateImagePlanePos();
+	m_ViewPyramid = CalculateViewPyramid(m_ImagePlanePos);
+}
 
+glm::vec3 Ball::Camera::CalculateImagePlanePos()
+{
 	const glm::vec3 viewDirection = m_Transform.Forward();
 	const glm::vec3 right = m_Transform.Right();
 	const glm::vec3 up = m_Transform.Up();
@@ -64,26 +69,41 @@ void Ball::Camera::UpdateCamera(uint32_t screenWidth, uint32_t screenHeight)
 	const float left = m_AspectRatio * 0.5f;
 	constexpr float top = 0.5f;
 	const float m_Dist = 0.5f / tan(m_FOV * glm::pi<float>() / 360.f);
-	m_ImagePlanePos = m_Dist * viewDirection - left * right + top * up;
+	return m_Dist * viewDirection - left * right + top * up;
+}
+
+ViewPyramid Ball::Camera::CalculateViewPyramid(const glm::vec3& imagePlanePos)
+{
+	const glm::vec3 right = m_Transform.Right();
+	const glm::vec3 up = m_Transform.Up();
 
 	// Calculate direction vectors for the view pyramid
-	const glm::vec3 topLeft = normalize(m_ImagePlanePos);
-	const glm::vec3 topRight = normalize(m_ImagePlanePos + right * m_AspectRatio);
-	const glm::vec3 bottomLeft = normalize(m_ImagePlanePos - up);
-	const glm::vec3 bottomRight = normalize(m_ImagePlanePos + right * m_AspectRatio - up);
+	const glm::vec3 topLeft = normalize(imagePlanePos);
+	const glm::vec3 topRight = normalize(imagePlanePos + right * m_AspectRatio);
+	const glm::vec3 bottomLeft = normalize(imagePlanePos - up);
+	const glm::vec3 bottomRight = normalize(imagePlanePos + right * m_AspectRatio - up);
 
+	ViewPyramid pyramid;
 	// Calculate planes values
 	// Calculate the top plane
-	m_ViewPyramid.m_TopPlane = CalculatePlane(topLeft, topRight, -up);
+	pyramid.m_TopPlane = CalculatePlane(topLeft, topRight, -up);
 
 	// Calculate the bottom plane
-	m_ViewPyramid.m_BotPlane = CalculatePlane(bottomLeft, bottomRight, up);
+	pyramid.m_BotPlane = CalculatePlane(bottomLeft, bottomRight, up);
 
 	// Calculate the left plane
-	m_ViewPyramid.m_LeftPlane = CalculatePlane(topLeft, bottomLeft, right);
+	pyramid.m_LeftPlane = CalculatePlane(topLeft, bottomLeft, right);
 
 	// Calculate the right plane
-	m_ViewPyramid.m_RightPlane = CalculatePlane(topRight, bottomRight, -right);
+	pyramid.m_RightPlane = CalculatePlane(topRight, bottomRight, -right);
+	return pyramid;
+}
+
+Ball::CullingFrustum Ball::Camera::GetCullingFrustum()
+{
+	// Doesn't touch m_ViewPyramid, that one has to stay the pyramid of the last rendered frame
+	return CullingFrustum::FromViewPyramid(
+		CalculateViewPyramid(CalculateImagePlanePos()), m_Transform.GetPosition(), m_FarPlane);
 }
 
 glm::mat4 Ball::Camera::GetProjection()
@@ -110,6 +130,8 @@ CameraGPU Ball::Camera::GetGPUCam(uint32_t screenWidth, uint32_t screenHeight)
 	gpu_cam.m_yAxis = float4(yAxis.x, yAxis.y, yAxis.z, 1.0);
 	gpu_cam.m_ScreenHeight = screenHeight;
 	gpu_cam.m_ScreenWidth = screenWidth;
-	gpu_cam.m_PrimaryConeSpreadAngle = glm::radians(m_FOV / float(screenHeight));
+	// Angle of one pixel at the center of the screen, Ray Tracing Gems chapter 20 equation 30
+	gpu_cam.m_PrimaryConeSpreadAngle =
+		glm::atan(2.f * glm::tan(glm::radians(m_FOV) * 0.5f) / static_cast<float>(screenHeight));
 	return gpu_cam;
 }
\ No newline at end of file
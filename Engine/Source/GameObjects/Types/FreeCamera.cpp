@@ -40,6 +40,12 @@ void Ball::FreeCamera::Init()
 		cam_yaw.AddStickBind(RIGHTX);
 		cam_yaw.AddKeyBind(KEY_LEFT, KEY_RIGHT);
 		cam_yaw.DeadZone(0.15f);
+
+		m_XAxis = input.GetAxisId("Free_Camera_X_Axis");
+		m_YAxis = input.GetAxisId("Free_Camera_Y_Axis");
+		m_ZAxis = input.GetAxisId("Free_Camera_Z_Axis");
+		m_PitchAxis = input.GetAxisId("Free_Camera_Pitch");
+		m_YawAxis = input.GetAxisId("Free_Camera_Yaw");
 	}
 }
 
@@ -55,11 +61,11 @@ void Ball::FreeCamera::Update(float deltaTime)
 
 	// Get input instance and check for camera input values
 	auto& input = GetEngine().GetInput();
-	const auto cam_x = input.GetAxis("Free_Camera_X_Axis");
-	const auto cam_y = input.GetAxis("Free_Camera_Y_Axis");
-	const auto cam_z = input.GetAxis("Free_Camera_Z_Axis");
-	const auto cam_pitch = input.GetAxis("Free_Camera_Pitch");
-	const auto cam_yaw = -input.GetAxis("Free_Camera_Yaw");
+	const auto cam_x = input.GetAxis(m_XAxis);
+	const auto cam_y = input.GetAxis(m_YAxis);
+	const auto cam_z = input.GetAxis(m_ZAxis);
+	const auto cam_pitch = input.GetAxis(m_PitchAxis);
+	const auto cam_yaw = -input.GetAxis(m_YawAxis);
 
 	glm::vec3 moveDirection = glm::vec3();
 	moveDirection += cam_z * m_Transform.Forward();
@@ -97,6 +97,14 @@ void Ball::LevelEditorCamera::Init()
 			camScroll.AddKeyBind(GAMEPAD_L1, GAMEPAD_R1);
 			camScroll.DeadZone(0.15f);
 		}
+
+		m_ForwardAxis = input.GetAxisId("Camera_Forward_Axis");
+		m_RightAxis = input.GetAxisId("Camera_Right_Axis");
+		m_UpAxis = input.GetAxisId("Camera_Up_Axis");
+		m_DownAxis = input.GetAxisId("Camera_Down_Axis");
+		m_PitchAxis = input.GetAxisId("Camera_Pitch");
+		m_YawAxis = input.GetAxisId("Camera_Yaw");
+		m_ScrollAxis = input.GetAxisId("Mouse_ScrollWheel");
 	}
 }
 
@@ -109,14 +117,18 @@ void Ball::LevelEditorCamera::UpdateMovement(float deltaTime)
 	auto& input = GetEngine().GetInput();
 
 	// If the control button is held down we do not updated the camera movement
-	const bool control = input.GetAction("Control");
+	// The control action is created by the game, so it's looked up the first time it's used
+	if (!m_ControlAction.IsValid())
+		m_ControlAction = input.GetActionId("Control");
+
+	const bool control = input.GetAction(m_ControlAction);
 	if (control)
 		return;
 
-	const auto forwardAxis = input.GetAxis("Camera_Forward_Axis");
-	const auto rightAxis = input.GetAxis("Camera_Right_Axis");
-	const auto upAxis = input.GetAxis("Camera_Up_Axis");
-	const auto downAxis = input.GetAxis("Camera_Down_Axis");
+	const auto forwardAxis = input.GetAxis(m_ForwardAxis);
+	const auto rightAxis = input.GetAxis(m_RightAxis);
+	const auto upAxis = input.GetAxis(m_UpAxis);
+	const auto downAxis = input.GetAxis(m_DownAxis);
 
 	// Camera movement on the X and Z axis is based on the direction the camera is looking.
 	// For the forward axis we only care about the X and Z axis and need to remove the Y axis
@@ -138,9 +150,9 @@ void Ball::LevelEditorCamera::UpdateMovement(float deltaTime)
 void Ball::LevelEditorCamera::UpdateRotation(float deltaTime)
 {
 	auto& input = GetEngine().GetInput();
-	const auto controllerAxisX = input.GetAxis("Camera_Pitch");
-	const auto controllerAxisY = input.GetAxis("Camera_Yaw");
-	const auto mouseScroll = input.GetAxis("Mouse_ScrollWheel");
+	const auto controllerAxisX = input.GetAxis(m_PitchAxis);
+	const auto controllerAxisY = input.GetAxis(m_YawAxis);
+	const auto mouseScroll = input.GetAxis(m_ScrollAxis);
 	const glm::vec2 mouseDelta = input.GetMouseDelta();
 
 	// Zoom in and out using the scroll wheel.
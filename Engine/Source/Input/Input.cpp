@@ -1,15 +1,178 @@
 #include "Input/Input.h"
 
 #include "Engine.h"
+#include "Input/InputRecording.h"
 #include "Log.h"
 #include "Window.h"
 
 #include <algorithm>
+#include <cmath>
 #include <ImGui/imgui.h>
 
 using namespace Ball;
+namespace
+{
+	// Keys the platform updates, so that we don't have to validate if the key exist at runtime.
+	constexpr KeyCode KNOWN_KEYS[] = {
+		KeyCode::MOUSE_L,
+		KeyCode::MOUSE_R,
+		KeyCode::MOUSE_MIDDLE,
+		KeyCode::KEY_BACKSPACE,
+		KeyCode::KEY_TAB,
+		KeyCode::KEY_CLEAR,
+		KeyCode::KEY_ENTER,
+		KeyCode::KEY_SHIFT,
+		KeyCode::KEY_CONTROL,
+		KeyCode::KEY_ALT,
+		KeyCode::KEY_PAUSE,
+		KeyCode::KEY_CAPSLOCK,
+		KeyCode::KEY_ESCAPE,
+		KeyCode::KEY_0,
+		KeyCode::KEY_1,
+		KeyCode::KEY_2,
+		KeyCode::KEY_3,
+		KeyCode::KEY_4,
+		KeyCode::KEY_5,
+		KeyCode::KEY_6,
+		KeyCode::KEY_7,
+		KeyCode::KEY_8,
+		KeyCode::KEY_9,
+		KeyCode::KEY_SPACE,
+		KeyCode::KEY_PAGEUP,
+		KeyCode::KEY_PAGEDOWN,
+		KeyCode::KEY_END,
+		KeyCode::KEY_HOME,
+		KeyCode::KEY_LEFT,
+		KeyCode::KEY_UP,
+		KeyCode::KEY_RIGHT,
+		KeyCode::KEY_DOWN,
+		KeyCode::KEY_SELECT,
+		KeyCode::KEY_PRINT,
+		KeyCode::KEY_PRINTSCREEN,
+		KeyCode::KEY_INSERT,
+		KeyCode::KEY_DELETE,
+		KeyCode::KEY_HELP,
+		KeyCode::KEY_ZERO,
+		KeyCode::KEY_ONE,
+		KeyCode::KEY_TWO,
+		KeyCode::KEY_THREE,
+		KeyCode::KEY_FOUR,
+		KeyCode::KEY_FIVE,
+		KeyCode::KEY_SIX,
+		KeyCode::KEY_SEVEN,
+		KeyCode::KEY_EIGHT,
+		KeyCode::KEY_NINE,
+		KeyCode::KEY_A,
+		KeyCode::KEY_B,
+		KeyCode::KEY_C,
+		KeyCode::KEY_D,
+		KeyCode::KEY_E,
+		KeyCode::KEY_F,
+		KeyCode::KEY_G,
+		KeyCode::KEY_H,
+		KeyCode::KEY_I,
+		KeyCode::KEY_J,
+		KeyCode::KEY_K,
+		KeyCode::KEY_L,
+		KeyCode::KEY_M,
+		KeyCode::KEY_N,
+		KeyCode::KEY_O,
+		KeyCode::KEY_P,
+		KeyCode::KEY_Q,
+		KeyCode::KEY_R,
+		KeyCode::KEY_S,
+		KeyCode::KEY_T,
+		KeyCode::KEY_U,
+		KeyCode::KEY_V,
+		KeyCode::KEY_W,
+		KeyCode::KEY_X,
+		KeyCode::KEY_Y,
+		KeyCode::KEY_Z,
+		KeyCode::KEY_LEFTWINDOWSKEY,
+		KeyCode::KEY_RIGHTWINDOWSKEY,
+		KeyCode::KEY_APPLICATIONSKEY,
+		KeyCode::KEY_SLEEP,
+		KeyCode::KEY_NUMPAD0,
+		KeyCode::KEY_NUMPAD1,
+		KeyCode::KEY_NUMPAD2,
+		KeyCode::KEY_NUMPAD3,
+		KeyCode::KEY_NUMPAD4,
+		KeyCode::KEY_NUMPAD5,
+		KeyCode::KEY_NUMPAD6,
+		KeyCode::KEY_NUMPAD7,
+		KeyCode::KEY_NUMPAD8,
+		KeyCode::KEY_NUMPAD9,
+		KeyCode::KEY_MULTIPLY,
+		KeyCode::KEY_ADD,
+		KeyCode::KEY_SEPERATOR,
+		KeyCode::KEY_SUBTRACT,
+		KeyCode::KEY_DECIMAL,
+		KeyCode::KEY_DIVIDE,
+		KeyCode::KEY_F1,
+		KeyCode::KEY_F2,
+		KeyCode::KEY_F3,
+		KeyCode::KEY_F4,
+		KeyCode::KEY_F5,
+		KeyCode::KEY_F6,
+		KeyCode::KEY_F7,
+		KeyCode::KEY_F8,
+		KeyCode::KEY_F9,
+		KeyCode::KEY_F10,
+		KeyCode::KEY_F11,
+		KeyCode::KEY_F12,
+		KeyCode::KEY_NUMLOCK,
+		KeyCode::KEY_SCROLLLOCK,
+		KeyCode::KEY_LEFTSHIFT,
+		KeyCode::KEY_RIGHTSHIFT,
+		KeyCode::KEY_LEFTCONTROL,
+		KeyCode::KEY_RIGHTCONTOL,
+		KeyCode::KEY_LEFTMENU,
+		KeyCode::KEY_RIGHTMENU,
+		KeyCode::KEY_BROWSERBACK,
+		KeyCode::KEY_BROWSERFORWARD,
+		KeyCode::KEY_BROWSERREFRESH,
+		KeyCode::KEY_BROWSERSTOP,
+		KeyCode::KEY_BROWSERSEARCH,
+		KeyCode::KEY_BROWSERFAVORITES,
+		KeyCode::KEY_BROWSERHOME,
+		KeyCode::KEY_VOLUMEMUTE,
+		KeyCode::KEY_VOLUMEDOWN,
+		KeyCode::KEY_VOLUMEUP,
+		KeyCode::KEY_NEXTTRACK,
+		KeyCode::KEY_PREVIOUSTRACK,
+		KeyCode::KEY_STOPMEDIA,
+		KeyCode::KEY_PLAYPAUSE,
+		KeyCode::GAMEPAD_DPAD_UP,
+		KeyCode::GAMEPAD_DPAD_DOWN,
+		KeyCode::GAMEPAD_DPAD_LEFT,
+		KeyCode::GAMEPAD_DPAD_RIGHT,
+		KeyCode::GAMEPAD_START,
+		KeyCode::GAMEPAD_BACK,
+		KeyCode::GAMEPAD_L3,
+		KeyCode::GAMEPAD_R3,
+		KeyCode::GAMEPAD_L1,
+		KeyCode::GAMEPAD_R1,
+		KeyCode::GAMEPAD_A,
+		KeyCode::GAMEPAD_B,
+		KeyCode::GAMEPAD_X,
+		KeyCode::GAMEPAD_Y,
+		KeyCode::GAMEPAD_L2,
+		KeyCode::GAMEPAD_R2,
+	};
+
+	bool IsKeySet(const KeyBitset& keys, KeyCode key)
+	{
+		return key < NUM_KEY_CODES && keys[key];
+	}
+} // namespace
+
 Input::Input()
 {
+	for (KeyState& keyState : m_KeyStates)
+		keyState = KeyState::NONE;
+	for (const KeyCode key : KNOWN_KEYS)
+		m_KnownKeys.set(key);
+
 	INFO(LOG_INPUT, "Input system got Created...");
 }
 Input::~Input()
@@ -23,168 +186,92 @@ Input::~Input()
 void Input::Init(unsigned short playerIndex)
 {
 	SetController(playerIndex);
-
-	m_AxisValues = {
-		{LEFTX, 0}, {LEFTY, 0}, {RIGHTX, 0}, {RIGHTY, 0}, {L2, 0}, {R2, 0}, {SCROLL_WHEEL, 0}, {SCROLL_WHEEL_H, 0}};
-
-	// KeyState map is initialized here, so that we don't have to validate if the key exist at runtime.
-	m_KeyStates = {
-		{KeyCode::MOUSE_L, KeyState::NONE},
-		{KeyCode::MOUSE_R, KeyState::NONE},
-		{KeyCode::MOUSE_MIDDLE, KeyState::NONE},
-		{KeyCode::KEY_BACKSPACE, KeyState::NONE},
-		{KeyCode::KEY_TAB, KeyState::NONE},
-		{KeyCode::KEY_CLEAR, KeyState::NONE},
-		{KeyCode::KEY_ENTER, KeyState::NONE},
-		{KeyCode::KEY_SHIFT, KeyState::NONE},
-		{KeyCode::KEY_CONTROL, KeyState::NONE},
-		{KeyCode::KEY_ALT, KeyState::NONE},
-		{KeyCode::KEY_PAUSE, KeyState::NONE},
-		{KeyCode::KEY_CAPSLOCK, KeyState::NONE},
-		{KeyCode::KEY_ESCAPE, KeyState::NONE},
-		{KeyCode::KEY_0, KeyState::NONE},
-		{KeyCode::KEY_1, KeyState::NONE},
-		{KeyCode::KEY_2, KeyState::NONE},
-		{KeyCode::KEY_3, KeyState::NONE},
-		{KeyCode::KEY_4, KeyState::NONE},
-		{KeyCode::KEY_5, KeyState::NONE},
-		{KeyCode::KEY_6, KeyState::NONE},
-		{KeyCode::KEY_7, KeyState::NONE},
-		{KeyCode::KEY_8, KeyState::NONE},
-		{KeyCode::KEY_9, KeyState::NONE},
-		{KeyCode::KEY_SPACE, KeyState::NONE},
-		{KeyCode::KEY_PAGEUP, KeyState::NONE},
-		{KeyCode::KEY_PAGEDOWN, KeyState::NONE},
-		{KeyCode::KEY_END, KeyState::NONE},
-		{KeyCode::KEY_HOME, KeyState::NONE},
-		{KeyCode::KEY_LEFT, KeyState::NONE},
-		{KeyCode::KEY_UP, KeyState::NONE},
-		{KeyCode::KEY_RIGHT, KeyState::NONE},
-		{KeyCode::KEY_DOWN, KeyState::NONE},
-		{KeyCode::KEY_SELECT, KeyState::NONE},
-		{KeyCode::KEY_PRINT, KeyState::NONE},
-		{KeyCode::KEY_PRINTSCREEN, KeyState::NONE},
-		{KeyCode::KEY_INSERT, KeyState::NONE},
-		{KeyCode::KEY_DELETE, KeyState::NONE},
-		{KeyCode::KEY_HELP, KeyState::NONE},
-		{KeyCode::KEY_ZERO, KeyState::NONE},
-		{KeyCode::KEY_ONE, KeyState::NONE},
-		{KeyCode::KEY_TWO, KeyState::NONE},
-		{KeyCode::KEY_THREE, KeyState::NONE},
-		{KeyCode::KEY_FOUR, KeyState::NONE},
-		{KeyCode::KEY_FIVE, KeyState::NONE},
-		{KeyCode::KEY_SIX, KeyState::NONE},
-		{KeyCode::KEY_SEVEN, KeyState::NONE},
-		{KeyCode::KEY_EIGHT, KeyState::NONE},
-		{KeyCode::KEY_NINE, KeyState::NONE},
-		{KeyCode::KEY_A, KeyState::NONE},
-		{KeyCode::KEY_B, KeyState::NONE},
-		{KeyCode::KEY_C, KeyState::NONE},
-		{KeyCode::KEY_D, KeyState::NONE},
-		{KeyCode::KEY_E, KeyState::NONE},
-		{KeyCode::KEY_F, KeyState::NONE},
-		{KeyCode::KEY_G, KeyState::NONE},
-		{KeyCode::KEY_H, KeyState::NONE},
-		{KeyCode::KEY_I, KeyState::NONE},
-		{KeyCode::KEY_J, KeyState::NONE},
-		{KeyCode::KEY_K, KeyState::NONE},
-		{KeyCode::KEY_L, KeyState::NONE},
-		{KeyCode::KEY_M, KeyState::NONE},
-		{KeyCode::KEY_N, KeyState::NONE},
-		{KeyCode::KEY_O, KeyState::NONE},
-		{KeyCode::KEY_P, KeyState::NONE},
-		{KeyCode::KEY_Q, KeyState::NONE},
-		{KeyCode::KEY_R, KeyState::NONE},
-		{KeyCode::KEY_S, KeyState::NONE},
-		{KeyCode::KEY_T, KeyState::NONE},
-		{KeyCode::KEY_U, KeyState::NONE},
-		{KeyCode::KEY_V, KeyState::NONE},
-		{KeyCode::KEY_W, KeyState::NONE},
-		{KeyCode::KEY_X, KeyState::NONE},
-		{KeyCode::KEY_Y, KeyState::NONE},
-		{KeyCode::KEY_Z, KeyState::NONE},
-		{KeyCode::KEY_LEFTWINDOWSKEY, KeyState::NONE},
-		{KeyCode::KEY_RIGHTWINDOWSKEY, KeyState::NONE},
-		{KeyCode::KEY_APPLICATIONSKEY, KeyState::NONE},
-		{KeyCode::KEY_SLEEP, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD0, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD1, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD2, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD3, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD4, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD5, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD6, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD7, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD8, KeyState::NONE},
-		{KeyCode::KEY_NUMPAD9, KeyState::NONE},
-		{KeyCode::KEY_MULTIPLY, KeyState::NONE},
-		{KeyCode::KEY_ADD, KeyState::NONE},
-		{KeyCode::KEY_SEPERATOR, KeyState::NONE},
-		{KeyCode::KEY_SUBTRACT, KeyState::NONE},
-		{KeyCode::KEY_DECIMAL, KeyState::NONE},
-		{KeyCode::KEY_DIVIDE, KeyState::NONE},
-		{KeyCode::KEY_F1, KeyState::NONE},
-		{KeyCode::KEY_F2, KeyState::NONE},
-		{KeyCode::KEY_F3, KeyState::NONE},
-		{KeyCode::KEY_F4, KeyState::NONE},
-		{KeyCode::KEY_F5, KeyState::NONE},
-		{KeyCode::KEY_F6, KeyState::NONE},
-		{KeyCode::KEY_F7, KeyState::NONE},
-		{KeyCode::KEY_F8, KeyState::NONE},
-		{KeyCode::KEY_F9, KeyState::NONE},
-		{KeyCode::KEY_F10, KeyState::NONE},
-		{KeyCode::KEY_F11, KeyState::NONE},
-		{KeyCode::KEY_F12, KeyState::NONE},
-		{KeyCode::KEY_NUMLOCK, KeyState::NONE},
-		{KeyCode::KEY_SCROLLLOCK, KeyState::NONE},
-		{KeyCode::KEY_LEFTSHIFT, KeyState::NONE},
-		{KeyCode::KEY_RIGHTSHIFT, KeyState::NONE},
-		{KeyCode::KEY_LEFTCONTROL, KeyState::NONE},
-		{KeyCode::KEY_RIGHTCONTOL, KeyState::NONE},
-		{KeyCode::KEY_LEFTMENU, KeyState::NONE},
-		{KeyCode::KEY_RIGHTMENU, KeyState::NONE},
-		{KeyCode::KEY_BROWSERBACK, KeyState::NONE},
-		{KeyCode::KEY_BROWSERFORWARD, KeyState::NONE},
-		{KeyCode::KEY_BROWSERREFRESH, KeyState::NONE},
-		{KeyCode::KEY_BROWSERSTOP, KeyState::NONE},
-		{KeyCode::KEY_BROWSERSEARCH, KeyState::NONE},
-		{KeyCode::KEY_BROWSERFAVORITES, KeyState::NONE},
-		{KeyCode::KEY_BROWSERHOME, KeyState::NONE},
-		{KeyCode::KEY_VOLUMEMUTE, KeyState::NONE},
-		{KeyCode::KEY_VOLUMEDOWN, KeyState::NONE},
-		{KeyCode::KEY_VOLUMEUP, KeyState::NONE},
-		{KeyCode::KEY_NEXTTRACK, KeyState::NONE},
-		{KeyCode::KEY_PREVIOUSTRACK, KeyState::NONE},
-		{KeyCode::KEY_STOPMEDIA, KeyState::NONE},
-		{KeyCode::KEY_PLAYPAUSE, KeyState::NONE},
-		{KeyCode::GAMEPAD_DPAD_UP, KeyState::NONE},
-		{KeyCode::GAMEPAD_DPAD_DOWN, KeyState::NONE},
-		{KeyCode::GAMEPAD_DPAD_LEFT, KeyState::NONE},
-		{KeyCode::GAMEPAD_DPAD_RIGHT, KeyState::NONE},
-		{KeyCode::GAMEPAD_START, KeyState::NONE},
-		{KeyCode::GAMEPAD_BACK, KeyState::NONE},
-		{KeyCode::GAMEPAD_L3, KeyState::NONE},
-		{KeyCode::GAMEPAD_R3, KeyState::NONE},
-		{KeyCode::GAMEPAD_L1, KeyState::NONE},
-		{KeyCode::GAMEPAD_R1, KeyState::NONE},
-		{KeyCode::GAMEPAD_A, KeyState::NONE},
-		{KeyCode::GAMEPAD_B, KeyState::NONE},
-		{KeyCode::GAMEPAD_X, KeyState::NONE},
-		{KeyCode::GAMEPAD_Y, KeyState::NONE},
-		{KeyCode::GAMEPAD_L2, KeyState::NONE},
-		{KeyCode::GAMEPAD_R2, KeyState::NONE},
-	};
 }
 
 void Input::Update()
 {
-	m_UpdatedKeys.clear();
+	m_UpdatedKeys.reset();
 	// Get new frame keys
 	GatherInputUpdate();
+
+	bool blockGameplayInput = !GetWindow().IsActive();
+#ifndef NO_IMGUI
+	blockGameplayInput |= ImGui::IsAnyItemActive();
+#endif
+	UpdateActions(blockGameplayInput);
+}
+
+void Input::UpdateSynthetic(const KeyBitset& keysDown, const float (&axisValues)[NUM_JOYSTICKS],
+							const glm::vec2& mouseDelta, bool blockGameplayInput)
+{
+	m_UpdatedKeys.reset();
+	for (unsigned int key = 0; key < NUM_KEY_CODES; key++)
+	{
+		if (m_KnownKeys[key])
+			UpdateKeyState(keysDown[key], static_cast<KeyCode>(key));
+	}
+
+	for (unsigned int stick = 0; stick < NUM_JOYSTICKS; stick++)
+		m_AxisValues[stick] = axisValues[stick];
+	m_AxisValues[JoyStick::JOYSTICK_NONE] = 0.f;
+	m_MouseDelta = mouseDelta;
+
+	UpdateActions(blockGameplayInput);
+}
+
+void Input::UpdateFromRecording(const InputFrame& frame)
+{
+	m_UpdatedKeys.reset();
+	for (const KeyStateChange& change : frame.m_KeyChanges)
+	{
+		assert(change.m_Key < NUM_KEY_CODES);
+		m_KeyStates[change.m_Key] = change.m_State;
+		m_UpdatedKeys.set(change.m_Key);
+	}
+
+	for (unsigned int stick = 0; stick < NUM_JOYSTICKS; stick++)
+		m_AxisValues[stick] = frame.m_AxisValues[stick];
+	m_AxisValues[JoyStick::JOYSTICK_NONE] = 0.f;
+	m_MouseDelta = frame.m_MouseDelta;
+
+	UpdateActions(frame.m_GameplayInputBlocked);
+}
+
+void Input::UpdateActions(bool blockGameplayInput)
+{
+	m_GameplayInputBlocked = blockGameplayInput;
+	for (unsigned int key = 0; key < NUM_KEY_CODES; key++)
+	{
+		const KeyState keyState = m_KeyStates[key];
+		m_HeldKeys[key] = keyState == KeyState::PRESSED || keyState == KeyState::DOWN;
+		m_PressedKeys[key] = keyState == KeyState::PRESSED;
+		m_ReleasedKeys[key] = keyState == KeyState::RELEASED;
+	}
+
+	for (size_t i = 0; i < m_Actions.size(); i++)
+	{
+		const Action& action = m_Actions[i];
+		ActionState& state = m_ActionStates[i];
+		state = {};
+		state.m_Raw = CalculateActionRaw(action);
+		if (blockGameplayInput)
+			continue;
+
+		for (const KeyCode key : action.m_Keys)
+		{
+			state.m_Held |= IsKeySet(m_HeldKeys, key);
+			state.m_Pressed |= IsKeySet(m_PressedKeys, key);
+			state.m_Released |= IsKeySet(m_ReleasedKeys, key);
+		}
+	}
+
+	for (size_t i = 0; i < m_Axes.size(); i++)
+		m_AxisStates[i] = blockGameplayInput ? 0.f : CalculateAxis(m_Axes[i]);
 }
 
 Action::Action(const std::string& n)
 {
+	m_Name = n;
 	for (size_t i = 0; i < m_KeyCount; i++)
 	{
 		m_Keys[i] = KeyCode::NONE;
@@ -222,6 +309,7 @@ Action& Action::RemoveKeyBind(KeyCode key)
 
 void Input::UpdateKeyState(bool KeyDown, KeyCode keyCode)
 {
+	assert(keyCode < NUM_KEY_CODES);
 	auto& key = m_KeyStates[keyCode];
 
 	// Cheap early out
@@ -235,12 +323,12 @@ void Input::UpdateKeyState(bool KeyDown, KeyCode keyCode)
 		{
 		case KeyState::RELEASED:
 		case KeyState::NONE:
-			m_KeyStates[keyCode] = KeyState::PRESSED;
+			key = KeyState::PRESSED;
 			break;
 
 		case KeyState::PRESSED:
 		case KeyState::DOWN:
-			m_KeyStates[keyCode] = KeyState::DOWN;
+			key = KeyState::DOWN;
 			break;
 		}
 	}
@@ -250,17 +338,17 @@ void Input::UpdateKeyState(bool KeyDown, KeyCode keyCode)
 		{
 		case KeyState::PRESSED:
 		case KeyState::DOWN:
-			m_KeyStates[keyCode] = KeyState::RELEASED;
+			key = KeyState::RELEASED;
 			break;
 
 		case KeyState::RELEASED:
 		case KeyState::NONE:
-			m_KeyStates[keyCode] = KeyState::NONE;
+			key = KeyState::NONE;
 			break;
 		}
 	}
 
-	m_UpdatedKeys.insert({keyCode, m_KeyStates[keyCode]});
+	m_UpdatedKeys.set(keyCode);
 }
 
 bool Input::IsControllerKey(KeyCode key)
@@ -275,21 +363,17 @@ bool Input::IsMouseKey(KeyCode key)
 	return key == KeyCode::MOUSE_L || key == KeyCode::MOUSE_MIDDLE || key == KeyCode::MOUSE_R;
 }
 
-KeyState Input::GetActionRaw(const std::string& name) const
+KeyState Input::CalculateActionRaw(const Action& action) const
 {
 	KeyState bestState = KeyState::NONE;
 
-	assert(m_Actions.find(name) != m_Actions.end());
-
-	const auto& action = m_Actions.find(name)->second;
-
 	for (int i = 0; i < action.m_KeyCount; i++)
 	{
 		KeyCode key = action.m_Keys[i];
 		if (key == KeyCode::NONE)
 			continue; // TODO: I think we can break here.
 
-		KeyState keyState = GetInput().GetRawKeyState(key);
+		KeyState keyState = GetRawKeyState(key);
 
 		if (keyState != KeyState::NONE)
 		{
@@ -306,117 +390,16 @@ KeyState Input::GetActionRaw(const std::string& name) const
 	return bestState;
 }
 
-bool Input::GetAction(const std::string& name) const
-{
-	assert(m_Actions.find(name) != m_Actions.end());
-
-	if (!GetWindow().IsActive())
-		return false;
-
-#ifndef NO_IMGUI
-	if (ImGui::IsAnyItemActive())
-		return false;
-#endif
-
-	const auto& action = m_Actions.find(name)->second;
-
-	for (int i = 0; i < action.m_KeyCount; i++)
-	{
-		KeyCode key = action.m_Keys[i];
-		if (key == KeyCode::NONE)
-			continue; // TODO: I think we can break here.
-
-		KeyState keyState = GetInput().GetRawKeyState(key);
-
-		if (keyState == KeyState::PRESSED || keyState == KeyState::DOWN)
-			return true;
-	}
-
-	return false;
-}
-
-bool Input::GetActionDown(const std::string& name) const
+float Input::CalculateAxis(const Axis& axis) const
 {
-	assert(m_Actions.find(name) != m_Actions.end());
-
-	if (!GetWindow().IsActive())
-		return false;
-
-#ifndef NO_IMGUI
-	if (ImGui::IsAnyItemActive())
-		return false;
-#endif
-
-	const auto& action = m_Actions.find(name)->second;
-
-	for (int i = 0; i < action.m_KeyCount; i++)
-	{
-		KeyCode key = action.m_Keys[i];
-		if (key == KeyCode::NONE)
-			continue; // TODO: I think we can break here.
-
-		KeyState keyState = GetInput().GetRawKeyState(key);
-
-		if (keyState == KeyState::PRESSED)
-			return true;
-	}
-
-	return false;
-}
-
-bool Input::GetActionReleased(const std::string& name) const
-{
-	assert(m_Actions.find(name) != m_Actions.end());
-
-	if (!GetWindow().IsActive())
-		return false;
-
-#ifndef NO_IMGUI
-	if (ImGui::IsAnyItemActive())
-		return false;
-#endif
-
-	const auto& action = m_Actions.find(name)->second;
-
-	for (int i = 0; i < action.m_KeyCount; i++)
-	{
-		KeyCode key = action.m_Keys[i];
-		if (key == KeyCode::NONE)
-			continue; // TODO: I think we can break here.
-
-		KeyState keyState = GetInput().GetRawKeyState(key);
-
-		if (keyState == KeyState::RELEASED)
-			return true;
-	}
-
-	return false;
-}
-
-float Input::GetAxis(const std::string& name) const
-{
-	assert(m_Axes.find(name) != m_Axes.end());
-	auto& axis = m_Axes.find(name)->second;
-
-	if (!GetWindow().IsActive())
-		return 0;
-
-#ifndef NO_IMGUI
-	if (ImGui::IsAnyItemActive())
-		return 0;
-#endif
-
 	float m_Value = 0;
 	for (int i = 0; i < 4; i += 2)
 	{
 		if (axis.m_Keys[i] == KeyCode::NONE)
 			break;
 
-		auto keystate = GetInput().GetRawKeyState(axis.m_Keys[i]);
-		bool lKey = keystate == KeyState::PRESSED || keystate == KeyState::DOWN;
-
-		keystate = GetInput().GetRawKeyState(axis.m_Keys[i + 1]);
-		bool rKey = keystate == KeyState::PRESSED || keystate == KeyState::DOWN;
+		const bool lKey = IsKeySet(m_HeldKeys, axis.m_Keys[i]);
+		const bool rKey = IsKeySet(m_HeldKeys, axis.m_Keys[i + 1]);
 
 		m_Value = (rKey - lKey);
 		if (m_Value != 0)
@@ -425,9 +408,9 @@ float Input::GetAxis(const std::string& name) const
 		}
 	}
 
-	m_Value = GetInput().m_AxisValues[axis.m_JoyStick];
+	m_Value = m_AxisValues[axis.m_JoyStick];
 
-	if (abs(m_Value) < axis.GetDeadZone())
+	if (std::abs(m_Value) < axis.GetDeadZone())
 	{
 		m_Value = 0;
 	}
@@ -435,53 +418,111 @@ float Input::GetAxis(const std::string& name) const
 	return m_Value * axis.GetMagnitude();
 }
 
+KeyState Input::GetActionRaw(StringId name) const
+{
+	const ActionId id = GetActionId(name);
+	assert(id.IsValid());
+	return GetActionRaw(id);
+}
+
+bool Input::GetAction(StringId name) const
+{
+	const ActionId id = GetActionId(name);
+	assert(id.IsValid());
+	return GetAction(id);
+}
+
+bool Input::GetActionDown(StringId name) const
+{
+	const ActionId id = GetActionId(name);
+	assert(id.IsValid());
+	return GetActionDown(id);
+}
+
+bool Input::GetActionReleased(StringId name) const
+{
+	const ActionId id = GetActionId(name);
+	assert(id.IsValid());
+	return GetActionReleased(id);
+}
+
+float Input::GetAxis(StringId name) const
+{
+	const AxisId id = GetAxisId(name);
+	assert(id.IsValid());
+	return GetAxis(id);
+}
+
 Axis& Input::CreateAxis(const std::string& name)
 {
 	// Axis already exists
-	assert(m_Axes.find(name) == m_Axes.end());
+	assert(!ContainsAxis(name));
 
-	auto inserted = m_Axes.emplace(name, Axis(name));
-	return inserted.first->second;
+	m_AxisIds.emplace(StringId::Intern(name), AxisId{static_cast<uint32_t>(m_Axes.size())});
+	m_AxisStates.push_back(0.f);
+	return m_Axes.emplace_back(name);
 }
 
-bool Input::ContainsAxis(const std::string& name) const
+bool Input::ContainsAxis(StringId name) const
 {
-	return m_Axes.find(name) != m_Axes.end();
+	return m_AxisIds.find(name) != m_AxisIds.end();
 }
-Axis& Input::GetAxisBinding(const std::string& name)
+
+AxisId Input::GetAxisId(StringId name) const
+{
+	const auto it = m_AxisIds.find(name);
+	return it != m_AxisIds.end() ? it->second : AxisId{};
+}
+
+Axis& Input::GetAxisBinding(StringId name)
 {
-	ASSERT_MSG(LOG_INPUT, !ContainsAxis(name), "Failed to find axis called %s", name.c_str());
+	// Names are only interned when they are created, a missing one can only be reported by its hash
+	ASSERT_MSG(LOG_INPUT,
+			   ContainsAxis(name),
+			   "Failed to find axis with id %016llx",
+			   static_cast<unsigned long long>(name.GetHash()));
 
-	return m_Axes.find(name)->second;
+	return m_Axes[GetAxisId(name).m_Index];
 }
 
 bool Input::GetAnyDown() const
 {
-	return !m_UpdatedKeys.empty();
+	return m_UpdatedKeys.any();
+}
+
+bool Input::ContainsAction(StringId name) const
+{
+	return m_ActionIds.find(name) != m_ActionIds.end();
 }
 
-bool Input::ContainsAction(const std::string& name) const
+ActionId Input::GetActionId(StringId name) const
 {
-	return m_Actions.find(name) != m_Actions.end();
+	const auto it = m_ActionIds.find(name);
+	return it != m_ActionIds.end() ? it->second : ActionId{};
 }
 
-Action& Input::GetActionBinding(const std::string& name)
+Action& Input::GetActionBinding(StringId name)
 {
-	ASSERT_MSG(LOG_INPUT, !ContainsAction(name), "Failed to find axis called %s", name.c_str());
+	ASSERT_MSG(LOG_INPUT,
+			   ContainsAction(name),
+			   "Failed to find action with id %016llx",
+			   static_cast<unsigned long long>(name.GetHash()));
 
-	return m_Actions.find(name)->second;
+	return m_Actions[GetActionId(name).m_Index];
 }
 
 const KeyState& Input::GetRawKeyState(KeyCode key) const
 {
-	return m_KeyStates.at(key);
+	assert(key < NUM_KEY_CODES);
+	return m_KeyStates[key];
 }
 float Input::GetJoystickRaw(JoyStick joyStick) const
 {
-	return m_AxisValues.at(joyStick);
+	assert(joyStick < NUM_JOYSTICKS);
+	return m_AxisValues[joyStick];
 }
 
-const std::unordered_map<KeyCode, KeyState>& Input::GetUpdatedKeys() const
+const KeyBitset& Input::GetUpdatedKeys() const
 {
 	return m_UpdatedKeys;
 }
@@ -546,7 +587,12 @@ float Axis::GetDeadZone() const
 
 Action& Input::CreateAction(const std::string& name)
 {
-	auto inserted = m_Actions.emplace(name, Action(name));
+	// Creating an action twice returns the existing one
+	const auto inserted =
+		m_ActionIds.emplace(StringId::Intern(name), ActionId{static_cast<uint32_t>(m_Actions.size())});
+	if (!inserted.second)
+		return m_Actions[inserted.first->second.m_Index];
 
-	return inserted.first->second;
+	m_ActionStates.emplace_back();
+	return m_Actions.emplace_back(name);
 }
\ No newline at end of file
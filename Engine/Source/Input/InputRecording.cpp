@@ -0,0 +1,298 @@
+#include "Input/InputRecording.h"
+
+#include <cstring>
+
+#include "FileIO.h"
+#include "Log.h"
+#include "Transform.h"
+
+namespace Ball
+{
+	namespace
+	{
+		constexpr uint32_t RECORDING_MAGIC = 0x504E4942; // "BINP"
+		// Version 1 didn't store blocked frames, those recordings replay as if input was never blocked
+		constexpr uint32_t RECORDING_VERSION = 2;
+
+		// Which optional blocks follow the delta time of a frame
+		enum FrameFlags : uint8_t
+		{
+			FRAME_KEYS = 1 << 0,
+			FRAME_MOUSE = 1 << 1,
+			FRAME_AXES = 1 << 2,
+			FRAME_BLOCKED = 1 << 3 // No data, the gameplay input of the frame was blocked
+		};
+
+		static_assert(NUM_KEY_CODES <= 256, "Key codes are stored in a byte");
+		static_assert(NUM_JOYSTICKS <= 16, "Changed axes are stored in a 16 bit mask");
+
+		template<typename T>
+		void Write(std::vector<uint8_t>& data, const T& value)
+		{
+			const size_t offset = data.size();
+			data.resize(offset + sizeof(T));
+			std::memcpy(data.data() + offset, &value, sizeof(T));
+		}
+
+		template<typename T>
+		bool Read(const std::vector<uint8_t>& data, size_t& offset, T& value)
+		{
+			if (data.size() - offset < sizeof(T))
+				return false;
+
+			std::memcpy(&value, data.data() + offset, sizeof(T));
+			offset += sizeof(T);
+			return true;
+		}
+
+		uint64_t HashBytes(const void* bytes, size_t size, uint64_t hash)
+		{
+			const uint8_t* data = static_cast<const uint8_t*>(bytes);
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= data[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+	} // namespace
+
+	InputRecorder::InputRecorder()
+	{
+		Write(m_Data, RECORDING_MAGIC);
+		Write(m_Data, RECORDING_VERSION);
+	}
+
+	void InputRecorder::RecordFrame(const Input& input, float deltaTime)
+	{
+		const KeyBitset& updatedKeys = input.GetUpdatedKeys();
+		const glm::vec2 mouseDelta = input.GetMouseDelta();
+
+		uint16_t changedAxes = 0;
+		float axisValues[NUM_JOYSTICKS];
+		for (unsigned int stick = 0; stick < NUM_JOYSTICKS; stick++)
+		{
+			axisValues[stick] = input.GetJoystickRaw(static_cast<JoyStick>(stick));
+			if (std::memcmp(&axisValues[stick], &m_PreviousAxisValues[stick], sizeof(float)) != 0)
+				changedAxes |= 1 << stick;
+			m_PreviousAxisValues[stick] = axisValues[stick];
+		}
+
+		uint8_t flags = 0;
+		if (updatedKeys.any())
+			flags |= FRAME_KEYS;
+		if (mouseDelta != glm::vec2(0.f))
+			flags |= FRAME_MOUSE;
+		if (changedAxes != 0)
+			flags |= FRAME_AXES;
+		if (input.IsGameplayInputBlocked())
+			flags |= FRAME_BLOCKED;
+
+		Write(m_Data, flags);
+		Write(m_Data, deltaTime);
+
+		if (flags & FRAME_KEYS)
+		{
+			Write(m_Data, static_cast<uint8_t>(updatedKeys.count()));
+			for (unsigned int key = 0; key < NUM_KEY_CODES; key++)
+			{
+				if (!updatedKeys[key])
+					continue;
+
+				Write(m_Data, static_cast<uint8_t>(key));
+				Write(m_Data, static_cast<uint8_t>(input.GetRawKeyState(static_cast<KeyCode>(key))));
+			}
+		}
+
+		if (flags & FRAME_MOUSE)
+		{
+			Write(m_Data, mouseDelta.x);
+			Write(m_Data, mouseDelta.y);
+		}
+
+		if (flags & FRAME_AXES)
+		{
+			Write(m_Data, changedAxes);
+			for (unsigned int stick = 0; stick < NUM_JOYSTICKS; stick++)
+			{
+				if (changedAxes & (1 << stick))
+					Write(m_Data, axisValues[stick]);
+			}
+		}
+
+		m_FrameCount++;
+	}
+
+	bool InputRecorder::Save(const std::string& relativePath) const
+	{
+		if (!FileIO::WriteBinary(FileIO::TempData, relativePath, m_Data.data(), m_Data.size()) ||
+			!FileIO::WriteBinary(FileIO::TempData,
+								 relativePath + ".hashes",
+								 m_StateHashes.data(),
+								 m_StateHashes.size() * sizeof(uint64_t)))
+		{
+			ERROR(LOG_INPUT, "Failed to save input recording to %s", relativePath.c_str());
+			return false;
+		}
+
+		INFO(LOG_INPUT, "Saved %u frames of input to %s", m_FrameCount, relativePath.c_str());
+		return true;
+	}
+
+	bool InputReplay::Load(const std::string& relativePath)
+	{
+		if (!FileIO::Exist(FileIO::TempData, relativePath))
+		{
+			ERROR(LOG_INPUT, "Input recording %s doesn't exist", relativePath.c_str());
+			return false;
+		}
+
+		std::vector<uint8_t> data(FileIO::GetSize(FileIO::TempData, relativePath));
+		if (!FileIO::ReadBinary(
+				FileIO::TempData, relativePath, data.data(), static_cast<std::streamsize>(data.size())))
+		{
+			ERROR(LOG_INPUT, "Failed to read input recording %s", relativePath.c_str());
+			return false;
+		}
+
+		// Without hashes the replay still works, it just can't be verified
+		std::vector<uint64_t> stateHashes;
+		const std::string hashesPath = relativePath + ".hashes";
+		if (FileIO::Exist(FileIO::TempData, hashesPath))
+		{
+			stateHashes.resize(FileIO::GetSize(FileIO::TempData, hashesPath) / sizeof(uint64_t));
+			if (!FileIO::ReadBinary(FileIO::TempData,
+									hashesPath,
+									stateHashes.data(),
+									static_cast<std::streamsize>(stateHashes.size() * sizeof(uint64_t))))
+			{
+				WARN(LOG_INPUT, "Failed to read the state hashes of %s", relativePath.c_str());
+				stateHashes.clear();
+			}
+		}
+
+		return Load(std::move(data), std::move(stateHashes));
+	}
+
+	bool InputReplay::Load(std::vector<uint8_t> data, std::vector<uint64_t> stateHashes)
+	{
+		m_Data = std::move(data);
+		m_StateHashes = std::move(stateHashes);
+		m_ReadOffset = 0;
+		m_FrameCount = 0;
+		m_MismatchCount = 0;
+		m_Frame = {};
+
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		if (!Read(m_Data, m_ReadOffset, magic) || !Read(m_Data, m_ReadOffset, version) ||
+			magic != RECORDING_MAGIC || version == 0 || version > RECORDING_VERSION)
+		{
+			ERROR(LOG_INPUT, "Input recording has an unknown format");
+			m_Data.clear();
+			m_ReadOffset = 0;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool InputReplay::NextFrame()
+	{
+		if (IsFinished())
+			return false;
+
+		if (!ReadFrame(m_Frame))
+		{
+			ERROR(LOG_INPUT, "Input recording is corrupt at frame %u", m_FrameCount);
+			m_ReadOffset = m_Data.size();
+			return false;
+		}
+
+		m_FrameCount++;
+		return true;
+	}
+
+	void InputReplay::ApplyInput(Input& input) const
+	{
+		input.UpdateFromRecording(m_Frame);
+	}
+
+	bool InputReplay::VerifyStateHash(uint64_t hash)
+	{
+		const uint32_t frameIndex = m_FrameCount - 1;
+		if (m_FrameCount == 0 || frameIndex >= m_StateHashes.size() || m_StateHashes[frameIndex] == hash)
+			return true;
+
+		// Only the first one is interesting, after that the states are expected to stay different
+		if (m_MismatchCount++ == 0)
+		{
+			WARN(LOG_INPUT,
+				 "Replay diverged from the recording at frame %u (state hash %016llx, recorded %016llx)",
+				 frameIndex,
+				 static_cast<unsigned long long>(hash),
+				 static_cast<unsigned long long>(m_StateHashes[frameIndex]));
+		}
+		return false;
+	}
+
+	bool InputReplay::ReadFrame(InputFrame& frame)
+	{
+		// Axes are only stored when they changed, the previous values in frame carry over
+		uint8_t flags = 0;
+		if (!Read(m_Data, m_ReadOffset, flags) || !Read(m_Data, m_ReadOffset, frame.m_DeltaTime))
+			return false;
+
+		frame.m_GameplayInputBlocked = (flags & FRAME_BLOCKED) != 0;
+		frame.m_KeyChanges.clear();
+		if (flags & FRAME_KEYS)
+		{
+			uint8_t count = 0;
+			if (!Read(m_Data, m_ReadOffset, count))
+				return false;
+
+			for (uint8_t i = 0; i < count; i++)
+			{
+				uint8_t key = 0;
+				uint8_t state = 0;
+				if (!Read(m_Data, m_ReadOffset, key) || !Read(m_Data, m_ReadOffset, state) || key >= NUM_KEY_CODES ||
+					state > static_cast<uint8_t>(KeyState::RELEASED))
+					return false;
+
+				frame.m_KeyChanges.push_back({static_cast<KeyCode>(key), static_cast<KeyState>(state)});
+			}
+		}
+
+		frame.m_MouseDelta = glm::vec2(0.f);
+		if ((flags & FRAME_MOUSE) &&
+			(!Read(m_Data, m_ReadOffset, frame.m_MouseDelta.x) || !Read(m_Data, m_ReadOffset, frame.m_MouseDelta.y)))
+			return false;
+
+		if (flags & FRAME_AXES)
+		{
+			uint16_t changedAxes = 0;
+			if (!Read(m_Data, m_ReadOffset, changedAxes))
+				return false;
+
+			for (unsigned int stick = 0; stick < NUM_JOYSTICKS; stick++)
+			{
+				if ((changedAxes & (1 << stick)) && !Read(m_Data, m_ReadOffset, frame.m_AxisValues[stick]))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	uint64_t HashTransform(Transform& transform, uint64_t hash)
+	{
+		const glm::vec3& position = transform.GetPosition();
+		const glm::quat& rotation = transform.GetRotation();
+		const glm::vec3& scale = transform.GetScale();
+
+		// Hashes the bits and not the values, a replay has to be bit-identical
+		hash = HashBytes(&position, sizeof(position), hash);
+		hash = HashBytes(&rotation, sizeof(rotation), hash);
+		return HashBytes(&scale, sizeof(scale), hash);
+	}
+} // namespace Ball
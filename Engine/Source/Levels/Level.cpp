@@ -7,8 +7,6 @@
 
 #include "Log.h"
 
-#include "GameObjects/Types/Camera.h"
-#include "GameObjects/Types/Light.h"
 #include "Rendering/Renderer.h"
 
 namespace Ball
@@ -62,49 +60,6 @@ namespace Ball
 		m_ObjectManager->Update(deltaTime);
 	}
 
-	void Level::GetLevelBounds(glm::vec3& min, glm::vec3& max, bool recalculate)
-	{
-		if (recalculate)
-			m_ValidBounds = false;
-
-		if (m_ValidBounds)
-		{
-			min = m_BoundsMin;
-			max = m_BoundsMax;
-			return;
-		}
-
-		// Get bounds of the entire map
-		for (Ball::GameObject* obj : Ball::GetLevel().GetObjectManager())
-		{
-			glm::vec3 pos = obj->GetTransform().GetPosition();
-
-			// Filter out particles as they are not part of the level bounds
-			if (dynamic_cast<Light*>(obj))
-				continue;
-			if (dynamic_cast<Camera*>(obj))
-				continue;
-
-			if (pos.x > m_BoundsMax.x)
-				m_BoundsMax.x = pos.x;
-			if (pos.y > m_BoundsMax.y)
-				m_BoundsMax.y = pos.y;
-			if (pos.z > m_BoundsMax.z)
-				m_BoundsMax.z = pos.z;
-
-			if (pos.x < m_BoundsMin.x)
-				m_BoundsMin.x = pos.x;
-			if (pos.y < m_BoundsMin.y)
-				m_BoundsMin.y = pos.y;
-			if (pos.z < m_BoundsMin.z)
-				m_BoundsMin.z = pos.z;
-		}
-
-		min = m_BoundsMin;
-		max = m_BoundsMax;
-		m_ValidBounds = true;
-	}
-
 	void Level::LoadLevel(const std::string& filePath, const LevelSaveType& type)
 	{
 		LOG(LOG_SERIALIZER, "Loading level data from save file: %s", m_CurrentLevelPath.c_str());
@@ -1,6 +1,7 @@
 #include "Logger/LoggerSystem.h"
 
-#include <filesystem>
+#include <climits>
+#include <cstdio>
 
 #include "Log.h"
 #include <sstream>
@@ -53,21 +54,18 @@ bool LoggerSystem::IsBlocked(ELogLevel Level, const char* Category)
 	if ((m_BlockedLevelMask & Level) != 0)
 		return true; // LogLevel is blocked
 
-	const auto categoryMask = m_BlockedCategories.find(Category);
+	const auto categoryMask = m_BlockedCategories.find(StringId(Category));
 
 	// If catogory doesn't exists create it and mute verbose
 	if (categoryMask == m_BlockedCategories.end())
-	{
-		CreateLogLevel(Category);
-		return (m_BlockedCategories.find(Category)->second & Level) != 0;
-	}
+		return (CreateLogLevel(Category) & Level) != 0;
 
 	return (categoryMask->second & Level) != 0;
 }
 
-void LoggerSystem::CreateLogLevel(const char* Category)
+ELogLevel& LoggerSystem::CreateLogLevel(const char* Category)
 {
-	m_BlockedCategories.insert({Category, ELogLevel::EINFO});
+	return m_BlockedCategories.emplace(StringId::Intern(Category), ELogLevel::EINFO).first->second;
 }
 
 void LoggerSystem::GenerateLogEntry(ELogLevel Level, const char* Category, const char* fileName, int lineNumber,
@@ -80,11 +78,27 @@ void LoggerSystem::GenerateLogEntry(ELogLevel Level, const char* Category, const
 
 	SetColor(Level);
 
-	LogMessage(("[" + GetTimeStampString() + "]").c_str());
-	LogMessage(("[" + std::string(Category) + "]").c_str());
-	LogMessage(
-		("[" + std::filesystem::path(fileName).filename().string() + ":" + std::to_string(lineNumber) + "]").c_str());
-	LogMessage((LogLevelToString(Level) + " ").c_str());
+	// Only the file name without the directories
+	const char* shortFileName = fileName;
+	for (const char* c = fileName; *c != '\0'; c++)
+	{
+		if (*c == '/' || *c == '\\')
+			shortFileName = c + 1;
+	}
+
+	// Formatted on the stack, logging shouldn't allocate a string per part of the entry
+	char timeStamp[32];
+	FormatTimeStamp(timeStamp, sizeof(timeStamp));
+	char header[256];
+	std::snprintf(header,
+				  sizeof(header),
+				  "[%s][%s][%s:%i]%s ",
+				  timeStamp,
+				  Category,
+				  shortFileName,
+				  lineNumber,
+				  LogLevelToString(Level).c_str());
+	LogMessage(header);
 
 	LogMessage(text);
 	SetColor(EALL); // we use all as a "reset" value here
@@ -123,10 +137,10 @@ void LoggerSystem::LogMessage(const char* message)
 	printf("%s", message);
 
 	// Buildup Cache.. will be saved to disk later
-	m_MemLog += std::string(message);
+	m_MemLog += message;
 }
 
-std::string LoggerSystem::GetTimeStampString()
+void LoggerSystem::FormatTimeStamp(char* buffer, size_t bufferSize)
 {
 	// Yes this implementation looks identical to pc.... LocalTime_s parameters are swapped around... thats why its not
 	// the same...
@@ -134,19 +148,15 @@ std::string LoggerSystem::GetTimeStampString()
 	auto currentTime = (std::chrono::system_clock::now());
 	auto startupTime = (GetEngine().GetStartupTime());
 	auto timeDiff = std::chrono::duration<float>(currentTime - startupTime).count();
-	std::ostringstream timeStream;
 
 	//+1 when timeDiff = 60 we want to showcase 1 minute, otherwise it only happens at 61.. idk why
 	int minutes = static_cast<int>((timeDiff + 1) / 60);
 	int seconds = static_cast<int>(std::fmod(timeDiff, 60.0f));
 
-	// Use ostringstream to format the string
 	if (minutes > 0)
-		timeStream << std::setfill('0') << minutes << "m ";
-
-	timeStream << std::setfill('0') << std::setw(2) << seconds << "s";
-
-	return timeStream.str();
+		std::snprintf(buffer, bufferSize, "%im %02is", minutes, seconds);
+	else
+		std::snprintf(buffer, bufferSize, "%02is", seconds);
 }
 
 const std::string& LoggerSystem::LogLevelToString(ELogLevel logLevel)
@@ -162,21 +172,16 @@ const std::string& LoggerSystem::LogLevelToString(ELogLevel logLevel)
 
 void LoggerSystem::SetLogCategory(ELogLevel level, const char* category, bool enabled)
 {
-	auto categoryBlock = m_BlockedCategories.find(category);
-	if (categoryBlock == m_BlockedCategories.end())
-	{
-		CreateLogLevel(category);
-		categoryBlock = m_BlockedCategories.find(category);
-	}
+	const auto categoryBlock = m_BlockedCategories.find(StringId(category));
+	ELogLevel& blocked = categoryBlock != m_BlockedCategories.end() ? categoryBlock->second : CreateLogLevel(category);
 
 	// Idealy we auto disable/enable lower priority categories, but math for it is funky
 	if (enabled)
-		for (ELogLevel i = level; (level <= categoryBlock->second) && categoryBlock->second != NONE;
-			 i = static_cast<ELogLevel>(i << 1))
-			categoryBlock->second = static_cast<ELogLevel>(categoryBlock->second & ~i);
+		for (ELogLevel i = level; (level <= blocked) && blocked != NONE; i = static_cast<ELogLevel>(i << 1))
+			blocked = static_cast<ELogLevel>(blocked & ~i);
 	else
 		for (ELogLevel i = level; i > NONE; i = static_cast<ELogLevel>(i >> 1))
-			categoryBlock->second = static_cast<ELogLevel>(categoryBlock->second | i);
+			blocked = static_cast<ELogLevel>(blocked | i);
 }
 
 void LoggerSystem::SetLogLevel(ELogLevel level, bool enabled)
@@ -2,28 +2,17 @@
 #include "Rendering//ModelLoading/Model.h"
 namespace Ball
 {
-	void AnimationController::Update(float dt)
+	void AnimationController::Update(float dt, bool evaluatePose)
 	{
 		m_AnimDirtyFlag = false;
 		if (!m_Paused && m_Speed != 0.f)
 		{
 			m_Time += m_Speed * (dt);
-			if (m_AnimatedModel != nullptr)
+			if (m_AnimatedModel != nullptr && evaluatePose)
 			{
 				m_AnimatedModel->UpdateAnimations(m_TimeOffset + m_Time);
 				m_AnimDirtyFlag = true;
 			}
 		}
 	}
-
-	void AnimationController::RebuildModelBlas()
-	{
-		if (m_AnimDirtyFlag)
-		{
-			if (m_AnimatedModel != nullptr)
-			{
-				m_AnimatedModel->RebuildBlas();
-			}
-		}
-	}
 } // namespace Ball
\ No newline at end of file
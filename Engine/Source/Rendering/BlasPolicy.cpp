@@ -0,0 +1,185 @@
+#include "Rendering/BlasPolicy.h"
+
+#include <algorithm>
+
+#include "Log.h"
+
+using namespace Ball;
+
+BlasPolicyManager::BlasPolicyManager(const BlasPolicySettings& settings) : m_Settings(settings)
+{
+}
+
+uint32_t BlasPolicyManager::Register(BlasUsage usage, uint32_t triangleCount)
+{
+	uint32_t id = static_cast<uint32_t>(m_Entries.size());
+	if (!m_FreeIds.empty())
+	{
+		id = m_FreeIds.back();
+		m_FreeIds.pop_back();
+	}
+	else
+	{
+		m_Entries.emplace_back();
+	}
+
+	Entry& entry = m_Entries[id];
+	entry = Entry();
+	entry.m_Usage = usage;
+	entry.m_TriangleCount = triangleCount;
+	entry.m_BuildFrame = m_Frame;
+	entry.m_Registered = true;
+	return id;
+}
+
+void BlasPolicyManager::Unregister(uint32_t id)
+{
+	ASSERT_MSG(LOG_GRAPHICS, IsRegistered(id), "Unregistering unknown BLAS %u", id);
+	m_Entries[id].m_Registered = false;
+	m_FreeIds.push_back(id);
+}
+
+void BlasPolicyManager::MarkDeformed(uint32_t id, float degradation)
+{
+	ASSERT_MSG(LOG_GRAPHICS, IsRegistered(id), "Deforming unknown BLAS %u", id);
+	Entry& entry = m_Entries[id];
+	ASSERT_MSG(LOG_GRAPHICS, entry.m_Usage == BlasUsage::DEFORMING, "BLAS %u was registered as static", id);
+	entry.m_Degradation = entry.m_Deformed ? (std::max)(entry.m_Degradation, degradation) : degradation;
+	entry.m_Deformed = true;
+}
+
+float BlasPolicyManager::EstimateMs(BlasOperation operation, uint32_t triangleCount) const
+{
+	float msPerMillion = m_Settings.m_RefitMsPerMillion;
+	if (operation == BlasOperation::REBUILD)
+		msPerMillion = m_Settings.m_RebuildMsPerMillion;
+	else if (operation == BlasOperation::COMPACT)
+		msPerMillion = m_Settings.m_CompactMsPerMillion;
+	return msPerMillion * static_cast<float>(triangleCount) * 1e-6f;
+}
+
+std::vector<BlasTask> BlasPolicyManager::Schedule()
+{
+	m_Frame++;
+	std::vector<BlasTask> tasks;
+	std::vector<uint32_t> rebuilds;
+	std::vector<uint32_t> compactions;
+	float spentMs = 0.f;
+
+	for (uint32_t id = 0; id < static_cast<uint32_t>(m_Entries.size()); id++)
+	{
+		const Entry& entry = m_Entries[id];
+		if (!entry.m_Registered)
+			continue;
+
+		if (entry.m_Usage == BlasUsage::DEFORMING)
+		{
+			if (entry.m_Deformed)
+			{
+				const float ms = EstimateMs(BlasOperation::REFIT, entry.m_TriangleCount);
+				tasks.push_back({id, BlasOperation::REFIT, ms});
+				spentMs += ms;
+			}
+			if (entry.m_Degradation >= m_Settings.m_RebuildThreshold)
+				rebuilds.push_back(id);
+		}
+		else if (!entry.m_Compacted && m_Frame >= entry.m_BuildFrame + m_Settings.m_CompactionDelay)
+		{
+			compactions.push_back(id);
+		}
+	}
+
+	// Most degraded first, compactions in the order their BLASes were built
+	std::stable_sort(rebuilds.begin(),
+					 rebuilds.end(),
+					 [this](uint32_t a, uint32_t b)
+					 { return m_Entries[a].m_Degradation > m_Entries[b].m_Degradation; });
+	std::stable_sort(compactions.begin(),
+					 compactions.end(),
+					 [this](uint32_t a, uint32_t b) { return m_Entries[a].m_BuildFrame < m_Entries[b].m_BuildFrame; });
+
+	bool deferredRan = false;
+	m_Stats.m_DeferredRebuilds = 0;
+	for (uint32_t id : rebuilds)
+	{
+		Entry& entry = m_Entries[id];
+		const float ms = EstimateMs(BlasOperation::REBUILD, entry.m_TriangleCount);
+		// The rebuild takes the place of this frame's refit
+		const float refitMs = entry.m_Deformed ? EstimateMs(BlasOperation::REFIT, entry.m_TriangleCount) : 0.f;
+		if (deferredRan && spentMs - refitMs + ms > m_Settings.m_FrameBudgetMs)
+		{
+			m_Stats.m_DeferredRebuilds++;
+			continue;
+		}
+
+		if (entry.m_Deformed)
+		{
+			tasks.erase(std::find_if(
+				tasks.begin(), tasks.end(), [id](const BlasTask& task) { return task.m_Id == id; }));
+		}
+		tasks.push_back({id, BlasOperation::REBUILD, ms});
+		spentMs += ms - refitMs;
+		deferredRan = true;
+		entry.m_Degradation = 1.f;
+		entry.m_BuildFrame = m_Frame;
+		entry.m_Deformed = false;
+	}
+
+	m_Stats.m_DeferredCompactions = 0;
+	for (uint32_t id : compactions)
+	{
+		const float ms = EstimateMs(BlasOperation::COMPACT, m_Entries[id].m_TriangleCount);
+		if (deferredRan && spentMs + ms > m_Settings.m_FrameBudgetMs)
+		{
+			m_Stats.m_DeferredCompactions++;
+			continue;
+		}
+
+		tasks.push_back({id, BlasOperation::COMPACT, ms});
+		spentMs += ms;
+		deferredRan = true;
+	}
+
+	for (const BlasTask& task : tasks)
+	{
+		if (task.m_Operation == BlasOperation::REFIT)
+		{
+			m_Entries[task.m_Id].m_Deformed = false;
+			m_Stats.m_Refits++;
+		}
+		else if (task.m_Operation == BlasOperation::REBUILD)
+		{
+			m_Stats.m_Rebuilds++;
+		}
+	}
+	m_Stats.m_EstimatedMs = spentMs;
+	return tasks;
+}
+
+void BlasPolicyManager::ReportCompaction(uint32_t id, uint64_t bytesBefore, uint64_t bytesAfter)
+{
+	ASSERT_MSG(LOG_GRAPHICS, IsRegistered(id), "Compacted unknown BLAS %u", id);
+	Entry& entry = m_Entries[id];
+	if (entry.m_Compacted)
+		return;
+
+	entry.m_Compacted = true;
+	m_Stats.m_Compactions++;
+	m_Stats.m_BytesBeforeCompaction += bytesBefore;
+	m_Stats.m_BytesAfterCompaction += (std::min)(bytesAfter, bytesBefore);
+}
+
+bool BlasPolicyManager::IsRegistered(uint32_t id) const
+{
+	return id < m_Entries.size() && m_Entries[id].m_Registered;
+}
+
+float BlasPolicyManager::GetDegradation(uint32_t id) const
+{
+	return IsRegistered(id) ? m_Entries[id].m_Degradation : 1.f;
+}
+
+bool BlasPolicyManager::IsCompacted(uint32_t id) const
+{
+	return IsRegistered(id) && m_Entries[id].m_Compacted;
+}
@@ -1,29 +1,49 @@
 #include "Rendering/BufferManager.h"
 
+#include "Log.h"
+
 namespace Ball
 {
 	Buffer* BufferManager::Create(const void* data, uint32_t stride, uint32_t count, BufferFlags flags,
-								  const std::string& name)
+								  const std::string& name, MemoryTag tag)
 	{
 		const auto buffer = new Buffer(data, stride, count, flags, name);
-		m_Buffers.push_back(buffer);
+		buffer->m_MemoryTag = tag;
+		GetMemoryTracker().Allocate(tag, buffer->GetSizeBytes());
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Buffers.insert(buffer);
 		m_BufferCount++;
 		return buffer;
 	}
 
 	void BufferManager::Destroy(Buffer* buffer)
 	{
-		m_Buffers.remove(buffer);
+		if (buffer == nullptr)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			const size_t numErased = m_Buffers.erase(buffer);
+			ASSERT_MSG(LOG_GRAPHICS, numErased == 1, "Buffer '%s' wasn't created by the BufferManager",
+					   buffer->GetName().c_str());
+			m_BufferCount--;
+		}
+
+		GetMemoryTracker().Free(buffer->GetMemoryTag(), buffer->GetSizeBytes());
 		delete buffer;
-		m_BufferCount--;
 	}
 
 	void BufferManager::DestroyAll()
 	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
 		m_BufferCount = 0;
 
 		for (const auto& buf : m_Buffers)
+		{
+			GetMemoryTracker().Free(buf->GetMemoryTag(), buf->GetSizeBytes());
 			delete buf;
+		}
 
 		m_Buffers.clear();
 	}
@@ -0,0 +1,257 @@
+#include "Rendering/CpuBvh.h"
+
+#include <algorithm>
+
+#include "Log.h"
+
+using namespace Ball;
+
+namespace
+{
+	// Half the surface area, the SAH only compares them
+	float HalfArea(const AABB& box)
+	{
+		if (!box.IsValid())
+			return 0.f;
+		const glm::vec3 size = box.m_Max - box.m_Min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+
+	float TotalTriangleArea(const std::vector<glm::vec3>& vertices)
+	{
+		double area = 0.0;
+		for (size_t i = 0; i + 2 < vertices.size(); i += 3)
+			area += 0.5 * glm::length(glm::cross(vertices[i + 1] - vertices[i], vertices[i + 2] - vertices[i]));
+		return static_cast<float>(area);
+	}
+
+	struct Bin
+	{
+		AABB m_Bounds;
+		uint32_t m_Count = 0;
+	};
+} // namespace
+
+void CpuBvh::Build(const std::vector<glm::vec3>& vertices)
+{
+	ASSERT_MSG(LOG_GRAPHICS,
+			   vertices.size() % 3 == 0,
+			   "CpuBvh expects 3 vertices per triangle, got %zu",
+			   vertices.size());
+	m_Nodes.clear();
+	m_Triangles.clear();
+	m_TriangleArea = 0.f;
+	m_BuildCost = 0.f;
+
+	const uint32_t triangleCount = static_cast<uint32_t>(vertices.size() / 3);
+	if (triangleCount == 0)
+		return;
+
+	std::vector<AABB> triangleBounds(triangleCount);
+	std::vector<glm::vec3> centers(triangleCount);
+	m_Triangles.resize(triangleCount);
+	for (uint32_t i = 0; i < triangleCount; i++)
+	{
+		triangleBounds[i].Grow(vertices[i * 3 + 0]);
+		triangleBounds[i].Grow(vertices[i * 3 + 1]);
+		triangleBounds[i].Grow(vertices[i * 3 + 2]);
+		centers[i] = triangleBounds[i].GetCenter();
+		m_Triangles[i] = i;
+	}
+
+	m_Nodes.reserve(triangleCount * 2 - 1);
+	Node root;
+	root.m_First = 0;
+	root.m_Count = triangleCount;
+	m_Nodes.push_back(root);
+	Subdivide(0, triangleBounds, centers);
+
+	m_TriangleArea = TotalTriangleArea(vertices);
+	m_BuildCost = TriangleRelativeCost();
+}
+
+void CpuBvh::Subdivide(uint32_t rootIndex, const std::vector<AABB>& triangleBounds,
+					   const std::vector<glm::vec3>& centers)
+{
+	std::vector<uint32_t> stack = {rootIndex};
+	while (!stack.empty())
+	{
+		const uint32_t nodeIndex = stack.back();
+		stack.pop_back();
+
+		const uint32_t first = m_Nodes[nodeIndex].m_First;
+		const uint32_t count = m_Nodes[nodeIndex].m_Count;
+		AABB bounds;
+		AABB centerBounds;
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			bounds.Grow(triangleBounds[m_Triangles[i]]);
+			centerBounds.Grow(centers[m_Triangles[i]]);
+		}
+		m_Nodes[nodeIndex].m_Bounds = bounds;
+		if (count <= MAX_LEAF_SIZE)
+			continue;
+
+		// Best bin boundary over all three axes, the split costs are relative to the area of this node
+		const float nodeArea = (std::max)(HalfArea(bounds), FLT_MIN);
+		float bestCost = static_cast<float>(count) * INTERSECTION_COST;
+		int bestAxis = -1;
+		uint32_t bestSplit = 0;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const float extent = centerBounds.m_Max[axis] - centerBounds.m_Min[axis];
+			if (extent <= 0.f)
+				continue;
+
+			Bin bins[BIN_COUNT];
+			const float scale = static_cast<float>(BIN_COUNT) / extent;
+			for (uint32_t i = first; i < first + count; i++)
+			{
+				const uint32_t triangle = m_Triangles[i];
+				const uint32_t bin = (std::min)(
+					static_cast<uint32_t>((centers[triangle][axis] - centerBounds.m_Min[axis]) * scale), BIN_COUNT - 1);
+				bins[bin].m_Bounds.Grow(triangleBounds[triangle]);
+				bins[bin].m_Count++;
+			}
+
+			// Sweep from the right first so the left sweep can price every boundary in one pass
+			float rightArea[BIN_COUNT];
+			uint32_t rightCount[BIN_COUNT];
+			AABB right;
+			uint32_t rightSum = 0;
+			for (uint32_t i = BIN_COUNT - 1; i > 0; i--)
+			{
+				right.Grow(bins[i].m_Bounds);
+				rightSum += bins[i].m_Count;
+				rightArea[i] = HalfArea(right);
+				rightCount[i] = rightSum;
+			}
+
+			AABB left;
+			uint32_t leftSum = 0;
+			for (uint32_t split = 1; split < BIN_COUNT; split++)
+			{
+				left.Grow(bins[split - 1].m_Bounds);
+				leftSum += bins[split - 1].m_Count;
+				if (leftSum == 0 || rightCount[split] == 0)
+					continue;
+
+				const float childCost = HalfArea(left) * static_cast<float>(leftSum) +
+					rightArea[split] * static_cast<float>(rightCount[split]);
+				const float cost = TRAVERSAL_COST + INTERSECTION_COST * childCost / nodeArea;
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = split;
+				}
+			}
+		}
+
+		// No split beats intersecting everything here, or all centers coincide
+		if (bestAxis == -1)
+			continue;
+
+		const float minCenter = centerBounds.m_Min[bestAxis];
+		const float scale = static_cast<float>(BIN_COUNT) / (centerBounds.m_Max[bestAxis] - minCenter);
+		const auto middle = std::partition(m_Triangles.begin() + first,
+										   m_Triangles.begin() + first + count,
+										   [&](uint32_t triangle)
+										   {
+											   const float position = (centers[triangle][bestAxis] - minCenter) * scale;
+											   const uint32_t bin =
+												   (std::min)(static_cast<uint32_t>(position), BIN_COUNT - 1);
+											   return bin < bestSplit;
+										   });
+		const uint32_t leftCount = static_cast<uint32_t>(middle - m_Triangles.begin()) - first;
+
+		const uint32_t leftIndex = static_cast<uint32_t>(m_Nodes.size());
+		Node leftNode;
+		leftNode.m_First = first;
+		leftNode.m_Count = leftCount;
+		Node rightNode;
+		rightNode.m_First = first + leftCount;
+		rightNode.m_Count = count - leftCount;
+		m_Nodes.push_back(leftNode);
+		m_Nodes.push_back(rightNode);
+
+		m_Nodes[nodeIndex].m_First = leftIndex;
+		m_Nodes[nodeIndex].m_Count = 0;
+		stack.push_back(leftIndex);
+		stack.push_back(leftIndex + 1);
+	}
+}
+
+void CpuBvh::FitLeaf(Node& node, const std::vector<glm::vec3>& vertices) const
+{
+	node.m_Bounds = AABB();
+	for (uint32_t i = node.m_First; i < node.m_First + node.m_Count; i++)
+	{
+		const uint32_t triangle = m_Triangles[i];
+		node.m_Bounds.Grow(vertices[triangle * 3 + 0]);
+		node.m_Bounds.Grow(vertices[triangle * 3 + 1]);
+		node.m_Bounds.Grow(vertices[triangle * 3 + 2]);
+	}
+}
+
+void CpuBvh::Refit(const std::vector<glm::vec3>& vertices)
+{
+	ASSERT_MSG(LOG_GRAPHICS,
+			   vertices.size() == m_Triangles.size() * 3,
+			   "CpuBvh was built from %zu triangles, refit got %zu vertices",
+			   m_Triangles.size(),
+			   vertices.size());
+
+	m_TriangleArea = TotalTriangleArea(vertices);
+	// Children are always stored after their parent, so going backwards visits them first
+	for (size_t i = m_Nodes.size(); i-- > 0;)
+	{
+		Node& node = m_Nodes[i];
+		if (node.IsLeaf())
+		{
+			FitLeaf(node, vertices);
+			continue;
+		}
+
+		node.m_Bounds = m_Nodes[node.m_First].m_Bounds;
+		node.m_Bounds.Grow(m_Nodes[node.m_First + 1].m_Bounds);
+	}
+}
+
+float CpuBvh::SAHCost() const
+{
+	if (m_Nodes.empty())
+		return 0.f;
+
+	const float rootArea = HalfArea(m_Nodes[0].m_Bounds);
+	if (rootArea <= 0.f)
+		return INTERSECTION_COST * static_cast<float>(m_Triangles.size());
+
+	float cost = 0.f;
+	for (const Node& node : m_Nodes)
+	{
+		const float area = HalfArea(node.m_Bounds) / rootArea;
+		cost += node.IsLeaf() ? INTERSECTION_COST * static_cast<float>(node.m_Count) * area : TRAVERSAL_COST * area;
+	}
+	return cost;
+}
+
+float CpuBvh::TriangleRelativeCost() const
+{
+	// Flat or degenerate triangles, fall back to the root box
+	if (m_TriangleArea <= 0.f)
+		return SAHCost();
+
+	float cost = 0.f;
+	for (const Node& node : m_Nodes)
+	{
+		const float area = HalfArea(node.m_Bounds);
+		cost += node.IsLeaf() ? INTERSECTION_COST * static_cast<float>(node.m_Count) * area : TRAVERSAL_COST * area;
+	}
+	return cost / m_TriangleArea;
+}
+
+float CpuBvh::Degradation() const
+{
+	return m_BuildCost > 0.f ? TriangleRelativeCost() / m_BuildCost : 1.f;
+}
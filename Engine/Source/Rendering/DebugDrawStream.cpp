@@ -0,0 +1,226 @@
+#include "Rendering/DebugDrawStream.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Rendering/ModelLoading/Model.h"
+#include "Log.h"
+
+namespace Ball
+{
+	void DebugPrimitiveRing::Init(DebugPrimitiveGPU* memory, uint32_t capacity, uint32_t numFrames)
+	{
+		m_Memory = memory;
+		m_Capacity = capacity;
+		m_NumFrames = numFrames;
+		m_Frame = 0;
+		m_Count.store(0, std::memory_order_relaxed);
+		m_Dropped.store(0, std::memory_order_relaxed);
+	}
+
+	DebugPrimitiveGPU* DebugPrimitiveRing::Allocate(uint32_t count)
+	{
+		// Compare exchange instead of fetch_add so a failed reservation doesn't leave a gap of unwritten records
+		uint32_t first = m_Count.load(std::memory_order_relaxed);
+		do
+		{
+			if (m_Memory == nullptr || first + count > m_Capacity)
+			{
+				m_Dropped.fetch_add(count, std::memory_order_relaxed);
+				return nullptr;
+			}
+		} while (!m_Count.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+
+		return m_Memory + m_Frame * m_Capacity + first;
+	}
+
+	DebugPrimitiveRange DebugPrimitiveRing::EndFrame()
+	{
+		const DebugPrimitiveRange range = {m_Frame * m_Capacity, m_Count.load(std::memory_order_acquire)};
+		m_Frame = (m_Frame + 1) % m_NumFrames;
+		m_Count.store(0, std::memory_order_relaxed);
+		m_Dropped.store(0, std::memory_order_relaxed);
+		return range;
+	}
+
+	void DebugDrawStream::Init(DebugPrimitiveGPU* memory)
+	{
+		uint32_t offset = 0;
+		for (int i = 0; i < NUM_STREAMS; i++)
+		{
+			m_Rings[i].Init(memory != nullptr ? memory + offset : nullptr, CAPACITIES[i], NUM_FRAMES);
+			offset += CAPACITIES[i] * NUM_FRAMES;
+		}
+	}
+
+	void DebugDrawStream::AddLine(const glm::vec3& start,
+								  const glm::vec3& end,
+								  const glm::vec3& color,
+								  DebugDrawChannel channel)
+	{
+		if (DebugPrimitiveGPU* line = AllocateLines(1, channel))
+			WriteDebugLine(*line, start, end, PackDebugColor(color));
+	}
+
+	void DebugDrawStream::AddAABB(const AABB& box, const glm::vec3& color, DebugDrawChannel channel)
+	{
+		if (!box.IsValid())
+			return;
+
+		glm::mat4 transform = glm::mat4(1.f);
+		transform[0][0] = box.GetExtents().x;
+		transform[1][1] = box.GetExtents().y;
+		transform[2][2] = box.GetExtents().z;
+		transform[3] = glm::vec4(box.GetCenter(), 1.f);
+		AddShape(transform, DEBUG_PRIMITIVE_BOX, color, channel);
+	}
+
+	void DebugDrawStream::AddSphere(const glm::vec3& center,
+									float radius,
+									const glm::vec3& color,
+									DebugDrawChannel channel)
+	{
+		glm::mat4 transform = glm::mat4(radius);
+		transform[3] = glm::vec4(center, 1.f);
+		AddShape(transform, DEBUG_PRIMITIVE_SPHERE, color, channel);
+	}
+
+	void DebugDrawStream::AddAxis(const glm::mat4& transform, float size, DebugDrawChannel channel)
+	{
+		glm::mat4 scaled = transform;
+		for (int axis = 0; axis < 3; axis++)
+			scaled[axis] = glm::vec4(glm::normalize(glm::vec3(transform[axis])) * size, 0.f);
+		AddShape(scaled, DEBUG_PRIMITIVE_AXIS, glm::vec3(1.f), channel);
+	}
+
+	void DebugDrawStream::AddFrustum(const CullingFrustum& frustum, const glm::vec3& color, DebugDrawChannel channel)
+	{
+		// m_Planes are top, bottom, left, right. The edges of the pyramid are where neighbouring planes meet, their
+		// normals point inside so the cross product is flipped until it points to the other planes.
+		auto getEdge = [&frustum](int vertical, int horizontal)
+		{
+			const glm::vec3 verticalNormal = glm::vec3(frustum.m_Planes[vertical]);
+			const glm::vec3 horizontalNormal = glm::vec3(frustum.m_Planes[horizontal]);
+			glm::vec3 direction = glm::normalize(glm::cross(verticalNormal, horizontalNormal));
+			if (glm::dot(direction, glm::vec3(frustum.m_Planes[vertical ^ 1])) < 0.f)
+				direction = -direction;
+			return direction;
+		};
+
+		const float distance = frustum.m_MaxDistance < FLT_MAX ? frustum.m_MaxDistance : 100.f;
+		const glm::vec3 bottomLeft = getEdge(1, 2) * distance;
+		const glm::vec3 bottomRight = getEdge(1, 3) * distance;
+		const glm::vec3 topLeft = getEdge(0, 2) * distance;
+
+		// Affine map of the unit pyramid, exact for symmetric frusta
+		glm::mat4 transform = glm::mat4(1.f);
+		transform[0] = glm::vec4((bottomRight - bottomLeft) * 0.5f, 0.f);
+		transform[1] = glm::vec4((topLeft - bottomLeft) * 0.5f, 0.f);
+		transform[2] = glm::vec4(bottomRight + (topLeft - bottomLeft) * 0.5f - glm::vec3(transform[0]), 0.f);
+		transform[3] = glm::vec4(frustum.m_Position, 1.f);
+		AddShape(transform, DEBUG_PRIMITIVE_PYRAMID, color, channel);
+	}
+
+	DebugPrimitiveGPU* DebugDrawStream::AllocateLines(uint32_t count, DebugDrawChannel channel)
+	{
+		const Stream stream = channel == DebugDrawChannel::OVERLAY ? OVERLAY_LINES : DEPTH_TESTED_LINES;
+		return m_Rings[stream].Allocate(count);
+	}
+
+	void DebugDrawStream::EndFrame(DebugPrimitiveRange ranges[NUM_STREAMS])
+	{
+		const uint32_t dropped = GetDroppedCount();
+		if (dropped > 0)
+			WARN(LOG_GRAPHICS, "%u debug lines and shapes didn't fit in the debug draw stream", dropped);
+
+		uint32_t offset = 0;
+		for (int i = 0; i < NUM_STREAMS; i++)
+		{
+			ranges[i] = m_Rings[i].EndFrame();
+			ranges[i].m_First += offset;
+			offset += CAPACITIES[i] * NUM_FRAMES;
+		}
+	}
+
+	uint32_t DebugDrawStream::GetDroppedCount() const
+	{
+		uint32_t dropped = 0;
+		for (const DebugPrimitiveRing& ring : m_Rings)
+			dropped += ring.GetDroppedCount();
+		return dropped;
+	}
+
+	void DebugDrawStream::AddShape(const glm::mat4& transform,
+								   uint32_t type,
+								   const glm::vec3& color,
+								   DebugDrawChannel channel)
+	{
+		const Stream stream = channel == DebugDrawChannel::OVERLAY ? OVERLAY_SHAPES : DEPTH_TESTED_SHAPES;
+		DebugPrimitiveGPU* shape = m_Rings[stream].Allocate(1);
+		if (shape == nullptr)
+			return;
+
+		// glm is column major, the records store rows
+		const glm::mat4 rows = glm::transpose(transform);
+		shape->m_Row0 = rows[0];
+		shape->m_Row1 = rows[1];
+		shape->m_Row2 = rows[2];
+		shape->m_Type = type;
+		shape->m_Color = PackDebugColor(color);
+	}
+
+	uint32_t PackDebugColor(const glm::vec3& color)
+	{
+		const glm::uvec3 bytes = glm::uvec3(glm::clamp(color, 0.f, 1.f) * 255.f + 0.5f);
+		return bytes.r | bytes.g << 8 | bytes.b << 16 | 0xFFu << 24;
+	}
+
+	void ExpandDebugPrimitives(const DebugPrimitiveGPU* primitives, uint32_t count, std::vector<glm::vec3>& points)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const uint32_t numVertices = GetDebugPrimitiveVertexCount(primitives[i].m_Type);
+			for (uint32_t vertex = 0; vertex < numVertices; vertex++)
+				points.push_back(GetDebugPrimitiveVertex(primitives[i], vertex));
+		}
+	}
+
+	void ExtractUniqueEdges(const std::vector<Triangle>& triangles, std::vector<DebugEdge>& edges)
+	{
+		// Triangles of an index buffer store the same vertex with the exact same position, so positions are
+		// compared bit for bit
+		struct PositionHash
+		{
+			size_t operator()(const glm::vec3& position) const
+			{
+				const std::hash<float> hash;
+				return hash(position.x) ^ hash(position.y) * 31 ^ hash(position.z) * 961;
+			}
+		};
+
+		std::unordered_map<glm::vec3, uint32_t, PositionHash> vertexIds;
+		std::unordered_set<uint64_t> addedEdges;
+		vertexIds.reserve(triangles.size() * 2);
+		addedEdges.reserve(triangles.size() * 2);
+
+		auto getVertexId = [&vertexIds](const glm::vec3& position)
+		{ return vertexIds.emplace(position, static_cast<uint32_t>(vertexIds.size())).first->second; };
+
+		for (const Triangle& triangle : triangles)
+		{
+			const glm::vec3* corners[3] = {&triangle.m_V0, &triangle.m_V1, &triangle.m_V2};
+			const uint32_t ids[3] = {getVertexId(triangle.m_V0), getVertexId(triangle.m_V1), getVertexId(triangle.m_V2)};
+			for (int i = 0; i < 3; i++)
+			{
+				const int next = (i + 1) % 3;
+				const uint32_t low = (std::min)(ids[i], ids[next]);
+				const uint32_t high = (std::max)(ids[i], ids[next]);
+				if (low == high)
+					continue;
+
+				if (addedEdges.insert(static_cast<uint64_t>(low) << 32 | high).second)
+					edges.push_back({*corners[i], *corners[next]});
+			}
+		}
+	}
+} // namespace Ball
@@ -107,14 +107,14 @@ void Denoiser::Initialize(int windowWidth, int windowHeight)
 		case DenoiseBuffers::VIEW_PYRAMID:
 			stride = sizeof(ViewPyramid);
 			count = 1;
-			flags = BufferFlags::SRV | BufferFlags::UPLOAD_HEAP;
+			flags = BufferFlags::SRV | BufferFlags::PER_FRAME;
 			screensize = false;
 			name = "View Pyramid";
 			break;
 		case DenoiseBuffers::CAMERAS:
 			stride = sizeof(CameraGPU);
 			count = 2;
-			flags = BufferFlags::SRV | BufferFlags::UPLOAD_HEAP;
+			flags = BufferFlags::SRV | BufferFlags::PER_FRAME;
 			screensize = false;
 			name = "Cameras";
 			break;
@@ -125,10 +125,10 @@ void Denoiser::Initialize(int windowWidth, int windowHeight)
 		}
 
 		if (screensize)
-			m_Buffers[i] =
-				BufferManager::Create(nullptr, stride, count, (flags | BufferFlags::SCREENSIZE), name.c_str());
+			m_Buffers[i] = BufferManager::Create(
+				nullptr, stride, count, (flags | BufferFlags::SCREENSIZE), name.c_str(), MemoryTag::DENOISER);
 		else
-			m_Buffers[i] = BufferManager::Create(nullptr, stride, count, flags, name.c_str());
+			m_Buffers[i] = BufferManager::Create(nullptr, stride, count, flags, name.c_str(), MemoryTag::DENOISER);
 	}
 }
 
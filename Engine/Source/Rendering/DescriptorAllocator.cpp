@@ -0,0 +1,194 @@
+#include "Rendering/DescriptorAllocator.h"
+
+#include <algorithm>
+
+#include "Log.h"
+
+namespace Ball
+{
+	DescriptorAllocator::DescriptorAllocator(uint32_t capacity) : m_Capacity(capacity)
+	{
+		if (capacity > 0)
+			InsertFreeBlock(0, capacity);
+	}
+
+	DescriptorRange DescriptorAllocator::Allocate(uint32_t count, const std::string& owner)
+	{
+		if (count == 0)
+			return {};
+
+		// The first size class can contain blocks that are too small, the ones above always fit
+		uint32_t blockStart = DescriptorRange::INVALID;
+		for (uint32_t sizeClass = GetSizeClass(count); sizeClass < NUM_SIZE_CLASSES; sizeClass++)
+		{
+			for (const uint32_t start : m_SizeClasses[sizeClass])
+			{
+				if (m_FreeBlocks[start] >= count)
+				{
+					blockStart = start;
+					break;
+				}
+			}
+
+			if (blockStart != DescriptorRange::INVALID)
+				break;
+		}
+
+		if (blockStart == DescriptorRange::INVALID)
+		{
+			ERROR(LOG_GRAPHICS,
+				  "Out of descriptors, couldn't allocate %u slots for '%s' (%u in use, %u waiting to be freed)",
+				  count,
+				  owner.c_str(),
+				  m_PersistentAllocated,
+				  GetStats().m_PendingFrees);
+			return {};
+		}
+
+		// Allocate from the front of the block, the remainder stays free
+		const uint32_t blockSize = m_FreeBlocks[blockStart];
+		RemoveFreeBlock(blockStart, blockSize);
+		if (blockSize > count)
+			InsertFreeBlock(blockStart + count, blockSize - count);
+
+		Allocation& allocation = m_Allocations[blockStart];
+		allocation.m_Count = count;
+#ifndef SHIPPING
+		allocation.m_Owner = owner;
+#endif
+		m_PersistentAllocated += count;
+
+		return {blockStart, count};
+	}
+
+	void DescriptorAllocator::Free(DescriptorRange& range)
+	{
+		if (!range.IsValid())
+			return;
+
+		const auto it = m_Allocations.find(range.m_Start);
+		ASSERT_MSG(LOG_GRAPHICS,
+				   it != m_Allocations.end() && it->second.m_Count == range.m_Count,
+				   "Freeing descriptor range [%u - %u] that wasn't allocated",
+				   range.m_Start,
+				   range.GetLast());
+		if (it == m_Allocations.end())
+			return;
+
+		m_Allocations.erase(it);
+		m_PersistentAllocated -= range.m_Count;
+		m_PendingFrees.push_back({m_CurrentFence, range});
+		range = {};
+	}
+
+	void DescriptorAllocator::BeginFrame(uint64_t frameFence, uint64_t completedFence)
+	{
+		m_CurrentFence = frameFence;
+
+		// Persistent ranges the GPU is done with go back to the free lists
+		auto pending = m_PendingFrees.begin();
+		while (pending != m_PendingFrees.end())
+		{
+			if (pending->m_Fence <= completedFence)
+			{
+				Release(pending->m_Range);
+				pending = m_PendingFrees.erase(pending);
+			}
+			else
+			{
+				++pending;
+			}
+		}
+	}
+
+	DescriptorAllocatorStats DescriptorAllocator::GetStats() const
+	{
+		DescriptorAllocatorStats stats;
+		stats.m_PersistentCapacity = m_Capacity;
+		stats.m_PersistentAllocated = m_PersistentAllocated;
+		stats.m_NumAllocations = static_cast<uint32_t>(m_Allocations.size());
+		stats.m_NumFreeBlocks = static_cast<uint32_t>(m_FreeBlocks.size());
+		for (const auto& block : m_FreeBlocks)
+			stats.m_LargestFreeBlock = std::max(stats.m_LargestFreeBlock, block.second);
+		for (const PendingFree& pending : m_PendingFrees)
+			stats.m_PendingFrees += pending.m_Range.m_Count;
+		return stats;
+	}
+
+	bool DescriptorAllocator::IsAllocated(uint32_t index) const
+	{
+		auto it = m_Allocations.upper_bound(index);
+		if (it == m_Allocations.begin())
+			return false;
+
+		--it;
+		return index < it->first + it->second.m_Count;
+	}
+
+#ifndef SHIPPING
+	std::vector<DescriptorAllocator::DebugAllocation> DescriptorAllocator::GetDebugAllocations() const
+	{
+		std::vector<DebugAllocation> allocations;
+		allocations.reserve(m_Allocations.size());
+		for (const auto& allocation : m_Allocations)
+			allocations.push_back({{allocation.first, allocation.second.m_Count}, allocation.second.m_Owner});
+		return allocations;
+	}
+
+	std::string DescriptorAllocator::GetOwner(uint32_t index) const
+	{
+		if (!IsAllocated(index))
+			return "";
+
+		return std::prev(m_Allocations.upper_bound(index))->second.m_Owner;
+	}
+#endif
+
+	uint32_t DescriptorAllocator::GetSizeClass(uint32_t count)
+	{
+		uint32_t sizeClass = 0;
+		while (count >>= 1)
+			sizeClass++;
+		return sizeClass;
+	}
+
+	void DescriptorAllocator::InsertFreeBlock(uint32_t start, uint32_t count)
+	{
+		m_FreeBlocks[start] = count;
+		m_SizeClasses[GetSizeClass(count)].insert(start);
+	}
+
+	void DescriptorAllocator::RemoveFreeBlock(uint32_t start, uint32_t count)
+	{
+		m_FreeBlocks.erase(start);
+		m_SizeClasses[GetSizeClass(count)].erase(start);
+	}
+
+	void DescriptorAllocator::Release(const DescriptorRange& range)
+	{
+		uint32_t start = range.m_Start;
+		uint32_t count = range.m_Count;
+
+		// Merge with the free blocks right after and right before the range
+		const auto next = m_FreeBlocks.find(start + count);
+		if (next != m_FreeBlocks.end())
+		{
+			count += next->second;
+			RemoveFreeBlock(next->first, next->second);
+		}
+
+		auto previous = m_FreeBlocks.lower_bound(start);
+		if (previous != m_FreeBlocks.begin())
+		{
+			--previous;
+			if (previous->first + previous->second == start)
+			{
+				start = previous->first;
+				count += previous->second;
+				RemoveFreeBlock(previous->first, previous->second);
+			}
+		}
+
+		InsertFreeBlock(start, count);
+	}
+} // namespace Ball
@@ -0,0 +1,241 @@
+#include "Rendering/EnergyLUT.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <numeric>
+
+#include "FileIO.h"
+#include "Log.h"
+#include "ShaderHeaders/BsdfGPU.h"
+#include "Utilities/LaunchParameters.h"
+
+namespace Ball
+{
+	namespace
+	{
+		using namespace Bsdf;
+
+		// Bump when the BSDF changes, outdated caches are baked again
+		constexpr uint32_t ENERGY_LUT_VERSION = 1;
+		constexpr uint32_t ENERGY_LUT_MAGIC = 0x54554C45; // "ELUT"
+		constexpr const char* ENERGY_LUT_CACHE = "EnergyLUT.bin";
+
+		// Grazing views and perfect mirrors are degenerate, the BSDF clamps them as well
+		constexpr float MIN_MU = 0.001f;
+		constexpr float MIN_ALPHA = 0.001f;
+
+		struct EnergyLUTHeader
+		{
+			uint32_t m_Magic = ENERGY_LUT_MAGIC;
+			uint32_t m_Version = ENERGY_LUT_VERSION;
+			uint32_t m_Size = ENERGY_LUT_SIZE;
+			uint32_t m_EtaSlices = ENERGY_LUT_ETA_SLICES;
+			float m_MaxEta = ENERGY_LUT_MAX_ETA;
+		};
+
+		// Van der Corput sequence in the given base
+		float RadicalInverse(uint32_t index, uint32_t base)
+		{
+			const double invBase = 1.0 / base;
+			double scale = invBase;
+			double result = 0.0;
+			while (index > 0)
+			{
+				result += (index % base) * scale;
+				index /= base;
+				scale *= invBase;
+			}
+			return static_cast<float>(result);
+		}
+
+		float3 MakeView(float mu)
+		{
+			mu = (std::max)(mu, MIN_MU);
+			return float3(std::sqrt(1.f - mu * mu), 0.f, mu);
+		}
+
+		MaterialHitData MakeMaterial(float alphaRoughness, float eta)
+		{
+			MaterialHitData material{};
+			material.m_AlphaRoughness = (std::max)(alphaRoughness, MIN_ALPHA);
+			material.m_Eta = eta;
+			material.m_BaseColor = float3(1.f, 1.f, 1.f);
+			return material;
+		}
+
+		// Reflection around H with F = 1, weighted by the BSDF times the cosine over the pdf like the path tracer does
+		float ReflectionEstimate(const MaterialHitData& material, float3 V, float3 H)
+		{
+			const float3 N = float3(0.f, 0.f, 1.f);
+			const float3 L = reflect(-V, H);
+			float pdf = 0.f;
+			const float3 brdf = BSDF_GGX(material, V, N, H, L.z, float3(1.f, 1.f, 1.f), pdf);
+			return pdf > 0.f ? brdf.x * L.z / pdf : 0.f;
+		}
+
+		// Expected value of the transmissive branch of PbrSample for H, the reflection/refraction choice is averaged
+		float DielectricEstimate(const MaterialHitData& material, float3 V, float3 H)
+		{
+			const float3 N = float3(0.f, 0.f, 1.f);
+			const float eta = material.m_Eta;
+			const float VdotH = std::abs(dot(V, H));
+			const float f0 = ((eta - 1.f) / (eta + 1.f)) * ((eta - 1.f) / (eta + 1.f));
+			const float f90 = clamp(f0 * 50.f, 0.f, 1.f);
+			float F = F_Schlick(f0, f90, VdotH);
+			// Total internal reflection
+			if (eta * eta * (1.f - VdotH * VdotH) > 1.f)
+				F = 1.f;
+
+			float transmission = 0.f;
+			if (F < 1.f)
+			{
+				float3 L = normalize(refract(-V, H, eta));
+				if (isnan(L.x) || isnan(L.y) || isnan(L.z))
+					L = -V;
+
+				const float NdotL = std::abs(L.z);
+				float pdf = 0.f;
+				const float3 btdf = BSDF_GGX(material, V, N, H, NdotL, float3(1.f, 1.f, 1.f), pdf);
+				transmission = pdf > 0.f ? btdf.x * NdotL / pdf : 0.f;
+			}
+			return F * ReflectionEstimate(material, V, H) + (1.f - F) * transmission;
+		}
+
+		// Hammersley points warped to the visible normals
+		template <typename Estimate>
+		float IntegrateAlbedo(const MaterialHitData& material, float mu, uint32_t numSamples, const Estimate& estimate)
+		{
+			const float3 V = MakeView(mu);
+			double sum = 0.0;
+			for (uint32_t i = 0; i < numSamples; i++)
+			{
+				const float r0 = (static_cast<float>(i) + 0.5f) / static_cast<float>(numSamples);
+				const float r1 = RadicalInverse(i, 2);
+				const float3 H = GGXSampleVNDF(V, material.m_AlphaRoughness, r0, r1);
+				sum += estimate(material, V, H);
+			}
+			return static_cast<float>(sum / numSamples);
+		}
+
+		// mu is drawn proportional to 2 * mu, the weight of E_avg, which leaves the plain mean of the estimates
+		template <typename Estimate>
+		float IntegrateAverageAlbedo(const MaterialHitData& material, uint32_t numSamples, const Estimate& estimate)
+		{
+			double sum = 0.0;
+			for (uint32_t i = 0; i < numSamples; i++)
+			{
+				const float mu = std::sqrt((static_cast<float>(i) + 0.5f) / static_cast<float>(numSamples));
+				const float3 V = MakeView(mu);
+				const float r0 = RadicalInverse(i, 2);
+				const float r1 = RadicalInverse(i, 3);
+				const float3 H = GGXSampleVNDF(V, material.m_AlphaRoughness, r0, r1);
+				sum += estimate(material, V, H);
+			}
+			return static_cast<float>(sum / numSamples);
+		}
+	} // namespace
+
+	float IntegrateReflectionAlbedo(float mu, float alphaRoughness, uint32_t numSamples)
+	{
+		return IntegrateAlbedo(MakeMaterial(alphaRoughness, 1.f), mu, numSamples, ReflectionEstimate);
+	}
+
+	float IntegrateDielectricAlbedo(float mu, float alphaRoughness, float eta, uint32_t numSamples)
+	{
+		return IntegrateAlbedo(MakeMaterial(alphaRoughness, eta), mu, numSamples, DielectricEstimate);
+	}
+
+	float IntegrateAverageReflectionAlbedo(float alphaRoughness, uint32_t numSamples)
+	{
+		return IntegrateAverageAlbedo(MakeMaterial(alphaRoughness, 1.f), numSamples, ReflectionEstimate);
+	}
+
+	float IntegrateAverageDielectricAlbedo(float alphaRoughness, float eta, uint32_t numSamples)
+	{
+		return IntegrateAverageAlbedo(MakeMaterial(alphaRoughness, eta), numSamples, DielectricEstimate);
+	}
+
+	EnergyLUTs BakeEnergyLUTs(uint32_t numSamples)
+	{
+		constexpr uint32_t size = ENERGY_LUT_SIZE;
+		EnergyLUTs luts;
+		luts.m_Reflection.resize(size * size);
+		luts.m_Dielectric.resize(size * size * ENERGY_LUT_ETA_SLICES);
+
+		// One job per row of alpha, the reflection table comes first
+		std::vector<uint32_t> rows(size + size * ENERGY_LUT_ETA_SLICES);
+		std::iota(rows.begin(), rows.end(), 0u);
+		std::for_each(std::execution::par,
+					  rows.begin(),
+					  rows.end(),
+					  [&](uint32_t row)
+					  {
+						  const bool dielectric = row >= size;
+						  const uint32_t tableRow = dielectric ? row - size : row;
+						  const float alpha = static_cast<float>(tableRow % size) / static_cast<float>(size - 1);
+						  const float eta = dielectric ? EnergyLUTSliceEta(tableRow / size) : 1.f;
+						  glm::vec2* entries = dielectric ? &luts.m_Dielectric[tableRow * size]
+														  : &luts.m_Reflection[tableRow * size];
+
+						  // The average covers all of mu, it gets more samples than a single entry
+						  const uint32_t numAverageSamples = numSamples * 4;
+						  const float average = dielectric
+													? IntegrateAverageDielectricAlbedo(alpha, eta, numAverageSamples)
+													: IntegrateAverageReflectionAlbedo(alpha, numAverageSamples);
+						  for (uint32_t x = 0; x < size; x++)
+						  {
+							  const float mu = static_cast<float>(x) / static_cast<float>(size - 1);
+							  const float energy = dielectric ? IntegrateDielectricAlbedo(mu, alpha, eta, numSamples)
+															  : IntegrateReflectionAlbedo(mu, alpha, numSamples);
+							  entries[x] = glm::vec2(energy, average);
+						  }
+					  });
+		return luts;
+	}
+
+	EnergyLUTs LoadOrBakeEnergyLUTs()
+	{
+		EnergyLUTs luts;
+		luts.m_Reflection.resize(ENERGY_LUT_SIZE * ENERGY_LUT_SIZE);
+		luts.m_Dielectric.resize(ENERGY_LUT_SIZE * ENERGY_LUT_SIZE * ENERGY_LUT_ETA_SLICES);
+		const size_t reflectionBytes = luts.m_Reflection.size() * sizeof(glm::vec2);
+		const size_t dielectricBytes = luts.m_Dielectric.size() * sizeof(glm::vec2);
+		const size_t fileSize = sizeof(EnergyLUTHeader) + reflectionBytes + dielectricBytes;
+
+		const bool forceBake = LaunchParameters::Contains("BakeEnergyLUT");
+		if (!forceBake && FileIO::Exist(FileIO::TempData, ENERGY_LUT_CACHE) &&
+			FileIO::GetSize(FileIO::TempData, ENERGY_LUT_CACHE) == fileSize)
+		{
+			std::vector<uint8_t> data(fileSize);
+			const EnergyLUTHeader expected;
+			if (FileIO::ReadBinary(FileIO::TempData, ENERGY_LUT_CACHE, data.data(), fileSize) &&
+				std::memcmp(data.data(), &expected, sizeof(EnergyLUTHeader)) == 0)
+			{
+				const uint8_t* tables = data.data() + sizeof(EnergyLUTHeader);
+				std::memcpy(luts.m_Reflection.data(), tables, reflectionBytes);
+				std::memcpy(luts.m_Dielectric.data(), tables + reflectionBytes, dielectricBytes);
+				return luts;
+			}
+		}
+
+		INFO(LOG_GRAPHICS, "Baking the energy compensation tables of the BSDF");
+		luts = BakeEnergyLUTs();
+
+		std::vector<uint8_t> data(fileSize);
+		const EnergyLUTHeader header;
+		std::memcpy(data.data(), &header, sizeof(EnergyLUTHeader));
+		std::memcpy(data.data() + sizeof(EnergyLUTHeader), luts.m_Reflection.data(), reflectionBytes);
+		std::memcpy(data.data() + sizeof(EnergyLUTHeader) + reflectionBytes, luts.m_Dielectric.data(), dielectricBytes);
+		if (!FileIO::WriteBinary(FileIO::TempData, ENERGY_LUT_CACHE, data.data(), data.size()))
+			WARN(LOG_GRAPHICS, "Couldn't cache the energy compensation tables, they will be baked again next launch");
+		return luts;
+	}
+
+	void BindEnergyLUTs(const EnergyLUTs* luts)
+	{
+		Bsdf::g_ReflectionEnergyLUT = luts != nullptr ? luts->m_Reflection.data() : nullptr;
+		Bsdf::g_DielectricEnergyLUT = luts != nullptr ? luts->m_Dielectric.data() : nullptr;
+	}
+} // namespace Ball
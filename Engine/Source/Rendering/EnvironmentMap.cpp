@@ -0,0 +1,145 @@
+#include "Rendering/EnvironmentMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <numeric>
+
+namespace Ball
+{
+	namespace
+	{
+		double Luminance(const float* rgba)
+		{
+			return 0.2126 * rgba[0] + 0.7152 * rgba[1] + 0.0722 * rgba[2];
+		}
+
+		// Fills the conditional table of every row with the given weights and returns the sum of each row. The
+		// weights are kept in m_Pdf until the total is known.
+		template <typename RowWeights>
+		std::vector<double> BuildRows(EnvironmentDistribution& distribution, const RowWeights& rowWeights)
+		{
+			const uint32_t width = distribution.m_Width;
+			const uint32_t height = distribution.m_Height;
+			std::vector<double> rowSums(height, 0.0);
+			std::vector<uint32_t> rows(height);
+			std::iota(rows.begin(), rows.end(), 0u);
+			std::for_each(std::execution::par,
+						  rows.begin(),
+						  rows.end(),
+						  [&](uint32_t y)
+						  {
+							  std::vector<double> weights(width);
+							  rowWeights(y, weights.data());
+							  EnvironmentAliasEntry* row = &distribution.m_Entries[height + y * width];
+							  rowSums[y] = BuildAliasTable(weights.data(), width, row);
+							  for (uint32_t x = 0; x < width; x++)
+								  row[x].m_Pdf = static_cast<float>(weights[x]);
+						  });
+			return rowSums;
+		}
+	} // namespace
+
+	double BuildAliasTable(const double* weights, uint32_t count, EnvironmentAliasEntry* entries)
+	{
+		double sum = 0.0;
+		for (uint32_t i = 0; i < count; i++)
+			sum += (std::max)(weights[i], 0.0);
+
+		std::vector<double> scaled(count);
+		std::vector<uint32_t> small;
+		std::vector<uint32_t> large;
+		small.reserve(count);
+		large.reserve(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			scaled[i] = sum > 0.0 ? (std::max)(weights[i], 0.0) * count / sum : 1.0;
+			(scaled[i] < 1.0 ? small : large).push_back(i);
+		}
+
+		// Every under full slot is topped up by an over full one, which then may become under full itself
+		while (!small.empty() && !large.empty())
+		{
+			const uint32_t less = small.back();
+			small.pop_back();
+			const uint32_t more = large.back();
+			large.pop_back();
+
+			entries[less].m_Probability = static_cast<float>(scaled[less]);
+			entries[less].m_Alias = more;
+			scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+			(scaled[more] < 1.0 ? small : large).push_back(more);
+		}
+
+		// What is left is full, up to rounding errors
+		for (const std::vector<uint32_t>* remaining : {&small, &large})
+		{
+			for (const uint32_t index : *remaining)
+			{
+				entries[index].m_Probability = 1.f;
+				entries[index].m_Alias = index;
+			}
+		}
+		return sum;
+	}
+
+	EnvironmentDistribution BuildEnvironmentDistribution(const float* rgba, uint32_t width, uint32_t height,
+														 uint32_t maxWidth)
+	{
+		// A whole factor, every texel of the distribution covers the same block of the HDRI
+		const uint32_t factor = (width + maxWidth - 1) / maxWidth;
+		EnvironmentDistribution distribution;
+		distribution.m_Width = (width + factor - 1) / factor;
+		distribution.m_Height = (height + factor - 1) / factor;
+		const uint32_t distributionWidth = distribution.m_Width;
+		const uint32_t distributionHeight = distribution.m_Height;
+		distribution.m_Entries.resize(distributionHeight + distributionWidth * distributionHeight);
+
+		auto sinTheta = [distributionHeight](uint32_t y)
+		{ return std::sin((y + 0.5) / distributionHeight * EnvironmentMap::ENVIRONMENT_PI); };
+
+		std::vector<double> rowSums = BuildRows(
+			distribution,
+			[&](uint32_t y, double* weights)
+			{
+				const uint32_t y0 = y * factor;
+				const uint32_t y1 = (std::min)(y0 + factor, height);
+				for (uint32_t x = 0; x < distributionWidth; x++)
+				{
+					const uint32_t x0 = x * factor;
+					const uint32_t x1 = (std::min)(x0 + factor, width);
+					double luminance = 0.0;
+					for (uint32_t sourceY = y0; sourceY < y1; sourceY++)
+					{
+						for (uint32_t sourceX = x0; sourceX < x1; sourceX++)
+							luminance += (std::max)(Luminance(&rgba[(sourceY * width + sourceX) * 4]), 0.0);
+					}
+					weights[x] = luminance / ((y1 - y0) * (x1 - x0)) * sinTheta(y);
+				}
+			});
+
+		double total = BuildAliasTable(rowSums.data(), distributionHeight, distribution.m_Entries.data());
+		if (!(total > 0.0))
+		{
+			auto uniform = [&](uint32_t y, double* weights) { std::fill_n(weights, distributionWidth, sinTheta(y)); };
+			rowSums = BuildRows(distribution, uniform);
+			total = BuildAliasTable(rowSums.data(), distributionHeight, distribution.m_Entries.data());
+		}
+
+		// Weights to densities over the UVs, p(row) * p(column | row) * width * height
+		const double texelScale = static_cast<double>(distributionWidth) * distributionHeight / total;
+		for (uint32_t y = 0; y < distributionHeight; y++)
+		{
+			distribution.m_Entries[y].m_Pdf = static_cast<float>(rowSums[y] / total * distributionHeight);
+			EnvironmentAliasEntry* row = &distribution.m_Entries[distributionHeight + y * distributionWidth];
+			for (uint32_t x = 0; x < distributionWidth; x++)
+				row[x].m_Pdf = static_cast<float>(row[x].m_Pdf * texelScale);
+		}
+		return distribution;
+	}
+
+	void BindEnvironmentDistribution(const EnvironmentDistribution* distribution)
+	{
+		EnvironmentMap::g_EnvironmentDistribution = distribution != nullptr ? distribution->m_Entries.data() : nullptr;
+	}
+} // namespace Ball
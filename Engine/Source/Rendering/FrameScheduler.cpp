@@ -0,0 +1,125 @@
+#include "Rendering/FrameScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "Log.h"
+
+using namespace Ball;
+
+FrameScheduler::FrameScheduler(IGpuTimeline& timeline, uint32_t framesInFlight) : m_Timeline(timeline)
+{
+	SetFramesInFlight(framesInFlight);
+	m_FramesInFlight = m_PendingFramesInFlight;
+}
+
+void FrameScheduler::SetFramesInFlight(uint32_t framesInFlight)
+{
+	m_PendingFramesInFlight = (std::clamp)(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+}
+
+uint32_t FrameScheduler::BeginFrame()
+{
+	ASSERT_MSG(LOG_GRAPHICS, !m_Recording, "FrameScheduler::BeginFrame called twice without EndFrame");
+
+	// Slots are handed out in order, the GPU has to be done with all of them before their count changes
+	if (m_PendingFramesInFlight != m_FramesInFlight)
+	{
+		WaitForIdle();
+		m_FramesInFlight = m_PendingFramesInFlight;
+		m_Slot = 0;
+	}
+
+	const uint64_t slotFence = m_SlotFences[m_Slot];
+	if (slotFence > m_Timeline.GetCompletedValue())
+	{
+		const auto start = std::chrono::steady_clock::now();
+		m_Timeline.WaitForValue(slotFence);
+		const std::chrono::duration<double, std::milli> waited = std::chrono::steady_clock::now() - start;
+		m_Stats.m_Waits++;
+		m_Stats.m_LastWaitMs = waited.count();
+		m_Stats.m_TotalWaitMs += waited.count();
+	}
+	else
+	{
+		m_Stats.m_LastWaitMs = 0.0;
+	}
+
+	{
+		// DeferDeletion reads the frame number from other threads
+		std::lock_guard<std::mutex> lock(m_DeletionMutex);
+		m_Frame++;
+		m_Recording = true;
+	}
+	RetireFrames();
+	return m_Slot;
+}
+
+void FrameScheduler::EndFrame()
+{
+	ASSERT_MSG(LOG_GRAPHICS, m_Recording, "FrameScheduler::EndFrame called without BeginFrame");
+
+	const uint64_t fenceValue = m_Timeline.Signal();
+	m_SlotFences[m_Slot] = fenceValue;
+	m_Submitted.push_back({m_Frame, fenceValue});
+	m_Slot = (m_Slot + 1) % m_FramesInFlight;
+	m_Stats.m_Frames++;
+
+	std::lock_guard<std::mutex> lock(m_DeletionMutex);
+	m_Recording = false;
+}
+
+void FrameScheduler::WaitForIdle()
+{
+	m_Timeline.WaitForValue(m_Timeline.Signal());
+	m_Submitted.clear();
+
+	// Commands of the frame being recorded haven't been submitted, its deletions have to wait for EndFrame. Between
+	// frames nothing can use what was deferred for the next frame yet.
+	m_CompletedFrame = m_Recording ? m_Frame - 1 : m_Frame;
+	RunDeletions(m_Recording ? m_CompletedFrame : m_Frame + 1);
+}
+
+void FrameScheduler::RetireFrames()
+{
+	const uint64_t completedValue = m_Timeline.GetCompletedValue();
+	while (!m_Submitted.empty() && m_Submitted.front().m_FenceValue <= completedValue)
+	{
+		m_CompletedFrame = m_Submitted.front().m_Frame;
+		m_Submitted.pop_front();
+	}
+	RunDeletions(m_CompletedFrame);
+}
+
+void FrameScheduler::RunDeletions(uint64_t completedFrame)
+{
+	// The callbacks run without the lock, they can release resources that defer deletions of their own
+	std::vector<std::function<void()>> ready;
+	{
+		std::lock_guard<std::mutex> lock(m_DeletionMutex);
+		while (!m_Deletions.empty() && m_Deletions.front().m_Frame <= completedFrame)
+		{
+			ready.push_back(std::move(m_Deletions.front().m_Release));
+			m_Deletions.pop_front();
+		}
+	}
+
+	for (std::function<void()>& release : ready)
+		release();
+	m_Stats.m_Deletions += ready.size();
+}
+
+void FrameScheduler::DeferDeletion(std::function<void()> release)
+{
+	std::lock_guard<std::mutex> lock(m_DeletionMutex);
+	// Between frames the resource can still be used by work submitted before the next BeginFrame
+	const uint64_t frame = m_Recording ? m_Frame : m_Frame + 1;
+	m_Deletions.push_back({frame, std::move(release)});
+}
+
+size_t FrameScheduler::GetPendingDeletions() const
+{
+	std::lock_guard<std::mutex> lock(m_DeletionMutex);
+	return m_Deletions.size();
+}
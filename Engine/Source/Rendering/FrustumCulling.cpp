@@ -0,0 +1,165 @@
+#include "Rendering/FrustumCulling.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define CULLING_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Ball
+{
+	void AABB::Grow(const glm::vec3& point)
+	{
+		m_Min = glm::min(m_Min, point);
+		m_Max = glm::max(m_Max, point);
+	}
+
+	void AABB::Grow(const AABB& box)
+	{
+		m_Min = glm::min(m_Min, box.m_Min);
+		m_Max = glm::max(m_Max, box.m_Max);
+	}
+
+	AABB AABB::Transformed(const glm::mat4& transform) const
+	{
+		if (!IsValid())
+			return {};
+
+		// Arvo's method, the new extents are the extents projected onto the absolute rotation/scale axes
+		const glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.f));
+		const glm::vec3 extents = GetExtents();
+		glm::vec3 newExtents = glm::vec3(0.f);
+		for (int axis = 0; axis < 3; axis++)
+			newExtents += glm::abs(glm::vec3(transform[axis])) * extents[axis];
+
+		return {center - newExtents, center + newExtents};
+	}
+
+	CullingFrustum CullingFrustum::FromViewPyramid(const ViewPyramid& pyramid,
+												   const glm::vec3& position,
+												   float maxDistance)
+	{
+		CullingFrustum frustum;
+		frustum.m_Position = position;
+		frustum.m_MaxDistance = maxDistance;
+
+		// The pyramid planes go through the camera position and aren't normalized
+		const glm::vec4 planes[NUM_PLANES] = {
+			pyramid.m_TopPlane, pyramid.m_BotPlane, pyramid.m_LeftPlane, pyramid.m_RightPlane};
+		for (int i = 0; i < NUM_PLANES; i++)
+		{
+			const glm::vec3 normal = glm::normalize(glm::vec3(planes[i]));
+			frustum.m_Planes[i] = glm::vec4(normal, -glm::dot(normal, position));
+		}
+		return frustum;
+	}
+
+	bool CullingFrustum::IsVisible(const AABB& box) const
+	{
+		uint8_t visible;
+		CullAABBs(*this, &box, 1, &visible, nullptr);
+		return visible != 0;
+	}
+
+	float CullingFrustum::GetDistance(const AABB& box) const
+	{
+		uint8_t visible;
+		float distance;
+		CullAABBs(*this, &box, 1, &visible, &distance);
+		return distance;
+	}
+
+	void CullAABBs(const CullingFrustum& frustum, const AABB* boxes, size_t count, uint8_t* visible, float* distances)
+	{
+		const float maxDistanceSq = frustum.m_MaxDistance * frustum.m_MaxDistance;
+		size_t i = 0;
+
+#ifdef CULLING_SSE
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 maxDistance = _mm_set1_ps(maxDistanceSq);
+		const __m128 cameraX = _mm_set1_ps(frustum.m_Position.x);
+		const __m128 cameraY = _mm_set1_ps(frustum.m_Position.y);
+		const __m128 cameraZ = _mm_set1_ps(frustum.m_Position.z);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const AABB* b = boxes + i;
+
+			// AoS to SoA, one lane per box
+			const __m128 minX = _mm_setr_ps(b[0].m_Min.x, b[1].m_Min.x, b[2].m_Min.x, b[3].m_Min.x);
+			const __m128 minY = _mm_setr_ps(b[0].m_Min.y, b[1].m_Min.y, b[2].m_Min.y, b[3].m_Min.y);
+			const __m128 minZ = _mm_setr_ps(b[0].m_Min.z, b[1].m_Min.z, b[2].m_Min.z, b[3].m_Min.z);
+			const __m128 maxX = _mm_setr_ps(b[0].m_Max.x, b[1].m_Max.x, b[2].m_Max.x, b[3].m_Max.x);
+			const __m128 maxY = _mm_setr_ps(b[0].m_Max.y, b[1].m_Max.y, b[2].m_Max.y, b[3].m_Max.y);
+			const __m128 maxZ = _mm_setr_ps(b[0].m_Max.z, b[1].m_Max.z, b[2].m_Max.z, b[3].m_Max.z);
+
+			const __m128 centerX = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+			const __m128 centerY = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+			const __m128 centerZ = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+			const __m128 extentX = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+			const __m128 extentY = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+			const __m128 extentZ = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+			// A box is outside when even its corner furthest along the normal is behind one of the planes
+			__m128 outside = zero;
+			for (const glm::vec4& plane : frustum.m_Planes)
+			{
+				const glm::vec3 absNormal = glm::abs(glm::vec3(plane));
+				__m128 distance = _mm_add_ps(_mm_mul_ps(centerX, _mm_set1_ps(plane.x)),
+											 _mm_mul_ps(centerY, _mm_set1_ps(plane.y)));
+				distance = _mm_add_ps(distance, _mm_mul_ps(centerZ, _mm_set1_ps(plane.z)));
+				distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+
+				__m128 radius = _mm_add_ps(_mm_mul_ps(extentX, _mm_set1_ps(absNormal.x)),
+										   _mm_mul_ps(extentY, _mm_set1_ps(absNormal.y)));
+				radius = _mm_add_ps(radius, _mm_mul_ps(extentZ, _mm_set1_ps(absNormal.z)));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			// Distance from the camera to the closest point of the box
+			const __m128 deltaX = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, cameraX), _mm_sub_ps(cameraX, maxX)), zero);
+			const __m128 deltaY = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, cameraY), _mm_sub_ps(cameraY, maxY)), zero);
+			const __m128 deltaZ = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, cameraZ), _mm_sub_ps(cameraZ, maxZ)), zero);
+			__m128 distanceSq = _mm_add_ps(_mm_mul_ps(deltaX, deltaX), _mm_mul_ps(deltaY, deltaY));
+			distanceSq = _mm_add_ps(distanceSq, _mm_mul_ps(deltaZ, deltaZ));
+			outside = _mm_or_ps(outside, _mm_cmpgt_ps(distanceSq, maxDistance));
+
+			const int outsideMask = _mm_movemask_ps(outside);
+			for (int lane = 0; lane < 4; lane++)
+				visible[i + lane] = ((outsideMask >> lane) & 1) == 0;
+
+			if (distances != nullptr)
+				_mm_storeu_ps(distances + i, _mm_sqrt_ps(distanceSq));
+		}
+#endif
+
+		// Remainder of the batches, or everything when SSE isn't available
+		for (; i < count; i++)
+		{
+			const AABB& box = boxes[i];
+			const glm::vec3 center = (box.m_Min + box.m_Max) * 0.5f;
+			const glm::vec3 extents = (box.m_Max - box.m_Min) * 0.5f;
+
+			bool outside = false;
+			for (const glm::vec4& plane : frustum.m_Planes)
+			{
+				const float distance = center.x * plane.x + center.y * plane.y + center.z * plane.z + plane.w;
+				const float radius =
+					extents.x * std::abs(plane.x) + extents.y * std::abs(plane.y) + extents.z * std::abs(plane.z);
+				outside |= distance + radius < 0.f;
+			}
+
+			const glm::vec3 delta =
+				glm::max(glm::max(box.m_Min - frustum.m_Position, frustum.m_Position - box.m_Max), glm::vec3(0.f));
+			const float distanceSq = glm::dot(delta, delta);
+			outside |= distanceSq > maxDistanceSq;
+
+			visible[i] = !outside;
+			if (distances != nullptr)
+				distances[i] = std::sqrt(distanceSq);
+		}
+	}
+} // namespace Ball
@@ -0,0 +1,172 @@
+#include "Rendering/MemoryTracker.h"
+
+#include <algorithm>
+
+#include "Log.h"
+
+namespace Ball
+{
+	namespace
+	{
+		constexpr double BYTES_TO_MB = 1.0 / (1024.0 * 1024.0);
+	}
+
+	void MemoryTracker::Allocate(MemoryTag tag, uint64_t bytes)
+	{
+		AddBytes(tag, static_cast<int64_t>(bytes), 1);
+	}
+
+	void MemoryTracker::Free(MemoryTag tag, uint64_t bytes)
+	{
+		AddBytes(tag, -static_cast<int64_t>(bytes), -1);
+	}
+
+	void MemoryTracker::Resize(MemoryTag tag, uint64_t oldBytes, uint64_t newBytes)
+	{
+		AddBytes(tag, static_cast<int64_t>(newBytes) - static_cast<int64_t>(oldBytes), 0);
+	}
+
+	void MemoryTracker::AddBytes(MemoryTag tag, int64_t bytes, int32_t numAllocations)
+	{
+		ASSERT_MSG(LOG_GRAPHICS, tag < MemoryTag::NUM_TAGS, "Allocations can't be tagged with MemoryTag::TOTAL");
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (const size_t index : {static_cast<size_t>(tag), static_cast<size_t>(MemoryTag::TOTAL)})
+		{
+			MemoryTagStats& stats = m_Stats[index];
+			ASSERT_MSG(LOG_GRAPHICS,
+					   bytes >= 0 || stats.m_LiveBytes >= static_cast<uint64_t>(-bytes),
+					   "Freeing more %s memory than was allocated",
+					   GetTagName(static_cast<MemoryTag>(index)));
+
+			stats.m_LiveBytes += bytes;
+			stats.m_NumAllocations += numAllocations;
+			stats.m_PeakBytes = std::max(stats.m_PeakBytes, stats.m_LiveBytes);
+		}
+	}
+
+	void MemoryTracker::EndFrame()
+	{
+		std::vector<std::pair<MemoryTag, MemoryTagStats>> overBudget;
+		std::vector<CallbackEntry> callbacks;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_FrameNumber++;
+
+			for (size_t i = 0; i < NUM_STATS; i++)
+			{
+				MemoryTagStats& stats = m_Stats[i];
+				stats.m_FrameDeltaBytes =
+					static_cast<int64_t>(stats.m_LiveBytes) - static_cast<int64_t>(m_LiveBytesLastFrame[i]);
+				m_LiveBytesLastFrame[i] = stats.m_LiveBytes;
+
+				const bool wasOverBudget = m_OverBudget[i];
+				m_OverBudget[i] = stats.m_BudgetBytes > 0 && stats.m_LiveBytes > stats.m_BudgetBytes;
+				if (!m_OverBudget[i])
+					continue;
+
+				const MemoryTag tag = static_cast<MemoryTag>(i);
+				if (m_WarnOnBudgetBreach && !wasOverBudget)
+				{
+					WARN(LOG_GRAPHICS,
+						 "%s memory over budget: %.2f MB / %.2f MB",
+						 GetTagName(tag),
+						 stats.m_LiveBytes * BYTES_TO_MB,
+						 stats.m_BudgetBytes * BYTES_TO_MB);
+				}
+				overBudget.push_back({tag, stats});
+			}
+
+			callbacks = m_BudgetCallbacks;
+		}
+
+		// Called without holding the lock, evicting resources frees memory through the tracker
+		for (const auto& [tag, stats] : overBudget)
+		{
+			for (const CallbackEntry& entry : callbacks)
+				entry.m_Callback(tag, stats);
+		}
+
+		if (m_LogInterval > 0 && m_FrameNumber % m_LogInterval == 0)
+			LogReport();
+	}
+
+	void MemoryTracker::SetBudget(MemoryTag tag, uint64_t bytes)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stats[static_cast<size_t>(tag)].m_BudgetBytes = bytes;
+	}
+
+	uint32_t MemoryTracker::AddBudgetCallback(BudgetCallback callback)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		const uint32_t callbackID = m_NextCallbackID++;
+		m_BudgetCallbacks.push_back({callbackID, std::move(callback)});
+		return callbackID;
+	}
+
+	void MemoryTracker::RemoveBudgetCallback(uint32_t callbackID)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_BudgetCallbacks.erase(std::remove_if(m_BudgetCallbacks.begin(),
+											   m_BudgetCallbacks.end(),
+											   [callbackID](const CallbackEntry& entry)
+											   { return entry.m_ID == callbackID; }),
+								m_BudgetCallbacks.end());
+	}
+
+	void MemoryTracker::LogReport() const
+	{
+		LOG(LOG_GRAPHICS, "Memory report (frame %llu):", static_cast<unsigned long long>(m_FrameNumber));
+		for (size_t i = 0; i < NUM_STATS; i++)
+		{
+			const MemoryTag tag = static_cast<MemoryTag>(i);
+			const MemoryTagStats stats = GetStats(tag);
+			LOG(LOG_GRAPHICS,
+				"  %-15s live %9.2f MB | peak %9.2f MB | delta %+9.2f MB | %5u allocations%s",
+				GetTagName(tag),
+				stats.m_LiveBytes * BYTES_TO_MB,
+				stats.m_PeakBytes * BYTES_TO_MB,
+				stats.m_FrameDeltaBytes * BYTES_TO_MB,
+				stats.m_NumAllocations,
+				stats.m_BudgetBytes > 0 && stats.m_LiveBytes > stats.m_BudgetBytes ? " | OVER BUDGET" : "");
+		}
+	}
+
+	MemoryTagStats MemoryTracker::GetStats(MemoryTag tag) const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Stats[static_cast<size_t>(tag)];
+	}
+
+	const char* MemoryTracker::GetTagName(MemoryTag tag)
+	{
+		switch (tag)
+		{
+		case MemoryTag::WAVEFRONT:
+			return "Wavefront";
+		case MemoryTag::DENOISER:
+			return "Denoiser";
+		case MemoryTag::MODEL_GEOMETRY:
+			return "Model Geometry";
+		case MemoryTag::TEXTURES:
+			return "Textures";
+		case MemoryTag::RENDER_TARGETS:
+			return "Render Targets";
+		case MemoryTag::STAGING:
+			return "Staging";
+		case MemoryTag::OTHER:
+			return "Other";
+		case MemoryTag::TOTAL:
+			return "Total";
+		default:
+			return "Unknown";
+		}
+	}
+
+	MemoryTracker& GetMemoryTracker()
+	{
+		static MemoryTracker tracker;
+		return tracker;
+	}
+} // namespace Ball
@@ -49,8 +49,13 @@ namespace Ball
 
 		// KHR_materials_emissive_strength
 		defaultMaterial.m_EmissiveStrength = 1.f;
-		// Dimension for the Mip-Map generation
-		defaultMaterial.m_TextureDim = 1.f; // 1.f, as log2(1.f) = 0.f
+
+		// Set by the shaders for every hit
+		defaultMaterial.m_MaterialLOD = 0.f;
+
+		// The glTF default alphaMode is OPAQUE
+		defaultMaterial.m_AlphaMask = 0;
+		defaultMaterial.m_AlphaCutoff = 0.5f;
 
 		return defaultMaterial;
 	};
@@ -122,7 +127,13 @@ namespace Ball
 			m_Data.m_BaseColorTextureIndex = model.textures[pbrMR.baseColorTexture.index].source;
 			uint32_t samplerIndex = model.textures[pbrMR.baseColorTexture.index].sampler;
 			m_Data.m_BaseColorSamplerIndex = GetSamplerHeapIndexFromGLTF(model.samplers[samplerIndex]);
-			m_Data.m_TextureDim = (float)model.images[m_Data.m_BaseColorTextureIndex].width;
+		}
+
+		// BLEND is treated as OPAQUE
+		if (mat.alphaMode == "MASK")
+		{
+			m_Data.m_AlphaMask = 1;
+			m_Data.m_AlphaCutoff = static_cast<float>(mat.alphaCutoff);
 		}
 
 		m_Data.m_MetallicFactor = static_cast<float>(pbrMR.metallicFactor);
@@ -132,8 +143,6 @@ namespace Ball
 			m_Data.m_MetallicRoughnessTextureIndex = model.textures[pbrMR.metallicRoughnessTexture.index].source;
 			uint32_t samplerIndex = model.textures[pbrMR.metallicRoughnessTexture.index].sampler;
 			m_Data.m_MetallicRoughnessSamplerIndex = GetSamplerHeapIndexFromGLTF(model.samplers[samplerIndex]);
-			if (m_Data.m_TextureDim == 1.f)
-				m_Data.m_TextureDim = (float)model.images[m_Data.m_MetallicRoughnessTextureIndex].width;
 		}
 
 		m_Data.m_EmissiveFactor = mat.emissiveFactor.size() == 3
@@ -144,8 +153,6 @@ namespace Ball
 			m_Data.m_EmissiveTextureIndex = model.textures[mat.emissiveTexture.index].source;
 			uint32_t samplerIndex = model.textures[mat.emissiveTexture.index].sampler;
 			m_Data.m_EmissiveSamplerIndex = GetSamplerHeapIndexFromGLTF(model.samplers[samplerIndex]);
-			if (m_Data.m_TextureDim == 1.f)
-				m_Data.m_TextureDim = (float)model.images[m_Data.m_EmissiveTextureIndex].width;
 		}
 
 		m_Data.m_NormalTextureScale = static_cast<float>(mat.normalTexture.scale);
@@ -154,8 +161,6 @@ namespace Ball
 			m_Data.m_NormalTextureIndex = model.textures[mat.normalTexture.index].source;
 			uint32_t samplerIndex = model.textures[mat.normalTexture.index].sampler;
 			m_Data.m_NormalSamplerIndex = GetSamplerHeapIndexFromGLTF(model.samplers[samplerIndex]);
-			if (m_Data.m_TextureDim == 1.f)
-				m_Data.m_TextureDim = (float)model.images[m_Data.m_NormalTextureIndex].width;
 		}
 
 		auto extentionIter = mat.extensions.find("KHR_materials_specular");
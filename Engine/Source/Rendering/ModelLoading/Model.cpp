@@ -22,10 +22,14 @@
 #include "Rendering/Renderer.h"
 #include "Rendering/ModelLoading/ModelAnimation.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "Rendering/BufferManager.h"
+#include "Rendering/OpacityMicromap.h"
 #include "Rendering/TextureManager.h"
+#include "Shaders/ShaderHeaders/RayConeGPU.h"
+#include "Utilities/PoolAllocator.h"
 
 namespace Ball
 {
@@ -112,11 +116,97 @@ namespace Ball
 		return intIndices;
 	}
 
+	// Copies an accessor to the CPU, following the stride of its buffer view. T has to match the accessor type
+	template<typename T>
+	std::vector<T> ReadAttributeFromGLTF(const tinygltf::Model& model, int index)
+	{
+		const auto& acc = model.accessors[index];
+		const auto& view = model.bufferViews[acc.bufferView];
+		const auto& buffer = model.buffers[view.buffer];
+		const size_t stride = view.byteStride != 0 ? view.byteStride : sizeof(T);
+		const unsigned char* dataLocation = &buffer.data.at(view.byteOffset + acc.byteOffset);
+
+		std::vector<T> values(acc.count);
+		for (size_t i = 0; i < acc.count; ++i)
+		{
+			memcpy(&values[i], dataLocation + i * stride, sizeof(T));
+		}
+		return values;
+	}
+
+	std::vector<uint32_t> ReadIndicesFromGLTF(const tinygltf::Model& model, int index)
+	{
+		const auto& acc = model.accessors[index];
+		const auto& view = model.bufferViews[acc.bufferView];
+		const auto& buffer = model.buffers[view.buffer];
+		const void* dataLocation = &buffer.data.at(view.byteOffset + acc.byteOffset);
+
+		if (acc.componentType == TINYGLTF_COMPONENT_TYPE_SHORT ||
+			acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
+			return ConvertTo32BitIndices((const uint16_t*)dataLocation, acc.count);
+
+		if (acc.componentType == TINYGLTF_COMPONENT_TYPE_BYTE ||
+			acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+			return ConvertTo32BitIndices((const uint8_t*)dataLocation, acc.count);
+
+		return ConvertTo32BitIndices((const uint32_t*)dataLocation, acc.count);
+	}
+
+	std::vector<uint32_t> BuildTriangleLODs(const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>& uvs,
+											const std::vector<glm::vec3>& normals,
+											const std::vector<uint32_t>& indices)
+	{
+		std::vector<uint32_t> triangleLODs(indices.size() / 3);
+		for (size_t i = 0; i < triangleLODs.size(); ++i)
+		{
+			const uint32_t i0 = indices[i * 3 + 0];
+			const uint32_t i1 = indices[i * 3 + 1];
+			const uint32_t i2 = indices[i * 3 + 2];
+
+			const glm::vec3& p0 = positions[i0];
+			const glm::vec3& p1 = positions[i1];
+			const glm::vec3& p2 = positions[i2];
+			const glm::vec2 uv01 = uvs[i1] - uvs[i0];
+			const glm::vec2 uv02 = uvs[i2] - uvs[i0];
+
+			const float areaDouble = glm::length(glm::cross(p1 - p0, p2 - p0));
+			const float uvAreaDouble = glm::abs(uv01.x * uv02.y - uv02.x * uv01.y);
+			const float lodConstant = RayCone::TriangleLODConstant(uvAreaDouble, areaDouble);
+
+			float curvature = 0.f;
+			if (!normals.empty())
+			{
+				curvature = RayCone::TriangleCurvature(
+					p0, p1, p2, glm::normalize(normals[i0]), glm::normalize(normals[i1]), glm::normalize(normals[i2]));
+			}
+
+			triangleLODs[i] = RayCone::PackTriangleLOD(lodConstant, curvature);
+		}
+		return triangleLODs;
+	}
+
+	// Keeps the alpha channel of RGBA texels, 16 bit ones at full precision
+	void CopyAlphaChannel(const uint8_t* rgba, int width, int height, int bits, AlphaTexture& alphaTexture)
+	{
+		alphaTexture.m_Width = static_cast<uint32_t>(width);
+		alphaTexture.m_Height = static_cast<uint32_t>(height);
+		alphaTexture.m_Alpha.resize(size_t(width) * height);
+		for (size_t i = 0; i < alphaTexture.m_Alpha.size(); i++)
+		{
+			if (bits == 16)
+				memcpy(&alphaTexture.m_Alpha[i], rgba + (i * 4 + 3) * sizeof(uint16_t), sizeof(uint16_t));
+			else
+				alphaTexture.m_Alpha[i] = static_cast<uint16_t>(rgba[i * 4 + 3] * 257u); // 255 maps to 0xffff
+		}
+	}
+
 	// Issues with LoadTextureFromGLTF:
 	//  ToDo : This will break for normal maps, they need to be loaded with R8G8B8A8_SNORM
 	//  ToDo : Replace with Assert from Logger.h once you update from main
 	//  ToDo : This always extends the channels to 4. This is bad. We shouldn't extend it
-	Texture* LoadTextureFromGLTF(const tinygltf::Model& model, int index, const std::string& filepath)
+	// alphaTexture, when given, gets a CPU copy of the alpha channel
+	Texture* LoadTextureFromGLTF(const tinygltf::Model& model, int index, const std::string& filepath,
+								 AlphaTexture* alphaTexture = nullptr)
 	{
 		Texture* texture = nullptr;
 		TextureSpec spec = {};
@@ -154,6 +244,8 @@ namespace Ball
 				std::lock_guard<std::mutex> lg(modelMu);
 				texture = TextureManager::Create(&image.image.at(0), spec, name);
 			}
+			if (alphaTexture)
+				CopyAlphaChannel(image.image.data(), image.width, image.height, image.bits, *alphaTexture);
 		}
 		else // This is in case of .gltf files which store textures as separate .jpgs/.pngs
 		{
@@ -169,6 +261,8 @@ namespace Ball
 			if (data)
 			{
 				texture = TextureManager::Create(data, spec, name);
+				if (alphaTexture)
+					CopyAlphaChannel(data, width, height, 8, *alphaTexture);
 				stbi_image_free(data);
 			}
 			else
@@ -216,7 +310,7 @@ namespace Ball
 			dataLocation = (void*)u32_from_u16.data();
 
 			const size_t stride = sizeof(uint32_t) * numElementsInType;
-			return BufferManager::Create(dataLocation, stride, acc.count, flags, name);
+			return BufferManager::Create(dataLocation, stride, acc.count, flags, name, MemoryTag::MODEL_GEOMETRY);
 		}
 
 		if (acc.componentType == TINYGLTF_COMPONENT_TYPE_BYTE ||
@@ -227,11 +321,11 @@ namespace Ball
 			dataLocation = (void*)u32_from_u8.data();
 
 			const size_t stride = sizeof(uint32_t) * numElementsInType;
-			return BufferManager::Create(dataLocation, stride, acc.count, flags, name);
+			return BufferManager::Create(dataLocation, stride, acc.count, flags, name, MemoryTag::MODEL_GEOMETRY);
 		}
 
 		const size_t stride = componentSizeInBytes * numElementsInType;
-		return BufferManager::Create(dataLocation, stride, acc.count, flags, name);
+		return BufferManager::Create(dataLocation, stride, acc.count, flags, name, MemoryTag::MODEL_GEOMETRY);
 	}
 
 	void Model::CreateBlasConstructionData(tinygltf::Model& test, OutBlasConstructor& outBlasConstrData,
@@ -250,12 +344,25 @@ namespace Ball
 				auto& mesh = inBlasConstrData.m_Meshes[node.m_MeshID];
 				for (auto& prim : mesh.GetPrimitivesRef())
 				{
-					BLASPrimitive* primitiveData = new BLASPrimitive();
+					BLASPrimitive* primitiveData = ObjectPool<BLASPrimitive>::New(); // Deleted by the BLAS
 					primitiveData->m_ModelMatrix = childMatrix;
 					primitiveData->m_IndexBuffer = inBlasConstrData.m_Buffers[prim.GetIndexBufferIndex()];
 					primitiveData->m_VertexBuffer = inBlasConstrData.m_Buffers[prim.GetPositionIndex()];
+					primitiveData->m_Opaque = prim.GetOpacityMicromapIndex() == -1;
 					prim.SetMatrix(childMatrix);
 
+					// glTF requires min/max on position accessors, the animated poses are added later
+					const auto& positions = test.accessors[prim.GetPositionIndex()];
+					AABB primBounds;
+					if (positions.minValues.size() == 3 && positions.maxValues.size() == 3)
+					{
+						primBounds = {
+							glm::vec3(positions.minValues[0], positions.minValues[1], positions.minValues[2]),
+							glm::vec3(positions.maxValues[0], positions.maxValues[1], positions.maxValues[2])};
+						m_Bounds.Grow(primBounds.Transformed(childMatrix));
+					}
+					m_PrimitiveBounds.push_back(primBounds);
+
 					outBlasConstrData.m_BlasConstrData.push_back(primitiveData);
 					outBlasConstrData.m_PrimitiveBufferGPU.push_back(prim);
 
@@ -327,7 +434,8 @@ namespace Ball
 														sizeof(Material),
 														m_Materials.size(),
 														BufferFlags::SRV | BufferFlags::DEFAULT_HEAP,
-														"Material Buffer: " + GetPath());
+														"Material Buffer: " + GetPath(),
+														MemoryTag::MODEL_GEOMETRY);
 		}
 
 		// Load Buffers (Accessors) to GPU
@@ -343,11 +451,23 @@ namespace Ball
 			blasHelperData.m_Meshes.emplace_back(model, i);
 		}
 
-		// Load Images (texture data)
+		// Before the primitives are copied into the GPU primitive buffer, they have to know their buffer
+		CreateTriangleLODBuffers(model, blasHelperData.m_Meshes);
+
+		// Load Images (texture data), alpha tested materials keep the alpha of their base color on the CPU
+		std::unordered_map<int, AlphaTexture> alphaTextures;
+		for (const Material& material : m_Materials)
+		{
+			if (material.m_Data.m_AlphaMask != 0 && material.m_Data.m_BaseColorTextureIndex != -1)
+				alphaTextures[material.m_Data.m_BaseColorTextureIndex];
+		}
 		for (int i = 0; i < static_cast<int>(model.images.size()); i++)
 		{
-			m_Textures.push_back(LoadTextureFromGLTF(model, i, GetPath()));
+			auto alphaTexture = alphaTextures.find(i);
+			m_Textures.push_back(LoadTextureFromGLTF(
+				model, i, GetPath(), alphaTexture != alphaTextures.end() ? &alphaTexture->second : nullptr));
 		}
+		CreateOpacityMicromaps(model, blasHelperData.m_Meshes, alphaTextures);
 
 		// Load Animations
 		m_Animation = new ModelAnimation();
@@ -409,6 +529,8 @@ namespace Ball
 
 		CreateBlasConstructionData(
 			model, *m_OutBlasConstrData, blasHelperData, rootNodeIdx, m_Animation->GetPrimOrderRef());
+		if (m_HasAnimation)
+			GrowBoundsOverAnimation();
 
 		BlasQuality blasQuality = m_HasAnimation ? BlasQuality::REFIT_FAST_TRAVERSE : BlasQuality::FAST_TRAVERSE;
 		std::string blasName = "BLAS: " + filepath;
@@ -419,12 +541,14 @@ namespace Ball
 		}
 		// CreateLightTriangleArray(blasHelperData, rootNodeIdx, model, *m_OutBlasConstrData);
 
-		BufferFlags primFlag = m_HasAnimation ? BufferFlags::UPLOAD_HEAP : BufferFlags::DEFAULT_HEAP;
+		// Animated primitives are rewritten every frame while earlier frames can still read them
+		BufferFlags primFlag = m_HasAnimation ? BufferFlags::PER_FRAME : BufferFlags::DEFAULT_HEAP;
 		m_GPUPrimitiveBuffer = BufferManager::Create(m_OutBlasConstrData->m_PrimitiveBufferGPU.data(),
 													 sizeof(PrimitiveGPU),
 													 m_OutBlasConstrData->m_PrimitiveBufferGPU.size(),
 													 BufferFlags::SRV | primFlag,
-													 "Primitive Buffer: " + GetPath());
+													 "Primitive Buffer: " + GetPath(),
+													 MemoryTag::MODEL_GEOMETRY);
 
 		m_CpuPhysicsData.m_PrimitiveBufferGPU = &m_OutBlasConstrData->m_PrimitiveBufferGPU;
 		GetCPUTrianglePrimitives(model, blasHelperData.m_Meshes);
@@ -432,11 +556,112 @@ namespace Ball
 		END_TIMER_MSG(LoadingModel, "Finished Loading: %s", GetPath().c_str());
 	}
 
-	void Model::RebuildBlas()
+	float Model::UpdateBlasPose()
 	{
-		m_BLAS->Update();
 		m_GPUPrimitiveBuffer->UpdateData(m_OutBlasConstrData->m_PrimitiveBufferGPU.data(),
 										 sizeof(PrimitiveGPU) * m_OutBlasConstrData->m_PrimitiveBufferGPU.size());
+
+		GatherPoseTriangles(m_PoseVertices);
+		if (m_PoseBvh.IsEmpty() || m_PoseBvh.GetTriangleCount() * 3 != m_PoseVertices.size())
+		{
+			m_PoseBvh.Build(m_PoseVertices);
+			return 1.f;
+		}
+
+		m_PoseBvh.Refit(m_PoseVertices);
+		return m_PoseBvh.Degradation();
+	}
+
+	void Model::RefitBlas()
+	{
+		m_BLAS->Refit();
+	}
+
+	void Model::RebuildBlas()
+	{
+		m_BLAS->Rebuild();
+		if (m_PoseVertices.empty())
+			GatherPoseTriangles(m_PoseVertices);
+		m_PoseBvh.Build(m_PoseVertices);
+	}
+
+	uint32_t Model::GetBlasTriangleCount() const
+	{
+		if (m_CpuPhysicsData.m_PrimitiveBufferGPU == nullptr)
+			return 0;
+
+		size_t count = 0;
+		for (const Primitive& primitive : *m_CpuPhysicsData.m_PrimitiveBufferGPU)
+		{
+			const uint64_t key =
+				static_cast<uint64_t>(primitive.GetPositionIndex()) << 32 | primitive.GetIndexBufferIndex();
+			const auto triangles = m_CpuPhysicsData.m_CPUTris.find(key);
+			if (triangles != m_CpuPhysicsData.m_CPUTris.end())
+				count += triangles->second.size();
+		}
+		return static_cast<uint32_t>(count);
+	}
+
+	void Model::GrowBoundsOverAnimation()
+	{
+		// Off-screen animations are throttled on these bounds, so the animated nodes can't leave them. Rotations can
+		// swing out between key frames, which is why every interval is sampled a few times.
+		constexpr int SAMPLES_PER_INTERVAL = 4;
+
+		std::vector<glm::mat4> blasMatrices;
+		for (const BLASPrimitive* primitive : m_OutBlasConstrData->m_BlasConstrData)
+			blasMatrices.push_back(primitive->m_ModelMatrix);
+		std::vector<glm::mat4> primitiveMatrices;
+		for (const Primitive& primitive : m_OutBlasConstrData->m_PrimitiveBufferGPU)
+			primitiveMatrices.push_back(primitive.GetMatrix());
+		const std::vector<glm::mat4> prevMatrices = m_CpuPhysicsData.m_PrevMatGpu;
+
+		std::vector<float> times = m_Animation->GetKeyFrameTimes();
+		std::sort(times.begin(), times.end());
+		times.erase(std::unique(times.begin(), times.end()), times.end());
+		for (size_t i = 0; i < times.size(); i++)
+		{
+			const int samples = i + 1 < times.size() ? SAMPLES_PER_INTERVAL : 1;
+			for (int s = 0; s < samples; s++)
+			{
+				const float time = samples == 1 ? times[i] : glm::mix(times[i], times[i + 1], float(s) / samples);
+				m_Animation->UpdateAnimations(m_OutBlasConstrData, &m_CpuPhysicsData, time);
+				for (size_t p = 0; p < m_PrimitiveBounds.size(); p++)
+				{
+					if (m_PrimitiveBounds[p].IsValid())
+						m_Bounds.Grow(m_PrimitiveBounds[p].Transformed(
+							m_OutBlasConstrData->m_PrimitiveBufferGPU[p].GetMatrix()));
+				}
+			}
+		}
+
+		// Back to the pose the BLAS is built with
+		for (size_t p = 0; p < blasMatrices.size(); p++)
+			m_OutBlasConstrData->m_BlasConstrData[p]->m_ModelMatrix = blasMatrices[p];
+		for (size_t p = 0; p < primitiveMatrices.size(); p++)
+			m_OutBlasConstrData->m_PrimitiveBufferGPU[p].SetMatrix(primitiveMatrices[p]);
+		m_CpuPhysicsData.m_PrevMatGpu = prevMatrices;
+	}
+
+	void Model::GatherPoseTriangles(std::vector<glm::vec3>& vertices) const
+	{
+		vertices.clear();
+		for (const Primitive& primitive : *m_CpuPhysicsData.m_PrimitiveBufferGPU)
+		{
+			const uint64_t key =
+				static_cast<uint64_t>(primitive.GetPositionIndex()) << 32 | primitive.GetIndexBufferIndex();
+			const auto triangles = m_CpuPhysicsData.m_CPUTris.find(key);
+			if (triangles == m_CpuPhysicsData.m_CPUTris.end())
+				continue;
+
+			const glm::mat4 matrix = primitive.GetMatrix();
+			for (const Triangle& triangle : triangles->second)
+			{
+				vertices.push_back(glm::vec3(matrix * glm::vec4(triangle.m_V0, 1.f)));
+				vertices.push_back(glm::vec3(matrix * glm::vec4(triangle.m_V1, 1.f)));
+				vertices.push_back(glm::vec3(matrix * glm::vec4(triangle.m_V2, 1.f)));
+			}
+		}
 	}
 
 	Model::~Model()
@@ -457,7 +682,10 @@ namespace Ball
 
 		// Remove physics trigs and set prims to nullptr
 		m_CpuPhysicsData.m_CPUTris.clear();
+		m_CpuPhysicsData.m_WireframeEdges.clear();
 		m_CpuPhysicsData.m_PrimitiveBufferGPU = nullptr;
+		m_PrimitiveBounds.clear();
+		m_Bounds = AABB();
 	}
 
 	void Model::GetCPUTrianglePrimitives(tinygltf::Model& model_cpu_data, std::vector<Mesh>& meshes)
@@ -466,47 +694,10 @@ namespace Ball
 		{
 			for (auto primitive : mesh.GetPrimitives())
 			{
-				std::vector<glm::vec3> positions;
-				std::vector<uint32_t> indices;
-
-				// Vertices
-				{
-					const auto& positionAccessor = model_cpu_data.accessors[primitive.GetPositionIndex()];
-					const auto& positionView = model_cpu_data.bufferViews[positionAccessor.bufferView];
-					const auto& positionBuffer = model_cpu_data.buffers[positionView.buffer];
-					const size_t componentSizeInBytes =
-						tinygltf::GetComponentSizeInBytes(positionAccessor.componentType);
-					const size_t numElementsInType = tinygltf::GetNumComponentsInType(positionAccessor.type);
-					const void* dataLocation =
-						(void*)&positionBuffer.data.at(positionView.byteOffset + positionAccessor.byteOffset);
-					const size_t dataSize = componentSizeInBytes * numElementsInType * positionAccessor.count;
-
-					positions.resize(positionAccessor.count);
-					memcpy(positions.data(), dataLocation, dataSize);
-				}
-
-				// Indices
-				{
-					const auto& indexAccessor = model_cpu_data.accessors[primitive.GetIndexBufferIndex()];
-					const auto& indexView = model_cpu_data.bufferViews[indexAccessor.bufferView];
-					const auto& indexBuffer = model_cpu_data.buffers[indexView.buffer];
-					const void* dataLocation =
-						(void*)&indexBuffer.data.at(indexView.byteOffset + indexAccessor.byteOffset);
-
-					// If Index buffer is not uint32_t, resize it to be this way
-					if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_SHORT ||
-						indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
-					{
-						// INFO(LOG_GRAPHICS, "Resizing %s -> uint16_t to uint32_t!", name.c_str());
-						indices = ConvertTo32BitIndices((uint16_t*)dataLocation, indexAccessor.count);
-					}
-					else if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_BYTE ||
-							 indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
-					{
-						// INFO(LOG_GRAPHICS, "Resizing %s -> uint8_t to uint32_t!", name.c_str());
-						indices = ConvertTo32BitIndices((uint8_t*)dataLocation, indexAccessor.count);
-					}
-				}
+				const std::vector<glm::vec3> positions =
+					ReadAttributeFromGLTF<glm::vec3>(model_cpu_data, primitive.GetPositionIndex());
+				const std::vector<uint32_t> indices =
+					ReadIndicesFromGLTF(model_cpu_data, primitive.GetIndexBufferIndex());
 
 				// Convert all triangles to vector and add them
 				std::vector<Triangle> primitiveTriBuffer;
@@ -531,6 +722,119 @@ namespace Ball
 		}
 	}
 
+	void Model::CreateTriangleLODBuffers(const tinygltf::Model& model, std::vector<Mesh>& meshes)
+	{
+		for (auto& mesh : meshes)
+		{
+			for (auto& primitive : mesh.GetPrimitivesRef())
+			{
+				// Nothing to pick a mip for, the shaders assume float texture coordinates like they do here
+				const int texCoordIndex = primitive.GetTexCoordIndex();
+				if (texCoordIndex == -1 ||
+					model.accessors[texCoordIndex].componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
+					continue;
+
+				std::vector<glm::vec3> normals;
+				if (primitive.GetNormalIndex() != -1)
+					normals = ReadAttributeFromGLTF<glm::vec3>(model, primitive.GetNormalIndex());
+
+				const std::vector<uint32_t> triangleLODs =
+					BuildTriangleLODs(ReadAttributeFromGLTF<glm::vec3>(model, primitive.GetPositionIndex()),
+									  ReadAttributeFromGLTF<glm::vec2>(model, texCoordIndex),
+									  normals,
+									  ReadIndicesFromGLTF(model, primitive.GetIndexBufferIndex()));
+				if (triangleLODs.empty())
+					continue;
+
+				std::lock_guard<std::mutex> lg(modelMu);
+				const std::string name =
+					"Triangle LOD Buffer [" + std::to_string(m_Buffers.size()) + "] from " + GetPath();
+				m_Buffers.push_back(BufferManager::Create(triangleLODs.data(),
+														  sizeof(uint32_t),
+														  static_cast<uint32_t>(triangleLODs.size()),
+														  BufferFlags::SRV | BufferFlags::DEFAULT_HEAP,
+														  name,
+														  MemoryTag::MODEL_GEOMETRY));
+				primitive.SetTriangleLODIndex(static_cast<int>(m_Buffers.size()) - 1);
+			}
+		}
+	}
+
+	void Model::CreateOpacityMicromaps(const tinygltf::Model& model, std::vector<Mesh>& meshes,
+									   const std::unordered_map<int, AlphaTexture>& alphaTextures)
+	{
+		const AlphaTexture noTexture;
+		OpacityMicromapStats stats;
+		size_t micromapBytes = 0;
+		for (auto& mesh : meshes)
+		{
+			for (auto& primitive : mesh.GetPrimitivesRef())
+			{
+				const int materialIndex = static_cast<int>(primitive.GetMaterialIndex());
+				if (materialIndex < 0 || materialIndex >= static_cast<int>(m_Materials.size()))
+					continue;
+				const MaterialGPU& material = m_Materials[materialIndex].m_Data;
+				if (material.m_AlphaMask == 0)
+					continue;
+
+				// Without a texture the factor decides for the whole primitive, the bake makes that a uniform state
+				const AlphaTexture* alphaTexture = &noTexture;
+				const int texCoordIndex = primitive.GetTexCoordIndex();
+				if (material.m_BaseColorTextureIndex != -1)
+				{
+					// The shaders can't alpha test what they can't sample, leave the primitive opaque
+					auto found = alphaTextures.find(material.m_BaseColorTextureIndex);
+					if (texCoordIndex == -1 || found == alphaTextures.end() || found->second.m_Alpha.empty() ||
+						model.accessors[texCoordIndex].componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
+						continue;
+					alphaTexture = &found->second;
+				}
+
+				OpacityMicromapSettings settings;
+				settings.m_AlphaCutoff = material.m_AlphaCutoff;
+				settings.m_AlphaScale = material.m_BaseColorFactor.a;
+				// The sampler heap repeats every 3 samplers, see GetSamplerHeapIndexFromGLTF
+				if (material.m_BaseColorSamplerIndex != -1)
+					settings.m_Wrap = static_cast<AlphaWrap>(material.m_BaseColorSamplerIndex % 3);
+
+				const std::vector<glm::vec3> positions =
+					ReadAttributeFromGLTF<glm::vec3>(model, primitive.GetPositionIndex());
+				const std::vector<glm::vec2> uvs = alphaTexture != &noTexture
+					? ReadAttributeFromGLTF<glm::vec2>(model, texCoordIndex)
+					: std::vector<glm::vec2>(positions.size(), glm::vec2(0.f));
+				const std::vector<uint32_t> indices = ReadIndicesFromGLTF(model, primitive.GetIndexBufferIndex());
+				const std::vector<uint32_t> micromap =
+					BuildOpacityMicromap(positions, uvs, indices, *alphaTexture, settings, &stats);
+				if (micromap.empty())
+					continue;
+				micromapBytes += micromap.size() * sizeof(uint32_t);
+
+				std::lock_guard<std::mutex> lg(modelMu);
+				const std::string name =
+					"Opacity Micromap [" + std::to_string(m_Buffers.size()) + "] from " + GetPath();
+				m_Buffers.push_back(BufferManager::Create(micromap.data(),
+														  sizeof(uint32_t),
+														  static_cast<uint32_t>(micromap.size()),
+														  BufferFlags::SRV | BufferFlags::DEFAULT_HEAP,
+														  name,
+														  MemoryTag::MODEL_GEOMETRY));
+				primitive.SetOpacityMicromapIndex(static_cast<int>(m_Buffers.size()) - 1);
+			}
+		}
+
+		if (stats.m_Triangles == 0)
+			return;
+		INFO(LOG_GRAPHICS,
+			 "Opacity micromaps of %s: %zu alpha tested triangles, %zu split into %zu micro-triangles, %zu KB. %.1f%% "
+			 "of the alpha test texture fetches eliminated",
+			 GetPath().c_str(),
+			 stats.m_Triangles,
+			 stats.m_SubdividedTriangles,
+			 stats.m_MicroTriangles,
+			 micromapBytes / 1024,
+			 stats.FetchesEliminated() * 100.0);
+	}
+
 	void Model::UpdateAnimations(float curTime)
 	{
 		if (m_HasAnimation)
@@ -1,6 +1,7 @@
 #include "Headers/Rendering/ModelLoading/ModelManager.h"
 #include "Headers/Rendering/ModelLoading/Model.h"
 
+#include "Headers/Rendering/BEAR/BLAS.h"
 #include "Headers/Rendering/BEAR/Buffer.h"
 #include "Headers/Rendering/BEAR/ResourceDescriptorHeap.h"
 #include "Headers/Rendering/BEAR/TLAS.h"
@@ -11,11 +12,15 @@
 #include "Headers/Levels/Level.h"
 
 #include "Headers/GameObjects/GameObject.h"
+#include "GameObjects/Types/Camera.h"
 #include "FileIO.h"
 #include "Shaders/ShaderHeaders/WavefrontStructsGPU.h"
 
 #include "ResourceManager/ResourceManager.h"
 #include "Utilities/LaunchParameters.h"
+#include "Utilities/CpuProfiler.h"
+#include "Utilities/FrameArena.h"
+#include "Utilities/PoolAllocator.h"
 #include "Rendering/AnimationController.h"
 
 #include "Rendering/Renderer.h"
@@ -23,6 +28,7 @@
 #include <ImGui/imgui.h>
 
 #include "Timer.h"
+#include <algorithm>
 #include <unordered_set>
 
 #include "Rendering/BufferManager.h"
@@ -147,9 +153,10 @@ namespace Ball
 		}
 #endif
 
-		// Create the Resource Desriptor Heap with all required loaded models
+		// Fill in the Resource Desriptor Heap with all required loaded models
 		int currentAddedModelsId = 0;
 		std::vector<ModelHeapLocation> cpuBuffer;
+		std::unordered_set<std::string> addedModels;
 		const auto loadedModels = ResourceManager<Model>::GetAllPaths();
 		for (const auto& path : loadedModels)
 		{
@@ -157,6 +164,8 @@ namespace Ball
 
 			if (model.IsLoaded())
 			{
+				addedModels.insert(path);
+
 				for (auto* texture : model.Get()->m_Textures)
 				{
 					if ((texture->GetSpec().m_Flags & TextureFlags::MIPMAP_GENERATE) == TextureFlags::MIPMAP_GENERATE)
@@ -170,46 +179,208 @@ namespace Ball
 			}
 		}
 
+		// Give back the slots of models that got unloaded
+		for (auto it = m_ModelDescriptorRanges.begin(); it != m_ModelDescriptorRanges.end();)
+		{
+			if (addedModels.find(it->first) == addedModels.end())
+			{
+				rdhToStoreModels.Free(it->second);
+				it = m_ModelDescriptorRanges.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
 		BufferManager::Destroy(m_ModelHeapLocationBuffer);
 		m_ModelHeapLocationBuffer = BufferManager::Create(cpuBuffer.data(),
 														  sizeof(cpuBuffer[0]),
 														  cpuBuffer.size(),
 														  BufferFlags::SRV | BufferFlags::DEFAULT_HEAP,
-														  "World Info Buffer");
+														  "World Info Buffer",
+														  MemoryTag::MODEL_GEOMETRY);
 
 		rdhToStoreModels.Switch(*m_ModelHeapLocationBuffer, RDH_MODEL_DATA);
 
+		UpdateBlasRegistrations(addedModels);
 		RebuildTLAS(rdhToStoreModels);
 		m_ReloadModels = false;
 	}
-	void ModelManager::UpdateAnimations()
+	void ModelManager::UpdateVisibility()
+	{
+		PROFILE_CPU_ZONE("Visibility");
+		m_CullingBounds.clear();
+		m_CullingIndices.clear();
+
+		Camera* camera = Camera::GetActiveCamera();
+		if (camera == nullptr)
+			return;
+
+		m_CullingFrustum = camera->GetCullingFrustum();
+		for (auto gameObject : GetLevel().GetObjectManager())
+		{
+			if (gameObject->GetModelPath().empty() || !ResourceManager<Model>::IsLoaded(gameObject->GetModelPath()))
+				continue;
+
+			const AABB& bounds = ResourceManager<Model>::Get(gameObject->GetModelPath())->GetBounds();
+			if (!bounds.IsValid())
+				continue;
+
+			m_CullingIndices[gameObject] = static_cast<uint32_t>(m_CullingBounds.size());
+			m_CullingBounds.push_back(bounds.Transformed(gameObject->GetTransform().GetModelMatrix()));
+		}
+
+		m_Visible.resize(m_CullingBounds.size());
+		m_ViewDistances.resize(m_CullingBounds.size());
+		CullAABBs(m_CullingFrustum,
+				  m_CullingBounds.data(),
+				  m_CullingBounds.size(),
+				  m_Visible.data(),
+				  m_ViewDistances.data());
+
+		if (m_DrawCullingBounds)
+		{
+			for (size_t i = 0; i < m_CullingBounds.size(); i++)
+			{
+				if (m_Visible[i])
+					RenderAPI::DrawDebugAABB(m_CullingBounds[i]);
+			}
+		}
+	}
+
+	bool ModelManager::IsVisible(const GameObject* object) const
+	{
+		const auto it = m_CullingIndices.find(object);
+		return it == m_CullingIndices.end() || m_Visible[it->second] != 0;
+	}
+
+	float ModelManager::GetViewDistance(const GameObject* object) const
+	{
+		const auto it = m_CullingIndices.find(object);
+		return it == m_CullingIndices.end() ? 0.f : m_ViewDistances[it->second];
+	}
+
+	void ModelManager::UpdateAnimations(float deltaTime)
 	{
+		PROFILE_CPU_ZONE("Animations");
+		m_AnimationFrame++;
+		uint32_t animationIndex = 0;
 		for (auto gameObject : GetLevel().GetObjectManager())
 		{
 			if (gameObject->GetAnimationControllerPtr() != nullptr)
 			{
-				// HACK : as we don't have a fixed timestep anymore
-				gameObject->GetAnimationControllerPtr()->Update(1 / 50.f);
+				// Time keeps running for skipped frames, the index spreads the evaluations of throttled
+				// animations over the frames instead of doing all of them on the same one
+				uint32_t interval = 1;
+				if (!IsVisible(gameObject))
+					interval = static_cast<uint32_t>((std::max)(m_OffscreenAnimationInterval, 1));
+				else if (GetViewDistance(gameObject) > m_AnimationLodDistance)
+					interval = 2;
+				const bool evaluatePose = (m_AnimationFrame + animationIndex++) % interval == 0;
+
+				gameObject->GetAnimationControllerPtr()->Update(deltaTime, evaluatePose);
+			}
+		}
+	}
+
+	void ModelManager::UpdateBlasRegistrations(const std::unordered_set<std::string>& loadedPaths)
+	{
+		for (auto it = m_BlasRecords.begin(); it != m_BlasRecords.end();)
+		{
+			const bool loaded = loadedPaths.find(it->first) != loadedPaths.end();
+			Model* model = loaded ? ResourceManager<Model>::Get(it->first).Get() : nullptr;
+			// Reloaded models come with a new BLAS
+			if (model == it->second.m_Model && &model->GetBLAS() == it->second.m_Blas)
+			{
+				++it;
+				continue;
 			}
+
+			m_BlasPolicy.Unregister(it->second.m_PolicyId);
+			it = m_BlasRecords.erase(it);
+		}
+
+		for (const std::string& path : loadedPaths)
+		{
+			if (m_BlasRecords.find(path) != m_BlasRecords.end())
+				continue;
+
+			BlasRecord record;
+			record.m_Model = ResourceManager<Model>::Get(path).Get();
+			record.m_Blas = &record.m_Model->GetBLAS();
+			const BlasUsage usage = AllowsRefit(record.m_Blas->GetQuality()) ? BlasUsage::DEFORMING : BlasUsage::STATIC;
+			record.m_PolicyId = m_BlasPolicy.Register(usage, record.m_Model->GetBlasTriangleCount());
+			if (record.m_PolicyId >= m_BlasPaths.size())
+				m_BlasPaths.resize(record.m_PolicyId + 1);
+			m_BlasPaths[record.m_PolicyId] = path;
+			m_BlasRecords[path] = record;
 		}
 	}
 
 	void ModelManager::UpdateAnimationsGPU()
 	{
-		for (int i = 0; i < m_AnimatedGameObjects.size(); i++)
+		PROFILE_CPU_ZONE("BLAS Updates");
+		// The compacted size of a build is read back once its slot comes around again, so no earlier than the frames
+		// in flight later
+		BlasPolicySettings& blasSettings = m_BlasPolicy.GetSettings();
+		blasSettings.m_CompactionDelay =
+			(std::max)(blasSettings.m_CompactionDelay, GetRenderer().GetFrameScheduler().GetFramesInFlight());
+
+		// Objects can share an animated model, its BLAS only follows the pose once
+		FrameVector<Model*> posedModels;
+		for (GameObject* gameObject : m_AnimatedGameObjects)
+		{
+			if (gameObject == nullptr || gameObject->GetAnimationControllerPtr() == nullptr)
+				continue;
+
+			const AnimationController* controller = gameObject->GetAnimationControllerPtr();
+			if (controller->IsPoseDirty() &&
+				std::find(posedModels.begin(), posedModels.end(), controller->GetModel()) == posedModels.end())
+				posedModels.push_back(controller->GetModel());
+		}
+
+		for (Model* model : posedModels)
 		{
-			if (m_AnimatedGameObjects[i] != nullptr)
+			const float degradation = model->UpdateBlasPose();
+			const auto record = m_BlasRecords.find(model->GetPath());
+			if (record != m_BlasRecords.end() && record->second.m_Model == model)
+				m_BlasPolicy.MarkDeformed(record->second.m_PolicyId, degradation);
+		}
+
+		for (const BlasTask& task : m_BlasPolicy.Schedule())
+		{
+			BlasRecord& record = m_BlasRecords.at(m_BlasPaths[task.m_Id]);
+			switch (task.m_Operation)
+			{
+			case BlasOperation::REFIT:
+				record.m_Model->RefitBlas();
+				break;
+			case BlasOperation::REBUILD:
+				record.m_Model->RebuildBlas();
+				break;
+			case BlasOperation::COMPACT:
 			{
-				if (m_AnimatedGameObjects[i]->GetAnimationControllerPtr() != nullptr)
+				const uint64_t sizeBefore = record.m_Blas->GetSizeInBytes();
+				if (record.m_Blas->Compact())
 				{
-					m_AnimatedGameObjects[i]->GetAnimationControllerPtr()->RebuildModelBlas();
+					m_BlasPolicy.ReportCompaction(task.m_Id, sizeBefore, record.m_Blas->GetSizeInBytes());
+					INFO(LOG_GRAPHICS,
+						 "Compacted BLAS of %s from %.2f MB to %.2f MB, %.2f MB saved in total",
+						 m_BlasPaths[task.m_Id].c_str(),
+						 static_cast<double>(sizeBefore) / (1024.0 * 1024.0),
+						 static_cast<double>(record.m_Blas->GetSizeInBytes()) / (1024.0 * 1024.0),
+						 static_cast<double>(m_BlasPolicy.GetStats().MemorySaved()) / (1024.0 * 1024.0));
 				}
+				break;
+			}
 			}
 		}
 	}
 	void ModelManager::UpdateInstanceTransformsBuffer()
 	{
-		std::vector<GameObject*> objectsWithModels;
+		FrameVector<GameObject*> objectsWithModels;
+		objectsWithModels.reserve(GetLevel().GetObjectManager().Size());
 		uint32_t index = 0;
 		for (auto const& object : GetLevel().GetObjectManager())
 		{
@@ -232,8 +403,8 @@ namespace Ball
 
 		// I do not like this approach, but I like the idea directly updating a TlasInstanceData*
 		// that lives in the Renderer from GameObject even less. - [ Angel 19/01/24 ]
-		std::vector<glm::mat4> instanceTransforms;
-		instanceTransforms.reserve(GetLevel().GetObjectManager().Size());
+		FrameVector<glm::mat4> instanceTransforms;
+		instanceTransforms.reserve(objectsWithModels.size());
 
 		for (int i = 0; i < objectsWithModels.size(); i++)
 		{
@@ -248,27 +419,40 @@ namespace Ball
 
 	ModelHeapLocation ModelManager::AddModel(ResourceDescriptorHeap& rdhToStoreModels, const Resource<Model> model)
 	{
+		// Primitive Info + Material Info + Buffers + Textures, see ModelHeapLocation
+		const uint32_t numDescriptors =
+			static_cast<uint32_t>(2 + model->m_Buffers.size() + model->m_Textures.size());
+
+		// A model keeps its slots between reloads, the views are recreated in place
+		DescriptorRange& range = m_ModelDescriptorRanges[model->GetPath()];
+		if (range.m_Count != numDescriptors)
+		{
+			rdhToStoreModels.Free(range);
+			range = rdhToStoreModels.Allocate(numDescriptors, model->GetPath());
+		}
+
+		int heapID = range.m_Start;
 		ModelHeapLocation info;
-		info.m_ModelStart = rdhToStoreModels.GetNumElements();
-		rdhToStoreModels.Add(*model->m_GPUPrimitiveBuffer);
-		rdhToStoreModels.Add(*model->m_GPUMaterialBuffer);
+		info.m_ModelStart = heapID;
+		rdhToStoreModels.Add(*model->m_GPUPrimitiveBuffer, heapID++);
+		rdhToStoreModels.Add(*model->m_GPUMaterialBuffer, heapID++);
 
 		{
 			// Push Back the Buffers
 			for (const auto& buffer : model->m_Buffers)
 			{
-				rdhToStoreModels.Add(*buffer);
+				rdhToStoreModels.Add(*buffer, heapID++);
 			}
 		}
 
 		// Location of First Texture
 		{
-			info.m_TextureStart = rdhToStoreModels.GetNumElements();
+			info.m_TextureStart = heapID;
 
 			// Push Back the Textures
 			for (const auto& texture : model->m_Textures)
 			{
-				rdhToStoreModels.Add(*texture);
+				rdhToStoreModels.Add(*texture, heapID++);
 			}
 		}
 
@@ -314,8 +498,9 @@ namespace Ball
 		m_InstanceTransformsBuffer = BufferManager::Create(instanceTransforms.data(),
 														   sizeof(glm::mat4),
 														   tlasConstructionData.size(),
-														   BufferFlags::SRV | BufferFlags::UPLOAD_HEAP,
-														   "Transform Buffer");
+														   BufferFlags::SRV | BufferFlags::PER_FRAME,
+														   "Transform Buffer",
+														   MemoryTag::MODEL_GEOMETRY);
 		rdhToStoreTLASBuffers.Switch(*m_InstanceTransformsBuffer, RDH_TRANSFORMS);
 
 		m_TLAS = new TLAS(tlasConstructionData);
@@ -360,7 +545,8 @@ namespace Ball
 											sizeof(LightPickData),
 											lightDataCPU.size(),
 											(BufferFlags::SRV | BufferFlags::DEFAULT_HEAP),
-											"Lights");
+											"Lights",
+											MemoryTag::MODEL_GEOMETRY);
 	}
 
 	std::vector<TlasInstanceData*> ModelManager::CreateTlasInstanceData()
@@ -379,7 +565,7 @@ namespace Ball
 			if (!modelRef.IsLoaded())
 				continue;
 
-			const auto instance = new TlasInstanceData; // Deallocated in TLAS Destructor / Destroy()
+			const auto instance = ObjectPool<TlasInstanceData>::New(); // Deallocated in TLAS Destructor / Destroy()
 
 			instance->m_Blas = &modelRef->GetBLAS();
 			instance->m_Transform = object->GetTransform().GetModelMatrix();
@@ -394,6 +580,26 @@ namespace Ball
 		// Animations
 		if (ImGui::CollapsingHeader("Animations"))
 		{
+			ImGui::SliderInt("Off-screen Update Interval", &m_OffscreenAnimationInterval, 1, 32);
+			ImGui::DragFloat("LOD Distance", &m_AnimationLodDistance, 1.f, 0.f, 10000.f);
+			ImGui::Checkbox("Draw Culling Bounds", &m_DrawCullingBounds);
+			ImGui::Separator();
+
+			BlasPolicySettings& blasSettings = m_BlasPolicy.GetSettings();
+			const BlasPolicyStats& blasStats = m_BlasPolicy.GetStats();
+			ImGui::DragFloat("BLAS Budget (ms)", &blasSettings.m_FrameBudgetMs, 0.05f, 0.f, 33.f);
+			ImGui::DragFloat("BLAS Rebuild Threshold", &blasSettings.m_RebuildThreshold, 0.01f, 1.f, 10.f);
+			ImGui::Text("BLAS refits %llu, rebuilds %llu, compactions %llu",
+						static_cast<unsigned long long>(blasStats.m_Refits),
+						static_cast<unsigned long long>(blasStats.m_Rebuilds),
+						static_cast<unsigned long long>(blasStats.m_Compactions));
+			ImGui::Text("Deferred rebuilds %u, compactions %u, estimated %.3f ms",
+						blasStats.m_DeferredRebuilds,
+						blasStats.m_DeferredCompactions,
+						blasStats.m_EstimatedMs);
+			ImGui::Text("Compaction saved %.2f MB", static_cast<double>(blasStats.MemorySaved()) / (1024.0 * 1024.0));
+			ImGui::Separator();
+
 			for (int i = 0; i < m_AnimatedGameObjects.size(); i++)
 			{
 				ImGui::Checkbox((std::string("Pause ") + std::to_string(i)).c_str(),
@@ -18,7 +18,8 @@ namespace Ball
 		defaultPrim.m_TangentIndex = -1;
 		defaultPrim.m_NormalIndex = -1;
 		defaultPrim.m_ColorIndex = -1;
-		defaultPrim.padding = -1;
+		defaultPrim.m_TriangleLODIndex = -1;
+		defaultPrim.m_OpacityMicromapIndex = -1;
 
 		return defaultPrim;
 	}
@@ -0,0 +1,355 @@
+#include "Rendering/OpacityMicromap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <numeric>
+
+#include <glm/glm.hpp>
+
+namespace Ball
+{
+	using namespace OpacityMicromap;
+
+	namespace
+	{
+		// Descriptors only have 26 bits for where the states start
+		constexpr uint32_t MAX_STATE_OFFSET = 1u << (32u - OPACITY_OFFSET_SHIFT);
+		// A query reads at most this many blocks of the pyramid per axis
+		constexpr int64_t MAX_QUERY_BLOCKS = 8;
+		// Keeps texels that a uv bound only touches within float precision in the query
+		constexpr float QUERY_MARGIN = 1e-3f;
+
+		int64_t FloorDiv(int64_t a, int64_t b)
+		{
+			return a >= 0 ? a / b : -((-a + b - 1) / b);
+		}
+
+		uint32_t WrapTexel(int64_t x, uint32_t size, AlphaWrap wrap)
+		{
+			const int64_t n = size;
+			switch (wrap)
+			{
+			case AlphaWrap::CLAMP:
+				return static_cast<uint32_t>(std::clamp<int64_t>(x, 0, n - 1));
+			case AlphaWrap::MIRROR:
+			{
+				const int64_t m = x - FloorDiv(x, 2 * n) * 2 * n;
+				return static_cast<uint32_t>(m < n ? m : 2 * n - 1 - m);
+			}
+			default:
+				return static_cast<uint32_t>(x - FloorDiv(x, n) * n);
+			}
+		}
+
+		// Texels [first, last] of an unwrapped axis as up to three ranges inside the texture
+		struct AxisRanges
+		{
+			uint32_t m_Count = 0;
+			uint32_t m_First[3];
+			uint32_t m_Last[3];
+		};
+
+		AxisRanges WrapRange(int64_t first, int64_t last, uint32_t size, AlphaWrap wrap)
+		{
+			AxisRanges ranges;
+			const int64_t period = wrap == AlphaWrap::MIRROR ? 2 * int64_t(size) : int64_t(size);
+			if (wrap != AlphaWrap::CLAMP && last - first + 1 >= period)
+			{
+				ranges.m_Count = 1;
+				ranges.m_First[0] = 0;
+				ranges.m_Last[0] = size - 1;
+				return ranges;
+			}
+
+			// Every tile of the texture the range crosses maps to one contiguous range, clamping only has one
+			for (int64_t start = first; start <= last && ranges.m_Count < 3;)
+			{
+				int64_t end = last;
+				if (wrap != AlphaWrap::CLAMP)
+					end = (std::min)(last, (FloorDiv(start, size) + 1) * size - 1);
+				const uint32_t a = WrapTexel(start, size, wrap);
+				const uint32_t b = WrapTexel(end, size, wrap);
+				ranges.m_First[ranges.m_Count] = (std::min)(a, b);
+				ranges.m_Last[ranges.m_Count] = (std::max)(a, b);
+				ranges.m_Count++;
+				start = end + 1;
+			}
+			return ranges;
+		}
+
+		// Min and max alpha of aligned 2^k x 2^k blocks of texels, level 0 are the texels
+		class AlphaPyramid
+		{
+		public:
+			explicit AlphaPyramid(const AlphaTexture& texture)
+			{
+				uint32_t width = (std::max)(texture.m_Width, 1u);
+				uint32_t height = (std::max)(texture.m_Height, 1u);
+				Level base = {width, height, std::vector<uint16_t>(width * height, AlphaTexture::MAX_VALUE), {}};
+				if (texture.m_Alpha.size() == size_t(width) * height)
+					base.m_Min = texture.m_Alpha;
+				base.m_Max = base.m_Min;
+				m_Levels.push_back(std::move(base));
+
+				while (width > 1 || height > 1)
+				{
+					const Level& fine = m_Levels.back();
+					const uint32_t w = (width + 1) / 2;
+					const uint32_t h = (height + 1) / 2;
+					Level coarse = {w,
+									h,
+									std::vector<uint16_t>(w * h, AlphaTexture::MAX_VALUE),
+									std::vector<uint16_t>(w * h, 0u)};
+					for (uint32_t y = 0; y < height; y++)
+					{
+						for (uint32_t x = 0; x < width; x++)
+						{
+							const size_t src = size_t(y) * width + x;
+							const size_t dst = size_t(y / 2) * w + x / 2;
+							coarse.m_Min[dst] = (std::min)(coarse.m_Min[dst], fine.m_Min[src]);
+							coarse.m_Max[dst] = (std::max)(coarse.m_Max[dst], fine.m_Max[src]);
+						}
+					}
+					m_Levels.push_back(std::move(coarse));
+					width = w;
+					height = h;
+				}
+			}
+
+			uint32_t Width() const { return m_Levels[0].m_Width; }
+			uint32_t Height() const { return m_Levels[0].m_Height; }
+
+			// Bounds of the alpha of texels [x0, x1] x [y0, y1], wider when the blocks reach past the rectangle
+			void Query(uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1, uint16_t& minAlpha, uint16_t& maxAlpha) const
+			{
+				uint32_t k = 0;
+				while (k + 1 < m_Levels.size() &&
+					   ((x1 >> k) - (x0 >> k) >= MAX_QUERY_BLOCKS || (y1 >> k) - (y0 >> k) >= MAX_QUERY_BLOCKS))
+					k++;
+
+				const Level& level = m_Levels[k];
+				for (uint32_t y = y0 >> k; y <= y1 >> k; y++)
+				{
+					for (uint32_t x = x0 >> k; x <= x1 >> k; x++)
+					{
+						minAlpha = (std::min)(minAlpha, level.m_Min[size_t(y) * level.m_Width + x]);
+						maxAlpha = (std::max)(maxAlpha, level.m_Max[size_t(y) * level.m_Width + x]);
+					}
+				}
+			}
+
+		private:
+			struct Level
+			{
+				uint32_t m_Width;
+				uint32_t m_Height;
+				std::vector<uint16_t> m_Min;
+				std::vector<uint16_t> m_Max;
+			};
+			std::vector<Level> m_Levels;
+		};
+
+		uint32_t ClassifyUVTriangle(const AlphaPyramid& pyramid, glm::vec2 uv0, glm::vec2 uv1, glm::vec2 uv2,
+									const OpacityMicromapSettings& settings)
+		{
+			// Bilinear filtering reads the texels around uv * size - 0.5, point filtering the one at uv * size
+			const glm::vec2 size(pyramid.Width(), pyramid.Height());
+			const glm::vec2 lo = glm::min(glm::min(uv0, uv1), uv2) * size - 0.5f - QUERY_MARGIN;
+			const glm::vec2 hi = glm::max(glm::max(uv0, uv1), uv2) * size - 0.5f + QUERY_MARGIN;
+			// Also keeps uvs from overflowing the texel indices
+			if (!(glm::all(glm::lessThan(glm::abs(lo), glm::vec2(1e9f))) &&
+				  glm::all(glm::lessThan(glm::abs(hi), glm::vec2(1e9f)))))
+				return OPACITY_UNKNOWN;
+
+			const AxisRanges xs = WrapRange(static_cast<int64_t>(std::floor(lo.x)),
+											static_cast<int64_t>(std::floor(hi.x)) + 1,
+											pyramid.Width(),
+											settings.m_Wrap);
+			const AxisRanges ys = WrapRange(static_cast<int64_t>(std::floor(lo.y)),
+											static_cast<int64_t>(std::floor(hi.y)) + 1,
+											pyramid.Height(),
+											settings.m_Wrap);
+
+			uint16_t minAlpha = AlphaTexture::MAX_VALUE;
+			uint16_t maxAlpha = 0u;
+			for (uint32_t y = 0; y < ys.m_Count; y++)
+			{
+				for (uint32_t x = 0; x < xs.m_Count; x++)
+					pyramid.Query(xs.m_First[x], xs.m_Last[x], ys.m_First[y], ys.m_Last[y], minAlpha, maxAlpha);
+			}
+
+			// Filtering never leaves [min, max] of the texels it blends
+			if (float(minAlpha) / AlphaTexture::MAX_VALUE * settings.m_AlphaScale >= settings.m_AlphaCutoff)
+				return OPACITY_OPAQUE;
+			if (float(maxAlpha) / AlphaTexture::MAX_VALUE * settings.m_AlphaScale < settings.m_AlphaCutoff)
+				return OPACITY_TRANSPARENT;
+			return OPACITY_UNKNOWN;
+		}
+
+		// Subdivision level that gives micro-triangles of about settings.m_TexelsPerMicroTriangle texels
+		uint32_t SubdivisionLevel(const AlphaPyramid& pyramid, glm::vec2 uv0, glm::vec2 uv1, glm::vec2 uv2,
+								  const OpacityMicromapSettings& settings)
+		{
+			const uint32_t maxLevel = (std::min)(settings.m_MaxLevel, OPACITY_MAX_LEVEL);
+			const glm::vec2 e1 = uv1 - uv0;
+			const glm::vec2 e2 = uv2 - uv0;
+			const float texelArea = 0.5f * std::abs(e1.x * e2.y - e1.y * e2.x) * pyramid.Width() * pyramid.Height();
+			const float microTriangles = texelArea / (std::max)(settings.m_TexelsPerMicroTriangle, 1e-3f);
+			if (maxLevel == 0 || !(microTriangles > 1.f))
+				return (std::min)(maxLevel, 1u);
+
+			// 4^level micro-triangles
+			const float level = std::ceil(0.5f * std::log2(microTriangles));
+			return (std::min)(static_cast<uint32_t>(level), maxLevel);
+		}
+
+		struct TriangleBake
+		{
+			uint32_t m_State = OPACITY_UNKNOWN;
+			uint32_t m_Level = 0;
+			std::vector<uint8_t> m_States;
+			double m_Area = 0.0;
+			double m_KnownArea = 0.0;
+		};
+
+		TriangleBake BakeTriangle(const AlphaPyramid& pyramid, glm::vec2 uv0, glm::vec2 uv1, glm::vec2 uv2,
+								  double area, const OpacityMicromapSettings& settings)
+		{
+			TriangleBake bake;
+			bake.m_Area = area;
+			bake.m_State = ClassifyUVTriangle(pyramid, uv0, uv1, uv2, settings);
+			const uint32_t level = SubdivisionLevel(pyramid, uv0, uv1, uv2, settings);
+			if (bake.m_State == OPACITY_UNKNOWN && level > 0)
+			{
+				const uint32_t count = MicroTriangleCount(level);
+				bake.m_States.resize(count);
+				uint32_t known = 0;
+				for (uint32_t i = 0; i < count; i++)
+				{
+					glm::vec2 b0, b1, b2;
+					MicroTriangleBarycentrics(i, level, b0, b1, b2);
+					const auto toUV = [&](glm::vec2 b) { return uv0 * (1.f - b.x - b.y) + uv1 * b.x + uv2 * b.y; };
+					bake.m_States[i] = static_cast<uint8_t>(
+						ClassifyUVTriangle(pyramid, toUV(b0), toUV(b1), toUV(b2), settings));
+					known += bake.m_States[i] != OPACITY_UNKNOWN;
+				}
+
+				// Keep the micro-triangles only when they tell more than the triangle as a whole
+				const bool uniform = std::all_of(
+					bake.m_States.begin(), bake.m_States.end(), [&](uint8_t s) { return s == bake.m_States[0]; });
+				if (uniform)
+				{
+					bake.m_State = bake.m_States[0];
+					bake.m_States.clear();
+				}
+				else
+				{
+					bake.m_Level = level;
+					bake.m_KnownArea = area * known / count;
+					return bake;
+				}
+			}
+
+			bake.m_KnownArea = bake.m_State == OPACITY_UNKNOWN ? 0.0 : area;
+			return bake;
+		}
+	} // namespace
+
+	void OpacityMicromapStats::Add(const OpacityMicromapStats& other)
+	{
+		m_Triangles += other.m_Triangles;
+		m_SubdividedTriangles += other.m_SubdividedTriangles;
+		m_MicroTriangles += other.m_MicroTriangles;
+		m_TotalArea += other.m_TotalArea;
+		m_KnownArea += other.m_KnownArea;
+	}
+
+	float SampleAlphaBilinear(const AlphaTexture& texture, glm::vec2 uv, const OpacityMicromapSettings& settings)
+	{
+		if (texture.m_Width == 0 || texture.m_Height == 0)
+			return settings.m_AlphaScale;
+
+		const float x = uv.x * texture.m_Width - 0.5f;
+		const float y = uv.y * texture.m_Height - 0.5f;
+		const float x0 = std::floor(x);
+		const float y0 = std::floor(y);
+		const float fx = x - x0;
+		const float fy = y - y0;
+
+		const auto texel = [&](float tx, float ty)
+		{
+			const uint32_t wx = WrapTexel(static_cast<int64_t>(tx), texture.m_Width, settings.m_Wrap);
+			const uint32_t wy = WrapTexel(static_cast<int64_t>(ty), texture.m_Height, settings.m_Wrap);
+			return float(texture.m_Alpha[size_t(wy) * texture.m_Width + wx]) / AlphaTexture::MAX_VALUE;
+		};
+		const float top = texel(x0, y0) * (1.f - fx) + texel(x0 + 1.f, y0) * fx;
+		const float bottom = texel(x0, y0 + 1.f) * (1.f - fx) + texel(x0 + 1.f, y0 + 1.f) * fx;
+		return (top * (1.f - fy) + bottom * fy) * settings.m_AlphaScale;
+	}
+
+	std::vector<uint32_t> BuildOpacityMicromap(const std::vector<glm::vec3>& positions,
+											   const std::vector<glm::vec2>& uvs,
+											   const std::vector<uint32_t>& indices,
+											   const AlphaTexture& texture,
+											   const OpacityMicromapSettings& settings,
+											   OpacityMicromapStats* stats)
+	{
+		const AlphaPyramid pyramid(texture);
+		const uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+		const size_t numVertices = (std::min)(positions.size(), uvs.size());
+
+		std::vector<TriangleBake> bakes(numTriangles);
+		std::vector<uint32_t> triangles(numTriangles);
+		std::iota(triangles.begin(), triangles.end(), 0u);
+		std::for_each(std::execution::par,
+					  triangles.begin(),
+					  triangles.end(),
+					  [&](uint32_t t)
+					  {
+						  const uint32_t i0 = indices[3 * t + 0];
+						  const uint32_t i1 = indices[3 * t + 1];
+						  const uint32_t i2 = indices[3 * t + 2];
+						  if (i0 >= numVertices || i1 >= numVertices || i2 >= numVertices)
+							  return;
+
+						  const glm::vec3 e1 = positions[i1] - positions[i0];
+						  const glm::vec3 e2 = positions[i2] - positions[i0];
+						  const double area = 0.5 * glm::length(glm::cross(e1, e2));
+						  bakes[t] = BakeTriangle(pyramid, uvs[i0], uvs[i1], uvs[i2], area, settings);
+					  });
+
+		// Descriptors first, then the states of the subdivided triangles one after another
+		std::vector<uint32_t> micromap(numTriangles, 0u);
+		uint32_t nextState = numTriangles * OPACITY_STATES_PER_WORD;
+		OpacityMicromapStats bakeStats;
+		bakeStats.m_Triangles = numTriangles;
+		for (uint32_t t = 0; t < numTriangles; t++)
+		{
+			const TriangleBake& bake = bakes[t];
+			const uint32_t count = static_cast<uint32_t>(bake.m_States.size());
+			bakeStats.m_TotalArea += bake.m_Area;
+			if (bake.m_Level == 0 || nextState + count >= MAX_STATE_OFFSET)
+			{
+				micromap[t] = OpacityDescriptor(bake.m_Level == 0 ? bake.m_State : OPACITY_UNKNOWN, 0u, 0u);
+				bakeStats.m_KnownArea += bake.m_Level == 0 ? bake.m_KnownArea : 0.0;
+				continue;
+			}
+
+			micromap[t] = OpacityDescriptor(OPACITY_UNKNOWN, bake.m_Level, nextState);
+			micromap.resize((nextState + count + OPACITY_STATES_PER_WORD - 1) / OPACITY_STATES_PER_WORD, 0u);
+			for (uint32_t i = 0; i < count; i++, nextState++)
+			{
+				micromap[nextState / OPACITY_STATES_PER_WORD] |= uint32_t(bake.m_States[i])
+					<< (2u * (nextState % OPACITY_STATES_PER_WORD));
+			}
+			bakeStats.m_SubdividedTriangles++;
+			bakeStats.m_MicroTriangles += count;
+			bakeStats.m_KnownArea += bake.m_KnownArea;
+		}
+
+		if (stats)
+			stats->Add(bakeStats);
+		return micromap;
+	}
+} // namespace Ball
@@ -0,0 +1,457 @@
+#include "Rendering/ReSTIRReference.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ShaderHeaders/ReservoirGPU.h"
+
+namespace Ball
+{
+	namespace
+	{
+		using namespace ReSTIR;
+		using ShaderRandom::CombineIntoSeed;
+		using ShaderRandom::GetWangHashSeed;
+
+		// Size of a pixel in world units
+		constexpr float PIXEL_SIZE = 0.125f;
+		constexpr float OCCLUDED_FRACTION = 0.1f;
+
+		struct PointLight
+		{
+			glm::vec3 m_Position;
+			float m_Intensity;
+		};
+
+		struct Surface
+		{
+			glm::vec3 m_Position;
+			glm::vec3 m_Normal;
+		};
+
+		// A reservoir that takes part in a reuse pass, together with the surface of the pixel it was made for
+		struct ReuseInput
+		{
+			Reservoir m_Reservoir;
+			const Surface* m_Surface;
+		};
+
+		class Scene
+		{
+		public:
+			Scene(const ReSTIRReferenceSettings& settings) : m_Settings(settings)
+			{
+				uint32_t seed = GetWangHashSeed(settings.m_Seed);
+				const float width = static_cast<float>(settings.m_Width) * PIXEL_SIZE;
+				const float height = static_cast<float>(settings.m_Height) * PIXEL_SIZE;
+				m_Lights.resize(settings.m_NumLights);
+				for (PointLight& light : m_Lights)
+				{
+					light.m_Position.x = rand(seed) * width;
+					light.m_Position.y = rand(seed) * height;
+					light.m_Position.z = 1.2f + rand(seed);
+					light.m_Intensity = 0.2f + rand(seed) * 0.8f;
+				}
+			}
+
+			// Valley along the y axis, the two planes meet in the middle of the screen
+			Surface GetSurface(float screenX, float screenY) const
+			{
+				const float tilt = m_Settings.m_CreaseAngle;
+				const float creaseX = static_cast<float>(m_Settings.m_Width) * 0.5f;
+				const float side = screenX < creaseX ? 1.f : -1.f;
+
+				Surface surface;
+				surface.m_Position.x = screenX * PIXEL_SIZE;
+				surface.m_Position.y = screenY * PIXEL_SIZE;
+				surface.m_Position.z = std::abs(screenX - creaseX) * PIXEL_SIZE * std::tan(tilt);
+				surface.m_Normal = glm::vec3(side * std::sin(tilt), 0.f, std::cos(tilt));
+				return surface;
+			}
+
+			// Unshadowed contribution, what the reservoirs resample
+			float Target(const Surface& surface, uint32_t lightIdx) const
+			{
+				if (lightIdx >= m_Lights.size())
+					return 0.f;
+
+				// Wall along the crease, lights only reach the plane on their side
+				const PointLight& light = m_Lights[lightIdx];
+				const float creaseX = static_cast<float>(m_Settings.m_Width) * 0.5f * PIXEL_SIZE;
+				if ((light.m_Position.x < creaseX) != (surface.m_Position.x < creaseX))
+					return 0.f;
+
+				const glm::vec3 toLight = light.m_Position - surface.m_Position;
+				const float distanceSq = (std::max)(glm::dot(toLight, toLight), 1e-3f);
+				const float cosTheta = glm::dot(surface.m_Normal, toLight) / std::sqrt(distanceSq);
+				return light.m_Intensity * (std::max)(cosTheta, 0.f) / distanceSq;
+			}
+
+			// Blocky shadows, the same for every point in a 0.5 x 0.5 world cell
+			float Integrand(const Surface& surface, uint32_t lightIdx) const
+			{
+				const uint32_t cellX = static_cast<uint32_t>(surface.m_Position.x * 2.f);
+				const uint32_t cellY = static_cast<uint32_t>(surface.m_Position.y * 2.f);
+				uint32_t hash = GetWangHashSeed(CombineIntoSeed(cellX + cellY * 1024u, lightIdx, m_Settings.m_Seed));
+				const bool occluded = rand(hash) < OCCLUDED_FRACTION;
+				return occluded ? 0.f : Target(surface, lightIdx);
+			}
+
+			double GroundTruth(const Surface& surface) const
+			{
+				double sum = 0.0;
+				for (uint32_t i = 0; i < m_Lights.size(); i++)
+					sum += Integrand(surface, i);
+				return sum;
+			}
+
+		private:
+			const ReSTIRReferenceSettings& m_Settings;
+			std::vector<PointLight> m_Lights;
+		};
+
+		bool HasSample(const Reservoir& reservoir)
+		{
+			return reservoir.m_PickedLightIdx != RESERVOIR_NO_LIGHT && reservoir.m_Weight > 0.f;
+		}
+
+		// Merges the inputs into the canonical reservoir (inputs[0]), the result belongs to the canonical surface
+		Reservoir Combine(const Scene& scene,
+						  ReservoirCombine combine,
+						  const std::vector<ReuseInput>& inputs,
+						  uint32_t& seed,
+						  uint64_t& targetEvaluations)
+		{
+			const ReuseInput& canonical = inputs[0];
+			const size_t numInputs = inputs.size();
+			if (numInputs == 1)
+				return canonical.m_Reservoir;
+
+			Reservoir result = InitEmptyReservoir();
+			switch (combine)
+			{
+			case ReservoirCombine::BIASED_SOURCE_TARGET:
+				result = canonical.m_Reservoir;
+				for (size_t i = 1; i < numInputs; i++)
+					result = CombineReservoirs(result, inputs[i].m_Reservoir, seed);
+				break;
+
+			case ReservoirCombine::BIASED:
+				for (const ReuseInput& input : inputs)
+				{
+					const Reservoir& r = input.m_Reservoir;
+					const uint32_t lightIdx = r.m_PickedLightIdx;
+					const float pHat = HasSample(r) ? scene.Target(*canonical.m_Surface, lightIdx) : 0.f;
+					targetEvaluations++;
+					UpdateReservoir(result, lightIdx, pHat, rcp(r.m_Weight * r.m_EvalLights), r.m_EvalLights, seed);
+				}
+				CalculateReservoirWeight(result);
+				break;
+
+			case ReservoirCombine::GENERALIZED_BALANCE:
+				for (const ReuseInput& input : inputs)
+				{
+					const Reservoir& r = input.m_Reservoir;
+					float misWeight = 0.f;
+					float pHat = 0.f;
+					if (HasSample(r))
+					{
+						float confidencePHatSum = 0.f;
+						float ownPHat = 0.f;
+						for (const ReuseInput& other : inputs)
+						{
+							const float otherPHat = scene.Target(*other.m_Surface, r.m_PickedLightIdx);
+							confidencePHatSum += other.m_Reservoir.m_EvalLights * otherPHat;
+							if (&other == &input)
+								ownPHat = otherPHat;
+							if (&other == &canonical)
+								pHat = otherPHat;
+						}
+						targetEvaluations += numInputs;
+						misWeight = GeneralizedBalanceWeight(r.m_EvalLights, ownPHat, confidencePHatSum);
+					}
+					UpdateReservoirMIS(result, r.m_PickedLightIdx, pHat, r.m_Weight, misWeight, r.m_EvalLights, seed);
+				}
+				CalculateReservoirWeightMIS(result);
+				break;
+
+			case ReservoirCombine::PAIRWISE:
+			{
+				const float numNeighbours = static_cast<float>(numInputs - 1);
+				const Reservoir& c = canonical.m_Reservoir;
+				const Surface& cSurface = *canonical.m_Surface;
+
+				float canonicalWeight = 0.f;
+				float canonicalPHat = 0.f;
+				if (HasSample(c))
+				{
+					canonicalPHat = scene.Target(cSurface, c.m_PickedLightIdx);
+					for (size_t i = 1; i < numInputs; i++)
+					{
+						const ReuseInput& neighbour = inputs[i];
+						const float neighbourPHat = scene.Target(*neighbour.m_Surface, c.m_PickedLightIdx);
+						canonicalWeight += PairwiseCanonicalWeight(neighbour.m_Reservoir.m_EvalLights,
+																   neighbourPHat,
+																   c.m_EvalLights,
+																   canonicalPHat,
+																   numNeighbours);
+					}
+					targetEvaluations += numInputs;
+				}
+				UpdateReservoirMIS(result, c.m_PickedLightIdx, canonicalPHat, c.m_Weight, canonicalWeight,
+								   c.m_EvalLights, seed);
+
+				for (size_t i = 1; i < numInputs; i++)
+				{
+					const Reservoir& r = inputs[i].m_Reservoir;
+					float misWeight = 0.f;
+					float pHat = 0.f;
+					if (HasSample(r))
+					{
+						const float neighbourPHat = scene.Target(*inputs[i].m_Surface, r.m_PickedLightIdx);
+						pHat = scene.Target(cSurface, r.m_PickedLightIdx);
+						misWeight = PairwiseNeighbourWeight(r.m_EvalLights, neighbourPHat, c.m_EvalLights, pHat,
+															numNeighbours);
+						targetEvaluations += 2;
+					}
+					UpdateReservoirMIS(result, r.m_PickedLightIdx, pHat, r.m_Weight, misWeight, r.m_EvalLights, seed);
+				}
+				CalculateReservoirWeightMIS(result);
+				break;
+			}
+			}
+			return result;
+		}
+
+		// Normal deviation test of ReprojectReSTIR.hlsl and SpatialReSTIR.hlsl, the depth test has nothing to reject
+		bool IsNeighbourValid(const Surface& neighbour, const Surface& current, float threshold)
+		{
+			return glm::distance(neighbour.m_Normal, current.m_Normal) <= threshold;
+		}
+	} // namespace
+
+	const char* ToString(ReservoirCombine combine)
+	{
+		switch (combine)
+		{
+		case ReservoirCombine::BIASED_SOURCE_TARGET:
+			return "Biased (source target)";
+		case ReservoirCombine::BIASED:
+			return "Biased (1/M)";
+		case ReservoirCombine::GENERALIZED_BALANCE:
+			return "Generalized balance";
+		case ReservoirCombine::PAIRWISE:
+			return "Pairwise";
+		}
+		return "Unknown";
+	}
+
+	const char* ToString(ReuseStrategy strategy)
+	{
+		switch (strategy)
+		{
+		case ReuseStrategy::RIS:
+			return "RIS";
+		case ReuseStrategy::TEMPORAL:
+			return "RIS + Temporal";
+		case ReuseStrategy::SPATIAL:
+			return "RIS + Spatial";
+		case ReuseStrategy::TEMPORAL_SPATIAL:
+			return "RIS + Temporal + Spatial";
+		}
+		return "Unknown";
+	}
+
+	ReSTIRReferenceResult RunReSTIRReference(const ReSTIRReferenceSettings& settings)
+	{
+		const Scene scene(settings);
+		const int width = static_cast<int>(settings.m_Width);
+		const int height = static_cast<int>(settings.m_Height);
+		const uint32_t numPixels = settings.m_Width * settings.m_Height;
+		const uint32_t numLights = settings.m_NumLights;
+		const bool useTemporal =
+			settings.m_Strategy == ReuseStrategy::TEMPORAL || settings.m_Strategy == ReuseStrategy::TEMPORAL_SPATIAL;
+		const bool useSpatial =
+			settings.m_Strategy == ReuseStrategy::SPATIAL || settings.m_Strategy == ReuseStrategy::TEMPORAL_SPATIAL;
+
+		std::vector<Surface> surfaces(numPixels);
+		std::vector<Surface> previousSurfaces(numPixels);
+		std::vector<Reservoir> reservoirs(numPixels);
+		std::vector<Reservoir> history(numPixels);
+		std::vector<Reservoir> spatialInput(numPixels);
+		std::vector<ReuseInput> inputs;
+
+		// Per pixel sums of estimate / ground truth over the trials
+		std::vector<double> truths(numPixels, 0.0);
+		std::vector<double> ratioSum(numPixels, 0.0);
+		std::vector<double> ratioSquaredSum(numPixels, 0.0);
+		std::vector<double> trialBias(settings.m_NumTrials, 0.0);
+		uint64_t targetEvaluations = 0;
+
+		for (uint32_t trial = 0; trial < settings.m_NumTrials; trial++)
+		{
+			for (uint32_t frame = 0; frame < settings.m_NumFrames; frame++)
+			{
+				// Every trial sees the same camera path, so the ground truth of a pixel is the same in all of them
+				const uint32_t frameIdx = trial * settings.m_NumFrames + frame;
+				uint32_t frameSeed = GetWangHashSeed(CombineIntoSeed(settings.m_Seed, frame, 1u));
+				const float jitterX = (rand(frameSeed) - 0.5f) * settings.m_Jitter;
+				const float jitterY = (rand(frameSeed) - 0.5f) * settings.m_Jitter;
+
+				for (int y = 0; y < height; y++)
+				{
+					for (int x = 0; x < width; x++)
+					{
+						const float screenX = static_cast<float>(x) + 0.5f + jitterX;
+						const float screenY = static_cast<float>(y) + 0.5f + jitterY;
+						surfaces[x + y * width] = scene.GetSurface(screenX, screenY);
+					}
+				}
+
+				// RIS, uniform candidates like DirectIllumination.hlsl
+				for (uint32_t pixelIdx = 0; pixelIdx < numPixels; pixelIdx++)
+				{
+					uint32_t seed = GetWangHashSeed(CombineIntoSeed(pixelIdx, frameIdx, 0u) ^ settings.m_Seed);
+					Reservoir reservoir = InitEmptyReservoir();
+					for (int i = 0; i < settings.m_RISRandomLights; i++)
+					{
+						const uint32_t candidate = static_cast<uint32_t>(rand(seed) * static_cast<float>(numLights));
+						const uint32_t lightIdx = (std::min)(candidate, numLights - 1);
+						const float pHat = scene.Target(surfaces[pixelIdx], lightIdx);
+						UpdateReservoir(reservoir, lightIdx, pHat, 1.f / static_cast<float>(numLights), 1.f, seed);
+					}
+					CalculateReservoirWeight(reservoir);
+					reservoirs[pixelIdx] = reservoir;
+					targetEvaluations += settings.m_RISRandomLights;
+				}
+
+				// Temporal, the scene is static so the previous pixel is the same pixel
+				if (useTemporal && frame > 0)
+				{
+					for (uint32_t pixelIdx = 0; pixelIdx < numPixels; pixelIdx++)
+					{
+						uint32_t seed = GetWangHashSeed(CombineIntoSeed(settings.m_Seed, pixelIdx, frameIdx + 2u));
+						inputs.clear();
+						inputs.push_back({reservoirs[pixelIdx], &surfaces[pixelIdx]});
+						const Surface& previousSurface = previousSurfaces[pixelIdx];
+						if (IsNeighbourValid(previousSurface, surfaces[pixelIdx], settings.m_NormalThreshold))
+						{
+							// Clamp previous frame reservoir influence
+							Reservoir previous = history[pixelIdx];
+							const float clamp = static_cast<float>(settings.m_CurrentLightClamp);
+							previous.m_EvalLights =
+								(std::min)(clamp * reservoirs[pixelIdx].m_EvalLights, previous.m_EvalLights);
+							inputs.push_back({previous, &previousSurface});
+						}
+						reservoirs[pixelIdx] = Combine(scene, settings.m_Combine, inputs, seed, targetEvaluations);
+					}
+				}
+
+				// Spatial, neighbours are picked the way SpatialReSTIR.hlsl picks them
+				if (useSpatial)
+				{
+					spatialInput = reservoirs;
+					for (int y = 0; y < height; y++)
+					{
+						for (int x = 0; x < width; x++)
+						{
+							const uint32_t pixelIdx = x + y * width;
+							uint32_t seed = GetWangHashSeed(CombineIntoSeed(frameIdx, pixelIdx, 0u) + settings.m_Seed);
+							inputs.clear();
+							inputs.push_back({spatialInput[pixelIdx], &surfaces[pixelIdx]});
+							for (int i = 0; i < settings.m_NumSpatialSamples; i++)
+							{
+								const float offsetX = (rand(seed) - 0.5f) * 2.f * settings.m_SpatialRadius;
+								const float offsetY = (rand(seed) - 0.5f) * 2.f * settings.m_SpatialRadius;
+								const int sampleX = static_cast<int>(static_cast<float>(x) + offsetX);
+								const int sampleY = static_cast<int>(static_cast<float>(y) + offsetY);
+								if (sampleX < 0 || sampleY < 0 || sampleX >= width || sampleY >= height)
+									continue;
+
+								const uint32_t sampleIdx = sampleX + sampleY * width;
+								const Surface& sampleSurface = surfaces[sampleIdx];
+								if (!IsNeighbourValid(sampleSurface, surfaces[pixelIdx], settings.m_NormalThreshold))
+									continue;
+								inputs.push_back({spatialInput[sampleIdx], &sampleSurface});
+							}
+							reservoirs[pixelIdx] = Combine(scene, settings.m_Combine, inputs, seed, targetEvaluations);
+						}
+					}
+				}
+
+				history = reservoirs;
+				previousSurfaces.swap(surfaces);
+			}
+
+			// Shade the last frame, its surfaces were swapped into previousSurfaces
+			double errorSum = 0.0;
+			double truthSum = 0.0;
+			for (uint32_t pixelIdx = 0; pixelIdx < numPixels; pixelIdx++)
+			{
+				const Surface& surface = previousSurfaces[pixelIdx];
+				const Reservoir& reservoir = reservoirs[pixelIdx];
+				double estimate = 0.0;
+				if (isReservoirValid(reservoir))
+					estimate = scene.Integrand(surface, reservoir.m_PickedLightIdx) * reservoir.m_Weight;
+
+				const double truth = scene.GroundTruth(surface);
+				truths[pixelIdx] = truth;
+				errorSum += estimate - truth;
+				truthSum += truth;
+				if (truth > 0.0)
+				{
+					const double ratio = estimate / truth;
+					ratioSum[pixelIdx] += ratio;
+					ratioSquaredSum[pixelIdx] += ratio * ratio;
+				}
+			}
+			trialBias[trial] = truthSum > 0.0 ? errorSum / truthSum : 0.0;
+		}
+
+		ReSTIRReferenceResult result;
+		const double numTrials = static_cast<double>(settings.m_NumTrials);
+		for (double bias : trialBias)
+			result.m_RelativeBias += bias / numTrials;
+
+		if (settings.m_NumTrials > 1)
+		{
+			double variance = 0.0;
+			for (double bias : trialBias)
+				variance += (bias - result.m_RelativeBias) * (bias - result.m_RelativeBias);
+			variance /= numTrials - 1.0;
+			result.m_BiasStandardError = std::sqrt(variance / numTrials);
+		}
+
+		// The squared bias of a pixel measured over the trials also holds the variance of its mean, which is removed
+		double squaredPixelBiasSum = 0.0;
+		double varianceSum = 0.0;
+		double squaredErrorSum = 0.0;
+		uint32_t numLitPixels = 0;
+		for (uint32_t pixelIdx = 0; pixelIdx < numPixels; pixelIdx++)
+		{
+			if (truths[pixelIdx] <= 0.0)
+				continue;
+
+			const double mean = ratioSum[pixelIdx] / numTrials;
+			const double squaredMean = ratioSquaredSum[pixelIdx] / numTrials;
+			const double besselCorrection = numTrials / (std::max)(numTrials - 1.0, 1.0);
+			const double variance = (std::max)(squaredMean - mean * mean, 0.0) * besselCorrection;
+			squaredPixelBiasSum += (mean - 1.0) * (mean - 1.0) - variance / numTrials;
+			varianceSum += variance;
+			squaredErrorSum += squaredMean - 2.0 * mean + 1.0;
+			numLitPixels++;
+		}
+		if (numLitPixels > 0)
+		{
+			result.m_PixelBias = std::sqrt((std::max)(squaredPixelBiasSum / numLitPixels, 0.0));
+			result.m_RelativeVariance = varianceSum / numLitPixels;
+			result.m_RelativeRMSE = std::sqrt((std::max)(squaredErrorSum / numLitPixels, 0.0));
+		}
+		result.m_TargetEvaluations = static_cast<double>(targetEvaluations) /
+			(static_cast<double>(numPixels) * numTrials * static_cast<double>(settings.m_NumFrames));
+		return result;
+	}
+} // namespace Ball
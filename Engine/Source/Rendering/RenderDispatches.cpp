@@ -7,9 +7,12 @@
 #include "Rendering/BEAR/Texture.h"
 #include "Rendering/ModelLoading/ModelManager.h"
 #include "GameObjects/GameObject.h"
+#include "ShaderHeaders/BloomStructsGPU.h"
 
 #include "Utilities/RenderUtilities.h"
 
+#include <memory>
+
 namespace Ball
 {
 	ComputePipelineDescription* RenderAPI::GenerateGenerateRaysPipeline()
@@ -51,7 +54,7 @@ namespace Ball
 		m_CmdList->SetDescriptorHeaps(m_ResourceHeap, m_SamplerHeap);
 
 		m_CmdList->BindResource32BitConstants(0, &cam, sizeof(CameraGPU) / sizeof(uint32_t));
-		uint32_t accumFrames[2] = {m_AccumFramesEnabled, m_NumTotalFrames};
+		uint32_t accumFrames[2] = {m_AccumFramesEnabled, GetSampleIndex()};
 		m_CmdList->BindResource32BitConstants(1, &accumFrames, sizeof(accumFrames) / sizeof(uint32_t));
 
 		m_CmdList->BindResourceUAV(2, *m_RayBatch[0]); // We write to the first Ray Batch
@@ -132,15 +135,15 @@ namespace Ball
 		shaderLayout.AddParameter(ShaderParameter::UAV); // Material Hit Data
 
 		shaderLayout.Add32bitConstParameter(sizeof(GameplaySkyMat) / sizeof(uint32_t)); // Gameplay Skybox Offset
-		shaderLayout.Add32bitConstParameter(3); // Brightness threshold, Cone Spread Angle, Tracing Distance Multiplier
+		shaderLayout.Add32bitConstParameter(3); // Brightness threshold, Texture LOD Bias, Tracing Distance Multiplier
+		shaderLayout.Add32bitConstParameter(sizeof(EnvironmentSettings) / sizeof(uint32_t)); // Environment Sampling
 
 		shaderLayout.Initialize();
 		cpd->Initialize("Shade", shaderLayout);
 		return cpd;
 	}
 
-	void RenderAPI::DispatchShadeRays(uint32_t numGroups1D, uint32_t wavefrontBounceNum, GameplaySkyMat skyMat,
-									  float coneSpreadAngle) const
+	void RenderAPI::DispatchShadeRays(uint32_t numGroups1D, uint32_t wavefrontBounceNum, GameplaySkyMat skyMat) const
 	{
 		const auto shadeTs = Utilities::PushGPUTimestamp(m_CmdList, "Shade " + std::to_string(wavefrontBounceNum));
 		m_CmdList->SetComputePipeline(*m_ShadeRaysPipeline);
@@ -156,7 +159,7 @@ namespace Ball
 		m_CmdList->BindResourceUAV(4, *m_ShadowRaysAtomic);
 		m_CmdList->BindResourceUAV(5, *m_RayBatch[writeIndex]);
 
-		const ShadeSeedData shadeSeeding = {m_NumTotalFrames, wavefrontBounceNum};
+		const ShadeSeedData shadeSeeding = {GetSampleIndex(), wavefrontBounceNum};
 		m_CmdList->BindResource32BitConstants(6, &shadeSeeding, sizeof(ShadeSeedData) / sizeof(uint32_t));
 
 		m_CmdList->BindResourceUAV(7, *m_WavefrontOutput);
@@ -173,8 +176,10 @@ namespace Ball
 		m_CmdList->BindResourceUAV(16, *m_MaterialHitData);
 
 		m_CmdList->BindResource32BitConstants(17, &skyMat, sizeof(skyMat) / sizeof(uint32_t));
-		const ShadeSettings shadeSettings = {m_BrightnessThreshold, coneSpreadAngle, m_TracingDistanceMultiplier};
+		const ShadeSettings shadeSettings = {m_BrightnessThreshold, m_TextureLODBias, m_TracingDistanceMultiplier};
 		m_CmdList->BindResource32BitConstants(18, &shadeSettings, sizeof(ShadeSettings) / sizeof(float));
+		m_CmdList->BindResource32BitConstants(
+			19, &m_EnvironmentSettings, sizeof(EnvironmentSettings) / sizeof(uint32_t));
 
 		m_CmdList->Dispatch(numGroups1D, 1, 1, true);
 
@@ -195,12 +200,15 @@ namespace Ball
 		shaderLayout.AddParameter(ShaderParameter::UAV); // ReSTIR Current Frame Reservoir
 		shaderLayout.Add32bitConstParameter(sizeof(ReStirSettings) / sizeof(uint32_t)); // ReSTIR Settings
 
+		shaderLayout.Add32bitConstParameter(sizeof(GameplaySkyMat) / sizeof(uint32_t)); // Gameplay Skybox Offset
+		shaderLayout.Add32bitConstParameter(sizeof(EnvironmentSettings) / sizeof(uint32_t)); // Environment Sampling
+
 		shaderLayout.Initialize();
 		cpd->Initialize("DirectIllumination", shaderLayout);
 		return cpd;
 	}
 
-	void RenderAPI::DispatchDirectIllum(uint32_t numGroups1D, uint32_t wavefrontBounceNum) const
+	void RenderAPI::DispatchDirectIllum(uint32_t numGroups1D, uint32_t wavefrontBounceNum, GameplaySkyMat skyMat) const
 	{
 		const auto diTs = Utilities::PushGPUTimestamp(m_CmdList, "Direct Illum " + std::to_string(wavefrontBounceNum));
 
@@ -213,7 +221,7 @@ namespace Ball
 		m_CmdList->BindResourceUAV(2, *m_ShadowRayBatch);
 
 		const auto lightData = m_ModelManager->GetLightData();
-		const DISeedData shadeSeeding = {m_NumTotalFrames, wavefrontBounceNum, lightData->GetNumElements()};
+		const DISeedData shadeSeeding = {GetSampleIndex(), wavefrontBounceNum, lightData->GetNumElements()};
 		m_CmdList->BindResource32BitConstants(3, &shadeSeeding, sizeof(DISeedData) / sizeof(uint32_t));
 		m_CmdList->BindResourceSRV(4, *lightData);
 		m_CmdList->BindResourceSRV(5, *m_MaterialHitData);
@@ -222,6 +230,11 @@ namespace Ball
 		m_CmdList->BindResourceUAV(6, *m_Reservoirs);
 		m_CmdList->BindResource32BitConstants(7, &m_ReStirSettings, sizeof(ReStirSettings) / sizeof(uint32_t));
 
+		// Environment:
+		m_CmdList->BindResource32BitConstants(8, &skyMat, sizeof(skyMat) / sizeof(uint32_t));
+		m_CmdList->BindResource32BitConstants(
+			9, &m_EnvironmentSettings, sizeof(EnvironmentSettings) / sizeof(uint32_t));
+
 		m_CmdList->Dispatch(numGroups1D, 1, 1, true);
 
 		Utilities::PopGPUTimestamp(m_CmdList, diTs);
@@ -402,7 +415,7 @@ namespace Ball
 		m_CmdList->BindResourceSRV(1, *m_ShadowRaysAtomic);
 
 		const auto lightData = m_ModelManager->GetLightData();
-		const DISeedData shadeSeeding = {m_NumTotalFrames, wavefrontBounceNum, lightData->GetNumElements()};
+		const DISeedData shadeSeeding = {GetSampleIndex(), wavefrontBounceNum, lightData->GetNumElements()};
 		m_CmdList->BindResource32BitConstants(2, &shadeSeeding, sizeof(DISeedData) / sizeof(uint32_t));
 		m_CmdList->BindResourceSRV(3, *lightData);
 		m_CmdList->BindResourceSRV(4, *m_MaterialHitData);
@@ -507,4 +520,421 @@ namespace Ball
 
 		Utilities::PopGPUTimestamp(m_CmdList, outlineShaderTs);
 	}
+	void RenderAPI::DispatchDebugRayTrace(int numGroupsX, int numGroupsY, CameraGPU cam) const
+	{
+		m_CmdList->SetComputePipeline(*m_SimpleRayTracer);
+
+		// Binding Register Resources
+		m_CmdList->BindResource32BitConstants(0, &cam, sizeof(CameraGPU) / 4);
+		m_CmdList->BindResourceSRV(1, m_ModelManager->GetTLASRef());
+		m_CmdList->BindResource32BitConstants(2, &m_RenderMode, sizeof(DebugSettings) / 4);
+		m_CmdList->Dispatch(numGroupsX, numGroupsY, 1, true);
+	}
+
+	void RenderAPI::DispatchGrid(int numGroupsX, int numGroupsY, CameraGPU cam) const
+	{
+		const auto gridShader = Utilities::PushGPUTimestamp(m_CmdList, "Grid Shader");
+		m_CmdList->SetComputePipeline(*m_GridShaderPipeline);
+		// Binding Register Resources
+		m_CmdList->BindResource32BitConstants(0, &cam, sizeof(CameraGPU) / 4);
+		m_CmdList->BindResource32BitConstants(1, &m_GridSettings, sizeof(GridShaderSettings) / 4);
+		m_CmdList->BindResourceSRV(2, *m_Denoiser->GetBufferAt(DenoiseBuffers::CURRENT_DEPTH));
+		m_CmdList->Dispatch(numGroupsX, numGroupsY, 1, true);
+		Utilities::PopGPUTimestamp(m_CmdList, gridShader);
+	}
+
+	void RenderAPI::DispatchBloom() const
+	{
+		constexpr float threadGroupSize = 16.0;
+
+		auto bloomTs = Utilities::PushGPUTimestamp(m_CmdList, "Bloom");
+		auto bloompMips = m_OutputTexture->CalculateMipsNum() - 1;
+
+		// Downsample
+		for (int targetMip = 1; targetMip <= bloompMips; targetMip++)
+		{
+			DownsampleData dsdata;
+			auto targetMipIndex = targetMip - 1;
+			Texture* dstTexture = m_BloomIntermediateTextures[targetMipIndex];
+			Texture* srcTexture = nullptr;
+			bool useKaris;
+			if (targetMip == 1)
+			{
+				srcTexture = m_OutputTexture;
+				useKaris = true;
+			}
+			else
+			{
+				srcTexture = m_BloomIntermediateTextures[targetMipIndex - 1];
+				useKaris = false;
+			}
+
+			dsdata.m_MipEvaulating = targetMip;
+			dsdata.m_SrcDimension = (srcTexture->GetHeight() & 1) << 1 | (srcTexture->GetWidth() & 1);
+			const float texelSizeX = 1.f / dstTexture->GetWidth();
+			const float texelSizeY = 1.f / dstTexture->GetHeight();
+			const glm::vec2 texelSize = {texelSizeX, texelSizeY};
+			dsdata.m_TexelSize = texelSize;
+			dsdata.m_UseKaris13Fetch = useKaris;
+
+			m_CmdList->SetComputePipeline(*m_BloomDownsamplePipeline);
+			m_CmdList->SetDescriptorHeaps(m_ResourceHeap, m_SamplerHeap);
+			m_CmdList->BindResource32BitConstants(0, &dsdata, sizeof(DownsampleData) / 4);
+			const int dispatchX = int(ceil(float(dstTexture->GetWidth()) / threadGroupSize));
+			const int dispatchY = int(ceil(float(dstTexture->GetHeight()) / threadGroupSize));
+			m_CmdList->Dispatch(dispatchX, dispatchY, 1, true);
+		}
+
+		// Upsample
+		for (int srcTextureIdx = bloompMips - 1; srcTextureIdx >= 0; srcTextureIdx--)
+		{
+			UpsampleData updata;
+			auto dstMipIndex = srcTextureIdx - 1;
+			Texture* dstTexture = nullptr;
+			Texture* srcTexture = m_BloomIntermediateTextures[srcTextureIdx];
+
+			// Mip Level of -1 of m_BloomIntermediateTextures is m_OutputTexture
+			if (dstMipIndex < 0)
+			{
+				dstTexture = m_OutputTexture;
+			}
+			else
+			{
+				dstTexture = m_BloomIntermediateTextures[dstMipIndex];
+			}
+
+			updata.m_Intensity = m_BloomSettings.m_Intensity;
+			updata.m_InvMipCount = 1.0f / (float)(bloompMips); // Not sure
+
+			const glm::vec2 invSrcDims = {1.f / (float)srcTexture->GetWidth(), 1.f / (float)srcTexture->GetHeight()};
+			updata.m_InvSrcDims = invSrcDims;
+			updata.m_Radius = m_BloomSettings.m_Radius < 1.0f ? 1 : static_cast<uint>(m_BloomSettings.m_Radius);
+			updata.m_MipEvaulating = dstMipIndex + 1; // Because the RDH is offset by one
+
+			const glm::vec2 texelSize = {(float)srcTexture->GetWidth() / (float)dstTexture->GetWidth(),
+										 (float)srcTexture->GetHeight() / (float)dstTexture->GetHeight()};
+
+			updata.m_TexelSize = texelSize;
+
+			m_CmdList->SetComputePipeline(*m_BloomUpsamplePipeline);
+			m_CmdList->SetDescriptorHeaps(m_ResourceHeap, m_SamplerHeap);
+			m_CmdList->BindResource32BitConstants(0, &updata, sizeof(UpsampleData) / 4);
+			const int dispatchX = int(ceil(float(dstTexture->GetWidth()) / threadGroupSize));
+			const int dispatchY = int(ceil(float(dstTexture->GetHeight()) / threadGroupSize));
+			m_CmdList->Dispatch(dispatchX, dispatchY, 1, true);
+		}
+		Utilities::PopGPUTimestamp(m_CmdList, bloomTs);
+	}
+
+	void RenderAPI::DispatchTonemap(int numGroupsX, int numGroupsY) const
+	{
+		// Tonemap & write to m_TransferToRTTexture
+		auto tonemappingTs = Utilities::PushGPUTimestamp(m_CmdList, "Tonemapping");
+		m_CmdList->SetComputePipeline(*m_TonemappingPipeline);
+		m_CmdList->SetDescriptorHeaps(m_ResourceHeap, m_SamplerHeap);
+		m_CmdList->BindResource32BitConstants(0, &m_TonemapParams, sizeof(TonemapParameters) / 4);
+		m_CmdList->BindResourceSRV(1, *m_Denoiser->GetBufferAt(DenoiseBuffers::EMISSION));
+		m_CmdList->Dispatch(numGroupsX, numGroupsY, 1, true);
+		Utilities::PopGPUTimestamp(m_CmdList, tonemappingTs);
+	}
+
+	void RenderAPI::IssueFrameGraphBarrier(const RGBarrier& barrier) const
+	{
+		const RGResource& resource = m_FrameGraph.GetResource(barrier.m_Resource);
+		switch (barrier.m_Type)
+		{
+		case RGBarrierType::TRANSITION:
+			if (barrier.m_After == RGResourceState::UAV)
+			{
+				if (resource.m_Buffer)
+					m_CmdList->TransitionToUAV(*resource.m_Buffer);
+				else if (resource.m_Texture)
+					m_CmdList->TransitionToUAV(*resource.m_Texture);
+			}
+			else
+			{
+				if (resource.m_Buffer)
+					m_CmdList->TransitionToSRV(*resource.m_Buffer);
+				else if (resource.m_Texture)
+					m_CmdList->TransitionToSRV(*resource.m_Texture);
+			}
+			break;
+		case RGBarrierType::UAV:
+			if (resource.m_Buffer)
+				m_CmdList->UAVBarrier(*resource.m_Buffer);
+			else if (resource.m_Texture)
+				m_CmdList->UAVBarrier(*resource.m_Texture);
+			break;
+		case RGBarrierType::ALIASING:
+			// Transient buffers are committed resources with their own memory, nothing is aliased yet
+			break;
+		}
+	}
+
+	void RenderAPI::BuildFrameGraph(const CameraGPU& cam, const GameplaySkyMat& skyMat, int numGroupsX,
+									int numGroupsY, int numGroups1D, bool dispatchWavefront)
+	{
+		RenderGraph& graph = m_FrameGraph;
+
+		auto textureSize = [](const Texture* texture)
+		{
+			return uint64_t(texture->GetWidth()) * texture->GetHeight() * texture->GetNumChannels() *
+				texture->GetBytesPerChannel();
+		};
+
+		// Persistent data (history, reservoirs, counters) is imported and kept alive as a graph output,
+		// data that only lives within the frame is transient and can share memory with other transient buffers
+		auto persistent = [&graph](Buffer* buffer)
+		{
+			const auto handle = graph.ImportBuffer(buffer->GetName(), buffer->GetSizeBytes(), buffer);
+			graph.MarkOutput(handle);
+			return handle;
+		};
+		auto transient = [&graph](Buffer* buffer)
+		{ return graph.CreateTransientBuffer(buffer->GetName(), buffer->GetSizeBytes(), buffer); };
+		auto denoise = [this](DenoiseBuffers type) { return m_Denoiser->GetBufferAt(type); };
+
+		// Textures written through the bindless heap
+		const auto outputTex =
+			graph.ImportTexture(m_OutputTexture->GetName(), textureSize(m_OutputTexture), m_OutputTexture);
+		const auto transferTex = graph.ImportTexture(
+			m_TransferToRTTexture->GetName(), textureSize(m_TransferToRTTexture), m_TransferToRTTexture);
+		graph.MarkOutput(transferTex);
+
+		// Wavefront
+		const RGResourceHandle rayBatch[2] = {transient(m_RayBatch[0]), transient(m_RayBatch[1])};
+		const auto extendBatch = transient(m_RayExtendBatch);
+		const auto shadowBatch = transient(m_ShadowRayBatch);
+		const auto materialHitData = transient(m_MaterialHitData);
+		// Accumulates over frames, Generate only clears it when accumulation is off
+		const auto wavefrontOutput = persistent(m_WavefrontOutput);
+		const auto rayCount = persistent(m_RayCount);
+		const auto newRaysAtomic = persistent(m_NewRaysAtomic);
+		const auto shadowRaysAtomic = persistent(m_ShadowRaysAtomic);
+		const auto instanceIDs = persistent(m_InstanceIDs);
+		const auto reservoirs = persistent(m_Reservoirs);
+		const auto prevReservoirs = persistent(m_PrevReservoirs);
+
+		// Denoiser, current data gets copied into the previous buffers by Generate next frame
+		const auto curNormal = persistent(denoise(DenoiseBuffers::CURRENT_NORMAL));
+		const auto curDepth = persistent(denoise(DenoiseBuffers::CURRENT_DEPTH));
+		const auto curID = persistent(denoise(DenoiseBuffers::CURRENT_ID));
+		const auto curHistory = persistent(denoise(DenoiseBuffers::CURRENT_HISTORY));
+		const auto curMoments = persistent(denoise(DenoiseBuffers::CURRENT_MOMENTS));
+		const auto prevNormal = persistent(denoise(DenoiseBuffers::PREVIOUS_NORMAL));
+		const auto prevDepth = persistent(denoise(DenoiseBuffers::PREVIOUS_DEPTH));
+		const auto prevID = persistent(denoise(DenoiseBuffers::PREVIOUS_ID));
+		const auto prevHistory = persistent(denoise(DenoiseBuffers::PREVIOUS_HISTORY));
+		const auto prevMoments = persistent(denoise(DenoiseBuffers::PREVIOUS_MOMENTS));
+		const auto prevIllumination = persistent(denoise(DenoiseBuffers::PREVIOUS_ILLUMINATION));
+		const auto cameras = persistent(denoise(DenoiseBuffers::CAMERAS));
+		const auto viewPyramid = persistent(denoise(DenoiseBuffers::VIEW_PYRAMID));
+		const auto curIllumination = transient(denoise(DenoiseBuffers::CURRENT_ILLUMINATION));
+		const auto intersectionPoints = transient(denoise(DenoiseBuffers::WORLDSPACE_INTERSECTION_POINTS));
+		const auto primaryAlbedo = transient(denoise(DenoiseBuffers::PRIMARY_ALBEDO));
+		const auto emission = transient(denoise(DenoiseBuffers::EMISSION));
+		const auto weightedIllumination = transient(denoise(DenoiseBuffers::WEIGHTED_ILLUMINATION));
+		const auto aTrousResult = transient(denoise(DenoiseBuffers::A_TROUS_RESULT));
+
+		if (m_RenderMode != RenderModes::RM_PATH_TRACE)
+		{
+			graph.AddPass("RayTraceTest", [=] { DispatchDebugRayTrace(numGroupsX, numGroupsY, cam); })
+				.Write(outputTex);
+		}
+		else if (dispatchWavefront)
+		{
+			graph.AddPass("Generate", [=] { DispatchGeneratePrimaryRays(numGroupsX, numGroupsY, cam); })
+				.Write(rayBatch[0])
+				.ReadWrite(rayCount)
+				.ReadWrite(wavefrontOutput)
+				.ReadWrite(curNormal)
+				.ReadWrite(prevNormal)
+				.ReadWrite(curID)
+				.ReadWrite(prevID)
+				.ReadWrite(curHistory)
+				.ReadWrite(prevHistory)
+				.ReadWrite(curMoments)
+				.ReadWrite(prevMoments)
+				.Write(curIllumination)
+				.Write(emission)
+				.Write(weightedIllumination);
+
+			for (uint32_t i = 0; i < m_MaxRecursionDepth; i++)
+			{
+				const auto readIndex = i % 2;
+				const auto writeIndex = (i + 1) % 2;
+
+				// Spans the whole bounce, Extend always runs first and the last pass of the bounce closes it
+				const auto bounceTs = std::make_shared<uint32_t>(0);
+				auto extend = [=]
+				{
+					*bounceTs = Utilities::PushGPUTimestamp(m_CmdList, "[GL] Wavefront " + std::to_string(i));
+					DispatchExtendRays(numGroups1D, i);
+				};
+				graph.AddPass("Extend", extend)
+					.Read(rayBatch[readIndex])
+					.Read(rayCount)
+					.Write(extendBatch)
+					.ReadWrite(shadowRaysAtomic)
+					.ReadWrite(newRaysAtomic);
+
+				graph.AddPass("Shade", [=] { DispatchShadeRays(numGroups1D, i, skyMat); })
+					.ReadWrite(rayBatch[readIndex])
+					.Read(rayCount)
+					.Read(extendBatch)
+					.ReadWrite(newRaysAtomic)
+					.ReadWrite(shadowRaysAtomic)
+					.Write(rayBatch[writeIndex])
+					.ReadWrite(wavefrontOutput)
+					.ReadWrite(intersectionPoints)
+					.ReadWrite(curDepth)
+					.ReadWrite(prevDepth)
+					.ReadWrite(curNormal)
+					.ReadWrite(curID)
+					.ReadWrite(primaryAlbedo)
+					.ReadWrite(emission)
+					.ReadWrite(instanceIDs)
+					.ReadWrite(materialHitData);
+
+				graph.AddPass("DirectIllumination", [=] { DispatchDirectIllum(numGroups1D, i, skyMat); })
+					.Read(rayBatch[readIndex])
+					.ReadWrite(shadowRaysAtomic)
+					.Write(shadowBatch)
+					.Read(materialHitData)
+					.ReadWrite(reservoirs);
+
+				// Every diffuse hit can add a shadow ray towards the sky as well
+				auto connect = [=]
+				{
+					DispatchConnectRays(numGroups1D * 2, i);
+					if (i != 0)
+						Utilities::PopGPUTimestamp(m_CmdList, *bounceTs);
+				};
+				graph.AddPass("Connect", connect)
+					.Read(shadowBatch)
+					.Read(shadowRaysAtomic)
+					.ReadWrite(wavefrontOutput)
+					.ReadWrite(rayCount)
+					.Read(newRaysAtomic)
+					.ReadWrite(reservoirs);
+
+				// Primary rays evaluations
+				if (i == 0)
+				{
+					graph.AddPass("ReprojectReSTIR", [=] { DispatchReprojectReSTIR(numGroups1D); })
+						.Read(cameras)
+						.ReadWrite(intersectionPoints)
+						.Read(viewPyramid)
+						.Read(curDepth)
+						.Read(prevDepth)
+						.Read(curNormal)
+						.Read(prevNormal)
+						.ReadWrite(reservoirs)
+						.Read(prevReservoirs)
+						.Read(rayCount);
+
+					graph.AddPass("SpatialReSTIR", [=] { DispatchSpatialReSTIR(numGroups1D); })
+						.Read(curDepth)
+						.Read(curNormal)
+						.Read(cameras)
+						.Write(prevReservoirs)
+						.Read(reservoirs);
+
+					auto shadeReSTIR = [=]
+					{
+						DispatchShadeReSTIR(numGroups1D, i);
+						Utilities::PopGPUTimestamp(m_CmdList, *bounceTs);
+					};
+					graph.AddPass("ShadeReSTIR", shadeReSTIR)
+						.Read(rayBatch[readIndex])
+						.Read(shadowRaysAtomic)
+						.Read(materialHitData)
+						.ReadWrite(wavefrontOutput)
+						.ReadWrite(reservoirs)
+						.ReadWrite(prevReservoirs);
+				}
+			}
+
+			graph.AddPass("Finalize", [=] { DispatchFinalize(numGroupsX, numGroupsY); })
+				.Read(wavefrontOutput)
+				.Write(aTrousResult)
+				.ReadWrite(curHistory)
+				.ReadWrite(outputTex);
+
+			if (!m_AccumFramesEnabled && m_ReprojectionEnabled)
+			{
+				auto reproject = [=]
+				{ m_Denoiser->DispatchReproject(numGroups1D, m_CmdList, m_PrevReservoirs, m_Reservoirs); };
+				graph.AddPass("Reproject", reproject)
+					.Read(intersectionPoints)
+					.Read(curNormal)
+					.Read(prevNormal)
+					.Read(curID)
+					.Read(prevID)
+					.ReadWrite(curHistory)
+					.Read(prevHistory)
+					.ReadWrite(curMoments)
+					.Read(prevMoments)
+					.ReadWrite(curIllumination)
+					.Read(prevIllumination)
+					.Read(aTrousResult)
+					.Read(primaryAlbedo)
+					.Read(emission)
+					.Read(cameras);
+
+				if (m_DenoisingEnabled)
+				{
+					auto calculateWeights = [=] { m_Denoiser->DispatchCalculateWeight(numGroups1D, cam, m_CmdList); };
+					graph.AddPass("CalculateWeights", calculateWeights)
+						.Read(curIllumination)
+						.Read(curMoments)
+						.Read(curHistory)
+						.Read(curDepth)
+						.Read(curNormal)
+						.Write(weightedIllumination);
+
+					graph.AddPass("ATrous", [=] { m_Denoiser->DispatchATrous(numGroups1D, cam, m_CmdList); })
+						.Read(curHistory)
+						.Read(curDepth)
+						.Read(curNormal)
+						.ReadWrite(weightedIllumination)
+						.ReadWrite(aTrousResult)
+						.ReadWrite(prevIllumination);
+
+					graph.AddPass("Modulate", [=] { m_Denoiser->DispatchModulate(numGroups1D, cam, m_CmdList); })
+						.ReadWrite(primaryAlbedo)
+						.Read(emission)
+						.Read(m_Denoiser->m_FilterIterations % 2 == 0 ? weightedIllumination : aTrousResult)
+						.ReadWrite(outputTex);
+				}
+			}
+		}
+
+		// Nothing to outline when both the selected and hovered object are off-screen
+		const bool outlineVisible = (m_SelectedObject != nullptr && m_ModelManager->IsVisible(m_SelectedObject)) ||
+									(m_HoveredObject != nullptr && m_ModelManager->IsVisible(m_HoveredObject));
+		if (m_RenderMode == RenderModes::RM_PATH_TRACE && m_DispatchOutlineObjects && outlineVisible)
+		{
+			graph.AddPass("OutlineObjects", [=] { DispatchOutlineObjects(numGroups1D); })
+				.Read(instanceIDs)
+				.ReadWrite(outputTex)
+				.Debug();
+		}
+
+		if (m_RunGridShader)
+		{
+			graph.AddPass("Grid", [=] { DispatchGrid(numGroupsX, numGroupsY, cam); })
+				.Read(curDepth)
+				.ReadWrite(outputTex)
+				.Debug();
+		}
+
+		if (m_BloomSettings.m_Enabled)
+			graph.AddPass("Bloom", [=] { DispatchBloom(); }).ReadWrite(outputTex);
+
+		graph.AddPass("Tonemapping", [=] { DispatchTonemap(numGroupsX, numGroupsY); })
+			.Read(outputTex)
+			.Read(emission)
+			.Write(transferTex);
+	}
 } // namespace Ball
\ No newline at end of file
@@ -0,0 +1,500 @@
+#include "Rendering/RenderGraph.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace Ball
+{
+	namespace
+	{
+		uint64_t AlignHeapSize(uint64_t size)
+		{
+			return (size + RenderGraph::HEAP_ALIGNMENT - 1) & ~(RenderGraph::HEAP_ALIGNMENT - 1);
+		}
+
+		bool IsRead(RGAccess access) { return access != RGAccess::WRITE; }
+		bool IsWrite(RGAccess access) { return access != RGAccess::READ; }
+	} // namespace
+
+	RGPassBuilder& RGPassBuilder::Read(RGResourceHandle resource)
+	{
+		return AddAccess(resource, RGAccess::READ);
+	}
+
+	RGPassBuilder& RGPassBuilder::Write(RGResourceHandle resource)
+	{
+		return AddAccess(resource, RGAccess::WRITE);
+	}
+
+	RGPassBuilder& RGPassBuilder::ReadWrite(RGResourceHandle resource)
+	{
+		return AddAccess(resource, RGAccess::READ_WRITE);
+	}
+
+	RGPassBuilder& RGPassBuilder::SideEffect()
+	{
+		GetPass().m_SideEffect = true;
+		return *this;
+	}
+
+	RGPassBuilder& RGPassBuilder::Debug()
+	{
+		GetPass().m_Debug = true;
+		return *this;
+	}
+
+	RGPass& RGPassBuilder::GetPass()
+	{
+		return m_Graph.m_Passes[m_Pass];
+	}
+
+	RGPassBuilder& RGPassBuilder::AddAccess(RGResourceHandle resource, RGAccess access)
+	{
+		RGPass& pass = GetPass();
+		ASSERT_MSG(
+			LOG_GRAPHICS, resource != RG_INVALID_RESOURCE, "Pass '%s' uses an invalid resource", pass.m_Name.c_str());
+
+		// A pass that reads and writes the same resource is a single READ_WRITE access
+		for (auto& existing : pass.m_Accesses)
+		{
+			if (existing.m_Resource == resource)
+			{
+				if (existing.m_Access != access)
+					existing.m_Access = RGAccess::READ_WRITE;
+				return *this;
+			}
+		}
+
+		pass.m_Accesses.push_back({resource, access});
+		return *this;
+	}
+
+	RGResourceHandle RenderGraph::CreateTransientBuffer(const std::string& name, uint64_t sizeBytes, Buffer* buffer)
+	{
+		RGResource resource;
+		resource.m_Name = name;
+		resource.m_SizeBytes = sizeBytes;
+		resource.m_Transient = true;
+		resource.m_Buffer = buffer;
+		m_Resources.push_back(resource);
+		m_Compiled = false;
+		return static_cast<RGResourceHandle>(m_Resources.size() - 1);
+	}
+
+	RGResourceHandle RenderGraph::ImportBuffer(const std::string& name, uint64_t sizeBytes, Buffer* buffer)
+	{
+		RGResource resource;
+		resource.m_Name = name;
+		resource.m_SizeBytes = sizeBytes;
+		resource.m_Transient = false;
+		resource.m_Buffer = buffer;
+		m_Resources.push_back(resource);
+		m_Compiled = false;
+		return static_cast<RGResourceHandle>(m_Resources.size() - 1);
+	}
+
+	RGResourceHandle RenderGraph::ImportTexture(const std::string& name, uint64_t sizeBytes, Texture* texture)
+	{
+		RGResource resource;
+		resource.m_Name = name;
+		resource.m_SizeBytes = sizeBytes;
+		resource.m_Transient = false;
+		resource.m_Texture = texture;
+		m_Resources.push_back(resource);
+		m_Compiled = false;
+		return static_cast<RGResourceHandle>(m_Resources.size() - 1);
+	}
+
+	void RenderGraph::MarkOutput(RGResourceHandle resource)
+	{
+		m_Resources[resource].m_Output = true;
+		m_Compiled = false;
+	}
+
+	RGPassBuilder RenderGraph::AddPass(const std::string& name, std::function<void()> execute)
+	{
+		RGPass pass;
+		pass.m_Name = name;
+		pass.m_Execute = std::move(execute);
+		m_Passes.push_back(std::move(pass));
+		m_Compiled = false;
+		return RGPassBuilder(*this, static_cast<uint32_t>(m_Passes.size() - 1));
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_Passes.clear();
+		m_Resources.clear();
+		m_ExecutionOrder.clear();
+		m_Dependencies.clear();
+		m_Producers.clear();
+		m_ReadWriteProducers.clear();
+		m_Stats = {};
+		m_Compiled = false;
+	}
+
+	void RenderGraph::Compile()
+	{
+		m_Stats = {};
+		m_Stats.m_NumPasses = static_cast<uint32_t>(m_Passes.size());
+
+		BuildDependencies();
+		CullPasses();
+		SortPasses();
+		AliasTransientResources();
+		ComputeBarriers();
+
+		m_Compiled = true;
+	}
+
+	void RenderGraph::BuildDependencies()
+	{
+		const auto numPasses = m_Passes.size();
+		m_Dependencies.assign(numPasses, {});
+		m_Producers.assign(numPasses, {});
+		m_ReadWriteProducers.assign(numPasses, {});
+
+		// Walk the passes in declaration order, that's the order the author expects the data to flow in
+		std::vector<int> lastWriter(m_Resources.size(), -1);
+		std::vector<std::vector<uint32_t>> readersSinceWrite(m_Resources.size());
+
+		auto addEdge = [](std::vector<uint32_t>& edges, uint32_t from)
+		{
+			if (std::find(edges.begin(), edges.end(), from) == edges.end())
+				edges.push_back(from);
+		};
+
+		for (uint32_t p = 0; p < numPasses; p++)
+		{
+			for (const auto& access : m_Passes[p].m_Accesses)
+			{
+				const auto r = access.m_Resource;
+				ASSERT_MSG(LOG_GRAPHICS,
+						   r < m_Resources.size(),
+						   "Pass '%s' uses an unknown resource",
+						   m_Passes[p].m_Name.c_str());
+
+				// Read after write
+				if (IsRead(access.m_Access) && lastWriter[r] >= 0)
+				{
+					addEdge(m_Dependencies[p], lastWriter[r]);
+					addEdge(m_Producers[p], lastWriter[r]);
+					if (access.m_Access == RGAccess::READ_WRITE)
+						addEdge(m_ReadWriteProducers[p], lastWriter[r]);
+				}
+
+				if (IsWrite(access.m_Access))
+				{
+					// Write after write
+					if (lastWriter[r] >= 0)
+						addEdge(m_Dependencies[p], lastWriter[r]);
+
+					// Write after read
+					for (const auto reader : readersSinceWrite[r])
+						if (reader != p)
+							addEdge(m_Dependencies[p], reader);
+
+					lastWriter[r] = static_cast<int>(p);
+					readersSinceWrite[r].clear();
+				}
+				else
+				{
+					readersSinceWrite[r].push_back(p);
+				}
+			}
+		}
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		auto isDisabled = [this](const RGPass& pass) { return pass.m_Debug && !m_DebugPassesEnabled; };
+
+		std::vector<uint32_t> stack;
+		std::vector<bool> visited(m_Passes.size(), false);
+		for (uint32_t p = 0; p < m_Passes.size(); p++)
+		{
+			auto& pass = m_Passes[p];
+			pass.m_Culled = true;
+
+			if (isDisabled(pass))
+				continue;
+
+			bool writesOutput = false;
+			for (const auto& access : pass.m_Accesses)
+				writesOutput |= IsWrite(access.m_Access) && m_Resources[access.m_Resource].m_Output;
+
+			if (pass.m_SideEffect || writesOutput)
+			{
+				pass.m_Culled = false;
+				visited[p] = true;
+				stack.push_back(p);
+			}
+		}
+
+		// Everything producing data for a living pass is alive as well. A disabled pass stays culled, but whatever
+		// it ReadWrites is what the earlier writers left there, so the liveness goes through to them.
+		while (!stack.empty())
+		{
+			const auto p = stack.back();
+			stack.pop_back();
+
+			const auto& producers = isDisabled(m_Passes[p]) ? m_ReadWriteProducers[p] : m_Producers[p];
+			for (const auto producer : producers)
+			{
+				if (visited[producer])
+					continue;
+
+				visited[producer] = true;
+				auto& pass = m_Passes[producer];
+				if (!isDisabled(pass))
+					pass.m_Culled = false;
+				stack.push_back(producer);
+			}
+		}
+
+		for (const auto& pass : m_Passes)
+			m_Stats.m_NumCulledPasses += pass.m_Culled ? 1 : 0;
+	}
+
+	void RenderGraph::SortPasses()
+	{
+		// Kahn's algorithm, ties are broken by declaration order to keep the result stable between frames
+		const auto numPasses = static_cast<uint32_t>(m_Passes.size());
+		std::vector<uint32_t> inDegree(numPasses, 0);
+		std::vector<std::vector<uint32_t>> dependants(numPasses);
+
+		// Culled passes don't run, but the passes around them still have to keep their order. Their dependencies are
+		// inherited by whoever depended on them.
+		std::vector<uint32_t> pending;
+		std::vector<bool> seen(numPasses);
+		for (uint32_t p = 0; p < numPasses; p++)
+		{
+			if (m_Passes[p].m_Culled)
+				continue;
+
+			std::fill(seen.begin(), seen.end(), false);
+			pending = m_Dependencies[p];
+			while (!pending.empty())
+			{
+				const auto dependency = pending.back();
+				pending.pop_back();
+				if (seen[dependency])
+					continue;
+				seen[dependency] = true;
+
+				if (m_Passes[dependency].m_Culled)
+				{
+					pending.insert(
+						pending.end(), m_Dependencies[dependency].begin(), m_Dependencies[dependency].end());
+					continue;
+				}
+
+				inDegree[p]++;
+				dependants[dependency].push_back(p);
+			}
+		}
+
+		std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+		for (uint32_t p = 0; p < numPasses; p++)
+		{
+			m_Passes[p].m_DependencyLevel = 0;
+			if (!m_Passes[p].m_Culled && inDegree[p] == 0)
+				ready.push(p);
+		}
+
+		m_ExecutionOrder.clear();
+		while (!ready.empty())
+		{
+			const auto p = ready.top();
+			ready.pop();
+			m_ExecutionOrder.push_back(p);
+
+			for (const auto dependant : dependants[p])
+			{
+				auto& level = m_Passes[dependant].m_DependencyLevel;
+				level = std::max(level, m_Passes[p].m_DependencyLevel + 1);
+
+				if (--inDegree[dependant] == 0)
+					ready.push(dependant);
+			}
+		}
+
+		ASSERT_MSG(LOG_GRAPHICS,
+				   m_ExecutionOrder.size() == numPasses - m_Stats.m_NumCulledPasses,
+				   "RenderGraph contains a cycle");
+	}
+
+	void RenderGraph::AliasTransientResources()
+	{
+		for (auto& resource : m_Resources)
+		{
+			resource.m_FirstPass = -1;
+			resource.m_LastPass = -1;
+			resource.m_HeapOffset = 0;
+
+			if (resource.m_Transient)
+				m_Stats.m_TransientBytesUnaliased += AlignHeapSize(resource.m_SizeBytes);
+		}
+
+		// Lifetimes, in execution order
+		for (int i = 0; i < static_cast<int>(m_ExecutionOrder.size()); i++)
+		{
+			for (const auto& access : m_Passes[m_ExecutionOrder[i]].m_Accesses)
+			{
+				auto& resource = m_Resources[access.m_Resource];
+				if (resource.m_FirstPass < 0)
+					resource.m_FirstPass = i;
+				resource.m_LastPass = i;
+			}
+		}
+
+		std::vector<uint32_t> transients;
+		for (uint32_t r = 0; r < m_Resources.size(); r++)
+			if (m_Resources[r].m_Transient && m_Resources[r].m_FirstPass >= 0)
+				transients.push_back(r);
+
+		// Biggest first gives the tightest packing for the greedy placement below
+		std::sort(transients.begin(),
+				  transients.end(),
+				  [this](uint32_t a, uint32_t b)
+				  {
+					  if (m_Resources[a].m_SizeBytes != m_Resources[b].m_SizeBytes)
+						  return m_Resources[a].m_SizeBytes > m_Resources[b].m_SizeBytes;
+					  return m_Resources[a].m_FirstPass < m_Resources[b].m_FirstPass;
+				  });
+
+		struct Range
+		{
+			uint64_t m_Begin;
+			uint64_t m_End;
+		};
+
+		std::vector<uint32_t> placed;
+		std::vector<Range> occupied;
+		for (const auto r : transients)
+		{
+			auto& resource = m_Resources[r];
+			const auto size = AlignHeapSize(resource.m_SizeBytes);
+
+			// Memory taken by resources that are alive at the same time as this one
+			occupied.clear();
+			for (const auto other : placed)
+			{
+				const auto& o = m_Resources[other];
+				if (o.m_FirstPass <= resource.m_LastPass && resource.m_FirstPass <= o.m_LastPass)
+					occupied.push_back({o.m_HeapOffset, o.m_HeapOffset + AlignHeapSize(o.m_SizeBytes)});
+			}
+			std::sort(occupied.begin(),
+					  occupied.end(),
+					  [](const Range& a, const Range& b) { return a.m_Begin < b.m_Begin; });
+
+			// First gap that fits
+			uint64_t offset = 0;
+			for (const auto& range : occupied)
+			{
+				if (offset + size <= range.m_Begin)
+					break;
+				offset = std::max(offset, range.m_End);
+			}
+
+			resource.m_HeapOffset = offset;
+			placed.push_back(r);
+			m_Stats.m_TransientBytesAliased = std::max(m_Stats.m_TransientBytesAliased, offset + size);
+		}
+	}
+
+	void RenderGraph::ComputeBarriers()
+	{
+		std::vector<RGResourceState> states(m_Resources.size(), RGResourceState::UNDEFINED);
+		std::vector<bool> lastAccessWrote(m_Resources.size(), false);
+
+		for (auto& pass : m_Passes)
+			pass.m_Barriers.clear();
+
+		for (int i = 0; i < static_cast<int>(m_ExecutionOrder.size()); i++)
+		{
+			auto& pass = m_Passes[m_ExecutionOrder[i]];
+
+			for (const auto& access : pass.m_Accesses)
+			{
+				const auto r = access.m_Resource;
+				const auto& resource = m_Resources[r];
+
+				// First use of transient memory that previously belonged to another resource
+				if (resource.m_Transient && resource.m_FirstPass == i)
+				{
+					RGResourceHandle aliasedFrom = RG_INVALID_RESOURCE;
+					int latestUse = -1;
+					const auto end = resource.m_HeapOffset + AlignHeapSize(resource.m_SizeBytes);
+					for (RGResourceHandle other = 0; other < m_Resources.size(); other++)
+					{
+						const auto& o = m_Resources[other];
+						if (other == r || !o.m_Transient || o.m_FirstPass < 0 || o.m_LastPass >= i)
+							continue;
+
+						const auto oEnd = o.m_HeapOffset + AlignHeapSize(o.m_SizeBytes);
+						if (o.m_HeapOffset < end && resource.m_HeapOffset < oEnd && o.m_LastPass > latestUse)
+						{
+							latestUse = o.m_LastPass;
+							aliasedFrom = other;
+						}
+					}
+
+					if (aliasedFrom != RG_INVALID_RESOURCE)
+					{
+						RGBarrier barrier;
+						barrier.m_Type = RGBarrierType::ALIASING;
+						barrier.m_Resource = r;
+						barrier.m_AliasedFrom = aliasedFrom;
+						pass.m_Barriers.push_back(barrier);
+						m_Stats.m_NumAliasingBarriers++;
+					}
+				}
+
+				const auto wanted = IsWrite(access.m_Access) ? RGResourceState::UAV : RGResourceState::SRV;
+				if (states[r] != wanted)
+				{
+					RGBarrier barrier;
+					barrier.m_Type = RGBarrierType::TRANSITION;
+					barrier.m_Resource = r;
+					barrier.m_Before = states[r];
+					barrier.m_After = wanted;
+					pass.m_Barriers.push_back(barrier);
+					m_Stats.m_NumTransitionBarriers++;
+				}
+				else if (wanted == RGResourceState::UAV && lastAccessWrote[r])
+				{
+					// UAV -> UAV, the previous pass has to finish writing before we touch it again
+					RGBarrier barrier;
+					barrier.m_Type = RGBarrierType::UAV;
+					barrier.m_Resource = r;
+					barrier.m_Before = RGResourceState::UAV;
+					barrier.m_After = RGResourceState::UAV;
+					pass.m_Barriers.push_back(barrier);
+					m_Stats.m_NumUAVBarriers++;
+				}
+
+				states[r] = wanted;
+				lastAccessWrote[r] = IsWrite(access.m_Access);
+			}
+		}
+	}
+
+	void RenderGraph::Execute(const std::function<void(const RGBarrier&)>& issueBarrier) const
+	{
+		ASSERT_MSG(LOG_GRAPHICS, m_Compiled, "RenderGraph::Execute called before Compile");
+
+		for (const auto p : m_ExecutionOrder)
+		{
+			const auto& pass = m_Passes[p];
+
+			if (issueBarrier)
+				for (const auto& barrier : pass.m_Barriers)
+					issueBarrier(barrier);
+
+			if (pass.m_Execute)
+				pass.m_Execute();
+		}
+	}
+} // namespace Ball
@@ -2,9 +2,14 @@
 #include "Engine.h"
 #include "FileIO.h"
 #include "Input/Input.h"
+#include "Timer.h"
 #include "Window.h"
 
 #include "Rendering/Denoiser.h"
+#include "Rendering/EnergyLUT.h"
+#include "Rendering/EnvironmentMap.h"
+#include "Rendering/FrameScheduler.h"
+#include "Rendering/SamplingTables.h"
 #include "Rendering/BackEndRenderer.h"
 #include "Rendering/BEAR/CommandList.h"
 #include "Rendering/BEAR/ComputePipelineDescription.h"
@@ -26,11 +31,13 @@
 #include <TinyglTF/tiny_gltf.h>
 #include <glm/ext/matrix_transform.hpp>
 
+#include <stb/stb_image.h>
 #include <stb/stb_image_write.h>
 
 #include "Rendering/BufferManager.h"
 #include "Rendering/TextureManager.h"
 #include "ShaderHeaders/BloomStructsGPU.h"
+#include "ShaderHeaders/BsdfGPU.h"
 
 namespace Ball
 {
@@ -60,16 +67,20 @@ namespace Ball
 
 		// Initialize Back End Renderer API(s)
 		m_BackEndAPI = new BackEndRenderer();
+		m_FrameScheduler =
+			new FrameScheduler(m_BackEndAPI->GetGpuTimeline(),
+							   static_cast<uint32_t>((std::max)(LaunchParameters::GetInt("FramesInFlight", 2), 1)));
 		m_CmdList = new CommandList();
 		m_SamplerHeap = new SamplerDescriptorHeap();
 		m_SimpleRayTracer = new ComputePipelineDescription();
 		m_BlendingPipeline = new ComputePipelineDescription();
 		m_Denoiser = new Denoiser();
 
-		// Init Resource heap
+		// Init Resource heap, the header lives at the start of the heap for the whole lifetime of the renderer
+		// ORDER IS IMPORTANT! Check GpuModelStruct
 		m_ResourceHeap = new ResourceDescriptorHeap(g_RDHSize);
-		// Hacky fix to be able to resize on first frame, it copies impl from Render()
-		m_ResourceHeap->ReserveSpace(RDH_HEADER_SIZE);
+		const int lastHeaderSlot = m_ResourceHeap->ReserveSpace(RDH_HEADER_SIZE, "RDH Header");
+		ASSERT_MSG(LOG_GRAPHICS, lastHeaderSlot == RDH_HEADER_SIZE - 1, "RDH Heap Header doesn't match macro");
 
 		const auto windowWidth = window->GetWidth();
 		const auto windowHeight = window->GetHeight();
@@ -82,12 +93,15 @@ namespace Ball
 		renderTargetSpec.m_Flags = TextureFlags::NONE;
 
 		for (int i = 0; i < NUM_RT_BUFFERS; i++)
-			m_RenderTargets[i] =
-				TextureManager::Create(nullptr, renderTargetSpec, "Render Target [" + std::to_string(i) + "]");
+			m_RenderTargets[i] = TextureManager::Create(nullptr,
+														renderTargetSpec,
+														"Render Target [" + std::to_string(i) + "]",
+														MemoryTag::RENDER_TARGETS);
 
 		renderTargetSpec.m_Type = TextureType::RW_TEXTURE;
 		renderTargetSpec.m_Flags = TextureFlags::ALLOW_UA | TextureFlags::SCREENSIZE;
-		m_TransferToRTTexture = TextureManager::Create(nullptr, renderTargetSpec, "Intermediate Texture");
+		m_TransferToRTTexture =
+			TextureManager::Create(nullptr, renderTargetSpec, "Intermediate Texture", MemoryTag::RENDER_TARGETS);
 
 		// Initialize Command List and Render Targets (as Textures)
 		m_CmdList->Initialize(m_TransferToRTTexture);
@@ -113,10 +127,12 @@ namespace Ball
 		intermediateOutputSpec.m_Format = TextureFormat::R32_G32_B32_A32_FLOAT;
 		intermediateOutputSpec.m_Type = TextureType::RW_TEXTURE;
 		intermediateOutputSpec.m_Flags = (TextureFlags::ALLOW_UA | TextureFlags::SCREENSIZE);
-		m_OutputTexture = TextureManager::Create(nullptr, intermediateOutputSpec, "Intermediate Output Texture");
+		m_OutputTexture = TextureManager::Create(
+			nullptr, intermediateOutputSpec, "Intermediate Output Texture", MemoryTag::RENDER_TARGETS);
 
 		// Add samplers to (another) Bindless Heapkloofendal_48d_partly_cloudy_puresky_4k
 		LoadBlueNoiseTextures();
+		LoadEnergyLUTTextures();
 
 		m_PreviousCamera = new Camera();
 
@@ -160,7 +176,8 @@ namespace Ball
 			intermediateOutputSpec.m_Height = glm::max<int>(intermediateOutputSpec.m_Height >> 1, 1);
 			intermediateOutputSpec.m_Width = glm::max<int>(intermediateOutputSpec.m_Width >> 1, 1);
 
-			m_BloomIntermediateTextures[i] = TextureManager::Create(nullptr, intermediateOutputSpec, name);
+			m_BloomIntermediateTextures[i] =
+				TextureManager::Create(nullptr, intermediateOutputSpec, name, MemoryTag::RENDER_TARGETS);
 		}
 
 		// BLOOM STUF END
@@ -169,8 +186,12 @@ namespace Ball
 
 		const auto numPrimaryRays = windowWidth * windowHeight;
 
-		m_InstanceIDs = BufferManager::Create(
-			nullptr, sizeof(uint32_t), numPrimaryRays, (defaultUAV | BufferFlags::SCREENSIZE), "Instance IDs");
+		m_InstanceIDs = BufferManager::Create(nullptr,
+											  sizeof(uint32_t),
+											  numPrimaryRays,
+											  (defaultUAV | BufferFlags::SCREENSIZE),
+											  "Instance IDs",
+											  MemoryTag::WAVEFRONT);
 
 		m_OutlineObjectsPipeline = GenerateOutlineObjectsPipeline();
 
@@ -191,34 +212,51 @@ namespace Ball
 			for (int i = 0; i < std::size(m_RayBatch); i++)
 			{
 				std::string name = "Ray Batch " + std::to_string(i);
-				m_RayBatch[i] = BufferManager::Create(
-					nullptr, sizeof(Ray), numPrimaryRays, (defaultUAV | BufferFlags::SCREENSIZE), name);
+				m_RayBatch[i] = BufferManager::Create(nullptr,
+													  sizeof(Ray),
+													  numPrimaryRays,
+													  (defaultUAV | BufferFlags::SCREENSIZE),
+													  name,
+													  MemoryTag::WAVEFRONT);
 			}
 
 			m_RayExtendBatch = BufferManager::Create(nullptr,
 													 sizeof(ExtendResult),
 													 numPrimaryRays,
 													 (defaultUAV | BufferFlags::SCREENSIZE),
-													 "Extended Batch");
+													 "Extended Batch",
+													 MemoryTag::WAVEFRONT);
 
-			m_ShadowRayBatch = BufferManager::Create(
-				nullptr, sizeof(ShadowRay), numPrimaryRays, (defaultUAV | BufferFlags::SCREENSIZE), "Shadow Batch");
+			m_ShadowRayBatch = BufferManager::Create(nullptr,
+													 sizeof(ShadowRay),
+													 numPrimaryRays * 2, // Lights and the sky
+													 (defaultUAV | BufferFlags::SCREENSIZE),
+													 "Shadow Batch",
+													 MemoryTag::WAVEFRONT);
 
 			// Atomic Counters
-			m_NewRaysAtomic = BufferManager::Create(nullptr, sizeof(uint32_t), 1, defaultUAV, "Atomic New Rays");
-			m_ShadowRaysAtomic = BufferManager::Create(nullptr, sizeof(uint32_t), 2, defaultUAV, "Atomic Shadow Rays");
+			m_NewRaysAtomic = BufferManager::Create(
+				nullptr, sizeof(uint32_t), 1, defaultUAV, "Atomic New Rays", MemoryTag::WAVEFRONT);
+			m_ShadowRaysAtomic = BufferManager::Create(
+				nullptr, sizeof(uint32_t), 2, defaultUAV, "Atomic Shadow Rays", MemoryTag::WAVEFRONT);
 
 			// Counters
-			m_RayCount = BufferManager::Create(&numPrimaryRays, sizeof(uint32_t), 1, defaultUAV, "Ray Count");
+			m_RayCount = BufferManager::Create(
+				&numPrimaryRays, sizeof(uint32_t), 1, defaultUAV, "Ray Count", MemoryTag::WAVEFRONT);
 
-			m_WavefrontOutput = BufferManager::Create(
-				nullptr, sizeof(glm::vec4), numPrimaryRays, (defaultUAV | BufferFlags::SCREENSIZE), "Wavefront Output");
+			m_WavefrontOutput = BufferManager::Create(nullptr,
+													  sizeof(glm::vec4),
+													  numPrimaryRays,
+													  (defaultUAV | BufferFlags::SCREENSIZE),
+													  "Wavefront Output",
+													  MemoryTag::WAVEFRONT);
 
 			m_MaterialHitData = BufferManager::Create(nullptr,
 													  sizeof(MaterialHitData),
 													  numPrimaryRays,
 													  (defaultUAV | BufferFlags::SCREENSIZE),
-													  "Material Hit Data");
+													  "Material Hit Data",
+													  MemoryTag::WAVEFRONT);
 		}
 
 		// ---------- REPROJECT / DENOISE -----------------
@@ -242,8 +280,11 @@ namespace Ball
 		m_GridShaderPipeline->Initialize("Grid", gridShaderLayout);
 		m_GridSettings = {0.1f, glm::vec2(0.1, 0.1), 0.5f, glm::vec3(0.0, 0.0, 0.0)};
 
+		m_LogFrameGraphStats = true;
+
 		// We need to execute after making all resources to upload them to GPU (only Windows)
 		m_CmdList->Execute();
+		m_FrameScheduler->WaitForIdle();
 	}
 
 	void RenderAPI::ImGuiBeginFrame()
@@ -256,7 +297,8 @@ namespace Ball
 		{
 			m_ResizeDirty = false;
 
-			m_BackEndAPI->WaitForCmdQueueExecute();
+			// Every frame in flight reads the screen sized resources
+			m_FrameScheduler->WaitForIdle();
 			m_CmdList->Reset();
 
 			uint32_t const width = m_ResizeDims[0];
@@ -300,7 +342,8 @@ namespace Ball
 				{
 					// Texture doesn't exist, add it.
 					std::string name = "Intermediate Output Texture Mip " + std::to_string(i);
-					m_BloomIntermediateTextures[i] = TextureManager::Create(nullptr, spec, name);
+					m_BloomIntermediateTextures[i] =
+						TextureManager::Create(nullptr, spec, name, MemoryTag::RENDER_TARGETS);
 				}
 				else
 				{
@@ -312,9 +355,12 @@ namespace Ball
 			AddBloomTexturesToRDH();
 
 			m_CmdList->Execute();
+			// The next frame resets the allocator of its slot, which can be the one that just recorded the resize
+			m_FrameScheduler->WaitForIdle();
 
 			m_NumTotalFrames = 0;
 			m_AccumFramesNum = 0;
+			m_LogFrameGraphStats = true;
 		}
 	}
 
@@ -322,7 +368,7 @@ namespace Ball
 	{
 		if (LaunchParameters::Contains("Headless"))
 			return;
-		m_BackEndAPI->WaitForCmdQueueExecute();
+		m_FrameScheduler->WaitForIdle();
 	}
 
 	void RenderAPI::OnResize(const uint32_t width, const uint32_t height)
@@ -342,16 +388,41 @@ namespace Ball
 		m_ScreenShot.onComplete = onComplete;
 	}
 
-	void RenderAPI::DrawDebugLine(Line line)
+	void RenderAPI::DrawDebugLine(Line line, DebugDrawChannel channel)
+	{
+		if (g_DrawLines)
+			g_LineDrawer->AddLine(line, channel);
+	}
+
+	void RenderAPI::DrawDebugLine(glm::vec3 start, glm::vec3 end, glm::vec3 color, DebugDrawChannel channel)
+	{
+		if (g_DrawLines)
+			g_LineDrawer->GetStream().AddLine(start, end, color, channel);
+	}
+
+	void RenderAPI::DrawDebugAABB(const AABB& aabb, glm::vec3 color, DebugDrawChannel channel)
 	{
+		// A single box instance, the 12 edges are expanded by the vertex shader
 		if (g_DrawLines)
-			g_LineDrawer->AddLine(line);
+			g_LineDrawer->GetStream().AddAABB(aabb, color, channel);
 	}
 
-	void RenderAPI::DrawDebugLine(glm::vec3 start, glm::vec3 end, glm::vec3 color)
+	void RenderAPI::DrawDebugSphere(glm::vec3 center, float radius, glm::vec3 color, DebugDrawChannel channel)
 	{
 		if (g_DrawLines)
-			g_LineDrawer->AddLine({start, end, color});
+			g_LineDrawer->GetStream().AddSphere(center, radius, color, channel);
+	}
+
+	void RenderAPI::DrawDebugAxis(const glm::mat4& transform, float size, DebugDrawChannel channel)
+	{
+		if (g_DrawLines)
+			g_LineDrawer->GetStream().AddAxis(transform, size, channel);
+	}
+
+	void RenderAPI::DrawDebugFrustum(const CullingFrustum& frustum, glm::vec3 color, DebugDrawChannel channel)
+	{
+		if (g_DrawLines)
+			g_LineDrawer->GetStream().AddFrustum(frustum, color, channel);
 	}
 
 	// TEMPORARY SOLUTION - replace with the dirty flag, when cam transform is added
@@ -366,9 +437,9 @@ namespace Ball
 		if (LaunchParameters::Contains("Headless"))
 			return;
 
-		// Wait for Previous frame to Complete
-		m_BackEndAPI->WaitForCmdQueueExecute();
-		m_BackEndAPI->BeginFrame();
+		// Only waits when the GPU is still busy with the last frame that used this slot
+		const uint32_t frameSlot = m_FrameScheduler->BeginFrame();
+		m_BackEndAPI->BeginFrame(frameSlot);
 	}
 
 	void RenderAPI::Render()
@@ -392,27 +463,32 @@ namespace Ball
 
 		LoadSkyboxLogic();
 
+		// Descriptors freed by a frame can be reused once the GPU finished it
+		m_ResourceHeap->BeginFrame(m_FrameScheduler->GetFrameNumber(), m_FrameScheduler->GetCompletedFrame());
+
 		// Add Models from Queue if necessary
 		if (m_ModelManager->ReloadingModels())
 		{
-			delete m_ResourceHeap;
-			m_ResourceHeap = new ResourceDescriptorHeap(g_RDHSize);
+			// Reloading destroys buffers and acceleration structures the frames in flight still trace against
+			m_FrameScheduler->WaitForIdle();
 
-			// Add Reserved Header of our Bindless Heap (MODEL_DATA_HEAP_OFFSET)
+			// Refresh the Reserved Header of our Bindless Heap (MODEL_DATA_HEAP_OFFSET)
 			// ORDER IS IMPORTANT! Check GpuModelStruct
-			m_ResourceHeap->ReserveSpace(RDH_HEADER_SIZE);
 			m_ResourceHeap->Switch(*m_TransferToRTTexture, RDH_TRANSFER); // Output Texture
 			m_ResourceHeap->Switch(*m_SkyTexture, RDH_SKYBOX); // Sky Texture
+			m_ResourceHeap->Switch(*m_EnvironmentDistribution, RDH_ENVIRONMENT_DISTRIBUTION);
+			m_ResourceHeap->Switch(*m_SamplingTables, RDH_SAMPLING_TABLES);
+			m_ResourceHeap->Switch(*m_EnergyLUTTexture, RDH_ENERGY_LUT);
+			m_ResourceHeap->Switch(*m_DielectricEnergyLUTTexture, RDH_ENERGY_LUT_DIELECTRIC);
+			for (int i = 0; i < NUM_BLUENOISE; i++)
+				m_ResourceHeap->Switch(*m_BlueNoiseTextures[i], RDH_BLUENOISE + i);
 			// HACK : Fix this gap
 			// m_ResourceHeap->Switch(*GetUISystem().GetTexture(), RDH_ULTRALIGHT); // UI Texture
 			m_ResourceHeap->Switch(*m_OutputTexture, RDH_OUTPUT); // Output Texture
 
 			AddBloomTexturesToRDH();
 
-			ASSERT_MSG(LOG_GRAPHICS,
-					   m_ResourceHeap->GetNumElements() == RDH_HEADER_SIZE,
-					   "RDH Heap Header doesn't match macro");
-
+			// Models keep their slots between reloads, only new or unloaded models touch the allocator
 			m_ModelManager->ProcessModelLoadingQueue(*m_ResourceHeap);
 
 			// Hacky fix to rest the GPU buffers for ReSTIR whenever we change level
@@ -421,15 +497,20 @@ namespace Ball
 
 			BufferFlags defaultUAV = (BufferFlags::UAV | BufferFlags::ALLOW_UA | BufferFlags::DEFAULT_HEAP);
 			const auto numPrimaryRays = windowWidth * windowHeight;
-			m_Reservoirs = BufferManager::Create(
-				nullptr, sizeof(Reservoir), numPrimaryRays, (defaultUAV | BufferFlags::SCREENSIZE), "ReSTIR Reservoir");
-			m_PrevReservoirs = BufferManager::Create(
-				nullptr, sizeof(Reservoir), numPrimaryRays, (defaultUAV | BufferFlags::SCREENSIZE), "ReSTIR Reservoir");
+			m_Reservoirs = BufferManager::Create(nullptr,
+												 sizeof(Reservoir),
+												 numPrimaryRays,
+												 (defaultUAV | BufferFlags::SCREENSIZE),
+												 "ReSTIR Reservoir",
+												 MemoryTag::WAVEFRONT);
+			m_PrevReservoirs = BufferManager::Create(nullptr,
+													 sizeof(Reservoir),
+													 numPrimaryRays,
+													 (defaultUAV | BufferFlags::SCREENSIZE),
+													 "ReSTIR Reservoir",
+													 MemoryTag::WAVEFRONT);
 		}
 
-		m_ResourceHeap->Switch(*m_BlueNoiseTextures[m_NumTotalFrames & NUM_BLUENOISE - 1],
-							   RDH_BLUENOISE); // Blue Noise Texture
-
 		// UPDATES
 		auto cam = activeCamera->GetGPUCam(windowWidth, windowHeight);
 		auto prevCam = m_PreviousCamera->GetGPUCam(windowWidth, windowHeight);
@@ -482,188 +563,41 @@ namespace Ball
 
 		Utilities::PopGPUTimestamp(m_CmdList, sceneSetupTSs);
 
-		if (m_RenderMode != RenderModes::RM_PATH_TRACE)
-		{
-			m_CmdList->SetComputePipeline(*m_SimpleRayTracer);
-
-			// Binding Register Resources
-			m_CmdList->BindResource32BitConstants(0, &cam, sizeof(CameraGPU) / 4);
-			m_CmdList->BindResourceSRV(1, m_ModelManager->GetTLASRef());
-			m_CmdList->BindResource32BitConstants(2, &m_RenderMode, sizeof(DebugSettings) / 4);
-			m_CmdList->Dispatch(numGroupsX, numGroupsY, 1, true);
-		}
-		else
-		// -------- WAVEFRONT ------------
-		{
-			if (m_AccumFramesNum < m_MaxAccumulatedFrames || !m_AccumFrameCapEnabled)
-			{
-				m_AccumFramesNum++;
-
-				// Generate
-				DispatchGeneratePrimaryRays(numGroupsX, numGroupsY, cam);
-
-				// Bounces
-				for (uint32_t i = 0; i < m_MaxRecursionDepth; i++)
-				{
-					const auto loopTs = Utilities::PushGPUTimestamp(m_CmdList, "[GL] Wavefront " + std::to_string(i));
-
-					// Hack : Gameplay skybox was the code for the special rotating skybox that we now no longer have
-					bool gameplaySkybox = false;
-					GameplaySkyMat skyMat = {activeCamera->GetGameplaySkyboxRotMat(),
-											 uint32_t(gameplaySkybox),
-											 m_HDRILightingStrength,
-											 m_HDRIBackgroundStrength};
-					// Extend
-					DispatchExtendRays(numGroups1D, i);
-
-					// Shade
-					DispatchShadeRays(numGroups1D, i, skyMat, cam.m_PrimaryConeSpreadAngle);
-
-					// Direct Illumination
-					DispatchDirectIllum(numGroups1D, i);
-
-					// Connect
-					DispatchConnectRays(numGroups1D, i);
-
-					// Primary rays evaluations
-					if (i == 0)
-					{
-						// Temporal RIS + Reproject pixel calc
-						DispatchReprojectReSTIR(numGroups1D);
-
-						// Spatial Reuse
-						DispatchSpatialReSTIR(numGroups1D);
-
-						// Add Direct Lighting
-						DispatchShadeReSTIR(numGroups1D, i);
-					}
-
-					Utilities::PopGPUTimestamp(m_CmdList, loopTs);
-				}
-
-				DispatchFinalize(numGroupsX, numGroupsY);
-
-				// ------------- REPROJECT -----------------------
-				if (!m_AccumFramesEnabled && m_ReprojectionEnabled)
-				{
-					m_Denoiser->DispatchReproject(numGroups1D, m_CmdList, m_PrevReservoirs, m_Reservoirs);
-
-					if (m_DenoisingEnabled)
-					{
-						m_Denoiser->DispatchCalculateWeight(numGroups1D, cam, m_CmdList);
-						m_Denoiser->DispatchATrous(numGroups1D, cam, m_CmdList);
-						m_Denoiser->DispatchModulate(numGroups1D, cam, m_CmdList);
-					}
-				}
-			}
-
-			if (m_DispatchOutlineObjects && !m_ScreenShot.requested)
-				DispatchOutlineObjects(numGroups1D);
-		}
-
-		if (m_RunGridShader && !m_ScreenShot.requested)
+		const bool dispatchWavefront = m_AccumFramesNum < m_MaxAccumulatedFrames || !m_AccumFrameCapEnabled;
+		if (m_RenderMode == RenderModes::RM_PATH_TRACE && dispatchWavefront)
+			m_AccumFramesNum++;
+
+		// Hack : Gameplay skybox was the code for the special rotating skybox that we now no longer have
+		bool gameplaySkybox = false;
+		GameplaySkyMat skyMat = {activeCamera->GetGameplaySkyboxRotMat(),
+								 uint32_t(gameplaySkybox),
+								 m_HDRILightingStrength,
+								 m_HDRIBackgroundStrength};
+		m_EnvironmentSettings.m_Enabled = m_EnvironmentSampling ? 1 : 0;
+
+		// Debug visualizers are culled from screenshots
+		m_FrameGraph.Reset();
+		m_FrameGraph.SetDebugPassesEnabled(!m_ScreenShot.requested);
+		BuildFrameGraph(cam, skyMat, numGroupsX, numGroupsY, numGroups1D, dispatchWavefront);
+		m_FrameGraph.Compile();
+
+		if (m_LogFrameGraphStats)
 		{
-			const auto gridShader = Utilities::PushGPUTimestamp(m_CmdList, "Grid Shader");
-			m_CmdList->SetComputePipeline(*m_GridShaderPipeline);
-			// Binding Register Resources
-			m_CmdList->BindResource32BitConstants(0, &cam, sizeof(CameraGPU) / 4);
-			m_CmdList->BindResource32BitConstants(1, &m_GridSettings, sizeof(GridShaderSettings) / 4);
-			m_CmdList->BindResourceSRV(2, *m_Denoiser->GetBufferAt(DenoiseBuffers::CURRENT_DEPTH));
-			m_CmdList->Dispatch(numGroupsX, numGroupsY, 1, true);
-			Utilities::PopGPUTimestamp(m_CmdList, gridShader);
+			m_LogFrameGraphStats = false;
+			const auto& stats = m_FrameGraph.GetStats();
+			constexpr float toMB = 1.f / (1024.f * 1024.f);
+			LOG(LOG_GRAPHICS,
+				"Frame Graph: %u passes (%u culled), %u transitions, %u UAV barriers. Transient wavefront + denoiser "
+				"memory: %.2f MB allocated for the whole program, aliasing them in one heap would need %.2f MB",
+				stats.m_NumPasses,
+				stats.m_NumCulledPasses,
+				stats.m_NumTransitionBarriers,
+				stats.m_NumUAVBarriers,
+				float(stats.m_TransientBytesUnaliased) * toMB,
+				float(stats.m_TransientBytesAliased) * toMB);
 		}
 
-		// Bloom Start
-		// Downsample
-		if (m_BloomSettings.m_Enabled)
-		{
-			auto bloomTs = Utilities::PushGPUTimestamp(m_CmdList, "Bloom");
-			auto bloompMips = m_OutputTexture->CalculateMipsNum() - 1;
-			for (int targetMip = 1; targetMip <= bloompMips; targetMip++)
-			{
-				DownsampleData dsdata;
-				auto targetMipIndex = targetMip - 1;
-				Texture* dstTexture = m_BloomIntermediateTextures[targetMipIndex];
-				Texture* srcTexture = nullptr;
-				bool useKaris;
-				if (targetMip == 1)
-				{
-					srcTexture = m_OutputTexture;
-					useKaris = true;
-				}
-				else
-				{
-					srcTexture = m_BloomIntermediateTextures[targetMipIndex - 1];
-					useKaris = false;
-				}
-
-				dsdata.m_MipEvaulating = targetMip;
-				dsdata.m_SrcDimension = (srcTexture->GetHeight() & 1) << 1 | (srcTexture->GetWidth() & 1);
-				const float texelSizeX = 1.f / dstTexture->GetWidth();
-				const float texelSizeY = 1.f / dstTexture->GetHeight();
-				const glm::vec2 texelSize = {texelSizeX, texelSizeY};
-				dsdata.m_TexelSize = texelSize;
-				dsdata.m_UseKaris13Fetch = useKaris;
-
-				m_CmdList->SetComputePipeline(*m_BloomDownsamplePipeline);
-				m_CmdList->SetDescriptorHeaps(m_ResourceHeap, m_SamplerHeap);
-				m_CmdList->BindResource32BitConstants(0, &dsdata, sizeof(DownsampleData) / 4);
-				const int dispatchX = int(ceil(float(dstTexture->GetWidth()) / threadGroupSize));
-				const int dispatchY = int(ceil(float(dstTexture->GetHeight()) / threadGroupSize));
-				m_CmdList->Dispatch(dispatchX, dispatchY, 1, true);
-			}
-
-			// Upsample
-			for (int srcTextureIdx = bloompMips - 1; srcTextureIdx >= 0; srcTextureIdx--)
-			{
-				UpsampleData updata;
-				auto dstMipIndex = srcTextureIdx - 1;
-				Texture* dstTexture = nullptr;
-				Texture* srcTexture = m_BloomIntermediateTextures[srcTextureIdx];
-
-				// Mip Level of -1 of m_BloomIntermediateTextures is m_OutputTexture
-				if (dstMipIndex < 0)
-				{
-					dstTexture = m_OutputTexture;
-				}
-				else
-				{
-					dstTexture = m_BloomIntermediateTextures[dstMipIndex];
-				}
-
-				updata.m_Intensity = m_BloomSettings.m_Intensity;
-				updata.m_InvMipCount = 1.0f / (float)(bloompMips); // Not sure
-
-				const glm::vec2 invSrcDims = {1.f / (float)srcTexture->GetWidth(),
-											  1.f / (float)srcTexture->GetHeight()};
-				updata.m_InvSrcDims = invSrcDims;
-				updata.m_Radius = m_BloomSettings.m_Radius < 1.0f ? 1 : static_cast<uint>(m_BloomSettings.m_Radius);
-				updata.m_MipEvaulating = dstMipIndex + 1; // Because the RDH is offset by one
-
-				const glm::vec2 texelSize = {(float)srcTexture->GetWidth() / (float)dstTexture->GetWidth(),
-											 (float)srcTexture->GetHeight() / (float)dstTexture->GetHeight()};
-
-				updata.m_TexelSize = texelSize;
-
-				m_CmdList->SetComputePipeline(*m_BloomUpsamplePipeline);
-				m_CmdList->SetDescriptorHeaps(m_ResourceHeap, m_SamplerHeap);
-				m_CmdList->BindResource32BitConstants(0, &updata, sizeof(UpsampleData) / 4);
-				const int dispatchX = int(ceil(float(dstTexture->GetWidth()) / threadGroupSize));
-				const int dispatchY = int(ceil(float(dstTexture->GetHeight()) / threadGroupSize));
-				m_CmdList->Dispatch(dispatchX, dispatchY, 1, true);
-			}
-			Utilities::PopGPUTimestamp(m_CmdList, bloomTs);
-		}
-		// Bloom End
-
-		// Tonemap & write to m_TransferToRTTexture
-		auto tonemappingTs = Utilities::PushGPUTimestamp(m_CmdList, "Tonemapping");
-		m_CmdList->SetComputePipeline(*m_TonemappingPipeline);
-		m_CmdList->SetDescriptorHeaps(m_ResourceHeap, m_SamplerHeap);
-		m_CmdList->BindResource32BitConstants(0, &m_TonemapParams, sizeof(TonemapParameters) / 4);
-		m_CmdList->BindResourceSRV(1, *m_Denoiser->GetBufferAt(DenoiseBuffers::EMISSION));
-		m_CmdList->Dispatch(numGroupsX, numGroupsY, 1, true);
-		Utilities::PopGPUTimestamp(m_CmdList, tonemappingTs);
+		m_FrameGraph.Execute([this](const RGBarrier& barrier) { IssueFrameGraphBarrier(barrier); });
 
 		if (m_ScreenShot.requested)
 		{
@@ -693,7 +627,8 @@ namespace Ball
 		}
 
 		auto lineTs = Utilities::PushGPUTimestamp(m_CmdList, "Line Rendering");
-		g_LineDrawer->DrawLines(activeCamera);
+		g_LineDrawer->DrawLines(
+			activeCamera, m_Denoiser->GetBufferAt(DenoiseBuffers::CURRENT_DEPTH), cam.m_ScreenWidth);
 		Utilities::PopGPUTimestamp(m_CmdList, lineTs);
 
 		m_PreviousCamData = cam;
@@ -710,10 +645,11 @@ namespace Ball
 
 		Utilities::PopGPUTimestamp(m_CmdList, renderStartTs);
 		Utilities::SaveGPUTimestampData(m_CmdList);
-		m_Data = Utilities::ProcessReadbackBuffer();
+		Utilities::ProcessReadbackBuffer(m_Data);
 		m_CmdList->Execute();
 
 		m_BackEndAPI->PresentFrame();
+		m_FrameScheduler->EndFrame();
 
 		// Camera is updated in game loop which happens before render
 		*m_PreviousCamera = *activeCamera;
@@ -758,14 +694,24 @@ namespace Ball
 		g_LineDrawer->Shutdown();
 		delete g_LineDrawer;
 
+		// Runs the deferred deletions of everything destroyed above
+		m_FrameScheduler->WaitForIdle();
+		delete m_FrameScheduler;
+
 		m_BackEndAPI->Shutdown();
 		delete m_BackEndAPI;
 	}
 
 	void RenderAPI::DrawTriangleWireframeCPU()
 	{
+		if (!g_DrawLines)
+			return;
+
 		for (auto obj : GetLevel().GetObjectManager())
 		{
+			if (!m_ModelManager->IsVisible(obj))
+				continue;
+
 			auto t = ResourceManager<Model>::Get(obj->GetModelPath());
 			auto modelMat = obj->GetTransform().GetModelMatrix();
 			if (t.IsLoaded())
@@ -775,12 +721,29 @@ namespace Ball
 				for (const auto& prim : *data.m_PrimitiveBufferGPU)
 				{
 					uint64_t key = static_cast<uint64_t>(prim.GetPositionIndex()) << 32 | prim.GetIndexBufferIndex();
-					auto trigs = data.m_CPUTris.at(key);
 
-					for (Triangle& tri : trigs)
+					// Edges shared by triangles are drawn once, the list is only built the first time
+					auto edgesIt = data.m_WireframeEdges.find(key);
+					if (edgesIt == data.m_WireframeEdges.end())
+					{
+						edgesIt = data.m_WireframeEdges.emplace(key, std::vector<DebugEdge>()).first;
+						ExtractUniqueEdges(data.m_CPUTris.at(key), edgesIt->second);
+					}
+
+					const std::vector<DebugEdge>& edges = edgesIt->second;
+					DebugPrimitiveGPU* lines = g_LineDrawer->GetStream().AllocateLines(
+						static_cast<uint32_t>(edges.size()), DebugDrawChannel::OVERLAY);
+					if (lines == nullptr)
+						continue;
+
+					const glm::mat4 mat = modelMat * prim.GetMatrix();
+					const uint32_t color = PackDebugColor(m_WireframeTriangleLinesColor);
+					for (size_t i = 0; i < edges.size(); i++)
 					{
-						glm::mat4 mat = modelMat * prim.GetMatrix();
-						tri.Draw(mat);
+						WriteDebugLine(lines[i],
+									   glm::vec3(mat * glm::vec4(edges[i].m_Start, 1.f)),
+									   glm::vec3(mat * glm::vec4(edges[i].m_End, 1.f)),
+									   color);
 					}
 				}
 			}
@@ -895,6 +858,9 @@ namespace Ball
 		g_PreparingScreenshotData = false;
 		m_ScreenShot.requested = false;
 
+		// The copy to the readback buffer was recorded by the previous frame, which can still be in flight
+		m_FrameScheduler->WaitForIdle();
+
 		const auto& tex = m_TransferToRTTexture;
 		unsigned char* data = static_cast<unsigned char*>(tex->GetDataOnCPU());
 
@@ -967,14 +933,7 @@ namespace Ball
 	{
 		if (!m_UpdateNewSkyboxPath.empty())
 		{
-			TextureManager::Destroy(m_SkyTexture);
-
-			TextureSpec skyboxSpec;
-			skyboxSpec.m_Format = TextureFormat::R32_G32_B32_A32_FLOAT;
-			skyboxSpec.m_Type = TextureType::R_TEXTURE;
-			skyboxSpec.m_Flags = TextureFlags::NONE;
-
-			m_SkyTexture = TextureManager::CreateFromFilepath(m_UpdateNewSkyboxPath, skyboxSpec, "Skybox");
+			LoadSkyTexture(m_UpdateNewSkyboxPath);
 			m_UpdateNewSkyboxPath.clear();
 		}
 
@@ -983,15 +942,49 @@ namespace Ball
 		{
 			// Kinda dumb but should work...
 			LoadSkybox(LaunchParameters::GetString("Skybox", "Images/HDRIs/green_aurora.hdr"));
-			TextureSpec skyboxSpec;
-			skyboxSpec.m_Format = TextureFormat::R32_G32_B32_A32_FLOAT;
-			skyboxSpec.m_Type = TextureType::R_TEXTURE;
-			skyboxSpec.m_Flags = TextureFlags::NONE;
-
-			m_SkyTexture = TextureManager::CreateFromFilepath(m_UpdateNewSkyboxPath, skyboxSpec, "Skybox");
+			LoadSkyTexture(m_UpdateNewSkyboxPath);
 		}
 	}
 
+	void RenderAPI::LoadSkyTexture(const std::string& path)
+	{
+		ASSERT_MSG(LOG_GRAPHICS, FileIO::Exist(FileIO::Engine, path), "Skybox path doesn't exist: '%s'", path.c_str());
+		const std::string skyboxPath = FileIO::GetPath(FileIO::Engine, path);
+
+		// Loaded here instead of TextureManager::CreateFromFilepath, the distribution is built from the same pixels
+		int width, height, channels;
+		float* data = stbi_loadf(skyboxPath.c_str(), &width, &height, &channels, 4);
+		ASSERT_MSG(LOG_GRAPHICS, data != nullptr, "stbi_loadf() failed for the skybox %s", path.c_str());
+
+		TextureManager::Destroy(m_SkyTexture);
+		TextureSpec skyboxSpec;
+		skyboxSpec.m_Width = width;
+		skyboxSpec.m_Height = height;
+		skyboxSpec.m_Format = TextureFormat::R32_G32_B32_A32_FLOAT;
+		skyboxSpec.m_Type = TextureType::R_TEXTURE;
+		skyboxSpec.m_Flags = TextureFlags::NONE;
+		m_SkyTexture = TextureManager::Create(data, skyboxSpec, "Skybox");
+
+		START_TIMER(EnvironmentDistribution);
+		const EnvironmentDistribution distribution = BuildEnvironmentDistribution(data, width, height);
+		END_TIMER_MSG(EnvironmentDistribution,
+					  "Built the %u x %u environment distribution of %s",
+					  distribution.m_Width,
+					  distribution.m_Height,
+					  path.c_str());
+		stbi_image_free(data);
+
+		BufferManager::Destroy(m_EnvironmentDistribution);
+		m_EnvironmentDistribution = BufferManager::Create(distribution.m_Entries.data(),
+														  sizeof(EnvironmentAliasEntry),
+														  static_cast<uint32_t>(distribution.m_Entries.size()),
+														  BufferFlags::SRV | BufferFlags::DEFAULT_HEAP,
+														  "Environment Distribution",
+														  MemoryTag::TEXTURES);
+		m_EnvironmentSettings.m_Width = distribution.m_Width;
+		m_EnvironmentSettings.m_Height = distribution.m_Height;
+	}
+
 	void RenderAPI::AddBloomTexturesToRDH()
 	{
 		int rdh_index = RDH_OUTPUT + 1;
@@ -1010,17 +1003,50 @@ namespace Ball
 
 	void RenderAPI::LoadBlueNoiseTextures()
 	{
+		const SamplingTables tables = LoadOrBuildSamplingTables();
+		ASSERT_MSG(LOG_GRAPHICS,
+				   tables.m_BlueNoiseSlices == NUM_BLUENOISE,
+				   "The blue noise has %u slices, the renderer cycles through %u",
+				   tables.m_BlueNoiseSlices,
+				   NUM_BLUENOISE);
+
 		TextureSpec blueNoiseSpec;
-		blueNoiseSpec.m_Format = TextureFormat::R32_G32_B32_A32_FLOAT;
+		blueNoiseSpec.m_Width = tables.m_BlueNoiseSize;
+		blueNoiseSpec.m_Height = tables.m_BlueNoiseSize;
+		blueNoiseSpec.m_Format = TextureFormat::R32_G32_FLOAT;
 		blueNoiseSpec.m_Type = TextureType::R_TEXTURE;
 		blueNoiseSpec.m_Flags = TextureFlags::NONE;
 
+		const size_t sliceSize = static_cast<size_t>(tables.m_BlueNoiseSize) * tables.m_BlueNoiseSize;
 		for (int i = 0; i < NUM_BLUENOISE; i++)
 		{
-			std::string path = std::string("Images/BlueNoise/product_" + std::to_string(i) + ".png");
-			m_BlueNoiseTextures[i] =
-				TextureManager::CreateFromFilepath(path, blueNoiseSpec, std::string("BlueNoise_" + std::to_string(i)));
+			m_BlueNoiseTextures[i] = TextureManager::Create(
+				&tables.m_BlueNoise[i * sliceSize], blueNoiseSpec, std::string("BlueNoise_" + std::to_string(i)));
 		}
+
+		m_SamplingTables = BufferManager::Create(tables.m_Tables.data(),
+												 sizeof(uint32_t),
+												 static_cast<uint32_t>(tables.m_Tables.size()),
+												 BufferFlags::SRV | BufferFlags::DEFAULT_HEAP,
+												 "Sampling Tables",
+												 MemoryTag::TEXTURES);
+	}
+
+	void RenderAPI::LoadEnergyLUTTextures()
+	{
+		const EnergyLUTs luts = LoadOrBakeEnergyLUTs();
+
+		TextureSpec lutSpec;
+		lutSpec.m_Width = Bsdf::ENERGY_LUT_SIZE;
+		lutSpec.m_Height = Bsdf::ENERGY_LUT_SIZE;
+		lutSpec.m_Format = TextureFormat::R32_G32_FLOAT;
+		lutSpec.m_Type = TextureType::R_TEXTURE;
+		lutSpec.m_Flags = TextureFlags::NONE;
+		m_EnergyLUTTexture = TextureManager::Create(luts.m_Reflection.data(), lutSpec, "Energy LUT");
+
+		lutSpec.m_Height = Bsdf::ENERGY_LUT_SIZE * Bsdf::ENERGY_LUT_ETA_SLICES;
+		m_DielectricEnergyLUTTexture =
+			TextureManager::Create(luts.m_Dielectric.data(), lutSpec, "Dielectric Energy LUT");
 	}
 
 	inline TonemapParameters SetDefaultTonemapValues()
@@ -0,0 +1,400 @@
+#include "Rendering/SamplingTables.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <numeric>
+
+#include "FileIO.h"
+#include "Log.h"
+#include "ShaderHeaders/RandomGPU.h"
+#include "Utilities/LaunchParameters.h"
+
+namespace Ball
+{
+	namespace
+	{
+		// Bump when the tables change, outdated caches are built again
+		constexpr uint32_t SAMPLING_TABLES_VERSION = 1;
+		constexpr uint32_t SAMPLING_TABLES_MAGIC = 0x4C504D53; // "SMPL"
+		constexpr const char* SAMPLING_TABLES_CACHE = "SamplingTables.bin";
+		constexpr uint32_t INVALID_TEXEL = UINT32_MAX;
+
+		struct SamplingTablesHeader
+		{
+			uint32_t m_Magic = SAMPLING_TABLES_MAGIC;
+			uint32_t m_Version = SAMPLING_TABLES_VERSION;
+			uint32_t m_Size = Sampling::BLUE_NOISE_SIZE;
+			uint32_t m_Slices = BlueNoiseSettings().m_Slices;
+			uint32_t m_SobolDimensions = Sampling::SOBOL_DIMENSIONS;
+		};
+
+		// Primitive polynomial of degree s with the inner coefficients in a, and the first s direction numbers.
+		// Dimensions 2 to 8 of new-joe-kuo-6.21201, the first dimension is the van der Corput sequence.
+		struct DirectionNumbers
+		{
+			uint32_t m_Degree;
+			uint32_t m_Coefficients;
+			uint32_t m_Initial[5];
+		};
+
+		constexpr DirectionNumbers SOBOL_DIRECTION_NUMBERS[MAX_SOBOL_DIMENSIONS - 1] = {
+			{1, 0, {1}},
+			{2, 1, {1, 3}},
+			{3, 1, {1, 3, 1}},
+			{3, 2, {1, 1, 1}},
+			{4, 1, {1, 1, 3, 3}},
+			{4, 4, {1, 3, 5, 13}},
+			{5, 2, {1, 1, 5, 5, 17}},
+		};
+
+		/// <summary>
+		/// Energies of the texels of all slices, with the most empty and most crowded texel of every slice cached.
+		/// Toggling a texel changes its whole slice, but only one texel in every other slice, so most caches survive.
+		/// </summary>
+		class VoidAndCluster
+		{
+		public:
+			explicit VoidAndCluster(const BlueNoiseSettings& settings)
+				: m_Size(settings.m_Size)
+				, m_Slices(settings.m_Slices)
+				, m_Area(settings.m_Size * settings.m_Size)
+				, m_Energies(m_Area * m_Slices, 0.f)
+				, m_Filled(m_Area * m_Slices, 0)
+				, m_SpatialKernel(m_Area)
+				, m_TemporalKernel(m_Slices)
+				, m_Voids(m_Slices, INVALID_TEXEL)
+				, m_Clusters(m_Slices, INVALID_TEXEL)
+				, m_Dirty(m_Slices, 1)
+			{
+				const float spatial = 2.f * settings.m_SpatialSigma * settings.m_SpatialSigma;
+				for (uint32_t y = 0; y < m_Size; y++)
+				{
+					for (uint32_t x = 0; x < m_Size; x++)
+					{
+						const float dx = static_cast<float>((std::min)(x, m_Size - x));
+						const float dy = static_cast<float>((std::min)(y, m_Size - y));
+						m_SpatialKernel[y * m_Size + x] = std::exp(-(dx * dx + dy * dy) / spatial);
+					}
+				}
+
+				// The texel itself is part of the spatial kernel
+				const float temporal = 2.f * settings.m_TemporalSigma * settings.m_TemporalSigma;
+				for (uint32_t t = 1; t < m_Slices; t++)
+				{
+					const float dt = static_cast<float>((std::min)(t, m_Slices - t));
+					m_TemporalKernel[t] = std::exp(-dt * dt / temporal);
+				}
+				m_TemporalKernel[0] = 0.f;
+			}
+
+			uint32_t GetNumTexels() const { return m_Area * m_Slices; }
+			bool IsFilled(uint32_t texel) const { return m_Filled[texel] != 0; }
+
+			void Set(uint32_t texel, bool fill)
+			{
+				const float sign = fill ? 1.f : -1.f;
+				m_Filled[texel] = fill ? 1 : 0;
+
+				const uint32_t slice = texel / m_Area;
+				const uint32_t local = texel % m_Area;
+				const uint32_t x = local % m_Size;
+				const uint32_t y = local / m_Size;
+				const uint32_t mask = m_Size - 1;
+
+				float* energies = &m_Energies[slice * m_Area];
+				for (uint32_t dy = 0; dy < m_Size; dy++)
+				{
+					float* row = &energies[((y + dy) & mask) * m_Size];
+					const float* kernel = &m_SpatialKernel[dy * m_Size];
+					for (uint32_t dx = 0; dx < m_Size; dx++)
+						row[(x + dx) & mask] += sign * kernel[dx];
+				}
+				Refresh(slice);
+
+				for (uint32_t other = 0; other < m_Slices; other++)
+				{
+					if (other == slice)
+						continue;
+					const uint32_t neighbour = other * m_Area + local;
+					m_Energies[neighbour] += sign * m_TemporalKernel[(other + m_Slices - slice) % m_Slices];
+					Update(other, neighbour, fill);
+				}
+			}
+
+			// Empty texel with the lowest energy
+			uint32_t LargestVoid() { return Best(m_Voids, false); }
+
+			// Filled texel with the highest energy
+			uint32_t TightestCluster() { return Best(m_Clusters, true); }
+
+		private:
+			// Ties go to the lower texel index, so the result doesn't depend on the order texels are visited in
+			bool IsBetterVoid(uint32_t a, uint32_t b) const
+			{
+				return b == INVALID_TEXEL || m_Energies[a] < m_Energies[b] || (m_Energies[a] == m_Energies[b] && a < b);
+			}
+
+			bool IsBetterCluster(uint32_t a, uint32_t b) const
+			{
+				return b == INVALID_TEXEL || m_Energies[a] > m_Energies[b] || (m_Energies[a] == m_Energies[b] && a < b);
+			}
+
+			void Refresh(uint32_t slice)
+			{
+				uint32_t bestVoid = INVALID_TEXEL;
+				uint32_t bestCluster = INVALID_TEXEL;
+				for (uint32_t texel = slice * m_Area; texel < (slice + 1) * m_Area; texel++)
+				{
+					if (m_Filled[texel] != 0)
+					{
+						if (IsBetterCluster(texel, bestCluster))
+							bestCluster = texel;
+					}
+					else if (IsBetterVoid(texel, bestVoid))
+						bestVoid = texel;
+				}
+				m_Voids[slice] = bestVoid;
+				m_Clusters[slice] = bestCluster;
+				m_Dirty[slice] = 0;
+			}
+
+			// The energy of one texel went up (increased) or down, only a cached texel that got worse needs a rescan
+			void Update(uint32_t slice, uint32_t texel, bool increased)
+			{
+				if (m_Dirty[slice] != 0)
+					return;
+
+				if (m_Filled[texel] != 0)
+				{
+					if (texel == m_Clusters[slice])
+						m_Dirty[slice] = increased ? 0 : 1;
+					else if (increased && IsBetterCluster(texel, m_Clusters[slice]))
+						m_Clusters[slice] = texel;
+				}
+				else
+				{
+					if (texel == m_Voids[slice])
+						m_Dirty[slice] = increased ? 1 : 0;
+					else if (!increased && IsBetterVoid(texel, m_Voids[slice]))
+						m_Voids[slice] = texel;
+				}
+			}
+
+			uint32_t Best(const std::vector<uint32_t>& cache, bool cluster)
+			{
+				uint32_t best = INVALID_TEXEL;
+				for (uint32_t slice = 0; slice < m_Slices; slice++)
+				{
+					if (m_Dirty[slice] != 0)
+						Refresh(slice);
+					const uint32_t candidate = cache[slice];
+					if (candidate == INVALID_TEXEL)
+						continue;
+					if (cluster ? IsBetterCluster(candidate, best) : IsBetterVoid(candidate, best))
+						best = candidate;
+				}
+				return best;
+			}
+
+			uint32_t m_Size;
+			uint32_t m_Slices;
+			uint32_t m_Area;
+			std::vector<float> m_Energies;
+			std::vector<uint8_t> m_Filled;
+			std::vector<float> m_SpatialKernel; // Indexed by the wrapped offset, dy * size + dx
+			std::vector<float> m_TemporalKernel; // Indexed by the wrapped slice offset
+			std::vector<uint32_t> m_Voids;
+			std::vector<uint32_t> m_Clusters;
+			std::vector<uint8_t> m_Dirty;
+		};
+	} // namespace
+
+	std::vector<uint32_t> BuildSobolMatrices(uint32_t numDimensions)
+	{
+		ASSERT(LOG_GRAPHICS, numDimensions <= MAX_SOBOL_DIMENSIONS);
+		constexpr uint32_t bits = Sampling::SOBOL_BITS;
+		std::vector<uint32_t> matrices(numDimensions * bits);
+		for (uint32_t i = 0; i < bits && numDimensions > 0; i++)
+			matrices[i] = 1u << (bits - 1 - i);
+
+		for (uint32_t dimension = 1; dimension < numDimensions; dimension++)
+		{
+			const DirectionNumbers& numbers = SOBOL_DIRECTION_NUMBERS[dimension - 1];
+			const uint32_t s = numbers.m_Degree;
+			uint32_t* v = &matrices[dimension * bits];
+			for (uint32_t i = 0; i < s; i++)
+				v[i] = numbers.m_Initial[i] << (bits - 1 - i);
+
+			// Recurrence of the primitive polynomial
+			for (uint32_t i = s; i < bits; i++)
+			{
+				v[i] = v[i - s] ^ (v[i - s] >> s);
+				for (uint32_t k = 1; k < s; k++)
+				{
+					if (((numbers.m_Coefficients >> (s - 1 - k)) & 1u) != 0)
+						v[i] ^= v[i - k];
+				}
+			}
+		}
+		return matrices;
+	}
+
+	std::vector<uint32_t> BuildBlueNoiseRanks(const BlueNoiseSettings& settings)
+	{
+		ASSERT_MSG(LOG_GRAPHICS,
+				   settings.m_Size > 0 && (settings.m_Size & (settings.m_Size - 1)) == 0,
+				   "Blue noise masks wrap with a bit mask, %u isn't a power of two",
+				   settings.m_Size);
+
+		VoidAndCluster prototype(settings);
+		const uint32_t numTexels = prototype.GetNumTexels();
+
+		// Initial binary pattern, random texels that are then moved from clusters into voids until nothing moves
+		uint32_t seed = ShaderRandom::GetWangHashSeed(settings.m_Seed);
+		const uint32_t numInitial =
+			(std::max)(1u, static_cast<uint32_t>(static_cast<float>(numTexels) * settings.m_InitialDensity));
+		for (uint32_t placed = 0; placed < numInitial;)
+		{
+			const float random = ShaderRandom::rand(seed) * static_cast<float>(numTexels);
+			const uint32_t randomTexel = static_cast<uint32_t>(random);
+			const uint32_t texel = (std::min)(randomTexel, numTexels - 1);
+			if (prototype.IsFilled(texel))
+				continue;
+			prototype.Set(texel, true);
+			placed++;
+		}
+		for (uint32_t iteration = 0; iteration < numTexels; iteration++)
+		{
+			const uint32_t cluster = prototype.TightestCluster();
+			prototype.Set(cluster, false);
+			const uint32_t largestVoid = prototype.LargestVoid();
+			prototype.Set(largestVoid, true);
+			if (largestVoid == cluster)
+				break;
+		}
+
+		std::vector<uint32_t> ranks(numTexels);
+
+		// Phase 1, the tightest clusters of the pattern get the ranks below it
+		VoidAndCluster removal = prototype;
+		for (uint32_t rank = numInitial; rank-- > 0;)
+		{
+			const uint32_t cluster = removal.TightestCluster();
+			removal.Set(cluster, false);
+			ranks[cluster] = rank;
+		}
+
+		// Phase 2 and 3, filling the largest void is the same as removing the tightest cluster of empty texels
+		for (uint32_t rank = numInitial; rank < numTexels; rank++)
+		{
+			const uint32_t largestVoid = prototype.LargestVoid();
+			prototype.Set(largestVoid, true);
+			ranks[largestVoid] = rank;
+		}
+
+		// The ranks run over all slices, every slice gets its own ranks in the same order so each one is uniform
+		const uint32_t area = settings.m_Size * settings.m_Size;
+		std::vector<uint32_t> order(area);
+		std::vector<uint32_t> sliceRanks(numTexels);
+		for (uint32_t slice = 0; slice < settings.m_Slices; slice++)
+		{
+			const uint32_t* globalRanks = &ranks[slice * area];
+			std::iota(order.begin(), order.end(), 0u);
+			std::sort(order.begin(),
+					  order.end(),
+					  [&](uint32_t a, uint32_t b) { return globalRanks[a] < globalRanks[b]; });
+			for (uint32_t i = 0; i < area; i++)
+				sliceRanks[slice * area + order[i]] = i;
+		}
+		return sliceRanks;
+	}
+
+	SamplingTables BuildSamplingTables(const BlueNoiseSettings& settings)
+	{
+		SamplingTables tables;
+		tables.m_BlueNoiseSize = settings.m_Size;
+		tables.m_BlueNoiseSlices = settings.m_Slices;
+
+		// One mask per channel, with their own seeds
+		std::vector<uint32_t> ranks[2];
+		std::vector<uint32_t> channels = {0, 1};
+		std::for_each(std::execution::par,
+					  channels.begin(),
+					  channels.end(),
+					  [&](uint32_t channel)
+					  {
+						  BlueNoiseSettings channelSettings = settings;
+						  channelSettings.m_Seed = settings.m_Seed + channel;
+						  ranks[channel] = BuildBlueNoiseRanks(channelSettings);
+					  });
+
+		const uint32_t area = settings.m_Size * settings.m_Size;
+		const float invArea = 1.f / static_cast<float>(area);
+		tables.m_BlueNoise.resize(ranks[0].size());
+		for (size_t i = 0; i < ranks[0].size(); i++)
+		{
+			tables.m_BlueNoise[i] = glm::vec2((static_cast<float>(ranks[0][i]) + 0.5f) * invArea,
+											  (static_cast<float>(ranks[1][i]) + 0.5f) * invArea);
+		}
+
+		// The lattice of the shaders is indexed by the first slice of the first mask
+		ASSERT_MSG(LOG_GRAPHICS,
+				   area == Sampling::LATTICE_POINTS,
+				   "The lattice needs a %u x %u mask",
+				   Sampling::BLUE_NOISE_SIZE,
+				   Sampling::BLUE_NOISE_SIZE);
+		tables.m_Tables = BuildSobolMatrices();
+		tables.m_Tables.insert(tables.m_Tables.end(), ranks[0].begin(), ranks[0].begin() + area);
+		return tables;
+	}
+
+	SamplingTables LoadOrBuildSamplingTables()
+	{
+		const BlueNoiseSettings settings;
+		const uint32_t area = settings.m_Size * settings.m_Size;
+		SamplingTables tables;
+		tables.m_BlueNoiseSize = settings.m_Size;
+		tables.m_BlueNoiseSlices = settings.m_Slices;
+		tables.m_Tables.resize(Sampling::SAMPLING_TABLES_SIZE);
+		tables.m_BlueNoise.resize(area * settings.m_Slices);
+		const size_t tablesBytes = tables.m_Tables.size() * sizeof(uint32_t);
+		const size_t blueNoiseBytes = tables.m_BlueNoise.size() * sizeof(glm::vec2);
+		const size_t fileSize = sizeof(SamplingTablesHeader) + tablesBytes + blueNoiseBytes;
+
+		const bool forceBuild = LaunchParameters::Contains("BakeSamplingTables");
+		if (!forceBuild && FileIO::Exist(FileIO::TempData, SAMPLING_TABLES_CACHE) &&
+			FileIO::GetSize(FileIO::TempData, SAMPLING_TABLES_CACHE) == fileSize)
+		{
+			std::vector<uint8_t> data(fileSize);
+			const SamplingTablesHeader expected;
+			if (FileIO::ReadBinary(FileIO::TempData, SAMPLING_TABLES_CACHE, data.data(), fileSize) &&
+				std::memcmp(data.data(), &expected, sizeof(SamplingTablesHeader)) == 0)
+			{
+				const uint8_t* payload = data.data() + sizeof(SamplingTablesHeader);
+				std::memcpy(tables.m_Tables.data(), payload, tablesBytes);
+				std::memcpy(tables.m_BlueNoise.data(), payload + tablesBytes, blueNoiseBytes);
+				return tables;
+			}
+		}
+
+		INFO(LOG_GRAPHICS, "Building the blue noise masks and Sobol tables");
+		tables = BuildSamplingTables(settings);
+
+		std::vector<uint8_t> data(fileSize);
+		const SamplingTablesHeader header;
+		std::memcpy(data.data(), &header, sizeof(SamplingTablesHeader));
+		std::memcpy(data.data() + sizeof(SamplingTablesHeader), tables.m_Tables.data(), tablesBytes);
+		uint8_t* blueNoiseData = data.data() + sizeof(SamplingTablesHeader) + tablesBytes;
+		std::memcpy(blueNoiseData, tables.m_BlueNoise.data(), blueNoiseBytes);
+		if (!FileIO::WriteBinary(FileIO::TempData, SAMPLING_TABLES_CACHE, data.data(), data.size()))
+			WARN(LOG_GRAPHICS, "Couldn't cache the sampling tables, they will be built again next launch");
+		return tables;
+	}
+
+	void BindSamplingTables(const SamplingTables* tables)
+	{
+		Sampling::g_SamplingTables = tables != nullptr ? tables->m_Tables.data() : nullptr;
+	}
+} // namespace Ball
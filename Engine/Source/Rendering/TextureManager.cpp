@@ -9,15 +9,20 @@
 
 using namespace Ball;
 
-Texture* TextureManager::Create(const void* data, TextureSpec spec, const std::string& name)
+Texture* TextureManager::Create(const void* data, TextureSpec spec, const std::string& name, MemoryTag tag)
 {
 	Texture* texture = new Texture(data, spec, name);
-	m_Textures.push_back(texture);
+	texture->m_MemoryTag = tag;
+	GetMemoryTracker().Allocate(tag, texture->GetSizeBytes());
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Textures.insert(texture);
 	m_TextureCount++;
 	return texture;
 }
 
-Texture* TextureManager::CreateFromFilepath(const std::string& path, TextureSpec spec, const std::string& name)
+Texture* TextureManager::CreateFromFilepath(const std::string& path, TextureSpec spec, const std::string& name,
+											MemoryTag tag)
 {
 	ASSERT_MSG(LOG_GRAPHICS, FileIO::Exist(FileIO::Engine, path), "Texture path doesn't exist: '%s'", path.c_str());
 	std::string texturepath = FileIO::GetPath(FileIO::Engine, path);
@@ -34,24 +39,38 @@ Texture* TextureManager::CreateFromFilepath(const std::string& path, TextureSpec
 	if (!data)
 		ASSERT_MSG(LOG_GRAPHICS, false, "stbi_load() failed in Texture constructor for %s", path.c_str());
 
-	Texture* texture = Create(data, spec, name);
+	Texture* texture = Create(data, spec, name, tag);
 	stbi_image_free(data);
 	return texture;
 }
 
 void TextureManager::Destroy(Texture* texture)
 {
-	m_Textures.remove(texture);
+	if (texture == nullptr)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		const size_t numErased = m_Textures.erase(texture);
+		ASSERT_MSG(LOG_GRAPHICS, numErased == 1, "Texture '%s' wasn't created by the TextureManager",
+				   texture->GetName().c_str());
+		m_TextureCount--;
+	}
+
+	GetMemoryTracker().Free(texture->GetMemoryTag(), texture->GetSizeBytes());
 	delete texture;
-	m_TextureCount--;
 }
 
 void TextureManager::DestroyAll()
 {
+	std::lock_guard<std::mutex> lock(m_Mutex);
 	m_TextureCount = 0;
 
 	for (auto& tex : m_Textures)
+	{
+		GetMemoryTracker().Free(tex->GetMemoryTag(), tex->GetSizeBytes());
 		delete tex;
+	}
 
 	m_Textures.clear();
 }
@@ -14,29 +14,48 @@ void BindlessHeapViewer::Draw()
 
 	RenderAPI& renderer = GetEngine().GetRenderer();
 
-	uint32_t textureCount = renderer.GetResourceDescriptorHeap()->GetTextureElementCount();
-	ImGui::Text("Resource descriptor element count: %i", textureCount);
+	ResourceDescriptorHeap* heap = renderer.GetResourceDescriptorHeap();
+	const DescriptorAllocatorStats stats = heap->GetAllocator().GetStats();
+	ImGui::Text("Resource descriptors: %u / %u", stats.m_PersistentAllocated, stats.m_PersistentCapacity);
+	ImGui::Text("Free blocks: %u, largest free block: %u, waiting for GPU: %u",
+				stats.m_NumFreeBlocks,
+				stats.m_LargestFreeBlock,
+				stats.m_PendingFrees);
 	ImGui::Checkbox("Hide buffer entries", &m_HideBufferEntires);
 
-	ImGui::Text("Textures:");
-	for (uint32_t i = 0; i < textureCount; i++)
+#ifndef SHIPPING
+	ImGui::Text("Allocations:");
+	for (const auto& allocation : heap->GetAllocator().GetDebugAllocations())
 	{
-		std::string name = renderer.GetResourceDescriptorHeap()->GetTextureElementName(i).c_str();
-		if (name.compare("null") != 0)
+		const DescriptorRange& range = allocation.m_Range;
+		if (!ImGui::TreeNode(reinterpret_cast<void*>(static_cast<uintptr_t>(range.m_Start)),
+							 "[%u - %u] %s",
+							 range.m_Start,
+							 range.GetLast(),
+							 allocation.m_Owner.c_str()))
+			continue;
+
+		for (uint32_t i = range.m_Start; i <= range.GetLast(); i++)
 		{
-			// Only print entry with name when its a texture
-			// But when hideBuffer entries is false also show buffer entries
-			if (name.compare("buffer") != 0 || !m_HideBufferEntires)
+			std::string name = heap->GetTextureElementName(i);
+			if (name.compare("null") != 0)
 			{
-				ImGui::Text("	[%i] %s", i, name.c_str());
+				// Only print entry with name when its a texture
+				// But when hideBuffer entries is false also show buffer entries
+				if (name.compare("buffer") != 0 || !m_HideBufferEntires)
+				{
+					ImGui::Text("	[%u] %s", i, name.c_str());
+				}
+			}
+			else
+			{
+				// Print invalid text when name is null
+				ImGui::Text("	[%u] invalid", i);
 			}
 		}
-		else
-		{
-			// Print invalid text when name is null
-			ImGui::Text("	[%i] invalid", i);
-		}
+		ImGui::TreePop();
 	}
+#endif
 
 	// Add spacing between lists
 	float spacing = ImGui::GetCursorPosY();
@@ -33,7 +33,8 @@ void BufferVisualizer::Draw()
 	ImGui::Combo("Sort by", &sortOption, sortItems, IM_ARRAYSIZE(sortItems));
 
 	const std::vector<std::string> items = {
-		"NONE", "CBV", "SRV", "UAV", "ALLOW_UA", "DEFAULT_HEAP", "UPLOAD_HEAP", "VERTEX_BUFFER", "SCREENSIZE"};
+		"NONE", "CBV", "SRV", "UAV", "ALLOW_UA", "DEFAULT_HEAP", "UPLOAD_HEAP", "VERTEX_BUFFER", "SCREENSIZE",
+		"PER_FRAME"};
 
 	if (ImGui::BeginCombo("Filter", "Select..."))
 	{
@@ -144,6 +145,8 @@ void BufferVisualizer::Draw()
 				ImGui::BulletText("VERTEX_BUFFER");
 			if ((flags & BufferFlags::SCREENSIZE) != BufferFlags::NONE)
 				ImGui::BulletText("SCREENSIZE");
+			if ((flags & BufferFlags::PER_FRAME) != BufferFlags::NONE)
+				ImGui::BulletText("PER_FRAME");
 		}
 
 		if (!open)
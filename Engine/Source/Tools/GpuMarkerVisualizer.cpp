@@ -56,17 +56,17 @@ void GpuMarkerVisualizer::Draw()
 		{
 			if (!paused)
 			{
-				historyMap[t.name].push_back(t.timeInMs);
+				historyMap[t.id].push_back(t.timeInMs);
 
 				// Optional: Limit the history size to keep the last N samples
-				if (historyMap[t.name].size() > 100)
+				if (historyMap[t.id].size() > 100)
 				{ // keep last 100 entries
-					historyMap[t.name].erase(historyMap[t.name].begin());
+					historyMap[t.id].erase(historyMap[t.id].begin());
 				}
 			}
 
-			const std::string& name = t.name;
-			std::vector<float>& values = historyMap[t.name];
+			const char* name = t.name;
+			std::vector<float>& values = historyMap[t.id];
 
 			if (!values.empty())
 			{
@@ -77,7 +77,7 @@ void GpuMarkerVisualizer::Draw()
 
 				// Plot the line graph for this entry
 				ImGui::PlotLines(
-					name.c_str(), values.data(), values.size(), 0, NULL, 0, m_ColorSensitivityClamp, ImVec2(0, 120));
+					name, values.data(), values.size(), 0, NULL, 0, m_ColorSensitivityClamp, ImVec2(0, 120));
 
 				// Pop the color style
 				ImGui::PopStyleColor();
@@ -87,7 +87,7 @@ void GpuMarkerVisualizer::Draw()
 
 	for (auto& t : renderer.m_Data)
 	{
-		// ImGui::Text("%s: %f", t.name.c_str(), t.timeInMs);
+		// ImGui::Text("%s: %f", t.name, t.timeInMs);
 
 		ImVec4 color = GetColorFromValue(t.timeInMs, m_ColorSensitivityClamp);
 
@@ -95,7 +95,7 @@ void GpuMarkerVisualizer::Draw()
 		ImGui::PushStyleColor(ImGuiCol_Text, color);
 
 		// Display the text
-		ImGui::Text("%s: %f ms", t.name.c_str(), t.timeInMs);
+		ImGui::Text("%s: %f ms", t.name, t.timeInMs);
 
 		// Pop the color style to reset it
 		ImGui::PopStyleColor();
@@ -164,14 +164,15 @@ void InputViewTool::DrawInputBindings()
 
 	if (ImGui::TreeNode("Actions"))
 	{
-		for (auto& actionPair : input.m_Actions)
+		for (size_t actionIndex = 0; actionIndex < input.m_Actions.size(); actionIndex++)
 		{
-			if (ImGui::TreeNode((actionPair.first).c_str()))
+			auto& action = input.m_Actions[actionIndex];
+			if (ImGui::TreeNode(action.m_Name.c_str()))
 			{
 				ImGui::Indent(1);
-				auto& action = actionPair.second;
 
-				ImGui::Text("State: %s", Ball::Utilities::ToString(input.GetActionRaw(actionPair.first)));
+				const ActionId actionId = {static_cast<uint32_t>(actionIndex)};
+				ImGui::Text("State: %s", Ball::Utilities::ToString(input.GetActionRaw(actionId)));
 
 				ImGui::Spacing();
 
@@ -182,7 +183,7 @@ void InputViewTool::DrawInputBindings()
 				{
 					ImGui::SameLine();
 
-					DrawRebindableButton(action.m_Keys[i], actionPair.first.c_str());
+					DrawRebindableButton(action.m_Keys[i], action.m_Name.c_str());
 
 					if (i + 1 >= action.m_BoundKeyCount)
 					{
@@ -211,12 +212,11 @@ void InputViewTool::DrawInputBindings()
 
 	if (ImGui::TreeNode("Axes"))
 	{
-		for (auto& axisPair : input.m_Axes)
+		for (size_t axisIndex = 0; axisIndex < input.m_Axes.size(); axisIndex++)
 		{
-			if (ImGui::TreeNode((axisPair.first).c_str()))
+			auto& Axis = input.m_Axes[axisIndex];
+			if (ImGui::TreeNode(Axis.m_Name.c_str()))
 			{
-				auto& Axis = axisPair.second;
-
 				ImGui::BeginGroup();
 				ImGui::Text("Bound keys:");
 
@@ -251,9 +251,9 @@ void InputViewTool::DrawInputBindings()
 					ImGui::EndPopup();
 				}
 
-				ImGui::Text("Value: %f", input.GetAxis(axisPair.first));
-				ImGui::InputFloat(("Deadzone##" + axisPair.first).c_str(), &Axis.m_Deadzone);
-				ImGui::InputFloat(("Magnitude##" + axisPair.first).c_str(), &Axis.m_Magnitude);
+				ImGui::Text("Value: %f", input.GetAxis(AxisId{static_cast<uint32_t>(axisIndex)}));
+				ImGui::InputFloat(("Deadzone##" + Axis.m_Name).c_str(), &Axis.m_Deadzone);
+				ImGui::InputFloat(("Magnitude##" + Axis.m_Name).c_str(), &Axis.m_Magnitude);
 
 				ImGui::TreePop();
 			}
@@ -279,15 +279,16 @@ void InputViewTool::DrawRawKeyState()
 
 		ImGui::Checkbox("ShowActive only", &showActiveOnly);
 
-		for (const auto& keyCodeNameLookup : input.m_AxisValues)
+		for (unsigned int stick = JoyStick::LEFTX; stick < NUM_JOYSTICKS; stick++)
 		{
+			const float value = input.m_AxisValues[stick];
 			if (showActiveOnly)
-				if (keyCodeNameLookup.second == 0.f)
+				if (value == 0.f)
 					continue;
 
-			ImGui::Text("%s: ", Utilities::ToString(keyCodeNameLookup.first));
+			ImGui::Text("%s: ", Utilities::ToString(static_cast<JoyStick>(stick)));
 			ImGui::SameLine();
-			ImGui::Text("%f", keyCodeNameLookup.second);
+			ImGui::Text("%f", value);
 		}
 
 		ImGui::TreePop();
@@ -299,21 +300,26 @@ void InputViewTool::DrawRawKeyState()
 
 		ImGui::Checkbox("ShowActive only", &showActiveOnly);
 
-		for (const auto& keyCodeNameLookup : input.m_KeyStates)
+		for (unsigned int key = 0; key < NUM_KEY_CODES; key++)
 		{
+			if (!input.m_KnownKeys[key])
+				continue;
+
+			const KeyCode keyCode = static_cast<KeyCode>(key);
+			const KeyState keyState = input.m_KeyStates[key];
 			if (showActiveOnly)
-				if (keyCodeNameLookup.second == KeyState::NONE)
+				if (keyState == KeyState::NONE)
 					continue;
 
-			ImGui::Text("%s", Utilities::ToString(keyCodeNameLookup.first));
+			ImGui::Text("%s", Utilities::ToString(keyCode));
 			ImGui::SameLine();
-			ImGui::TextDisabled("%s", Ball::Utilities::ToString(keyCodeNameLookup.second));
+			ImGui::TextDisabled("%s", Ball::Utilities::ToString(keyState));
 
 			if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
 			{
-				if (keyHistory.key != keyCodeNameLookup.first || keyHistory.key == KeyCode::NONE)
+				if (keyHistory.key != keyCode || keyHistory.key == KeyCode::NONE)
 				{
-					keyHistory.key = keyCodeNameLookup.first;
+					keyHistory.key = keyCode;
 					keyHistory.history.clear();
 				}
 				else
@@ -323,11 +329,11 @@ void InputViewTool::DrawRawKeyState()
 						if (keyHistory.history.size() > 0)
 						{
 							auto last = keyHistory.history[keyHistory.history.size() - 1];
-							if (last == keyCodeNameLookup.second)
+							if (last == keyState)
 								continue;
 						}
 
-						keyHistory.history.emplace_back(keyCodeNameLookup.second);
+						keyHistory.history.emplace_back(keyState);
 					} while (false);
 				}
 
@@ -0,0 +1,102 @@
+#include "Tools/MemoryBudgetViewer.h"
+
+#include <algorithm>
+
+#include "imgui.h"
+#include "Rendering/MemoryTracker.h"
+
+using namespace Ball;
+
+namespace
+{
+	constexpr float BYTES_TO_MB = 1.0f / (1024.0f * 1024.0f);
+}
+
+void MemoryBudgetViewer::Init()
+{
+	m_Open = false;
+	m_Name = "Memory Budget Viewer";
+	m_ToolCatagory = ToolCatagory::RESOURCES;
+	m_ToolInterfaceType = ToolInterfaceType::WINDOW;
+}
+
+void MemoryBudgetViewer::Update()
+{
+	const float totalMB = GetMemoryTracker().GetStats(MemoryTag::TOTAL).m_LiveBytes * BYTES_TO_MB;
+	if (m_TotalHistoryMB.size() >= HISTORY_SIZE)
+		m_TotalHistoryMB.erase(m_TotalHistoryMB.begin());
+	m_TotalHistoryMB.push_back(totalMB);
+}
+
+void MemoryBudgetViewer::Draw()
+{
+	ImGui::Begin(m_Name.c_str(), &m_Open);
+	MemoryTracker& tracker = GetMemoryTracker();
+
+	if (!m_TotalHistoryMB.empty())
+	{
+		const float maxMB = *std::max_element(m_TotalHistoryMB.begin(), m_TotalHistoryMB.end());
+		const std::string overlay = std::to_string(static_cast<int>(m_TotalHistoryMB.back())) + " MB";
+		ImGui::PlotLines("Total",
+						 m_TotalHistoryMB.data(),
+						 static_cast<int>(m_TotalHistoryMB.size()),
+						 0,
+						 overlay.c_str(),
+						 0.0f,
+						 std::max(maxMB * 1.1f, 1.0f),
+						 ImVec2(0, 80));
+	}
+
+	ImGui::Columns(6, "MemoryTags");
+	ImGui::Text("Tag");
+	ImGui::NextColumn();
+	ImGui::Text("Live (MB)");
+	ImGui::NextColumn();
+	ImGui::Text("Peak (MB)");
+	ImGui::NextColumn();
+	ImGui::Text("Frame delta (MB)");
+	ImGui::NextColumn();
+	ImGui::Text("Allocations");
+	ImGui::NextColumn();
+	ImGui::Text("Budget (MB, 0 = none)");
+	ImGui::NextColumn();
+	ImGui::Separator();
+
+	for (size_t i = 0; i <= static_cast<size_t>(MemoryTag::NUM_TAGS); i++)
+	{
+		const MemoryTag tag = static_cast<MemoryTag>(i);
+		const MemoryTagStats stats = tracker.GetStats(tag);
+		const bool overBudget = stats.m_BudgetBytes > 0 && stats.m_LiveBytes > stats.m_BudgetBytes;
+
+		if (overBudget)
+			ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.3f, 0.3f, 1.0f));
+
+		ImGui::Text("%s", MemoryTracker::GetTagName(tag));
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", stats.m_LiveBytes * BYTES_TO_MB);
+		ImGui::NextColumn();
+		ImGui::Text("%.2f", stats.m_PeakBytes * BYTES_TO_MB);
+		ImGui::NextColumn();
+		ImGui::Text("%+.2f", stats.m_FrameDeltaBytes * BYTES_TO_MB);
+		ImGui::NextColumn();
+		ImGui::Text("%u", stats.m_NumAllocations);
+		ImGui::NextColumn();
+
+		if (overBudget)
+			ImGui::PopStyleColor();
+
+		int budgetMB = static_cast<int>(stats.m_BudgetBytes / (1024 * 1024));
+		ImGui::PushID(static_cast<int>(i));
+		if (ImGui::InputInt("##Budget", &budgetMB, 16, 256))
+			tracker.SetBudget(tag, static_cast<uint64_t>(std::max(budgetMB, 0)) * 1024 * 1024);
+		ImGui::PopID();
+		ImGui::NextColumn();
+	}
+
+	ImGui::Columns(1);
+	ImGui::Separator();
+	if (ImGui::Button("Log report"))
+		tracker.LogReport();
+
+	ImGui::End();
+}
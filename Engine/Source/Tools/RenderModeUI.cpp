@@ -2,6 +2,7 @@
 #include "Engine.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/Denoiser.h"
+#include "Rendering/FrameScheduler.h"
 #include "Rendering/ModelLoading/ModelManager.h"
 #include "Utilities/LaunchParameters.h"
 #include "Utilities/RenderUtilities.h"
@@ -67,9 +68,29 @@ void RenderModeUI::Draw()
 	}
 
 	ImGui::DragFloat("Tracing Distance", &renderer.m_TracingDistanceMultiplier, 1.f, 0.01f, 400.f);
+	if (ImGui::DragFloat("Texture LOD Bias", &renderer.m_TextureLODBias, 0.05f, -4.f, 4.f))
+		renderer.m_ShouldClearAccum = true;
+	if (ImGui::Checkbox("Environment Importance Sampling", &renderer.m_EnvironmentSampling))
+		renderer.m_ShouldClearAccum = true;
 
 	ImGui::Checkbox("Denoising", &renderer.m_DenoisingEnabled);
 
+	if (ImGui::CollapsingHeader("Frame Pacing:"))
+	{
+		FrameScheduler& scheduler = renderer.GetFrameScheduler();
+		int framesInFlight = static_cast<int>(scheduler.GetFramesInFlight());
+		const int maxFramesInFlight = static_cast<int>(FrameScheduler::MAX_FRAMES_IN_FLIGHT);
+		if (ImGui::SliderInt("Frames In Flight", &framesInFlight, 1, maxFramesInFlight))
+			scheduler.SetFramesInFlight(static_cast<uint32_t>(framesInFlight));
+
+		const FrameSchedulerStats& stats = scheduler.GetStats();
+		ImGui::Text("GPU waits: %llu of %llu frames",
+					static_cast<unsigned long long>(stats.m_Waits),
+					static_cast<unsigned long long>(stats.m_Frames));
+		ImGui::Text("Last wait: %.3f ms", stats.m_LastWaitMs);
+		ImGui::Text("Pending deletions: %zu", scheduler.GetPendingDeletions());
+	}
+
 	if (ImGui::CollapsingHeader("Accumulation:"))
 	{
 		ImGui::Checkbox("Stationary Accumulation", &renderer.m_StationaryCamAccumEnabled);
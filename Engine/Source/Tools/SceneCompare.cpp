@@ -8,6 +8,7 @@
 #include "FileIO.h"
 
 #include <External/nlohmann/json.hpp>
+#include <algorithm>
 
 #include "Utilities/LaunchParameters.h"
 #include "Rendering/Renderer.h"
@@ -16,11 +17,16 @@
 
 using namespace Ball;
 
+// Screenshots are done a few frames after the request, a capture that takes this long is never going to complete
+constexpr uint32_t CAPTURE_TIMEOUT_FRAMES = 600;
+
 void SceneCompare::Init()
 {
 	m_Name = "Scene Compare";
 	m_ToolCatagory = ToolCatagory::GRAPHICS;
 	m_ToolInterfaceType = ToolInterfaceType::WINDOW;
+	// Batches run from the command line without the overlay
+	m_UpdateWithoutOverlay = true;
 
 	if (LaunchParameters::Contains("SceneCompare"))
 	{
@@ -28,6 +34,13 @@ void SceneCompare::Init()
 		m_Open = true;
 		m_StateFileName = LaunchParameters::GetString("SceneCompare", "DefaultState.json");
 	}
+
+	if (LaunchParameters::Contains("SceneCompareBatch"))
+	{
+		m_Open = true;
+		m_ExitAfterBatch = true;
+		StartBatch(LaunchParameters::GetString("SceneCompareBatch", m_BatchDirectory));
+	}
 }
 
 void SceneCompare::Draw()
@@ -62,43 +75,17 @@ void SceneCompare::Draw()
 	{
 		m_LoadOnStart = false;
 
-		if (FileIO::Exist(FileIO::DirectoryType::TempData, m_StateFileName))
-		{
-			std::string readData = FileIO::Read(FileIO::DirectoryType::TempData, m_StateFileName);
-			nlohmann::json data = nlohmann::json::parse(readData);
+		LoadState(m_StateFileName);
+	}
 
-			// Check if parsed data is empty
-			if (!data.empty())
-			{
-				// Load camera position
-				if (data.contains("CameraPosition"))
-				{
-					glm::vec3 newPosition = {0, 0, 0};
-					newPosition.x = data.at("CameraPosition").at(0);
-					newPosition.y = data.at("CameraPosition").at(1);
-					newPosition.z = data.at("CameraPosition").at(2);
-					camera->GetTransform().SetPosition(newPosition);
-				}
-
-				// Load camera rotation
-				if (data.contains("CameraRotation"))
-				{
-					glm::vec3 newRotation = {0, 0, 0};
-					newRotation.x = data.at("CameraRotation").at(0);
-					newRotation.y = data.at("CameraRotation").at(1);
-					newRotation.z = data.at("CameraRotation").at(2);
-					camera->GetTransform().SetRotation(newRotation);
-				}
-
-				// Load rendering mode
-				if (data.contains("RenderingMode"))
-				{
-					renderer.m_RenderMode = static_cast<RenderModes>(data.at("RenderingMode"));
-				}
-
-				LOG(LOG_LOGGING, "SceneCompare: Loaded state [%s]", m_StateFileName.c_str());
-			}
-		}
+	ImGui::InputText("Batch directory", &m_BatchDirectory);
+	ImGui::SameLine();
+	if (ImGui::Button("Run batch") && m_BatchStep == BatchStep::NONE)
+		StartBatch(m_BatchDirectory);
+
+	if (m_BatchStep != BatchStep::NONE)
+	{
+		ImGui::Text("Batch: scene %zu of %zu, %u failed", m_BatchIndex + 1, m_BatchStates.size(), m_FailedScenes);
 	}
 
 	// Display camera position
@@ -140,8 +127,278 @@ void SceneCompare::Draw()
 
 void SceneCompare::Update()
 {
+	switch (m_BatchStep)
+	{
+	case BatchStep::LOAD_STATE:
+	{
+		if (m_BatchIndex >= m_BatchStates.size())
+		{
+			FinishBatch();
+			return;
+		}
+
+		const nlohmann::json data = LoadState(m_BatchDirectory + "/" + m_BatchStates[m_BatchIndex]);
+		if (data.empty())
+		{
+			m_BatchResults["scenes"].push_back({{"name", GetSceneName()}, {"status", "error"}});
+			m_FailedScenes++;
+			m_BatchIndex++;
+			return;
+		}
+
+		m_FramesToAccumulate = data.value("AccumulatedFrames", LaunchParameters::GetInt("SceneCompareFrames", 64));
+		m_Thresholds = ImageCompareThresholds{};
+		if (data.contains("Thresholds"))
+		{
+			const nlohmann::json& thresholds = data.at("Thresholds");
+			m_Thresholds.m_MaxRMSE = thresholds.value("MaxRMSE", m_Thresholds.m_MaxRMSE);
+			m_Thresholds.m_MinSSIM = thresholds.value("MinSSIM", m_Thresholds.m_MinSSIM);
+			m_Thresholds.m_MaxFlip = thresholds.value("MaxFlip", m_Thresholds.m_MaxFlip);
+		}
+
+		// Moving the camera resets the accumulation, counting starts from the frame after the state is applied
+		m_FramesAccumulated = 0;
+		m_BatchStep = BatchStep::ACCUMULATE;
+		break;
+	}
+	case BatchStep::ACCUMULATE:
+		if (++m_FramesAccumulated <= m_FramesToAccumulate)
+			return;
+
+		m_CaptureDone = false;
+		m_CaptureWaitFrames = 0;
+		m_BatchStep = BatchStep::WAIT_FOR_CAPTURE;
+		GetEngine().GetRenderer().TakeScreenshot(FileIO::GetPath(FileIO::DirectoryType::TempData, GetCapturePath()),
+												 [this, capture = ++m_CaptureIndex]()
+												 {
+													 if (capture == m_CaptureIndex)
+														 m_CaptureDone = true;
+												 });
+		break;
+	case BatchStep::WAIT_FOR_CAPTURE:
+		if (m_CaptureDone)
+		{
+			CompareBatchCapture();
+		}
+		else
+		{
+			if (++m_CaptureWaitFrames < CAPTURE_TIMEOUT_FRAMES)
+				return;
+
+			ERROR(LOG_GRAPHICS, "SceneCompare: Capture of [%s] timed out", GetSceneName().c_str());
+			m_BatchResults["scenes"].push_back({{"name", GetSceneName()}, {"status", "error"}});
+			m_FailedScenes++;
+		}
+		m_BatchIndex++;
+		m_BatchStep = BatchStep::LOAD_STATE;
+		break;
+	default:
+		break;
+	}
 }
 
 void SceneCompare::Event()
 {
-}
\ No newline at end of file
+}
+nlohmann::json SceneCompare::LoadState(const std::string& fileName)
+{
+	RenderAPI& renderer = GetEngine().GetRenderer();
+	Camera* camera = Ball::Camera::GetActiveCamera();
+
+	if (camera == nullptr || !FileIO::Exist(FileIO::DirectoryType::TempData, fileName))
+	{
+		WARN(LOG_GRAPHICS, "SceneCompare: Can't load state [%s]", fileName.c_str());
+		return nlohmann::json::object();
+	}
+
+	std::string readData = FileIO::Read(FileIO::DirectoryType::TempData, fileName);
+	nlohmann::json data = nlohmann::json::parse(readData, nullptr, false);
+
+	// Check if parsed data is empty
+	if (data.is_discarded() || data.empty())
+		return nlohmann::json::object();
+
+	// Load camera position
+	if (data.contains("CameraPosition"))
+	{
+		glm::vec3 newPosition = {0, 0, 0};
+		newPosition.x = data.at("CameraPosition").at(0);
+		newPosition.y = data.at("CameraPosition").at(1);
+		newPosition.z = data.at("CameraPosition").at(2);
+		camera->GetTransform().SetPosition(newPosition);
+	}
+
+	// Load camera rotation
+	if (data.contains("CameraRotation"))
+	{
+		glm::vec3 newRotation = {0, 0, 0};
+		newRotation.x = data.at("CameraRotation").at(0);
+		newRotation.y = data.at("CameraRotation").at(1);
+		newRotation.z = data.at("CameraRotation").at(2);
+		camera->GetTransform().SetRotation(newRotation);
+	}
+
+	// Load rendering mode
+	if (data.contains("RenderingMode"))
+	{
+		renderer.m_RenderMode = static_cast<RenderModes>(data.at("RenderingMode"));
+	}
+
+	LOG(LOG_LOGGING, "SceneCompare: Loaded state [%s]", fileName.c_str());
+	return data;
+}
+
+void SceneCompare::StartBatch(const std::string& directory)
+{
+	m_BatchDirectory = directory;
+	m_BatchStates.clear();
+	m_BatchIndex = 0;
+	m_FailedScenes = 0;
+	m_BatchResults = {{"directory", directory}, {"scenes", nlohmann::json::array()}};
+
+	// Nothing is rendered in headless runs, so there is nothing to capture
+	if (LaunchParameters::Contains("Headless"))
+	{
+		ERROR(LOG_GRAPHICS, "SceneCompare: Batches need the renderer, they can't run with -Headless");
+		m_FailedScenes = 1;
+		FinishBatch();
+		return;
+	}
+
+	if (FileIO::Exist(FileIO::DirectoryType::TempData, directory))
+		m_BatchStates = FileIO::GetDirectoryContent(FileIO::DirectoryType::TempData, directory, ".json");
+	std::sort(m_BatchStates.begin(), m_BatchStates.end());
+
+	if (m_BatchStates.empty())
+	{
+		ERROR(LOG_GRAPHICS, "SceneCompare: No state files in [%s]", directory.c_str());
+		m_FailedScenes = 1;
+		FinishBatch();
+		return;
+	}
+
+	// Also creates the Results directory, the screenshot is written without FileIO
+	WriteBatchSummary();
+
+	INFO(LOG_GRAPHICS, "SceneCompare: Comparing %zu scenes in [%s]", m_BatchStates.size(), directory.c_str());
+	m_BatchStep = BatchStep::LOAD_STATE;
+}
+
+void SceneCompare::CompareBatchCapture()
+{
+	const std::string sceneName = GetSceneName();
+	const std::string capturePath = GetCapturePath();
+	const std::string referencePath = m_BatchDirectory + "/References/" + sceneName + ".png";
+	const std::string diffPath = m_BatchDirectory + "/Results/" + sceneName + "_diff.png";
+
+	nlohmann::json scene = {{"name", sceneName},
+							{"thresholds",
+							 {{"MaxRMSE", m_Thresholds.m_MaxRMSE},
+							  {"MinSSIM", m_Thresholds.m_MinSSIM},
+							  {"MaxFlip", m_Thresholds.m_MaxFlip}}}};
+
+	const CompareImage capture = CompareImage::Load(FileIO::GetPath(FileIO::DirectoryType::TempData, capturePath));
+	if (!capture.IsValid())
+	{
+		ERROR(LOG_GRAPHICS, "SceneCompare: Capture of [%s] is missing", sceneName.c_str());
+		scene["status"] = "error";
+		m_FailedScenes++;
+	}
+	else if (!FileIO::Exist(FileIO::DirectoryType::TempData, referencePath))
+	{
+		// The first run of a new scene becomes its reference
+		std::vector<char> data(FileIO::GetSize(FileIO::DirectoryType::TempData, capturePath));
+		FileIO::ReadBinary(FileIO::DirectoryType::TempData, capturePath, data.data(), data.size());
+		FileIO::WriteBinary(FileIO::DirectoryType::TempData, referencePath, data.data(), data.size());
+
+		WARN(LOG_GRAPHICS, "SceneCompare: No reference for [%s], saved the capture as reference", sceneName.c_str());
+		scene["status"] = "created";
+	}
+	else
+	{
+		const CompareImage reference =
+			CompareImage::Load(FileIO::GetPath(FileIO::DirectoryType::TempData, referencePath));
+
+		ImageCompareResult result;
+		if (!CompareImages(reference, capture, result))
+		{
+			ERROR(LOG_GRAPHICS,
+				  "SceneCompare: [%s] is %ux%u, the reference is %ux%u",
+				  sceneName.c_str(),
+				  capture.m_Width,
+				  capture.m_Height,
+				  reference.m_Width,
+				  reference.m_Height);
+			scene["status"] = "error";
+			m_FailedScenes++;
+		}
+		else
+		{
+			const bool passed = result.Passes(m_Thresholds);
+			if (!passed)
+				m_FailedScenes++;
+
+			CreateHeatmap(result.m_ErrorMap, capture.m_Width, capture.m_Height)
+				.SavePNG(FileIO::GetPath(FileIO::DirectoryType::TempData, diffPath));
+
+			scene["status"] = passed ? "passed" : "failed";
+			scene["rmse"] = result.m_RMSE;
+			scene["ssim"] = result.m_SSIM;
+			scene["flip"] = result.m_Flip;
+
+			if (passed)
+			{
+				INFO(LOG_GRAPHICS,
+					 "SceneCompare: [%s] passed, RMSE %f, SSIM %f, FLIP %f",
+					 sceneName.c_str(),
+					 result.m_RMSE,
+					 result.m_SSIM,
+					 result.m_Flip);
+			}
+			else
+			{
+				ERROR(LOG_GRAPHICS,
+					  "SceneCompare: [%s] failed, RMSE %f, SSIM %f, FLIP %f",
+					  sceneName.c_str(),
+					  result.m_RMSE,
+					  result.m_SSIM,
+					  result.m_Flip);
+			}
+		}
+	}
+
+	m_BatchResults["scenes"].push_back(scene);
+
+	// Written after every scene, so a crash still leaves the results up to that point
+	WriteBatchSummary();
+}
+
+void SceneCompare::FinishBatch()
+{
+	m_BatchStep = BatchStep::NONE;
+	m_BatchResults["failed"] = m_FailedScenes;
+	if (!m_BatchStates.empty())
+		WriteBatchSummary();
+
+	INFO(LOG_GRAPHICS, "SceneCompare: Batch finished, %u of %zu scenes failed", m_FailedScenes, m_BatchStates.size());
+
+	if (m_ExitAfterBatch)
+		GetEngine().RequestExit(m_FailedScenes > 0 ? 1 : 0);
+}
+
+std::string SceneCompare::GetSceneName() const
+{
+	// The state file without its extension
+	const std::string& stateFile = m_BatchStates[m_BatchIndex];
+	return stateFile.substr(0, stateFile.find_last_of('.'));
+}
+
+std::string SceneCompare::GetCapturePath() const
+{
+	return m_BatchDirectory + "/Results/" + GetSceneName() + ".png";
+}
+
+void SceneCompare::WriteBatchSummary() const
+{
+	FileIO::Write(FileIO::DirectoryType::TempData, m_BatchDirectory + "/Results/Summary.json", m_BatchResults.dump(4));
+}
@@ -23,6 +23,7 @@
 
 #include "Tools/BufferVisualizer.h"
 #include "Tools/TextureVisualizer.h"
+#include "Tools/MemoryBudgetViewer.h"
 
 using namespace Ball;
 
@@ -30,10 +31,7 @@ using namespace Ball;
 
 void ToolManager::Init()
 {
-#ifdef NO_IMGUI
-	return;
-#endif
-
+	// Tools are registered in every build, some of them do work in Update that doesn't depend on ImGui
 	m_Tools.clear();
 	REGISTER_TOOL(BindlessHeapViewer);
 	REGISTER_TOOL(CameraSettings);
@@ -48,6 +46,7 @@ void ToolManager::Init()
 	REGISTER_TOOL(InputViewTool);
 	REGISTER_TOOL(BufferVisualizer);
 	REGISTER_TOOL(TextureVisualizer);
+	REGISTER_TOOL(MemoryBudgetViewer);
 
 	std::string source = Ball::LaunchParameters::GetString("OpenTools", "");
 	if (!source.empty())
@@ -64,12 +63,22 @@ void ToolManager::Init()
 
 void Ball::ToolManager::Shutdown()
 {
-#ifndef NO_IMGUI
 	for (size_t i = 0; i < m_Tools.size(); i++)
 	{
 		delete m_Tools[i];
 	}
-#endif // !NO_IMGUI
+	m_Tools.clear();
+	m_ToolLookup.clear();
+}
+
+void ToolManager::Update()
+{
+	// Ticked from the engine loop so these keep working when the overlay isn't drawn (headless, hidden or NO_IMGUI)
+	for (size_t i = 0; i < m_Tools.size(); i++)
+	{
+		if (m_Tools[i]->UpdatesWithoutOverlay())
+			m_Tools[i]->Update();
+	}
 }
 
 void ToolManager::CreateToolMenu(const char* menuName, ToolCatagory category) const
@@ -113,7 +122,7 @@ void ToolManager::OnImgui()
 	if (!m_ShowToolManager)
 		return;
 
-	// Drawing the Windows and updatign the tools
+	// Drawing the Windows and updating the tools that aren't updated from the engine loop
 	{
 		if (m_ShowDemoWindow)
 			ImGui::ShowDemoWindow();
@@ -122,7 +131,8 @@ void ToolManager::OnImgui()
 		for (size_t i = 0; i < m_Tools.size(); i++)
 		{
 			ToolBase* tool = m_Tools[i];
-			tool->Update();
+			if (!tool->UpdatesWithoutOverlay())
+				tool->Update();
 			if (tool->IsOpen())
 				tool->Draw();
 		}
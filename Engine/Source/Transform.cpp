@@ -7,8 +7,15 @@
 
 #include "imgui.h"
 
+#include <atomic>
+
 using namespace Ball;
 
+namespace
+{
+	std::atomic<uint32_t> g_NextTransformVersion{1};
+}
+
 Transform::Transform()
 {
 	m_Position = glm::vec3(0, 0, 0);
@@ -19,6 +26,7 @@ Transform::Transform()
 	m_Up = glm::vec3(0, 1, 0);
 	m_ModelMatrix = glm::mat4(1.0f);
 	m_Dirty = false;
+	m_Version = 0;
 }
 
 const glm::mat4& Transform::GetModelMatrix()
@@ -192,6 +200,14 @@ void Transform::UpdateTransform()
 	// - Angel [06/03/24]
 
 	m_Dirty = false;
+	m_Version = g_NextTransformVersion.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t Transform::GetVersion()
+{
+	if (m_Dirty)
+		UpdateTransform();
+	return m_Version;
 }
 
 void Transform::ImGuiForDebugging()
@@ -224,9 +240,7 @@ void Transform::ImGuiForDebugging()
 
 void Transform::Serialize(SerializeArchive& archive)
 {
-	archive.Add(ARCHIVE_VAR(m_Position));
-	archive.Add(ARCHIVE_VAR(m_Rotation));
-	archive.Add(ARCHIVE_VAR(m_Scale));
+	archive.AddFields(*this);
 
 	if (archive.GetArchiveType() == SerializeArchiveType::LOAD_DATA)
 		Dirty();
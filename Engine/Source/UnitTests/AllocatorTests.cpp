@@ -0,0 +1,147 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <list>
+#include <new>
+#include <set>
+#include <thread>
+
+#include "Utilities/AllocationCounter.h"
+#include "Utilities/FrameArena.h"
+#include "Utilities/PoolAllocator.h"
+
+using namespace Ball;
+
+CATCH_TEST_CASE("FrameArena")
+{
+	// Separate arena, the global one is in use by the running engine
+	FrameArena arena(1024);
+
+	CATCH_SECTION("Allocations are aligned and don't overlap")
+	{
+		auto* a = static_cast<uint8_t*>(arena.Allocate(3, 1));
+		auto* b = static_cast<uint8_t*>(arena.Allocate(16, 16));
+		auto* c = static_cast<uint8_t*>(arena.Allocate(8, 8));
+
+		CATCH_CHECK(reinterpret_cast<uintptr_t>(b) % 16 == 0);
+		CATCH_CHECK(reinterpret_cast<uintptr_t>(c) % 8 == 0);
+		CATCH_CHECK(b >= a + 3);
+		CATCH_CHECK(c >= b + 16);
+		CATCH_CHECK(arena.Owns(a));
+		CATCH_CHECK(arena.GetNumOverflows() == 0);
+	}
+
+	CATCH_SECTION("Memory stays valid for one more frame")
+	{
+		auto* first = static_cast<uint32_t*>(arena.Allocate(sizeof(uint32_t)));
+		*first = 1234;
+
+		arena.BeginFrame();
+		CATCH_CHECK(arena.GetUsedBytes() == 0);
+		auto* second = static_cast<uint32_t*>(arena.Allocate(sizeof(uint32_t)));
+		*second = 5678;
+		CATCH_CHECK(*first == 1234);
+
+		// Two frames later the first half is reused
+		arena.BeginFrame();
+		CATCH_CHECK(arena.Allocate(sizeof(uint32_t)) == first);
+		CATCH_CHECK(*second == 5678);
+	}
+
+	CATCH_SECTION("Falls back to the heap when full")
+	{
+		arena.Allocate(1000);
+		void* overflow = arena.Allocate(100);
+		CATCH_CHECK(!arena.Owns(overflow));
+		CATCH_CHECK(arena.GetNumOverflows() == 1);
+		arena.Deallocate(overflow);
+	}
+
+	CATCH_SECTION("FrameVector")
+	{
+		FrameVector<int> values{FrameAllocator<int>(arena)};
+		for (int i = 0; i < 100; i++)
+			values.push_back(i);
+
+		CATCH_CHECK(values[99] == 99);
+		CATCH_CHECK(arena.Owns(values.data()));
+	}
+}
+
+CATCH_TEST_CASE("PoolAllocator")
+{
+	struct PooledObject
+	{
+		PooledObject(int value) : m_Value(value) {}
+		int m_Value;
+		double m_Padding[5];
+	};
+	using Pool = ObjectPool<PooledObject>::Pool;
+	const uint64_t liveAtStart = Pool::GetStats().m_NumLiveBlocks;
+
+	CATCH_SECTION("Freed blocks are reused")
+	{
+		PooledObject* a = ObjectPool<PooledObject>::New(7);
+		CATCH_CHECK(a->m_Value == 7);
+		CATCH_CHECK(Pool::GetStats().m_NumLiveBlocks == liveAtStart + 1);
+
+		ObjectPool<PooledObject>::Delete(a);
+		PooledObject* b = ObjectPool<PooledObject>::New(8);
+		CATCH_CHECK(b == a);
+		ObjectPool<PooledObject>::Delete(b);
+		CATCH_CHECK(Pool::GetStats().m_NumLiveBlocks == liveAtStart);
+	}
+
+	CATCH_SECTION("Objects can be freed on another thread")
+	{
+		std::vector<PooledObject*> objects;
+		std::thread loader(
+			[&objects]()
+			{
+				for (int i = 0; i < 500; i++)
+					objects.push_back(ObjectPool<PooledObject>::New(i));
+			});
+		loader.join();
+
+		std::set<PooledObject*> unique(objects.begin(), objects.end());
+		CATCH_CHECK(unique.size() == objects.size());
+		CATCH_CHECK(objects[499]->m_Value == 499);
+		CATCH_CHECK(Pool::GetStats().m_NumLiveBlocks == liveAtStart + 500);
+
+		for (PooledObject* object : objects)
+			ObjectPool<PooledObject>::Delete(object);
+		CATCH_CHECK(Pool::GetStats().m_NumLiveBlocks == liveAtStart);
+	}
+
+	CATCH_SECTION("STL node containers")
+	{
+		std::list<int, PoolAllocator<int>> values;
+		for (int i = 0; i < 100; i++)
+			values.push_back(i);
+		values.remove_if([](int value) { return value % 2 == 0; });
+
+		CATCH_CHECK(values.size() == 50);
+		CATCH_CHECK(values.back() == 99);
+	}
+}
+
+CATCH_TEST_CASE("AllocationCounter")
+{
+	if (!AllocationCounter::IsEnabled())
+		return;
+
+	const uint64_t before = AllocationCounter::GetNumAllocations();
+	// Calling operator new directly, new expressions can be optimized away
+	void* memory = ::operator new(sizeof(int));
+	::operator delete(memory, sizeof(int));
+	// Other threads of the engine can allocate at the same time
+	CATCH_CHECK(AllocationCounter::GetNumAllocations() >= before + 1);
+	CATCH_CHECK(AllocationCounter::GetNumAllocatedBytes() >= sizeof(int));
+
+	// Over-aligned types take the std::align_val_t overloads
+	const uint64_t beforeAligned = AllocationCounter::GetNumAllocations();
+	constexpr std::align_val_t ALIGNMENT{256};
+	void* aligned = ::operator new(sizeof(int), ALIGNMENT);
+	CATCH_CHECK(reinterpret_cast<uintptr_t>(aligned) % static_cast<size_t>(ALIGNMENT) == 0);
+	::operator delete(aligned, sizeof(int), ALIGNMENT);
+	CATCH_CHECK(AllocationCounter::GetNumAllocations() >= beforeAligned + 1);
+}
@@ -2,6 +2,8 @@
 #include <../External/FMOD/inc/fmod_studio_common.h>
 #include "AudioSystem.h"
 
+#include <algorithm>
+
 #include <../External/FMOD/inc/fmod_errors.h>
 #include <../External/FMOD/inc/fmod.hpp>
 #include <../External/FMOD/inc/fmod_studio.hpp>
@@ -64,3 +66,229 @@ CATCH_TEST_CASE("Audio unit tests")
 		}
 	}
 }
+
+namespace
+{
+	// Plays nothing, remembers which voices the scheduler started
+	class NullAudioBackend final : public AudioBackend
+	{
+	public:
+		float GetEventLength(AudioEventId event) override
+		{
+			return event.m_Index < m_Lengths.size() ? m_Lengths[event.m_Index] : -1.f;
+		}
+		void StartVoice(const AudioVoice& voice) override
+		{
+			m_Playing.push_back(voice.m_Id);
+			m_StartTimes.push_back(voice.m_Time);
+			m_StartParameters = voice.m_Parameters;
+		}
+		void StopVoice(AudioVoiceId voice, bool) override
+		{
+			m_Playing.erase(std::remove(m_Playing.begin(), m_Playing.end(), voice), m_Playing.end());
+			m_Stops++;
+		}
+		bool IsVoicePlaying(AudioVoiceId voice) override
+		{
+			return std::find(m_Playing.begin(), m_Playing.end(), voice) != m_Playing.end();
+		}
+		void SetVoiceVolume(AudioVoiceId, float) override {}
+		void SetVoicePosition(AudioVoiceId, const glm::vec3&) override {}
+		void SetVoiceParameter(AudioVoiceId, AudioParameterId, float) override { m_ParameterCalls++; }
+		void SetListener(const glm::vec3&, const glm::vec3&, const glm::vec3&) override {}
+
+		std::vector<float> m_Lengths;
+		std::vector<AudioVoiceId> m_Playing;
+		std::vector<float> m_StartTimes;
+		std::vector<std::pair<AudioParameterId, float>> m_StartParameters;
+		uint32_t m_Stops = 0;
+		uint32_t m_ParameterCalls = 0;
+	};
+} // namespace
+
+CATCH_TEST_CASE("Audio voice scheduler")
+{
+	NullAudioBackend backend;
+	AudioVoiceScheduler scheduler;
+	AudioCommandBuffer commands;
+	const AudioEventId footstep = {0};
+	const AudioEventId music = {1};
+
+	auto play = [&](AudioEventId event)
+	{
+		const AudioVoiceId voice = scheduler.ReserveVoice();
+		commands.Play(voice, event, 1.f);
+		return voice;
+	};
+	auto play3D = [&](AudioEventId event, const glm::vec3& position)
+	{
+		const AudioVoiceId voice = scheduler.ReserveVoice();
+		commands.Play3D(voice, event, position, 1.f);
+		return voice;
+	};
+	auto update = [&](float deltaTime)
+	{
+		scheduler.Execute(commands, deltaTime, backend);
+		commands.Clear();
+	};
+
+	CATCH_SECTION("Names are interned to dense ids")
+	{
+		AudioNameTable names;
+		CATCH_CHECK(names.Intern("SFX/PlayerHit") == 0);
+		CATCH_CHECK(names.Intern("Music/TestEvent") == 1);
+		CATCH_CHECK(names.Intern("SFX/PlayerHit") == 0);
+		CATCH_CHECK(names.Find("Music/TestEvent") == 1);
+		CATCH_CHECK(names.Find("Unknown") == UINT32_MAX);
+		CATCH_CHECK(names.GetName(1) == "Music/TestEvent");
+	}
+
+	CATCH_SECTION("Voices past the event limit are virtual")
+	{
+		AudioEventSettings settings;
+		settings.m_MaxRealVoices = 2;
+		scheduler.SetEventSettings(footstep, settings);
+
+		for (int i = 0; i < 5; i++)
+			play(footstep);
+		update(0.016f);
+
+		CATCH_CHECK(backend.m_Playing.size() == 2);
+		CATCH_CHECK(scheduler.GetLastFrameStats().m_RealVoices == 2);
+		CATCH_CHECK(scheduler.GetLastFrameStats().m_VirtualVoices == 3);
+		CATCH_CHECK(scheduler.GetLastFrameStats().m_Commands == 5);
+	}
+
+	CATCH_SECTION("Higher priorities win the global limit")
+	{
+		scheduler.SetMaxRealVoices(2);
+		AudioEventSettings important;
+		important.m_Priority = 10;
+		scheduler.SetEventSettings(music, important);
+
+		play(footstep);
+		play(footstep);
+		update(0.016f);
+		CATCH_CHECK(backend.m_Playing.size() == 2);
+
+		const AudioVoiceId musicVoice = play(music);
+		update(0.016f);
+		CATCH_CHECK(backend.m_Playing.size() == 2);
+		CATCH_CHECK(backend.IsVoicePlaying(musicVoice));
+		CATCH_CHECK(scheduler.GetLastFrameStats().m_VirtualizedVoices == 1);
+		CATCH_CHECK(scheduler.GetLastFrameStats().m_StartedVoices == 1);
+	}
+
+	CATCH_SECTION("Voices out of range are virtual and resume at their time")
+	{
+		AudioEventSettings settings;
+		settings.m_MaxDistance = 10.f;
+		scheduler.SetEventSettings(footstep, settings);
+
+		const AudioVoiceId far = play3D(footstep, glm::vec3(20.f, 0.f, 0.f));
+		const AudioVoiceId near = play3D(footstep, glm::vec3(2.f, 0.f, 0.f));
+		update(0.5f);
+		CATCH_CHECK(!backend.IsVoicePlaying(far));
+		CATCH_CHECK(backend.IsVoicePlaying(near));
+		CATCH_CHECK(scheduler.IsVoiceActive(far));
+
+		commands.SetListener(glm::vec3(18.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 1.f), glm::vec3(0.f, 1.f, 0.f));
+		update(0.5f);
+		CATCH_CHECK(backend.IsVoicePlaying(far));
+		CATCH_CHECK(!backend.IsVoicePlaying(near));
+		CATCH_CHECK(backend.m_StartTimes.back() == Catch::Approx(1.f));
+	}
+
+	CATCH_SECTION("Similar voices don't swap every frame")
+	{
+		scheduler.SetMaxRealVoices(1);
+		const AudioVoiceId first = play3D(footstep, glm::vec3(5.f, 0.f, 0.f));
+		update(0.016f);
+		const AudioVoiceId second = play3D(footstep, glm::vec3(4.9f, 0.f, 0.f));
+		update(0.016f);
+		CATCH_CHECK(backend.IsVoicePlaying(first));
+		CATCH_CHECK(!backend.IsVoicePlaying(second));
+	}
+
+	CATCH_SECTION("Finished voices are freed")
+	{
+		backend.m_Lengths = {1.f};
+		scheduler.SetMaxRealVoices(1);
+
+		// The backend decides when real voices end
+		const AudioVoiceId real = play(footstep);
+		update(0.25f);
+		CATCH_REQUIRE(backend.IsVoicePlaying(real));
+		backend.m_Playing.clear();
+		update(0.25f);
+		CATCH_CHECK(!scheduler.IsVoiceActive(real));
+		CATCH_CHECK(scheduler.GetLastFrameStats().m_FinishedVoices == 1);
+
+		// Virtual voices end after the length of the event
+		const AudioVoiceId playing = play(music);
+		const AudioVoiceId virtualVoice = play(footstep);
+		update(0.5f);
+		CATCH_REQUIRE(backend.IsVoicePlaying(playing));
+		CATCH_CHECK(scheduler.IsVoiceActive(virtualVoice));
+		update(0.5f);
+		CATCH_CHECK(scheduler.GetVoice(virtualVoice) == nullptr);
+		CATCH_CHECK(scheduler.IsVoiceActive(playing));
+	}
+
+	CATCH_SECTION("Stopped voice ids stay invalid when the slot is reused")
+	{
+		const AudioVoiceId voice = play(footstep);
+		update(0.016f);
+		commands.StopVoice(voice, true);
+		update(0.016f);
+		CATCH_CHECK(!scheduler.IsVoiceActive(voice));
+		CATCH_CHECK(backend.m_Stops == 1);
+
+		const AudioVoiceId reused = play(footstep);
+		CATCH_CHECK(reused.m_Index == voice.m_Index);
+		commands.StopVoice(voice, false);
+		update(0.016f);
+		CATCH_CHECK(scheduler.IsVoiceActive(reused));
+
+		play(music);
+		commands.StopEvent(footstep, false);
+		update(0.016f);
+		CATCH_CHECK(!scheduler.IsVoiceActive(reused));
+		CATCH_CHECK(backend.m_Playing.size() == 1);
+	}
+
+	CATCH_SECTION("Invalid events don't play")
+	{
+		const AudioVoiceId voice = play(AudioEventId());
+		update(0.016f);
+		CATCH_CHECK(!scheduler.IsVoiceActive(voice));
+		CATCH_CHECK(scheduler.GetVoice(voice) == nullptr);
+		CATCH_CHECK(backend.m_Playing.empty());
+
+		// The voice slot is free again
+		CATCH_CHECK(play(footstep).m_Index == voice.m_Index);
+	}
+
+	CATCH_SECTION("Parameters of virtual voices are applied when they start")
+	{
+		AudioEventSettings settings;
+		settings.m_MaxDistance = 10.f;
+		scheduler.SetEventSettings(footstep, settings);
+
+		const AudioParameterId surface = {3};
+		const AudioVoiceId voice = play3D(footstep, glm::vec3(20.f, 0.f, 0.f));
+		commands.SetParameter(voice, surface, 1.f);
+		commands.SetParameter(voice, surface, 2.f);
+		update(0.016f);
+		CATCH_CHECK(backend.m_ParameterCalls == 0);
+
+		commands.SetPosition(voice, glm::vec3(1.f, 0.f, 0.f));
+		update(0.016f);
+		CATCH_REQUIRE(backend.m_StartParameters.size() == 1);
+		CATCH_CHECK(backend.m_StartParameters[0].second == 2.f);
+
+		commands.SetParameter(voice, surface, 3.f);
+		update(0.016f);
+		CATCH_CHECK(backend.m_ParameterCalls == 1);
+	}
+}
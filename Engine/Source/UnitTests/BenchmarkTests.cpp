@@ -0,0 +1,122 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include "Utilities/Benchmark.h"
+#include "Utilities/CpuProfiler.h"
+
+using namespace Ball;
+
+CATCH_TEST_CASE("Benchmark")
+{
+	CATCH_SECTION("Percentiles use the nearest rank")
+	{
+		std::vector<float> samples;
+		for (int i = 100; i >= 1; i--)
+			samples.push_back(static_cast<float>(i));
+
+		const BenchmarkStatistics statistics = BenchmarkStatistics::Calculate(samples);
+		CATCH_CHECK(statistics.m_Min == 1.f);
+		CATCH_CHECK(statistics.m_Max == 100.f);
+		CATCH_CHECK(statistics.m_Mean == 50.5f);
+		CATCH_CHECK(statistics.m_P50 == 50.f);
+		CATCH_CHECK(statistics.m_P90 == 90.f);
+		CATCH_CHECK(statistics.m_P95 == 95.f);
+		CATCH_CHECK(statistics.m_P99 == 99.f);
+
+		const BenchmarkStatistics single = BenchmarkStatistics::Calculate({3.f});
+		CATCH_CHECK(single.m_P50 == 3.f);
+		CATCH_CHECK(single.m_P99 == 3.f);
+		CATCH_CHECK(BenchmarkStatistics::Calculate({}).m_Max == 0.f);
+	}
+
+	CATCH_SECTION("Warm-up frames are skipped and missing samples count as 0")
+	{
+		BenchmarkSettings settings;
+		settings.m_WarmupFrames = 2;
+		settings.m_MeasuredFrames = 4;
+		BenchmarkRunner runner(settings);
+
+		for (int frame = 0; frame < 6; frame++)
+		{
+			CATCH_CHECK(runner.IsWarmingUp() == (frame < 2));
+			runner.AddSample("frame", "time", frame < 2 ? 1000.f : 10.f);
+
+			// Only entered in the last two frames, twice per frame
+			if (frame >= 4)
+			{
+				runner.AddSample("cpu", "Animations", 1.f);
+				runner.AddSample("cpu", "Animations", 2.f);
+			}
+			runner.EndFrame();
+		}
+		CATCH_CHECK(runner.IsFinished());
+
+		CATCH_CHECK(runner.GetStatistics("frame", "time").m_Max == 10.f);
+		const BenchmarkStatistics animations = runner.GetStatistics("cpu", "Animations");
+		CATCH_CHECK(animations.m_Min == 0.f);
+		CATCH_CHECK(animations.m_Max == 3.f);
+		CATCH_CHECK(animations.m_Mean == 1.5f);
+
+		runner.SetValue("memoryPeakBytes", "Total", 1024.0);
+		const nlohmann::json json = runner.ToJson();
+		CATCH_CHECK(json["measuredFrames"] == 4);
+		CATCH_CHECK(json["metrics"]["cpu"]["Animations"]["p95"] == 3.f);
+		CATCH_CHECK(json["values"]["memoryPeakBytes"]["Total"] == 1024.0);
+	}
+
+	CATCH_SECTION("Regressions against a baseline")
+	{
+		const auto makeResults = [](float frameTime, float zoneTime, double memoryPeak)
+		{
+			BenchmarkSettings settings;
+			settings.m_WarmupFrames = 0;
+			settings.m_MeasuredFrames = 10;
+			BenchmarkRunner runner(settings);
+			for (int frame = 0; frame < 10; frame++)
+			{
+				runner.AddSample("frame", "time", frameTime);
+				runner.AddSample("cpu", "Tiny", zoneTime);
+				runner.EndFrame();
+			}
+			runner.SetValue("memoryPeakBytes", "Total", memoryPeak);
+			return runner.ToJson();
+		};
+
+		const nlohmann::json baseline = makeResults(10.f, 0.01f, 1000.0);
+		CATCH_CHECK(BenchmarkRunner::Compare(baseline, makeResults(10.5f, 0.01f, 1000.0), 0.1f).empty());
+
+		// The tiny zone tripled, but it's below the minimum difference
+		const auto regressions = BenchmarkRunner::Compare(baseline, makeResults(12.f, 0.03f, 2000.0), 0.1f);
+		CATCH_REQUIRE(regressions.size() == 3);
+		CATCH_CHECK(regressions[0].m_Metric == "frame/time/p50");
+		CATCH_CHECK(regressions[1].m_Metric == "frame/time/p95");
+		CATCH_CHECK(regressions[2].m_Metric == "memoryPeakBytes/Total");
+		CATCH_CHECK(regressions[2].m_Current == 2000.0);
+
+		// Getting faster or dropping a metric isn't a regression
+		nlohmann::json faster = makeResults(5.f, 0.01f, 500.0);
+		faster["metrics"].erase("cpu");
+		CATCH_CHECK(BenchmarkRunner::Compare(baseline, faster, 0.f).empty());
+	}
+}
+
+CATCH_TEST_CASE("CpuProfiler")
+{
+	CpuProfiler profiler;
+	profiler.AddZoneTime("Update", 1.f);
+	profiler.AddZoneTime("Render", 2.f);
+
+	// Same name from another string literal
+	const std::string update = "Update";
+	profiler.AddZoneTime(update.c_str(), 0.5f);
+	CATCH_CHECK(profiler.GetLastFrameZones().empty());
+
+	profiler.EndFrame();
+	const auto& zones = profiler.GetLastFrameZones();
+	CATCH_REQUIRE(zones.size() == 2);
+	CATCH_CHECK(std::string(zones[0].m_Name) == "Update");
+	CATCH_CHECK(zones[0].m_TimeInMs == 1.5f);
+	CATCH_CHECK(zones[1].m_TimeInMs == 2.f);
+
+	profiler.EndFrame();
+	CATCH_CHECK(profiler.GetLastFrameZones().empty());
+}
@@ -0,0 +1,364 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Rendering/BlasPolicy.h"
+#include "Rendering/CpuBvh.h"
+#include "ShaderHeaders/RandomGPU.h"
+
+using namespace Ball;
+
+namespace
+{
+	// Small triangles spread over a cube, three vertices each
+	std::vector<glm::vec3> MakeTriangleSoup(uint32_t count, uint32_t seed)
+	{
+		std::vector<glm::vec3> vertices;
+		vertices.reserve(count * 3);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const glm::vec3 center(ShaderRandom::rand(seed), ShaderRandom::rand(seed), ShaderRandom::rand(seed));
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const glm::vec3 offset(ShaderRandom::rand(seed), ShaderRandom::rand(seed), ShaderRandom::rand(seed));
+				vertices.push_back(center * 10.f + (offset - 0.5f) * 0.2f);
+			}
+		}
+		return vertices;
+	}
+
+	bool BoxContains(const AABB& box, const glm::vec3& point)
+	{
+		const float epsilon = 1e-4f;
+		return glm::all(glm::lessThanEqual(box.m_Min - epsilon, point)) &&
+			glm::all(glm::lessThanEqual(point, box.m_Max + epsilon));
+	}
+
+	// Every triangle in exactly one leaf and inside all boxes on the way to it
+	void CheckBvh(const CpuBvh& bvh, const std::vector<glm::vec3>& vertices)
+	{
+		const std::vector<CpuBvh::Node>& nodes = bvh.GetNodes();
+		std::vector<int> seen(vertices.size() / 3, 0);
+		std::vector<uint32_t> stack = {0};
+		while (!stack.empty())
+		{
+			const CpuBvh::Node& node = nodes[stack.back()];
+			stack.pop_back();
+			if (node.IsLeaf())
+			{
+				for (uint32_t i = node.m_First; i < node.m_First + node.m_Count; i++)
+				{
+					const uint32_t triangle = bvh.GetTriangles()[i];
+					seen[triangle]++;
+					for (int corner = 0; corner < 3; corner++)
+						CATCH_CHECK(BoxContains(node.m_Bounds, vertices[triangle * 3 + corner]));
+				}
+				continue;
+			}
+
+			for (uint32_t child = node.m_First; child < node.m_First + 2; child++)
+			{
+				CATCH_CHECK(BoxContains(node.m_Bounds, nodes[child].m_Bounds.m_Min));
+				CATCH_CHECK(BoxContains(node.m_Bounds, nodes[child].m_Bounds.m_Max));
+				stack.push_back(child);
+			}
+		}
+
+		for (int count : seen)
+			CATCH_CHECK(count == 1);
+	}
+
+	BlasPolicySettings MakePolicySettings()
+	{
+		BlasPolicySettings settings;
+		settings.m_FrameBudgetMs = 1.f;
+		settings.m_RebuildThreshold = 1.5f;
+		settings.m_CompactionDelay = 2;
+		settings.m_RefitMsPerMillion = 1.f;
+		settings.m_RebuildMsPerMillion = 10.f;
+		settings.m_CompactMsPerMillion = 1.f;
+		return settings;
+	}
+
+	const BlasTask* FindTask(const std::vector<BlasTask>& tasks, uint32_t id)
+	{
+		for (const BlasTask& task : tasks)
+		{
+			if (task.m_Id == id)
+				return &task;
+		}
+		return nullptr;
+	}
+} // namespace
+
+CATCH_TEST_CASE("CPU BVH build and refit", "[BLAS]")
+{
+	std::vector<glm::vec3> vertices = MakeTriangleSoup(2000, 3);
+	CpuBvh bvh;
+	bvh.Build(vertices);
+	CATCH_REQUIRE(bvh.GetTriangleCount() == 2000);
+	CheckBvh(bvh, vertices);
+	CATCH_CHECK(bvh.Degradation() == Catch::Approx(1.f));
+
+	// A binned SAH tree is far better than intersecting every triangle
+	CATCH_CHECK(bvh.SAHCost() < 2000.f * CpuBvh::INTERSECTION_COST * 0.05f);
+	for (const CpuBvh::Node& node : bvh.GetNodes())
+	{
+		if (node.IsLeaf())
+			CATCH_CHECK(node.m_Count <= CpuBvh::MAX_LEAF_SIZE * 2);
+	}
+
+	CATCH_SECTION("Rigid motion doesn't degrade the tree")
+	{
+		for (glm::vec3& vertex : vertices)
+			vertex = vertex * 3.f + glm::vec3(100.f, -20.f, 5.f);
+		bvh.Refit(vertices);
+		CheckBvh(bvh, vertices);
+		CATCH_CHECK(bvh.Degradation() == Catch::Approx(1.f).epsilon(1e-3));
+	}
+
+	CATCH_SECTION("Scattering the triangles degrades the tree, a rebuild repairs it")
+	{
+		const std::vector<glm::vec3> scattered = MakeTriangleSoup(2000, 77);
+		bvh.Refit(scattered);
+		CheckBvh(bvh, scattered);
+		const float refitCost = bvh.SAHCost();
+		CATCH_CHECK(bvh.Degradation() > 3.f);
+
+		CpuBvh rebuilt;
+		rebuilt.Build(scattered);
+		CATCH_CHECK(rebuilt.SAHCost() < refitCost / 3.f);
+	}
+
+	CATCH_SECTION("Twisting degrades the tree more the further it twists")
+	{
+		// Every slice along z turns around the z axis in proportion to its height, boxes that split the cube along x
+		// and y turn into diagonals
+		float previous = 1.f;
+		for (float turns : {0.1f, 0.25f, 0.5f})
+		{
+			std::vector<glm::vec3> twisted = vertices;
+			for (glm::vec3& vertex : twisted)
+			{
+				const float angle = vertex.z / 10.f * turns * 6.2831853f;
+				const glm::vec2 offset = glm::vec2(vertex.x, vertex.y) - 5.f;
+				vertex.x = 5.f + offset.x * std::cos(angle) - offset.y * std::sin(angle);
+				vertex.y = 5.f + offset.x * std::sin(angle) + offset.y * std::cos(angle);
+			}
+			bvh.Refit(twisted);
+			CheckBvh(bvh, twisted);
+			CATCH_INFO("Turns " << turns);
+			CATCH_CHECK(bvh.Degradation() > previous);
+			previous = bvh.Degradation();
+		}
+		CATCH_CHECK(previous > 1.25f);
+	}
+}
+
+CATCH_TEST_CASE("CPU BVH edge cases", "[BLAS]")
+{
+	CpuBvh bvh;
+	bvh.Build({});
+	CATCH_CHECK(bvh.IsEmpty());
+	CATCH_CHECK(bvh.SAHCost() == 0.f);
+	CATCH_CHECK(bvh.Degradation() == 1.f);
+
+	// All triangles on top of each other can't be split, they end up in one leaf
+	std::vector<glm::vec3> stacked;
+	for (int i = 0; i < 20; i++)
+	{
+		stacked.push_back(glm::vec3(0.f));
+		stacked.push_back(glm::vec3(1.f, 0.f, 0.f));
+		stacked.push_back(glm::vec3(0.f, 1.f, 0.f));
+	}
+	bvh.Build(stacked);
+	CATCH_REQUIRE(bvh.GetNodes().size() == 1);
+	CATCH_CHECK(bvh.GetNodes()[0].m_Count == 20);
+	CheckBvh(bvh, stacked);
+}
+
+CATCH_TEST_CASE("BLAS policy compacts static BLASes", "[BLAS]")
+{
+	BlasPolicyManager policy(MakePolicySettings());
+	const uint32_t id = policy.Register(BlasUsage::STATIC, 1000);
+
+	// The compacted size isn't known before the delay
+	CATCH_CHECK(policy.Schedule().empty());
+	std::vector<BlasTask> tasks = policy.Schedule();
+	CATCH_REQUIRE(tasks.size() == 1);
+	CATCH_CHECK(tasks[0].m_Id == id);
+	CATCH_CHECK(tasks[0].m_Operation == BlasOperation::COMPACT);
+
+	// Until it is reported the compaction comes back
+	tasks = policy.Schedule();
+	CATCH_REQUIRE(tasks.size() == 1);
+	CATCH_CHECK(tasks[0].m_Operation == BlasOperation::COMPACT);
+
+	policy.ReportCompaction(id, 1000000, 400000);
+	CATCH_CHECK(policy.IsCompacted(id));
+	CATCH_CHECK(policy.Schedule().empty());
+	CATCH_CHECK(policy.GetStats().m_Compactions == 1);
+	CATCH_CHECK(policy.GetStats().MemorySaved() == 600000);
+
+	// Reporting twice doesn't count again, a BLAS that didn't shrink saves nothing
+	policy.ReportCompaction(id, 1000000, 400000);
+	const uint32_t other = policy.Register(BlasUsage::STATIC, 1000);
+	policy.ReportCompaction(other, 1000, 2000);
+	CATCH_CHECK(policy.GetStats().m_Compactions == 2);
+	CATCH_CHECK(policy.GetStats().MemorySaved() == 600000);
+}
+
+CATCH_TEST_CASE("BLAS policy refits and rebuilds deforming BLASes", "[BLAS]")
+{
+	BlasPolicyManager policy(MakePolicySettings());
+	const uint32_t id = policy.Register(BlasUsage::DEFORMING, 10000);
+
+	// Nothing to do while it doesn't move, deforming BLASes aren't compacted
+	for (int frame = 0; frame < 4; frame++)
+		CATCH_CHECK(policy.Schedule().empty());
+
+	policy.MarkDeformed(id, 1.1f);
+	std::vector<BlasTask> tasks = policy.Schedule();
+	CATCH_REQUIRE(tasks.size() == 1);
+	CATCH_CHECK(tasks[0].m_Operation == BlasOperation::REFIT);
+	CATCH_CHECK(tasks[0].m_EstimatedMs == Catch::Approx(0.01f));
+	CATCH_CHECK(policy.Schedule().empty());
+
+	// Two objects share the model, the worst pose decides
+	policy.MarkDeformed(id, 1.6f);
+	policy.MarkDeformed(id, 1.2f);
+	CATCH_CHECK(policy.GetDegradation(id) == Catch::Approx(1.6f));
+	tasks = policy.Schedule();
+	CATCH_REQUIRE(tasks.size() == 1);
+	CATCH_CHECK(tasks[0].m_Operation == BlasOperation::REBUILD);
+	CATCH_CHECK(policy.GetDegradation(id) == 1.f);
+	CATCH_CHECK(policy.GetStats().m_Refits == 1);
+	CATCH_CHECK(policy.GetStats().m_Rebuilds == 1);
+
+	policy.MarkDeformed(id, 1.05f);
+	tasks = policy.Schedule();
+	CATCH_REQUIRE(tasks.size() == 1);
+	CATCH_CHECK(tasks[0].m_Operation == BlasOperation::REFIT);
+}
+
+CATCH_TEST_CASE("BLAS policy spreads rebuilds over frames", "[BLAS]")
+{
+	BlasPolicySettings settings = MakePolicySettings();
+	BlasPolicyManager policy(settings);
+
+	// A rebuild of 50K triangles costs 0.5 ms, only one fits in the budget next to the refits
+	std::vector<uint32_t> ids;
+	for (int i = 0; i < 8; i++)
+		ids.push_back(policy.Register(BlasUsage::DEFORMING, 50000));
+
+	std::vector<uint64_t> rebuildFrame(ids.size(), 0);
+	for (int frame = 0; frame < 8; frame++)
+	{
+		for (size_t i = 0; i < ids.size(); i++)
+			policy.MarkDeformed(ids[i], rebuildFrame[i] == 0 ? 2.f + 0.1f * static_cast<float>(i) : 1.f);
+
+		const std::vector<BlasTask> tasks = policy.Schedule();
+		CATCH_INFO("Frame " << frame);
+		// Every BLAS moved, each one is either refitted or rebuilt
+		CATCH_CHECK(tasks.size() == ids.size());
+		CATCH_CHECK(policy.GetStats().m_EstimatedMs <= settings.m_FrameBudgetMs + 1e-4f);
+
+		for (size_t i = 0; i < ids.size(); i++)
+		{
+			const BlasTask* task = FindTask(tasks, ids[i]);
+			CATCH_REQUIRE(task != nullptr);
+			if (task->m_Operation == BlasOperation::REBUILD)
+			{
+				CATCH_CHECK(rebuildFrame[i] == 0);
+				rebuildFrame[i] = policy.GetFrame();
+			}
+		}
+	}
+
+	// All got rebuilt, the most degraded ones first
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		CATCH_CHECK(rebuildFrame[i] != 0);
+		if (i > 0)
+			CATCH_CHECK(rebuildFrame[i] <= rebuildFrame[i - 1]);
+	}
+	CATCH_CHECK(policy.GetStats().m_Rebuilds == ids.size());
+}
+
+CATCH_TEST_CASE("BLAS policy doesn't starve over budget work", "[BLAS]")
+{
+	BlasPolicySettings settings = MakePolicySettings();
+	settings.m_FrameBudgetMs = 0.f;
+	BlasPolicyManager policy(settings);
+
+	const uint32_t deforming = policy.Register(BlasUsage::DEFORMING, 1000000);
+	std::vector<uint32_t> statics;
+	for (int i = 0; i < 3; i++)
+		statics.push_back(policy.Register(BlasUsage::STATIC, 1000000));
+
+	policy.MarkDeformed(deforming, 5.f);
+	for (int frame = 0; frame < 6; frame++)
+	{
+		const std::vector<BlasTask> tasks = policy.Schedule();
+		uint32_t deferred = 0;
+		for (const BlasTask& task : tasks)
+		{
+			if (task.m_Operation == BlasOperation::COMPACT)
+			{
+				policy.ReportCompaction(task.m_Id, 2000, 1000);
+				deferred++;
+			}
+			else if (task.m_Operation == BlasOperation::REBUILD)
+			{
+				deferred++;
+			}
+		}
+		// One over budget operation per frame, not all of them
+		CATCH_CHECK(deferred <= 1);
+	}
+
+	CATCH_CHECK(policy.GetStats().m_Rebuilds == 1);
+	for (uint32_t id : statics)
+		CATCH_CHECK(policy.IsCompacted(id));
+	CATCH_CHECK(policy.GetStats().MemorySaved() == 3000);
+}
+
+CATCH_TEST_CASE("BLAS policy reuses ids", "[BLAS]")
+{
+	BlasPolicyManager policy(MakePolicySettings());
+	const uint32_t first = policy.Register(BlasUsage::STATIC, 100);
+	const uint32_t second = policy.Register(BlasUsage::DEFORMING, 100);
+	policy.Unregister(first);
+	CATCH_CHECK(!policy.IsRegistered(first));
+	CATCH_CHECK(policy.IsRegistered(second));
+
+	// An unregistered BLAS isn't compacted anymore
+	for (int frame = 0; frame < 4; frame++)
+		CATCH_CHECK(policy.Schedule().empty());
+
+	const uint32_t third = policy.Register(BlasUsage::STATIC, 100);
+	CATCH_CHECK(third == first);
+	CATCH_CHECK(!policy.IsCompacted(third));
+}
+
+// Cost of keeping the degradation metric of an animated model up to date, run with [.benchmark]
+CATCH_TEST_CASE("CPU BVH benchmark", "[.benchmark]")
+{
+	std::printf("%-10s %10s %10s %10s\n", "Triangles", "Build ms", "Refit ms", "SAH");
+	for (uint32_t count : {10000u, 100000u, 1000000u})
+	{
+		const std::vector<glm::vec3> vertices = MakeTriangleSoup(count, 5);
+		CpuBvh bvh;
+		auto start = std::chrono::high_resolution_clock::now();
+		bvh.Build(vertices);
+		const std::chrono::duration<double, std::milli> build = std::chrono::high_resolution_clock::now() - start;
+
+		start = std::chrono::high_resolution_clock::now();
+		bvh.Refit(vertices);
+		const std::chrono::duration<double, std::milli> refit = std::chrono::high_resolution_clock::now() - start;
+		std::printf("%-10u %10.2f %10.2f %10.2f\n", count, build.count(), refit.count(), bvh.SAHCost());
+	}
+}
@@ -0,0 +1,474 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "ShaderHeaders/BsdfGPU.h"
+
+using namespace Ball;
+
+namespace
+{
+	// Shading frame of the tests, tangent space and world space are the same
+	const float3 NORMAL = float3(0.f, 0.f, 1.f);
+	const float3 TANGENT = float3(1.f, 0.f, 0.f);
+	const float3 BITANGENT = float3(0.f, 1.f, 0.f);
+
+	MaterialHitData MakeMaterial(float alphaRoughness, float metallic, float specularWeight = 0.f,
+								 float transmission = 0.f)
+	{
+		MaterialHitData material{};
+		material.m_AlphaRoughness = alphaRoughness;
+		material.m_Metallic = metallic;
+		material.m_SpecularWeight = specularWeight;
+		material.m_TransmissionFactor = transmission;
+		material.m_Eta = 1.f / 1.5f;
+		// White, so every bit of energy the BSDF reflects shows up in the furnace tests
+		material.m_BaseColor = float3(1.f, 1.f, 1.f);
+		material.m_F0 = Bsdf::lerp(float3(0.04f, 0.04f, 0.04f), material.m_BaseColor, metallic);
+		return material;
+	}
+
+	float3 MakeDirection(float cosTheta, float phi)
+	{
+		const float sinTheta = std::sqrt(std::max(1.f - cosTheta * cosTheta, 0.f));
+		return float3(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+	}
+
+	float3 RandomHemisphereDirection(uint& seed)
+	{
+		const float cosTheta = 0.05f + 0.95f * Bsdf::rand(seed);
+		return MakeDirection(cosTheta, 2.f * Bsdf::BSDF_PI * Bsdf::rand(seed));
+	}
+
+	// Pearson's chi-square test of sampled directions against the pdf they should follow. Directions are binned by
+	// cos(theta) and phi over the whole sphere, the expected counts integrate the pdf numerically. Returns the z-score
+	// of the statistic (Wilson-Hilferty approximation), low values mean the samples fit the pdf.
+	double ChiSquareTest(const std::function<float3(uint&)>& sample, const std::function<float(float3)>& pdf,
+						 int numSamples, double& integratedPdf)
+	{
+		constexpr int THETA_BINS = 20;
+		constexpr int PHI_BINS = 40;
+		constexpr int SUB_SAMPLES = 16;
+		const double TWO_PI = 2.0 * Bsdf::BSDF_PI;
+
+		std::vector<double> observed(THETA_BINS * PHI_BINS, 0.0);
+		uint seed = 7919;
+		for (int i = 0; i < numSamples; i++)
+		{
+			const float3 direction = sample(seed);
+			double phi = std::atan2(direction.y, direction.x);
+			if (phi < 0.0)
+				phi += TWO_PI;
+			const int thetaBin =
+				std::clamp(static_cast<int>((direction.z + 1.0) * 0.5 * THETA_BINS), 0, THETA_BINS - 1);
+			const int phiBin = std::clamp(static_cast<int>(phi / TWO_PI * PHI_BINS), 0, PHI_BINS - 1);
+			observed[thetaBin * PHI_BINS + phiBin] += 1.0;
+		}
+
+		std::vector<double> expected(THETA_BINS * PHI_BINS, 0.0);
+		integratedPdf = 0.0;
+		const double binSolidAngle = (2.0 / THETA_BINS) * (TWO_PI / PHI_BINS);
+		for (int thetaBin = 0; thetaBin < THETA_BINS; thetaBin++)
+		{
+			for (int phiBin = 0; phiBin < PHI_BINS; phiBin++)
+			{
+				double sum = 0.0;
+				for (int i = 0; i < SUB_SAMPLES; i++)
+				{
+					const double cosTheta = -1.0 + (thetaBin + (i + 0.5) / SUB_SAMPLES) * 2.0 / THETA_BINS;
+					for (int j = 0; j < SUB_SAMPLES; j++)
+					{
+						const double phi = (phiBin + (j + 0.5) / SUB_SAMPLES) * TWO_PI / PHI_BINS;
+						sum += pdf(MakeDirection(static_cast<float>(cosTheta), static_cast<float>(phi)));
+					}
+				}
+				const double probability = sum / (SUB_SAMPLES * SUB_SAMPLES) * binSolidAngle;
+				expected[thetaBin * PHI_BINS + phiBin] = probability * numSamples;
+				integratedPdf += probability;
+			}
+		}
+
+		// Bins with few expected samples are pooled, the statistic isn't chi-square distributed otherwise
+		double chiSquare = 0.0;
+		double pooledObserved = 0.0;
+		double pooledExpected = 0.0;
+		int degreesOfFreedom = -1;
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			if (expected[i] < 5.0)
+			{
+				pooledObserved += observed[i];
+				pooledExpected += expected[i];
+				continue;
+			}
+			const double difference = observed[i] - expected[i];
+			chiSquare += difference * difference / expected[i];
+			degreesOfFreedom++;
+		}
+		if (pooledExpected > 0.0)
+		{
+			const double difference = pooledObserved - pooledExpected;
+			chiSquare += difference * difference / std::max(pooledExpected, 5.0);
+			degreesOfFreedom++;
+		}
+
+		const double k = std::max(degreesOfFreedom, 1);
+		const double variance = 2.0 / (9.0 * k);
+		return (std::cbrt(chiSquare / k) - (1.0 - variance)) / std::sqrt(variance);
+	}
+
+	struct Estimate
+	{
+		double m_Mean = 0.0;
+		double m_Variance = 0.0;
+	};
+
+	// Directional albedo of a material, the average throughput of a bounce like Shade.hlsl computes it
+	Estimate EstimateAlbedo(const MaterialHitData& material, float3 V, int numSamples, uint seed)
+	{
+		double sum = 0.0;
+		double sumSq = 0.0;
+		for (int i = 0; i < numSamples; i++)
+		{
+			uint isSpecular = 0;
+			bool refracted = false;
+			float3 L = float3(0.f, 0.f, 0.f);
+			float pdf = 0.f;
+			const float3 brdf =
+				Bsdf::PbrSample(material, NORMAL, TANGENT, BITANGENT, V, isSpecular, refracted, L, pdf, seed);
+			double weight = 0.0;
+			if (pdf > 0.f)
+				weight = brdf.g * std::abs(glm::dot(NORMAL, L)) / pdf;
+			sum += weight;
+			sumSq += weight * weight;
+		}
+		Estimate estimate;
+		estimate.m_Mean = sum / numSamples;
+		estimate.m_Variance = sumSq / numSamples - estimate.m_Mean * estimate.m_Mean;
+		return estimate;
+	}
+
+	// Directional albedo of the GGX reflection lobe with F = 1 by brute force quadrature over the hemisphere
+	double IntegrateSpecular(float alpha, float3 V)
+	{
+		constexpr int STEPS = 512;
+		double sum = 0.0;
+		for (int i = 0; i < STEPS; i++)
+		{
+			const float cosTheta = (i + 0.5f) / STEPS;
+			for (int j = 0; j < STEPS; j++)
+			{
+				const float3 L = MakeDirection(cosTheta, 2.f * Bsdf::BSDF_PI * (j + 0.5f) / STEPS);
+				const float3 H = glm::normalize(V + L);
+				sum += Bsdf::D_GGX(H.z, alpha) * Bsdf::V_GGX(L.z, V.z, alpha) * L.z;
+			}
+		}
+		return sum * 2.0 * Bsdf::BSDF_PI / (STEPS * STEPS);
+	}
+
+	// Estimates of the GGX reflection lobe with F = 1 when sampling with the old and the visible normal sampler
+	Estimate EstimateSpecular(float alpha, float3 V, bool visibleNormals, int numSamples)
+	{
+		uint seed = 4099;
+		double sum = 0.0;
+		double sumSq = 0.0;
+		for (int i = 0; i < numSamples; i++)
+		{
+			const float3 H =
+				visibleNormals ? Bsdf::GGXSamplingVNDF(V, alpha, seed) : Bsdf::GGXSampling(alpha, seed);
+			const float3 L = glm::reflect(-V, H);
+			const float NdotL = L.z;
+			const float NdotV = V.z;
+			const float VdotH = glm::dot(V, H);
+			double weight = 0.0;
+			if (NdotL > 0.f && VdotH > 0.f)
+			{
+				const float pdf = visibleNormals ? Bsdf::GGXReflectionPdfVNDF(NdotV, H.z, alpha)
+												 : Bsdf::GGXReflectionPdf(H.z, VdotH, alpha);
+				weight = Bsdf::D_GGX(H.z, alpha) * Bsdf::V_GGX(NdotL, NdotV, alpha) * NdotL / pdf;
+			}
+			sum += weight;
+			sumSq += weight * weight;
+		}
+		Estimate estimate;
+		estimate.m_Mean = sum / numSamples;
+		estimate.m_Variance = sumSq / numSamples - estimate.m_Mean * estimate.m_Mean;
+		return estimate;
+	}
+} // namespace
+
+CATCH_TEST_CASE("BSDF sampling matches the pdf")
+{
+	// p-value of about 3e-5, the tests are deterministic
+	constexpr double MAX_Z_SCORE = 4.0;
+	constexpr int NUM_SAMPLES = 200000;
+	double integratedPdf = 0.0;
+
+	CATCH_SECTION("Cosine weighted hemisphere")
+	{
+		const double z = ChiSquareTest([](uint& seed) { return Bsdf::CosineWeightedDiffuseReflection(seed); },
+									   [](float3 L) { return std::max(L.z, 0.f) * Bsdf::BSDF_INV_PI; },
+									   NUM_SAMPLES,
+									   integratedPdf);
+		CATCH_CHECK(z < MAX_Z_SCORE);
+		CATCH_CHECK(integratedPdf == Catch::Approx(1.0).epsilon(0.01));
+	}
+
+	for (const float alpha : {0.2f, 0.5f, 1.f})
+	{
+		for (const float cosThetaV : {0.3f, 0.7f, 1.f})
+		{
+			const float3 V = MakeDirection(cosThetaV, 0.5f);
+			CATCH_CAPTURE(alpha, cosThetaV);
+
+			// Reflections around the sampled half vectors, the pdfs include the Jacobian of the reflection
+			const double vndfZ = ChiSquareTest(
+				[&](uint& seed) { return glm::reflect(-V, Bsdf::GGXSamplingVNDF(V, alpha, seed)); },
+				[&](float3 L)
+				{
+					const float3 H = glm::normalize(V + L);
+					if (glm::dot(V, H) <= 0.f || H.z <= 0.f)
+						return 0.f;
+					return Bsdf::GGXReflectionPdfVNDF(V.z, H.z, alpha);
+				},
+				NUM_SAMPLES,
+				integratedPdf);
+			CATCH_CHECK(vndfZ < MAX_Z_SCORE);
+			CATCH_CHECK(integratedPdf == Catch::Approx(1.0).epsilon(0.01));
+
+			const double ndfZ = ChiSquareTest(
+				[&](uint& seed) { return glm::reflect(-V, Bsdf::GGXSampling(alpha, seed)); },
+				[&](float3 L)
+				{
+					// Half vectors facing away from V reflect as well, the sampled one is in the upper hemisphere
+					float3 H = glm::normalize(V + L);
+					if (H.z < 0.f)
+						H = -H;
+					return Bsdf::GGXReflectionPdf(H.z, std::abs(glm::dot(V, H)), alpha);
+				},
+				NUM_SAMPLES,
+				integratedPdf);
+			CATCH_CHECK(ndfZ < MAX_Z_SCORE);
+			CATCH_CHECK(integratedPdf == Catch::Approx(1.0).epsilon(0.01));
+		}
+	}
+}
+
+CATCH_TEST_CASE("BSDF is reciprocal")
+{
+	uint seed = 1237;
+	for (const float alpha : {0.05f, 0.3f, 0.7f, 1.f})
+	{
+		for (const float metallic : {0.f, 0.5f, 1.f})
+		{
+			const MaterialHitData material = MakeMaterial(alpha, metallic, 0.5f);
+			const float specularChance = Bsdf::GetSpecularChance(material);
+			for (int i = 0; i < 64; i++)
+			{
+				const float3 V = RandomHemisphereDirection(seed);
+				const float3 L = RandomHemisphereDirection(seed);
+				const float3 H = glm::normalize(V + L);
+				CATCH_CAPTURE(alpha, metallic, i);
+
+				float pdf = 0.f;
+				for (const bool specular : {false, true})
+				{
+					const float3 forward =
+						Bsdf::EvalBSDF(material, V, NORMAL, L, H, specular, specularChance, false, 0.f, pdf);
+					const float3 backward =
+						Bsdf::EvalBSDF(material, L, NORMAL, V, H, specular, specularChance, false, 0.f, pdf);
+					CATCH_CHECK(forward.r == Catch::Approx(backward.r).epsilon(1e-4));
+					CATCH_CHECK(forward.g == Catch::Approx(backward.g).epsilon(1e-4));
+				}
+			}
+		}
+	}
+}
+
+CATCH_TEST_CASE("BSDF white furnace")
+{
+	constexpr int NUM_SAMPLES = 100000;
+
+	CATCH_SECTION("No material reflects more energy than it receives")
+	{
+		// Fewer samples per material, the grid is large
+		constexpr int NUM_GRID_SAMPLES = 20000;
+		uint seed = 17;
+		for (const float alpha : {0.01f, 0.1f, 0.3f, 0.6f, 1.f})
+		{
+			for (const float metallic : {0.f, 0.25f, 0.5f, 0.75f, 1.f})
+			{
+				for (const float specularWeight : {0.f, 0.5f, 1.f})
+				{
+					for (const float cosThetaV : {0.2f, 0.6f, 1.f})
+					{
+						const MaterialHitData material = MakeMaterial(alpha, metallic, specularWeight);
+						const Estimate albedo =
+							EstimateAlbedo(material, MakeDirection(cosThetaV, 0.f), NUM_GRID_SAMPLES, seed++);
+						CATCH_CAPTURE(alpha, metallic, specularWeight, cosThetaV, albedo.m_Mean);
+						// Four standard errors of slack for the noise
+						CATCH_CHECK(albedo.m_Mean <= 1.0 + 4.0 * std::sqrt(albedo.m_Variance / NUM_GRID_SAMPLES));
+					}
+				}
+			}
+		}
+	}
+
+	CATCH_SECTION("Diffuse and smooth metals reflect everything")
+	{
+		const float3 V = MakeDirection(0.8f, 0.f);
+		const Estimate diffuse = EstimateAlbedo(MakeMaterial(0.5f, 0.f), V, NUM_SAMPLES, 3);
+		CATCH_CHECK(diffuse.m_Mean == Catch::Approx(1.0).epsilon(0.01));
+
+		const Estimate mirror = EstimateAlbedo(MakeMaterial(0.01f, 1.f), V, NUM_SAMPLES, 5);
+		CATCH_CHECK(mirror.m_Mean == Catch::Approx(1.0).epsilon(0.01));
+		// Every sample of a smooth metal carries the same weight
+		CATCH_CHECK(mirror.m_Variance < 1e-3);
+	}
+
+	CATCH_SECTION("Metals match the integrated single scattering albedo")
+	{
+		// Single scattering GGX loses energy at high roughness, the sampled estimate has to lose the same amount
+		uint seed = 11;
+		for (const float alpha : {0.1f, 0.3f, 0.6f, 1.f})
+		{
+			for (const float cosThetaV : {0.2f, 0.6f, 1.f})
+			{
+				const float3 V = MakeDirection(cosThetaV, 0.f);
+				const double reference = IntegrateSpecular(alpha, V);
+				const Estimate albedo = EstimateAlbedo(MakeMaterial(alpha, 1.f), V, NUM_SAMPLES, seed++);
+				CATCH_CAPTURE(alpha, cosThetaV, reference, albedo.m_Mean);
+				CATCH_CHECK(std::abs(albedo.m_Mean - reference) <
+							4.0 * std::sqrt(albedo.m_Variance / NUM_SAMPLES) + 0.002);
+			}
+		}
+	}
+
+	CATCH_SECTION("Transmissive materials")
+	{
+		uint seed = 29;
+		for (const float alpha : {0.05f, 0.3f, 1.f})
+		{
+			for (const float cosThetaV : {0.2f, 0.6f, 1.f})
+			{
+				const MaterialHitData glass = MakeMaterial(alpha, 0.f, 0.f, 1.f);
+				const Estimate albedo = EstimateAlbedo(glass, MakeDirection(cosThetaV, 0.f), NUM_SAMPLES, seed++);
+				CATCH_CAPTURE(alpha, cosThetaV, albedo.m_Mean);
+				CATCH_CHECK(albedo.m_Mean <= 1.0 + 4.0 * std::sqrt(albedo.m_Variance / NUM_SAMPLES));
+			}
+		}
+	}
+}
+
+CATCH_TEST_CASE("BSDF visible normal sampling")
+{
+	constexpr int NUM_SAMPLES = 200000;
+	for (const float alpha : {0.1f, 0.4f, 0.8f})
+	{
+		for (const float cosThetaV : {0.2f, 0.5f, 0.9f})
+		{
+			const float3 V = MakeDirection(cosThetaV, 1.f);
+			const Estimate ndf = EstimateSpecular(alpha, V, false, NUM_SAMPLES);
+			const Estimate vndf = EstimateSpecular(alpha, V, true, NUM_SAMPLES);
+			CATCH_CAPTURE(alpha, cosThetaV, ndf.m_Mean, ndf.m_Variance, vndf.m_Mean, vndf.m_Variance);
+
+			// Both estimate the same integral, the visible normals with less noise
+			const double standardError = std::sqrt((ndf.m_Variance + vndf.m_Variance) / NUM_SAMPLES);
+			CATCH_CHECK(std::abs(ndf.m_Mean - vndf.m_Mean) < 4.0 * standardError + 1e-4);
+			CATCH_CHECK(vndf.m_Variance < ndf.m_Variance);
+			// A sample never carries more than all the energy
+			CATCH_CHECK(vndf.m_Mean <= 1.0);
+		}
+	}
+}
+
+CATCH_TEST_CASE("BSDF benchmark", "[.benchmark]")
+{
+	constexpr int NUM_SAMPLES = 4096;
+	uint seed = 97;
+	std::vector<MaterialHitData> materials;
+	std::vector<float3> views;
+	std::vector<float3> lights;
+	for (int i = 0; i < NUM_SAMPLES; i++)
+	{
+		materials.push_back(MakeMaterial(0.01f + Bsdf::rand(seed), Bsdf::rand(seed), Bsdf::rand(seed)));
+		views.push_back(RandomHemisphereDirection(seed));
+		lights.push_back(RandomHemisphereDirection(seed));
+	}
+
+	// The terms of the GGX lobe as structure of arrays, the layout the compiler turns into SIMD loops
+	std::vector<float> NdotH(NUM_SAMPLES);
+	std::vector<float> NdotL(NUM_SAMPLES);
+	std::vector<float> NdotV(NUM_SAMPLES);
+	std::vector<float> VdotH(NUM_SAMPLES);
+	std::vector<float> alpha(NUM_SAMPLES);
+	std::vector<float> result(NUM_SAMPLES);
+	for (int i = 0; i < NUM_SAMPLES; i++)
+	{
+		const float3 H = glm::normalize(views[i] + lights[i]);
+		NdotH[i] = H.z;
+		NdotL[i] = lights[i].z;
+		NdotV[i] = views[i].z;
+		VdotH[i] = glm::dot(views[i], H);
+		alpha[i] = materials[i].m_AlphaRoughness;
+	}
+
+	CATCH_BENCHMARK("4096 EvalBSDF")
+	{
+		float3 sum = float3(0.f, 0.f, 0.f);
+		for (int i = 0; i < NUM_SAMPLES; i++)
+		{
+			const float3 H = glm::normalize(views[i] + lights[i]);
+			float pdf = 0.f;
+			sum += Bsdf::EvalBSDF(materials[i], views[i], NORMAL, lights[i], H, true, 0.5f, false, 0.f, pdf);
+		}
+		return sum;
+	};
+
+	CATCH_BENCHMARK("4096 PbrSample")
+	{
+		float3 sum = float3(0.f, 0.f, 0.f);
+		uint sampleSeed = 101;
+		for (int i = 0; i < NUM_SAMPLES; i++)
+		{
+			uint isSpecular = 0;
+			bool refracted = false;
+			float3 L = float3(0.f, 0.f, 0.f);
+			float pdf = 0.f;
+			sum += Bsdf::PbrSample(
+				materials[i], NORMAL, TANGENT, BITANGENT, views[i], isSpecular, refracted, L, pdf, sampleSeed);
+		}
+		return sum;
+	};
+
+	CATCH_BENCHMARK("4096 D * V * F, structure of arrays")
+	{
+		for (int i = 0; i < NUM_SAMPLES; i++)
+		{
+			result[i] = Bsdf::D_GGX(NdotH[i], alpha[i]) * Bsdf::V_GGX(NdotL[i], NdotV[i], alpha[i]) *
+				Bsdf::F_Schlick(0.04f, 1.f, VdotH[i]);
+		}
+		return result[NUM_SAMPLES / 2];
+	};
+
+	CATCH_BENCHMARK("4096 GGXSampling")
+	{
+		float3 sum = float3(0.f, 0.f, 0.f);
+		uint sampleSeed = 103;
+		for (int i = 0; i < NUM_SAMPLES; i++)
+			sum += Bsdf::GGXSampling(alpha[i], sampleSeed);
+		return sum;
+	};
+
+	CATCH_BENCHMARK("4096 GGXSamplingVNDF")
+	{
+		float3 sum = float3(0.f, 0.f, 0.f);
+		uint sampleSeed = 103;
+		for (int i = 0; i < NUM_SAMPLES; i++)
+			sum += Bsdf::GGXSamplingVNDF(views[i], alpha[i], sampleSeed);
+		return sum;
+	};
+}
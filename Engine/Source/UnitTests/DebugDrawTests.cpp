@@ -0,0 +1,232 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <thread>
+
+#include "Rendering/DebugDrawStream.h"
+#include "Rendering/ModelLoading/Model.h"
+
+using namespace Ball;
+
+namespace
+{
+	Triangle MakeTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2)
+	{
+		return {v0, v1, v2, glm::normalize(glm::cross(v1 - v0, v2 - v0))};
+	}
+
+	// 12 triangles, 2 per face
+	std::vector<Triangle> MakeCube()
+	{
+		std::vector<Triangle> triangles;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			for (float side : {-1.f, 1.f})
+			{
+				glm::vec3 corners[4];
+				for (int i = 0; i < 4; i++)
+				{
+					glm::vec3 corner;
+					corner[axis] = side;
+					corner[(axis + 1) % 3] = (i == 1 || i == 2) ? 1.f : -1.f;
+					corner[(axis + 2) % 3] = i >= 2 ? 1.f : -1.f;
+					corners[i] = corner;
+				}
+				triangles.push_back(MakeTriangle(corners[0], corners[1], corners[2]));
+				triangles.push_back(MakeTriangle(corners[0], corners[2], corners[3]));
+			}
+		}
+		return triangles;
+	}
+} // namespace
+
+CATCH_TEST_CASE("DebugDrawStream")
+{
+	CATCH_SECTION("Ring allocates until the frame is full")
+	{
+		std::vector<DebugPrimitiveGPU> memory(2 * 8);
+		DebugPrimitiveRing ring;
+		ring.Init(memory.data(), 8, 2);
+
+		DebugPrimitiveGPU* first = ring.Allocate(5);
+		CATCH_CHECK(first == memory.data());
+		CATCH_CHECK(ring.Allocate(2) == memory.data() + 5);
+		// Doesn't fit, nothing is reserved
+		CATCH_CHECK(ring.Allocate(2) == nullptr);
+		CATCH_CHECK(ring.GetDroppedCount() == 2);
+		CATCH_CHECK(ring.Allocate(1) == memory.data() + 7);
+
+		const DebugPrimitiveRange range = ring.EndFrame();
+		CATCH_CHECK(range.m_First == 0);
+		CATCH_CHECK(range.m_Count == 8);
+		CATCH_CHECK(ring.GetDroppedCount() == 0);
+
+		// The next frame writes to the second region, then the first one again
+		CATCH_CHECK(ring.Allocate(3) == memory.data() + 8);
+		CATCH_CHECK(ring.EndFrame().m_First == 8);
+		CATCH_CHECK(ring.Allocate(1) == memory.data());
+		CATCH_CHECK(ring.EndFrame().m_Count == 1);
+	}
+
+	CATCH_SECTION("Records from many threads all end up in the frame")
+	{
+		constexpr uint32_t numThreads = 8;
+		constexpr uint32_t perThread = 10000;
+		std::vector<DebugPrimitiveGPU> memory(numThreads * perThread);
+		DebugPrimitiveRing ring;
+		ring.Init(memory.data(), numThreads * perThread, 1);
+
+		std::vector<std::thread> threads;
+		for (uint32_t thread = 0; thread < numThreads; thread++)
+		{
+			threads.emplace_back(
+				[&ring, thread]()
+				{
+					// Mix single records and batches
+					for (uint32_t i = 0; i < perThread;)
+					{
+						const uint32_t count = (std::min)(1 + i % 7, perThread - i);
+						DebugPrimitiveGPU* records = ring.Allocate(count);
+						for (uint32_t j = 0; j < count; j++)
+							records[j].m_Color = thread * perThread + i + j;
+						i += count;
+					}
+				});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+
+		const DebugPrimitiveRange range = ring.EndFrame();
+		CATCH_REQUIRE(range.m_Count == numThreads * perThread);
+
+		std::vector<uint8_t> seen(numThreads * perThread, 0);
+		for (const DebugPrimitiveGPU& record : memory)
+			seen[record.m_Color]++;
+		CATCH_CHECK(std::count(seen.begin(), seen.end(), 1) == static_cast<long>(seen.size()));
+	}
+
+	CATCH_SECTION("Streams are laid out one after another")
+	{
+		std::vector<DebugPrimitiveGPU> memory(DebugDrawStream::NUM_FRAMES * DebugDrawStream::GetRecordsPerFrame());
+		DebugDrawStream stream;
+		stream.Init(memory.data());
+
+		stream.AddLine(glm::vec3(0.f), glm::vec3(1.f), glm::vec3(1.f, 0.f, 0.f), DebugDrawChannel::OVERLAY);
+		stream.AddAABB({glm::vec3(-1.f), glm::vec3(1.f)}, glm::vec3(1.f), DebugDrawChannel::DEPTH_TESTED);
+		stream.AddAABB({}, glm::vec3(1.f), DebugDrawChannel::DEPTH_TESTED);
+
+		DebugPrimitiveRange ranges[DebugDrawStream::NUM_STREAMS];
+		stream.EndFrame(ranges);
+		CATCH_CHECK(ranges[DebugDrawStream::DEPTH_TESTED_LINES].m_Count == 0);
+		CATCH_CHECK(ranges[DebugDrawStream::DEPTH_TESTED_SHAPES].m_Count == 1);
+		CATCH_CHECK(ranges[DebugDrawStream::OVERLAY_LINES].m_Count == 1);
+
+		const DebugPrimitiveGPU& line = memory[ranges[DebugDrawStream::OVERLAY_LINES].m_First];
+		CATCH_CHECK(line.m_Type == DEBUG_PRIMITIVE_LINE);
+		CATCH_CHECK(line.m_Color == 0xFF0000FFu);
+		CATCH_CHECK(memory[ranges[DebugDrawStream::DEPTH_TESTED_SHAPES].m_First].m_Type == DEBUG_PRIMITIVE_BOX);
+	}
+
+	CATCH_SECTION("Shapes expand to their outlines")
+	{
+		std::vector<DebugPrimitiveGPU> memory(DebugDrawStream::NUM_FRAMES * DebugDrawStream::GetRecordsPerFrame());
+		DebugDrawStream stream;
+		stream.Init(memory.data());
+
+		const AABB box = {glm::vec3(1.f, 2.f, 3.f), glm::vec3(2.f, 4.f, 6.f)};
+		stream.AddAABB(box, glm::vec3(1.f), DebugDrawChannel::OVERLAY);
+		stream.AddSphere(glm::vec3(5.f, 0.f, 0.f), 2.f, glm::vec3(1.f), DebugDrawChannel::OVERLAY);
+
+		DebugPrimitiveRange ranges[DebugDrawStream::NUM_STREAMS];
+		stream.EndFrame(ranges);
+		const DebugPrimitiveRange& shapes = ranges[DebugDrawStream::OVERLAY_SHAPES];
+		CATCH_REQUIRE(shapes.m_Count == 2);
+
+		std::vector<glm::vec3> boxPoints;
+		ExpandDebugPrimitives(&memory[shapes.m_First], 1, boxPoints);
+		CATCH_REQUIRE(boxPoints.size() == 24);
+		for (size_t i = 0; i < boxPoints.size(); i += 2)
+		{
+			// Every point is a corner and every line is an edge along one axis
+			for (int axis = 0; axis < 3; axis++)
+			{
+				CATCH_CHECK((boxPoints[i][axis] == Catch::Approx(box.m_Min[axis]) ||
+							 boxPoints[i][axis] == Catch::Approx(box.m_Max[axis])));
+			}
+			const glm::vec3 edge = glm::abs(boxPoints[i + 1] - boxPoints[i]);
+			CATCH_CHECK((edge.x > 0.f) + (edge.y > 0.f) + (edge.z > 0.f) == 1);
+		}
+
+		std::vector<glm::vec3> spherePoints;
+		ExpandDebugPrimitives(&memory[shapes.m_First + 1], 1, spherePoints);
+		CATCH_REQUIRE(spherePoints.size() == DEBUG_SHAPE_VERTEX_COUNT);
+		for (const glm::vec3& point : spherePoints)
+			CATCH_CHECK(glm::length(point - glm::vec3(5.f, 0.f, 0.f)) == Catch::Approx(2.f));
+	}
+
+	CATCH_SECTION("Frustum edges lie on the planes")
+	{
+		ViewPyramid pyramid;
+		pyramid.m_TopPlane = glm::vec4(0.f, -1.f, -1.f, 0.f);
+		pyramid.m_BotPlane = glm::vec4(0.f, 1.f, -1.f, 0.f);
+		pyramid.m_LeftPlane = glm::vec4(1.f, 0.f, -1.f, 0.f);
+		pyramid.m_RightPlane = glm::vec4(-1.f, 0.f, -1.f, 0.f);
+		const auto frustum = CullingFrustum::FromViewPyramid(pyramid, glm::vec3(3.f, 0.f, 0.f), 10.f);
+
+		std::vector<DebugPrimitiveGPU> memory(DebugDrawStream::NUM_FRAMES * DebugDrawStream::GetRecordsPerFrame());
+		DebugDrawStream stream;
+		stream.Init(memory.data());
+		stream.AddFrustum(frustum, glm::vec3(1.f), DebugDrawChannel::OVERLAY);
+
+		DebugPrimitiveRange ranges[DebugDrawStream::NUM_STREAMS];
+		stream.EndFrame(ranges);
+		std::vector<glm::vec3> points;
+		ExpandDebugPrimitives(&memory[ranges[DebugDrawStream::OVERLAY_SHAPES].m_First], 1, points);
+		CATCH_REQUIRE(points.size() == 16);
+
+		// The first 4 lines start at the camera and end at the max distance, on two planes each
+		for (size_t i = 0; i < 8; i += 2)
+		{
+			CATCH_CHECK(points[i] == glm::vec3(3.f, 0.f, 0.f));
+			CATCH_CHECK(glm::length(points[i + 1] - points[i]) == Catch::Approx(10.f));
+
+			int onPlanes = 0;
+			for (const glm::vec4& plane : frustum.m_Planes)
+				onPlanes += std::abs(glm::dot(glm::vec3(plane), points[i + 1]) + plane.w) < 1e-4f;
+			CATCH_CHECK(onPlanes == 2);
+		}
+	}
+
+	CATCH_SECTION("Shared triangle edges are extracted once")
+	{
+		std::vector<DebugEdge> edges;
+		ExtractUniqueEdges({MakeTriangle(glm::vec3(0.f), glm::vec3(1.f, 0.f, 0.f), glm::vec3(1.f, 1.f, 0.f)),
+							MakeTriangle(glm::vec3(0.f), glm::vec3(1.f, 1.f, 0.f), glm::vec3(0.f, 1.f, 0.f))},
+						   edges);
+		CATCH_CHECK(edges.size() == 5);
+
+		edges.clear();
+		const std::vector<Triangle> cube = MakeCube();
+		ExtractUniqueEdges(cube, edges);
+		// 12 sides and a diagonal per face
+		CATCH_CHECK(edges.size() == 18);
+
+		// Every edge of every triangle is in the list
+		for (const Triangle& triangle : cube)
+		{
+			const glm::vec3 corners[3] = {triangle.m_V0, triangle.m_V1, triangle.m_V2};
+			for (int i = 0; i < 3; i++)
+			{
+				const glm::vec3& a = corners[i];
+				const glm::vec3& b = corners[(i + 1) % 3];
+				const bool found = std::any_of(edges.begin(),
+											   edges.end(),
+											   [&](const DebugEdge& edge)
+											   {
+												   return (edge.m_Start == a && edge.m_End == b) ||
+													   (edge.m_Start == b && edge.m_End == a);
+											   });
+				CATCH_CHECK(found);
+			}
+		}
+	}
+}
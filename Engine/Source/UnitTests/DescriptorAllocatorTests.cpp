@@ -0,0 +1,176 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <random>
+
+#include "Rendering/DescriptorAllocator.h"
+
+using namespace Ball;
+
+CATCH_TEST_CASE("DescriptorAllocator")
+{
+	CATCH_SECTION("Allocations are contiguous and don't overlap")
+	{
+		DescriptorAllocator allocator(1024);
+		const auto header = allocator.Allocate(18, "Header");
+		const auto model = allocator.Allocate(40, "Model");
+
+		CATCH_REQUIRE(header.IsValid());
+		CATCH_REQUIRE(model.IsValid());
+		CATCH_CHECK(header.m_Start == 0);
+		CATCH_CHECK(model.m_Start == 18);
+		CATCH_CHECK(allocator.GetStats().m_PersistentAllocated == 58);
+	}
+
+	CATCH_SECTION("Frees are deferred until the fence completed")
+	{
+		DescriptorAllocator allocator(64);
+		allocator.BeginFrame(1, 0);
+		auto range = allocator.Allocate(64);
+		const auto freedStart = range.m_Start;
+		allocator.Free(range);
+		CATCH_CHECK(!range.IsValid());
+
+		// Frame 1 is still in flight
+		allocator.BeginFrame(2, 0);
+		CATCH_CHECK(allocator.GetStats().m_PendingFrees == 64);
+		CATCH_CHECK(!allocator.Allocate(1).IsValid());
+
+		allocator.BeginFrame(3, 1);
+		CATCH_CHECK(allocator.GetStats().m_PendingFrees == 0);
+		CATCH_CHECK(allocator.Allocate(64).m_Start == freedStart);
+	}
+
+	CATCH_SECTION("Free blocks are coalesced")
+	{
+		DescriptorAllocator allocator(300);
+		auto a = allocator.Allocate(100);
+		auto b = allocator.Allocate(100);
+		auto c = allocator.Allocate(100);
+		allocator.Free(a);
+		allocator.Free(c);
+		allocator.BeginFrame(1, 0);
+		CATCH_CHECK(allocator.GetStats().m_NumFreeBlocks == 2);
+		CATCH_CHECK(!allocator.Allocate(200).IsValid());
+
+		allocator.Free(b);
+		allocator.BeginFrame(2, 1);
+		CATCH_CHECK(allocator.GetStats().m_NumFreeBlocks == 1);
+		CATCH_CHECK(allocator.GetStats().m_LargestFreeBlock == 300);
+		CATCH_CHECK(allocator.Allocate(300).IsValid());
+	}
+
+#ifndef SHIPPING
+	CATCH_SECTION("Owners are tracked")
+	{
+		DescriptorAllocator allocator(128);
+		allocator.Allocate(4, "Header");
+		auto model = allocator.Allocate(8, "Sponza");
+
+		CATCH_CHECK(allocator.GetOwner(0) == "Header");
+		CATCH_CHECK(allocator.GetOwner(11) == "Sponza");
+		CATCH_CHECK(allocator.GetOwner(12).empty());
+		CATCH_CHECK(allocator.GetDebugAllocations().size() == 2);
+
+		allocator.Free(model);
+		CATCH_CHECK(allocator.GetOwner(11).empty());
+	}
+#endif
+
+	CATCH_SECTION("Fuzz random allocate and free patterns")
+	{
+		constexpr uint32_t capacity = 4096;
+		constexpr uint64_t framesInFlight = 2;
+
+		std::mt19937 rng(1337);
+		DescriptorAllocator allocator(capacity);
+
+		struct Pending
+		{
+			uint64_t m_Fence;
+			DescriptorRange m_Range;
+		};
+		std::vector<DescriptorRange> live;
+		std::vector<Pending> pending;
+		// Slot -> 0 free, 1 allocated, 2 freed but still in use by the GPU
+		std::vector<uint8_t> slots(capacity, 0);
+
+		uint64_t fence = 0;
+		for (int frame = 0; frame < 500; frame++)
+		{
+			fence++;
+			const uint64_t completed = fence > framesInFlight ? fence - framesInFlight : 0;
+			allocator.BeginFrame(fence, completed);
+
+			for (auto it = pending.begin(); it != pending.end();)
+			{
+				if (it->m_Fence <= completed)
+				{
+					for (uint32_t i = 0; i < it->m_Range.m_Count; i++)
+						slots[it->m_Range.m_Start + i] = 0;
+					it = pending.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+
+			const int numOperations = std::uniform_int_distribution<int>(1, 20)(rng);
+			for (int op = 0; op < numOperations; op++)
+			{
+				const int action = std::uniform_int_distribution<int>(0, 7)(rng);
+				if (action < 5)
+				{
+					// Mostly small allocations (textures of a model), sometimes a big one
+					const uint32_t count = action == 0 ? std::uniform_int_distribution<uint32_t>(64, 512)(rng)
+													   : std::uniform_int_distribution<uint32_t>(1, 16)(rng);
+					const auto range = allocator.Allocate(count);
+					if (!range.IsValid())
+						continue;
+
+					CATCH_REQUIRE(range.m_Count == count);
+					CATCH_REQUIRE(range.GetLast() < capacity);
+					for (uint32_t i = 0; i < count; i++)
+					{
+						CATCH_REQUIRE(slots[range.m_Start + i] == 0);
+						slots[range.m_Start + i] = 1;
+					}
+					live.push_back(range);
+				}
+				else if (!live.empty())
+				{
+					const auto index = std::uniform_int_distribution<size_t>(0, live.size() - 1)(rng);
+					DescriptorRange range = live[index];
+					live.erase(live.begin() + index);
+					for (uint32_t i = 0; i < range.m_Count; i++)
+						slots[range.m_Start + i] = 2;
+					pending.push_back({fence, range});
+					allocator.Free(range);
+				}
+			}
+
+			const auto stats = allocator.GetStats();
+			uint32_t allocated = 0;
+			uint32_t waiting = 0;
+			for (const uint8_t slot : slots)
+			{
+				allocated += slot == 1;
+				waiting += slot == 2;
+			}
+			CATCH_REQUIRE(stats.m_PersistentAllocated == allocated);
+			CATCH_REQUIRE(stats.m_PendingFrees == waiting);
+			CATCH_REQUIRE(stats.m_NumAllocations == live.size());
+		}
+
+		// Once everything is freed and the GPU caught up the heap is one block again
+		for (auto& range : live)
+			allocator.Free(range);
+		allocator.BeginFrame(fence + 1, fence);
+		allocator.BeginFrame(fence + 2, fence + 1);
+
+		const auto stats = allocator.GetStats();
+		CATCH_CHECK(stats.m_PersistentAllocated == 0);
+		CATCH_CHECK(stats.m_NumFreeBlocks == 1);
+		CATCH_CHECK(stats.m_LargestFreeBlock == capacity);
+	}
+}
@@ -0,0 +1,354 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Utilities/DynamicAABBTree.h"
+
+using namespace Ball;
+
+namespace
+{
+	AABB CreateRandomBox(std::mt19937& rng, float range)
+	{
+		std::uniform_real_distribution<float> position(-range, range);
+		std::uniform_real_distribution<float> size(0.1f, 5.f);
+		AABB box;
+		box.m_Min = glm::vec3(position(rng), position(rng), position(rng));
+		box.m_Max = box.m_Min + glm::vec3(size(rng), size(rng), size(rng));
+		return box;
+	}
+
+	bool Overlaps(const AABB& a, const AABB& b)
+	{
+		return glm::all(glm::lessThanEqual(a.m_Min, b.m_Max)) && glm::all(glm::lessThanEqual(b.m_Min, a.m_Max));
+	}
+
+	// Ray entry distance computed per axis without the slab shortcut, negative when the ray misses
+	float BruteForceRayDistance(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, const AABB& box)
+	{
+		float enter = 0.f;
+		float exit = maxDistance;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (direction[axis] == 0.f)
+			{
+				if (origin[axis] < box.m_Min[axis] || origin[axis] > box.m_Max[axis])
+					return -1.f;
+				continue;
+			}
+			float t0 = (box.m_Min[axis] - origin[axis]) / direction[axis];
+			float t1 = (box.m_Max[axis] - origin[axis]) / direction[axis];
+			if (t0 > t1)
+				std::swap(t0, t1);
+			enter = (std::max)(enter, t0);
+			exit = (std::min)(exit, t1);
+		}
+		return enter <= exit ? enter : -1.f;
+	}
+
+	// Live proxies next to their bounds, so queries can be checked against a loop over all boxes
+	struct TestScene
+	{
+		DynamicAABBTree m_Tree;
+		std::vector<int32_t> m_Proxies;
+		std::vector<AABB> m_Boxes;
+
+		void Add(const AABB& box)
+		{
+			m_Proxies.push_back(m_Tree.CreateProxy(box, nullptr));
+			m_Boxes.push_back(box);
+		}
+
+		void Remove(size_t index)
+		{
+			m_Tree.DestroyProxy(m_Proxies[index]);
+			m_Proxies.erase(m_Proxies.begin() + index);
+			m_Boxes.erase(m_Boxes.begin() + index);
+		}
+
+		void Move(size_t index, const glm::vec3& offset)
+		{
+			m_Boxes[index].m_Min += offset;
+			m_Boxes[index].m_Max += offset;
+			m_Tree.MoveProxy(m_Proxies[index], m_Boxes[index], offset);
+		}
+
+		template<typename Predicate>
+		std::vector<int32_t> BruteForce(Predicate&& predicate) const
+		{
+			std::vector<int32_t> result;
+			for (size_t i = 0; i < m_Boxes.size(); i++)
+			{
+				if (predicate(m_Boxes[i]))
+					result.push_back(m_Proxies[i]);
+			}
+			std::sort(result.begin(), result.end());
+			return result;
+		}
+	};
+
+	std::vector<int32_t> QueryOverlap(const DynamicAABBTree& tree, const AABB& box)
+	{
+		std::vector<int32_t> result;
+		tree.QueryOverlap(box,
+						  [&result](int32_t proxyId)
+						  {
+							  result.push_back(proxyId);
+							  return true;
+						  });
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	void CheckQueries(const TestScene& scene, std::mt19937& rng)
+	{
+		const DynamicAABBTree& tree = scene.m_Tree;
+		for (int query = 0; query < 20; query++)
+		{
+			AABB box = CreateRandomBox(rng, 100.f);
+			box.m_Max += glm::vec3(20.f);
+			CATCH_REQUIRE(QueryOverlap(tree, box) ==
+						  scene.BruteForce([&box](const AABB& other) { return Overlaps(box, other); }));
+
+			const glm::vec3 center = CreateRandomBox(rng, 100.f).m_Min;
+			const float radius = 25.f;
+			std::vector<int32_t> inRadius;
+			tree.QueryRadius(center,
+							 radius,
+							 [&inRadius](int32_t proxyId)
+							 {
+								 inRadius.push_back(proxyId);
+								 return true;
+							 });
+			std::sort(inRadius.begin(), inRadius.end());
+			CATCH_REQUIRE(inRadius == scene.BruteForce(
+										  [&](const AABB& other)
+										  {
+											  return glm::length(glm::clamp(center, other.m_Min, other.m_Max) -
+																 center) <= radius;
+										  }));
+
+			// Closest hit along a ray
+			const glm::vec3 origin = CreateRandomBox(rng, 100.f).m_Min;
+			const glm::vec3 direction = glm::normalize(CreateRandomBox(rng, 1.f).m_Min);
+			int32_t closest = DynamicAABBTree::NULL_NODE;
+			float closestDistance = 300.f;
+			tree.RayCast(origin,
+						 direction,
+						 300.f,
+						 [&](int32_t proxyId, float distance)
+						 {
+							 if (distance < closestDistance)
+							 {
+								 closest = proxyId;
+								 closestDistance = distance;
+							 }
+							 return closestDistance;
+						 });
+
+			int32_t expected = DynamicAABBTree::NULL_NODE;
+			float expectedDistance = 300.f;
+			for (size_t i = 0; i < scene.m_Boxes.size(); i++)
+			{
+				const float distance = BruteForceRayDistance(origin, direction, 300.f, scene.m_Boxes[i]);
+				if (distance >= 0.f && distance < expectedDistance)
+				{
+					expected = scene.m_Proxies[i];
+					expectedDistance = distance;
+				}
+			}
+			CATCH_REQUIRE(closestDistance == Catch::Approx(expectedDistance).margin(1e-3));
+			CATCH_REQUIRE((closest == DynamicAABBTree::NULL_NODE) == (expected == DynamicAABBTree::NULL_NODE));
+		}
+	}
+} // namespace
+
+CATCH_TEST_CASE("DynamicAABBTree")
+{
+	std::mt19937 rng(42);
+
+	CATCH_SECTION("Empty tree")
+	{
+		DynamicAABBTree tree;
+		CATCH_CHECK(tree.Validate());
+		CATCH_CHECK(!tree.GetRootBounds().IsValid());
+		CATCH_CHECK(QueryOverlap(tree, {glm::vec3(-1e6f), glm::vec3(1e6f)}).empty());
+	}
+
+	CATCH_SECTION("Queries match brute force while objects are added, moved and removed")
+	{
+		TestScene scene;
+		for (int i = 0; i < 1000; i++)
+			scene.Add(CreateRandomBox(rng, 100.f));
+
+		CATCH_REQUIRE(scene.m_Tree.Validate());
+		CATCH_CHECK(scene.m_Tree.GetProxyCount() == 1000);
+		// Balanced trees stay close to log2(n)
+		CATCH_CHECK(scene.m_Tree.GetHeight() < 20);
+		CheckQueries(scene, rng);
+
+		std::uniform_real_distribution<float> step(-2.f, 2.f);
+		for (int frame = 0; frame < 10; frame++)
+		{
+			for (size_t i = 0; i < scene.m_Boxes.size(); i += 2)
+				scene.Move(i, glm::vec3(step(rng), step(rng), step(rng)));
+		}
+		CATCH_REQUIRE(scene.m_Tree.Validate());
+		CheckQueries(scene, rng);
+
+		for (int i = 0; i < 500; i++)
+			scene.Remove(rng() % scene.m_Boxes.size());
+		for (int i = 0; i < 200; i++)
+			scene.Add(CreateRandomBox(rng, 100.f));
+		CATCH_REQUIRE(scene.m_Tree.Validate());
+		CATCH_CHECK(scene.m_Tree.GetProxyCount() == 700);
+		CheckQueries(scene, rng);
+
+		// The root contains everything
+		AABB all;
+		for (const AABB& box : scene.m_Boxes)
+			all.Grow(box);
+		const AABB root = scene.m_Tree.GetRootBounds();
+		CATCH_CHECK(glm::all(glm::lessThanEqual(root.m_Min, all.m_Min)));
+		CATCH_CHECK(glm::all(glm::greaterThanEqual(root.m_Max, all.m_Max)));
+	}
+
+	CATCH_SECTION("Small moves stay inside the fat box")
+	{
+		DynamicAABBTree tree(0.5f);
+		const int32_t proxy = tree.CreateProxy({glm::vec3(0.f), glm::vec3(1.f)}, nullptr);
+		tree.CreateProxy({glm::vec3(10.f), glm::vec3(11.f)}, nullptr);
+
+		CATCH_CHECK_FALSE(tree.MoveProxy(proxy, {glm::vec3(0.2f), glm::vec3(1.2f)}));
+		CATCH_CHECK(tree.GetBounds(proxy).m_Min == glm::vec3(0.2f));
+		CATCH_CHECK(tree.MoveProxy(proxy, {glm::vec3(2.f), glm::vec3(3.f)}));
+		CATCH_CHECK(tree.Validate());
+
+		// Queries use the exact bounds, not the fat box
+		CATCH_CHECK(QueryOverlap(tree, {glm::vec3(1.6f), glm::vec3(1.9f)}).empty());
+		CATCH_CHECK(QueryOverlap(tree, {glm::vec3(2.9f), glm::vec3(3.1f)}) == std::vector<int32_t>{proxy});
+	}
+
+	CATCH_SECTION("Queries stop when the callback returns false")
+	{
+		DynamicAABBTree tree;
+		for (int i = 0; i < 100; i++)
+			tree.CreateProxy(CreateRandomBox(rng, 10.f), nullptr);
+
+		int visited = 0;
+		tree.QueryOverlap({glm::vec3(-20.f), glm::vec3(20.f)},
+						  [&visited](int32_t)
+						  {
+							  visited++;
+							  return visited < 5;
+						  });
+		CATCH_CHECK(visited == 5);
+	}
+
+	CATCH_SECTION("Frustum queries match CullingFrustum")
+	{
+		TestScene scene;
+		for (int i = 0; i < 2000; i++)
+			scene.Add(CreateRandomBox(rng, 200.f));
+
+		ViewPyramid pyramid;
+		pyramid.m_TopPlane = glm::vec4(0.f, -1.f, -1.f, 0.f);
+		pyramid.m_BotPlane = glm::vec4(0.f, 1.f, -1.f, 0.f);
+		pyramid.m_LeftPlane = glm::vec4(1.f, 0.f, -1.f, 0.f);
+		pyramid.m_RightPlane = glm::vec4(-1.f, 0.f, -1.f, 0.f);
+		const auto frustum = CullingFrustum::FromViewPyramid(pyramid, glm::vec3(5.f, 0.f, 20.f), 150.f);
+
+		std::vector<int32_t> visible;
+		scene.m_Tree.QueryFrustum(frustum,
+								  [&visible](int32_t proxyId)
+								  {
+									  visible.push_back(proxyId);
+									  return true;
+								  });
+		std::sort(visible.begin(), visible.end());
+
+		const std::vector<int32_t> expected =
+			scene.BruteForce([&frustum](const AABB& box) { return frustum.IsVisible(box); });
+		CATCH_CHECK(!expected.empty());
+		CATCH_CHECK(visible == expected);
+	}
+}
+
+CATCH_TEST_CASE("DynamicAABBTree benchmark", "[.benchmark]")
+{
+	constexpr size_t numObjects = 10000;
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> step(-0.3f, 0.3f);
+
+	TestScene scene;
+	std::vector<glm::vec3> velocities(numObjects);
+	for (size_t i = 0; i < numObjects; i++)
+	{
+		scene.Add(CreateRandomBox(rng, 500.f));
+		velocities[i] = glm::vec3(step(rng), step(rng), step(rng));
+	}
+
+	// A frame of a busy scene: everything moves, then gameplay asks what is near a few things
+	std::vector<AABB> queryBoxes(100);
+	for (AABB& box : queryBoxes)
+	{
+		box = CreateRandomBox(rng, 500.f);
+		box.m_Max += glm::vec3(20.f);
+	}
+
+	CATCH_BENCHMARK("Move 10k objects and run 100 queries")
+	{
+		for (size_t i = 0; i < numObjects; i++)
+			scene.Move(i, velocities[i]);
+
+		size_t found = 0;
+		for (const AABB& box : queryBoxes)
+			found += QueryOverlap(scene.m_Tree, box).size();
+		return found;
+	};
+
+	CATCH_BENCHMARK("Move 10k objects and run 100 queries brute force")
+	{
+		for (size_t i = 0; i < numObjects; i++)
+		{
+			scene.m_Boxes[i].m_Min += velocities[i];
+			scene.m_Boxes[i].m_Max += velocities[i];
+		}
+
+		size_t found = 0;
+		for (const AABB& queryBox : queryBoxes)
+			found += scene.BruteForce([&queryBox](const AABB& box) { return Overlaps(queryBox, box); }).size();
+		return found;
+	};
+
+	CATCH_BENCHMARK("Rebuild 10k objects")
+	{
+		DynamicAABBTree tree;
+		for (const AABB& box : scene.m_Boxes)
+			tree.CreateProxy(box, nullptr);
+		return tree.GetHeight();
+	};
+
+	CATCH_BENCHMARK("1000 overlap queries on 10k objects")
+	{
+		size_t found = 0;
+		for (int i = 0; i < 1000; i++)
+		{
+			const glm::vec3 center = glm::vec3(static_cast<float>(i % 100) * 10.f - 500.f);
+			scene.m_Tree.QueryOverlap({center - glm::vec3(10.f), center + glm::vec3(10.f)},
+									  [&found](int32_t)
+									  {
+										  found++;
+										  return true;
+									  });
+		}
+		return found;
+	};
+
+	CATCH_CHECK(scene.m_Tree.Validate());
+	CATCH_CHECK(scene.m_Tree.GetAreaRatio() > 0.f);
+}
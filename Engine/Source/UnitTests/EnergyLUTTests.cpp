@@ -0,0 +1,197 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "Rendering/EnergyLUT.h"
+#include "ShaderHeaders/BsdfGPU.h"
+
+using namespace Ball;
+using Bsdf::ENERGY_LUT_ETA_SLICES;
+using Bsdf::ENERGY_LUT_SIZE;
+
+namespace
+{
+	// Fewer samples than the shipped tables, the bake has to stay quick in the test run
+	constexpr uint32_t TEST_LUT_SAMPLES = 512;
+
+	// E(mu) of GGX reflection at alpha = 1, D is 1 / pi and the height correlated G2 is 2 * mu * muL / (mu + muL)
+	double ReflectionAlbedoAlphaOne(double mu)
+	{
+		return 1.0 - mu * std::log((1.0 + mu) / mu);
+	}
+
+	// With eta = 1 nothing is reflected and every refraction continues along -V, which leaves G2 / G1 for mu and mu
+	double TransmissionAlbedoEtaOne(double mu, double alpha)
+	{
+		const double s = std::sqrt(mu * mu * (1.0 - alpha * alpha) + alpha * alpha);
+		return (mu + s) / (2.0 * s);
+	}
+
+	MaterialHitData MakeCompensatedMaterial(float alphaRoughness, bool glass)
+	{
+		MaterialHitData material{};
+		material.m_AlphaRoughness = alphaRoughness;
+		material.m_Metallic = glass ? 0.f : 1.f;
+		material.m_TransmissionFactor = glass ? 1.f : 0.f;
+		material.m_Eta = 1.f / 1.5f;
+		material.m_BaseColor = float3(1.f, 1.f, 1.f);
+		material.m_F0 = glass ? float3(0.04f, 0.04f, 0.04f) : float3(1.f, 1.f, 1.f);
+		return material;
+	}
+
+	// Average throughput of a bounce, the way Shade.hlsl weighs PbrSample
+	double EstimateCompensatedAlbedo(const MaterialHitData& material, float mu, int numSamples, uint seed)
+	{
+		const float3 N = float3(0.f, 0.f, 1.f);
+		const float3 V = float3(std::sqrt(1.f - mu * mu), 0.f, mu);
+		double sum = 0.0;
+		for (int i = 0; i < numSamples; i++)
+		{
+			uint isSpecular = 0;
+			bool refracted = false;
+			float3 L = float3(0.f, 0.f, 0.f);
+			float pdf = 0.f;
+			const float3 brdf = Bsdf::PbrSample(material, N, float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f), V,
+												isSpecular, refracted, L, pdf, seed);
+			if (pdf > 0.f)
+				sum += brdf.g * std::abs(L.z) / pdf;
+		}
+		return sum / numSamples;
+	}
+} // namespace
+
+CATCH_TEST_CASE("Energy LUT integration matches analytic limits")
+{
+	constexpr uint32_t NUM_SAMPLES = 4096;
+
+	CATCH_SECTION("Smooth surfaces lose nothing")
+	{
+		for (const float mu : {0.1f, 0.5f, 1.f})
+		{
+			CATCH_CAPTURE(mu);
+			CATCH_CHECK(IntegrateReflectionAlbedo(mu, 0.001f, NUM_SAMPLES) == Catch::Approx(1.f).epsilon(0.002));
+			CATCH_CHECK(IntegrateDielectricAlbedo(mu, 0.001f, 1.5f, NUM_SAMPLES) == Catch::Approx(1.f).epsilon(0.002));
+			CATCH_CHECK(IntegrateDielectricAlbedo(mu, 0.001f, 1.f / 1.5f, NUM_SAMPLES) ==
+						Catch::Approx(1.f).epsilon(0.002));
+		}
+		CATCH_CHECK(IntegrateAverageReflectionAlbedo(0.001f, NUM_SAMPLES) == Catch::Approx(1.f).epsilon(0.002));
+	}
+
+	CATCH_SECTION("Reflection at alpha = 1")
+	{
+		for (const float mu : {0.1f, 0.3f, 0.6f, 1.f})
+		{
+			CATCH_CAPTURE(mu);
+			CATCH_CHECK(IntegrateReflectionAlbedo(mu, 1.f, NUM_SAMPLES) ==
+						Catch::Approx(ReflectionAlbedoAlphaOne(mu)).epsilon(0.005));
+		}
+
+		// E_avg = 2 * integral of E(mu) * mu, midpoint rule
+		constexpr int STEPS = 4096;
+		double average = 0.0;
+		for (int i = 0; i < STEPS; i++)
+		{
+			const double mu = (i + 0.5) / STEPS;
+			average += 2.0 * ReflectionAlbedoAlphaOne(mu) * mu / STEPS;
+		}
+		CATCH_CHECK(IntegrateAverageReflectionAlbedo(1.f, NUM_SAMPLES) == Catch::Approx(average).epsilon(0.005));
+	}
+
+	CATCH_SECTION("Transmission at eta = 1")
+	{
+		for (const float alpha : {0.2f, 0.5f, 1.f})
+		{
+			for (const float mu : {0.2f, 0.5f, 1.f})
+			{
+				CATCH_CAPTURE(alpha, mu);
+				CATCH_CHECK(IntegrateDielectricAlbedo(mu, alpha, 1.f, NUM_SAMPLES) ==
+							Catch::Approx(TransmissionAlbedoEtaOne(mu, alpha)).epsilon(0.001));
+			}
+		}
+	}
+}
+
+CATCH_TEST_CASE("Energy LUT bake")
+{
+	const EnergyLUTs luts = BakeEnergyLUTs(TEST_LUT_SAMPLES);
+	CATCH_REQUIRE(luts.m_Reflection.size() == ENERGY_LUT_SIZE * ENERGY_LUT_SIZE);
+	CATCH_REQUIRE(luts.m_Dielectric.size() == ENERGY_LUT_SIZE * ENERGY_LUT_SIZE * ENERGY_LUT_ETA_SLICES);
+
+	CATCH_SECTION("Same tables on every run")
+	{
+		// The rows run on however many threads are free, the result may not depend on it
+		const EnergyLUTs again = BakeEnergyLUTs(TEST_LUT_SAMPLES);
+		CATCH_CHECK(std::memcmp(luts.m_Reflection.data(), again.m_Reflection.data(),
+								luts.m_Reflection.size() * sizeof(glm::vec2)) == 0);
+		CATCH_CHECK(std::memcmp(luts.m_Dielectric.data(), again.m_Dielectric.data(),
+								luts.m_Dielectric.size() * sizeof(glm::vec2)) == 0);
+	}
+
+	CATCH_SECTION("Entries match the integrators")
+	{
+		const uint32_t last = ENERGY_LUT_SIZE - 1;
+		const glm::vec2 rough = luts.m_Reflection[last * ENERGY_LUT_SIZE + last / 2];
+		const float mu = static_cast<float>(last / 2) / static_cast<float>(last);
+		CATCH_CHECK(rough.x == IntegrateReflectionAlbedo(mu, 1.f, TEST_LUT_SAMPLES));
+		CATCH_CHECK(rough.y == IntegrateAverageReflectionAlbedo(1.f, TEST_LUT_SAMPLES * 4));
+
+		const uint32_t slice = ENERGY_LUT_ETA_SLICES - 1;
+		const glm::vec2 glass = luts.m_Dielectric[(slice * ENERGY_LUT_SIZE + last) * ENERGY_LUT_SIZE + last];
+		CATCH_CHECK(glass.x == IntegrateDielectricAlbedo(1.f, 1.f, Bsdf::EnergyLUTSliceEta(slice), TEST_LUT_SAMPLES));
+	}
+
+	CATCH_SECTION("Rougher reflections lose more energy")
+	{
+		// Not at grazing angles, smooth surfaces are shadowed more there than slightly rough ones
+		for (uint32_t x = ENERGY_LUT_SIZE / 4; x < ENERGY_LUT_SIZE; x++)
+		{
+			for (uint32_t y = 1; y < ENERGY_LUT_SIZE; y++)
+			{
+				const glm::vec2 smooth = luts.m_Reflection[(y - 1) * ENERGY_LUT_SIZE + x];
+				const glm::vec2 rough = luts.m_Reflection[y * ENERGY_LUT_SIZE + x];
+				CATCH_CAPTURE(x, y);
+				CATCH_CHECK(rough.x <= smooth.x + 1e-4f);
+				CATCH_CHECK(rough.x > 0.f);
+				CATCH_CHECK(rough.y <= 1.f + 1e-4f);
+			}
+		}
+	}
+}
+
+CATCH_TEST_CASE("Energy compensation white furnace")
+{
+	constexpr int NUM_SAMPLES = 100000;
+	const EnergyLUTs luts = BakeEnergyLUTs(TEST_LUT_SAMPLES);
+
+	for (const bool glass : {false, true})
+	{
+		for (const float alpha : {0.3f, 0.6f, 1.f})
+		{
+			for (const float mu : {0.3f, 0.7f, 1.f})
+			{
+				const MaterialHitData material = MakeCompensatedMaterial(alpha, glass);
+				const double single = EstimateCompensatedAlbedo(material, mu, NUM_SAMPLES, 41);
+				BindEnergyLUTs(&luts);
+				const double compensated = EstimateCompensatedAlbedo(material, mu, NUM_SAMPLES, 41);
+				BindEnergyLUTs(nullptr);
+
+				CATCH_CAPTURE(glass, alpha, mu, single, compensated);
+				CATCH_CHECK(compensated > single);
+				CATCH_CHECK(compensated == Catch::Approx(1.0).epsilon(0.01));
+			}
+		}
+	}
+}
+
+// Time it takes to bake the shipped tables, run with [.benchmark]
+CATCH_TEST_CASE("Energy LUT bake benchmark", "[.benchmark]")
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	const EnergyLUTs luts = BakeEnergyLUTs();
+	const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+	std::printf("Baked %zu entries in %.1f ms\n", luts.m_Reflection.size() + luts.m_Dielectric.size(),
+				duration.count());
+}
@@ -0,0 +1,323 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Rendering/EnvironmentMap.h"
+#include "ShaderHeaders/RandomGPU.h"
+
+using namespace Ball;
+
+namespace
+{
+	const float3 SUN_DIRECTION = glm::normalize(float3(0.4f, 0.8f, 0.3f));
+
+	// Dim gradient from the horizon up, a small and very bright sun and a black band below the horizon
+	std::vector<float> MakeSunSky(uint32_t width, uint32_t height)
+	{
+		std::vector<float> rgba(static_cast<size_t>(width) * height * 4);
+		for (uint32_t y = 0; y < height; y++)
+		{
+			for (uint32_t x = 0; x < width; x++)
+			{
+				const float2 uv = float2((x + 0.5f) / width, (y + 0.5f) / height);
+				const float3 direction = EnvironmentMap::EnvironmentUVToDirection(uv);
+				float3 radiance = float3(0.2f, 0.3f, 0.5f) * (1.f + direction.y);
+				if (direction.y < -0.5f)
+					radiance = float3(0.f, 0.f, 0.f);
+				if (glm::dot(direction, SUN_DIRECTION) > 0.999f)
+					radiance = float3(5000.f, 4500.f, 4000.f);
+
+				float* texel = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+				texel[0] = radiance.x;
+				texel[1] = radiance.y;
+				texel[2] = radiance.z;
+				texel[3] = 1.f;
+			}
+		}
+		return rgba;
+	}
+
+	float SkyLuminance(const std::vector<float>& rgba, uint32_t width, uint32_t height, float3 direction)
+	{
+		const glm::uvec2 texel = EnvironmentMap::EnvironmentTexel(glm::uvec2(width, height),
+																   EnvironmentMap::DirectionToEnvironmentUV(direction));
+		const float* value = &rgba[(static_cast<size_t>(texel.y) * width + texel.x) * 4];
+		return 0.2126f * value[0] + 0.7152f * value[1] + 0.0722f * value[2];
+	}
+
+	float4 RandomEnvironmentNumbers(uint& seed)
+	{
+		return float4(ShaderRandom::rand(seed), ShaderRandom::rand(seed), ShaderRandom::rand(seed),
+					  ShaderRandom::rand(seed));
+	}
+
+	struct SkyEstimate
+	{
+		double m_Mean = 0.0;
+		double m_Variance = 0.0;
+	};
+
+	SkyEstimate MakeSkyEstimate(double sum, double sumSq, int numSamples)
+	{
+		SkyEstimate estimate;
+		estimate.m_Mean = sum / numSamples;
+		estimate.m_Variance = sumSq / numSamples - estimate.m_Mean * estimate.m_Mean;
+		return estimate;
+	}
+} // namespace
+
+CATCH_TEST_CASE("Alias table picks slots proportional to their weight")
+{
+	const double weights[] = {0.0, 1.0, 2.0, 3.0, 10.0, 0.5};
+	constexpr uint32_t COUNT = 6;
+	std::vector<EnvironmentAliasEntry> entries(COUNT);
+	CATCH_REQUIRE(BuildAliasTable(weights, COUNT, entries.data()) == Catch::Approx(16.5));
+
+	EnvironmentMap::g_EnvironmentDistribution = entries.data();
+	// Evenly spaced numbers hit every slot and its split exactly in proportion
+	constexpr int NUM_SAMPLES = 165000;
+	int picked[COUNT] = {};
+	for (int i = 0; i < NUM_SAMPLES; i++)
+		picked[EnvironmentMap::SampleEnvironmentAlias(0u, COUNT, (i + 0.5f) / NUM_SAMPLES)]++;
+	EnvironmentMap::g_EnvironmentDistribution = nullptr;
+
+	CATCH_CHECK(picked[0] == 0);
+	for (uint32_t i = 0; i < COUNT; i++)
+	{
+		CATCH_CAPTURE(i, picked[i]);
+		CATCH_CHECK(std::abs(picked[i] - weights[i] / 16.5 * NUM_SAMPLES) < 0.001 * NUM_SAMPLES);
+	}
+}
+
+CATCH_TEST_CASE("Environment distribution")
+{
+	constexpr uint32_t WIDTH = 256;
+	constexpr uint32_t HEIGHT = 128;
+	const std::vector<float> sky = MakeSunSky(WIDTH, HEIGHT);
+	const EnvironmentDistribution distribution = BuildEnvironmentDistribution(sky.data(), WIDTH, HEIGHT);
+	CATCH_REQUIRE(distribution.m_Width == WIDTH);
+	CATCH_REQUIRE(distribution.m_Height == HEIGHT);
+	const glm::uvec2 size = glm::uvec2(WIDTH, HEIGHT);
+	BindEnvironmentDistribution(&distribution);
+
+	CATCH_SECTION("Pdf integrates to one over the sphere")
+	{
+		// Four points per texel, the pdf is constant over the UVs of a texel
+		constexpr uint32_t STEPS_U = WIDTH * 2;
+		constexpr uint32_t STEPS_V = HEIGHT * 2;
+		const double cellSolidAngle = 2.0 * EnvironmentMap::ENVIRONMENT_PI * EnvironmentMap::ENVIRONMENT_PI /
+									  (static_cast<double>(STEPS_U) * STEPS_V);
+		double integral = 0.0;
+		for (uint32_t v = 0; v < STEPS_V; v++)
+		{
+			for (uint32_t u = 0; u < STEPS_U; u++)
+			{
+				const float2 uv = float2((u + 0.5f) / STEPS_U, (v + 0.5f) / STEPS_V);
+				const float3 direction = EnvironmentMap::EnvironmentUVToDirection(uv);
+				const double sinTheta = std::sin(uv.y * EnvironmentMap::ENVIRONMENT_PI);
+				integral += EnvironmentMap::EnvironmentPdf(size, direction) * sinTheta * cellSolidAngle;
+			}
+		}
+		CATCH_CHECK(integral == Catch::Approx(1.0).epsilon(1e-3));
+	}
+
+	CATCH_SECTION("Sampled pdf matches the evaluated pdf")
+	{
+		uint seed = 5;
+		for (int i = 0; i < 10000; i++)
+		{
+			float4 r = RandomEnvironmentNumbers(seed);
+			// Away from the texel borders, where rounding may move the direction into the neighbour
+			r.z = 0.05f + 0.9f * r.z;
+			r.w = 0.05f + 0.9f * r.w;
+			float pdf = 0.f;
+			const float3 direction = EnvironmentMap::SampleEnvironment(size, r, pdf);
+			CATCH_CAPTURE(i, direction.x, direction.y, direction.z);
+			CATCH_REQUIRE(glm::length(direction) == Catch::Approx(1.f).epsilon(1e-4));
+			CATCH_REQUIRE(pdf > 0.f);
+			CATCH_REQUIRE(pdf == Catch::Approx(EnvironmentMap::EnvironmentPdf(size, direction)).epsilon(1e-4));
+		}
+	}
+
+	CATCH_SECTION("Samples follow the pdf")
+	{
+		// Bins of 16 x 16 texels, the expected count sums the pdf of the texels in a bin
+		constexpr uint32_t BIN = 16;
+		constexpr uint32_t BINS_X = WIDTH / BIN;
+		constexpr uint32_t BINS_Y = HEIGHT / BIN;
+		constexpr int NUM_SAMPLES = 400000;
+		std::vector<double> expected(BINS_X * BINS_Y, 0.0);
+		for (uint32_t y = 0; y < HEIGHT; y++)
+		{
+			for (uint32_t x = 0; x < WIDTH; x++)
+			{
+				const double texelProbability = distribution.m_Entries[HEIGHT + y * WIDTH + x].m_Pdf / (WIDTH * HEIGHT);
+				expected[(y / BIN) * BINS_X + x / BIN] += texelProbability * NUM_SAMPLES;
+			}
+		}
+
+		std::vector<int> observed(BINS_X * BINS_Y, 0);
+		uint seed = 9;
+		for (int i = 0; i < NUM_SAMPLES; i++)
+		{
+			float pdf = 0.f;
+			const float3 direction = EnvironmentMap::SampleEnvironment(size, RandomEnvironmentNumbers(seed), pdf);
+			const float2 uv = EnvironmentMap::DirectionToEnvironmentUV(direction);
+			const glm::uvec2 texel = EnvironmentMap::EnvironmentTexel(size, uv);
+			observed[(texel.y / BIN) * BINS_X + texel.x / BIN]++;
+		}
+
+		for (uint32_t bin = 0; bin < BINS_X * BINS_Y; bin++)
+		{
+			CATCH_CAPTURE(bin, observed[bin], expected[bin]);
+			if (expected[bin] == 0.0)
+				CATCH_CHECK(observed[bin] == 0);
+			else
+				CATCH_CHECK(std::abs(observed[bin] - expected[bin]) < 5.0 * std::sqrt(expected[bin]) + 1.0);
+		}
+	}
+
+	CATCH_SECTION("Importance sampling and MIS lower the variance of the irradiance")
+	{
+		// Irradiance of a surface facing up, the integral of the luminance times the cosine
+		constexpr uint32_t STEPS_U = WIDTH * 4;
+		constexpr uint32_t STEPS_V = HEIGHT * 4;
+		const double cellArea = 2.0 * EnvironmentMap::ENVIRONMENT_PI * EnvironmentMap::ENVIRONMENT_PI /
+								(static_cast<double>(STEPS_U) * STEPS_V);
+		double reference = 0.0;
+		for (uint32_t v = 0; v < STEPS_V; v++)
+		{
+			for (uint32_t u = 0; u < STEPS_U; u++)
+			{
+				const float2 uv = float2((u + 0.5f) / STEPS_U, (v + 0.5f) / STEPS_V);
+				const float3 direction = EnvironmentMap::EnvironmentUVToDirection(uv);
+				if (direction.y > 0.f)
+				{
+					const double sinTheta = std::sin(uv.y * EnvironmentMap::ENVIRONMENT_PI);
+					reference += SkyLuminance(sky, WIDTH, HEIGHT, direction) * direction.y * sinTheta * cellArea;
+				}
+			}
+		}
+
+		constexpr int NUM_SAMPLES = 200000;
+		const float invPi = 1.f / EnvironmentMap::ENVIRONMENT_PI;
+		uint seed = 13;
+		double sums[3] = {};
+		double sumsSq[3] = {};
+		for (int i = 0; i < NUM_SAMPLES; i++)
+		{
+			// Cosine weighted hemisphere around +y
+			const float r0 = ShaderRandom::rand(seed);
+			const float r1 = ShaderRandom::rand(seed);
+			const float cosTheta = std::sqrt(1.f - r0);
+			const float sinTheta = std::sqrt(r0);
+			const float phi = 2.f * EnvironmentMap::ENVIRONMENT_PI * r1;
+			const float3 cosineDirection = float3(sinTheta * std::cos(phi), cosTheta, sinTheta * std::sin(phi));
+			const float cosinePdf = cosTheta * invPi;
+			const double cosineValue = SkyLuminance(sky, WIDTH, HEIGHT, cosineDirection) * cosTheta;
+
+			float environmentPdf = 0.f;
+			const float3 environmentDirection =
+				EnvironmentMap::SampleEnvironment(size, RandomEnvironmentNumbers(seed), environmentPdf);
+			double environmentValue = 0.0;
+			if (environmentDirection.y > 0.f)
+				environmentValue = SkyLuminance(sky, WIDTH, HEIGHT, environmentDirection) * environmentDirection.y;
+
+			// One sample of each for MIS, the way Shade.hlsl and DirectIllumination.hlsl split it
+			const float cosineWeight =
+				EnvironmentMap::EnvironmentMISWeight(cosinePdf, EnvironmentMap::EnvironmentPdf(size, cosineDirection));
+			const float environmentWeight =
+				EnvironmentMap::EnvironmentMISWeight(environmentPdf, std::max(environmentDirection.y, 0.f) * invPi);
+			const double estimates[3] = {
+				cosineValue / cosinePdf,
+				environmentValue / environmentPdf,
+				cosineValue / cosinePdf * cosineWeight + environmentValue / environmentPdf * environmentWeight};
+			for (int j = 0; j < 3; j++)
+			{
+				sums[j] += estimates[j];
+				sumsSq[j] += estimates[j] * estimates[j];
+			}
+		}
+
+		const SkyEstimate cosine = MakeSkyEstimate(sums[0], sumsSq[0], NUM_SAMPLES);
+		const SkyEstimate environment = MakeSkyEstimate(sums[1], sumsSq[1], NUM_SAMPLES);
+		const SkyEstimate mis = MakeSkyEstimate(sums[2], sumsSq[2], NUM_SAMPLES);
+		CATCH_CAPTURE(reference, cosine.m_Mean, environment.m_Mean, mis.m_Mean);
+		CATCH_CAPTURE(cosine.m_Variance, environment.m_Variance, mis.m_Variance);
+		for (const SkyEstimate& estimate : {cosine, environment, mis})
+			CATCH_CHECK(std::abs(estimate.m_Mean - reference) < 4.0 * std::sqrt(estimate.m_Variance / NUM_SAMPLES));
+		CATCH_CHECK(environment.m_Variance < 0.01 * cosine.m_Variance);
+		CATCH_CHECK(mis.m_Variance < 0.01 * cosine.m_Variance);
+	}
+
+	BindEnvironmentDistribution(nullptr);
+}
+
+CATCH_TEST_CASE("Environment distribution build")
+{
+	CATCH_SECTION("Large HDRIs are averaged down")
+	{
+		constexpr uint32_t WIDTH = 2000;
+		constexpr uint32_t HEIGHT = 1000;
+		const std::vector<float> sky = MakeSunSky(WIDTH, HEIGHT);
+		const EnvironmentDistribution distribution = BuildEnvironmentDistribution(sky.data(), WIDTH, HEIGHT, 512);
+		// Factor 4, the last column and row cover what is left
+		CATCH_CHECK(distribution.m_Width == 500);
+		CATCH_CHECK(distribution.m_Height == 250);
+		CATCH_CHECK(distribution.m_Entries.size() == 250 + 500 * 250);
+
+		double probability = 0.0;
+		for (uint32_t i = 0; i < distribution.m_Width * distribution.m_Height; i++)
+			probability += distribution.m_Entries[distribution.m_Height + i].m_Pdf;
+		CATCH_CHECK(probability / (distribution.m_Width * distribution.m_Height) == Catch::Approx(1.0).epsilon(1e-4));
+
+		// The same on every run, no matter how the rows were spread over the threads
+		const EnvironmentDistribution again = BuildEnvironmentDistribution(sky.data(), WIDTH, HEIGHT, 512);
+		CATCH_CHECK(std::memcmp(distribution.m_Entries.data(), again.m_Entries.data(),
+								distribution.m_Entries.size() * sizeof(EnvironmentAliasEntry)) == 0);
+	}
+
+	CATCH_SECTION("Black HDRIs are sampled uniformly")
+	{
+		constexpr uint32_t WIDTH = 64;
+		constexpr uint32_t HEIGHT = 32;
+		const std::vector<float> black(WIDTH * HEIGHT * 4, 0.f);
+		const EnvironmentDistribution distribution = BuildEnvironmentDistribution(black.data(), WIDTH, HEIGHT);
+		BindEnvironmentDistribution(&distribution);
+		const glm::uvec2 size = glm::uvec2(WIDTH, HEIGHT);
+		// Texel centres, the density of a texel follows sin(theta) of its centre
+		const float2 centres[] = {
+			float2(0.5f, 15.5f / HEIGHT), float2(0.3f, 10.5f / HEIGHT), float2(0.9f, 4.5f / HEIGHT)};
+		for (const float2 uv : centres)
+		{
+			const float3 direction = EnvironmentMap::EnvironmentUVToDirection(uv);
+			CATCH_CHECK(EnvironmentMap::EnvironmentPdf(size, direction) ==
+						Catch::Approx(0.25f / EnvironmentMap::ENVIRONMENT_PI).epsilon(0.01));
+		}
+		BindEnvironmentDistribution(nullptr);
+	}
+}
+
+// Build time of the distribution of an 8K HDRI, run with [.benchmark]
+CATCH_TEST_CASE("Environment distribution benchmark", "[.benchmark]")
+{
+	constexpr uint32_t WIDTH = 8192;
+	constexpr uint32_t HEIGHT = 4096;
+	const std::vector<float> sky = MakeSunSky(WIDTH, HEIGHT);
+
+	for (const uint32_t maxWidth : {1024u, 2048u, 8192u})
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		const EnvironmentDistribution distribution = BuildEnvironmentDistribution(sky.data(), WIDTH, HEIGHT, maxWidth);
+		const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+		std::printf("8K HDRI to %u x %u: %.1f ms, %.1f MB\n",
+					distribution.m_Width,
+					distribution.m_Height,
+					duration.count(),
+					distribution.m_Entries.size() * sizeof(EnvironmentAliasEntry) / (1024.0 * 1024.0));
+	}
+}
@@ -0,0 +1,204 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include "GameObjects/Serialization/ObjectSerializer.h"
+
+using namespace Ball;
+
+namespace
+{
+	struct FieldTableTestOffset
+	{
+		glm::vec3 m_Offset = glm::vec3(0.f);
+		static constexpr auto GetFieldTable() { return MakeFieldTable(FIELD(FieldTableTestOffset, m_Offset)); }
+	};
+
+	struct FieldTableTestSettings
+	{
+		std::string m_Name = "Default";
+		int m_Count = 3;
+		float m_Speed = 1.f;
+		FieldTableTestOffset m_Offset;
+
+		static constexpr auto GetFieldTable()
+		{
+			return MakeFieldTable(FIELD(FieldTableTestSettings, m_Name),
+								  FIELD(FieldTableTestSettings, m_Count),
+								  FIELD(FieldTableTestSettings, m_Speed),
+								  FIELD(FieldTableTestSettings, m_Offset));
+		}
+
+		// Same fields through the string based path
+		void SerializeWithStrings(SerializeArchive& archive)
+		{
+			archive.Add(ARCHIVE_VAR(m_Name));
+			archive.Add(ARCHIVE_VAR(m_Count));
+			archive.Add(ARCHIVE_VAR(m_Speed));
+			archive.Add(ARCHIVE_VAR(m_Offset));
+		}
+	};
+
+	// A later version of the settings, m_Speed got renamed and m_Count removed
+	struct FieldTableTestSettingsV2
+	{
+		std::string m_Name = "Default";
+		float m_MoveSpeed = 1.f;
+		bool m_Enabled = true;
+
+		static constexpr auto GetFieldTable()
+		{
+			return MakeFieldTable(FIELD(FieldTableTestSettingsV2, m_Name),
+								  FIELD_RENAMED(FieldTableTestSettingsV2, m_MoveSpeed, "m_Speed"),
+								  FIELD(FieldTableTestSettingsV2, m_Enabled));
+		}
+	};
+
+	// Tables are built at compile time
+	constexpr auto TEST_FIELDS = FieldTableTestSettings::GetFieldTable();
+	static_assert(std::tuple_size_v<decltype(TEST_FIELDS)> == 4);
+	static_assert(std::get<2>(TEST_FIELDS).m_NameHash == HashFieldName("Speed"));
+	static_assert(std::get<1>(TEST_FIELDS).m_Type == FieldType::INT);
+	static_assert(std::get<3>(TEST_FIELDS).m_Type == FieldType::OBJECT);
+	static_assert(HasUniqueFieldNames(TEST_FIELDS));
+	static_assert(!HasUniqueFieldNames(
+		MakeFieldTable(FIELD(FieldTableTestSettings, m_Name), FIELD(FieldTableTestSettings, m_Name))));
+
+	template<typename T>
+	nlohmann::ordered_json Save(T& object)
+	{
+		nlohmann::ordered_json data;
+		SerializeArchive archive(SerializeArchiveType::SAVE_DATA, &data);
+		archive.AddFields(object);
+		return data;
+	}
+
+	template<typename T>
+	T Load(nlohmann::ordered_json data)
+	{
+		T object;
+		SerializeArchive archive(SerializeArchiveType::LOAD_DATA, &data);
+		archive.AddFields(object);
+		return object;
+	}
+} // namespace
+
+CATCH_TEST_CASE("FieldTable")
+{
+	FieldTableTestSettings settings;
+	settings.m_Name = "Saved";
+	settings.m_Count = 7;
+	settings.m_Speed = 2.5f;
+	settings.m_Offset.m_Offset = glm::vec3(1.f, 2.f, 3.f);
+
+	CATCH_SECTION("Saves the same data as the string based serialization")
+	{
+		nlohmann::ordered_json stringData;
+		SerializeArchive archive(SerializeArchiveType::SAVE_DATA, &stringData);
+		settings.SerializeWithStrings(archive);
+
+		const nlohmann::ordered_json tableData = Save(settings);
+		CATCH_CHECK(tableData == stringData);
+		CATCH_CHECK(tableData["m_Offset"]["m_Offset"] == nlohmann::ordered_json({1.f, 2.f, 3.f}));
+	}
+
+	CATCH_SECTION("Round trip")
+	{
+		const FieldTableTestSettings loaded = Load<FieldTableTestSettings>(Save(settings));
+		CATCH_CHECK(loaded.m_Name == "Saved");
+		CATCH_CHECK(loaded.m_Count == 7);
+		CATCH_CHECK(loaded.m_Speed == 2.5f);
+		CATCH_CHECK(loaded.m_Offset.m_Offset == glm::vec3(1.f, 2.f, 3.f));
+	}
+
+	CATCH_SECTION("Missing fields keep their default")
+	{
+		nlohmann::ordered_json data = Save(settings);
+		data.erase("m_Count");
+		const FieldTableTestSettings loaded = Load<FieldTableTestSettings>(data);
+		CATCH_CHECK(loaded.m_Count == 3);
+		CATCH_CHECK(loaded.m_Name == "Saved");
+	}
+
+	CATCH_SECTION("Renamed fields load from old files, removed fields are ignored")
+	{
+		const FieldTableTestSettingsV2 loaded = Load<FieldTableTestSettingsV2>(Save(settings));
+		CATCH_CHECK(loaded.m_Name == "Saved");
+		CATCH_CHECK(loaded.m_MoveSpeed == 2.5f);
+		CATCH_CHECK(loaded.m_Enabled);
+
+		FieldTableTestSettingsV2 upgraded = loaded;
+		const nlohmann::ordered_json data = Save(upgraded);
+		CATCH_CHECK(data.contains("m_MoveSpeed"));
+		CATCH_CHECK_FALSE(data.contains("m_Speed"));
+		CATCH_CHECK_FALSE(data.contains("m_Count"));
+
+		// The new name wins when a file has both
+		nlohmann::ordered_json both = data;
+		both["m_MoveSpeed"] = 4.f;
+		both["m_Speed"] = 8.f;
+		CATCH_CHECK(Load<FieldTableTestSettingsV2>(both).m_MoveSpeed == 4.f);
+	}
+
+	CATCH_SECTION("Fields can be found by name")
+	{
+		bool visited = VisitField(settings,
+								  "m_Speed",
+								  [](const auto& field, auto& value)
+								  {
+									  CATCH_CHECK(std::string(field.m_PrefabName) == "Speed");
+									  if constexpr (std::is_same_v<std::decay_t<decltype(value)>, float>)
+										  value = 5.f;
+								  });
+		CATCH_CHECK(visited);
+		CATCH_CHECK(settings.m_Speed == 5.f);
+		CATCH_CHECK(VisitField(settings, "Count", [](const auto&, auto&) {}));
+		CATCH_CHECK_FALSE(VisitField(settings, "m_Missing", [](const auto&, auto&) {}));
+	}
+}
+
+CATCH_TEST_CASE("FieldTable benchmark", "[.benchmark]")
+{
+	std::vector<FieldTableTestSettings> objects(1000);
+
+	CATCH_BENCHMARK("Save with strings")
+	{
+		nlohmann::ordered_json data;
+		for (FieldTableTestSettings& object : objects)
+		{
+			nlohmann::ordered_json objectData;
+			SerializeArchive archive(SerializeArchiveType::SAVE_DATA, &objectData);
+			object.SerializeWithStrings(archive);
+			data.push_back(std::move(objectData));
+		}
+		return data;
+	};
+
+	CATCH_BENCHMARK("Save with field table")
+	{
+		nlohmann::ordered_json data;
+		for (FieldTableTestSettings& object : objects)
+			data.push_back(Save(object));
+		return data;
+	};
+
+	nlohmann::ordered_json saved = Save(objects[0]);
+
+	CATCH_BENCHMARK("Load with strings")
+	{
+		for (FieldTableTestSettings& object : objects)
+		{
+			SerializeArchive archive(SerializeArchiveType::LOAD_DATA, &saved);
+			object.SerializeWithStrings(archive);
+		}
+		return objects[0].m_Count;
+	};
+
+	CATCH_BENCHMARK("Load with field table")
+	{
+		for (FieldTableTestSettings& object : objects)
+		{
+			SerializeArchive archive(SerializeArchiveType::LOAD_DATA, &saved);
+			archive.AddFields(object);
+		}
+		return objects[0].m_Count;
+	};
+}
@@ -1,6 +1,10 @@
 #include <Catch2/catch_amalgamated.hpp>
 
+#include <cstring>
+#include <thread>
+
 #include "FileIO.h"
+#include "FileReadBatch.h"
 
 using namespace Ball;
 using namespace Catch::Matchers;
@@ -82,4 +86,366 @@ CATCH_TEST_CASE("FileIO")
 		if (FileIO::Exist(FileIO::TempData, BINARY_FILE_PATH))
 			FileIO::Delete(FileIO::TempData, BINARY_FILE_PATH);
 	}
-}
\ No newline at end of file
+}
+
+namespace
+{
+	// Every byte depends on its offset and the seed, so misplaced or mixed up data is detected
+	std::vector<uint8_t> MakeFileData(size_t size, uint32_t seed)
+	{
+		std::vector<uint8_t> data(size);
+		uint32_t state = seed * 2654435761u + 1;
+		for (size_t i = 0; i < size; i++)
+		{
+			state = state * 1664525u + 1013904223u;
+			data[i] = static_cast<uint8_t>(state >> 24);
+		}
+		return data;
+	}
+
+	std::string MakeTestFileName(const char* name, size_t index)
+	{
+		return std::string("FileIOTest_") + name + "_" + std::to_string(index) + ".bin";
+	}
+} // namespace
+
+CATCH_TEST_CASE("FileIO memory mapping")
+{
+	CATCH_SECTION("Mapping shows the file content")
+	{
+		const std::vector<uint8_t> data = MakeFileData(100000, 1);
+		const std::string path = MakeTestFileName("Mapped", 0);
+		CATCH_REQUIRE(FileIO::WriteBinary(FileIO::TempData, path, data.data(), data.size()));
+
+		{
+			MappedFile mapping = FileIO::MapReadOnly(FileIO::TempData, path);
+			CATCH_REQUIRE(mapping.IsValid());
+			CATCH_REQUIRE(mapping.GetSize() == data.size());
+			CATCH_CHECK(memcmp(mapping.GetData(), data.data(), data.size()) == 0);
+
+			// Ownership moves with the object
+			MappedFile moved = std::move(mapping);
+			CATCH_CHECK_FALSE(mapping.IsValid());
+			CATCH_CHECK(mapping.GetData() == nullptr);
+			CATCH_REQUIRE(moved.IsValid());
+			CATCH_CHECK(moved.GetData()[data.size() - 1] == data.back());
+		}
+
+		// Unmapped, so the file can be deleted again
+		CATCH_CHECK(FileIO::Delete(FileIO::TempData, path));
+	}
+
+	CATCH_SECTION("Missing and empty files")
+	{
+		CATCH_CHECK_FALSE(FileIO::MapReadOnly(FileIO::TempData, MakeTestFileName("Missing", 0)).IsValid());
+
+		const std::string path = MakeTestFileName("Empty", 0);
+		CATCH_REQUIRE(FileIO::Write(FileIO::TempData, path, ""));
+		{
+			MappedFile mapping = FileIO::MapReadOnly(FileIO::TempData, path);
+			CATCH_CHECK(mapping.IsValid());
+			CATCH_CHECK(mapping.GetSize() == 0);
+		}
+		FileIO::Delete(FileIO::TempData, path);
+	}
+}
+
+CATCH_TEST_CASE("FileIO async reads")
+{
+	CATCH_SECTION("Batch of files and ranges")
+	{
+		// More requests than the io_uring backend keeps in flight
+		constexpr size_t NUM_FILES = 100;
+		std::vector<std::vector<uint8_t>> files;
+		std::vector<FileReadRequest> requests;
+		std::vector<std::vector<uint8_t>> buffers(NUM_FILES + 1);
+		for (size_t i = 0; i < NUM_FILES; i++)
+		{
+			files.push_back(MakeFileData(1000 + i * 37, static_cast<uint32_t>(i)));
+			CATCH_REQUIRE(FileIO::WriteBinary(
+				FileIO::TempData, MakeTestFileName("Async", i), files.back().data(), files.back().size()));
+
+			// Odd files are read from an offset
+			const size_t offset = (i % 2) * 100;
+			buffers[i].resize(files.back().size() - offset);
+			requests.push_back({FileIO::TempData, MakeTestFileName("Async", i), offset, buffers[i].data(),
+								buffers[i].size()});
+		}
+		// A missing file only fails its own request
+		buffers[NUM_FILES].resize(16);
+		requests.push_back({FileIO::TempData, MakeTestFileName("Missing", 0), 0, buffers[NUM_FILES].data(), 16});
+
+		std::shared_ptr<FileReadBatch> batch = FileIO::ReadAsync(std::move(requests));
+		batch->Wait();
+		CATCH_REQUIRE(batch->IsComplete());
+		CATCH_CHECK_FALSE(batch->AllSucceeded());
+
+		const std::vector<FileReadRequest>& results = batch->GetRequests();
+		CATCH_REQUIRE(results.size() == NUM_FILES + 1);
+		for (size_t i = 0; i < NUM_FILES; i++)
+		{
+			const size_t offset = (i % 2) * 100;
+			CATCH_CHECK(results[i].m_Succeeded);
+			CATCH_CHECK(results[i].m_BytesRead == files[i].size() - offset);
+			CATCH_CHECK(memcmp(buffers[i].data(), files[i].data() + offset, buffers[i].size()) == 0);
+		}
+		CATCH_CHECK_FALSE(results[NUM_FILES].m_Succeeded);
+
+		for (size_t i = 0; i < NUM_FILES; i++)
+			FileIO::Delete(FileIO::TempData, MakeTestFileName("Async", i));
+	}
+
+	CATCH_SECTION("Reading past the end")
+	{
+		const std::vector<uint8_t> data = MakeFileData(64, 3);
+		const std::string path = MakeTestFileName("Short", 0);
+		CATCH_REQUIRE(FileIO::WriteBinary(FileIO::TempData, path, data.data(), data.size()));
+
+		std::vector<uint8_t> buffer(128);
+		std::shared_ptr<FileReadBatch> batch =
+			FileIO::ReadAsync({{FileIO::TempData, path, 32, buffer.data(), buffer.size()}});
+		batch->Wait();
+		CATCH_CHECK_FALSE(batch->GetRequests()[0].m_Succeeded);
+		CATCH_CHECK(batch->GetRequests()[0].m_BytesRead == 32);
+		CATCH_CHECK(memcmp(buffer.data(), data.data() + 32, 32) == 0);
+
+		FileIO::Delete(FileIO::TempData, path);
+	}
+
+	CATCH_SECTION("Empty batches complete right away")
+	{
+		std::shared_ptr<FileReadBatch> batch = FileIO::ReadAsync({});
+		CATCH_CHECK(batch->IsComplete());
+		CATCH_CHECK(batch->AllSucceeded());
+	}
+}
+
+CATCH_TEST_CASE("FileIO concurrency")
+{
+	CATCH_SECTION("Threads writing and reading their own files")
+	{
+		constexpr size_t NUM_THREADS = 8;
+		constexpr int NUM_ITERATIONS = 20;
+		std::vector<int> failures(NUM_THREADS, 0);
+
+		std::vector<std::thread> threads;
+		for (size_t thread = 0; thread < NUM_THREADS; thread++)
+		{
+			threads.emplace_back(
+				[thread, &failures]()
+				{
+					const std::string path = MakeTestFileName("Thread", thread);
+					for (int i = 0; i < NUM_ITERATIONS; i++)
+					{
+						const std::vector<uint8_t> data =
+							MakeFileData(4096 + i, static_cast<uint32_t>(thread * NUM_ITERATIONS + i));
+						std::vector<uint8_t> read(data.size());
+						if (!FileIO::WriteBinary(FileIO::TempData, path, data.data(), data.size()) ||
+							!FileIO::ReadBinary(FileIO::TempData, path, read.data(), read.size()) || read != data)
+						{
+							failures[thread]++;
+						}
+					}
+					FileIO::Delete(FileIO::TempData, path);
+				});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+
+		for (size_t thread = 0; thread < NUM_THREADS; thread++)
+			CATCH_CHECK(failures[thread] == 0);
+	}
+
+	CATCH_SECTION("Concurrent writes to one file leave one complete version")
+	{
+		constexpr uint32_t NUM_THREADS = 8;
+		constexpr size_t FILE_SIZE = 256 * 1024;
+		const std::string path = MakeTestFileName("Shared", 0);
+
+		std::vector<std::thread> threads;
+		for (uint32_t thread = 0; thread < NUM_THREADS; thread++)
+		{
+			threads.emplace_back(
+				[thread, &path]()
+				{
+					const std::vector<uint8_t> data = MakeFileData(FILE_SIZE, thread);
+					for (int i = 0; i < 5; i++)
+						FileIO::WriteBinary(FileIO::TempData, path, data.data(), data.size());
+				});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+
+		// Data written by different threads never ends up interleaved
+		std::vector<uint8_t> read(FILE_SIZE);
+		CATCH_REQUIRE(FileIO::GetSize(FileIO::TempData, path) == FILE_SIZE);
+		CATCH_REQUIRE(FileIO::ReadBinary(FileIO::TempData, path, read.data(), read.size()));
+		bool matchesOneWriter = false;
+		for (uint32_t thread = 0; thread < NUM_THREADS; thread++)
+			matchesOneWriter |= read == MakeFileData(FILE_SIZE, thread);
+		CATCH_CHECK(matchesOneWriter);
+
+		// No temporary files are left behind
+		for (const std::string& file : FileIO::GetDirectoryContent(FileIO::TempData, ""))
+			CATCH_CHECK(file.find(".tmp") == std::string::npos);
+
+		FileIO::Delete(FileIO::TempData, path);
+	}
+}
+
+CATCH_TEST_CASE("FileIO crash safety")
+{
+	const std::string path = MakeTestFileName("Save", 0);
+	const std::string original = "{\"level\": \"original\"}";
+	CATCH_REQUIRE(FileIO::Write(FileIO::TempData, path, original));
+
+	CATCH_SECTION("A write that never finished leaves the file alone")
+	{
+		// What a crash during a write leaves behind: a partial temporary file next to the target
+		const std::string tempPath = path + ".0.0.tmp";
+		CATCH_REQUIRE(FileIO::Write(FileIO::TempData, tempPath, "{\"level\": \"repl", true));
+		CATCH_CHECK(FileIO::Read(FileIO::TempData, path) == original);
+
+		// The next write replaces the file completely
+		const std::string replacement = "{\"level\": \"replacement\"}";
+		CATCH_REQUIRE(FileIO::Write(FileIO::TempData, path, replacement));
+		CATCH_CHECK(FileIO::Read(FileIO::TempData, path) == replacement);
+
+		FileIO::Delete(FileIO::TempData, tempPath);
+	}
+
+	CATCH_SECTION("A failed write cleans up after itself")
+	{
+		// A directory can't be replaced by a file, the rename fails
+		const std::string directory = "FileIOTest_Directory";
+		CATCH_REQUIRE(FileIO::Write(FileIO::TempData, directory + "/" + path, original));
+		CATCH_CHECK_FALSE(FileIO::Write(FileIO::TempData, directory, "new"));
+
+		for (const std::string& file : FileIO::GetDirectoryContent(FileIO::TempData, ""))
+			CATCH_CHECK(file.find(".tmp") == std::string::npos);
+		CATCH_CHECK(FileIO::Read(FileIO::TempData, directory + "/" + path) == original);
+
+		FileIO::Delete(FileIO::TempData, directory + "/" + path);
+	}
+
+	CATCH_SECTION("Shorter data truncates the file")
+	{
+		CATCH_REQUIRE(FileIO::Write(FileIO::TempData, path, "{}"));
+		CATCH_CHECK(FileIO::Read(FileIO::TempData, path) == "{}");
+	}
+
+	FileIO::Delete(FileIO::TempData, path);
+}
+
+CATCH_TEST_CASE("FileIO large files")
+{
+	// About the size of a large glTF buffer or HDR environment map
+	constexpr size_t FILE_SIZE = 48 * 1024 * 1024;
+	constexpr size_t CHUNK_SIZE = 4 * 1024 * 1024;
+	const std::string path = MakeTestFileName("Large", 0);
+	const std::vector<uint8_t> data = MakeFileData(FILE_SIZE, 7);
+	CATCH_REQUIRE(FileIO::WriteBinary(FileIO::TempData, path, data.data(), data.size()));
+	CATCH_REQUIRE(FileIO::GetSize(FileIO::TempData, path) == FILE_SIZE);
+
+	CATCH_SECTION("ReadBinary")
+	{
+		std::vector<uint8_t> read(FILE_SIZE);
+		CATCH_REQUIRE(FileIO::ReadBinary(FileIO::TempData, path, read.data(), read.size()));
+		CATCH_CHECK(read == data);
+	}
+
+	CATCH_SECTION("MapReadOnly")
+	{
+		MappedFile mapping = FileIO::MapReadOnly(FileIO::TempData, path);
+		CATCH_REQUIRE(mapping.IsValid());
+		CATCH_REQUIRE(mapping.GetSize() == FILE_SIZE);
+		CATCH_CHECK(memcmp(mapping.GetData(), data.data(), FILE_SIZE) == 0);
+	}
+
+	CATCH_SECTION("ReadAsync in chunks")
+	{
+		std::vector<uint8_t> read(FILE_SIZE);
+		std::vector<FileReadRequest> requests;
+		for (size_t offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE)
+			requests.push_back({FileIO::TempData, path, offset, read.data() + offset, CHUNK_SIZE});
+
+		std::shared_ptr<FileReadBatch> batch = FileIO::ReadAsync(std::move(requests));
+		batch->Wait();
+		CATCH_CHECK(batch->AllSucceeded());
+		CATCH_CHECK(read == data);
+	}
+
+	FileIO::Delete(FileIO::TempData, path);
+}
+
+CATCH_TEST_CASE("FileIO benchmark", "[.benchmark]")
+{
+	// About the size of the glTF buffers of a level
+	constexpr size_t FILE_SIZE = 32 * 1024 * 1024;
+	constexpr size_t NUM_SMALL_FILES = 64;
+	constexpr size_t SMALL_FILE_SIZE = 64 * 1024;
+	const std::string path = MakeTestFileName("Benchmark", 0);
+	const std::vector<uint8_t> data = MakeFileData(FILE_SIZE, 11);
+	CATCH_REQUIRE(FileIO::WriteBinary(FileIO::TempData, path, data.data(), data.size()));
+	for (size_t i = 0; i < NUM_SMALL_FILES; i++)
+	{
+		const uint8_t* smallData = data.data() + i * SMALL_FILE_SIZE;
+		CATCH_REQUIRE(
+			FileIO::WriteBinary(FileIO::TempData, MakeTestFileName("BenchmarkSmall", i), smallData, SMALL_FILE_SIZE));
+	}
+
+	std::vector<uint8_t> buffer(FILE_SIZE);
+	const auto checksum = [](const uint8_t* bytes, size_t size)
+	{
+		// Touches every page, a mapping would otherwise not load anything
+		uint64_t sum = 0;
+		for (size_t i = 0; i < size; i += 4096)
+			sum += bytes[i];
+		return sum;
+	};
+
+	CATCH_BENCHMARK("32MB Read (fstream into string)")
+	{
+		const std::string read = FileIO::Read(FileIO::TempData, path);
+		return checksum(reinterpret_cast<const uint8_t*>(read.data()), read.size());
+	};
+
+	CATCH_BENCHMARK("32MB ReadBinary")
+	{
+		FileIO::ReadBinary(FileIO::TempData, path, buffer.data(), buffer.size());
+		return checksum(buffer.data(), buffer.size());
+	};
+
+	CATCH_BENCHMARK("32MB MapReadOnly")
+	{
+		MappedFile mapping = FileIO::MapReadOnly(FileIO::TempData, path);
+		return checksum(mapping.GetData(), mapping.GetSize());
+	};
+
+	CATCH_BENCHMARK("64 x 64KB ReadBinary")
+	{
+		for (size_t i = 0; i < NUM_SMALL_FILES; i++)
+		{
+			uint8_t* target = buffer.data() + i * SMALL_FILE_SIZE;
+			FileIO::ReadBinary(FileIO::TempData, MakeTestFileName("BenchmarkSmall", i), target, SMALL_FILE_SIZE);
+		}
+		return checksum(buffer.data(), NUM_SMALL_FILES * SMALL_FILE_SIZE);
+	};
+
+	CATCH_BENCHMARK("64 x 64KB ReadAsync")
+	{
+		std::vector<FileReadRequest> requests;
+		for (size_t i = 0; i < NUM_SMALL_FILES; i++)
+		{
+			requests.push_back({FileIO::TempData, MakeTestFileName("BenchmarkSmall", i), 0,
+								buffer.data() + i * SMALL_FILE_SIZE, SMALL_FILE_SIZE});
+		}
+		std::shared_ptr<FileReadBatch> batch = FileIO::ReadAsync(std::move(requests));
+		batch->Wait();
+		return checksum(buffer.data(), NUM_SMALL_FILES * SMALL_FILE_SIZE);
+	};
+
+	FileIO::Delete(FileIO::TempData, path);
+	for (size_t i = 0; i < NUM_SMALL_FILES; i++)
+		FileIO::Delete(FileIO::TempData, MakeTestFileName("BenchmarkSmall", i));
+}
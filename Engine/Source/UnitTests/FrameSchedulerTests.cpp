@@ -0,0 +1,342 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "Rendering/FrameScheduler.h"
+#include "ShaderHeaders/RandomGPU.h"
+
+using namespace Ball;
+
+namespace
+{
+	// GPU that only finishes work when the test says so, waiting on it finishes everything up to the value
+	class ManualGpuTimeline : public IGpuTimeline
+	{
+	public:
+		uint64_t Signal() override { return ++m_Signaled; }
+		uint64_t GetCompletedValue() const override { return m_Completed; }
+		void WaitForValue(uint64_t value) override
+		{
+			m_WaitedFor.push_back(value);
+			m_Completed = (std::max)(m_Completed, value);
+		}
+
+		void Complete(uint64_t value) { m_Completed = (std::max)(m_Completed, value); }
+
+		uint64_t m_Signaled = 0;
+		uint64_t m_Completed = 0;
+		std::vector<uint64_t> m_WaitedFor;
+	};
+
+	// GPU that runs the submitted work back to back on a simulated clock, waiting moves the CPU clock forward
+	class SimulatedGpuTimeline : public IGpuTimeline
+	{
+	public:
+		uint64_t Signal() override
+		{
+			m_GpuFreeMs = (std::max)(m_GpuFreeMs, m_SubmitMs) + m_PendingMs;
+			m_PendingMs = 0.0;
+			m_Completions.push_back(m_GpuFreeMs);
+			return m_Completions.size();
+		}
+		uint64_t GetCompletedValue() const override
+		{
+			return std::upper_bound(m_Completions.begin(), m_Completions.end(), m_NowMs) - m_Completions.begin();
+		}
+		void WaitForValue(uint64_t value) override
+		{
+			if (value > 0)
+				m_NowMs = (std::max)(m_NowMs, m_Completions[value - 1]);
+		}
+
+		// The GPU can't start on a frame before the CPU submitted it
+		void Submit(double gpuMs)
+		{
+			m_SubmitMs = m_NowMs;
+			m_PendingMs += gpuMs;
+		}
+
+		double m_NowMs = 0.0;
+		double m_SubmitMs = 0.0;
+		double m_PendingMs = 0.0;
+		double m_GpuFreeMs = 0.0;
+		std::vector<double> m_Completions;
+	};
+
+	struct SimulatedRun
+	{
+		double m_FrameMs = 0.0; // CPU time between frames
+		double m_LatencyMs = 0.0; // From the start of a frame on the CPU until the GPU finished it
+		double m_WaitMs = 0.0; // CPU time spent blocked on the GPU per frame
+	};
+
+	SimulatedRun SimulateFrames(uint32_t framesInFlight, uint32_t frames, double cpuMs, double gpuMs,
+								double jitter = 0.0, uint32_t seed = 1)
+	{
+		SimulatedGpuTimeline gpu;
+		FrameScheduler scheduler(gpu, framesInFlight);
+		std::vector<double> starts;
+		double waitMs = 0.0;
+		for (uint32_t i = 0; i < frames; i++)
+		{
+			const double before = gpu.m_NowMs;
+			scheduler.BeginFrame();
+			waitMs += gpu.m_NowMs - before;
+			starts.push_back(gpu.m_NowMs);
+
+			gpu.m_NowMs += cpuMs * (1.0 + jitter * (ShaderRandom::rand(seed) - 0.5));
+			gpu.Submit(gpuMs * (1.0 + jitter * (ShaderRandom::rand(seed) - 0.5)));
+			scheduler.EndFrame();
+		}
+		scheduler.WaitForIdle();
+
+		SimulatedRun run;
+		// The first frames fill the pipeline
+		const uint32_t warmup = frames / 4;
+		run.m_FrameMs = (starts.back() - starts[warmup]) / static_cast<double>(frames - 1 - warmup);
+		for (uint32_t i = warmup; i < frames; i++)
+			run.m_LatencyMs += gpu.m_Completions[i] - starts[i];
+		run.m_LatencyMs /= static_cast<double>(frames - warmup);
+		run.m_WaitMs = waitMs / static_cast<double>(frames);
+		return run;
+	}
+} // namespace
+
+CATCH_TEST_CASE("Frame scheduler slots", "[FrameScheduler]")
+{
+	ManualGpuTimeline gpu;
+
+	CATCH_SECTION("The number of frames in flight is clamped")
+	{
+		FrameScheduler scheduler(gpu, 0);
+		CATCH_CHECK(scheduler.GetFramesInFlight() == 1);
+		scheduler.SetFramesInFlight(7);
+		CATCH_CHECK(scheduler.GetFramesInFlight() == FrameScheduler::MAX_FRAMES_IN_FLIGHT);
+	}
+
+	CATCH_SECTION("Slots are handed out in order")
+	{
+		for (uint32_t framesInFlight = 1; framesInFlight <= FrameScheduler::MAX_FRAMES_IN_FLIGHT; framesInFlight++)
+		{
+			CATCH_INFO("Frames in flight: " << framesInFlight);
+			FrameScheduler scheduler(gpu, framesInFlight);
+			for (uint32_t frame = 0; frame < 7; frame++)
+			{
+				CATCH_CHECK(scheduler.BeginFrame() == frame % framesInFlight);
+				CATCH_CHECK(scheduler.IsRecording());
+				scheduler.EndFrame();
+				gpu.Complete(gpu.m_Signaled);
+			}
+		}
+	}
+
+	CATCH_SECTION("Only a reused slot waits, and only for the frame that used it")
+	{
+		FrameScheduler scheduler(gpu, 2);
+		std::vector<uint64_t> fences;
+		for (int frame = 0; frame < 2; frame++)
+		{
+			scheduler.BeginFrame();
+			scheduler.EndFrame();
+			fences.push_back(gpu.m_Signaled);
+		}
+		CATCH_CHECK(gpu.m_WaitedFor.empty());
+
+		// The GPU hasn't finished anything, the third frame reuses the slot of the first one
+		scheduler.BeginFrame();
+		CATCH_REQUIRE(gpu.m_WaitedFor.size() == 1);
+		CATCH_CHECK(gpu.m_WaitedFor[0] == fences[0]);
+		CATCH_CHECK(scheduler.GetCompletedFrame() == 1);
+		CATCH_CHECK(scheduler.GetStats().m_Waits == 1);
+		scheduler.EndFrame();
+
+		// Already finished, nothing to wait for
+		gpu.Complete(fences[1]);
+		scheduler.BeginFrame();
+		CATCH_CHECK(gpu.m_WaitedFor.size() == 1);
+		CATCH_CHECK(scheduler.GetCompletedFrame() == 2);
+		scheduler.EndFrame();
+	}
+
+	CATCH_SECTION("One frame in flight waits for the previous frame every time")
+	{
+		FrameScheduler scheduler(gpu, 1);
+		for (int frame = 0; frame < 4; frame++)
+		{
+			scheduler.BeginFrame();
+			CATCH_CHECK(scheduler.GetCompletedFrame() == scheduler.GetFrameNumber() - 1);
+			scheduler.EndFrame();
+		}
+		CATCH_CHECK(gpu.m_WaitedFor.size() == 3);
+	}
+
+	CATCH_SECTION("Changing the count drains the GPU and restarts the slots")
+	{
+		FrameScheduler scheduler(gpu, 3);
+		scheduler.BeginFrame();
+		scheduler.EndFrame();
+		scheduler.BeginFrame();
+		scheduler.EndFrame();
+
+		scheduler.SetFramesInFlight(2);
+		CATCH_CHECK(scheduler.GetFramesInFlight() == 2);
+		CATCH_CHECK(scheduler.BeginFrame() == 0);
+		CATCH_CHECK(gpu.m_Completed == gpu.m_Signaled);
+		CATCH_CHECK(scheduler.GetCompletedFrame() == 2);
+		scheduler.EndFrame();
+		CATCH_CHECK(scheduler.BeginFrame() == 1);
+		scheduler.EndFrame();
+	}
+}
+
+CATCH_TEST_CASE("Frame scheduler deferred deletion", "[FrameScheduler]")
+{
+	ManualGpuTimeline gpu;
+	FrameScheduler scheduler(gpu, 2);
+	std::vector<int> released;
+
+	CATCH_SECTION("Runs once the GPU finished the frame that released it")
+	{
+		scheduler.BeginFrame();
+		scheduler.DeferDeletion([&released] { released.push_back(1); });
+		scheduler.EndFrame();
+		const uint64_t firstFence = gpu.m_Signaled;
+
+		scheduler.BeginFrame();
+		scheduler.DeferDeletion([&released] { released.push_back(2); });
+		scheduler.EndFrame();
+		CATCH_CHECK(released.empty());
+		CATCH_CHECK(scheduler.GetPendingDeletions() == 2);
+
+		gpu.Complete(firstFence);
+		scheduler.BeginFrame();
+		CATCH_CHECK(released == std::vector<int>{1});
+		scheduler.EndFrame();
+
+		gpu.Complete(gpu.m_Signaled);
+		scheduler.BeginFrame();
+		CATCH_CHECK(released == std::vector<int>{1, 2});
+		CATCH_CHECK(scheduler.GetStats().m_Deletions == 2);
+		scheduler.EndFrame();
+	}
+
+	CATCH_SECTION("Between frames it waits for the next frame")
+	{
+		scheduler.BeginFrame();
+		scheduler.EndFrame();
+		scheduler.DeferDeletion([&released] { released.push_back(1); });
+
+		gpu.Complete(gpu.m_Signaled);
+		scheduler.BeginFrame();
+		CATCH_CHECK(released.empty());
+		scheduler.EndFrame();
+
+		gpu.Complete(gpu.m_Signaled);
+		scheduler.BeginFrame();
+		CATCH_CHECK(released == std::vector<int>{1});
+		scheduler.EndFrame();
+	}
+
+	CATCH_SECTION("Waiting for idle keeps the deletions of the frame being recorded")
+	{
+		scheduler.BeginFrame();
+		scheduler.DeferDeletion([&released] { released.push_back(1); });
+		scheduler.EndFrame();
+
+		scheduler.BeginFrame();
+		scheduler.DeferDeletion([&released] { released.push_back(2); });
+		scheduler.WaitForIdle();
+		CATCH_CHECK(released == std::vector<int>{1});
+		CATCH_CHECK(scheduler.GetCompletedFrame() == 1);
+		scheduler.EndFrame();
+
+		scheduler.DeferDeletion([&released] { released.push_back(3); });
+		scheduler.WaitForIdle();
+		CATCH_CHECK(released == std::vector<int>{1, 2, 3});
+		CATCH_CHECK(scheduler.GetPendingDeletions() == 0);
+	}
+
+	CATCH_SECTION("A deletion can defer another one")
+	{
+		scheduler.BeginFrame();
+		scheduler.DeferDeletion(
+			[&]
+			{
+				released.push_back(1);
+				scheduler.DeferDeletion([&released] { released.push_back(2); });
+			});
+		scheduler.EndFrame();
+
+		gpu.Complete(gpu.m_Signaled);
+		scheduler.BeginFrame();
+		CATCH_CHECK(released == std::vector<int>{1});
+		CATCH_CHECK(scheduler.GetPendingDeletions() == 1);
+		scheduler.EndFrame();
+	}
+}
+
+CATCH_TEST_CASE("Frame scheduler overlaps CPU and GPU", "[FrameScheduler]")
+{
+	CATCH_SECTION("Balanced frames run twice as fast with two frames in flight")
+	{
+		const SimulatedRun serial = SimulateFrames(1, 64, 10.0, 10.0);
+		const SimulatedRun pipelined = SimulateFrames(2, 64, 10.0, 10.0);
+		CATCH_CHECK(serial.m_FrameMs == Catch::Approx(20.0));
+		CATCH_CHECK(pipelined.m_FrameMs == Catch::Approx(10.0));
+		CATCH_CHECK(pipelined.m_WaitMs < serial.m_WaitMs);
+	}
+
+	CATCH_SECTION("GPU bound frames are limited by the GPU")
+	{
+		const SimulatedRun serial = SimulateFrames(1, 64, 4.0, 10.0);
+		CATCH_CHECK(serial.m_FrameMs == Catch::Approx(14.0));
+		for (uint32_t framesInFlight : {2u, 3u})
+			CATCH_CHECK(SimulateFrames(framesInFlight, 64, 4.0, 10.0).m_FrameMs == Catch::Approx(10.0));
+	}
+
+	CATCH_SECTION("More frames in flight add latency when the GPU is the bottleneck")
+	{
+		const SimulatedRun two = SimulateFrames(2, 64, 4.0, 10.0);
+		const SimulatedRun three = SimulateFrames(3, 64, 4.0, 10.0);
+		CATCH_CHECK(three.m_LatencyMs > two.m_LatencyMs);
+	}
+}
+
+// Frame time, latency and CPU stalls of a jittery frame loop, run with [.benchmark]
+CATCH_TEST_CASE("Frame scheduler benchmark", "[.benchmark]")
+{
+	std::printf("%-8s %-8s %-8s %10s %12s %10s\n", "CPU ms", "GPU ms", "Frames", "Frame ms", "Latency ms", "Wait ms");
+	for (const auto& [cpuMs, gpuMs] : {std::pair(8.0, 8.0), std::pair(4.0, 12.0), std::pair(12.0, 4.0)})
+	{
+		for (uint32_t framesInFlight = 1; framesInFlight <= FrameScheduler::MAX_FRAMES_IN_FLIGHT; framesInFlight++)
+		{
+			const SimulatedRun run = SimulateFrames(framesInFlight, 10000, cpuMs, gpuMs, 0.5, 7);
+			std::printf("%-8.1f %-8.1f %-8u %10.2f %12.2f %10.2f\n",
+						cpuMs,
+						gpuMs,
+						framesInFlight,
+						run.m_FrameMs,
+						run.m_LatencyMs,
+						run.m_WaitMs);
+		}
+	}
+
+	// Bookkeeping cost of a frame with a few deferred deletions
+	ManualGpuTimeline gpu;
+	FrameScheduler scheduler(gpu, 2);
+	const uint32_t frames = 100000;
+	const auto start = std::chrono::high_resolution_clock::now();
+	for (uint32_t i = 0; i < frames; i++)
+	{
+		scheduler.BeginFrame();
+		for (int deletion = 0; deletion < 4; deletion++)
+			scheduler.DeferDeletion([] {});
+		scheduler.EndFrame();
+		gpu.Complete(gpu.m_Signaled);
+	}
+	const std::chrono::duration<double, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+	std::printf("Scheduler overhead: %.3f us per frame\n", elapsed.count() / frames);
+}
@@ -0,0 +1,197 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Rendering/FrustumCulling.h"
+
+using namespace Ball;
+
+namespace
+{
+	// 90 degree pyramid looking down -Z from the origin, planes as the camera calculates them
+	ViewPyramid CreateTestPyramid()
+	{
+		ViewPyramid pyramid;
+		pyramid.m_TopPlane = glm::vec4(0.f, -1.f, -1.f, 0.f);
+		pyramid.m_BotPlane = glm::vec4(0.f, 1.f, -1.f, 0.f);
+		pyramid.m_LeftPlane = glm::vec4(1.f, 0.f, -1.f, 0.f);
+		pyramid.m_RightPlane = glm::vec4(-1.f, 0.f, -1.f, 0.f);
+		return pyramid;
+	}
+
+	// Smallest signed plane distance of the box's best corner, negative when all corners are behind a plane
+	float BruteForcePlaneMargin(const CullingFrustum& frustum, const AABB& box)
+	{
+		float margin = FLT_MAX;
+		for (const glm::vec4& plane : frustum.m_Planes)
+		{
+			float furthest = -FLT_MAX;
+			for (int corner = 0; corner < 8; corner++)
+			{
+				const glm::vec3 point = glm::vec3(corner & 1 ? box.m_Max.x : box.m_Min.x,
+												  corner & 2 ? box.m_Max.y : box.m_Min.y,
+												  corner & 4 ? box.m_Max.z : box.m_Min.z);
+				furthest = (std::max)(furthest, glm::dot(glm::vec3(plane), point) + plane.w);
+			}
+			margin = (std::min)(margin, furthest);
+		}
+		return margin;
+	}
+
+	float BruteForceDistance(const CullingFrustum& frustum, const AABB& box)
+	{
+		return glm::length(glm::clamp(frustum.m_Position, box.m_Min, box.m_Max) - frustum.m_Position);
+	}
+
+	std::vector<AABB> CreateRandomBoxes(size_t count, uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> position(-200.f, 200.f);
+		std::uniform_real_distribution<float> size(0.01f, 10.f);
+
+		std::vector<AABB> boxes(count);
+		for (AABB& box : boxes)
+		{
+			box.m_Min = glm::vec3(position(rng), position(rng), position(rng));
+			box.m_Max = box.m_Min + glm::vec3(size(rng), size(rng), size(rng));
+		}
+		return boxes;
+	}
+} // namespace
+
+CATCH_TEST_CASE("FrustumCulling")
+{
+	CATCH_SECTION("Planes are moved to world space")
+	{
+		const auto frustum = CullingFrustum::FromViewPyramid(CreateTestPyramid(), glm::vec3(10.f, 0.f, 0.f), 100.f);
+
+		CATCH_CHECK(frustum.IsVisible({glm::vec3(9.f, -1.f, -6.f), glm::vec3(11.f, 1.f, -4.f)}));
+		CATCH_CHECK(!frustum.IsVisible({glm::vec3(-1.f, -1.f, -6.f), glm::vec3(1.f, 1.f, -4.f)}));
+		// Behind the camera
+		CATCH_CHECK(!frustum.IsVisible({glm::vec3(9.f, -1.f, 4.f), glm::vec3(11.f, 1.f, 6.f)}));
+		// Camera inside the box
+		CATCH_CHECK(frustum.IsVisible({glm::vec3(9.f, -1.f, -1.f), glm::vec3(11.f, 1.f, 1.f)}));
+		CATCH_CHECK(frustum.GetDistance({glm::vec3(9.f, -1.f, -1.f), glm::vec3(11.f, 1.f, 1.f)}) == 0.f);
+	}
+
+	CATCH_SECTION("Boxes past the max distance are culled")
+	{
+		const auto frustum = CullingFrustum::FromViewPyramid(CreateTestPyramid(), glm::vec3(0.f), 50.f);
+
+		CATCH_CHECK(frustum.IsVisible({glm::vec3(-1.f, -1.f, -49.f), glm::vec3(1.f, 1.f, -40.f)}));
+		CATCH_CHECK(!frustum.IsVisible({glm::vec3(-1.f, -1.f, -60.f), glm::vec3(1.f, 1.f, -51.f)}));
+		CATCH_CHECK(frustum.GetDistance({glm::vec3(-1.f, -1.f, -60.f), glm::vec3(1.f, 1.f, -51.f)}) ==
+					Catch::Approx(51.f));
+	}
+
+	CATCH_SECTION("Transformed boxes contain the transformed corners")
+	{
+		const AABB box = {glm::vec3(-1.f, -2.f, -3.f), glm::vec3(1.f, 2.f, 3.f)};
+		glm::mat4 transform = glm::translate(glm::mat4(1.f), glm::vec3(5.f, 0.f, 0.f));
+		transform = glm::rotate(transform, 0.7f, glm::normalize(glm::vec3(1.f, 1.f, 0.f)));
+		transform = glm::scale(transform, glm::vec3(2.f));
+
+		const AABB transformed = box.Transformed(transform);
+		for (int corner = 0; corner < 8; corner++)
+		{
+			const glm::vec3 point = glm::vec3(corner & 1 ? box.m_Max.x : box.m_Min.x,
+											  corner & 2 ? box.m_Max.y : box.m_Min.y,
+											  corner & 4 ? box.m_Max.z : box.m_Min.z);
+			const glm::vec3 worldPoint = glm::vec3(transform * glm::vec4(point, 1.f));
+			CATCH_CHECK(glm::all(glm::greaterThanEqual(worldPoint, transformed.m_Min - 1e-4f)));
+			CATCH_CHECK(glm::all(glm::lessThanEqual(worldPoint, transformed.m_Max + 1e-4f)));
+		}
+		CATCH_CHECK(!AABB().Transformed(transform).IsValid());
+	}
+
+	CATCH_SECTION("Batches match brute force plane tests")
+	{
+		// Odd count so the scalar remainder is tested too
+		constexpr size_t numBoxes = 10003;
+		const auto boxes = CreateRandomBoxes(numBoxes, 42);
+
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> position(-50.f, 50.f);
+		for (int camera = 0; camera < 8; camera++)
+		{
+			// Rotated pyramid at a random position
+			const glm::mat4 rotation = glm::rotate(glm::mat4(1.f), camera * 0.8f, glm::vec3(0.3f, 1.f, 0.1f));
+			ViewPyramid pyramid = CreateTestPyramid();
+			pyramid.m_TopPlane = rotation * pyramid.m_TopPlane;
+			pyramid.m_BotPlane = rotation * pyramid.m_BotPlane;
+			pyramid.m_LeftPlane = rotation * pyramid.m_LeftPlane;
+			pyramid.m_RightPlane = rotation * pyramid.m_RightPlane;
+
+			const float maxDistance = 100.f + camera * 20.f;
+			const auto frustum = CullingFrustum::FromViewPyramid(
+				pyramid, glm::vec3(position(rng), position(rng), position(rng)), maxDistance);
+
+			std::vector<uint8_t> visible(numBoxes);
+			std::vector<float> distances(numBoxes);
+			CullAABBs(frustum, boxes.data(), numBoxes, visible.data(), distances.data());
+
+			size_t numVisible = 0;
+			for (size_t i = 0; i < numBoxes; i++)
+			{
+				const float margin = BruteForcePlaneMargin(frustum, boxes[i]);
+				const float distance = BruteForceDistance(frustum, boxes[i]);
+				CATCH_REQUIRE(distances[i] == Catch::Approx(distance).margin(1e-3));
+
+				// Boxes touching a plane can go either way because of rounding
+				if (std::abs(margin) < 1e-3f || std::abs(distance - maxDistance) < 1e-3f)
+					continue;
+
+				const bool expected = margin >= 0.f && distance <= maxDistance;
+				CATCH_REQUIRE(static_cast<bool>(visible[i]) == expected);
+				numVisible += expected;
+			}
+
+			// Make sure the test isn't trivially passing
+			CATCH_CHECK(numVisible > 0);
+			CATCH_CHECK(numVisible < numBoxes);
+		}
+	}
+}
+
+CATCH_TEST_CASE("FrustumCulling benchmark", "[.benchmark]")
+{
+	constexpr size_t numInstances = 100000;
+	const auto boxes = CreateRandomBoxes(numInstances, 1234);
+	const auto frustum = CullingFrustum::FromViewPyramid(CreateTestPyramid(), glm::vec3(0.f), 150.f);
+
+	std::vector<uint8_t> visible(numInstances);
+	std::vector<float> distances(numInstances);
+
+	CATCH_BENCHMARK("Cull 100k instances")
+	{
+		CullAABBs(frustum, boxes.data(), numInstances, visible.data(), distances.data());
+		return visible[numInstances - 1];
+	};
+
+	CATCH_BENCHMARK("Cull 100k instances brute force")
+	{
+		size_t numVisible = 0;
+		for (const AABB& box : boxes)
+			numVisible += BruteForcePlaneMargin(frustum, box) >= 0.f && BruteForceDistance(frustum, box) <= 150.f;
+		return numVisible;
+	};
+
+	// The benchmarked result has to match brute force, boxes touching a plane can go either way because of rounding
+	CullAABBs(frustum, boxes.data(), numInstances, visible.data(), distances.data());
+	size_t numVisible = 0;
+	for (size_t i = 0; i < numInstances; i++)
+	{
+		const float margin = BruteForcePlaneMargin(frustum, boxes[i]);
+		const float distance = BruteForceDistance(frustum, boxes[i]);
+		if (std::abs(margin) < 1e-3f || std::abs(distance - 150.f) < 1e-3f)
+			continue;
+
+		const bool expected = margin >= 0.f && distance <= 150.f;
+		CATCH_REQUIRE(static_cast<bool>(visible[i]) == expected);
+		numVisible += expected;
+	}
+	CATCH_CHECK(numVisible > 0);
+	CATCH_CHECK(numVisible < numInstances);
+}
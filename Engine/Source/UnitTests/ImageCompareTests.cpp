@@ -0,0 +1,124 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include "Utilities/ImageCompare.h"
+
+#include <glm/common.hpp>
+#include <random>
+
+using namespace Ball;
+
+namespace
+{
+	// Horizontal gradient with a hard vertical edge in the middle
+	CompareImage CreateTestImage(uint32_t width, uint32_t height)
+	{
+		CompareImage image;
+		image.m_Width = width;
+		image.m_Height = height;
+		image.m_Pixels.resize(width * height);
+		for (uint32_t y = 0; y < height; y++)
+		{
+			for (uint32_t x = 0; x < width; x++)
+			{
+				const float gradient = static_cast<float>(x) / width;
+				image.m_Pixels[y * width + x] = x < width / 2 ? glm::vec3(gradient * 0.5f, 0.2f, 0.3f)
+															  : glm::vec3(0.9f, gradient, 0.1f);
+			}
+		}
+		return image;
+	}
+
+	CompareImage AddNoise(CompareImage image, float amplitude)
+	{
+		std::mt19937 random(42);
+		std::uniform_real_distribution<float> distribution(-amplitude, amplitude);
+		for (glm::vec3& pixel : image.m_Pixels)
+			pixel = glm::clamp(pixel + glm::vec3(distribution(random)), 0.f, 1.f);
+		return image;
+	}
+} // namespace
+
+CATCH_TEST_CASE("ImageCompare")
+{
+	const CompareImage reference = CreateTestImage(64, 48);
+
+	CATCH_SECTION("Identical images have no error")
+	{
+		ImageCompareResult result;
+		CATCH_REQUIRE(CompareImages(reference, reference, result));
+		CATCH_CHECK(result.m_RMSE == 0.f);
+		CATCH_CHECK(result.m_SSIM == Catch::Approx(1.f));
+		CATCH_CHECK(result.m_Flip == 0.f);
+		CATCH_CHECK(result.m_ErrorMap.size() == 64 * 48);
+		CATCH_CHECK(result.Passes(ImageCompareThresholds{}));
+	}
+
+	CATCH_SECTION("RMSE of a constant offset")
+	{
+		CompareImage brighter = reference;
+		for (glm::vec3& pixel : brighter.m_Pixels)
+			pixel += glm::vec3(0.1f);
+
+		CATCH_CHECK(ComputeRMSE(reference, brighter) == Catch::Approx(0.1f).epsilon(0.001));
+	}
+
+	CATCH_SECTION("Errors grow with the amount of noise")
+	{
+		ImageCompareResult low;
+		ImageCompareResult high;
+		CATCH_REQUIRE(CompareImages(reference, AddNoise(reference, 0.02f), low));
+		CATCH_REQUIRE(CompareImages(reference, AddNoise(reference, 0.2f), high));
+
+		CATCH_CHECK(low.m_RMSE > 0.f);
+		CATCH_CHECK(low.m_RMSE < high.m_RMSE);
+		CATCH_CHECK(low.m_SSIM < 1.f);
+		CATCH_CHECK(low.m_SSIM > high.m_SSIM);
+		CATCH_CHECK(low.m_Flip > 0.f);
+		CATCH_CHECK(low.m_Flip < high.m_Flip);
+
+		CATCH_CHECK(low.Passes(ImageCompareThresholds{}));
+		CATCH_CHECK_FALSE(high.Passes(ImageCompareThresholds{}));
+	}
+
+	CATCH_SECTION("A moved edge is a larger perceptual error than noise with the same RMSE")
+	{
+		CompareImage moved = CreateTestImage(64, 48);
+		for (uint32_t y = 0; y < moved.m_Height; y++)
+		{
+			for (uint32_t x = 28; x < 32; x++)
+				moved.m_Pixels[y * moved.m_Width + x] = reference.GetPixel(40, y);
+		}
+
+		const float movedRMSE = ComputeRMSE(reference, moved);
+		float amplitude = 0.01f;
+		CompareImage noisy = AddNoise(reference, amplitude);
+		while (ComputeRMSE(reference, noisy) < movedRMSE)
+		{
+			amplitude += 0.01f;
+			noisy = AddNoise(reference, amplitude);
+		}
+
+		const std::vector<float> movedError = ComputeFlipErrorMap(reference, moved);
+		const std::vector<float> noiseError = ComputeFlipErrorMap(reference, noisy);
+		const size_t edgePixel = 10 * moved.m_Width + 30;
+		CATCH_CHECK(movedError[edgePixel] > noiseError[edgePixel]);
+		CATCH_CHECK(movedError[10 * moved.m_Width + 5] == 0.f);
+	}
+
+	CATCH_SECTION("Images of different sizes can't be compared")
+	{
+		ImageCompareResult result;
+		CATCH_CHECK_FALSE(CompareImages(reference, CreateTestImage(32, 48), result));
+		CATCH_CHECK_FALSE(CompareImages(reference, CompareImage{}, result));
+	}
+
+	CATCH_SECTION("Heatmap")
+	{
+		const CompareImage heatmap = CreateHeatmap({0.f, 0.5f, 1.f, 2.f}, 2, 2);
+		CATCH_REQUIRE(heatmap.IsValid());
+		CATCH_CHECK(heatmap.GetPixel(0, 0).r < 0.01f);
+		CATCH_CHECK(heatmap.GetPixel(1, 0).r > heatmap.GetPixel(0, 0).r);
+		CATCH_CHECK(heatmap.GetPixel(0, 1) == heatmap.GetPixel(1, 1));
+		CATCH_CHECK_FALSE(CreateHeatmap({0.f}, 2, 2).IsValid());
+	}
+}
@@ -0,0 +1,200 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <random>
+
+#include "Input/InputRecording.h"
+#include "Transform.h"
+
+using namespace Ball;
+
+namespace
+{
+	// Small fly camera, moves and rotates the transform from the input like the FreeCamera does
+	class ReplayController
+	{
+	public:
+		explicit ReplayController(Input& input) : m_Input(input)
+		{
+			m_Input.CreateAxis("Forward").AddKeyBind(KEY_S, KEY_W).AddStickBind(LEFTY);
+			m_Input.CreateAxis("Right").AddKeyBind(KEY_A, KEY_D).AddStickBind(LEFTX);
+			m_Input.CreateAction("Jump").AddKeyBind(KEY_SPACE);
+			m_Input.CreateAction("Grow").AddKeyBind(MOUSE_L);
+
+			m_Forward = m_Input.GetAxisId("Forward");
+			m_Right = m_Input.GetAxisId("Right");
+			m_Jump = m_Input.GetActionId("Jump");
+			m_Grow = m_Input.GetActionId("Grow");
+		}
+
+		uint64_t Update(float deltaTime)
+		{
+			const float seconds = deltaTime * 0.001f;
+			const glm::vec2 mouseDelta = m_Input.GetMouseDelta();
+			m_Transform.AngleAxisGlobal(-mouseDelta.x * 0.002f, glm::vec3(0.f, 1.f, 0.f));
+			m_Transform.AngleAxisLocal(-mouseDelta.y * 0.002f, glm::vec3(1.f, 0.f, 0.f));
+
+			const glm::vec3 movement =
+				m_Transform.Forward() * m_Input.GetAxis(m_Forward) + m_Transform.Right() * m_Input.GetAxis(m_Right);
+			m_Transform.Translate(movement * 10.f * seconds);
+
+			if (m_Input.GetActionDown(m_Jump))
+				m_Transform.Translate(0.f, 1.f, 0.f);
+			if (m_Input.GetAction(m_Grow))
+				m_Transform.SetScale(m_Transform.GetScale() * (1.f + seconds));
+
+			return HashTransform(m_Transform);
+		}
+
+	private:
+		Input& m_Input;
+		Transform m_Transform;
+		AxisId m_Forward;
+		AxisId m_Right;
+		ActionId m_Jump;
+		ActionId m_Grow;
+	};
+
+	// Every raw key state, so the replayed input can be compared with the recorded one
+	std::vector<KeyState> GetKeyStates(const Input& input)
+	{
+		std::vector<KeyState> states(NUM_KEY_CODES);
+		for (unsigned int key = 0; key < NUM_KEY_CODES; key++)
+			states[key] = input.GetRawKeyState(static_cast<KeyCode>(key));
+		return states;
+	}
+} // namespace
+
+CATCH_TEST_CASE("InputReplay")
+{
+	constexpr int numFrames = 600;
+
+	// Record a random session with variable frame times
+	std::mt19937 rng(1234);
+	Input recordedInput;
+	ReplayController recordedController(recordedInput);
+	InputRecorder recorder;
+	std::vector<std::vector<KeyState>> recordedKeyStates;
+	std::vector<bool> recordedBlocked;
+
+	const KeyCode usedKeys[] = {KEY_W, KEY_A, KEY_S, KEY_D, KEY_SPACE, MOUSE_L};
+	KeyBitset keysDown;
+	float axisValues[NUM_JOYSTICKS] = {};
+	bool blocked = false;
+	int numBlockedFrames = 0;
+	for (int frame = 0; frame < numFrames; frame++)
+	{
+		// Stretches where the window lost focus or an ImGui widget was active
+		if (std::uniform_int_distribution<int>(0, 19)(rng) == 0)
+			blocked = !blocked;
+		numBlockedFrames += blocked ? 1 : 0;
+
+		// Keys are held for a couple of frames, sticks and mouse move every now and then
+		for (const KeyCode key : usedKeys)
+		{
+			if (std::uniform_int_distribution<int>(0, 9)(rng) == 0)
+				keysDown.flip(key);
+		}
+		if (std::uniform_int_distribution<int>(0, 4)(rng) == 0)
+			axisValues[LEFTX] = std::uniform_real_distribution<float>(-1.f, 1.f)(rng);
+		if (std::uniform_int_distribution<int>(0, 4)(rng) == 0)
+			axisValues[LEFTY] = std::uniform_real_distribution<float>(-1.f, 1.f)(rng);
+
+		glm::vec2 mouseDelta(0.f);
+		if (std::uniform_int_distribution<int>(0, 2)(rng) == 0)
+		{
+			mouseDelta.x = static_cast<float>(std::uniform_int_distribution<int>(-20, 20)(rng));
+			mouseDelta.y = static_cast<float>(std::uniform_int_distribution<int>(-20, 20)(rng));
+		}
+
+		const float deltaTime = std::uniform_real_distribution<float>(4.f, 40.f)(rng);
+		recordedInput.UpdateSynthetic(keysDown, axisValues, mouseDelta, blocked);
+		recorder.RecordFrame(recordedInput, deltaTime);
+		recorder.RecordStateHash(recordedController.Update(deltaTime));
+		recordedKeyStates.push_back(GetKeyStates(recordedInput));
+		recordedBlocked.push_back(blocked);
+	}
+	CATCH_REQUIRE(recorder.GetFrameCount() == numFrames);
+	CATCH_REQUIRE(numBlockedFrames > 0);
+	CATCH_REQUIRE(numBlockedFrames < numFrames);
+
+	CATCH_SECTION("Replays are bit-identical to the recording")
+	{
+		for (int run = 0; run < 2; run++)
+		{
+			Input input;
+			ReplayController controller(input);
+			InputReplay replay;
+			CATCH_REQUIRE(replay.Load(recorder.GetData(), recorder.GetStateHashes()));
+
+			int frame = 0;
+			while (replay.NextFrame())
+			{
+				replay.ApplyInput(input);
+				const uint64_t hash = controller.Update(replay.GetDeltaTime());
+				CATCH_REQUIRE(hash == recorder.GetStateHashes()[frame]);
+				CATCH_REQUIRE(replay.VerifyStateHash(hash));
+				CATCH_REQUIRE(GetKeyStates(input) == recordedKeyStates[frame]);
+				CATCH_REQUIRE(input.IsGameplayInputBlocked() == recordedBlocked[frame]);
+				frame++;
+			}
+
+			CATCH_CHECK(frame == numFrames);
+			CATCH_CHECK(replay.IsFinished());
+			CATCH_CHECK(replay.GetMismatchCount() == 0);
+		}
+	}
+
+	CATCH_SECTION("Diverging state is detected")
+	{
+		InputReplay replay;
+		CATCH_REQUIRE(replay.Load(recorder.GetData(), recorder.GetStateHashes()));
+		CATCH_REQUIRE(replay.NextFrame());
+		CATCH_CHECK(replay.VerifyStateHash(recorder.GetStateHashes()[0]));
+
+		CATCH_REQUIRE(replay.NextFrame());
+		CATCH_CHECK(!replay.VerifyStateHash(recorder.GetStateHashes()[1] + 1));
+		CATCH_CHECK(replay.GetMismatchCount() == 1);
+	}
+
+	CATCH_SECTION("Corrupt recordings are rejected")
+	{
+		InputReplay replay;
+		std::vector<uint8_t> data = recorder.GetData();
+		data[0] ^= 0xFF;
+		CATCH_CHECK(!replay.Load(data));
+		CATCH_CHECK(!replay.NextFrame());
+
+		// A truncated recording plays until the cut off frame
+		data = recorder.GetData();
+		data.resize(data.size() - 1);
+		CATCH_REQUIRE(replay.Load(data));
+		int numFramesReplayed = 0;
+		while (replay.NextFrame())
+			numFramesReplayed++;
+		CATCH_CHECK(numFramesReplayed == numFrames - 1);
+	}
+}
+
+CATCH_TEST_CASE("InputRecorder")
+{
+	Input input;
+	InputRecorder recorder;
+	const size_t headerSize = recorder.GetData().size();
+
+	// Frames without any change only store the flags and the delta time
+	const float axisValues[NUM_JOYSTICKS] = {};
+	for (int frame = 0; frame < 100; frame++)
+	{
+		input.UpdateSynthetic({}, axisValues);
+		recorder.RecordFrame(input, 16.f);
+	}
+	CATCH_CHECK(recorder.GetData().size() == headerSize + 100 * (sizeof(uint8_t) + sizeof(float)));
+
+	// A key press stores the count and one key/state pair
+	const size_t idleSize = recorder.GetData().size();
+	KeyBitset keysDown;
+	keysDown.set(KEY_E);
+	input.UpdateSynthetic(keysDown, axisValues);
+	recorder.RecordFrame(input, 16.f);
+	CATCH_CHECK(recorder.GetData().size() == idleSize + sizeof(uint8_t) + sizeof(float) + 3);
+}
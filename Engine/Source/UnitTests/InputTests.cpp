@@ -0,0 +1,162 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include "Input/Input.h"
+
+using namespace Ball;
+
+namespace
+{
+	// Runs one frame with the given keys held down and the sticks at rest
+	void UpdateFrame(Input& input, std::initializer_list<KeyCode> keysDown)
+	{
+		KeyBitset keys;
+		for (const KeyCode key : keysDown)
+			keys.set(key);
+
+		const float axisValues[NUM_JOYSTICKS] = {};
+		input.UpdateSynthetic(keys, axisValues);
+	}
+} // namespace
+
+CATCH_TEST_CASE("Input")
+{
+	// Separate instance, the engine one is driven by the platform
+	Input input;
+
+	CATCH_SECTION("Raw key states follow the synthetic events")
+	{
+		UpdateFrame(input, {KEY_SPACE});
+		CATCH_CHECK(input.GetRawKeyState(KEY_SPACE) == KeyState::PRESSED);
+		CATCH_CHECK(input.GetUpdatedKeys().test(KEY_SPACE));
+		CATCH_CHECK(input.GetUpdatedKeys().count() == 1);
+		CATCH_CHECK(input.GetAnyDown());
+
+		UpdateFrame(input, {KEY_SPACE});
+		CATCH_CHECK(input.GetRawKeyState(KEY_SPACE) == KeyState::DOWN);
+
+		// Held keys don't change state anymore
+		UpdateFrame(input, {KEY_SPACE});
+		CATCH_CHECK(input.GetRawKeyState(KEY_SPACE) == KeyState::DOWN);
+		CATCH_CHECK(!input.GetAnyDown());
+
+		UpdateFrame(input, {});
+		CATCH_CHECK(input.GetRawKeyState(KEY_SPACE) == KeyState::RELEASED);
+
+		UpdateFrame(input, {});
+		CATCH_CHECK(input.GetRawKeyState(KEY_SPACE) == KeyState::NONE);
+		CATCH_CHECK(input.GetRawKeyState(KEY_A) == KeyState::NONE);
+	}
+
+	CATCH_SECTION("Actions by id and by name")
+	{
+		input.CreateAction("Jump").AddKeyBind(KEY_SPACE).AddKeyBind(GAMEPAD_A);
+		input.CreateAction("Fire").AddKeyBind(MOUSE_L);
+
+		const ActionId jump = input.GetActionId("Jump");
+		CATCH_REQUIRE(jump.IsValid());
+		CATCH_CHECK(!input.GetActionId("Crouch").IsValid());
+		CATCH_CHECK(&input.CreateAction("Jump") == &input.GetActionBinding("Jump"));
+
+		UpdateFrame(input, {GAMEPAD_A});
+		CATCH_CHECK(input.GetAction(jump));
+		CATCH_CHECK(input.GetActionDown(jump));
+		CATCH_CHECK(!input.GetActionReleased(jump));
+		CATCH_CHECK(input.GetActionRaw(jump) == KeyState::PRESSED);
+		CATCH_CHECK(!input.GetAction("Fire"));
+
+		// Second key of the action pressed while the first one is held
+		UpdateFrame(input, {GAMEPAD_A, KEY_SPACE});
+		CATCH_CHECK(input.GetAction("Jump"));
+		CATCH_CHECK(input.GetActionDown("Jump"));
+		CATCH_CHECK(input.GetActionRaw("Jump") == KeyState::DOWN);
+
+		UpdateFrame(input, {});
+		CATCH_CHECK(!input.GetAction(jump));
+		CATCH_CHECK(input.GetActionReleased(jump));
+		CATCH_CHECK(input.GetActionRaw(jump) == KeyState::RELEASED);
+
+		UpdateFrame(input, {});
+		CATCH_CHECK(!input.GetActionReleased(jump));
+		CATCH_CHECK(input.GetActionRaw(jump) == KeyState::NONE);
+	}
+
+	CATCH_SECTION("Rebinding is picked up on the next update")
+	{
+		input.CreateAction("Interact").AddKeyBind(KEY_E);
+		const ActionId interact = input.GetActionId("Interact");
+
+		input.GetActionBinding("Interact").RemoveKeyBind(KEY_E).AddKeyBind(KEY_F);
+		UpdateFrame(input, {KEY_E});
+		CATCH_CHECK(!input.GetAction(interact));
+
+		UpdateFrame(input, {KEY_F});
+		CATCH_CHECK(input.GetActionDown(interact));
+	}
+
+	CATCH_SECTION("Axes use keys before sticks")
+	{
+		input.CreateAxis("Forward").AddKeyBind(KEY_S, KEY_W).AddStickBind(LEFTY).DeadZone(0.2f).Magnitude(2.f);
+		const AxisId forward = input.GetAxisId("Forward");
+		CATCH_REQUIRE(forward.IsValid());
+		CATCH_CHECK(!input.GetAxisId("Sideways").IsValid());
+
+		UpdateFrame(input, {KEY_W});
+		CATCH_CHECK(input.GetAxis(forward) == 2.f);
+
+		UpdateFrame(input, {KEY_W, KEY_S});
+		CATCH_CHECK(input.GetAxis("Forward") == 0.f);
+
+		float axisValues[NUM_JOYSTICKS] = {};
+		axisValues[LEFTY] = -0.5f;
+		input.UpdateSynthetic(KeyBitset().set(KEY_S), axisValues);
+		CATCH_CHECK(input.GetAxis(forward) == -2.f);
+
+		input.UpdateSynthetic(KeyBitset(), axisValues);
+		CATCH_CHECK(input.GetAxis(forward) == -1.f);
+		CATCH_CHECK(input.GetJoystickRaw(LEFTY) == -0.5f);
+
+		// Inside the dead zone
+		axisValues[LEFTY] = 0.1f;
+		input.UpdateSynthetic(KeyBitset(), axisValues);
+		CATCH_CHECK(input.GetAxis(forward) == 0.f);
+	}
+}
+
+CATCH_TEST_CASE("Input benchmark", "[.benchmark]")
+{
+	Input input;
+
+	// Roughly what a level with a few dozen scripted objects polls every frame
+	constexpr int numActions = 64;
+	std::vector<std::string> names;
+	std::vector<ActionId> ids;
+	for (int i = 0; i < numActions; i++)
+	{
+		names.push_back("Gameplay_Action_" + std::to_string(i));
+		input.CreateAction(names.back()).AddKeyBind(static_cast<KeyCode>(KEY_A + i % 26));
+		ids.push_back(input.GetActionId(names.back()));
+	}
+	UpdateFrame(input, {KEY_A, KEY_D});
+
+	CATCH_BENCHMARK("Poll 64 actions by name")
+	{
+		int numHeld = 0;
+		for (const std::string& name : names)
+			numHeld += input.GetAction(name);
+		return numHeld;
+	};
+
+	CATCH_BENCHMARK("Poll 64 actions by id")
+	{
+		int numHeld = 0;
+		for (const ActionId id : ids)
+			numHeld += input.GetAction(id);
+		return numHeld;
+	};
+
+	CATCH_BENCHMARK("Update the states of 64 actions")
+	{
+		UpdateFrame(input, {KEY_A, KEY_D});
+		return input.GetAction(ids[0]);
+	};
+}
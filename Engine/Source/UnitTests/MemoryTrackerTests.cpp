@@ -0,0 +1,105 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include "Rendering/MemoryTracker.h"
+
+using namespace Ball;
+
+CATCH_TEST_CASE("MemoryTracker")
+{
+	// Separate tracker, the global one holds the counters of the running engine
+	MemoryTracker tracker;
+	tracker.SetWarnOnBudgetBreach(false);
+
+	CATCH_SECTION("Live and peak bytes per tag")
+	{
+		tracker.Allocate(MemoryTag::WAVEFRONT, 100);
+		tracker.Allocate(MemoryTag::WAVEFRONT, 50);
+		tracker.Allocate(MemoryTag::TEXTURES, 30);
+		tracker.Free(MemoryTag::WAVEFRONT, 100);
+
+		const auto wavefront = tracker.GetStats(MemoryTag::WAVEFRONT);
+		CATCH_CHECK(wavefront.m_LiveBytes == 50);
+		CATCH_CHECK(wavefront.m_PeakBytes == 150);
+		CATCH_CHECK(wavefront.m_NumAllocations == 1);
+
+		const auto total = tracker.GetStats(MemoryTag::TOTAL);
+		CATCH_CHECK(total.m_LiveBytes == 80);
+		CATCH_CHECK(total.m_PeakBytes == 180);
+		CATCH_CHECK(total.m_NumAllocations == 2);
+		CATCH_CHECK(tracker.GetStats(MemoryTag::DENOISER).m_LiveBytes == 0);
+	}
+
+	CATCH_SECTION("Resizing keeps the allocation count")
+	{
+		tracker.Allocate(MemoryTag::DENOISER, 64);
+		tracker.Resize(MemoryTag::DENOISER, 64, 256);
+		tracker.Resize(MemoryTag::DENOISER, 256, 128);
+
+		const auto denoiser = tracker.GetStats(MemoryTag::DENOISER);
+		CATCH_CHECK(denoiser.m_LiveBytes == 128);
+		CATCH_CHECK(denoiser.m_PeakBytes == 256);
+		CATCH_CHECK(denoiser.m_NumAllocations == 1);
+	}
+
+	CATCH_SECTION("Per frame deltas")
+	{
+		tracker.Allocate(MemoryTag::STAGING, 1000);
+		tracker.EndFrame();
+		CATCH_CHECK(tracker.GetStats(MemoryTag::STAGING).m_FrameDeltaBytes == 1000);
+
+		tracker.Free(MemoryTag::STAGING, 1000);
+		tracker.Allocate(MemoryTag::STAGING, 200);
+		tracker.EndFrame();
+		CATCH_CHECK(tracker.GetStats(MemoryTag::STAGING).m_FrameDeltaBytes == -800);
+
+		tracker.EndFrame();
+		CATCH_CHECK(tracker.GetStats(MemoryTag::STAGING).m_FrameDeltaBytes == 0);
+		CATCH_CHECK(tracker.GetFrameNumber() == 3);
+	}
+
+	CATCH_SECTION("Budget callbacks run while over budget")
+	{
+		std::vector<MemoryTag> breaches;
+		const uint32_t callbackID =
+			tracker.AddBudgetCallback([&](MemoryTag tag, const MemoryTagStats&) { breaches.push_back(tag); });
+
+		tracker.SetBudget(MemoryTag::TEXTURES, 100);
+		tracker.Allocate(MemoryTag::TEXTURES, 100);
+		tracker.EndFrame();
+		CATCH_CHECK(breaches.empty());
+
+		tracker.Allocate(MemoryTag::TEXTURES, 1);
+		tracker.EndFrame();
+		tracker.EndFrame();
+		CATCH_CHECK(breaches == std::vector<MemoryTag>{MemoryTag::TEXTURES, MemoryTag::TEXTURES});
+
+		tracker.RemoveBudgetCallback(callbackID);
+		tracker.EndFrame();
+		CATCH_CHECK(breaches.size() == 2);
+	}
+
+	CATCH_SECTION("Eviction callback can free memory")
+	{
+		std::vector<uint64_t> residentTextures = {40, 40, 40};
+		for (const uint64_t size : residentTextures)
+			tracker.Allocate(MemoryTag::TEXTURES, size);
+
+		tracker.SetBudget(MemoryTag::TOTAL, 100);
+		tracker.AddBudgetCallback(
+			[&](MemoryTag tag, const MemoryTagStats& stats)
+			{
+				// Evict until the total fits again
+				uint64_t live = stats.m_LiveBytes;
+				while (tag == MemoryTag::TOTAL && live > stats.m_BudgetBytes && !residentTextures.empty())
+				{
+					tracker.Free(MemoryTag::TEXTURES, residentTextures.back());
+					live -= residentTextures.back();
+					residentTextures.pop_back();
+				}
+			});
+
+		tracker.EndFrame();
+		CATCH_CHECK(residentTextures.size() == 2);
+		CATCH_CHECK(tracker.GetStats(MemoryTag::TOTAL).m_LiveBytes == 80);
+	}
+}
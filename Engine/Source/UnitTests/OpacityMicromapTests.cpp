@@ -0,0 +1,260 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Rendering/OpacityMicromap.h"
+#include "ShaderHeaders/RandomGPU.h"
+
+using namespace Ball;
+
+namespace
+{
+	// Leaves on a transparent background, with a few texels of soft edge and noise like a real foliage texture
+	AlphaTexture MakeFoliageTexture(uint32_t size)
+	{
+		AlphaTexture texture;
+		texture.m_Width = size;
+		texture.m_Height = size;
+		texture.m_Alpha.resize(size * size);
+
+		const glm::vec2 leaves[4] = {{0.3f, 0.3f}, {0.7f, 0.35f}, {0.35f, 0.72f}, {0.72f, 0.75f}};
+		uint32_t seed = 11;
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				const glm::vec2 uv((x + 0.5f) / size, (y + 0.5f) / size);
+				float distance = 1e9f;
+				for (const glm::vec2& leaf : leaves)
+				{
+					const glm::vec2 d = (uv - leaf) / glm::vec2(0.18f, 0.1f);
+					distance = (std::min)(distance, glm::length(d) - 1.f);
+				}
+				const float edge = 0.5f - distance * size * 0.05f + (ShaderRandom::rand(seed) - 0.5f) * 0.3f;
+				texture.m_Alpha[y * size + x] =
+					static_cast<uint16_t>(glm::clamp(edge, 0.f, 1.f) * AlphaTexture::MAX_VALUE + 0.5f);
+			}
+		}
+		return texture;
+	}
+
+	// Point filtering, the texel the uv falls in
+	float SampleAlphaNearest(const AlphaTexture& texture, glm::vec2 uv, const OpacityMicromapSettings& settings)
+	{
+		const glm::vec2 texel = glm::floor(uv * glm::vec2(texture.m_Width, texture.m_Height)) + 0.5f;
+		return SampleAlphaBilinear(texture, texel / glm::vec2(texture.m_Width, texture.m_Height), settings);
+	}
+
+	// Grid of leaf card quads, every card maps a tile of uv space starting at uvOrigin
+	struct FoliageMesh
+	{
+		std::vector<glm::vec3> m_Positions;
+		std::vector<glm::vec2> m_UVs;
+		std::vector<uint32_t> m_Indices;
+	};
+
+	FoliageMesh MakeFoliageMesh(uint32_t cards, glm::vec2 uvOrigin, float uvSize)
+	{
+		FoliageMesh mesh;
+		for (uint32_t y = 0; y <= cards; y++)
+		{
+			for (uint32_t x = 0; x <= cards; x++)
+			{
+				const glm::vec2 t(float(x) / cards, float(y) / cards);
+				mesh.m_Positions.push_back(glm::vec3(t, 0.f));
+				mesh.m_UVs.push_back(uvOrigin + t * uvSize);
+			}
+		}
+		for (uint32_t y = 0; y < cards; y++)
+		{
+			for (uint32_t x = 0; x < cards; x++)
+			{
+				const uint32_t v = y * (cards + 1) + x;
+				const uint32_t quad[6] = {v, v + 1, v + cards + 1, v + 1, v + cards + 2, v + cards + 1};
+				mesh.m_Indices.insert(mesh.m_Indices.end(), quad, quad + 6);
+			}
+		}
+		return mesh;
+	}
+
+	struct AlphaTestResult
+	{
+		uint32_t m_Hits = 0;
+		uint32_t m_Known = 0;
+		uint32_t m_Mismatches = 0;
+	};
+
+	// Random any hits on the mesh, every hit the micromap answers has to agree with sampling the texture
+	AlphaTestResult RunAlphaTests(const FoliageMesh& mesh, const std::vector<uint32_t>& micromap,
+								  const AlphaTexture& texture, const OpacityMicromapSettings& settings, uint32_t hits)
+	{
+		AlphaTestResult result;
+		const uint32_t numTriangles = static_cast<uint32_t>(mesh.m_Indices.size() / 3);
+		uint32_t seed = 23;
+		for (uint32_t h = 0; h < hits; h++)
+		{
+			const uint32_t t =
+				(std::min)(static_cast<uint32_t>(ShaderRandom::rand(seed) * numTriangles), numTriangles - 1);
+			glm::vec2 b(ShaderRandom::rand(seed), ShaderRandom::rand(seed));
+			if (b.x + b.y > 1.f)
+				b = 1.f - glm::vec2(b.y, b.x);
+
+			const glm::vec2 uv = mesh.m_UVs[mesh.m_Indices[3 * t]] * (1.f - b.x - b.y) +
+				mesh.m_UVs[mesh.m_Indices[3 * t + 1]] * b.x + mesh.m_UVs[mesh.m_Indices[3 * t + 2]] * b.y;
+			const uint32_t state = OpacityMicromap::OpacityState(micromap.data(), t, b);
+			result.m_Hits++;
+			if (state == OpacityMicromap::OPACITY_UNKNOWN)
+				continue;
+
+			result.m_Known++;
+			const bool opaque = state == OpacityMicromap::OPACITY_OPAQUE;
+			if ((SampleAlphaBilinear(texture, uv, settings) >= settings.m_AlphaCutoff) != opaque ||
+				(SampleAlphaNearest(texture, uv, settings) >= settings.m_AlphaCutoff) != opaque)
+				result.m_Mismatches++;
+		}
+		return result;
+	}
+} // namespace
+
+CATCH_TEST_CASE("Micro-triangle indices tile the triangle", "[Rendering][OpacityMicromap]")
+{
+	for (uint32_t level = 0; level <= OpacityMicromap::OPACITY_MAX_LEVEL; level++)
+	{
+		CATCH_INFO("Level " << level);
+		const uint32_t count = OpacityMicromap::MicroTriangleCount(level);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			glm::vec2 b0, b1, b2;
+			OpacityMicromap::MicroTriangleBarycentrics(i, level, b0, b1, b2);
+			CATCH_CHECK(OpacityMicromap::MicroTriangleIndex((b0 + b1 + b2) / 3.f, level) == i);
+			// Same winding as the triangle, every micro-triangle covers 1 / count of it
+			const glm::vec2 e1 = b1 - b0;
+			const glm::vec2 e2 = b2 - b0;
+			CATCH_CHECK(0.5f * (e1.x * e2.y - e1.y * e2.x) == Catch::Approx(0.5f / count));
+		}
+
+		// Corners and edges of the triangle stay inside the range
+		const glm::vec2 corners[3] = {{0.f, 0.f}, {1.f, 0.f}, {0.f, 1.f}};
+		for (const glm::vec2& corner : corners)
+			CATCH_CHECK(OpacityMicromap::MicroTriangleIndex(corner, level) < count);
+		CATCH_CHECK(OpacityMicromap::MicroTriangleIndex(glm::vec2(0.5f, 0.5f), level) < count);
+	}
+}
+
+CATCH_TEST_CASE("Opacity micromaps agree with sampling the alpha texture", "[Rendering][OpacityMicromap]")
+{
+	const AlphaTexture texture = MakeFoliageTexture(64);
+	OpacityMicromapSettings settings;
+
+	CATCH_SECTION("Leaf cards")
+	{
+		const FoliageMesh mesh = MakeFoliageMesh(4, glm::vec2(0.f), 1.f);
+		OpacityMicromapStats stats;
+		const std::vector<uint32_t> micromap =
+			BuildOpacityMicromap(mesh.m_Positions, mesh.m_UVs, mesh.m_Indices, texture, settings, &stats);
+		CATCH_CHECK(stats.m_Triangles == mesh.m_Indices.size() / 3);
+		CATCH_CHECK(stats.m_SubdividedTriangles > 0);
+
+		const AlphaTestResult result = RunAlphaTests(mesh, micromap, texture, settings, 200000);
+		CATCH_CHECK(result.m_Mismatches == 0);
+
+		// The cards all have the same area, so uniform hits measure what the bake reports
+		const double eliminated = double(result.m_Known) / result.m_Hits;
+		CATCH_INFO("Micromap of " << stats.m_MicroTriangles << " micro-triangles in "
+								  << micromap.size() * sizeof(uint32_t) << " bytes");
+		CATCH_CAPTURE(eliminated, stats.FetchesEliminated());
+		CATCH_CHECK(eliminated == Catch::Approx(stats.FetchesEliminated()).margin(0.01));
+		CATCH_CHECK(eliminated > 0.6);
+	}
+
+	CATCH_SECTION("Wrap modes")
+	{
+		// The cards reach outside [0, 1], where the sampler repeats, clamps or mirrors
+		const FoliageMesh mesh = MakeFoliageMesh(6, glm::vec2(-1.3f, -0.6f), 3.1f);
+		for (AlphaWrap wrap : {AlphaWrap::REPEAT, AlphaWrap::CLAMP, AlphaWrap::MIRROR})
+		{
+			CATCH_INFO("Wrap " << static_cast<int>(wrap));
+			settings.m_Wrap = wrap;
+			const std::vector<uint32_t> micromap =
+				BuildOpacityMicromap(mesh.m_Positions, mesh.m_UVs, mesh.m_Indices, texture, settings);
+			const AlphaTestResult result = RunAlphaTests(mesh, micromap, texture, settings, 100000);
+			CATCH_CHECK(result.m_Mismatches == 0);
+			CATCH_CHECK(result.m_Known > result.m_Hits / 2);
+		}
+	}
+
+	CATCH_SECTION("Cutoff and alpha scale")
+	{
+		const FoliageMesh mesh = MakeFoliageMesh(3, glm::vec2(0.1f, 0.05f), 0.8f);
+		settings.m_AlphaCutoff = 0.3f;
+		settings.m_AlphaScale = 0.7f;
+		settings.m_MaxLevel = OpacityMicromap::OPACITY_MAX_LEVEL;
+		const std::vector<uint32_t> micromap =
+			BuildOpacityMicromap(mesh.m_Positions, mesh.m_UVs, mesh.m_Indices, texture, settings);
+		CATCH_CHECK(RunAlphaTests(mesh, micromap, texture, settings, 100000).m_Mismatches == 0);
+	}
+}
+
+CATCH_TEST_CASE("Uniform alpha needs no micro-triangles", "[Rendering][OpacityMicromap]")
+{
+	AlphaTexture texture;
+	texture.m_Width = 8;
+	texture.m_Height = 8;
+	texture.m_Alpha.assign(64, 50000);
+	const FoliageMesh mesh = MakeFoliageMesh(2, glm::vec2(0.f), 1.f);
+
+	OpacityMicromapSettings settings;
+	OpacityMicromapStats stats;
+	std::vector<uint32_t> micromap =
+		BuildOpacityMicromap(mesh.m_Positions, mesh.m_UVs, mesh.m_Indices, texture, settings, &stats);
+	CATCH_CHECK(micromap.size() == mesh.m_Indices.size() / 3);
+	for (uint32_t descriptor : micromap)
+		CATCH_CHECK(descriptor == OpacityMicromap::OpacityDescriptor(OpacityMicromap::OPACITY_OPAQUE, 0u, 0u));
+	CATCH_CHECK(stats.m_MicroTriangles == 0);
+	CATCH_CHECK(stats.FetchesEliminated() == Catch::Approx(1.0));
+
+	// Materials without a texture only have the factor, here below the cutoff
+	settings.m_AlphaScale = 0.4f;
+	micromap = BuildOpacityMicromap(mesh.m_Positions, mesh.m_UVs, mesh.m_Indices, AlphaTexture(), settings);
+	for (uint32_t descriptor : micromap)
+		CATCH_CHECK(descriptor == OpacityMicromap::OpacityDescriptor(OpacityMicromap::OPACITY_TRANSPARENT, 0u, 0u));
+
+	// 16 bit alpha keeps its precision, these are just below and above the cutoff
+	settings.m_AlphaScale = 1.f;
+	texture.m_Alpha.assign(64, 0x7fff);
+	micromap = BuildOpacityMicromap(mesh.m_Positions, mesh.m_UVs, mesh.m_Indices, texture, settings);
+	for (uint32_t descriptor : micromap)
+		CATCH_CHECK(descriptor == OpacityMicromap::OpacityDescriptor(OpacityMicromap::OPACITY_TRANSPARENT, 0u, 0u));
+	texture.m_Alpha.assign(64, 0x8000);
+	micromap = BuildOpacityMicromap(mesh.m_Positions, mesh.m_UVs, mesh.m_Indices, texture, settings);
+	for (uint32_t descriptor : micromap)
+		CATCH_CHECK(descriptor == OpacityMicromap::OpacityDescriptor(OpacityMicromap::OPACITY_OPAQUE, 0u, 0u));
+}
+
+// Fetches eliminated and memory per subdivision level on a 1K foliage texture, run with [.benchmark]
+CATCH_TEST_CASE("Opacity micromap bake benchmark", "[.benchmark]")
+{
+	const AlphaTexture texture = MakeFoliageTexture(1024);
+	const FoliageMesh mesh = MakeFoliageMesh(16, glm::vec2(0.f), 1.f);
+	std::printf("%-6s %12s %14s %10s %10s\n", "Level", "Eliminated", "MicroTris", "KB", "ms");
+	for (uint32_t level = 0; level <= OpacityMicromap::OPACITY_MAX_LEVEL; level++)
+	{
+		OpacityMicromapSettings settings;
+		settings.m_MaxLevel = level;
+		settings.m_TexelsPerMicroTriangle = 1.f;
+		OpacityMicromapStats stats;
+		const auto start = std::chrono::high_resolution_clock::now();
+		const std::vector<uint32_t> micromap =
+			BuildOpacityMicromap(mesh.m_Positions, mesh.m_UVs, mesh.m_Indices, texture, settings, &stats);
+		const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+		std::printf("%-6u %11.1f%% %14zu %10.1f %10.1f\n",
+					level,
+					stats.FetchesEliminated() * 100.0,
+					stats.m_MicroTriangles,
+					micromap.size() * sizeof(uint32_t) / 1024.0,
+					duration.count());
+	}
+}
@@ -3,6 +3,10 @@
 #include "FileIO.h"
 #include "GameObjects/GameObject.h"
 #include "GameObjects/Serialization/ObjectSerializer.h"
+#include "GameObjects/Serialization/PrefabCache.h"
+
+#include <chrono>
+#include <memory>
 
 class PrefabTestObject : public Ball::GameObject
 {
@@ -47,4 +51,60 @@ CATCH_TEST_CASE("Prefabs")
 		// As this object is not added to a level, we have to delete it !
 		delete object;
 	}
-}
\ No newline at end of file
+
+	CATCH_SECTION("Cached instantiation matches loading the prefab")
+	{
+		Ball::PrefabCache cache;
+
+		std::unique_ptr<Ball::GameObject> loaded(Ball::ObjectSerializer::LoadPrefab("PrefabUnitTest"));
+		std::unique_ptr<Ball::GameObject> first(cache.Instantiate("PrefabUnitTest"));
+		std::unique_ptr<Ball::GameObject> second(cache.Instantiate("PrefabUnitTest"));
+		CATCH_CHECK(cache.GetCachedCount() == 1);
+
+		for (Ball::GameObject* object : {first.get(), second.get()})
+		{
+			auto* cached = dynamic_cast<PrefabTestObject*>(object);
+			auto* uncached = dynamic_cast<PrefabTestObject*>(loaded.get());
+			CATCH_REQUIRE(cached);
+			CATCH_REQUIRE(uncached);
+			CATCH_CHECK(cached->GetPrefabName() == uncached->GetPrefabName());
+			CATCH_CHECK(cached->GetModelPath() == uncached->GetModelPath());
+			CATCH_CHECK(cached->m_TextField == uncached->m_TextField);
+			CATCH_CHECK(cached->m_IndexValue == uncached->m_IndexValue);
+			CATCH_CHECK(cached->GetTransform().GetPosition() == uncached->GetTransform().GetPosition());
+			CATCH_CHECK(cached->GetTransform().GetRotation() == uncached->GetTransform().GetRotation());
+			CATCH_CHECK(cached->GetTransform().GetScale() == uncached->GetTransform().GetScale());
+		}
+
+		// Every spawn is its own object
+		dynamic_cast<PrefabTestObject*>(first.get())->m_IndexValue = 1;
+		CATCH_CHECK(dynamic_cast<PrefabTestObject*>(second.get())->m_IndexValue == -999);
+
+		cache.Invalidate("PrefabUnitTest");
+		CATCH_CHECK(cache.GetCachedCount() == 0);
+		std::unique_ptr<Ball::GameObject> reloaded(cache.Instantiate("PrefabUnitTest"));
+		CATCH_CHECK(dynamic_cast<PrefabTestObject*>(reloaded.get())->m_IndexValue == -999);
+	}
+}
+
+CATCH_TEST_CASE("Prefab spawns per second", "[.benchmark]")
+{
+	constexpr int spawnCount = 1000;
+
+	const auto measure = [](const auto& spawn)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < spawnCount; i++)
+			delete spawn();
+		const std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+		return spawnCount / duration.count();
+	};
+
+	Ball::PrefabCache cache;
+	const double uncached = measure([]() { return Ball::ObjectSerializer::LoadPrefab("PrefabUnitTest"); });
+	const double cached = measure([&cache]() { return cache.Instantiate("PrefabUnitTest"); });
+
+	CATCH_WARN("Uncached: " << static_cast<int>(uncached) << " spawns per second, cached: " << static_cast<int>(cached)
+						  << " spawns per second");
+	CATCH_CHECK(cached > uncached);
+}
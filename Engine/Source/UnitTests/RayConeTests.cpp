@@ -0,0 +1,244 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "Rendering/ModelLoading/Model.h"
+#include "ShaderHeaders/RayConeGPU.h"
+
+using namespace Ball;
+
+namespace
+{
+	constexpr float CONE_TEXTURE_SIZE = 1024.f;
+
+	// Textured plane, the texture repeats every m_TileSize in both directions
+	struct ConePlane
+	{
+		glm::vec3 m_Origin;
+		glm::vec3 m_Tangent;
+		glm::vec3 m_Bitangent;
+		glm::vec3 m_Normal;
+		float m_TileSize;
+
+		// Baked like Model::CreateTriangleLODBuffers does for one triangle of the plane
+		float LODConstant() const
+		{
+			const std::vector<glm::vec3> positions = {
+				m_Origin, m_Origin + m_Tangent * m_TileSize, m_Origin + m_Bitangent * m_TileSize};
+			const std::vector<glm::vec2> uvs = {glm::vec2(0.f, 0.f), glm::vec2(1.f, 0.f), glm::vec2(0.f, 1.f)};
+			return RayCone::UnpackTriangleLOD(BuildTriangleLODs(positions, uvs, {}, {0, 1, 2})[0]).x;
+		}
+
+		// Hit distance and texture coordinates in texels
+		bool Intersect(const glm::vec3& origin, const glm::vec3& direction, float& t, glm::vec2& texel) const
+		{
+			const float denom = glm::dot(direction, m_Normal);
+			if (std::abs(denom) < 1e-6f)
+				return false;
+			t = glm::dot(m_Origin - origin, m_Normal) / denom;
+			const glm::vec3 local = origin + direction * t - m_Origin;
+			texel = glm::vec2(glm::dot(local, m_Tangent), glm::dot(local, m_Bitangent)) / m_TileSize;
+			texel *= CONE_TEXTURE_SIZE;
+			return t > 0.f;
+		}
+	};
+
+	ConePlane MakeTiltedPlane(float distance, float tilt, float tileSize)
+	{
+		ConePlane plane;
+		plane.m_Normal = glm::vec3(0.f, std::sin(tilt), -std::cos(tilt));
+		plane.m_Tangent = glm::vec3(1.f, 0.f, 0.f);
+		plane.m_Bitangent = glm::cross(plane.m_Normal, plane.m_Tangent);
+		plane.m_Origin = glm::vec3(0.f, 0.f, distance);
+		plane.m_TileSize = tileSize;
+		return plane;
+	}
+
+	// Brute force reference, the mip a ray differential gives: rays one pixel (spread) apart along both screen axes,
+	// log2 of the longer axis of the footprint in texels
+	float ReferenceMip(const ConePlane& plane, const glm::vec3& direction, float spread)
+	{
+		const glm::vec3 screenX = glm::normalize(glm::cross(glm::vec3(0.f, 1.f, 0.f), direction));
+		const glm::vec3 screenY = glm::cross(direction, screenX);
+
+		float t = 0.f;
+		glm::vec2 center(0.f), offsetX(0.f), offsetY(0.f);
+		plane.Intersect(glm::vec3(0.f), direction, t, center);
+		plane.Intersect(glm::vec3(0.f), glm::normalize(direction + screenX * std::tan(spread)), t, offsetX);
+		plane.Intersect(glm::vec3(0.f), glm::normalize(direction + screenY * std::tan(spread)), t, offsetY);
+		const float longest = (std::max)(glm::length(offsetX - center), glm::length(offsetY - center));
+		return (std::max)(std::log2(longest), 0.f);
+	}
+
+	float ConeMip(const ConePlane& plane, const glm::vec3& direction, float spread)
+	{
+		float t = 0.f;
+		glm::vec2 texel(0.f);
+		plane.Intersect(glm::vec3(0.f), direction, t, texel);
+		const float width = RayCone::PropagateConeWidth(0.f, spread, t);
+		const float cosTheta = glm::dot(direction, plane.m_Normal);
+		const float lod = RayCone::ConeMaterialLOD(plane.LODConstant(), width, cosTheta, 0.f);
+		return RayCone::TextureMipLevel(lod, CONE_TEXTURE_SIZE, CONE_TEXTURE_SIZE);
+	}
+
+	glm::vec3 SpherePoint(float theta, float phi)
+	{
+		return glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+	}
+
+	// Curvature a small triangle of a tessellated sphere bakes, with normals pointing out or in
+	float BakedSphereCurvature(float radius, bool inwards)
+	{
+		const glm::vec3 n0 = SpherePoint(0.7f, 0.2f);
+		const glm::vec3 n1 = SpherePoint(0.75f, 0.2f);
+		const glm::vec3 n2 = SpherePoint(0.7f, 0.25f);
+		const float sign = inwards ? -1.f : 1.f;
+		const std::vector<uint32_t> packed = BuildTriangleLODs(
+			{n0 * radius, n1 * radius, n2 * radius}, {glm::vec2(0.f), glm::vec2(1.f, 0.f), glm::vec2(0.f, 1.f)},
+			{n0 * sign, n1 * sign, n2 * sign}, {0, 1, 2});
+		return RayCone::UnpackTriangleLOD(packed[0]).y;
+	}
+
+	// Angle between the two edges of a parallel beam after they reflect off a sphere. The center of the beam hits the
+	// sphere at the origin, where the normal is -z, the edges are offset in the plane of incidence. In doubles, the
+	// angles are too small for floats
+	float ReflectedBeamSpread(double radius, double width, double incidence)
+	{
+		const glm::dvec3 direction = glm::dvec3(std::sin(incidence), 0.0, std::cos(incidence));
+		const glm::dvec3 across = glm::dvec3(std::cos(incidence), 0.0, -std::sin(incidence));
+		const glm::dvec3 center = glm::dvec3(0.0, 0.0, radius);
+
+		glm::dvec3 reflected[2];
+		for (int i = 0; i < 2; i++)
+		{
+			const glm::dvec3 origin = -direction * radius + across * (i == 0 ? -0.5 : 0.5) * width;
+			const glm::dvec3 oc = origin - center;
+			const double b = glm::dot(oc, direction);
+			const double c = glm::dot(oc, oc) - radius * radius;
+			const double t = -b - std::sqrt(b * b - c);
+			const glm::dvec3 hitNormal = glm::normalize(origin + direction * t - center);
+			reflected[i] = glm::reflect(direction, hitNormal);
+		}
+		return static_cast<float>(std::acos(glm::clamp(glm::dot(reflected[0], reflected[1]), -1.0, 1.0)));
+	}
+} // namespace
+
+CATCH_TEST_CASE("Ray cones bake the texel density of triangles", "[RayCone]")
+{
+	CATCH_SECTION("A triangle with the uv area of its world area has a constant of 0")
+	{
+		const std::vector<uint32_t> packed = BuildTriangleLODs(
+			{glm::vec3(0.f), glm::vec3(2.f, 0.f, 0.f), glm::vec3(0.f, 2.f, 0.f)},
+			{glm::vec2(0.f), glm::vec2(2.f, 0.f), glm::vec2(0.f, 2.f)}, {}, {0, 1, 2});
+		const glm::vec2 triangleLOD = RayCone::UnpackTriangleLOD(packed[0]);
+		CATCH_CHECK(triangleLOD.x == Catch::Approx(0.f).margin(1e-3f));
+		CATCH_CHECK(triangleLOD.y == 0.f);
+	}
+
+	CATCH_SECTION("Every halving of the uv size lowers the constant by a mip")
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			const float uvSize = std::exp2(-static_cast<float>(i));
+			const std::vector<uint32_t> packed = BuildTriangleLODs(
+				{glm::vec3(0.f), glm::vec3(3.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 3.f)},
+				{glm::vec2(0.f), glm::vec2(uvSize, 0.f), glm::vec2(0.f, uvSize)}, {}, {0, 1, 2});
+			const float expected = -static_cast<float>(i) - std::log2(3.f);
+			CATCH_CHECK(RayCone::UnpackTriangleLOD(packed[0]).x == Catch::Approx(expected).margin(5e-3f));
+		}
+	}
+
+	CATCH_SECTION("Degenerate triangles pick the finest mip")
+	{
+		const std::vector<uint32_t> packed = BuildTriangleLODs(
+			{glm::vec3(0.f), glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f)},
+			{glm::vec2(0.5f), glm::vec2(0.5f), glm::vec2(0.5f)}, {}, {0, 1, 2});
+		CATCH_CHECK(RayCone::UnpackTriangleLOD(packed[0]).x == RayCone::TRIANGLE_LOD_MIN);
+	}
+
+	CATCH_SECTION("Scaled instances move the constant by the log2 of the scale")
+	{
+		for (float scale : {0.25f, 1.f, 3.f, 100.f})
+		{
+			CATCH_CHECK(RayCone::TransformScaleLog2(scale * scale * scale) ==
+						Catch::Approx(std::log2(scale)).margin(1e-5f));
+		}
+		CATCH_CHECK(RayCone::TransformScaleLog2(0.f) == 0.f);
+	}
+
+	CATCH_SECTION("Curvature is one over the radius of a sphere, negative seen from inside")
+	{
+		for (float radius : {0.5f, 2.f, 10.f})
+		{
+			CATCH_CHECK(BakedSphereCurvature(radius, false) == Catch::Approx(1.f / radius).epsilon(0.01f));
+			CATCH_CHECK(BakedSphereCurvature(radius, true) == Catch::Approx(-1.f / radius).epsilon(0.01f));
+		}
+	}
+}
+
+CATCH_TEST_CASE("Ray cone mips match ray differentials", "[RayCone]")
+{
+	const float spread = 1e-3f;
+	for (float distance : {1.f, 10.f, 100.f})
+	{
+		for (float tilt : {0.f, 0.5f, 1.f, 1.2f})
+		{
+			for (float tileSize : {0.5f, 4.f})
+			{
+				const ConePlane plane = MakeTiltedPlane(distance, tilt, tileSize);
+				const glm::vec3 direction = glm::vec3(0.f, 0.f, 1.f);
+				CATCH_CHECK(ConeMip(plane, direction, spread) ==
+							Catch::Approx(ReferenceMip(plane, direction, spread)).margin(0.05f));
+			}
+		}
+	}
+
+	CATCH_SECTION("Off axis rays")
+	{
+		const ConePlane plane = MakeTiltedPlane(5.f, 0.6f, 1.f);
+		for (float angle : {-0.4f, -0.2f, 0.2f, 0.4f})
+		{
+			const glm::vec3 direction = glm::normalize(glm::vec3(angle, 0.5f * angle, 1.f));
+			CATCH_CHECK(ConeMip(plane, direction, spread) ==
+						Catch::Approx(ReferenceMip(plane, direction, spread)).margin(0.1f));
+		}
+	}
+
+	CATCH_SECTION("Footprints smaller than a texel read mip 0")
+	{
+		CATCH_CHECK(ConeMip(MakeTiltedPlane(0.1f, 0.f, 100.f), glm::vec3(0.f, 0.f, 1.f), spread) == 0.f);
+	}
+
+	CATCH_SECTION("The bias is added in mips")
+	{
+		const float lod = RayCone::ConeMaterialLOD(-2.f, 0.01f, 1.f, 0.f);
+		CATCH_CHECK(RayCone::ConeMaterialLOD(-2.f, 0.01f, 1.f, 1.5f) == Catch::Approx(lod + 1.5f));
+	}
+}
+
+CATCH_TEST_CASE("Ray cones spread like beams reflected off curved mirrors", "[RayCone]")
+{
+	const float radius = 2.f;
+	const float width = 1e-3f;
+	for (float incidence : {0.f, 0.5f, 1.f})
+	{
+		const float curvature = BakedSphereCurvature(radius, false);
+		const float spread = RayCone::BounceConeSpread(0.f, width, curvature, std::cos(incidence), 0.f);
+		CATCH_CHECK(spread == Catch::Approx(ReflectedBeamSpread(radius, width, incidence)).epsilon(0.03f));
+	}
+
+	CATCH_SECTION("Concave mirrors focus the cone")
+	{
+		const float curvature = BakedSphereCurvature(radius, true);
+		CATCH_CHECK(RayCone::BounceConeSpread(0.f, width, curvature, 1.f, 0.f) < 0.f);
+		CATCH_CHECK(RayCone::BounceConeSpread(0.01f, width, curvature, 1.f, 0.f) < 0.01f);
+	}
+
+	CATCH_SECTION("Flat mirrors keep the spread, rough lobes add theirs and the spread stays bounded")
+	{
+		CATCH_CHECK(RayCone::BounceConeSpread(0.01f, 1.f, 0.f, 0.3f, 0.f) == Catch::Approx(0.01f));
+		CATCH_CHECK(RayCone::BounceConeSpread(0.01f, 1.f, 0.f, 0.3f, 0.2f) == Catch::Approx(0.21f));
+		CATCH_CHECK(RayCone::BounceConeSpread(0.01f, 1.f, 1000.f, 0.01f, 0.f) == RayCone::RAY_CONE_MAX_SPREAD);
+	}
+}
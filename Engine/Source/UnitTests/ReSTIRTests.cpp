@@ -0,0 +1,187 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <cmath>
+#include <cstdio>
+
+#include "Rendering/ReSTIRReference.h"
+#include "ShaderHeaders/ReservoirGPU.h"
+
+using namespace Ball;
+
+namespace
+{
+	constexpr ReuseStrategy REUSE_STRATEGIES[] = {ReuseStrategy::RIS,
+												  ReuseStrategy::TEMPORAL,
+												  ReuseStrategy::SPATIAL,
+												  ReuseStrategy::TEMPORAL_SPATIAL};
+	constexpr ReservoirCombine RESERVOIR_COMBINES[] = {ReservoirCombine::BIASED_SOURCE_TARGET,
+													   ReservoirCombine::BIASED,
+													   ReservoirCombine::GENERALIZED_BALANCE,
+													   ReservoirCombine::PAIRWISE};
+
+	ReSTIRReferenceResult RunReSTIR(ReuseStrategy strategy, ReservoirCombine combine, uint32_t numTrials = 64)
+	{
+		ReSTIRReferenceSettings settings;
+		settings.m_Strategy = strategy;
+		settings.m_Combine = combine;
+		settings.m_NumTrials = numTrials;
+		return RunReSTIRReference(settings);
+	}
+} // namespace
+
+CATCH_TEST_CASE("ReSTIR reservoir operations")
+{
+	CATCH_SECTION("Empty reservoirs are invalid")
+	{
+		Reservoir reservoir = ReSTIR::InitEmptyReservoir();
+		CATCH_REQUIRE_FALSE(ReSTIR::isReservoirValid(reservoir));
+		ReSTIR::CalculateReservoirWeight(reservoir);
+		CATCH_REQUIRE(reservoir.m_Weight == 0.f);
+	}
+
+	CATCH_SECTION("Streaming picks candidates proportional to their weight")
+	{
+		constexpr int NUM_RUNS = 20000;
+		const float pHats[3] = {1.f, 2.f, 5.f};
+		int picked[3] = {};
+		uint32_t seed = 11;
+		for (int run = 0; run < NUM_RUNS; run++)
+		{
+			Reservoir reservoir = ReSTIR::InitEmptyReservoir();
+			for (uint32_t i = 0; i < 3; i++)
+				ReSTIR::UpdateReservoir(reservoir, i, pHats[i], 1.f, 1.f, seed);
+			picked[reservoir.m_PickedLightIdx]++;
+
+			// W = wSum / (pHat * M)
+			ReSTIR::CalculateReservoirWeight(reservoir);
+			CATCH_REQUIRE(reservoir.m_Weight == Catch::Approx(8.f / (reservoir.m_PHat * 3.f)));
+		}
+		for (int i = 0; i < 3; i++)
+		{
+			const double expected = pHats[i] / 8.0 * NUM_RUNS;
+			CATCH_REQUIRE(std::abs(picked[i] - expected) < 4.0 * std::sqrt(expected));
+		}
+	}
+
+	CATCH_SECTION("MIS weights sum up to one")
+	{
+		const float M[3] = {4.f, 16.f, 7.f};
+		const float pHat[3] = {0.3f, 1.2f, 0.f};
+
+		float confidencePHatSum = 0.f;
+		for (int i = 0; i < 3; i++)
+			confidencePHatSum += M[i] * pHat[i];
+		float balanceSum = 0.f;
+		for (int i = 0; i < 3; i++)
+			balanceSum += ReSTIR::GeneralizedBalanceWeight(M[i], pHat[i], confidencePHatSum);
+		CATCH_REQUIRE(balanceSum == Catch::Approx(1.f));
+
+		// Canonical reservoir 0, neighbours 1 and 2
+		float pairwiseSum = 0.f;
+		for (int i = 1; i < 3; i++)
+		{
+			pairwiseSum += ReSTIR::PairwiseNeighbourWeight(M[i], pHat[i], M[0], pHat[0], 2.f);
+			pairwiseSum += ReSTIR::PairwiseCanonicalWeight(M[i], pHat[i], M[0], pHat[0], 2.f);
+		}
+		CATCH_REQUIRE(pairwiseSum == Catch::Approx(1.f));
+	}
+}
+
+CATCH_TEST_CASE("ReSTIR unbiased reuse")
+{
+	for (ReuseStrategy strategy : REUSE_STRATEGIES)
+	{
+		for (ReservoirCombine combine : {ReservoirCombine::GENERALIZED_BALANCE, ReservoirCombine::PAIRWISE})
+		{
+			const ReSTIRReferenceResult result = RunReSTIR(strategy, combine);
+			CATCH_INFO(ToString(strategy) << ", " << ToString(combine) << ": bias " << result.m_RelativeBias << " +- "
+										  << result.m_BiasStandardError);
+			CATCH_REQUIRE(result.m_BiasStandardError > 0.0);
+			CATCH_REQUIRE(std::abs(result.m_RelativeBias) < 4.0 * result.m_BiasStandardError);
+		}
+	}
+}
+
+CATCH_TEST_CASE("ReSTIR biased reuse is measurable")
+{
+	// No normal test, so neighbours from behind the wall, that can't see the lights of this side, are reused
+	ReSTIRReferenceSettings settings;
+	settings.m_Strategy = ReuseStrategy::SPATIAL;
+	settings.m_NormalThreshold = 2.f;
+	settings.m_SpatialRadius = 10.f;
+	settings.m_NumTrials = 128;
+
+	ReSTIRReferenceResult results[4];
+	for (ReservoirCombine combine : RESERVOIR_COMBINES)
+	{
+		settings.m_Combine = combine;
+		results[static_cast<int>(combine)] = RunReSTIRReference(settings);
+	}
+
+	for (ReservoirCombine combine : {ReservoirCombine::BIASED_SOURCE_TARGET, ReservoirCombine::BIASED})
+	{
+		const ReSTIRReferenceResult& result = results[static_cast<int>(combine)];
+		CATCH_INFO(ToString(combine) << ": bias " << result.m_RelativeBias << " +- " << result.m_BiasStandardError);
+		CATCH_REQUIRE(std::abs(result.m_RelativeBias) > 4.0 * result.m_BiasStandardError);
+	}
+
+	const ReSTIRReferenceResult& biased = results[static_cast<int>(ReservoirCombine::BIASED)];
+	for (ReservoirCombine combine : {ReservoirCombine::GENERALIZED_BALANCE, ReservoirCombine::PAIRWISE})
+	{
+		const ReSTIRReferenceResult& result = results[static_cast<int>(combine)];
+		CATCH_INFO(ToString(combine) << ": bias " << result.m_RelativeBias << " +- " << result.m_BiasStandardError);
+		CATCH_REQUIRE(std::abs(result.m_RelativeBias) < 4.0 * result.m_BiasStandardError);
+		CATCH_REQUIRE(result.m_PixelBias < 0.5 * biased.m_PixelBias);
+	}
+}
+
+CATCH_TEST_CASE("ReSTIR reuse reduces variance")
+{
+	const ReSTIRReferenceResult ris = RunReSTIR(ReuseStrategy::RIS, ReservoirCombine::PAIRWISE);
+	for (ReuseStrategy strategy : {ReuseStrategy::TEMPORAL, ReuseStrategy::SPATIAL, ReuseStrategy::TEMPORAL_SPATIAL})
+	{
+		const ReSTIRReferenceResult reuse = RunReSTIR(strategy, ReservoirCombine::PAIRWISE);
+		CATCH_INFO(ToString(strategy) << ": " << reuse.m_RelativeVariance << " vs RIS " << ris.m_RelativeVariance);
+		CATCH_REQUIRE(reuse.m_RelativeVariance < ris.m_RelativeVariance);
+	}
+}
+
+// Numbers to tune the reuse settings with, run with [.benchmark]
+CATCH_TEST_CASE("ReSTIR strategy report", "[.benchmark]")
+{
+	std::printf("%-26s %-24s %10s %10s %10s %10s %10s %8s\n", "Strategy", "Combine", "Bias", "StdError",
+				"PixelBias", "Variance", "RMSE", "Evals");
+	for (ReuseStrategy strategy : REUSE_STRATEGIES)
+	{
+		for (ReservoirCombine combine : RESERVOIR_COMBINES)
+		{
+			const ReSTIRReferenceResult result = RunReSTIR(strategy, combine, 256);
+			std::printf("%-26s %-24s %10.5f %10.5f %10.5f %10.5f %10.5f %8.1f\n",
+						ToString(strategy),
+						ToString(combine),
+						result.m_RelativeBias,
+						result.m_BiasStandardError,
+						result.m_PixelBias,
+						result.m_RelativeVariance,
+						result.m_RelativeRMSE,
+						result.m_TargetEvaluations);
+		}
+	}
+
+	// Influence of the history clamp on temporal only reuse
+	for (int clamp : {1, 5, 20, 50})
+	{
+		ReSTIRReferenceSettings settings;
+		settings.m_Strategy = ReuseStrategy::TEMPORAL;
+		settings.m_Combine = ReservoirCombine::BIASED_SOURCE_TARGET;
+		settings.m_CurrentLightClamp = clamp;
+		settings.m_NumFrames = 32;
+		const ReSTIRReferenceResult result = RunReSTIRReference(settings);
+		std::printf("Temporal clamp %2d: bias %.5f +- %.5f, pixel bias %.5f, variance %.5f\n",
+					clamp,
+					result.m_RelativeBias,
+					result.m_BiasStandardError,
+					result.m_PixelBias,
+					result.m_RelativeVariance);
+	}
+}
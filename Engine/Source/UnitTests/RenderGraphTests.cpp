@@ -0,0 +1,222 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include "Rendering/RenderGraph.h"
+
+using namespace Ball;
+
+namespace
+{
+	uint32_t CountBarriers(const RGPass& pass, RGBarrierType type, RGResourceHandle resource)
+	{
+		uint32_t count = 0;
+		for (const auto& barrier : pass.m_Barriers)
+			if (barrier.m_Type == type && barrier.m_Resource == resource)
+				count++;
+		return count;
+	}
+} // namespace
+
+CATCH_TEST_CASE("RenderGraph")
+{
+	constexpr uint64_t MB = 1024 * 1024;
+
+	CATCH_SECTION("Execution order follows data flow")
+	{
+		RenderGraph graph;
+		const auto output = graph.ImportBuffer("Output", MB);
+		graph.MarkOutput(output);
+		const auto a = graph.CreateTransientBuffer("A", MB);
+		const auto b = graph.CreateTransientBuffer("B", MB);
+
+		std::vector<std::string> executed;
+		graph.AddPass("Write A", [&] { executed.push_back("Write A"); }).Write(a);
+		graph.AddPass("Write B", [&] { executed.push_back("Write B"); }).Write(b);
+		graph.AddPass("Combine", [&] { executed.push_back("Combine"); }).Read(a).Read(b).Write(output);
+		graph.Compile();
+		graph.Execute();
+
+		CATCH_REQUIRE(executed == std::vector<std::string>{"Write A", "Write B", "Combine"});
+
+		// Both writers are independent of each other, Combine has to wait for both
+		const auto& passes = graph.GetPasses();
+		CATCH_CHECK(passes[0].m_DependencyLevel == 0);
+		CATCH_CHECK(passes[1].m_DependencyLevel == 0);
+		CATCH_CHECK(passes[2].m_DependencyLevel == 1);
+	}
+
+	CATCH_SECTION("Unused passes are culled")
+	{
+		RenderGraph graph;
+		const auto output = graph.ImportBuffer("Output", MB);
+		graph.MarkOutput(output);
+		const auto used = graph.CreateTransientBuffer("Used", MB);
+		const auto unused = graph.CreateTransientBuffer("Unused", MB);
+
+		graph.AddPass("Producer").Write(used);
+		graph.AddPass("Dead End").Write(unused);
+		graph.AddPass("Consumer").Read(used).Write(output);
+		graph.Compile();
+
+		CATCH_CHECK(!graph.GetPasses()[0].m_Culled);
+		CATCH_CHECK(graph.GetPasses()[1].m_Culled);
+		CATCH_CHECK(!graph.GetPasses()[2].m_Culled);
+		CATCH_CHECK(graph.GetStats().m_NumCulledPasses == 1);
+		CATCH_CHECK(graph.GetResource(unused).m_FirstPass == -1);
+	}
+
+	CATCH_SECTION("Debug passes and their producers are culled when disabled")
+	{
+		RenderGraph graph;
+		const auto output = graph.ImportBuffer("Output", MB);
+		graph.MarkOutput(output);
+		const auto debugData = graph.CreateTransientBuffer("Debug Data", MB);
+
+		graph.AddPass("Main").Write(output);
+		graph.AddPass("Gather Debug Data").Write(debugData);
+		graph.AddPass("Visualize").Read(debugData).ReadWrite(output).Debug();
+
+		graph.Compile();
+		CATCH_CHECK(graph.GetExecutionOrder().size() == 3);
+
+		graph.SetDebugPassesEnabled(false);
+		graph.Compile();
+		CATCH_REQUIRE(graph.GetExecutionOrder().size() == 1);
+		CATCH_CHECK(graph.GetExecutionOrder()[0] == 0);
+	}
+
+	CATCH_SECTION("Disabled passes in a ReadWrite chain keep the earlier writers alive")
+	{
+		RenderGraph graph;
+		const auto output = graph.ImportBuffer("Output", MB);
+		graph.MarkOutput(output);
+		const auto lighting = graph.CreateTransientBuffer("Lighting", MB);
+		const auto color = graph.ImportTexture("Color", MB);
+
+		graph.AddPass("Lighting").Write(lighting);
+		graph.AddPass("Finalize").Read(lighting).ReadWrite(color);
+		graph.AddPass("Grid").ReadWrite(color).Debug();
+		graph.AddPass("Outlines").ReadWrite(color).Debug();
+		graph.AddPass("Tonemap").Read(color).Write(output);
+
+		graph.SetDebugPassesEnabled(false);
+		graph.Compile();
+		CATCH_CHECK(graph.GetExecutionOrder() == std::vector<uint32_t>{0, 1, 4});
+		CATCH_CHECK(graph.GetStats().m_NumCulledPasses == 2);
+
+		// Tonemap depended on Finalize through the disabled passes only, it still can't share its level
+		const auto& passes = graph.GetPasses();
+		CATCH_CHECK(passes[0].m_DependencyLevel == 0);
+		CATCH_CHECK(passes[1].m_DependencyLevel == 1);
+		CATCH_CHECK(passes[4].m_DependencyLevel == 2);
+	}
+
+	CATCH_SECTION("Side effect passes are kept")
+	{
+		RenderGraph graph;
+		const auto data = graph.CreateTransientBuffer("Data", MB);
+		graph.AddPass("Producer").Write(data);
+		graph.AddPass("Writes Bindless Texture").Read(data).SideEffect();
+		graph.Compile();
+
+		CATCH_CHECK(graph.GetStats().m_NumCulledPasses == 0);
+	}
+
+	CATCH_SECTION("Only needed barriers are inserted")
+	{
+		RenderGraph graph;
+		const auto output = graph.ImportBuffer("Output", MB);
+		graph.MarkOutput(output);
+		const auto data = graph.CreateTransientBuffer("Data", MB);
+
+		graph.AddPass("Clear").Write(data);
+		graph.AddPass("Accumulate").ReadWrite(data);
+		graph.AddPass("Read 0").Read(data).Write(output);
+		graph.AddPass("Read 1").Read(data).ReadWrite(output);
+		graph.Compile();
+
+		const auto& passes = graph.GetPasses();
+
+		// Initial transition into UAV
+		CATCH_CHECK(CountBarriers(passes[0], RGBarrierType::TRANSITION, data) == 1);
+		// UAV -> UAV needs a UAV barrier, not a transition
+		CATCH_CHECK(CountBarriers(passes[1], RGBarrierType::UAV, data) == 1);
+		CATCH_CHECK(CountBarriers(passes[1], RGBarrierType::TRANSITION, data) == 0);
+		// UAV -> SRV
+		CATCH_CHECK(CountBarriers(passes[2], RGBarrierType::TRANSITION, data) == 1);
+		// SRV -> SRV needs nothing
+		CATCH_CHECK(passes[3].m_Barriers.size() == 1);
+		CATCH_CHECK(CountBarriers(passes[3], RGBarrierType::UAV, output) == 1);
+
+		CATCH_CHECK(graph.GetStats().m_NumUAVBarriers == 2);
+		CATCH_CHECK(graph.GetStats().m_NumTransitionBarriers == 3);
+	}
+
+	CATCH_SECTION("Barriers are handed out before the pass executes")
+	{
+		RenderGraph graph;
+		const auto data = graph.CreateTransientBuffer("Data", MB);
+		std::vector<std::string> events;
+		graph.AddPass("Write", [&] { events.push_back("Write"); }).Write(data);
+		graph.AddPass("Read", [&] { events.push_back("Read"); }).Read(data).SideEffect();
+		graph.Compile();
+		graph.Execute([&](const RGBarrier& barrier)
+					  { events.push_back(barrier.m_After == RGResourceState::UAV ? "ToUAV" : "ToSRV"); });
+
+		CATCH_REQUIRE(events == std::vector<std::string>{"ToUAV", "Write", "ToSRV", "Read"});
+	}
+
+	CATCH_SECTION("Transient buffers with disjoint lifetimes alias")
+	{
+		RenderGraph graph;
+		const auto output = graph.ImportBuffer("Output", MB);
+		graph.MarkOutput(output);
+		const auto first = graph.CreateTransientBuffer("First", 4 * MB);
+		const auto second = graph.CreateTransientBuffer("Second", 4 * MB);
+		const auto overlapping = graph.CreateTransientBuffer("Overlapping", 2 * MB);
+
+		graph.AddPass("0").Write(first).Write(overlapping);
+		graph.AddPass("1").Read(first).ReadWrite(output);
+		graph.AddPass("2").Write(second);
+		graph.AddPass("3").Read(second).Read(overlapping).ReadWrite(output);
+		graph.Compile();
+
+		const auto& stats = graph.GetStats();
+		CATCH_CHECK(stats.m_TransientBytesUnaliased == 10 * MB);
+		CATCH_CHECK(stats.m_TransientBytesAliased == 6 * MB);
+
+		// First and Second share memory, Overlapping lives next to them
+		CATCH_CHECK(graph.GetResource(first).m_HeapOffset == graph.GetResource(second).m_HeapOffset);
+		CATCH_CHECK(graph.GetResource(overlapping).m_HeapOffset >= 4 * MB);
+		CATCH_CHECK(CountBarriers(graph.GetPasses()[2], RGBarrierType::ALIASING, second) == 1);
+		CATCH_CHECK(stats.m_NumAliasingBarriers == 1);
+	}
+
+	CATCH_SECTION("Imported buffers never alias")
+	{
+		RenderGraph graph;
+		const auto history = graph.ImportBuffer("History", 4 * MB);
+		graph.MarkOutput(history);
+		const auto scratch = graph.CreateTransientBuffer("Scratch", 4 * MB);
+
+		graph.AddPass("0").Write(scratch);
+		graph.AddPass("1").Read(scratch).Write(history);
+		graph.Compile();
+
+		CATCH_CHECK(graph.GetStats().m_TransientBytesUnaliased == 4 * MB);
+		CATCH_CHECK(graph.GetStats().m_TransientBytesAliased == 4 * MB);
+		CATCH_CHECK(graph.GetStats().m_NumAliasingBarriers == 0);
+	}
+
+	CATCH_SECTION("Sizes are rounded up to the heap alignment")
+	{
+		RenderGraph graph;
+		const auto a = graph.CreateTransientBuffer("A", 1);
+		const auto b = graph.CreateTransientBuffer("B", 1);
+		graph.AddPass("0").Write(a).Write(b).SideEffect();
+		graph.Compile();
+
+		CATCH_CHECK(graph.GetStats().m_TransientBytesAliased == 2 * RenderGraph::HEAP_ALIGNMENT);
+		CATCH_CHECK(graph.GetResource(a).m_HeapOffset % RenderGraph::HEAP_ALIGNMENT == 0);
+		CATCH_CHECK(graph.GetResource(b).m_HeapOffset % RenderGraph::HEAP_ALIGNMENT == 0);
+	}
+}
@@ -0,0 +1,396 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+
+#include "Rendering/SamplingTables.h"
+#include "ShaderHeaders/RandomGPU.h"
+
+using namespace Ball;
+
+namespace
+{
+	uint32_t TopBits(uint32_t x, uint32_t numBits)
+	{
+		return numBits == 0 ? 0u : x >> (32u - numBits);
+	}
+
+	// Every elementary interval of area 2^-m holds exactly one of the 2^m points
+	bool IsZeroNet(const std::vector<uint32_t>& xs, const std::vector<uint32_t>& ys, uint32_t m)
+	{
+		for (uint32_t a = 0; a <= m; a++)
+		{
+			std::vector<int> counts(size_t(1) << m, 0);
+			for (size_t i = 0; i < xs.size(); i++)
+				counts[(TopBits(xs[i], a) << (m - a)) | TopBits(ys[i], m - a)]++;
+			for (const int count : counts)
+			{
+				if (count != 1)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// L2 star discrepancy of points in [0, 1)^2, Warnock's formula
+	double StarDiscrepancyL2(const std::vector<glm::dvec2>& points)
+	{
+		const double n = static_cast<double>(points.size());
+		double single = 0.0;
+		double pairs = 0.0;
+		for (const glm::dvec2& p : points)
+		{
+			single += (1.0 - p.x * p.x) * (1.0 - p.y * p.y);
+			for (const glm::dvec2& q : points)
+				pairs += (1.0 - (std::max)(p.x, q.x)) * (1.0 - (std::max)(p.y, q.y));
+		}
+		return std::sqrt(1.0 / 9.0 - single / (2.0 * n) + pairs / (n * n));
+	}
+
+	// Radially averaged power spectrum of one slice, bins by the integer frequency radius
+	std::vector<double> RadialPowerSpectrum(const std::vector<float>& values, uint32_t size)
+	{
+		const double twoPi = 2.0 * 3.14159265358979323846;
+		std::vector<double> power(size, 0.0);
+		std::vector<int> counts(size, 0);
+		for (uint32_t fy = 0; fy < size; fy++)
+		{
+			for (uint32_t fx = 0; fx < size; fx++)
+			{
+				std::complex<double> sum = 0.0;
+				for (uint32_t y = 0; y < size; y++)
+				{
+					for (uint32_t x = 0; x < size; x++)
+					{
+						const double angle = -twoPi * (double(fx * x) + double(fy * y)) / size;
+						const double value = double(values[y * size + x] - 0.5f);
+						sum += value * std::complex<double>(std::cos(angle), std::sin(angle));
+					}
+				}
+				const int dx = fx <= size / 2 ? int(fx) : int(fx) - int(size);
+				const int dy = fy <= size / 2 ? int(fy) : int(fy) - int(size);
+				const uint32_t radius = static_cast<uint32_t>(std::lround(std::sqrt(double(dx * dx + dy * dy))));
+				if (radius < size)
+				{
+					power[radius] += std::norm(sum);
+					counts[radius]++;
+				}
+			}
+		}
+		for (uint32_t r = 0; r < size; r++)
+			power[r] = counts[r] > 0 ? power[r] / counts[r] : 0.0;
+		return power;
+	}
+
+	double MeanPower(const std::vector<double>& spectrum, uint32_t from, uint32_t to)
+	{
+		double sum = 0.0;
+		for (uint32_t r = from; r < to; r++)
+			sum += spectrum[r];
+		return sum / (to - from);
+	}
+
+	// Irradiance / pi of a sky with a bright sun, cosine weighted directions from two uniform numbers
+	double SkyIntegrand(double u, double v)
+	{
+		const double cosTheta = std::sqrt(1.0 - u);
+		const double sinTheta = std::sqrt(u);
+		const double phi = 2.0 * 3.14159265358979323846 * v;
+		const glm::dvec3 direction(sinTheta * std::cos(phi), cosTheta, sinTheta * std::sin(phi));
+		const double sun = (std::max)(glm::dot(direction, glm::normalize(glm::dvec3(0.4, 0.8, 0.2))), 0.0);
+		return 0.3 + direction.y + 4.0 * std::pow(sun, 24.0);
+	}
+
+	struct ConvergenceResult
+	{
+		double m_WhiteRMSE;
+		double m_SobolRMSE;
+	};
+
+	// Error over a tile of pixels that each estimate SkyIntegrand with numSamples samples
+	ConvergenceResult MeasureConvergence(uint32_t numSamples, double reference)
+	{
+		constexpr uint32_t TILE = 32;
+		double whiteError = 0.0;
+		double sobolError = 0.0;
+		for (uint32_t y = 0; y < TILE; y++)
+		{
+			for (uint32_t x = 0; x < TILE; x++)
+			{
+				uint32_t seed = ShaderRandom::GetWangHashSeed(ShaderRandom::CombineIntoSeed(y * TILE + x, 7u, 0u));
+				double white = 0.0;
+				double sobol = 0.0;
+				for (uint32_t i = 0; i < numSamples; i++)
+				{
+					const float u = ShaderRandom::rand(seed);
+					const float v = ShaderRandom::rand(seed);
+					white += SkyIntegrand(u, v);
+
+					const uint32_t dimension = Sampling::SamplingDimension(1u, Sampling::SAMPLE_LIGHT);
+					sobol += SkyIntegrand(Sampling::LowDiscrepancySample(x, y, i, dimension),
+										  Sampling::LowDiscrepancySample(x, y, i, dimension + 1));
+				}
+				whiteError += std::pow(white / numSamples - reference, 2.0);
+				sobolError += std::pow(sobol / numSamples - reference, 2.0);
+			}
+		}
+		return {std::sqrt(whiteError / (TILE * TILE)) / reference, std::sqrt(sobolError / (TILE * TILE)) / reference};
+	}
+
+	// The lattice needs the full mask size, but a couple of slices are enough
+	SamplingTables BuildTestSamplingTables()
+	{
+		BlueNoiseSettings settings;
+		settings.m_Slices = 2;
+		return BuildSamplingTables(settings);
+	}
+} // namespace
+
+CATCH_TEST_CASE("Sobol sequence")
+{
+	const std::vector<uint32_t> matrices = BuildSobolMatrices(MAX_SOBOL_DIMENSIONS);
+	SamplingTables tables;
+	tables.m_Tables = matrices;
+	BindSamplingTables(&tables);
+
+	constexpr uint32_t M = 10;
+	constexpr uint32_t NUM_POINTS = 1u << M;
+
+	CATCH_SECTION("Every dimension is stratified")
+	{
+		for (uint32_t dimension = 0; dimension < MAX_SOBOL_DIMENSIONS; dimension++)
+		{
+			std::vector<int> counts(NUM_POINTS, 0);
+			for (uint32_t i = 0; i < NUM_POINTS; i++)
+				counts[TopBits(Sampling::SobolBits(i, dimension), M)]++;
+			CATCH_CAPTURE(dimension);
+			CATCH_CHECK(std::count(counts.begin(), counts.end(), 1) == NUM_POINTS);
+		}
+	}
+
+	CATCH_SECTION("The first two dimensions are a (0, m, 2)-net")
+	{
+		std::vector<uint32_t> xs, ys;
+		for (uint32_t i = 0; i < NUM_POINTS; i++)
+		{
+			xs.push_back(Sampling::SobolBits(i, 0));
+			ys.push_back(Sampling::SobolBits(i, 1));
+		}
+		CATCH_CHECK(IsZeroNet(xs, ys, M));
+	}
+
+	CATCH_SECTION("Owen scrambling and shuffling keep the net")
+	{
+		// Dimensions 4 and 5 use the matrices of 0 and 1 with their own shuffle
+		for (const uint32_t first : {0u, Sampling::SOBOL_DIMENSIONS})
+		{
+			for (const uint32_t seed : {1u, 99u})
+			{
+				for (const uint32_t m : {4u, 8u})
+				{
+					std::vector<uint32_t> xs, ys;
+					for (uint32_t i = 0; i < (1u << m); i++)
+					{
+						xs.push_back(Sampling::OwenSobolBits(i, first, seed));
+						ys.push_back(Sampling::OwenSobolBits(i, first + 1, seed));
+					}
+					CATCH_CAPTURE(first, seed, m);
+					CATCH_CHECK(IsZeroNet(xs, ys, m));
+				}
+			}
+		}
+	}
+
+	CATCH_SECTION("Scrambles differ between seeds")
+	{
+		int same = 0;
+		for (uint32_t i = 0; i < 64; i++)
+			same += Sampling::OwenSobolBits(i, 0, 1u) == Sampling::OwenSobolBits(i, 0, 2u) ? 1 : 0;
+		CATCH_CHECK(same < 4);
+	}
+
+	BindSamplingTables(nullptr);
+}
+
+CATCH_TEST_CASE("Rank-1 lattice shifts")
+{
+	const SamplingTables tables = BuildTestSamplingTables();
+	CATCH_REQUIRE(tables.m_Tables.size() == Sampling::SAMPLING_TABLES_SIZE);
+	BindSamplingTables(&tables);
+
+	CATCH_SECTION("Every shift appears once per tile")
+	{
+		for (uint32_t dimension = 0; dimension < 48; dimension++)
+		{
+			std::vector<int> counts(Sampling::LATTICE_POINTS, 0);
+			for (uint32_t y = 0; y < Sampling::BLUE_NOISE_SIZE; y++)
+			{
+				for (uint32_t x = 0; x < Sampling::BLUE_NOISE_SIZE; x++)
+					counts[TopBits(Sampling::LatticeShiftBits(x, y, dimension), 12)]++;
+			}
+			CATCH_CAPTURE(dimension);
+			CATCH_CHECK(std::count(counts.begin(), counts.end(), 1) == int(Sampling::LATTICE_POINTS));
+		}
+	}
+
+	CATCH_SECTION("Tiles repeat")
+	{
+		const uint32_t size = Sampling::BLUE_NOISE_SIZE;
+		CATCH_CHECK(Sampling::LatticeShiftBits(3, 5, 7) == Sampling::LatticeShiftBits(3 + size, 5 + 2 * size, 7));
+	}
+
+	CATCH_SECTION("Shifted samples keep a low discrepancy")
+	{
+		constexpr uint32_t NUM_POINTS = 256;
+		uint32_t seed = 5;
+		std::vector<glm::dvec2> random, sobol, shifted;
+		for (uint32_t i = 0; i < NUM_POINTS; i++)
+		{
+			const double x = ShaderRandom::rand(seed);
+			const double y = ShaderRandom::rand(seed);
+			random.push_back(glm::dvec2(x, y));
+
+			const uint32_t dimension = Sampling::SamplingDimension(2u, Sampling::SAMPLE_ENVIRONMENT);
+			const uint32_t sobolX = Sampling::OwenSobolBits(i, dimension, Sampling::SAMPLING_SEED);
+			const uint32_t sobolY = Sampling::OwenSobolBits(i, dimension + 1, Sampling::SAMPLING_SEED);
+			sobol.push_back(glm::dvec2(sobolX / 4294967296.0, sobolY / 4294967296.0));
+			shifted.push_back(glm::dvec2(Sampling::LowDiscrepancySample(21, 40, i, dimension),
+										 Sampling::LowDiscrepancySample(21, 40, i, dimension + 1)));
+		}
+
+		const double randomDiscrepancy = StarDiscrepancyL2(random);
+		const double sobolDiscrepancy = StarDiscrepancyL2(sobol);
+		const double shiftedDiscrepancy = StarDiscrepancyL2(shifted);
+		CATCH_CAPTURE(randomDiscrepancy, sobolDiscrepancy, shiftedDiscrepancy);
+		CATCH_CHECK(sobolDiscrepancy < randomDiscrepancy * 0.25);
+		CATCH_CHECK(shiftedDiscrepancy < randomDiscrepancy * 0.5);
+	}
+
+	BindSamplingTables(nullptr);
+}
+
+CATCH_TEST_CASE("Spatiotemporal blue noise")
+{
+	BlueNoiseSettings settings;
+	settings.m_Size = 32;
+	settings.m_Slices = 8;
+	const std::vector<uint32_t> ranks = BuildBlueNoiseRanks(settings);
+	const uint32_t area = settings.m_Size * settings.m_Size;
+	CATCH_REQUIRE(ranks.size() == area * settings.m_Slices);
+
+	CATCH_SECTION("Every slice is uniform")
+	{
+		for (uint32_t slice = 0; slice < settings.m_Slices; slice++)
+		{
+			std::vector<int> counts(area, 0);
+			for (uint32_t i = 0; i < area; i++)
+				counts[ranks[slice * area + i]]++;
+			CATCH_CHECK(std::count(counts.begin(), counts.end(), 1) == int(area));
+		}
+	}
+
+	CATCH_SECTION("Same masks on every run")
+	{
+		CATCH_CHECK(BuildBlueNoiseRanks(settings) == ranks);
+	}
+
+	CATCH_SECTION("Low frequencies are missing in space")
+	{
+		uint32_t seed = 3;
+		std::vector<double> blue(settings.m_Size, 0.0);
+		std::vector<double> white(settings.m_Size, 0.0);
+		for (uint32_t slice = 0; slice < settings.m_Slices; slice++)
+		{
+			std::vector<float> values(area);
+			std::vector<float> noise(area);
+			for (uint32_t i = 0; i < area; i++)
+			{
+				values[i] = (ranks[slice * area + i] + 0.5f) / area;
+				noise[i] = ShaderRandom::rand(seed);
+			}
+			const std::vector<double> slicePower = RadialPowerSpectrum(values, settings.m_Size);
+			const std::vector<double> noisePower = RadialPowerSpectrum(noise, settings.m_Size);
+			for (uint32_t r = 0; r < settings.m_Size; r++)
+			{
+				blue[r] += slicePower[r];
+				white[r] += noisePower[r];
+			}
+		}
+
+		const uint32_t lowEnd = settings.m_Size / 8;
+		const uint32_t highStart = settings.m_Size / 4;
+		const double blueRatio = MeanPower(blue, 1, lowEnd) / MeanPower(blue, highStart, settings.m_Size / 2);
+		const double whiteRatio = MeanPower(white, 1, lowEnd) / MeanPower(white, highStart, settings.m_Size / 2);
+		CATCH_CAPTURE(blueRatio, whiteRatio);
+		CATCH_CHECK(blueRatio < 0.1);
+		CATCH_CHECK(whiteRatio > 0.5);
+	}
+
+	CATCH_SECTION("Low frequencies are missing in time")
+	{
+		const double twoPi = 2.0 * 3.14159265358979323846;
+		const uint32_t slices = settings.m_Slices;
+		double low = 0.0;
+		double high = 0.0;
+		for (uint32_t i = 0; i < area; i++)
+		{
+			for (const uint32_t frequency : {1u, slices / 2})
+			{
+				std::complex<double> sum = 0.0;
+				for (uint32_t t = 0; t < slices; t++)
+				{
+					const double value = (ranks[t * area + i] + 0.5) / area - 0.5;
+					const double angle = -twoPi * frequency * t / slices;
+					sum += value * std::complex<double>(std::cos(angle), std::sin(angle));
+				}
+				(frequency == 1u ? low : high) += std::norm(sum);
+			}
+		}
+		CATCH_CAPTURE(low, high);
+		CATCH_CHECK(low < high * 0.5);
+	}
+}
+
+CATCH_TEST_CASE("Low discrepancy sampling converges faster")
+{
+	// Midpoint rule over the sample space
+	constexpr int STEPS = 2048;
+	double reference = 0.0;
+	for (int y = 0; y < STEPS; y++)
+	{
+		for (int x = 0; x < STEPS; x++)
+			reference += SkyIntegrand((x + 0.5) / STEPS, (y + 0.5) / STEPS);
+	}
+	reference /= double(STEPS) * STEPS;
+
+	const SamplingTables tables = BuildTestSamplingTables();
+	BindSamplingTables(&tables);
+	ConvergenceResult previous = {};
+	for (const uint32_t numSamples : {16u, 64u, 256u})
+	{
+		const ConvergenceResult result = MeasureConvergence(numSamples, reference);
+		CATCH_CAPTURE(numSamples, result.m_WhiteRMSE, result.m_SobolRMSE);
+		CATCH_CHECK(result.m_SobolRMSE < result.m_WhiteRMSE * (numSamples >= 256u ? 0.25 : 0.75));
+
+		// White noise halves its error with 4x the samples, Sobol does better
+		if (numSamples > 16u)
+			CATCH_CHECK(result.m_SobolRMSE / previous.m_SobolRMSE < 0.4);
+		previous = result;
+	}
+	BindSamplingTables(nullptr);
+}
+
+// Time it takes to build the shipped tables, run with [.benchmark]
+CATCH_TEST_CASE("Sampling tables build benchmark", "[.benchmark]")
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	const SamplingTables tables = BuildSamplingTables();
+	const std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+	std::printf("Built %u x %u x %u blue noise and the Sobol tables in %.1f ms\n",
+				tables.m_BlueNoiseSize,
+				tables.m_BlueNoiseSize,
+				tables.m_BlueNoiseSlices,
+				duration.count());
+}
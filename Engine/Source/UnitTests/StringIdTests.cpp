@@ -0,0 +1,200 @@
+#include <Catch2/catch_amalgamated.hpp>
+
+#include <thread>
+#include <unordered_map>
+
+#include "Utilities/AllocationCounter.h"
+#include "Utilities/StringId.h"
+
+using namespace Ball;
+
+// Literals are hashed by the compiler
+static_assert(StringId("").GetHash() == StringId::FNV_OFFSET_BASIS);
+static_assert(StringId("a").GetHash() == 0xaf63dc4c8601ec8cull);
+static_assert(StringId("foobar").GetHash() == 0x85944171f73967e8ull);
+static_assert(StringId("Resources/").Append("Models/Ball.gltf") == StringId("Resources/Models/Ball.gltf"));
+
+namespace
+{
+	std::vector<std::string> MakeNames(int count)
+	{
+		std::vector<std::string> names;
+		for (int i = 0; i < count; i++)
+			names.push_back("Resources/Models/Level_Object_" + std::to_string(i) + ".gltf");
+		return names;
+	}
+} // namespace
+
+CATCH_TEST_CASE("StringId")
+{
+	CATCH_SECTION("Every string type hashes the same")
+	{
+		const std::string name = "Camera_Forward_Axis";
+		CATCH_CHECK(StringId(name) == StringId("Camera_Forward_Axis"));
+		CATCH_CHECK(StringId(std::string_view(name)) == StringId(name.c_str()));
+		CATCH_CHECK(StringId(name) != StringId("Camera_Right_Axis"));
+
+		// Default ids are invalid, the empty name is a valid name
+		CATCH_CHECK_FALSE(StringId().IsValid());
+		CATCH_CHECK(StringId("").IsValid());
+		CATCH_CHECK(StringId() != StringId(""));
+	}
+
+	CATCH_SECTION("Appending continues the hash")
+	{
+		const std::string prefix = "C:/Game/Resources/";
+		const std::string path = "Textures/Ball.png";
+		CATCH_CHECK(StringId(prefix).Append(path) == StringId(prefix + path));
+		CATCH_CHECK(StringId(prefix).Append("") == StringId(prefix));
+		CATCH_CHECK(StringId(path).Append(prefix) != StringId(prefix + path));
+	}
+
+#ifndef SHIPPING
+	CATCH_SECTION("Interned names can be looked up")
+	{
+		const StringId id = StringId::Intern("StringIdTests_Interned");
+		CATCH_CHECK(id == StringId("StringIdTests_Interned"));
+		CATCH_CHECK(std::string(id.GetDebugName()) == "StringIdTests_Interned");
+		CATCH_CHECK(std::string(StringId("StringIdTests_NeverInterned").GetDebugName()) == "?");
+
+		// Interning again keeps the first entry
+		const size_t count = GetInternedStringCount();
+		CATCH_CHECK(StringId::Intern(std::string("StringIdTests_Interned")) == id);
+		CATCH_CHECK(GetInternedStringCount() == count);
+	}
+
+	CATCH_SECTION("Interning from many threads")
+	{
+		const std::vector<std::string> names = MakeNames(1000);
+		const size_t countBefore = GetInternedStringCount();
+
+		std::vector<std::thread> threads;
+		for (int thread = 0; thread < 8; thread++)
+		{
+			threads.emplace_back(
+				[&names]()
+				{
+					for (const std::string& name : names)
+						StringId::Intern(name);
+				});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+
+		// Other tests may have interned some of the names already
+		CATCH_CHECK(GetInternedStringCount() <= countBefore + names.size());
+		for (const std::string& name : names)
+			CATCH_CHECK(std::string(StringId(name).GetDebugName()) == name);
+	}
+#endif
+
+	CATCH_SECTION("Maps keyed by ids don't allocate on lookups")
+	{
+		if (!AllocationCounter::IsEnabled())
+			CATCH_SKIP("Allocations aren't counted in this build");
+
+		std::unordered_map<StringId, int> map;
+		map.emplace("Jump", 1);
+		map.emplace("Resources/Models/Ball.gltf", 2);
+
+		const std::string prefix = "Resources/";
+		const uint64_t before = AllocationCounter::GetNumAllocations();
+		int found = 0;
+		for (int i = 0; i < 100; i++)
+		{
+			found += map.find("Jump")->second;
+			found += map.find(StringId(prefix).Append("Models/Ball.gltf"))->second;
+		}
+		CATCH_CHECK(AllocationCounter::GetNumAllocations() == before);
+		CATCH_CHECK(found == 300);
+	}
+}
+
+CATCH_TEST_CASE("StringId benchmark", "[.benchmark]")
+{
+	// About the number of resources, prefabs and actions in a level
+	const std::vector<std::string> names = MakeNames(512);
+	std::unordered_map<std::string, int> stringMap;
+	std::unordered_map<StringId, int> idMap;
+	std::vector<StringId> ids;
+	for (int i = 0; i < static_cast<int>(names.size()); i++)
+	{
+		stringMap.emplace(names[i], i);
+		idMap.emplace(StringId(names[i]), i);
+		ids.emplace_back(names[i]);
+	}
+
+	// Lookups the way the resource manager used to do them, prefix + path concatenated into a new string
+	const std::string prefix = "Resources/";
+	std::vector<std::string> relativePaths;
+	for (const std::string& name : names)
+		relativePaths.push_back(name.substr(prefix.size()));
+
+	const auto countAllocations = [](auto&& function)
+	{
+		const uint64_t before = AllocationCounter::GetNumAllocations();
+		function();
+		return AllocationCounter::GetNumAllocations() - before;
+	};
+
+	int sum = 0;
+	const uint64_t stringAllocations = countAllocations(
+		[&]()
+		{
+			for (const std::string& path : relativePaths)
+				sum += stringMap.find(prefix + path)->second;
+		});
+	const uint64_t idAllocations = countAllocations(
+		[&]()
+		{
+			for (const std::string& path : relativePaths)
+				sum += idMap.find(StringId(prefix).Append(path))->second;
+		});
+	if (AllocationCounter::IsEnabled())
+	{
+		CATCH_INFO("Allocations for 512 lookups, string keys: " << stringAllocations << ", id keys: " << idAllocations);
+		CATCH_CHECK(idAllocations == 0);
+	}
+
+	CATCH_BENCHMARK("512 lookups by string")
+	{
+		int found = 0;
+		for (const std::string& name : names)
+			found += stringMap.find(name)->second;
+		return found;
+	};
+
+	CATCH_BENCHMARK("512 lookups by hashing the string")
+	{
+		int found = 0;
+		for (const std::string& name : names)
+			found += idMap.find(StringId(name))->second;
+		return found;
+	};
+
+	CATCH_BENCHMARK("512 lookups by id")
+	{
+		int found = 0;
+		for (const StringId id : ids)
+			found += idMap.find(id)->second;
+		return found;
+	};
+
+	CATCH_BENCHMARK("512 prefixed lookups by concatenated string")
+	{
+		int found = 0;
+		for (const std::string& path : relativePaths)
+			found += stringMap.find(prefix + path)->second;
+		return found;
+	};
+
+	CATCH_BENCHMARK("512 prefixed lookups by appended id")
+	{
+		int found = 0;
+		for (const std::string& path : relativePaths)
+			found += idMap.find(StringId(prefix).Append(path))->second;
+		return found;
+	};
+
+	CATCH_CHECK(sum > 0);
+}
@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "Engine.h"
+#include "Utilities/LaunchParameters.h"
 #include "ObjectManagerTests.cpp"
 #include "AudioTests.cpp"
 #include "FileIOTest.cpp"
@@ -15,6 +16,28 @@
 #include "ResourceTest.cpp"
 #include "PrefabTests.cpp"
 #include "TransformUnitTest.cpp"
+#include "RenderGraphTests.cpp"
+#include "DescriptorAllocatorTests.cpp"
+#include "MemoryTrackerTests.cpp"
+#include "AllocatorTests.cpp"
+#include "FrustumCullingTests.cpp"
+#include "InputTests.cpp"
+#include "InputReplayTests.cpp"
+#include "BenchmarkTests.cpp"
+#include "ImageCompareTests.cpp"
+#include "FieldTableTests.cpp"
+#include "DynamicAABBTreeTests.cpp"
+#include "DebugDrawTests.cpp"
+#include "StringIdTests.cpp"
+#include "BsdfTests.cpp"
+#include "ReSTIRTests.cpp"
+#include "EnergyLUTTests.cpp"
+#include "EnvironmentMapTests.cpp"
+#include "SamplingTests.cpp"
+#include "RayConeTests.cpp"
+#include "OpacityMicromapTests.cpp"
+#include "BlasPolicyTests.cpp"
+#include "FrameSchedulerTests.cpp"
 
 namespace Ball
 {
@@ -34,6 +57,13 @@ namespace Ball
 
 		int returncode = session.run();
 		session.run(2, args);
+
+		// Benchmarks are hidden test cases, they take too long to run every time
+		if (LaunchParameters::Contains("RunBenchmarks"))
+		{
+			const char* benchmarkArgs[2] = {"", "[benchmark]"};
+			session.run(2, benchmarkArgs);
+		}
 		return returncode;
 	}
 } // namespace Ball
@@ -0,0 +1,94 @@
+#include "Utilities/AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+#include "Log.h"
+
+using namespace Ball;
+
+#ifndef SHIPPING
+#define COUNT_ALLOCATIONS
+#endif
+
+#ifdef COUNT_ALLOCATIONS
+// The array and nothrow versions forward to these, the sized and aligned ones are replaced as well because the
+// compiler calls them directly
+void* operator new(size_t bytes)
+{
+	AllocationCounter::OnAllocate(bytes);
+	if (void* memory = std::malloc(bytes == 0 ? 1 : bytes))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void* operator new(size_t bytes, std::align_val_t alignment)
+{
+	AllocationCounter::OnAllocate(bytes);
+	const size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+	void* memory = _aligned_malloc(bytes == 0 ? 1 : bytes, align);
+#else
+	// aligned_alloc wants the size to be a multiple of the alignment
+	void* memory = std::aligned_alloc(align, bytes == 0 ? align : (bytes + align - 1) / align * align);
+#endif
+	if (memory)
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(memory, alignment);
+}
+#endif
+
+bool AllocationCounter::IsEnabled()
+{
+#ifdef COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void AllocationCounter::EndFrame()
+{
+	const uint64_t numAllocations = GetNumAllocations();
+	const uint64_t numBytes = GetNumAllocatedBytes();
+	m_FrameAllocations = numAllocations - m_AllocationsAtFrameStart;
+	m_FrameAllocatedBytes = numBytes - m_BytesAtFrameStart;
+	m_AllocationsAtFrameStart = numAllocations;
+	m_BytesAtFrameStart = numBytes;
+	m_FrameNumber++;
+
+	if (m_LogInterval > 0 && m_FrameNumber % m_LogInterval == 0)
+	{
+		LOG(LOG_GENERIC,
+			"Frame %llu did %llu heap allocations (%llu bytes)",
+			static_cast<unsigned long long>(m_FrameNumber),
+			static_cast<unsigned long long>(m_FrameAllocations),
+			static_cast<unsigned long long>(m_FrameAllocatedBytes));
+	}
+}
@@ -0,0 +1,201 @@
+#include "Utilities/Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Ball
+{
+	namespace
+	{
+		float GetPercentile(const std::vector<float>& sortedSamples, float percentile)
+		{
+			const size_t rank = static_cast<size_t>(std::ceil(percentile * 0.01f * sortedSamples.size()));
+			return sortedSamples[(std::max)(rank, size_t(1)) - 1];
+		}
+
+		bool IsRegression(double baseline, double current, float tolerance, float minimumDifference)
+		{
+			return current > baseline * (1.0 + tolerance) && current - baseline > minimumDifference;
+		}
+
+		template<typename Map>
+		auto& FindOrEmplace(Map& map, std::string_view key)
+		{
+			auto it = map.find(key);
+			if (it == map.end())
+				it = map.emplace(std::string(key), typename Map::mapped_type{}).first;
+			return it->second;
+		}
+	} // namespace
+
+	BenchmarkStatistics BenchmarkStatistics::Calculate(std::vector<float> samples)
+	{
+		BenchmarkStatistics statistics;
+		if (samples.empty())
+			return statistics;
+
+		std::sort(samples.begin(), samples.end());
+
+		double sum = 0.0;
+		for (const float sample : samples)
+			sum += sample;
+
+		statistics.m_Min = samples.front();
+		statistics.m_Mean = static_cast<float>(sum / samples.size());
+		statistics.m_P50 = GetPercentile(samples, 50.f);
+		statistics.m_P90 = GetPercentile(samples, 90.f);
+		statistics.m_P95 = GetPercentile(samples, 95.f);
+		statistics.m_P99 = GetPercentile(samples, 99.f);
+		statistics.m_Max = samples.back();
+		return statistics;
+	}
+
+	BenchmarkRunner::BenchmarkRunner(BenchmarkSettings settings) : m_Settings(std::move(settings))
+	{
+	}
+
+	void BenchmarkRunner::AddSample(std::string_view group, std::string_view name, float value)
+	{
+		if (IsWarmingUp() || IsFinished())
+			return;
+
+		std::vector<float>& samples = FindOrEmplace(FindOrEmplace(m_Samples, group), name);
+		if (samples.empty())
+		{
+			// Reserved up front, so recording doesn't show up in the allocation counts of the measured frames
+			samples.reserve(m_Settings.m_MeasuredFrames);
+			samples.resize(GetMeasuredFrameIndex(), 0.f);
+		}
+
+		// Zones that are entered multiple times per frame add up
+		if (samples.size() == GetMeasuredFrameIndex() + 1)
+			samples.back() += value;
+		else
+			samples.push_back(value);
+	}
+
+	void BenchmarkRunner::SetValue(std::string_view group, std::string_view name, double value)
+	{
+		FindOrEmplace(FindOrEmplace(m_Values, group), name) = value;
+	}
+
+	void BenchmarkRunner::EndFrame()
+	{
+		if (!IsWarmingUp() && !IsFinished())
+		{
+			for (auto& group : m_Samples)
+			{
+				for (auto& metric : group.second)
+				{
+					if (metric.second.size() == GetMeasuredFrameIndex())
+						metric.second.push_back(0.f);
+				}
+			}
+		}
+
+		m_FrameIndex++;
+	}
+
+	BenchmarkStatistics BenchmarkRunner::GetStatistics(std::string_view group, std::string_view name) const
+	{
+		const auto groupIt = m_Samples.find(group);
+		if (groupIt == m_Samples.end())
+			return {};
+
+		const auto metricIt = groupIt->second.find(name);
+		if (metricIt == groupIt->second.end())
+			return {};
+
+		return BenchmarkStatistics::Calculate(metricIt->second);
+	}
+
+	nlohmann::json BenchmarkRunner::ToJson() const
+	{
+		nlohmann::json json;
+		json["name"] = m_Settings.m_Name;
+		json["seed"] = m_Settings.m_Seed;
+		json["warmupFrames"] = m_Settings.m_WarmupFrames;
+		json["measuredFrames"] = m_Settings.m_MeasuredFrames;
+		json["fixedDeltaTime"] = m_Settings.m_FixedDeltaTime;
+
+		nlohmann::json& metrics = json["metrics"];
+		metrics = nlohmann::json::object();
+		for (const auto& group : m_Samples)
+		{
+			for (const auto& metric : group.second)
+			{
+				const BenchmarkStatistics statistics = BenchmarkStatistics::Calculate(metric.second);
+				metrics[group.first][metric.first] = {{"min", statistics.m_Min},
+													  {"mean", statistics.m_Mean},
+													  {"p50", statistics.m_P50},
+													  {"p90", statistics.m_P90},
+													  {"p95", statistics.m_P95},
+													  {"p99", statistics.m_P99},
+													  {"max", statistics.m_Max}};
+			}
+		}
+
+		nlohmann::json& values = json["values"];
+		values = nlohmann::json::object();
+		for (const auto& group : m_Values)
+		{
+			for (const auto& value : group.second)
+				values[group.first][value.first] = value.second;
+		}
+
+		return json;
+	}
+
+	std::vector<BenchmarkRegression> BenchmarkRunner::Compare(const nlohmann::json& baseline,
+															  const nlohmann::json& current, float tolerance,
+															  float minimumDifference)
+	{
+		std::vector<BenchmarkRegression> regressions;
+
+		// Both files have the same layout, group -> name -> statistics or value
+		const auto compareSection = [&](const char* section, bool hasStatistics)
+		{
+			if (!baseline.contains(section) || !current.contains(section))
+				return;
+
+			for (const auto& group : baseline[section].items())
+			{
+				const auto currentGroup = current[section].find(group.key());
+				if (currentGroup == current[section].end())
+					continue;
+
+				for (const auto& metric : group.value().items())
+				{
+					const auto currentMetric = currentGroup->find(metric.key());
+					if (currentMetric == currentGroup->end())
+						continue;
+
+					const std::string metricName = group.key() + "/" + metric.key();
+					if (!hasStatistics)
+					{
+						const double baselineValue = metric.value().get<double>();
+						const double currentValue = currentMetric->get<double>();
+						if (IsRegression(baselineValue, currentValue, tolerance, minimumDifference))
+							regressions.push_back({metricName, baselineValue, currentValue});
+						continue;
+					}
+
+					for (const char* statistic : {"p50", "p95"})
+					{
+						if (!metric.value().contains(statistic) || !currentMetric->contains(statistic))
+							continue;
+
+						const double baselineValue = metric.value()[statistic].get<double>();
+						const double currentValue = (*currentMetric)[statistic].get<double>();
+						if (IsRegression(baselineValue, currentValue, tolerance, minimumDifference))
+							regressions.push_back({metricName + "/" + statistic, baselineValue, currentValue});
+					}
+				}
+			}
+		};
+
+		compareSection("metrics", true);
+		compareSection("values", false);
+		return regressions;
+	}
+} // namespace Ball
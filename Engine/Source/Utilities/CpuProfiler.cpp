@@ -0,0 +1,34 @@
+#include "Utilities/CpuProfiler.h"
+
+#include <cstring>
+
+namespace Ball
+{
+	void CpuProfiler::AddZoneTime(const char* name, float timeInMs)
+	{
+		// Only a handful of zones per frame, a linear search beats hashing the names
+		for (CpuZoneTime& zone : m_FrameZones)
+		{
+			if (zone.m_Name == name || std::strcmp(zone.m_Name, name) == 0)
+			{
+				zone.m_TimeInMs += timeInMs;
+				return;
+			}
+		}
+
+		m_FrameZones.push_back({name, timeInMs});
+	}
+
+	void CpuProfiler::EndFrame()
+	{
+		// Swapping keeps the memory of both vectors around, so a frame doesn't allocate
+		m_LastFrameZones.swap(m_FrameZones);
+		m_FrameZones.clear();
+	}
+
+	CpuProfiler& GetCpuProfiler()
+	{
+		static CpuProfiler profiler;
+		return profiler;
+	}
+} // namespace Ball
@@ -0,0 +1,334 @@
+#include "Utilities/DynamicAABBTree.h"
+
+using namespace Ball;
+
+namespace
+{
+	AABB Union(const AABB& a, const AABB& b)
+	{
+		AABB result = a;
+		result.Grow(b);
+		return result;
+	}
+
+	bool Contains(const AABB& outer, const AABB& inner)
+	{
+		return outer.m_Min.x <= inner.m_Min.x && outer.m_Min.y <= inner.m_Min.y && outer.m_Min.z <= inner.m_Min.z &&
+			inner.m_Max.x <= outer.m_Max.x && inner.m_Max.y <= outer.m_Max.y && inner.m_Max.z <= outer.m_Max.z;
+	}
+
+	// Half the surface area, only used to compare boxes
+	float GetArea(const AABB& box)
+	{
+		const glm::vec3 size = box.m_Max - box.m_Min;
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+
+	AABB Expand(const AABB& box, float distance)
+	{
+		return {box.m_Min - glm::vec3(distance), box.m_Max + glm::vec3(distance)};
+	}
+} // namespace
+
+DynamicAABBTree::DynamicAABBTree(float margin) : m_Margin(margin)
+{
+}
+
+int32_t DynamicAABBTree::CreateProxy(const AABB& bounds, GameObject* object)
+{
+	const int32_t proxyId = AllocateNode();
+	Node& node = m_Nodes[proxyId];
+	node.m_Bounds = bounds;
+	node.m_FatBounds = Expand(bounds, m_Margin);
+	node.m_Object = object;
+	node.m_Height = 0;
+
+	InsertLeaf(proxyId);
+	m_ProxyCount++;
+	return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxyId)
+{
+	ASSERT_MSG(LOG_GENERIC,
+			   proxyId >= 0 && proxyId < static_cast<int32_t>(m_Nodes.size()) && m_Nodes[proxyId].IsLeaf(),
+			   "Invalid proxy id %i",
+			   proxyId);
+
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	m_ProxyCount--;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxyId, const AABB& bounds, const glm::vec3& displacement)
+{
+	ASSERT_MSG(LOG_GENERIC,
+			   proxyId >= 0 && proxyId < static_cast<int32_t>(m_Nodes.size()) && m_Nodes[proxyId].IsLeaf(),
+			   "Invalid proxy id %i",
+			   proxyId);
+
+	Node& node = m_Nodes[proxyId];
+	node.m_Bounds = bounds;
+
+	// Predict where the proxy goes next
+	AABB fatBounds = Expand(bounds, m_Margin);
+	const glm::vec3 prediction = displacement * 4.f;
+	fatBounds.m_Min += glm::min(prediction, glm::vec3(0.f));
+	fatBounds.m_Max += glm::max(prediction, glm::vec3(0.f));
+
+	// Still inside the old fat box, unless that box is a lot larger than needed, e.g. after a fast move stopped
+	if (Contains(node.m_FatBounds, bounds) && Contains(Expand(fatBounds, 4.f * m_Margin), node.m_FatBounds))
+		return false;
+
+	RemoveLeaf(proxyId);
+	m_Nodes[proxyId].m_FatBounds = fatBounds;
+	InsertLeaf(proxyId);
+	return true;
+}
+
+void DynamicAABBTree::Clear()
+{
+	m_Nodes.clear();
+	m_Root = NULL_NODE;
+	m_FreeList = NULL_NODE;
+	m_ProxyCount = 0;
+}
+
+float DynamicAABBTree::GetAreaRatio() const
+{
+	if (m_Root == NULL_NODE)
+		return 0.f;
+
+	const float rootArea = GetArea(m_Nodes[m_Root].m_FatBounds);
+	float totalArea = 0.f;
+	for (const Node& node : m_Nodes)
+	{
+		if (node.m_Height > 0)
+			totalArea += GetArea(node.m_FatBounds);
+	}
+	return rootArea > 0.f ? totalArea / rootArea : 0.f;
+}
+
+bool DynamicAABBTree::Validate() const
+{
+	if (m_Root != NULL_NODE && !ValidateNode(m_Root, NULL_NODE))
+		return false;
+
+	int32_t freeCount = 0;
+	for (int32_t nodeId = m_FreeList; nodeId != NULL_NODE; nodeId = m_Nodes[nodeId].m_Parent)
+		freeCount++;
+
+	// A tree with n leaves has n - 1 internal nodes
+	const int32_t usedCount = m_ProxyCount == 0 ? 0 : 2 * m_ProxyCount - 1;
+	return usedCount + freeCount == static_cast<int32_t>(m_Nodes.size());
+}
+
+int32_t DynamicAABBTree::AllocateNode()
+{
+	if (m_FreeList == NULL_NODE)
+	{
+		m_Nodes.emplace_back();
+		return static_cast<int32_t>(m_Nodes.size()) - 1;
+	}
+
+	const int32_t nodeId = m_FreeList;
+	m_FreeList = m_Nodes[nodeId].m_Parent;
+	m_Nodes[nodeId] = Node();
+	return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int32_t nodeId)
+{
+	Node& node = m_Nodes[nodeId];
+	node.m_Parent = m_FreeList;
+	node.m_Child1 = NULL_NODE;
+	node.m_Child2 = NULL_NODE;
+	node.m_Height = -1;
+	node.m_Object = nullptr;
+	m_FreeList = nodeId;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf)
+{
+	if (m_Root == NULL_NODE)
+	{
+		m_Root = leaf;
+		m_Nodes[leaf].m_Parent = NULL_NODE;
+		return;
+	}
+
+	// Walk down to the sibling with the lowest surface area heuristic cost
+	const AABB leafBounds = m_Nodes[leaf].m_FatBounds;
+	int32_t index = m_Root;
+	while (!m_Nodes[index].IsLeaf())
+	{
+		const Node& node = m_Nodes[index];
+		const float area = GetArea(node.m_FatBounds);
+		const float combinedArea = GetArea(Union(node.m_FatBounds, leafBounds));
+
+		// Cost of making a new parent for this node and the leaf
+		const float cost = 2.f * combinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.f * (combinedArea - area);
+
+		auto getChildCost = [&](int32_t childId)
+		{
+			const Node& child = m_Nodes[childId];
+			const float newArea = GetArea(Union(child.m_FatBounds, leafBounds));
+			return (child.IsLeaf() ? newArea : newArea - GetArea(child.m_FatBounds)) + inheritanceCost;
+		};
+		const float cost1 = getChildCost(node.m_Child1);
+		const float cost2 = getChildCost(node.m_Child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? node.m_Child1 : node.m_Child2;
+	}
+
+	const int32_t sibling = index;
+	const int32_t oldParent = m_Nodes[sibling].m_Parent;
+	const int32_t newParent = AllocateNode();
+
+	// AllocateNode can grow m_Nodes, don't hold references over it
+	Node& parentNode = m_Nodes[newParent];
+	parentNode.m_Parent = oldParent;
+	parentNode.m_FatBounds = Union(leafBounds, m_Nodes[sibling].m_FatBounds);
+	parentNode.m_Height = m_Nodes[sibling].m_Height + 1;
+	parentNode.m_Child1 = sibling;
+	parentNode.m_Child2 = leaf;
+	m_Nodes[sibling].m_Parent = newParent;
+	m_Nodes[leaf].m_Parent = newParent;
+
+	if (oldParent == NULL_NODE)
+		m_Root = newParent;
+	else if (m_Nodes[oldParent].m_Child1 == sibling)
+		m_Nodes[oldParent].m_Child1 = newParent;
+	else
+		m_Nodes[oldParent].m_Child2 = newParent;
+
+	Refit(newParent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+{
+	if (leaf == m_Root)
+	{
+		m_Root = NULL_NODE;
+		return;
+	}
+
+	// The parent of the leaf is replaced by the sibling of the leaf
+	const int32_t parent = m_Nodes[leaf].m_Parent;
+	const int32_t grandParent = m_Nodes[parent].m_Parent;
+	const int32_t sibling =
+		m_Nodes[parent].m_Child1 == leaf ? m_Nodes[parent].m_Child2 : m_Nodes[parent].m_Child1;
+
+	m_Nodes[sibling].m_Parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == NULL_NODE)
+	{
+		m_Root = sibling;
+		return;
+	}
+
+	if (m_Nodes[grandParent].m_Child1 == parent)
+		m_Nodes[grandParent].m_Child1 = sibling;
+	else
+		m_Nodes[grandParent].m_Child2 = sibling;
+
+	Refit(grandParent);
+}
+
+void DynamicAABBTree::Refit(int32_t nodeId)
+{
+	while (nodeId != NULL_NODE)
+	{
+		nodeId = Balance(nodeId);
+
+		Node& node = m_Nodes[nodeId];
+		const Node& child1 = m_Nodes[node.m_Child1];
+		const Node& child2 = m_Nodes[node.m_Child2];
+		node.m_Height = 1 + (std::max)(child1.m_Height, child2.m_Height);
+		node.m_FatBounds = Union(child1.m_FatBounds, child2.m_FatBounds);
+
+		nodeId = node.m_Parent;
+	}
+}
+
+int32_t DynamicAABBTree::Balance(int32_t nodeId)
+{
+	Node& a = m_Nodes[nodeId];
+	if (a.IsLeaf() || a.m_Height < 2)
+		return nodeId;
+
+	const int32_t bId = a.m_Child1;
+	const int32_t cId = a.m_Child2;
+	Node& b = m_Nodes[bId];
+	Node& c = m_Nodes[cId];
+	const int32_t balance = c.m_Height - b.m_Height;
+	if (balance >= -1 && balance <= 1)
+		return nodeId;
+
+	// Moves the taller child up into the place of a, a takes the place of the shorter grandchild
+	const bool rotateC = balance > 1;
+	const int32_t upId = rotateC ? cId : bId;
+	Node& up = rotateC ? c : b;
+	Node& other = rotateC ? b : c;
+
+	const int32_t fId = up.m_Child1;
+	const int32_t gId = up.m_Child2;
+	Node& f = m_Nodes[fId];
+	Node& g = m_Nodes[gId];
+
+	up.m_Child1 = nodeId;
+	up.m_Parent = a.m_Parent;
+	a.m_Parent = upId;
+
+	if (up.m_Parent == NULL_NODE)
+		m_Root = upId;
+	else if (m_Nodes[up.m_Parent].m_Child1 == nodeId)
+		m_Nodes[up.m_Parent].m_Child1 = upId;
+	else
+		m_Nodes[up.m_Parent].m_Child2 = upId;
+
+	// The taller grandchild stays with the node that moved up
+	const bool keepF = f.m_Height > g.m_Height;
+	const int32_t keptId = keepF ? fId : gId;
+	const int32_t movedId = keepF ? gId : fId;
+	Node& kept = keepF ? f : g;
+	Node& moved = keepF ? g : f;
+
+	up.m_Child2 = keptId;
+	if (rotateC)
+		a.m_Child2 = movedId;
+	else
+		a.m_Child1 = movedId;
+	moved.m_Parent = nodeId;
+
+	a.m_FatBounds = Union(other.m_FatBounds, moved.m_FatBounds);
+	a.m_Height = 1 + (std::max)(other.m_Height, moved.m_Height);
+	up.m_FatBounds = Union(a.m_FatBounds, kept.m_FatBounds);
+	up.m_Height = 1 + (std::max)(a.m_Height, kept.m_Height);
+	return upId;
+}
+
+bool DynamicAABBTree::ValidateNode(int32_t nodeId, int32_t parent) const
+{
+	const Node& node = m_Nodes[nodeId];
+	if (node.m_Parent != parent)
+		return false;
+
+	if (node.IsLeaf())
+		return node.m_Child2 == NULL_NODE && node.m_Height == 0 && Contains(node.m_FatBounds, node.m_Bounds);
+
+	const Node& child1 = m_Nodes[node.m_Child1];
+	const Node& child2 = m_Nodes[node.m_Child2];
+	if (node.m_Height != 1 + (std::max)(child1.m_Height, child2.m_Height))
+		return false;
+	if (!Contains(node.m_FatBounds, child1.m_FatBounds) || !Contains(node.m_FatBounds, child2.m_FatBounds))
+		return false;
+
+	return ValidateNode(node.m_Child1, nodeId) && ValidateNode(node.m_Child2, nodeId);
+}
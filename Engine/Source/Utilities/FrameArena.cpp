@@ -0,0 +1,64 @@
+#include "Utilities/FrameArena.h"
+
+#include <new>
+
+namespace Ball
+{
+	FrameArena::FrameArena(size_t bytesPerFrame) : m_BytesPerFrame(bytesPerFrame)
+	{
+		m_Memory[0] = std::make_unique<uint8_t[]>(bytesPerFrame);
+		m_Memory[1] = std::make_unique<uint8_t[]>(bytesPerFrame);
+	}
+
+	void* FrameArena::Allocate(size_t bytes, size_t alignment)
+	{
+		uint8_t* base = m_Memory[m_CurrentHalf].get();
+		const uintptr_t baseAddress = reinterpret_cast<uintptr_t>(base);
+
+		size_t offset = m_Offset.load(std::memory_order_relaxed);
+		size_t alignedOffset;
+		do
+		{
+			const uintptr_t address = (baseAddress + offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+			alignedOffset = address - baseAddress;
+			if (alignedOffset + bytes > m_BytesPerFrame)
+			{
+				m_NumOverflows.fetch_add(1, std::memory_order_relaxed);
+				return ::operator new(bytes, std::align_val_t(alignment));
+			}
+		} while (!m_Offset.compare_exchange_weak(offset, alignedOffset + bytes, std::memory_order_relaxed));
+
+		return base + alignedOffset;
+	}
+
+	void FrameArena::Deallocate(void* memory, size_t alignment)
+	{
+		if (memory != nullptr && !Owns(memory))
+			::operator delete(memory, std::align_val_t(alignment));
+	}
+
+	void FrameArena::BeginFrame()
+	{
+		// The other half was used two frames ago, nothing is allowed to reference it anymore
+		m_CurrentHalf = 1 - m_CurrentHalf;
+		m_Offset.store(0, std::memory_order_relaxed);
+		m_NumOverflows.store(0, std::memory_order_relaxed);
+	}
+
+	bool FrameArena::Owns(const void* memory) const
+	{
+		const uint8_t* pointer = static_cast<const uint8_t*>(memory);
+		for (const auto& half : m_Memory)
+		{
+			if (pointer >= half.get() && pointer < half.get() + m_BytesPerFrame)
+				return true;
+		}
+		return false;
+	}
+
+	FrameArena& GetFrameArena()
+	{
+		static FrameArena arena(4 * 1024 * 1024);
+		return arena;
+	}
+} // namespace Ball
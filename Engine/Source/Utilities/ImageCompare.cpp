@@ -0,0 +1,335 @@
+#include "Utilities/ImageCompare.h"
+
+#include <stb/stb_image.h>
+#include <stb/stb_image_write.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace Ball
+{
+	namespace
+	{
+		// FLIP constants, see "FLIP: A Difference Evaluator for Alternating Images" (Andersson et al. 2020)
+		constexpr float FLIP_COLOR_EXPONENT = 0.7f;
+		constexpr float FLIP_COLOR_COMPRESSION_POINT = 0.4f;
+		constexpr float FLIP_COLOR_COMPRESSION_THRESHOLD = 0.95f;
+		constexpr float FLIP_FEATURE_EXPONENT = 0.5f;
+
+		float SRGBToLinear(float value)
+		{
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		float LabCurve(float value)
+		{
+			constexpr float delta = 6.f / 29.f;
+			return value > delta * delta * delta ? std::cbrt(value) : value / (3.f * delta * delta) + 4.f / 29.f;
+		}
+
+		glm::vec3 LinearToLab(const glm::vec3& color)
+		{
+			// D65 white point
+			const float x = (0.4124f * color.r + 0.3576f * color.g + 0.1805f * color.b) / 0.9505f;
+			const float y = 0.2126f * color.r + 0.7152f * color.g + 0.0722f * color.b;
+			const float z = (0.0193f * color.r + 0.1192f * color.g + 0.9505f * color.b) / 1.089f;
+
+			const float fx = LabCurve(x);
+			const float fy = LabCurve(y);
+			const float fz = LabCurve(z);
+			return {116.f * fy - 16.f, 500.f * (fx - fy), 200.f * (fy - fz)};
+		}
+
+		float HyAB(const glm::vec3& a, const glm::vec3& b)
+		{
+			const float da = a.y - b.y;
+			const float db = a.z - b.z;
+			return std::abs(a.x - b.x) + std::sqrt(da * da + db * db);
+		}
+
+		float Luminance(const glm::vec3& color) { return 0.2126f * color.r + 0.7152f * color.g + 0.0722f * color.b; }
+
+		// Separable 5 tap gaussian with a sigma of 1 pixel, clamped at the borders
+		std::vector<glm::vec3> Blur(const std::vector<glm::vec3>& pixels, uint32_t width, uint32_t height)
+		{
+			constexpr float weights[5] = {0.0545f, 0.2442f, 0.4026f, 0.2442f, 0.0545f};
+			const auto clampIndex = [](int value, uint32_t size)
+			{ return static_cast<uint32_t>(std::clamp(value, 0, static_cast<int>(size) - 1)); };
+
+			std::vector<glm::vec3> horizontal(pixels.size());
+			for (uint32_t y = 0; y < height; y++)
+			{
+				for (uint32_t x = 0; x < width; x++)
+				{
+					glm::vec3 sum(0.f);
+					for (int i = -2; i <= 2; i++)
+						sum += weights[i + 2] * pixels[y * width + clampIndex(static_cast<int>(x) + i, width)];
+					horizontal[y * width + x] = sum;
+				}
+			}
+
+			std::vector<glm::vec3> result(pixels.size());
+			for (uint32_t y = 0; y < height; y++)
+			{
+				for (uint32_t x = 0; x < width; x++)
+				{
+					glm::vec3 sum(0.f);
+					for (int i = -2; i <= 2; i++)
+						sum += weights[i + 2] * horizontal[clampIndex(static_cast<int>(y) + i, height) * width + x];
+					result[y * width + x] = sum;
+				}
+			}
+			return result;
+		}
+
+		// Edge (Sobel) and point (Laplacian) strength of the lightness, both kernels are normalized to [0, 1]
+		void ComputeFeatures(const std::vector<float>& lightness, uint32_t width, uint32_t height,
+							 std::vector<float>& edges, std::vector<float>& points)
+		{
+			edges.resize(lightness.size());
+			points.resize(lightness.size());
+
+			const auto sample = [&](int x, int y)
+			{
+				x = std::clamp(x, 0, static_cast<int>(width) - 1);
+				y = std::clamp(y, 0, static_cast<int>(height) - 1);
+				return lightness[y * width + x];
+			};
+
+			for (int y = 0; y < static_cast<int>(height); y++)
+			{
+				for (int x = 0; x < static_cast<int>(width); x++)
+				{
+					const float gradientX = (sample(x + 1, y - 1) + 2.f * sample(x + 1, y) + sample(x + 1, y + 1) -
+											 sample(x - 1, y - 1) - 2.f * sample(x - 1, y) - sample(x - 1, y + 1)) /
+						4.f;
+					const float gradientY = (sample(x - 1, y + 1) + 2.f * sample(x, y + 1) + sample(x + 1, y + 1) -
+											 sample(x - 1, y - 1) - 2.f * sample(x, y - 1) - sample(x + 1, y - 1)) /
+						4.f;
+					const float laplacian = (sample(x - 1, y) + sample(x + 1, y) + sample(x, y - 1) +
+											 sample(x, y + 1) - 4.f * sample(x, y)) /
+						4.f;
+
+					edges[y * width + x] = std::sqrt(gradientX * gradientX + gradientY * gradientY);
+					points[y * width + x] = std::abs(laplacian);
+				}
+			}
+		}
+
+		bool HaveSameSize(const CompareImage& a, const CompareImage& b)
+		{
+			return a.IsValid() && b.IsValid() && a.m_Width == b.m_Width && a.m_Height == b.m_Height;
+		}
+	} // namespace
+
+	CompareImage CompareImage::Load(const std::string& path)
+	{
+		CompareImage image;
+
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 3);
+		if (data == nullptr)
+			return image;
+
+		image.m_Width = static_cast<uint32_t>(width);
+		image.m_Height = static_cast<uint32_t>(height);
+		image.m_Pixels.resize(image.m_Width * image.m_Height);
+		for (size_t i = 0; i < image.m_Pixels.size(); i++)
+			image.m_Pixels[i] = glm::vec3(data[i * 3], data[i * 3 + 1], data[i * 3 + 2]) / 255.f;
+
+		stbi_image_free(data);
+		return image;
+	}
+
+	bool CompareImage::SavePNG(const std::string& path) const
+	{
+		if (!IsValid())
+			return false;
+
+		std::vector<unsigned char> data(m_Pixels.size() * 3);
+		for (size_t i = 0; i < m_Pixels.size(); i++)
+		{
+			for (int channel = 0; channel < 3; channel++)
+			{
+				const float value = std::clamp(m_Pixels[i][channel], 0.f, 1.f);
+				data[i * 3 + channel] = static_cast<unsigned char>(value * 255.f + 0.5f);
+			}
+		}
+
+		return stbi_write_png(path.c_str(), m_Width, m_Height, 3, data.data(), m_Width * 3) != 0;
+	}
+
+	float ComputeRMSE(const CompareImage& reference, const CompareImage& test)
+	{
+		if (!HaveSameSize(reference, test))
+			return 1.f;
+
+		double sum = 0.0;
+		for (size_t i = 0; i < reference.m_Pixels.size(); i++)
+		{
+			const glm::vec3 difference = reference.m_Pixels[i] - test.m_Pixels[i];
+			sum += glm::dot(difference, difference);
+		}
+
+		return static_cast<float>(std::sqrt(sum / (reference.m_Pixels.size() * 3.0)));
+	}
+
+	float ComputeSSIM(const CompareImage& reference, const CompareImage& test)
+	{
+		if (!HaveSameSize(reference, test))
+			return 0.f;
+
+		// Stabilizing constants for a dynamic range of 1
+		constexpr double c1 = 0.01 * 0.01;
+		constexpr double c2 = 0.03 * 0.03;
+		constexpr uint32_t stride = 4;
+
+		const uint32_t windowWidth = (std::min)(reference.m_Width, 8u);
+		const uint32_t windowHeight = (std::min)(reference.m_Height, 8u);
+		const double windowSize = static_cast<double>(windowWidth * windowHeight);
+
+		double ssimSum = 0.0;
+		uint32_t windowCount = 0;
+		for (uint32_t startY = 0; startY + windowHeight <= reference.m_Height; startY += stride)
+		{
+			for (uint32_t startX = 0; startX + windowWidth <= reference.m_Width; startX += stride)
+			{
+				double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumYY = 0.0, sumXY = 0.0;
+				for (uint32_t y = startY; y < startY + windowHeight; y++)
+				{
+					for (uint32_t x = startX; x < startX + windowWidth; x++)
+					{
+						const double a = Luminance(reference.GetPixel(x, y));
+						const double b = Luminance(test.GetPixel(x, y));
+						sumX += a;
+						sumY += b;
+						sumXX += a * a;
+						sumYY += b * b;
+						sumXY += a * b;
+					}
+				}
+
+				const double meanX = sumX / windowSize;
+				const double meanY = sumY / windowSize;
+				const double varianceX = sumXX / windowSize - meanX * meanX;
+				const double varianceY = sumYY / windowSize - meanY * meanY;
+				const double covariance = sumXY / windowSize - meanX * meanY;
+
+				ssimSum += ((2.0 * meanX * meanY + c1) * (2.0 * covariance + c2)) /
+					((meanX * meanX + meanY * meanY + c1) * (varianceX + varianceY + c2));
+				windowCount++;
+			}
+		}
+
+		return static_cast<float>(ssimSum / windowCount);
+	}
+
+	std::vector<float> ComputeFlipErrorMap(const CompareImage& reference, const CompareImage& test)
+	{
+		if (!HaveSameSize(reference, test))
+			return {};
+
+		const uint32_t width = reference.m_Width;
+		const uint32_t height = reference.m_Height;
+		const size_t pixelCount = reference.m_Pixels.size();
+
+		std::vector<glm::vec3> labReference(pixelCount);
+		std::vector<glm::vec3> labTest(pixelCount);
+		std::vector<float> lightnessReference(pixelCount);
+		std::vector<float> lightnessTest(pixelCount);
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			const glm::vec3& a = reference.m_Pixels[i];
+			const glm::vec3& b = test.m_Pixels[i];
+			labReference[i] = LinearToLab({SRGBToLinear(a.r), SRGBToLinear(a.g), SRGBToLinear(a.b)});
+			labTest[i] = LinearToLab({SRGBToLinear(b.r), SRGBToLinear(b.g), SRGBToLinear(b.b)});
+			lightnessReference[i] = (labReference[i].x + 16.f) / 116.f;
+			lightnessTest[i] = (labTest[i].x + 16.f) / 116.f;
+		}
+
+		// Colors are compared after the blur, features on the sharp image
+		labReference = Blur(labReference, width, height);
+		labTest = Blur(labTest, width, height);
+
+		std::vector<float> edgesReference, pointsReference, edgesTest, pointsTest;
+		ComputeFeatures(lightnessReference, width, height, edgesReference, pointsReference);
+		ComputeFeatures(lightnessTest, width, height, edgesTest, pointsTest);
+
+		// Largest difference between two colors, pure green and pure blue
+		const float maxColorError = std::pow(
+			HyAB(LinearToLab(glm::vec3(0.f, 1.f, 0.f)), LinearToLab(glm::vec3(0.f, 0.f, 1.f))), FLIP_COLOR_EXPONENT);
+		const float compressionPoint = FLIP_COLOR_COMPRESSION_POINT * maxColorError;
+
+		std::vector<float> errorMap(pixelCount);
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			// Small differences are spread over most of the range, large ones are compressed
+			float colorError = std::pow(HyAB(labReference[i], labTest[i]), FLIP_COLOR_EXPONENT);
+			if (colorError < compressionPoint)
+			{
+				colorError *= FLIP_COLOR_COMPRESSION_THRESHOLD / compressionPoint;
+			}
+			else
+			{
+				colorError = FLIP_COLOR_COMPRESSION_THRESHOLD + (colorError - compressionPoint) /
+						(maxColorError - compressionPoint) * (1.f - FLIP_COLOR_COMPRESSION_THRESHOLD);
+			}
+			colorError = (std::min)(colorError, 1.f);
+
+			const float featureDifference = (std::max)(std::abs(edgesReference[i] - edgesTest[i]),
+													   std::abs(pointsReference[i] - pointsTest[i]));
+			const float featureError =
+				std::clamp(std::pow(featureDifference / std::sqrt(2.f), FLIP_FEATURE_EXPONENT), 0.f, 1.f);
+
+			errorMap[i] = std::pow(colorError, 1.f - featureError);
+		}
+
+		return errorMap;
+	}
+
+	bool CompareImages(const CompareImage& reference, const CompareImage& test, ImageCompareResult& result)
+	{
+		if (!HaveSameSize(reference, test))
+			return false;
+
+		result.m_RMSE = ComputeRMSE(reference, test);
+		result.m_SSIM = ComputeSSIM(reference, test);
+		result.m_ErrorMap = ComputeFlipErrorMap(reference, test);
+
+		double sum = 0.0;
+		for (const float error : result.m_ErrorMap)
+			sum += error;
+		result.m_Flip = static_cast<float>(sum / result.m_ErrorMap.size());
+		return true;
+	}
+
+	CompareImage CreateHeatmap(const std::vector<float>& errorMap, uint32_t width, uint32_t height)
+	{
+		// Samples of the magma color map
+		static const glm::vec3 magma[] = {{0.001f, 0.000f, 0.014f},
+										  {0.317f, 0.071f, 0.485f},
+										  {0.716f, 0.215f, 0.475f},
+										  {0.987f, 0.537f, 0.382f},
+										  {0.987f, 0.991f, 0.750f}};
+		constexpr int lastIndex = static_cast<int>(std::size(magma)) - 1;
+
+		CompareImage heatmap;
+		if (errorMap.size() != static_cast<size_t>(width) * height)
+			return heatmap;
+
+		heatmap.m_Width = width;
+		heatmap.m_Height = height;
+		heatmap.m_Pixels.resize(errorMap.size());
+		for (size_t i = 0; i < errorMap.size(); i++)
+		{
+			const float position = std::clamp(errorMap[i], 0.f, 1.f) * lastIndex;
+			const int index = (std::min)(static_cast<int>(position), lastIndex - 1);
+			heatmap.m_Pixels[i] = glm::mix(magma[index], magma[index + 1], position - index);
+		}
+		return heatmap;
+	}
+} // namespace Ball
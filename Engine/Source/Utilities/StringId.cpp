@@ -0,0 +1,82 @@
+#include "Utilities/StringId.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "Log.h"
+
+namespace Ball
+{
+#ifndef SHIPPING
+	namespace
+	{
+		struct InternTable
+		{
+			std::mutex m_Mutex;
+			// Node based, so the name pointers handed out by GetDebugName stay valid
+			std::unordered_map<StringId, std::string> m_Names;
+		};
+
+		// Ids are interned from static constructors as well (e.g. object types), the table is created on first use
+		InternTable& GetInternTable()
+		{
+			static InternTable table;
+			return table;
+		}
+	} // namespace
+
+	StringId StringId::Intern(std::string_view name)
+	{
+		const StringId id(name);
+
+		InternTable& table = GetInternTable();
+		bool collision = false;
+		{
+			std::lock_guard<std::mutex> lock(table.m_Mutex);
+			const auto inserted = table.m_Names.try_emplace(id, name);
+			collision = !inserted.second && inserted.first->second != name;
+		}
+
+		// Logged outside of the lock, the logger can intern its categories
+		ASSERT_MSG(LOG_GENERIC,
+				   !collision,
+				   "StringId collision: \"%.*s\" has the same hash as \"%s\"",
+				   static_cast<int>(name.size()),
+				   name.data(),
+				   id.GetDebugName());
+
+		return id;
+	}
+
+	const char* StringId::GetDebugName() const
+	{
+		InternTable& table = GetInternTable();
+		std::lock_guard<std::mutex> lock(table.m_Mutex);
+
+		const auto it = table.m_Names.find(*this);
+		return it != table.m_Names.end() ? it->second.c_str() : "?";
+	}
+
+	size_t GetInternedStringCount()
+	{
+		InternTable& table = GetInternTable();
+		std::lock_guard<std::mutex> lock(table.m_Mutex);
+		return table.m_Names.size();
+	}
+#else
+	StringId StringId::Intern(std::string_view name)
+	{
+		return StringId(name);
+	}
+
+	const char* StringId::GetDebugName() const
+	{
+		return "?";
+	}
+
+	size_t GetInternedStringCount()
+	{
+		return 0;
+	}
+#endif
+} // namespace Ball
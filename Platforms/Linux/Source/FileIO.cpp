@@ -0,0 +1,832 @@
+#include "FileIO.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "FileReadBatch.h"
+#include "Log.h"
+#include "Utilities/LaunchParameters.h"
+
+namespace Ball
+{
+	static std::unordered_map<FileIO::DirectoryType, std::string> filePaths{};
+
+	namespace
+	{
+		// Single read calls are limited to a bit below 2GB by the kernel
+		constexpr size_t MAX_READ_SIZE = 1u << 30;
+
+		// Reads until the range is done, the end of the file is reached or an error occurs
+		size_t ReadFully(int fd, void* buffer, size_t size, uint64_t offset)
+		{
+			size_t bytesRead = 0;
+			while (bytesRead < size)
+			{
+				const size_t chunk = (std::min)(size - bytesRead, MAX_READ_SIZE);
+				const ssize_t result =
+					pread(fd, static_cast<uint8_t*>(buffer) + bytesRead, chunk, static_cast<off_t>(offset + bytesRead));
+				if (result < 0 && errno == EINTR)
+					continue;
+				if (result <= 0)
+					break;
+				bytesRead += static_cast<size_t>(result);
+			}
+			return bytesRead;
+		}
+
+		bool WriteFully(int fd, const void* data, size_t size)
+		{
+			size_t written = 0;
+			while (written < size)
+			{
+				const ssize_t result = write(fd, static_cast<const uint8_t*>(data) + written, size - written);
+				if (result < 0 && errno == EINTR)
+					continue;
+				if (result <= 0)
+					return false;
+				written += static_cast<size_t>(result);
+			}
+			return true;
+		}
+
+		void ReadRequestBlocking(FileReadRequest& request)
+		{
+			const std::string path = FileIO::GetPath(request.m_Type, request.m_RelativePath);
+			const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0)
+				return;
+
+			request.m_BytesRead = ReadFully(fd, request.m_Buffer, request.m_Size, request.m_Offset);
+			request.m_Succeeded = request.m_BytesRead == request.m_Size;
+			close(fd);
+		}
+
+		// Temporary files of concurrent writes to the same file must not collide
+		std::atomic<uint32_t> tempFileCounter = 0;
+
+		/// <summary>
+		/// Writes into a temporary file next to the target and renames it over the target once the data is on disk.
+		/// Rename is atomic on POSIX file systems: readers and crashes see either the old or the new file.
+		/// </summary>
+		bool WriteAtomic(const std::string& filePath, const void* data, size_t size)
+		{
+			const std::string tempPath = filePath + "." + std::to_string(getpid()) + "." +
+				std::to_string(tempFileCounter.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+
+			const int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			if (fd < 0)
+				return false;
+
+			bool succeeded = WriteFully(fd, data, size);
+			// Without the sync the rename can reach the disk before the data does
+			succeeded = fsync(fd) == 0 && succeeded;
+			succeeded = close(fd) == 0 && succeeded;
+			succeeded = succeeded && rename(tempPath.c_str(), filePath.c_str()) == 0;
+
+			if (!succeeded)
+				unlink(tempPath.c_str());
+			return succeeded;
+		}
+
+		bool CreateParentDirectories(const std::string& filePath)
+		{
+			const std::filesystem::path parent = std::filesystem::path(filePath).parent_path();
+			std::error_code error;
+			if (!parent.empty() && !std::filesystem::exists(parent, error))
+				std::filesystem::create_directories(parent, error);
+			return !error;
+		}
+
+		FileReadWorkers* readWorkers = nullptr;
+		std::mutex readWorkersMutex;
+
+		// The thread pool is created on first use when io_uring is used, it only takes over if the ring fails
+		FileReadWorkers& GetReadWorkers()
+		{
+			std::lock_guard<std::mutex> lock(readWorkersMutex);
+			if (!readWorkers)
+				readWorkers = new FileReadWorkers(4, &ReadRequestBlocking);
+			return *readWorkers;
+		}
+
+		/// <summary>
+		/// Submits read requests to an io_uring from a dedicated thread. Batches are turned into read operations, as
+		/// many as fit in the submission queue are submitted with one system call and the thread sleeps in the
+		/// kernel until they complete. Short reads are resubmitted for the rest of the range.
+		/// liburing isn't used, the ring is set up with the raw system calls. If the ring stops working the reads that
+		/// didn't complete fail and all later batches go to the thread pool.
+		/// </summary>
+		class IoUringReader
+		{
+		public:
+			~IoUringReader() { Shutdown(); }
+
+			// False if io_uring isn't available, e.g. an old kernel or a sandbox that blocks the system calls, or if
+			// the kernel doesn't support the read operation
+			bool Init(uint32_t entries);
+			void Shutdown();
+			// Batches submitted after this are read by the thread pool
+			bool HasFailed() const { return m_Failed; }
+			void Submit(const std::shared_ptr<FileReadBatch>& batch);
+
+		private:
+			struct Operation
+			{
+				std::shared_ptr<FileReadBatch> m_Batch;
+				size_t m_Index = 0;
+				int m_Fd = -1;
+			};
+
+			// Asks the kernel which operations the ring supports, IORING_OP_READ needs 5.6 or newer
+			bool SupportsRead() const;
+			void Run();
+			// Starts the next part of the read, false when the request is finished
+			bool Prepare(Operation* operation);
+			void Finish(Operation* operation);
+			void Reap();
+			// Fails every operation that isn't done and hands the waiting batches to the thread pool
+			void FailAll();
+
+			int m_RingFd = -1;
+			uint32_t m_NumEntries = 0;
+			void* m_SqRing = nullptr;
+			void* m_CqRing = nullptr;
+			size_t m_SqRingSize = 0;
+			size_t m_CqRingSize = 0;
+			io_uring_sqe* m_Sqes = nullptr;
+
+			uint32_t* m_SqTail = nullptr;
+			uint32_t* m_SqMask = nullptr;
+			uint32_t* m_SqArray = nullptr;
+			uint32_t* m_CqHead = nullptr;
+			uint32_t* m_CqTail = nullptr;
+			uint32_t* m_CqMask = nullptr;
+			io_uring_cqe* m_Cqes = nullptr;
+
+			// Only touched by the ring thread
+			std::vector<Operation*> m_Ready;
+			// In the submission queue or in the kernel
+			std::unordered_set<Operation*> m_Pending;
+			uint32_t m_NumToSubmit = 0;
+			uint32_t m_NumInFlight = 0;
+
+			std::thread m_Thread;
+			std::mutex m_Mutex;
+			std::condition_variable m_HasBatches;
+			std::deque<std::shared_ptr<FileReadBatch>> m_Batches;
+			bool m_Stop = false;
+			std::atomic<bool> m_Failed = false;
+		};
+
+		bool IoUringReader::Init(uint32_t entries)
+		{
+			io_uring_params params = {};
+			m_RingFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+			if (m_RingFd < 0)
+				return false;
+
+			if (!SupportsRead())
+			{
+				Shutdown();
+				return false;
+			}
+
+			m_NumEntries = params.sq_entries;
+			m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+			m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (singleMap)
+				m_SqRingSize = m_CqRingSize = (std::max)(m_SqRingSize, m_CqRingSize);
+
+			m_SqRing = mmap(nullptr,
+							m_SqRingSize,
+							PROT_READ | PROT_WRITE,
+							MAP_SHARED | MAP_POPULATE,
+							m_RingFd,
+							static_cast<off_t>(IORING_OFF_SQ_RING));
+			m_CqRing = singleMap ? m_SqRing
+								 : mmap(nullptr,
+										m_CqRingSize,
+										PROT_READ | PROT_WRITE,
+										MAP_SHARED | MAP_POPULATE,
+										m_RingFd,
+										static_cast<off_t>(IORING_OFF_CQ_RING));
+			void* sqes = mmap(nullptr,
+							  params.sq_entries * sizeof(io_uring_sqe),
+							  PROT_READ | PROT_WRITE,
+							  MAP_SHARED | MAP_POPULATE,
+							  m_RingFd,
+							  static_cast<off_t>(IORING_OFF_SQES));
+			if (m_SqRing == MAP_FAILED || m_CqRing == MAP_FAILED || sqes == MAP_FAILED)
+			{
+				if (m_SqRing == MAP_FAILED)
+					m_SqRing = nullptr;
+				if (m_CqRing == MAP_FAILED)
+					m_CqRing = nullptr;
+				if (sqes != MAP_FAILED)
+					munmap(sqes, params.sq_entries * sizeof(io_uring_sqe));
+				Shutdown();
+				return false;
+			}
+			m_Sqes = static_cast<io_uring_sqe*>(sqes);
+
+			uint8_t* sqRing = static_cast<uint8_t*>(m_SqRing);
+			m_SqTail = reinterpret_cast<uint32_t*>(sqRing + params.sq_off.tail);
+			m_SqMask = reinterpret_cast<uint32_t*>(sqRing + params.sq_off.ring_mask);
+			m_SqArray = reinterpret_cast<uint32_t*>(sqRing + params.sq_off.array);
+
+			uint8_t* cqRing = static_cast<uint8_t*>(m_CqRing);
+			m_CqHead = reinterpret_cast<uint32_t*>(cqRing + params.cq_off.head);
+			m_CqTail = reinterpret_cast<uint32_t*>(cqRing + params.cq_off.tail);
+			m_CqMask = reinterpret_cast<uint32_t*>(cqRing + params.cq_off.ring_mask);
+			m_Cqes = reinterpret_cast<io_uring_cqe*>(cqRing + params.cq_off.cqes);
+
+			m_Thread = std::thread(&IoUringReader::Run, this);
+			return true;
+		}
+
+		bool IoUringReader::SupportsRead() const
+		{
+			constexpr uint32_t MAX_PROBE_OPS = 256;
+			constexpr size_t PROBE_SIZE = sizeof(io_uring_probe) + MAX_PROBE_OPS * sizeof(io_uring_probe_op);
+			alignas(io_uring_probe) uint8_t buffer[PROBE_SIZE] = {};
+			io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer);
+
+			// Kernels without the probe don't have IORING_OP_READ either, both were added in 5.6
+			if (syscall(__NR_io_uring_register, m_RingFd, IORING_REGISTER_PROBE, probe, MAX_PROBE_OPS) < 0)
+				return false;
+
+			return IORING_OP_READ <= probe->last_op && IORING_OP_READ < probe->ops_len &&
+				(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+		}
+
+		void IoUringReader::Shutdown()
+		{
+			if (m_Thread.joinable())
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					m_Stop = true;
+				}
+				m_HasBatches.notify_all();
+				m_Thread.join();
+			}
+
+			if (m_Sqes)
+				munmap(m_Sqes, m_NumEntries * sizeof(io_uring_sqe));
+			if (m_CqRing && m_CqRing != m_SqRing)
+				munmap(m_CqRing, m_CqRingSize);
+			if (m_SqRing)
+				munmap(m_SqRing, m_SqRingSize);
+			if (m_RingFd >= 0)
+				close(m_RingFd);
+
+			m_Sqes = nullptr;
+			m_CqRing = nullptr;
+			m_SqRing = nullptr;
+			m_RingFd = -1;
+		}
+
+		void IoUringReader::Submit(const std::shared_ptr<FileReadBatch>& batch)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if (!m_Failed)
+				{
+					m_Batches.push_back(batch);
+					m_HasBatches.notify_one();
+					return;
+				}
+			}
+			GetReadWorkers().Submit(batch);
+		}
+
+		void IoUringReader::Run()
+		{
+			while (true)
+			{
+				// Take the new batches, only sleep here when nothing is in flight
+				{
+					std::unique_lock<std::mutex> lock(m_Mutex);
+					if (m_NumInFlight == 0 && m_Ready.empty())
+						m_HasBatches.wait(lock, [this]() { return m_Stop || !m_Batches.empty(); });
+
+					// Stopping finishes everything that was submitted first
+					if (m_Stop && m_Batches.empty() && m_NumInFlight == 0 && m_Ready.empty())
+						return;
+
+					for (const std::shared_ptr<FileReadBatch>& batch : m_Batches)
+					{
+						for (size_t i = 0; i < batch->GetNumRequests(); i++)
+							m_Ready.push_back(new Operation{batch, i, -1});
+					}
+					m_Batches.clear();
+				}
+
+				// Fill the submission queue, the operations that didn't fit wait for the next round
+				size_t numTaken = 0;
+				while (numTaken < m_Ready.size() && m_NumInFlight + m_NumToSubmit < m_NumEntries)
+				{
+					Operation* operation = m_Ready[numTaken++];
+					if (!Prepare(operation))
+						Finish(operation);
+				}
+				m_Ready.erase(m_Ready.begin(), m_Ready.begin() + numTaken);
+
+				if (m_NumToSubmit == 0 && m_NumInFlight == 0)
+					continue;
+
+				// Submits the new operations and waits for at least one to complete
+				const long result =
+					syscall(__NR_io_uring_enter, m_RingFd, m_NumToSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+				if (result >= 0)
+				{
+					m_NumInFlight += static_cast<uint32_t>(result);
+					m_NumToSubmit -= static_cast<uint32_t>(result);
+				}
+				else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+				{
+					// Retrying would only spin on the same error
+					ERROR(LOG_FILEIO, "io_uring_enter failed: %s, reads use the thread pool now", strerror(errno));
+					FailAll();
+					return;
+				}
+
+				Reap();
+			}
+		}
+
+		bool IoUringReader::Prepare(Operation* operation)
+		{
+			FileReadRequest& request = operation->m_Batch->GetRequest(operation->m_Index);
+			if (operation->m_Fd < 0)
+			{
+				const std::string path = FileIO::GetPath(request.m_Type, request.m_RelativePath);
+				operation->m_Fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+				if (operation->m_Fd < 0)
+					return false;
+			}
+
+			if (request.m_BytesRead >= request.m_Size)
+			{
+				request.m_Succeeded = true;
+				return false;
+			}
+
+			const uint32_t tail = *m_SqTail;
+			const uint32_t index = tail & *m_SqMask;
+			io_uring_sqe& sqe = m_Sqes[index];
+			std::memset(&sqe, 0, sizeof(sqe));
+			sqe.opcode = IORING_OP_READ;
+			sqe.fd = operation->m_Fd;
+			sqe.addr = reinterpret_cast<uint64_t>(static_cast<uint8_t*>(request.m_Buffer) + request.m_BytesRead);
+			sqe.len = static_cast<uint32_t>((std::min)(request.m_Size - request.m_BytesRead, MAX_READ_SIZE));
+			sqe.off = request.m_Offset + request.m_BytesRead;
+			sqe.user_data = reinterpret_cast<uint64_t>(operation);
+			m_SqArray[index] = index;
+
+			// The kernel reads the entry after it sees the new tail
+			__atomic_store_n(m_SqTail, tail + 1, __ATOMIC_RELEASE);
+			m_NumToSubmit++;
+			m_Pending.insert(operation);
+			return true;
+		}
+
+		void IoUringReader::Finish(Operation* operation)
+		{
+			if (operation->m_Fd >= 0)
+				close(operation->m_Fd);
+			operation->m_Batch->CompleteRequest();
+			delete operation;
+		}
+
+		void IoUringReader::Reap()
+		{
+			uint32_t head = *m_CqHead;
+			const uint32_t tail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+			while (head != tail)
+			{
+				const io_uring_cqe& cqe = m_Cqes[head & *m_CqMask];
+				Operation* operation = reinterpret_cast<Operation*>(cqe.user_data);
+				FileReadRequest& request = operation->m_Batch->GetRequest(operation->m_Index);
+				m_Pending.erase(operation);
+				m_NumInFlight--;
+				head++;
+
+				if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+				{
+					m_Ready.push_back(operation);
+					continue;
+				}
+
+				// 0 is the end of the file, the request is shorter than asked for
+				if (cqe.res <= 0)
+				{
+					Finish(operation);
+					continue;
+				}
+
+				// Short reads continue where they stopped
+				request.m_BytesRead += static_cast<size_t>(cqe.res);
+				m_Ready.push_back(operation);
+			}
+			__atomic_store_n(m_CqHead, head, __ATOMIC_RELEASE);
+		}
+
+		void IoUringReader::FailAll()
+		{
+			// Reads the kernel already completed keep their result
+			Reap();
+
+			// Finishing leaves m_Succeeded unset, the requests report the bytes read so far. Short reads that were
+			// waiting for the next part can already be done.
+			for (Operation* operation : m_Pending)
+				Finish(operation);
+			for (Operation* operation : m_Ready)
+			{
+				FileReadRequest& request = operation->m_Batch->GetRequest(operation->m_Index);
+				request.m_Succeeded = request.m_BytesRead >= request.m_Size;
+				Finish(operation);
+			}
+			m_Pending.clear();
+			m_Ready.clear();
+			m_NumInFlight = 0;
+			m_NumToSubmit = 0;
+
+			std::deque<std::shared_ptr<FileReadBatch>> batches;
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Failed = true;
+				batches.swap(m_Batches);
+			}
+			for (const std::shared_ptr<FileReadBatch>& batch : batches)
+				GetReadWorkers().Submit(batch);
+		}
+
+		IoUringReader* ioUringReader = nullptr;
+	} // namespace
+
+	bool FileIO::Init()
+	{
+		char exeFilePath[PATH_MAX] = {};
+		[[maybe_unused]] const ssize_t length = readlink("/proc/self/exe", exeFilePath, sizeof(exeFilePath) - 1);
+		assert(length > 0);
+
+		{
+			// User data goes to $XDG_DATA_HOME, like the roaming directory on Windows
+			std::string dataFolderPath;
+			if (const char* xdgDataHome = std::getenv("XDG_DATA_HOME"); xdgDataHome && *xdgDataHome)
+				dataFolderPath = xdgDataHome;
+			else if (const char* home = std::getenv("HOME"); home && *home)
+				dataFolderPath = std::string(home) + "/.local/share";
+			else
+				dataFolderPath = "/tmp";
+
+			// Create a custom ball folder in the data directory if it doesn't exist.
+			dataFolderPath += "/OnTheBubble/";
+			std::error_code error;
+			if (!std::filesystem::exists(dataFolderPath, error))
+			{
+				INFO(LOG_FILEIO, "Creating \"OnTheBubble\" folder in known directory: %s", dataFolderPath.c_str());
+				std::filesystem::create_directories(dataFolderPath, error);
+				if (error)
+					ERROR(LOG_FILEIO, "Failed to create '%s': %s", dataFolderPath.c_str(), error.message().c_str());
+			}
+
+			filePaths.insert({DirectoryType::CommunitySave, ""});
+			filePaths.insert({DirectoryType::LocalLevel, dataFolderPath + "LocalLevel/"});
+			filePaths.insert({DirectoryType::TempData, dataFolderPath + "TempData/"});
+		}
+
+		const std::string applicationPath = std::filesystem::path(exeFilePath).parent_path().string() + "/";
+
+		filePaths.insert({DirectoryType::CampaignSave, applicationPath + "Resources/CampaignSaves/"});
+
+		filePaths.insert({DirectoryType::Engine, applicationPath + "Resources/"});
+		filePaths.insert({DirectoryType::Prefabs, applicationPath + "Resources/Prefabs/"});
+		filePaths.insert({DirectoryType::Shaders, applicationPath + "Shaders/"});
+		filePaths.insert({DirectoryType::PlatformSpecificShaders, applicationPath + "ShadersLinux/"});
+		filePaths.insert({DirectoryType::Audio, applicationPath + "Resources/Audio/"});
+		filePaths.insert({DirectoryType::Log, applicationPath + "Log/"});
+
+		filePaths.insert({DirectoryType::ToolPreset, applicationPath + "Resources/ToolSettings"});
+
+		if (!LaunchParameters::Contains("FileIOThreadPool"))
+		{
+			ioUringReader = new IoUringReader();
+			if (!ioUringReader->Init(64))
+			{
+				INFO(LOG_FILEIO, "io_uring is not available, async reads use the thread pool");
+				delete ioUringReader;
+				ioUringReader = nullptr;
+			}
+		}
+		if (!ioUringReader)
+			GetReadWorkers();
+
+		return true;
+	}
+
+	bool FileIO::Shutdown()
+	{
+		// Both finish their queued reads first
+		delete ioUringReader;
+		ioUringReader = nullptr;
+		delete readWorkers;
+		readWorkers = nullptr;
+		return true;
+	}
+
+	bool FileIO::Exist(DirectoryType type, const std::string& targetFile)
+	{
+		return access(GetPath(type, targetFile).c_str(), F_OK) == 0;
+	}
+
+	bool FileIO::Write(DirectoryType type, const std::string& relativePath, const std::string& data, bool appendData)
+	{
+		if (!HasWriteAccess(type))
+		{
+			ERROR(LOG_FILEIO, "DirectoryType '%i' is not savable", type);
+			return false;
+		}
+
+		const std::string filePath = GetPath(type, relativePath);
+		CreateParentDirectories(filePath);
+
+		bool succeeded = false;
+		if (appendData)
+		{
+			// Appending can't go through a temporary file, O_APPEND keeps concurrent appends from overlapping
+			const int fd = open(filePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+			if (fd >= 0)
+			{
+				succeeded = WriteFully(fd, data.data(), data.size());
+				succeeded = close(fd) == 0 && succeeded;
+			}
+		}
+		else
+		{
+			succeeded = WriteAtomic(filePath, data.data(), data.size());
+		}
+
+		if (!succeeded)
+		{
+			ERROR(LOG_FILEIO, "Failed to write '%s': %s\n", filePath.c_str(), strerror(errno));
+			return false;
+		}
+
+		INFO(LOG_FILEIO, "Wrote to file: %s", filePath.c_str());
+		return true;
+	}
+
+	bool FileIO::WriteBinary(DirectoryType type, const std::string& relativePath, const void* data, size_t size)
+	{
+		ASSERT_MSG(LOG_FILEIO, data, "Called FileIO::write with a invalid data pointer");
+
+		if (!HasWriteAccess(type))
+		{
+			ERROR(LOG_FILEIO, "DirectoryType '%i' is not savable", type);
+			return false;
+		}
+
+		const std::string filePath = GetPath(type, relativePath);
+		CreateParentDirectories(filePath);
+
+		if (!WriteAtomic(filePath, data, size))
+		{
+			ERROR(LOG_FILEIO, "Failed to write '%s': %s\n", filePath.c_str(), strerror(errno));
+			return false;
+		}
+
+		INFO(LOG_FILEIO, "Wrote to binary file: %s", filePath.c_str());
+		return true;
+	}
+
+	std::string FileIO::Read(DirectoryType type, const std::string& relativePath)
+	{
+		const std::string filePath = GetPath(type, relativePath);
+		const int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			ERROR(LOG_FILEIO, "Attempted to read from '%s' which doesnt exist !", filePath.c_str());
+			return "";
+		}
+
+		// Sized once and read straight into the string, no stream buffers in between
+		struct stat fileStat = {};
+		std::string data;
+		if (fstat(fd, &fileStat) == 0)
+		{
+			data.resize(static_cast<size_t>(fileStat.st_size));
+			data.resize(ReadFully(fd, data.data(), data.size(), 0));
+		}
+		close(fd);
+		return data;
+	}
+
+	bool FileIO::ReadBinary(DirectoryType type, const std::string& relativePath, void* targetBuffer,
+							std::streamsize targetBufferSize)
+	{
+		ASSERT_MSG(LOG_FILEIO, targetBuffer, "Called FileIO::Read with a invalid targetbuffer");
+
+		const std::string filePath = GetPath(type, relativePath);
+		const int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			ASSERT_MSG(LOG_FILEIO, false, "ReadFromFile failed, '%s' does not exist.", relativePath.c_str());
+			return false;
+		}
+
+		struct stat fileStat = {};
+		if (fstat(fd, &fileStat) != 0 || targetBufferSize > fileStat.st_size)
+		{
+			ERROR(LOG_FILEIO, "Target buffer is to big to read the file into");
+			close(fd);
+			return false;
+		}
+
+		const size_t size = static_cast<size_t>(targetBufferSize);
+		const bool succeeded = ReadFully(fd, targetBuffer, size, 0) == size;
+		close(fd);
+		return succeeded;
+	}
+
+	MappedFile FileIO::MapReadOnly(DirectoryType type, const std::string& relativePath)
+	{
+		MappedFile mapping;
+
+		const std::string filePath = GetPath(type, relativePath);
+		const int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+		{
+			ERROR(LOG_FILEIO, "Attempted to map '%s' which doesnt exist !", filePath.c_str());
+			return mapping;
+		}
+
+		struct stat fileStat = {};
+		if (fstat(fd, &fileStat) == 0)
+		{
+			mapping.m_Size = static_cast<size_t>(fileStat.st_size);
+			if (mapping.m_Size == 0)
+			{
+				// Zero length mappings aren't allowed
+				mapping.m_Valid = true;
+			}
+			else
+			{
+				void* data = mmap(nullptr, mapping.m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (data != MAP_FAILED)
+				{
+					// Large files are usually read front to back (buffers, images)
+					madvise(data, mapping.m_Size, MADV_SEQUENTIAL);
+					mapping.m_Data = static_cast<const uint8_t*>(data);
+					mapping.m_Valid = true;
+				}
+				else
+				{
+					ERROR(LOG_FILEIO, "Failed to map '%s': %s", filePath.c_str(), strerror(errno));
+					mapping.m_Size = 0;
+				}
+			}
+		}
+
+		// The mapping keeps the file alive
+		close(fd);
+		return mapping;
+	}
+
+	void MappedFile::Reset()
+	{
+		if (m_Data)
+			munmap(const_cast<uint8_t*>(m_Data), m_Size);
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Valid = false;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Reset();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: m_Data(other.m_Data), m_Size(other.m_Size), m_Valid(other.m_Valid)
+	{
+		other.m_Data = nullptr;
+		other.m_Size = 0;
+		other.m_Valid = false;
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			std::swap(m_Data, other.m_Data);
+			std::swap(m_Size, other.m_Size);
+			std::swap(m_Valid, other.m_Valid);
+		}
+		return *this;
+	}
+
+	std::shared_ptr<FileReadBatch> FileIO::ReadAsync(std::vector<FileReadRequest> requests)
+	{
+		ASSERT_MSG(LOG_FILEIO, ioUringReader || readWorkers, "FileIO::ReadAsync called before FileIO::Init");
+
+		std::shared_ptr<FileReadBatch> batch = std::make_shared<FileReadBatch>(std::move(requests));
+		if (batch->GetNumRequests() == 0)
+			return batch;
+
+		if (ioUringReader)
+			ioUringReader->Submit(batch);
+		else
+			GetReadWorkers().Submit(batch);
+		return batch;
+	}
+
+	FileIO::AsyncReadBackend FileIO::GetAsyncReadBackend()
+	{
+		return ioUringReader && !ioUringReader->HasFailed() ? AsyncReadBackend::IO_URING
+															 : AsyncReadBackend::THREAD_POOL;
+	}
+
+	std::vector<std::string> FileIO::GetDirectoryContent(DirectoryType type, const std::string& directoryPath)
+	{
+		std::vector<std::string> paths;
+
+		const std::string path = FileIO::GetPath(type, directoryPath);
+
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(path, error))
+			paths.push_back(entry.path().lexically_relative(path).string());
+
+		return paths;
+	}
+
+	std::vector<std::string> FileIO::GetDirectoryContent(DirectoryType type, const std::string& directoryPath,
+														 const std::string& extension)
+	{
+		std::vector<std::string> paths;
+
+		const std::string path = FileIO::GetPath(type, directoryPath);
+
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(path, error))
+		{
+			if (entry.path().extension() == extension)
+				paths.push_back(entry.path().lexically_relative(path).string());
+		}
+
+		return paths;
+	}
+
+	bool FileIO::Delete(DirectoryType type, const std::string& relativePath)
+	{
+		return unlink(GetPath(type, relativePath).c_str()) == 0;
+	}
+
+	size_t FileIO::GetSize(DirectoryType type, const std::string& relativePath)
+	{
+		struct stat fileStat = {};
+		if (stat(GetPath(type, relativePath).c_str(), &fileStat) != 0)
+			return 0;
+		return static_cast<size_t>(fileStat.st_size);
+	}
+
+	const std::string& FileIO::GetPath(DirectoryType type)
+	{
+		const auto rootPath = filePaths.find(type);
+		assert(rootPath != filePaths.end()); // If this asserts it needs to be implemented in initialize most likely !
+
+		return rootPath->second;
+	}
+
+	std::string FileIO::GetPath(DirectoryType type, const std::string& relativePath)
+	{
+		return std::filesystem::path(GetPath(type)).append(relativePath).string();
+	}
+
+	bool FileIO::HasWriteAccess(FileIO::DirectoryType type)
+	{
+		return type == FileIO::CampaignSave || type == FileIO::LocalLevel || type == FileIO::CommunitySave ||
+			type == FileIO::Log || type == FileIO::TempData || type == FileIO::ToolPreset;
+	}
+} // namespace Ball
@@ -14,9 +14,12 @@ namespace Ball
 		extern Microsoft::WRL::ComPtr<IDXGIFactory4> g_DxgiFactory;
 		extern std::shared_ptr<CommandQueue> g_DirectCommandQueue;
 		extern Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4> g_DirectCommandList;
+		// Allocator of the frame being recorded, every frame in flight has its own
 		extern Microsoft::WRL::ComPtr<ID3D12CommandAllocator> g_CommandAllocator;
 		extern Microsoft::WRL::ComPtr<IDXGISwapChain4> g_SwapChain;
 		extern uint32_t g_FrameIndex;
+		// FrameScheduler slot of the frame being recorded, picks the per frame copies of upload memory
+		extern uint32_t g_FrameSlot;
 		// Useful variables
 		extern uint32_t g_RTVDescSize;
 		extern uint32_t g_CBV_SRV_UAVDescSize;
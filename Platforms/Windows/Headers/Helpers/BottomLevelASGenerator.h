@@ -103,8 +103,11 @@ namespace nv_helpers_dx12
 							  /// allow iterative updates
 			UINT64* scratchSizeInBytes, /// Required scratch memory on the GPU to
 										/// build the acceleration structure
-			UINT64* resultSizeInBytes /// Required GPU memory to store the
-									  /// acceleration structure
+			UINT64* resultSizeInBytes, /// Required GPU memory to store the
+									   /// acceleration structure
+			D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS extraFlags =
+				D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_NONE /// Trace/build preference and compaction
+																		/// flags, added to the update flag
 		);
 
 		/// Enqueue the construction of the acceleration structure on a command list, using
@@ -119,10 +122,14 @@ namespace nv_helpers_dx12
 			Microsoft::WRL::ComPtr<ID3D12Resource> resultBuffer, /// Result buffer storing the acceleration structure
 			bool updateOnly = false, /// If true, simply refit the existing acceleration structure
 			Microsoft::WRL::ComPtr<ID3D12Resource> previousResult =
-				nullptr /// Optional previous acceleration structure, used
-						/// if an iterative update is requested
+				nullptr, /// Optional previous acceleration structure, used
+						 /// if an iterative update is requested
+			const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC* postbuildInfo =
+				nullptr /// Optional info the build writes out, like the compacted size
 		);
 
+		D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS GetFlags() const { return m_flags; }
+
 	private:
 		/// Vertex buffer descriptors used to generate the AS
 		std::vector<D3D12_RAYTRACING_GEOMETRY_DESC> m_vertexBuffers = {};
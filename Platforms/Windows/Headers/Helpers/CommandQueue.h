@@ -4,9 +4,11 @@
 #include <glm/fwd.hpp>
 #include <queue>
 
+#include "Rendering/FrameScheduler.h"
+
 namespace Ball
 {
-	class CommandQueue
+	class CommandQueue : public IGpuTimeline
 	{
 	public:
 		CommandQueue(D3D12_COMMAND_LIST_TYPE type);
@@ -14,10 +16,11 @@ namespace Ball
 
 		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4> GetCommandList();
 		void Flush();
-		uint64_t Signal();
+		uint64_t Signal() override;
+		uint64_t GetCompletedValue() const override;
+		void WaitForValue(uint64_t fenceValue) override { WaitForFenceValue(fenceValue); }
 		bool IsFenceComplete(uint64_t fenceValue);
 		void WaitForFenceValue(uint64_t fenceValue);
-		void WaitForExecution(); // TEMPORARY SOLUTION
 		Microsoft::WRL::ComPtr<ID3D12CommandQueue> GetD3D12CommandQueue() const;
 
 	protected:
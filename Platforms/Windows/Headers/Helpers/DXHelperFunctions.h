@@ -44,6 +44,8 @@ namespace Ball::Helpers
 
 	static const D3D12_HEAP_PROPERTIES kDefaultHeapProps = {
 		D3D12_HEAP_TYPE_DEFAULT, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 0, 0};
+	static const D3D12_HEAP_PROPERTIES kReadbackHeapProps = {
+		D3D12_HEAP_TYPE_READBACK, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 0, 0};
 	enum BufferType
 	{
 		CBV,
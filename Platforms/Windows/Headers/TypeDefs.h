@@ -3,6 +3,7 @@
 #include "Helpers/RootSignatureGenerator.h"
 #include "Helpers/TopLevelASGenerator.h"
 #include "Helpers/BottomLevelASGenerator.h"
+#include "Rendering/FrameScheduler.h"
 
 namespace Ball
 {
@@ -17,6 +18,7 @@ namespace Ball
 		D3D12_RESOURCE_STATES m_State = D3D12_RESOURCE_STATE_COMMON;
 		Microsoft::WRL::ComPtr<ID3D12Resource> m_Buffer = nullptr;
 		Microsoft::WRL::ComPtr<ID3D12Resource> m_Uploader = nullptr;
+		PerFrame<Microsoft::WRL::ComPtr<ID3D12Resource>> m_FrameUploaders; // Only used by PER_FRAME buffers
 	};
 
 	struct DX12CommandList
@@ -68,7 +70,10 @@ namespace Ball
 	{
 		Microsoft::WRL::ComPtr<ID3D12Resource> m_Scratch; // Scratch memory for AS builder
 		Microsoft::WRL::ComPtr<ID3D12Resource> m_Result; // Where the AS is
-		Microsoft::WRL::ComPtr<ID3D12Resource> m_TransformBuffer; // Hold the matrices of the instances
+		// Hold the matrices of the primitives, refits and rebuilds rewrite them so each frame in flight has its own
+		PerFrame<Microsoft::WRL::ComPtr<ID3D12Resource>> m_TransformBuffers;
+		Microsoft::WRL::ComPtr<ID3D12Resource> m_CompactedSize; // Written by the build when it allows compaction
+		Microsoft::WRL::ComPtr<ID3D12Resource> m_CompactedSizeReadback;
 		nv_helpers_dx12::BottomLevelASGenerator m_BottomLevelASGenerator;
 	};
 
@@ -76,7 +81,8 @@ namespace Ball
 	{
 		Microsoft::WRL::ComPtr<ID3D12Resource> m_Scratch; // Scratch memory for AS builder
 		Microsoft::WRL::ComPtr<ID3D12Resource> m_Result; // Where the AS is
-		Microsoft::WRL::ComPtr<ID3D12Resource> m_InstanceDesc; // Hold the matrices of the instances
+		// Hold the matrices of the instances, rewritten by every build so each frame in flight has its own
+		PerFrame<Microsoft::WRL::ComPtr<ID3D12Resource>> m_InstanceDescs;
 		nv_helpers_dx12::TopLevelASGenerator m_TopLevelASGenerator;
 	};
 
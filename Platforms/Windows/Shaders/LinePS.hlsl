@@ -1,6 +1,19 @@
+struct LineSettings
+{
+    matrix ViewProjection;
+    float3 CameraPosition;
+    uint ScreenWidth;
+    uint DepthTest;
+    float DepthBias;
+};
+ConstantBuffer<LineSettings> settings : register(b0);
+// Distance to the primary hit of every pixel, negative when nothing was hit
+StructuredBuffer<float> currentDepthBuffer : register(t1);
+
 struct PixelShaderInput
 {
     float4 Color : COLOR;
+    float3 WorldPosition : POSITION;
     float4 Position : SV_Position;
 };
 
@@ -11,7 +24,16 @@ struct PixelShaderOutput
 
 PixelShaderOutput main(PixelShaderInput input)
 {
+    if (settings.DepthTest != 0)
+    {
+        const uint2 pixel = uint2(input.Position.xy);
+        const float sceneDepth = currentDepthBuffer[pixel.y * settings.ScreenWidth + pixel.x];
+        const float lineDepth = length(input.WorldPosition - settings.CameraPosition);
+        if (sceneDepth >= 0.f && lineDepth > sceneDepth * (1.f + settings.DepthBias))
+            discard;
+    }
+
     PixelShaderOutput output;
     output.Color = float4(input.Color.rgb, 1.0f);
     return output;
-}
\ No newline at end of file
+}
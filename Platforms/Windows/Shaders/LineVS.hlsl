@@ -1,23 +1,51 @@
-struct Line
-{
-    matrix MVP;
-    float4 Color;
-};
-StructuredBuffer<Line> LinesSB : register(t0);
+#define SHADER_STRUCT 1
+#include "../Shaders/ShaderHeaders/DebugDrawGPU.h"
 
-struct VertexShaderInput
+struct LineSettings
 {
-    float3 Position : POSITION;
+    matrix ViewProjection;
+    float3 CameraPosition;
+    uint ScreenWidth;
+    uint DepthTest;
+    float DepthBias;
 };
+ConstantBuffer<LineSettings> settings : register(b0);
+StructuredBuffer<DebugPrimitiveGPU> PrimitivesSB : register(t0);
+
 struct VertexShaderOutput
 {
     float4 Color : COLOR;
+    float3 WorldPosition : POSITION;
     float4 Position : SV_Position;
 };
-VertexShaderOutput main(VertexShaderInput input, uint instanceID : SV_InstanceID)
+
+float4 UnpackColor(uint color)
+{
+    return float4(color & 0xFF, (color >> 8) & 0xFF, (color >> 16) & 0xFF, (color >> 24) & 0xFF) / 255.f;
+}
+
+// Lines are drawn with 2 vertices per instance, shapes with DEBUG_SHAPE_VERTEX_COUNT
+VertexShaderOutput main(uint vertexID : SV_VertexID, uint instanceID : SV_InstanceID)
 {
     VertexShaderOutput output;
-    output.Position = mul(LinesSB[instanceID].MVP, float4(input.Position, 1.0f));
-    output.Color = LinesSB[instanceID].Color;
+    const DebugPrimitiveGPU primitive = PrimitivesSB[instanceID];
+
+    // Shapes with less vertices collapse the rest onto a point outside of the view
+    if (vertexID >= GetDebugPrimitiveVertexCount(primitive.m_Type))
+    {
+        output.Color = float4(0.f, 0.f, 0.f, 0.f);
+        output.WorldPosition = float3(0.f, 0.f, 0.f);
+        output.Position = float4(0.f, 0.f, -1.f, 1.f);
+        return output;
+    }
+
+    output.WorldPosition = GetDebugPrimitiveVertex(primitive, vertexID);
+    output.Position = mul(settings.ViewProjection, float4(output.WorldPosition, 1.0f));
+    output.Color = UnpackColor(primitive.m_Color);
+    if (primitive.m_Type == DEBUG_PRIMITIVE_AXIS)
+    {
+        const uint axis = vertexID / 2;
+        output.Color = float4(axis == 0, axis == 1, axis == 2, 1.f);
+    }
     return output;
-}
\ No newline at end of file
+}
@@ -3,30 +3,40 @@
 #include "Helpers/DXHelperFunctions.h"
 #include "DX12GlobalVariables.h"
 #include <Helpers/CommandQueue.h>
+#include "Utilities/PoolAllocator.h"
+#include "Engine.h"
+#include "Rendering/Renderer.h"
 
 namespace Ball
 {
-	BLAS::BLAS(const std::vector<BLASPrimitive*>& data, BlasQuality quality, const std::string& name)
+	namespace
 	{
-		m_ModelData = data;
-
-		// Transform Buffer creation
-		m_BLASHandle.m_TransformBuffer = Helpers::CreateBuffer(sizeof(glm::mat4) * data.size(),
-															   D3D12_RESOURCE_FLAG_NONE,
-															   D3D12_RESOURCE_STATE_COMMON,
-															   Helpers::kUploadHeapProps);
-		// Fill in the transforms buffer
-		CD3DX12_RANGE readRange(0, 0);
-		UINT8* pUploadBegin;
-		ThrowIfFailed(m_BLASHandle.m_TransformBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pUploadBegin)));
-
-		for (size_t i = 0; i < data.size(); i++)
+		D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS GetBuildFlags(BlasQuality quality)
 		{
-			size_t offset = i * sizeof(glm::mat4);
-			glm::mat4 mat = glm::transpose(data[i]->m_ModelMatrix);
-			memcpy(pUploadBegin + offset, &mat, sizeof(glm::mat4));
+			switch (quality)
+			{
+			case BlasQuality::FAST_BUILD:
+				return D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD |
+					D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_COMPACTION;
+			case BlasQuality::REFIT_FAST_BUILD:
+				return D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_BUILD;
+			case BlasQuality::REFIT_FAST_TRAVERSE:
+				return D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
+			case BlasQuality::FAST_TRAVERSE:
+			default:
+				return D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE |
+					D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_COMPACTION;
+			}
 		}
-		m_BLASHandle.m_TransformBuffer->Unmap(0, nullptr);
+	} // namespace
+
+	BLAS::BLAS(const std::vector<BLASPrimitive*>& data, BlasQuality quality, const std::string& name) :
+		m_Name(name), m_Quality(quality)
+	{
+		m_ModelData = data;
+
+		UploadTransforms();
+		ID3D12Resource* transforms = m_BLASHandle.m_TransformBuffers[GlobalDX12::g_FrameSlot].Get();
 
 		// Add blas primitives
 		for (size_t i = 0; i < data.size(); i++)
@@ -41,16 +51,19 @@ namespace Ball
 				data[i]->m_IndexBuffer->GetGPUHandleRef().m_Buffer.Get(),
 				0,
 				data[i]->m_IndexBuffer->GetNumElements(),
-				m_BLASHandle.m_TransformBuffer.Get(),
+				transforms,
 				offset,
-				true);
+				data[i]->m_Opaque);
 		}
 
 		// Create BLAS
 		UINT64 scratchSizeInBytes = 0;
 		UINT64 resultSizeInBytes = 0;
-		m_BLASHandle.m_BottomLevelASGenerator.ComputeASBufferSizes(
-			GlobalDX12::g_Device.Get(), false, &scratchSizeInBytes, &resultSizeInBytes);
+		m_BLASHandle.m_BottomLevelASGenerator.ComputeASBufferSizes(GlobalDX12::g_Device.Get(),
+																   AllowsRefit(quality),
+																   &scratchSizeInBytes,
+																   &resultSizeInBytes,
+																   GetBuildFlags(quality));
 		m_BLASHandle.m_Scratch = Helpers::CreateBuffer(scratchSizeInBytes,
 													   D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
 													   D3D12_RESOURCE_STATE_COMMON,
@@ -59,24 +72,66 @@ namespace Ball
 													  D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
 													  D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE,
 													  Helpers::kDefaultHeapProps);
+		m_SizeInBytes = resultSizeInBytes;
 
-		m_BLASHandle.m_BottomLevelASGenerator.Generate(
-			GlobalDX12::g_DirectCommandList.Get(), m_BLASHandle.m_Scratch.Get(), m_BLASHandle.m_Result.Get());
+		if (AllowsRefit(quality))
+		{
+			m_BLASHandle.m_BottomLevelASGenerator.Generate(
+				GlobalDX12::g_DirectCommandList.Get(), m_BLASHandle.m_Scratch.Get(), m_BLASHandle.m_Result.Get());
+			return;
+		}
+
+		// The build writes the size the BLAS compacts to, Compact() reads it back a few frames later
+		m_BLASHandle.m_CompactedSize = Helpers::CreateBuffer(sizeof(UINT64),
+															 D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+															 D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+															 Helpers::kDefaultHeapProps);
+		m_BLASHandle.m_CompactedSizeReadback = Helpers::CreateBuffer(
+			sizeof(UINT64), D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST, Helpers::kReadbackHeapProps);
+
+		D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC postbuildInfo = {};
+		postbuildInfo.InfoType = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE;
+		postbuildInfo.DestBuffer = m_BLASHandle.m_CompactedSize->GetGPUVirtualAddress();
+		m_BLASHandle.m_BottomLevelASGenerator.Generate(GlobalDX12::g_DirectCommandList.Get(),
+													   m_BLASHandle.m_Scratch.Get(),
+													   m_BLASHandle.m_Result.Get(),
+													   false,
+													   nullptr,
+													   &postbuildInfo);
+
+		auto* commandList = GlobalDX12::g_DirectCommandList.Get();
+		CD3DX12_RESOURCE_BARRIER transition =
+			CD3DX12_RESOURCE_BARRIER::Transition(m_BLASHandle.m_CompactedSize.Get(),
+												 D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+												 D3D12_RESOURCE_STATE_COPY_SOURCE);
+		commandList->ResourceBarrier(1, &transition);
+		commandList->CopyResource(m_BLASHandle.m_CompactedSizeReadback.Get(), m_BLASHandle.m_CompactedSize.Get());
 	}
 
 	BLAS::~BLAS()
 	{
 		for (int i = 0; i < m_ModelData.size(); i++)
 		{
-			delete m_ModelData[i];
+			ObjectPool<BLASPrimitive>::Delete(m_ModelData[i]);
 		}
 	}
-	void BLAS::Update()
+
+	void BLAS::UploadTransforms()
 	{
+		// Builds of earlier frames in flight can still read the transforms of their own slot
+		Microsoft::WRL::ComPtr<ID3D12Resource>& transforms = m_BLASHandle.m_TransformBuffers[GlobalDX12::g_FrameSlot];
+		if (transforms == nullptr)
+		{
+			transforms = Helpers::CreateBuffer(sizeof(glm::mat4) * m_ModelData.size(),
+											   D3D12_RESOURCE_FLAG_NONE,
+											   D3D12_RESOURCE_STATE_COMMON,
+											   Helpers::kUploadHeapProps);
+		}
+
 		// Fill in the transforms buffer
 		CD3DX12_RANGE readRange(0, 0);
 		UINT8* pUploadBegin;
-		ThrowIfFailed(m_BLASHandle.m_TransformBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pUploadBegin)));
+		ThrowIfFailed(transforms->Map(0, &readRange, reinterpret_cast<void**>(&pUploadBegin)));
 
 		for (size_t i = 0; i < m_ModelData.size(); i++)
 		{
@@ -85,17 +140,86 @@ namespace Ball
 			memcpy(pUploadBegin + offset, &mat, sizeof(glm::mat4));
 		}
 
-		m_BLASHandle.m_TransformBuffer->Unmap(0, nullptr);
+		transforms->Unmap(0, nullptr);
 
-		// Add blas primitives
-		for (size_t i = 0; i < m_ModelData.size(); i++)
+		// No-op while the constructor hasn't added the primitives yet
+		for (uint32_t i = 0; i < m_ModelData.size(); i++)
+			m_BLASHandle.m_BottomLevelASGenerator.UpdateTransform(i, transforms, i * sizeof(glm::mat4));
+	}
+
+	void BLAS::Refit()
+	{
+		if (!AllowsRefit(m_Quality))
 		{
-			size_t offset = i * sizeof(glm::mat4);
-			// Add a new primitive
-			m_BLASHandle.m_BottomLevelASGenerator.UpdateTransform(i, m_BLASHandle.m_TransformBuffer.Get(), offset);
+			Rebuild();
+			return;
 		}
 
+		UploadTransforms();
+		m_BLASHandle.m_BottomLevelASGenerator.Generate(GlobalDX12::g_DirectCommandList.Get(),
+													   m_BLASHandle.m_Scratch.Get(),
+													   m_BLASHandle.m_Result.Get(),
+													   true,
+													   m_BLASHandle.m_Result.Get());
+		m_Version++;
+	}
+
+	void BLAS::Rebuild()
+	{
+		assert(!m_Compacted && "A compacted BLAS has no scratch memory left to build with");
+		UploadTransforms();
 		m_BLASHandle.m_BottomLevelASGenerator.Generate(
 			GlobalDX12::g_DirectCommandList.Get(), m_BLASHandle.m_Scratch.Get(), m_BLASHandle.m_Result.Get());
+		m_Version++;
+	}
+
+	bool BLAS::Compact()
+	{
+		if (m_Compacted || !m_BLASHandle.m_CompactedSizeReadback)
+			return false;
+
+		UINT64 compactedSize = 0;
+		CD3DX12_RANGE readRange(0, sizeof(UINT64));
+		CD3DX12_RANGE writeRange(0, 0);
+		void* readback = nullptr;
+		ThrowIfFailed(m_BLASHandle.m_CompactedSizeReadback->Map(0, &readRange, &readback));
+		memcpy(&compactedSize, readback, sizeof(UINT64));
+		m_BLASHandle.m_CompactedSizeReadback->Unmap(0, &writeRange);
+
+		// Still zero when the build hasn't executed yet
+		if (compactedSize == 0)
+			return false;
+
+		compactedSize = (compactedSize + D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT - 1) &
+			~static_cast<UINT64>(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT - 1);
+		Microsoft::WRL::ComPtr<ID3D12Resource> compacted =
+			Helpers::CreateBuffer(compactedSize,
+								  D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+								  D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE,
+								  Helpers::kDefaultHeapProps);
+
+		auto* commandList = GlobalDX12::g_DirectCommandList.Get();
+		commandList->CopyRaytracingAccelerationStructure(compacted->GetGPUVirtualAddress(),
+														 m_BLASHandle.m_Result->GetGPUVirtualAddress(),
+														 D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_COMPACT);
+		D3D12_RESOURCE_BARRIER uavBarrier = CD3DX12_RESOURCE_BARRIER::UAV(compacted.Get());
+		commandList->ResourceBarrier(1, &uavBarrier);
+
+		// Nothing builds this BLAS again, the scratch memory can go with the uncompacted result once the copy and the
+		// frames still tracing it are done
+		std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> retired = {m_BLASHandle.m_Result,
+																		m_BLASHandle.m_Scratch,
+																		m_BLASHandle.m_CompactedSize,
+																		m_BLASHandle.m_CompactedSizeReadback};
+		GetEngine().GetRenderer().GetFrameScheduler().DeferDeletion([retired]() mutable { retired.clear(); });
+		m_BLASHandle.m_Result = compacted;
+		m_BLASHandle.m_Scratch.Reset();
+		m_BLASHandle.m_CompactedSize.Reset();
+		m_BLASHandle.m_CompactedSizeReadback.Reset();
+
+		m_SizeInBytes = compactedSize;
+		m_Compacted = true;
+		m_Version++;
+		return true;
 	}
-} // namespace Ball
\ No newline at end of file
+} // namespace Ball
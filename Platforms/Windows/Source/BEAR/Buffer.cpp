@@ -32,7 +32,7 @@ namespace Ball
 			createFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 		}
 
-		if ((m_Flags & BufferFlags::DEFAULT_HEAP) != BufferFlags::NONE)
+		if ((m_Flags & (BufferFlags::DEFAULT_HEAP | BufferFlags::PER_FRAME)) != BufferFlags::NONE)
 		{
 			heapProps = Helpers::kDefaultHeapProps;
 			assert((m_Flags & BufferFlags::UPLOAD_HEAP) == BufferFlags::NONE &&
@@ -54,6 +54,8 @@ namespace Ball
 					LOG_GRAPHICS, m_BufferHandle.m_Uploader == nullptr, "Buffer must be null to create a new one");
 				m_BufferHandle.m_Uploader = Helpers::CreateBuffer(
 					bufferSize, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ, Helpers::kUploadHeapProps);
+				m_StagingBytes = bufferSize;
+				GetMemoryTracker().Allocate(MemoryTag::STAGING, m_StagingBytes);
 
 				UINT8* pUploadBegin;
 				ThrowIfFailed(m_BufferHandle.m_Uploader->Map(0, &readRange, reinterpret_cast<void**>(&pUploadBegin)));
@@ -68,6 +70,10 @@ namespace Ball
 					Helpers::TransitionResourceState(this, D3D12_RESOURCE_STATE_COMMON);
 				}
 			}
+			else if ((m_Flags & BufferFlags::PER_FRAME) != BufferFlags::NONE)
+			{
+				UploadFrameCopy(data, bufferSize);
+			}
 			else if ((m_Flags & BufferFlags::UPLOAD_HEAP) != BufferFlags::NONE)
 			{
 				CD3DX12_RANGE readRange(0, 0);
@@ -91,6 +97,12 @@ namespace Ball
 		size_t sizeInBytes = m_Stride * m_Count;
 		assert((dataSizeInBytes <= sizeInBytes) && "Update data size doesn't match buffer size");
 
+		if ((m_Flags & BufferFlags::PER_FRAME) != BufferFlags::NONE)
+		{
+			UploadFrameCopy(data, dataSizeInBytes);
+			return;
+		}
+
 		CD3DX12_RANGE readRange(0, 0);
 		UINT8* pUploadBegin;
 		ThrowIfFailed(m_BufferHandle.m_Buffer->Map(0, &readRange, reinterpret_cast<void**>(&pUploadBegin)));
@@ -98,10 +110,37 @@ namespace Ball
 		m_BufferHandle.m_Buffer->Unmap(0, nullptr);
 	}
 
+	void Buffer::UploadFrameCopy(const void* data, uint32_t dataSizeInBytes)
+	{
+		// The GPU can still be copying from the upload buffers of the other frames in flight
+		Microsoft::WRL::ComPtr<ID3D12Resource>& uploader = m_BufferHandle.m_FrameUploaders[GlobalDX12::g_FrameSlot];
+		if (uploader == nullptr)
+		{
+			uploader = Helpers::CreateBuffer(
+				GetSizeBytes(), D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ, Helpers::kUploadHeapProps);
+			m_FrameStagingBytes += GetSizeBytes();
+			GetMemoryTracker().Allocate(MemoryTag::STAGING, GetSizeBytes());
+		}
+
+		CD3DX12_RANGE readRange(0, 0);
+		UINT8* pUploadBegin;
+		ThrowIfFailed(uploader->Map(0, &readRange, reinterpret_cast<void**>(&pUploadBegin)));
+		memcpy(pUploadBegin, data, dataSizeInBytes);
+		uploader->Unmap(0, nullptr);
+
+		std::lock_guard<std::mutex> lg(bufMut);
+		Helpers::TransitionResourceState(this, D3D12_RESOURCE_STATE_COPY_DEST);
+		GlobalDX12::g_DirectCommandList->CopyBufferRegion(
+			m_BufferHandle.m_Buffer.Get(), 0, uploader.Get(), 0, dataSizeInBytes);
+		Helpers::TransitionResourceState(this, D3D12_RESOURCE_STATE_GENERIC_READ);
+	}
+
 	void Buffer::Resize(uint32_t newCount)
 	{
 		m_BufferHandle.m_Buffer.Reset();
+		ReleaseFrameUploaders();
 
+		GetMemoryTracker().Resize(m_MemoryTag, GetSizeBytes(), static_cast<uint64_t>(m_Stride) * newCount);
 		m_Count = newCount;
 		uint32_t bufferSize = m_Stride * m_Count;
 
@@ -115,7 +154,7 @@ namespace Ball
 			createFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 		}
 
-		if ((m_Flags & BufferFlags::DEFAULT_HEAP) != BufferFlags::NONE)
+		if ((m_Flags & (BufferFlags::DEFAULT_HEAP | BufferFlags::PER_FRAME)) != BufferFlags::NONE)
 		{
 			heapProps = Helpers::kDefaultHeapProps;
 			assert((m_Flags & BufferFlags::UPLOAD_HEAP) == BufferFlags::NONE &&
@@ -130,6 +169,8 @@ namespace Ball
 			ASSERT_MSG(LOG_GRAPHICS, m_BufferHandle.m_Uploader == nullptr, "Buffer must be null to create a new one");
 			m_BufferHandle.m_Uploader = Helpers::CreateBuffer(
 				bufferSize, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ, Helpers::kUploadHeapProps);
+			m_StagingBytes = bufferSize;
+			GetMemoryTracker().Allocate(MemoryTag::STAGING, m_StagingBytes);
 		}
 	}
 
@@ -141,14 +182,38 @@ namespace Ball
 		}
 
 		CleanupHelperResources();
+		ReleaseFrameUploaders();
 		m_BufferHandle.m_Buffer.ReleaseAndGetAddressOf();
 	}
 
+	void Buffer::ReleaseFrameUploaders()
+	{
+		for (Microsoft::WRL::ComPtr<ID3D12Resource>& uploader : m_BufferHandle.m_FrameUploaders)
+			uploader.Reset();
+
+		if (m_FrameStagingBytes > 0)
+		{
+			GetMemoryTracker().Free(MemoryTag::STAGING, m_FrameStagingBytes);
+			m_FrameStagingBytes = 0;
+		}
+	}
+
 	void Buffer::CleanupHelperResources()
 	{
 		// Only this should be responsible for cleaning up the uploader
-		// and (eventually) readback buffers.
+		// and (eventually) readback buffers. The copy from it can still be in flight, so the FrameScheduler holds on
+		// to it until that frame finished.
 		if (m_BufferHandle.m_Uploader.Get() != nullptr)
+		{
+			GetEngine().GetRenderer().GetFrameScheduler().DeferDeletion(
+				[uploader = m_BufferHandle.m_Uploader]() mutable { uploader.Reset(); });
 			m_BufferHandle.m_Uploader.Reset();
+		}
+
+		if (m_StagingBytes > 0)
+		{
+			GetMemoryTracker().Free(MemoryTag::STAGING, m_StagingBytes);
+			m_StagingBytes = 0;
+		}
 	}
 } // namespace Ball
@@ -103,6 +103,42 @@ namespace Ball
 			layoutLocation, texture.GetGPUHandleRef().m_Texture.Get()->GetGPUVirtualAddress());
 	}
 
+	void CommandList::TransitionToSRV(Buffer& buffer)
+	{
+		Helpers::TransitionResourceState(&buffer, D3D12_RESOURCE_STATE_GENERIC_READ);
+	}
+
+	void CommandList::TransitionToSRV(Texture& texture)
+	{
+		Helpers::TransitionResourceState(&texture, D3D12_RESOURCE_STATE_GENERIC_READ);
+	}
+
+	void CommandList::TransitionToUAV(Buffer& buffer)
+	{
+		Helpers::TransitionResourceState(&buffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	}
+
+	void CommandList::TransitionToUAV(Texture& texture)
+	{
+		Helpers::TransitionResourceState(&texture, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	}
+
+	void CommandList::UAVBarrier(Buffer& buffer)
+	{
+		D3D12_RESOURCE_BARRIER uavBarrier = {};
+		uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+		uavBarrier.UAV.pResource = buffer.GetGPUHandleRef().m_Buffer.Get();
+		m_CmdListHandle.m_CommandList->ResourceBarrier(1, &uavBarrier);
+	}
+
+	void CommandList::UAVBarrier(Texture& texture)
+	{
+		D3D12_RESOURCE_BARRIER uavBarrier = {};
+		uavBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+		uavBarrier.UAV.pResource = texture.GetGPUHandleRef().m_Texture.Get();
+		m_CmdListHandle.m_CommandList->ResourceBarrier(1, &uavBarrier);
+	}
+
 	void CommandList::SetComputePipeline(ComputePipelineDescription& cpd)
 	{
 		Utilities::PushGPUMarker(this, cpd.GetShaderName());
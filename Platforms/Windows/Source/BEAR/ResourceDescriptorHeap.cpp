@@ -12,7 +12,7 @@
 namespace Ball
 {
 
-	ResourceDescriptorHeap::ResourceDescriptorHeap(uint32_t maxNumberResources)
+	ResourceDescriptorHeap::ResourceDescriptorHeap(uint32_t maxNumberResources) : m_Allocator(maxNumberResources)
 	{
 		// For now all of the descriptors will be shader visible
 		m_DescriptorHeapHandle.m_Heap =
@@ -25,23 +25,34 @@ namespace Ball
 	{
 	}
 
-	int ResourceDescriptorHeap::ReserveSpace(uint32_t numSpacesToReserve)
+	int ResourceDescriptorHeap::ReserveSpace(uint32_t numSpacesToReserve, const std::string& owner)
 	{
-		ReserveSpaceCommonLogic(numSpacesToReserve);
-
-		m_DescriptorHeapHandle.m_Handle.ptr += GlobalDX12::g_CBV_SRV_UAVDescSize * numSpacesToReserve;
-		return m_NumElements - 1;
+		const DescriptorRange range = Allocate(numSpacesToReserve, owner);
+		WARN(LOG_GRAPHICS,
+			 "Resource Descriptor Entry [%u - %u] : RESERVED SPACE(s), Currently Empty",
+			 range.m_Start,
+			 range.GetLast());
+		return range.GetLast();
 	}
 
 	int ResourceDescriptorHeap::Add(Buffer& buffer)
 	{
+		const int heapID = Allocate(1, buffer.GetName()).m_Start;
+		Add(buffer, heapID);
+		return heapID;
+	}
+
+	void ResourceDescriptorHeap::Add(Buffer& buffer, int heapID)
+	{
+		D3D12_CPU_DESCRIPTOR_HANDLE handle = m_DescriptorHeapHandle.m_Heap->GetCPUDescriptorHandleForHeapStart();
+		handle.ptr += heapID * GlobalDX12::g_CBV_SRV_UAVDescSize;
 		if ((buffer.GetFlags() & BufferFlags::CBV) != BufferFlags::NONE)
 		{
 			// Describe and create a constant buffer view
 			D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc = {};
 			cbvDesc.BufferLocation = buffer.GetGPUHandleRef().m_Buffer.Get()->GetGPUVirtualAddress();
 			cbvDesc.SizeInBytes = buffer.GetSizeBytes();
-			GlobalDX12::g_Device->CreateConstantBufferView(&cbvDesc, m_DescriptorHeapHandle.m_Handle);
+			GlobalDX12::g_Device->CreateConstantBufferView(&cbvDesc, handle);
 			assert((buffer.GetFlags() & BufferFlags::SRV) == BufferFlags::NONE &&
 				   "Buffer can't have CBV and SRV flags");
 		}
@@ -54,7 +65,7 @@ namespace Ball
 			uavDesc.Buffer.NumElements = buffer.GetNumElements();
 			uavDesc.Buffer.StructureByteStride = buffer.GetStride();
 			GlobalDX12::g_Device->CreateUnorderedAccessView(
-				buffer.GetGPUHandleRef().m_Buffer.Get(), nullptr, &uavDesc, m_DescriptorHeapHandle.m_Handle);
+				buffer.GetGPUHandleRef().m_Buffer.Get(), nullptr, &uavDesc, handle);
 			assert((buffer.GetFlags() & BufferFlags::CBV) == BufferFlags::NONE &&
 				   "Buffer can't have CBV and UAV flags");
 			assert((buffer.GetFlags() & BufferFlags::SRV) == BufferFlags::NONE &&
@@ -71,20 +82,16 @@ namespace Ball
 			srvDesc.Buffer.StructureByteStride = buffer.GetStride();
 			srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
 			GlobalDX12::g_Device->CreateShaderResourceView(
-				buffer.GetGPUHandleRef().m_Buffer.Get(), &srvDesc, m_DescriptorHeapHandle.m_Handle);
+				buffer.GetGPUHandleRef().m_Buffer.Get(), &srvDesc, handle);
 		}
-		m_DescriptorHeapHandle.m_Handle.ptr += GlobalDX12::g_CBV_SRV_UAVDescSize;
-		m_NumElements++;
 
 		// Add buffer with placeholder text so the heapID is alligned
-		m_TextureNames.push_back(std::string("buffer"));
+		SetElementName(heapID, std::string("buffer"));
 
 		if ((buffer.GetFlags() & BufferFlags::SCREENSIZE) != BufferFlags::NONE)
 		{
-			GetEngine().GetRenderer().MakeScreensizeHeapLink({&buffer, this, m_NumElements - 1});
+			GetEngine().GetRenderer().MakeScreensizeHeapLink({&buffer, this, heapID});
 		}
-
-		return m_NumElements - 1;
 	}
 
 	void ResourceDescriptorHeap::Switch(Buffer& newBuffer, int heapID)
@@ -143,6 +150,15 @@ namespace Ball
 
 	int ResourceDescriptorHeap::Add(Texture& texture)
 	{
+		const int heapID = Allocate(1, texture.GetName()).m_Start;
+		Add(texture, heapID);
+		return heapID;
+	}
+
+	void ResourceDescriptorHeap::Add(Texture& texture, int heapID)
+	{
+		D3D12_CPU_DESCRIPTOR_HANDLE handle = m_DescriptorHeapHandle.m_Heap->GetCPUDescriptorHandleForHeapStart();
+		handle.ptr += heapID * GlobalDX12::g_CBV_SRV_UAVDescSize;
 		if (texture.GetType() == TextureType::R_TEXTURE)
 		{
 			D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
@@ -154,27 +170,23 @@ namespace Ball
 			srvDesc.Texture2D.PlaneSlice = 0;
 			srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
 			GlobalDX12::g_Device->CreateShaderResourceView(
-				texture.GetGPUHandleRef().m_Texture.Get(), &srvDesc, m_DescriptorHeapHandle.m_Handle);
+				texture.GetGPUHandleRef().m_Texture.Get(), &srvDesc, handle);
 		}
 		if (texture.GetType() == TextureType::RW_TEXTURE)
 		{
 			D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
 			uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
 			GlobalDX12::g_Device->CreateUnorderedAccessView(
-				texture.GetGPUHandleRef().m_Texture.Get(), nullptr, &uavDesc, m_DescriptorHeapHandle.m_Handle);
+				texture.GetGPUHandleRef().m_Texture.Get(), nullptr, &uavDesc, handle);
 		}
-		m_DescriptorHeapHandle.m_Handle.ptr += GlobalDX12::g_CBV_SRV_UAVDescSize;
-		m_NumElements++;
 
 		// Add texture name to dynamic array
-		m_TextureNames.push_back(texture.GetName());
+		SetElementName(heapID, texture.GetName());
 
 		if ((texture.GetFlags() & TextureFlags::SCREENSIZE) != TextureFlags::NONE)
 		{
-			GetEngine().GetRenderer().MakeScreensizeHeapLink({&texture, this, m_NumElements - 1});
+			GetEngine().GetRenderer().MakeScreensizeHeapLink({&texture, this, heapID});
 		}
-
-		return m_NumElements - 1;
 	}
 
 	void ResourceDescriptorHeap::Switch(Texture& newTexture, int heapID)
@@ -203,8 +215,7 @@ namespace Ball
 		}
 
 		// Replace name of texture at heapID index
-		// Do I need to cast the int to size_t?
-		m_TextureNames.at(heapID) = newTexture.GetName();
+		SetElementName(heapID, newTexture.GetName());
 
 		// Remove the resizing link from the previous texture, add to the new one
 		if ((newTexture.GetFlags() & TextureFlags::SCREENSIZE) != TextureFlags::NONE)
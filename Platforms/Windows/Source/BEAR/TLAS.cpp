@@ -3,23 +3,14 @@
 #include "Helpers/TopLevelASGenerator.h"
 #include "Helpers/DXHelperFunctions.h"
 #include "DX12GlobalVariables.h"
+#include "Utilities/PoolAllocator.h"
 
 namespace Ball
 {
 	TLAS::TLAS(const std::vector<TlasInstanceData*>& levelData)
 	{
 		m_LevelData = levelData;
-		m_TLAS.m_TopLevelASGenerator.ClearInstances();
-		// Gather all the instances into the builder helper
-		for (size_t i = 0; i < m_LevelData.size(); i++)
-		{
-			m_TLAS.m_TopLevelASGenerator.AddInstance(
-				m_LevelData[i]->m_Blas->GetBLASRef().m_Result.Get(),
-				m_LevelData[i]->m_Transform,
-				static_cast<UINT>(m_LevelData[i]->m_ModelId),
-				// Hit group id refers to the order in which we added Hit Groups to SBT
-				static_cast<UINT>(i));
-		}
+		AddInstances();
 		UINT64 scratchSize, resultSize, instanceDescsSize;
 		m_TLAS.m_TopLevelASGenerator.ComputeASBufferSizes(
 			GlobalDX12::g_Device.Get(), true, &scratchSize, &resultSize, &instanceDescsSize);
@@ -31,8 +22,13 @@ namespace Ball
 												D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
 												D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE,
 												Helpers::kDefaultHeapProps);
-		m_TLAS.m_InstanceDesc = Helpers::CreateBuffer(
-			instanceDescsSize, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ, Helpers::kUploadHeapProps);
+		for (Microsoft::WRL::ComPtr<ID3D12Resource>& instanceDescs : m_TLAS.m_InstanceDescs)
+		{
+			instanceDescs = Helpers::CreateBuffer(instanceDescsSize,
+												  D3D12_RESOURCE_FLAG_NONE,
+												  D3D12_RESOURCE_STATE_GENERIC_READ,
+												  Helpers::kUploadHeapProps);
+		}
 
 		// After all the buffers are allocated, or if only an update is required, we
 		// can build the acceleration structure. Note that in the case of the update
@@ -41,14 +37,31 @@ namespace Ball
 		m_TLAS.m_TopLevelASGenerator.Generate(GlobalDX12::g_DirectCommandList,
 											  m_TLAS.m_Scratch.Get(),
 											  m_TLAS.m_Result.Get(),
-											  m_TLAS.m_InstanceDesc.Get());
+											  m_TLAS.m_InstanceDescs[GlobalDX12::g_FrameSlot].Get());
+	}
+
+	void TLAS::AddInstances()
+	{
+		m_TLAS.m_TopLevelASGenerator.ClearInstances();
+		m_BlasVersions.resize(m_LevelData.size());
+		// Gather all the instances into the builder helper
+		for (size_t i = 0; i < m_LevelData.size(); i++)
+		{
+			m_TLAS.m_TopLevelASGenerator.AddInstance(
+				m_LevelData[i]->m_Blas->GetBLASRef().m_Result.Get(),
+				m_LevelData[i]->m_Transform,
+				static_cast<UINT>(m_LevelData[i]->m_ModelId),
+				// Hit group id refers to the order in which we added Hit Groups to SBT
+				static_cast<UINT>(i));
+			m_BlasVersions[i] = m_LevelData[i]->m_Blas->GetVersion();
+		}
 	}
 
 	TLAS::~TLAS()
 	{
 		for (int i = 0; i < m_LevelData.size(); i++)
 		{
-			delete m_LevelData[i];
+			ObjectPool<TlasInstanceData>::Delete(m_LevelData[i]);
 		}
 		m_LevelData.clear();
 	}
@@ -56,7 +69,11 @@ namespace Ball
 	void TLAS::SetInstanceTransform(const glm::mat4& newTransform, const uint32_t id)
 	{
 		assert(id < m_LevelData.size() && "ID out of bounds");
+		if (m_LevelData[id]->m_Transform == newTransform)
+			return;
+
 		m_LevelData[id]->m_Transform = newTransform;
+		m_TransformsDirty = true;
 	}
 
 	glm::mat4& TLAS::GetInstanceTransformRef(const uint32_t id) const
@@ -67,9 +84,20 @@ namespace Ball
 
 	void TLAS::Update()
 	{
+		bool blasChanged = false;
+		for (size_t i = 0; i < m_LevelData.size() && !blasChanged; i++)
+			blasChanged = m_LevelData[i]->m_Blas->GetVersion() != m_BlasVersions[i];
+
+		if (!blasChanged && !m_TransformsDirty)
+			return;
+
+		if (blasChanged)
+			AddInstances();
+		m_TransformsDirty = false;
+		// Earlier frames in flight can still be building from their own instance descriptors
 		m_TLAS.m_TopLevelASGenerator.Generate(GlobalDX12::g_DirectCommandList,
 											  m_TLAS.m_Scratch.Get(),
 											  m_TLAS.m_Result.Get(),
-											  m_TLAS.m_InstanceDesc.Get());
+											  m_TLAS.m_InstanceDescs[GlobalDX12::g_FrameSlot].Get());
 	}
 } // namespace Ball
\ No newline at end of file
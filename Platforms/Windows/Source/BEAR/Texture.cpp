@@ -57,6 +57,8 @@ namespace Ball
 		ASSERT_MSG(LOG_GRAPHICS, m_TextureHandle.m_Uploader == nullptr, "Texture must be null to create a new one");
 		m_TextureHandle.m_Uploader = Helpers::CreateBuffer(
 			alignedSize, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ, Helpers::kUploadHeapProps);
+		m_StagingBytes = alignedSize;
+		GetMemoryTracker().Allocate(MemoryTag::STAGING, m_StagingBytes);
 
 		if (data != nullptr)
 		{
@@ -205,10 +207,12 @@ namespace Ball
 	{
 		CleanupHelperResources();
 		m_TextureHandle.m_Texture.Reset();
+		const uint64_t oldSizeBytes = GetSizeBytes();
 		m_Spec.m_Width = newWidth;
 		m_Spec.m_Height = newHeight;
 		const uint32_t rowPitch = m_Spec.m_Width * m_Channels * m_BytesPerChannel;
 		m_SizeInBytes = rowPitch * m_Spec.m_Height;
+		GetMemoryTracker().Resize(m_MemoryTag, oldSizeBytes, GetSizeBytes());
 
 		// Render Targets are rectreated by a Swap Chain
 		if (m_Spec.m_Type != TextureType::RENDER_TARGET)
@@ -231,6 +235,8 @@ namespace Ball
 															   D3D12_RESOURCE_FLAG_NONE,
 															   D3D12_RESOURCE_STATE_GENERIC_READ,
 															   Helpers::kUploadHeapProps);
+			m_StagingBytes = GetAlignedSize();
+			GetMemoryTracker().Allocate(MemoryTag::STAGING, m_StagingBytes);
 		}
 	}
 
@@ -419,7 +425,7 @@ namespace Ball
 																						  ppCommandLists);
 
 			// Wait for other commands to execute
-			GlobalDX12::g_DirectCommandQueue->WaitForExecution();
+			GlobalDX12::g_DirectCommandQueue->Flush();
 			ThrowIfFailed(GlobalDX12::g_CommandAllocator->Reset());
 			ThrowIfFailed(GlobalDX12::g_DirectCommandList->Reset(GlobalDX12::g_CommandAllocator.Get(), nullptr));
 
@@ -449,8 +455,19 @@ namespace Ball
 	void Texture::CleanupHelperResources()
 	{
 		// Only this should be responsible for cleaning up the uploader
-		// and (eventually) readback buffers.
+		// and (eventually) readback buffers. The copy from it can still be in flight, so the FrameScheduler holds on
+		// to it until that frame finished.
 		if (m_TextureHandle.m_Uploader.Get() != nullptr)
+		{
+			GetEngine().GetRenderer().GetFrameScheduler().DeferDeletion(
+				[uploader = m_TextureHandle.m_Uploader]() mutable { uploader.Reset(); });
 			m_TextureHandle.m_Uploader.Reset();
+		}
+
+		if (m_StagingBytes > 0)
+		{
+			GetMemoryTracker().Free(MemoryTag::STAGING, m_StagingBytes);
+			m_StagingBytes = 0;
+		}
 	}
 } // namespace Ball
@@ -26,6 +26,7 @@
 #include <stb/stb_image.h>
 
 #include "Rendering/BufferManager.h"
+#include "Rendering/FrameScheduler.h"
 #include "Rendering/TextureManager.h"
 
 #pragma clang diagnostic pop
@@ -49,6 +50,8 @@ namespace
 	D3D12_VIEWPORT g_Viewport;
 	D3D12_RECT g_ScissorRect;
 	Ball::Texture* g_RenderTargets[NUM_RT_BUFFERS];
+	// An allocator can only be reset once the GPU finished the frame recorded with it
+	Ball::PerFrame<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> g_FrameAllocators;
 } // namespace
 namespace Ball
 {
@@ -197,8 +200,9 @@ namespace Ball
 		ThrowIfFailed(GlobalDX12::g_Device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&g_ImguiDescHeap)));
 
 		ImGui_ImplWin32_Init(g_Hwnd);
+		// ImGui rewrites its vertex buffers every frame, it needs a set for each frame in flight
 		ImGui_ImplDX12_Init(GlobalDX12::g_Device.Get(),
-							NUM_RT_BUFFERS,
+							FrameScheduler::MAX_FRAMES_IN_FLIGHT,
 							DXGI_FORMAT_R8G8B8A8_UNORM,
 							g_ImguiDescHeap->GetCPUDescriptorHandleForHeapStart(),
 							g_ImguiDescHeap->GetGPUDescriptorHandleForHeapStart());
@@ -214,7 +218,8 @@ namespace Ball
 		// Readback Heap for reading back query Heap data
 		D3D12_RESOURCE_DESC bufferDesc = {};
 		bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-		bufferDesc.Width = GlobalDX12::MAX_GPU_QUERIES * sizeof(UINT64);
+		// One region per frame in flight, the timestamps of a frame are read once its slot comes around again
+		bufferDesc.Width = FrameScheduler::MAX_FRAMES_IN_FLIGHT * GlobalDX12::MAX_GPU_QUERIES * sizeof(UINT64);
 		bufferDesc.Height = 1;
 		bufferDesc.DepthOrArraySize = 1;
 		bufferDesc.MipLevels = 1;
@@ -264,8 +269,19 @@ namespace Ball
 		Helpers::TransitionResourceState(g_RenderTargets[GlobalDX12::g_FrameIndex], D3D12_RESOURCE_STATE_PRESENT);
 	}
 
-	void BackEndRenderer::BeginFrame()
+	void BackEndRenderer::BeginFrame(uint32_t frameSlot)
 	{
+		GlobalDX12::g_FrameSlot = frameSlot;
+		GlobalDX12::g_FrameIndex = GlobalDX12::g_SwapChain->GetCurrentBackBufferIndex();
+
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator>& allocator = g_FrameAllocators[frameSlot];
+		if (allocator == nullptr)
+		{
+			ThrowIfFailed(GlobalDX12::g_Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+																	   IID_PPV_ARGS(&allocator)));
+		}
+		GlobalDX12::g_CommandAllocator = allocator;
+
 		// Reset Cmd List
 		ThrowIfFailed(GlobalDX12::g_CommandAllocator->Reset());
 		ThrowIfFailed(GlobalDX12::g_DirectCommandList->Reset(GlobalDX12::g_CommandAllocator.Get(), nullptr));
@@ -311,6 +327,8 @@ namespace Ball
 		GlobalDX12::g_ReadbackBuffer.ReleaseAndGetAddressOf();
 		GlobalDX12::g_QueryHeap.ReleaseAndGetAddressOf();
 		GlobalDX12::g_CommandAllocator.ReleaseAndGetAddressOf();
+		for (Microsoft::WRL::ComPtr<ID3D12CommandAllocator>& allocator : g_FrameAllocators)
+			allocator.ReleaseAndGetAddressOf();
 		GlobalDX12::g_DirectCommandList.ReleaseAndGetAddressOf();
 		GlobalDX12::g_DirectCommandQueue.reset();
 		GlobalDX12::g_SwapChain.ReleaseAndGetAddressOf();
@@ -327,9 +345,8 @@ namespace Ball
 		ImGui_ImplWin32_NewFrame();
 		ImGui::NewFrame();
 	}
-	void BackEndRenderer::WaitForCmdQueueExecute()
+	IGpuTimeline& BackEndRenderer::GetGpuTimeline()
 	{
-		////TEMPORARY SOLUTION - LOOK INTO FRAME BUFFERING
-		GlobalDX12::g_DirectCommandQueue->WaitForExecution();
+		return *GlobalDX12::g_DirectCommandQueue;
 	}
 } // namespace Ball
\ No newline at end of file
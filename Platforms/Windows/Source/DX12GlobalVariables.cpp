@@ -9,6 +9,7 @@ namespace Ball::GlobalDX12
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> g_CommandAllocator = nullptr;
 	Microsoft::WRL::ComPtr<IDXGISwapChain4> g_SwapChain = nullptr;
 	uint32_t g_FrameIndex = 0;
+	uint32_t g_FrameSlot = 0;
 	// Useful variables
 	uint32_t g_RTVDescSize = 0;
 	uint32_t g_CBV_SRV_UAVDescSize = 0;
@@ -1,4 +1,5 @@
 #include "FileIO.h"
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -8,6 +9,7 @@
 #include <locale>
 #include <unordered_map>
 
+#include "FileReadBatch.h"
 #include "Log.h"
 
 #include <shlobj_core.h>
@@ -16,6 +18,65 @@ namespace Ball
 {
 	static std::unordered_map<FileIO::DirectoryType, std::string> filePaths{};
 
+	namespace
+	{
+		void ReadRequestBlocking(FileReadRequest& request)
+		{
+			std::ifstream file(FileIO::GetPath(request.m_Type, request.m_RelativePath), std::ios::binary);
+			if (!file.is_open())
+				return;
+
+			file.seekg(static_cast<std::streamoff>(request.m_Offset));
+			file.read(static_cast<char*>(request.m_Buffer), static_cast<std::streamsize>(request.m_Size));
+			request.m_BytesRead = static_cast<size_t>(file.gcount());
+			request.m_Succeeded = request.m_BytesRead == request.m_Size;
+		}
+
+		// Temporary files of concurrent writes to the same file must not collide
+		std::atomic<uint32_t> tempFileCounter = 0;
+
+		// Writes into a temporary file next to the target, flushes it to disk and renames it over the target, so a
+		// crash or failed write leaves either the old or the new file
+		bool WriteAtomic(const std::string& filePath, const void* data, size_t size, std::ios_base::openmode mode)
+		{
+			const std::string tempPath = filePath + "." + std::to_string(GetCurrentProcessId()) + "." +
+				std::to_string(tempFileCounter.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+
+			std::fstream file(tempPath, std::fstream::out | std::fstream::trunc | mode);
+			if (!file.is_open())
+				return false;
+
+			file.write(static_cast<const char*>(data), size);
+			file.close();
+
+			std::error_code error;
+			if (file.fail())
+			{
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+
+			// Without the flush the rename can reach the disk before the data does. The stream doesn't expose its
+			// handle, flushing through a new one writes out the cached data of the whole file
+			const HANDLE handle =
+				CreateFileA(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			const bool flushed = handle != INVALID_HANDLE_VALUE && FlushFileBuffers(handle) != 0;
+			if (handle != INVALID_HANDLE_VALUE)
+				CloseHandle(handle);
+
+			// MOVEFILE_WRITE_THROUGH only returns once the rename itself is on disk
+			if (!flushed ||
+				!MoveFileExA(tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+			{
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+			return true;
+		}
+
+		FileReadWorkers* readWorkers = nullptr;
+	} // namespace
+
 	bool FileIO::Init()
 	{
 		char exeFilePath[MAX_PATH];
@@ -68,11 +129,16 @@ namespace Ball
 
 		filePaths.insert({DirectoryType::ToolPreset, applicationPath + "Resources/ToolSettings"});
 
+		readWorkers = new FileReadWorkers(4, &ReadRequestBlocking);
+
 		return true;
 	}
 
 	bool FileIO::Shutdown()
 	{
+		// Finishes the queued reads first
+		delete readWorkers;
+		readWorkers = nullptr;
 		return true;
 	}
 
@@ -96,13 +162,21 @@ namespace Ball
 			std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
 		}
 
-		// Open file. Assign the right flags, based on whether to append or truncate the data.
-		std::fstream file{};
+		if (!appendData)
+		{
+			if (!WriteAtomic(filePath, data.data(), data.size(), {}))
+			{
+				ERROR(LOG_FILEIO, "Failed to write '%s'.\n", filePath.c_str());
+				return false;
+			}
 
-		std::ios_base::openmode mode = std::fstream::out;
-		mode |= appendData ? std::fstream::app : std::fstream::trunc;
+			INFO(LOG_FILEIO, "Wrote to file: %s", filePath.c_str());
+			return true;
+		}
 
-		file.open(filePath, mode);
+		// Appending can't go through a temporary file
+		std::fstream file{};
+		file.open(filePath, std::fstream::out | std::fstream::app);
 
 		if (!file.is_open())
 		{
@@ -135,20 +209,12 @@ namespace Ball
 			std::filesystem::create_directories(std::filesystem::path(filePath).parent_path());
 		}
 
-		// Open file. Assign the right flags, based on whether to append or truncate the data.
-		std::fstream file{};
-
-		file.open(filePath, std::fstream::out | std::fstream::trunc | std::ios::binary);
-
-		if (!file.is_open())
+		if (!WriteAtomic(filePath, data, size, std::ios::binary))
 		{
-			ERROR(LOG_FILEIO, "Failed to open '%s' for writing.\n", filePath.c_str());
+			ERROR(LOG_FILEIO, "Failed to write '%s'.\n", filePath.c_str());
 			return false;
 		}
 
-		file.write(static_cast<const char*>(data), size);
-		file.close();
-
 		INFO(LOG_FILEIO, "Wrote to binary file: %s", filePath.c_str());
 		return true;
 	}
@@ -211,6 +277,101 @@ namespace Ball
 		return true;
 	}
 
+	MappedFile FileIO::MapReadOnly(DirectoryType type, const std::string& relativePath)
+	{
+		MappedFile mapping;
+
+		const std::wstring filePath = std::filesystem::path(GetPath(type, relativePath)).wstring();
+		HANDLE file = CreateFileW(filePath.c_str(),
+								  GENERIC_READ,
+								  FILE_SHARE_READ,
+								  nullptr,
+								  OPEN_EXISTING,
+								  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+								  nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			ERROR(LOG_FILEIO, "Attempted to map '%s' which doesnt exist !", relativePath.c_str());
+			return mapping;
+		}
+
+		LARGE_INTEGER size = {};
+		if (GetFileSizeEx(file, &size))
+		{
+			mapping.m_Size = static_cast<size_t>(size.QuadPart);
+			if (mapping.m_Size == 0)
+			{
+				// Empty files can't be mapped
+				mapping.m_Valid = true;
+			}
+			else if (HANDLE fileMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+			{
+				mapping.m_Data = static_cast<const uint8_t*>(MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0));
+				mapping.m_Valid = mapping.m_Data != nullptr;
+				// The view keeps the mapping and the file alive
+				CloseHandle(fileMapping);
+			}
+
+			if (!mapping.m_Valid)
+			{
+				ERROR(LOG_FILEIO, "Failed to map '%s'", relativePath.c_str());
+				mapping.m_Size = 0;
+			}
+		}
+
+		CloseHandle(file);
+		return mapping;
+	}
+
+	void MappedFile::Reset()
+	{
+		if (m_Data)
+			UnmapViewOfFile(m_Data);
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Valid = false;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Reset();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: m_Data(other.m_Data), m_Size(other.m_Size), m_Valid(other.m_Valid)
+	{
+		other.m_Data = nullptr;
+		other.m_Size = 0;
+		other.m_Valid = false;
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			std::swap(m_Data, other.m_Data);
+			std::swap(m_Size, other.m_Size);
+			std::swap(m_Valid, other.m_Valid);
+		}
+		return *this;
+	}
+
+	std::shared_ptr<FileReadBatch> FileIO::ReadAsync(std::vector<FileReadRequest> requests)
+	{
+		ASSERT_MSG(LOG_FILEIO, readWorkers, "FileIO::ReadAsync called before FileIO::Init");
+
+		std::shared_ptr<FileReadBatch> batch = std::make_shared<FileReadBatch>(std::move(requests));
+		if (batch->GetNumRequests() > 0)
+			readWorkers->Submit(batch);
+		return batch;
+	}
+
+	FileIO::AsyncReadBackend FileIO::GetAsyncReadBackend()
+	{
+		return AsyncReadBackend::THREAD_POOL;
+	}
+
 	std::vector<std::string> FileIO::GetDirectoryContent(DirectoryType type, const std::string& directoryPath)
 	{
 		std::vector<std::string> paths;
@@ -256,7 +417,7 @@ namespace Ball
 		return std::filesystem::file_size(GetPath(type, relativePath));
 	}
 
-	std::string FileIO::GetPath(DirectoryType type)
+	const std::string& FileIO::GetPath(DirectoryType type)
 	{
 		const auto rootPath = filePaths.find(type);
 		assert(rootPath != filePaths.end()); // If this asserts it needs to be implemented in initialize most likely !
@@ -272,6 +433,6 @@ namespace Ball
 	bool FileIO::HasWriteAccess(FileIO::DirectoryType type)
 	{
 		return type == FileIO::CampaignSave || type == FileIO::LocalLevel || type == FileIO::CommunitySave ||
-			type == FileIO::Log || type == FileIO::TempData || FileIO::ToolPreset;
+			type == FileIO::Log || type == FileIO::TempData || type == FileIO::ToolPreset;
 	}
 } // namespace Ball
\ No newline at end of file
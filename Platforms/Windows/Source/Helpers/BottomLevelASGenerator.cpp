@@ -134,8 +134,9 @@ namespace nv_helpers_dx12
 						  // allow iterative updates
 		UINT64 *scratchSizeInBytes, // Required scratch memory on the GPU to build
 									// the acceleration structure
-		UINT64 *resultSizeInBytes // Required GPU memory to store the acceleration
-								  // structure
+		UINT64 *resultSizeInBytes, // Required GPU memory to store the acceleration
+								   // structure
+		D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS extraFlags // Trace/build preference and compaction flags
 	)
 	{
 		// The generated AS can support iterative updates. This may change the final
@@ -143,6 +144,7 @@ namespace nv_helpers_dx12
 		// to be set before the actual build
 		m_flags = allowUpdate ? D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE
 							  : D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_NONE;
+		m_flags |= extraFlags;
 
 		// Describe the work being requested, in this case the construction of a
 		// (possibly dynamic) bottom-level hierarchy, with the given vertex buffers
@@ -186,22 +188,25 @@ namespace nv_helpers_dx12
 		Microsoft::WRL::ComPtr<ID3D12Resource> resultBuffer, // Result buffer storing the acceleration structure
 		bool updateOnly, // If true, simply refit the existing
 						 // acceleration structure
-		Microsoft::WRL::ComPtr<ID3D12Resource> previousResult // Optional previous acceleration
-															  // structure, used if an iterative update
-															  // is requested
+		Microsoft::WRL::ComPtr<ID3D12Resource> previousResult, // Optional previous acceleration
+															   // structure, used if an iterative update
+															   // is requested
+		const D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC
+			*postbuildInfo // Optional info the build writes out, like the compacted size
 	)
 	{
 		D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS flags = m_flags;
 		// The stored flags represent whether the AS has been built for updates or
 		// not. If yes and an update is requested, the builder is told to only update
-		// the AS instead of fully rebuilding it
-		if (flags == D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE && updateOnly)
+		// the AS instead of fully rebuilding it. An update has to repeat the flags of the build it updates
+		const bool allowsUpdate = (m_flags & D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE) != 0;
+		if (allowsUpdate && updateOnly)
 		{
-			flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
+			flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
 		}
 
 		// Sanity checks
-		if (m_flags != D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE && updateOnly)
+		if (!allowsUpdate && updateOnly)
 		{
 			throw std::logic_error("Cannot update a bottom-level AS not originally built for updates");
 		}
@@ -229,7 +234,7 @@ namespace nv_helpers_dx12
 		buildDesc.Inputs.Flags = flags;
 
 		// Build the AS
-		commandList->BuildRaytracingAccelerationStructure(&buildDesc, 0, nullptr);
+		commandList->BuildRaytracingAccelerationStructure(&buildDesc, postbuildInfo ? 1 : 0, postbuildInfo);
 
 		// Wait for the builder to complete by setting a barrier on the resulting
 		// buffer. This is particularly important as the construction of the top-level
@@ -29,6 +29,11 @@ namespace Ball
 		return fenceValue;
 	}
 
+	uint64_t CommandQueue::GetCompletedValue() const
+	{
+		return m_D3d12Fence->GetCompletedValue();
+	}
+
 	bool CommandQueue::IsFenceComplete(uint64_t fenceValue)
 	{
 		return m_D3d12Fence->GetCompletedValue() >= fenceValue;
@@ -47,21 +52,6 @@ namespace Ball
 	{
 		WaitForFenceValue(Signal());
 	}
-	void CommandQueue::WaitForExecution()
-	{
-		const UINT64 fence = m_FenceValue;
-		ThrowIfFailed(m_D3d12CommandQueue->Signal(m_D3d12Fence.Get(), fence));
-		m_FenceValue++;
-
-		// Wait until the previous frame is finished.
-		if (m_D3d12Fence->GetCompletedValue() < fence)
-		{
-			ThrowIfFailed(m_D3d12Fence->SetEventOnCompletion(fence, m_FenceEvent));
-			WaitForSingleObject(m_FenceEvent, INFINITE);
-		}
-
-		GlobalDX12::g_FrameIndex = GlobalDX12::g_SwapChain->GetCurrentBackBufferIndex();
-	}
 
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CommandQueue::CreateCommandAllocator()
 	{
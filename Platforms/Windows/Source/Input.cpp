@@ -89,8 +89,11 @@ void Input::GatherInputUpdate()
 	if (GetWindow().GetWindowHandle() != GetActiveWindow())
 	{
 		// Reset all key states and return early.
-		for (auto& keyState : m_KeyStates)
-			UpdateKeyState(false, keyState.first);
+		for (unsigned int key = 0; key < NUM_KEY_CODES; key++)
+		{
+			if (m_KnownKeys[key])
+				UpdateKeyState(false, static_cast<KeyCode>(key));
+		}
 
 		return;
 	}
@@ -141,16 +144,16 @@ void Input::GatherInputUpdate()
 			for (int i = KeyCode::MOUSE_L; i <= KeyCode::KEY_PLAYPAUSE; i++)
 			{
 				KeyCode keyCode = static_cast<KeyCode>(i);
-				const auto& keyLookup = m_KeyStates.find(keyCode);
-				if (keyLookup == m_KeyStates.end())
+				if (!m_KnownKeys[keyCode])
 					continue;
 
+				const KeyState currentState = m_KeyStates[keyCode];
 				int keyState = GetAsyncKeyState(static_cast<KeyCode>(keyCode));
-				if ((keyState) && (keyLookup->second == KeyState::NONE || keyLookup->second == KeyState::PRESSED))
+				if ((keyState) && (currentState == KeyState::NONE || currentState == KeyState::PRESSED))
 				{
 					UpdateKeyState(true, keyCode);
 				}
-				else if (keyState == 0 && keyLookup->second != KeyState::NONE)
+				else if (keyState == 0 && currentState != KeyState::NONE)
 				{
 					UpdateKeyState(false, keyCode);
 				}
@@ -2,10 +2,10 @@
 #include "D3D12/d3dx12.h"
 #include "DX12GlobalVariables.h"
 #include "GameObjects/Types/Camera.h"
+#include "Rendering/BEAR/Buffer.h"
 #include <Helpers/DXHelperFunctions.h>
 #include <Helpers/RootSignatureGenerator.h>
 #include <dxcapi.h>
-#include <glm/ext/matrix_transform.hpp>
 
 #include "Log.h"
 
@@ -14,29 +14,44 @@ namespace Ball
 	// Rasterization resources for DX12
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> m_LinePSO;
 	Microsoft::WRL::ComPtr<ID3D12RootSignature> m_LineRootSignature;
-	Microsoft::WRL::ComPtr<ID3D12Resource> m_LinesResource;
-	Microsoft::WRL::ComPtr<ID3D12Resource> m_LineVertexBuffer;
-	D3D12_VERTEX_BUFFER_VIEW m_LineVertexBufferView;
+	// Persistently mapped, holds the records of every frame in flight
+	Microsoft::WRL::ComPtr<ID3D12Resource> m_PrimitivesResource;
 
-	void LineDrawer::AddLine(Ball::Line line)
+	namespace
 	{
-		m_Lines.push_back(line);
+		enum LineRootParameters
+		{
+			LINE_SETTINGS,
+			LINE_PRIMITIVES,
+			LINE_DEPTH,
+		};
+	} // namespace
+
+	void LineDrawer::AddLine(Ball::Line line, DebugDrawChannel channel)
+	{
+		m_Stream.AddLine(line.m_Start, line.m_End, line.m_Color, channel);
 	}
 	void LineDrawer::Shutdown()
 	{
+		if (m_PrimitivesResource)
+			m_PrimitivesResource->Unmap(0, nullptr);
+		m_Stream.Init(nullptr);
+
 		m_LinePSO.ReleaseAndGetAddressOf();
 		m_LineRootSignature.ReleaseAndGetAddressOf();
-		m_LinesResource.ReleaseAndGetAddressOf();
-		m_LineVertexBuffer.ReleaseAndGetAddressOf();
+		m_PrimitivesResource.ReleaseAndGetAddressOf();
 	}
 	void LineDrawer::Init(uint32_t width, uint32_t height)
 	{
 		D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineStateDesc = {};
 
 		nv_helpers_dx12::RootSignatureGenerator rsg;
+		rsg.AddRootParameter(
+			D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS, 0, 0, D3D12_SHADER_VISIBILITY_ALL, sizeof(LineSettings) / 4);
 		rsg.AddRootParameter(D3D12_ROOT_PARAMETER_TYPE_SRV, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
-		m_LineRootSignature =
-			rsg.Generate(GlobalDX12::g_Device, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+		rsg.AddRootParameter(D3D12_ROOT_PARAMETER_TYPE_SRV, 1, 0, D3D12_SHADER_VISIBILITY_PIXEL);
+		// Vertices are generated from SV_VertexID, there is no input layout
+		m_LineRootSignature = rsg.Generate(GlobalDX12::g_Device, D3D12_ROOT_SIGNATURE_FLAG_NONE);
 
 		pipelineStateDesc.pRootSignature = m_LineRootSignature.Get();
 
@@ -59,14 +74,13 @@ namespace Ball
 		pipelineStateDesc.RasterizerState.FillMode = D3D12_FILL_MODE_WIREFRAME;
 		pipelineStateDesc.RasterizerState.AntialiasedLineEnable = true;
 
+		// The path tracer doesn't write a depth buffer, the depth tested channel compares against the primary hit
+		// distance in the pixel shader instead
 		pipelineStateDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
 		pipelineStateDesc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
 		pipelineStateDesc.DepthStencilState.DepthEnable = false;
 		pipelineStateDesc.DepthStencilState.StencilEnable = false;
 
-		std::vector<D3D12_INPUT_ELEMENT_DESC> inputLayout = {
-			{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}};
-		pipelineStateDesc.InputLayout = {inputLayout.data(), (UINT)inputLayout.size()};
 		pipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
 		pipelineStateDesc.NumRenderTargets = 1;
 		pipelineStateDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -74,75 +88,62 @@ namespace Ball
 		pipelineStateDesc.SampleMask = UINT_MAX;
 		GlobalDX12::g_Device->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&m_LinePSO));
 
-		// Create a vertex buffer for the line
-		glm::vec3 line[2] = {glm::vec3(0), glm::vec3(0.f, -1.f, 0.f)};
-		m_LineVertexBuffer = Helpers::CreateBuffer(2 * sizeof(glm::vec3),
-												   D3D12_RESOURCE_FLAG_NONE,
-												   D3D12_RESOURCE_STATE_GENERIC_READ,
-												   Helpers::kUploadHeapProps);
-		uint8_t* pData;
-		ThrowIfFailed(m_LineVertexBuffer->Map(0, nullptr, (void**)&pData));
-		memcpy(pData, &line[0], 2 * sizeof(glm::vec3));
-		m_LineVertexBuffer->Unmap(0, nullptr);
-
-		m_LineVertexBufferView.BufferLocation = m_LineVertexBuffer->GetGPUVirtualAddress();
-		m_LineVertexBufferView.StrideInBytes = sizeof(glm::vec3);
-		m_LineVertexBufferView.SizeInBytes = 2 * sizeof(glm::vec3);
-
-		// Allocate a buffer for line data
-		m_LinesResource = Helpers::CreateBuffer(m_MaxLinesNum * sizeof(LineData),
-												D3D12_RESOURCE_FLAG_NONE,
-												D3D12_RESOURCE_STATE_GENERIC_READ,
-												Helpers::kUploadHeapProps);
+		// Upload heap memory stays mapped for the lifetime of the drawer, producers write their records into it
+		// directly. Each frame in flight has its own region so the GPU never reads what is being written.
+		m_PrimitivesResource = Helpers::CreateBuffer(static_cast<uint64_t>(DebugDrawStream::NUM_FRAMES) *
+														 DebugDrawStream::GetRecordsPerFrame() * sizeof(DebugPrimitiveGPU),
+													 D3D12_RESOURCE_FLAG_NONE,
+													 D3D12_RESOURCE_STATE_GENERIC_READ,
+													 Helpers::kUploadHeapProps);
+		DebugPrimitiveGPU* mapped = nullptr;
+		CD3DX12_RANGE readRange(0, 0);
+		ThrowIfFailed(m_PrimitivesResource->Map(0, &readRange, reinterpret_cast<void**>(&mapped)));
+		m_Stream.Init(mapped);
 	}
 
-	void LineDrawer::DrawLines(Camera* cam)
+	void LineDrawer::DrawLines(Camera* cam, Buffer* depthBuffer, uint32_t screenWidth)
 	{
-		if (m_Lines.empty())
+		DebugPrimitiveRange ranges[DebugDrawStream::NUM_STREAMS];
+		m_Stream.EndFrame(ranges);
+		if (!m_LinePSO)
 			return;
 
+		bool empty = true;
+		for (const DebugPrimitiveRange& range : ranges)
+			empty &= range.m_Count == 0;
+		if (empty)
+			return;
+
+		Helpers::TransitionResourceState(depthBuffer, D3D12_RESOURCE_STATE_GENERIC_READ);
+
 		GlobalDX12::g_DirectCommandList->SetPipelineState(m_LinePSO.Get());
 		GlobalDX12::g_DirectCommandList->SetGraphicsRootSignature(m_LineRootSignature.Get());
+		GlobalDX12::g_DirectCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
+		GlobalDX12::g_DirectCommandList->SetGraphicsRootShaderResourceView(
+			LINE_DEPTH, depthBuffer->GetGPUHandleRef().m_Buffer->GetGPUVirtualAddress());
+
+		LineSettings settings;
+		settings.m_ViewProjection = cam->GetProjection() * cam->GetView();
+		settings.m_CameraPosition = cam->GetCullingFrustum().m_Position;
+		settings.m_ScreenWidth = screenWidth;
+		settings.m_DepthBias = 0.001f;
 
-		// Calculations from start->finiswh to MVP
-		glm::mat4 viewProjectionMatrix = cam->GetProjection() * cam->GetView();
-		std::vector<LineData> lineDatas;
-		lineDatas.reserve(m_Lines.size());
-		for (auto& line : m_Lines)
+		const D3D12_GPU_VIRTUAL_ADDRESS primitivesAddress = m_PrimitivesResource->GetGPUVirtualAddress();
+		for (int i = 0; i < DebugDrawStream::NUM_STREAMS; i++)
 		{
-			glm::mat4 modelMatrix = glm::translate(glm::identity<glm::mat4>(), line.m_Start);
-			glm::vec3 lineDirection = glm::normalize(line.m_End - line.m_Start + glm::vec3(0.0, 0.0, 0.00002));
-			float lineLength = glm::length(line.m_End - line.m_Start);
-			float angle = glm::acos(abs(glm::dot(lineDirection, glm::vec3(0.0f, -1.0f, 0.0f))));
-			if (glm::dot(lineDirection, glm::vec3(0.0f, -1.0f, 0.0f)) < 0.0f)
-				angle = glm::pi<float>() - angle;
-			modelMatrix = glm::rotate(modelMatrix, angle, glm::cross(glm::vec3(0.0f, -1.0f, 0.0f), lineDirection));
-			modelMatrix = glm::scale(modelMatrix, glm::vec3(1.0f, lineLength, 1.0f));
-
-			LineData lineData;
-			lineData.m_MVP = viewProjectionMatrix * modelMatrix;
-			lineData.m_Color = glm::vec4(line.m_Color, 1.0f);
-			lineDatas.push_back(lineData);
+			if (ranges[i].m_Count == 0)
+				continue;
+
+			const bool shapes = i == DebugDrawStream::DEPTH_TESTED_SHAPES || i == DebugDrawStream::OVERLAY_SHAPES;
+			settings.m_DepthTest =
+				i == DebugDrawStream::DEPTH_TESTED_LINES || i == DebugDrawStream::DEPTH_TESTED_SHAPES;
+
+			GlobalDX12::g_DirectCommandList->SetGraphicsRoot32BitConstants(
+				LINE_SETTINGS, sizeof(LineSettings) / 4, &settings, 0);
+			GlobalDX12::g_DirectCommandList->SetGraphicsRootShaderResourceView(
+				LINE_PRIMITIVES, primitivesAddress + ranges[i].m_First * sizeof(DebugPrimitiveGPU));
+			GlobalDX12::g_DirectCommandList->DrawInstanced(shapes ? DEBUG_SHAPE_VERTEX_COUNT : 2, ranges[i].m_Count, 0, 0);
 		}
-
-		ASSERT_MSG(LOG_GRAPHICS,
-				   m_Lines.size() <= m_MaxLinesNum,
-				   "Exceeded debug line limit of %i. Increase it from LineDrawer.h",
-				   m_MaxLinesNum);
-
-		// Copy line data
-		uint8_t* pData;
-		ThrowIfFailed(m_LinesResource->Map(0, nullptr, (void**)&pData));
-		memcpy(pData, lineDatas.data(), lineDatas.size() * sizeof(LineData));
-		m_LinesResource->Unmap(0, nullptr);
-
-		// Draw Lines
-		GlobalDX12::g_DirectCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
-		GlobalDX12::g_DirectCommandList->IASetVertexBuffers(0, 1, &m_LineVertexBufferView);
-		GlobalDX12::g_DirectCommandList->SetGraphicsRootShaderResourceView(0, m_LinesResource->GetGPUVirtualAddress());
-		GlobalDX12::g_DirectCommandList->DrawInstanced(2, lineDatas.size(), 0, 0);
-		lineDatas.clear();
-		m_Lines.clear();
 	}
 
-} // namespace Ball
\ No newline at end of file
+} // namespace Ball
@@ -6,18 +6,26 @@
 #endif // !SHIPPING
 #include <WinPixEventRuntime/Include/WinPixEventRuntime/pix3.h>
 
+#include <D3D12/d3dx12.h>
 #include "DX12GlobalVariables.h"
 #include "Log.h"
 #include "Helpers/CommandQueue.h"
+#include "Utilities/PoolAllocator.h"
 
 struct StartEndPairs
 {
-	std::string name;
+	Ball::StringId name;
 	uint32_t start;
 	uint32_t end;
 };
 
-static std::unordered_map<uint32_t, StartEndPairs> timestampPairs;
+// Nodes come from a pool, the map is cleared every frame
+static std::unordered_map<uint32_t,
+						  StartEndPairs,
+						  std::hash<uint32_t>,
+						  std::equal_to<uint32_t>,
+						  Ball::PoolAllocator<std::pair<const uint32_t, StartEndPairs>>>
+	timestampPairs;
 
 namespace Ball::Utilities
 {
@@ -25,7 +33,7 @@ namespace Ball::Utilities
 	{
 		MarkerColors color = MarkerColors::TEAL;
 
-		auto it = g_MarkerColors.find(name);
+		auto it = g_MarkerColors.find(StringId(name));
 		if (it != g_MarkerColors.end())
 			color = it->second;
 
@@ -40,7 +48,7 @@ namespace Ball::Utilities
 
 	void PushGPUMarker(Ball::CommandList* cmdList, const std::string& name, MarkerColors color)
 	{
-		auto it = g_MarkerColors.find(name);
+		auto it = g_MarkerColors.find(StringId(name));
 		if (it != g_MarkerColors.end())
 			color = it->second;
 		else
@@ -57,12 +65,13 @@ namespace Ball::Utilities
 
 #ifndef SHIPPING
 
-	uint32_t PushGPUTimestamp(Ball::CommandList* cmdList, const std::string& name)
+	uint32_t PushGPUTimestamp(Ball::CommandList* cmdList, std::string_view name)
 	{
 		cmdList->GetCommandListHandleRef().m_CommandList.Get()->EndQuery(
 			GlobalDX12::g_QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, GlobalDX12::g_TimestampCounter);
 
-		timestampPairs[GlobalDX12::g_TimestampCounter] = StartEndPairs{name, GlobalDX12::g_TimestampCounter, INT32_MAX};
+		timestampPairs[GlobalDX12::g_TimestampCounter] =
+			StartEndPairs{StringId::Intern(name), GlobalDX12::g_TimestampCounter, INT32_MAX};
 
 		GlobalDX12::g_TimestampCounter++;
 
@@ -99,6 +108,12 @@ namespace Ball::Utilities
 		GlobalDX12::g_TimestampCounter++;
 	}
 
+	// Each frame in flight resolves into its own region of the readback buffer
+	static UINT64 GetReadbackOffset()
+	{
+		return static_cast<UINT64>(GlobalDX12::g_FrameSlot) * GlobalDX12::MAX_GPU_QUERIES * sizeof(UINT64);
+	}
+
 	void SaveGPUTimestampData(CommandList* cmdList)
 	{
 		cmdList->GetCommandListHandleRef().m_CommandList.Get()->ResolveQueryData(GlobalDX12::g_QueryHeap.Get(),
@@ -106,16 +121,21 @@ namespace Ball::Utilities
 																				 0,
 																				 GlobalDX12::g_TimestampCounter,
 																				 GlobalDX12::g_ReadbackBuffer.Get(),
-																				 0);
+																				 GetReadbackOffset());
 	}
 
-	std::vector<TimestampData> ProcessReadbackBuffer()
+	void ProcessReadbackBuffer(std::vector<TimestampData>& timestampData)
 	{
-		std::vector<TimestampData> timestampData;
-		timestampData.reserve(timestampPairs.size());
+		timestampData.resize(timestampPairs.size());
+		size_t numTimestamps = 0;
 
-		UINT64* pData = nullptr;
-		HRESULT hr = GlobalDX12::g_ReadbackBuffer.Get()->Map(0, nullptr, reinterpret_cast<void**>(&pData));
+		// The region of this slot holds the timestamps of the last frame that used it, which the GPU finished before
+		// the FrameScheduler handed the slot out again
+		const UINT64 offset = GetReadbackOffset();
+		CD3DX12_RANGE readRange(offset, offset + GlobalDX12::MAX_GPU_QUERIES * sizeof(UINT64));
+		UINT8* pMapped = nullptr;
+		HRESULT hr = GlobalDX12::g_ReadbackBuffer.Get()->Map(0, &readRange, reinterpret_cast<void**>(&pMapped));
+		const UINT64* pData = reinterpret_cast<const UINT64*>(pMapped + offset);
 
 		UINT64 gpuFrequency;
 		GlobalDX12::g_DirectCommandQueue->GetD3D12CommandQueue()->GetTimestampFrequency(&gpuFrequency);
@@ -129,10 +149,14 @@ namespace Ball::Utilities
 
 				const float timeDiffMs = (endTime - startTime) * 1000.0 / gpuFrequency;
 
-				timestampData.push_back({ts.second.name, timeDiffMs});
+				TimestampData& data = timestampData[numTimestamps++];
+				data.id = ts.second.name;
+				data.name = ts.second.name.GetDebugName();
+				data.timeInMs = timeDiffMs;
 			}
 
-			GlobalDX12::g_ReadbackBuffer.Get()->Unmap(0, nullptr);
+			CD3DX12_RANGE writeRange(0, 0);
+			GlobalDX12::g_ReadbackBuffer.Get()->Unmap(0, &writeRange);
 		}
 		else
 		{
@@ -140,15 +164,15 @@ namespace Ball::Utilities
 			// Handle mapping errors
 		}
 
+		timestampData.resize(numTimestamps);
+
 		// Reset GPU Timestamp Queries
 		timestampPairs.clear();
 		timestampPairs.reserve(GlobalDX12::MAX_GPU_QUERIES);
 		GlobalDX12::g_TimestampCounter = 0;
-
-		return timestampData;
 	}
 #else
-	uint32_t PushGPUTimestamp(CommandList* cmdList, const std::string& name)
+	uint32_t PushGPUTimestamp(CommandList* cmdList, std::string_view name)
 	{
 		return UINT32_MAX;
 	}
@@ -161,9 +185,9 @@ namespace Ball::Utilities
 	{
 	}
 
-	std::vector<TimestampData> ProcessReadbackBuffer()
+	void ProcessReadbackBuffer(std::vector<TimestampData>& timestampData)
 	{
-		return {};
+		timestampData.clear();
 	}
 
 #endif